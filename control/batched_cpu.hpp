@@ -0,0 +1,165 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       Helpers for host (CPU) batched routines that factor many tiny
+       matrices at once using a batch-interleaved ("batch-innermost") layout.
+
+       A group of up to magma_batched_cpu_lanes<real_t>() matrices is copied
+       into a buffer where element (i,j) of all matrices in the group is
+       contiguous, so a loop over the group ("lanes") vectorizes and each SIMD
+       lane operates on a different matrix. Complex matrices keep separate
+       real and imaginary planes:
+
+           buf[ ((j*n + i)*ncomp + c)*lanes + l ]
+
+       for row i, column j, component c (0 = real, 1 = imaginary, complex
+       only), and lane l (matrix index within the group).
+*/
+
+#ifndef MAGMA_BATCHED_CPU_HPP
+#define MAGMA_BATCHED_CPU_HPP
+
+#include "magma_internal.h"
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+// Maximum matrix size handled by the interleaved kernels; larger matrices
+// are factored one at a time by LAPACK.
+#define MAGMA_BATCHED_CPU_MAX_N 32
+
+
+/******************************************************************************/
+/// @return number of matrices in one interleaved group, i.e., the number of
+/// real_t values in a 64-byte (AVX-512) vector. Narrower ISAs simply process
+/// a group in several vector chunks.
+template< typename real_t >
+inline constexpr magma_int_t magma_batched_cpu_lanes()
+{
+    return 64 / sizeof(real_t);
+}
+
+
+/***************************************************************************//**
+    Copies matrices A_array[ 0 : count-1 ] into interleaved buffer buf, which
+    holds m-by-n matrices. If conjtrans, the buffer gets the
+    conjugate-transpose of each n-by-m matrix, which maps an upper triangular
+    problem onto a lower triangular kernel, or a wide matrix onto a tall one;
+    otherwise each matrix is m-by-n. In both cases lda is the leading
+    dimension of the matrices in A_array. Unused lanes (count < lanes) are set
+    to the identity, so kernels never see NaN or spurious singularities there.
+
+    A_array holds real_t pointers to column-major matrices of ncomp-tuples
+    (ncomp = 2 for complex).
+*******************************************************************************/
+template< typename real_t, magma_int_t ncomp >
+void magma_batched_cpu_pack(
+    magma_int_t m, magma_int_t n, real_t const* const* A_array, magma_int_t lda,
+    magma_int_t count, bool conjtrans, real_t* buf )
+{
+    const magma_int_t L = magma_batched_cpu_lanes< real_t >();
+    for (magma_int_t j = 0; j < n; ++j) {
+        for (magma_int_t i = 0; i < m; ++i) {
+            real_t* b = buf + (j*m + i)*ncomp*L;
+            // (i,j) of the buffer comes from (i,j) or (j,i) of the matrix
+            magma_int_t src = conjtrans ? (j + i*lda)*ncomp : (i + j*lda)*ncomp;
+            for (magma_int_t l = 0; l < count; ++l) {
+                b[l] = A_array[l][src];
+                if (ncomp == 2) {
+                    b[L + l] = conjtrans ? -A_array[l][src + 1] : A_array[l][src + 1];
+                }
+            }
+            for (magma_int_t l = count; l < L; ++l) {
+                b[l] = (i == j ? 1 : 0);
+                if (ncomp == 2) {
+                    b[L + l] = 0;
+                }
+            }
+        }
+    }
+}
+
+
+/******************************************************************************/
+/// Square case of magma_batched_cpu_pack: each matrix is n-by-n.
+template< typename real_t, magma_int_t ncomp >
+void magma_batched_cpu_pack(
+    magma_int_t n, real_t const* const* A_array, magma_int_t lda,
+    magma_int_t count, bool conjtrans, real_t* buf )
+{
+    magma_batched_cpu_pack< real_t, ncomp >( n, n, A_array, lda, count, conjtrans, buf );
+}
+
+
+/***************************************************************************//**
+    Inverse of magma_batched_cpu_pack. If uplo is MagmaLower or MagmaUpper,
+    only that triangle of the buffer is copied back (the triangle refers to the
+    buffer, before undoing any conjugate-transpose), leaving the other triangle
+    of each matrix untouched.
+*******************************************************************************/
+template< typename real_t, magma_int_t ncomp >
+void magma_batched_cpu_unpack(
+    magma_int_t n, real_t const* buf, magma_uplo_t uplo,
+    magma_int_t count, bool conjtrans, real_t* const* A_array, magma_int_t lda )
+{
+    const magma_int_t L = magma_batched_cpu_lanes< real_t >();
+    for (magma_int_t j = 0; j < n; ++j) {
+        magma_int_t ibeg = (uplo == MagmaLower ? j : 0);
+        magma_int_t iend = (uplo == MagmaUpper ? j+1 : n);
+        for (magma_int_t i = ibeg; i < iend; ++i) {
+            real_t const* b = buf + (j*n + i)*ncomp*L;
+            magma_int_t dst = conjtrans ? (j + i*lda)*ncomp : (i + j*lda)*ncomp;
+            for (magma_int_t l = 0; l < count; ++l) {
+                A_array[l][dst] = b[l];
+                if (ncomp == 2) {
+                    A_array[l][dst + 1] = conjtrans ? -b[L + l] : b[L + l];
+                }
+            }
+        }
+    }
+}
+
+
+/***************************************************************************//**
+    Runs group_fn( first, count, buf ) for every group of matrices in a batch,
+    distributing groups over OpenMP threads. Each thread owns one interleaved
+    buffer of bufsize real_t values for the duration of the call.
+
+    @return MAGMA_SUCCESS, or MAGMA_ERR_HOST_ALLOC if a buffer could not be
+    allocated.
+*******************************************************************************/
+template< typename real_t, typename group_function >
+magma_int_t magma_batched_cpu_run(
+    magma_int_t batchCount, size_t bufsize, group_function group_fn )
+{
+    const magma_int_t L = magma_batched_cpu_lanes< real_t >();
+    magma_int_t ngroups = magma_ceildiv( batchCount, L );
+    magma_int_t err = MAGMA_SUCCESS;
+
+    #pragma omp parallel
+    {
+        real_t* buf = NULL;
+        magma_int_t lerr = magma_malloc_cpu( (void**) &buf, bufsize*sizeof(real_t) );
+        if (lerr != MAGMA_SUCCESS) {
+            #pragma omp critical (magma_batched_cpu)
+            err = lerr;
+        }
+        // every thread must reach the worksharing loop, even without a buffer
+        #pragma omp for schedule(static)
+        for (magma_int_t g = 0; g < ngroups; ++g) {
+            if (buf != NULL) {
+                magma_int_t first = g*L;
+                group_fn( first, min( L, batchCount - first ), buf );
+            }
+        }
+        magma_free_cpu( buf );
+    }
+    return err;
+}
+
+#endif // MAGMA_BATCHED_CPU_HPP
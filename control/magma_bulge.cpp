@@ -10,6 +10,8 @@
        @author Raffaele Solca
 */
 
+#include <unistd.h>
+
 #include "magma_internal.h"
 
 #define applyQver 113
@@ -197,6 +199,93 @@ return n*lda2[0];
 }
 
 
+/******************************************************************************/
+// Returns size in bytes of the level 1, 2, or 3 data cache of one core,
+// or a typical size if the system cannot be queried.
+magma_int_t magma_bulge_get_cachesize(magma_int_t level)
+{
+    long size = 0;
+    #if defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE) && defined(_SC_LEVEL3_CACHE_SIZE)
+    if (level == 1)
+        size = sysconf( _SC_LEVEL1_DCACHE_SIZE );
+    else if (level == 2)
+        size = sysconf( _SC_LEVEL2_CACHE_SIZE );
+    else
+        size = sysconf( _SC_LEVEL3_CACHE_SIZE );
+    #endif
+    if (size <= 0) {
+        if (level == 1)
+            size = 32*1024;
+        else if (level == 2)
+            size = 256*1024;
+        else
+            size = 8*1024*1024;
+    }
+    return size;
+}
+
+
+/******************************************************************************/
+// Tunes the blocking of the CPU application of Q2 in bulge_back, for
+// ncol columns of E and elements of elsize bytes, applied by threads threads.
+// E is split into column chunks of nb_loc columns, assigned dynamically to
+// threads, so there should be a few chunks per thread. Within a chunk, grsiz
+// consecutive Vblksiz-sweep blocks of V are applied together in a skewed
+// (diamond) order, so each row of E is loaded into cache once per group
+// instead of once per V block. grsiz is chosen so the E rows touched by a
+// group, and the V and T blocks of the group, each fit in half the L2 cache.
+void magma_bulge_get_applyQ_blk(
+    magma_int_t n, magma_int_t nb, magma_int_t Vblksiz, magma_int_t ncol,
+    magma_int_t threads, magma_int_t elsize,
+    magma_int_t *nb_loc, magma_int_t *grsiz)
+{
+    magma_int_t l2   = magma_bulge_get_cachesize( 2 ) / 2;
+    magma_int_t ldv  = nb + Vblksiz;
+    magma_int_t nbGblk = max( 1, magma_ceildiv( n-1, Vblksiz ));
+
+    // aim for 2 chunks per thread, of 32 to 256 columns
+    magma_int_t nloc = magma_roundup( magma_ceildiv( ncol, 2*max( threads, 1 )), 16 );
+    nloc = max( 32, min( 256, nloc ));
+    // a single V block must still be applied to nloc columns within L2
+    while (nloc > 32 && ldv*nloc*elsize > l2)
+        nloc /= 2;
+
+    magma_int_t rows = l2 / (nloc*elsize);
+    magma_int_t gE   = (rows - ldv) / Vblksiz;
+    magma_int_t gV   = l2 / ((ldv + Vblksiz) * Vblksiz * elsize);
+    *nb_loc = nloc;
+    *grsiz  = max( 1, min( nbGblk, min( gE, gV )));
+}
+
+
+/******************************************************************************/
+// Returns the GPU over CPU performance ratio for applying Q2 to the
+// eigenvectors, measured on this machine and given in $MAGMA_BULGE_GCPERF,
+// or 0 if it is not set, in which case the GPU(s) apply all of Q2.
+// zbulge_back and zbulge_back_m give the CPU threads a share of the columns
+// of Z proportional to this ratio. The split only pays off if the ratio is
+// right: the CPU and GPU parts run concurrently, so too large a CPU share
+// makes the whole apply wait for the CPU. The tuned ratios of
+// magma_get_zbulge_gcperf date from Kepler GPUs and would give the CPU far
+// too large a share on current GPUs, so without a measured ratio the split,
+// and the blocked CPU apply, is off.
+magma_int_t magma_bulge_get_gcperf()
+{
+    const char *perf_str = getenv("MAGMA_BULGE_GCPERF");
+    magma_int_t perf = 0;
+    if ( perf_str != NULL ) {
+        char* endptr;
+        perf = strtol( perf_str, &endptr, 10 );
+        if ( perf < 1 || *endptr != '\0' ) {
+            perf = 0;
+            fprintf( stderr, "$MAGMA_BULGE_GCPERF='%s' is an invalid ratio; using the GPU only.\n",
+                     perf_str );
+        }
+    }
+    return perf;
+}
+
+
 // =============================================================================
 // Old functions
 
@@ -0,0 +1,500 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+    Caching host allocator, see magma_host_cache.h.
+
+    Each pool keeps its free blocks in bins by size class, guarded by one
+    mutex. Small blocks are cached per thread first, so the common
+    allocate-free-allocate pattern of a workspace in a loop takes no shared
+    lock. A sharded registry records which pointers the pool owns, so blocks
+    allocated before the cache was enabled, or after it was disabled, are
+    still freed by the caller and the cache can be switched at any time.
+*/
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>  // madvise
+#endif
+
+#include "magma_internal.h"
+#include "magma_host_cache.h"
+
+namespace {
+
+const size_t min_bytes      = 64;              // smallest class, and the alignment
+const int    max_log2       = 40;              // larger requests are not cached
+const int    num_classes    = 1 + 4*(max_log2 - 6);
+const size_t thread_bytes   = size_t(1) << 20; // largest class cached per thread
+const int    thread_classes = 1 + 4*(20 - 6);
+const int    thread_depth   = 8;               // blocks per class per thread
+const size_t huge_bytes     = size_t(2) << 20; // huge page size
+const int    num_shards     = 64;              // registry shards, power of 2
+
+
+/******************************************************************************/
+// Size class of a request, with the size of the class in class_bytes;
+// -1 if the request is too large to cache. Above min_bytes there are
+// 4 classes in each (2^k, 2^(k+1)], so at most 25% is wasted.
+int size_class( size_t bytes, size_t* class_bytes )
+{
+    if (bytes <= min_bytes) {
+        *class_bytes = min_bytes;
+        return 0;
+    }
+    if (uint64_t( bytes ) > (uint64_t(1) << max_log2)) {
+        return -1;
+    }
+    int k = 6;
+    while ((uint64_t(2) << k) < bytes) {
+        ++k;
+    }
+    uint64_t step = uint64_t(1) << (k - 2);
+    uint64_t j = (bytes - (uint64_t(1) << k) + step - 1) / step;  // 1, ..., 4
+    *class_bytes = size_t( (uint64_t(1) << k) + j*step );
+    return 1 + 4*(k - 6) + int(j - 1);
+}
+
+// size of class c, the inverse of size_class
+size_t class_size( int c )
+{
+    if (c == 0) {
+        return min_bytes;
+    }
+    int k = 6 + (c - 1) / 4;
+    return size_t( (uint64_t(1) << k) + (uint64_t( (c - 1) % 4 + 1 ) << (k - 2)) );
+}
+
+
+/******************************************************************************/
+struct pool_t
+{
+    std::mutex         mutex;  // guards bins
+    std::vector<void*> bins[ num_classes ];
+
+    std::atomic< const magma_host_cache_backend_t* > backend;
+
+    std::atomic<long long> hits;
+    std::atomic<long long> misses;
+    std::atomic<long long> bytes_in_use;
+    std::atomic<long long> bytes_cached;
+    std::atomic<long long> peak_bytes;
+
+    // size class of each block the pool owns, whether in use or cached
+    std::atomic<long long>             owned;
+    std::mutex                         shard_mutex[ num_shards ];
+    std::unordered_map< void*, int >   shards[ num_shards ];
+
+    pool_t():
+        backend( nullptr ), hits( 0 ), misses( 0 ), bytes_in_use( 0 ),
+        bytes_cached( 0 ), peak_bytes( 0 ), owned( 0 )
+    {}
+};
+
+struct thread_cache_t;
+
+struct cache_t
+{
+    std::atomic<int> enabled;
+    bool             huge_pages;
+    long long        limit;     // max. bytes cached per pool
+    pool_t           pools[2];
+
+    std::mutex                     threads_mutex;  // guards threads
+    std::vector< thread_cache_t* > threads;
+
+    // MAGMA_HOST_CACHE=1 enables the cache; MAGMA_HOST_CACHE_LIMIT sets the
+    // limit in MiB (default 1 GiB); MAGMA_HOST_CACHE_HUGEPAGES=0 disables
+    // the huge page advice.
+    cache_t():
+        enabled( 0 ), huge_pages( true ), limit( 1LL << 30 )
+    {
+        const char* env = getenv( "MAGMA_HOST_CACHE" );
+        if (env != NULL && (strcmp( env, "1" ) == 0 || strcmp( env, "on" ) == 0)) {
+            enabled = 1;
+        }
+        env = getenv( "MAGMA_HOST_CACHE_LIMIT" );
+        if (env != NULL) {
+            limit = atoll( env ) << 20;
+        }
+        env = getenv( "MAGMA_HOST_CACHE_HUGEPAGES" );
+        if (env != NULL && strcmp( env, "0" ) == 0) {
+            huge_pages = false;
+        }
+    }
+};
+
+// Never destroyed, so memory can still be freed from static destructors.
+cache_t& cache()
+{
+    static cache_t* c = new cache_t();
+    return *c;
+}
+
+
+/******************************************************************************/
+// Registry of the blocks owned by a pool.
+std::unordered_map< void*, int >& registry_shard( pool_t& p, void* ptr, std::mutex** mutex )
+{
+    // blocks are aligned, so hash the address instead of using its low bits
+    uint64_t h = uint64_t( uintptr_t( ptr )) * 0x9E3779B97F4A7C15ull;
+    int s = int( h >> 58 ) & (num_shards - 1);
+    *mutex = &p.shard_mutex[ s ];
+    return p.shards[ s ];
+}
+
+void registry_insert( pool_t& p, void* ptr, int c )
+{
+    std::mutex* mutex;
+    std::unordered_map< void*, int >& shard = registry_shard( p, ptr, &mutex );
+    std::lock_guard< std::mutex > lock( *mutex );
+    shard[ ptr ] = c;
+    ++p.owned;
+}
+
+// size class of ptr, or -1 if the pool does not own it
+int registry_find( pool_t& p, void* ptr )
+{
+    std::mutex* mutex;
+    std::unordered_map< void*, int >& shard = registry_shard( p, ptr, &mutex );
+    std::lock_guard< std::mutex > lock( *mutex );
+    auto iter = shard.find( ptr );
+    return (iter == shard.end() ? -1 : iter->second);
+}
+
+void registry_erase( pool_t& p, void* ptr )
+{
+    std::mutex* mutex;
+    std::unordered_map< void*, int >& shard = registry_shard( p, ptr, &mutex );
+    std::lock_guard< std::mutex > lock( *mutex );
+    if (shard.erase( ptr ) > 0) {
+        --p.owned;
+    }
+}
+
+
+/******************************************************************************/
+// System allocation and free of a block of the pool.
+void* system_alloc( magma_host_cache_pool_t id, size_t bytes )
+{
+    cache_t& c = cache();
+    bool huge = (id == MagmaHostCacheCPU && c.huge_pages && bytes >= huge_bytes);
+    void* ptr = c.pools[id].backend.load()->alloc( bytes, huge ? huge_bytes : min_bytes );
+    #if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (ptr != NULL && huge) {
+        madvise( ptr, bytes, MADV_HUGEPAGE );  // only advice, errors are harmless
+    }
+    #endif
+    return ptr;
+}
+
+void system_free( pool_t& p, void* ptr )
+{
+    registry_erase( p, ptr );
+    p.backend.load()->free( ptr );
+}
+
+void update_peak( pool_t& p )
+{
+    long long bytes = p.bytes_in_use + p.bytes_cached;
+    long long peak  = p.peak_bytes;
+    while (bytes > peak && ! p.peak_bytes.compare_exchange_weak( peak, bytes )) {
+    }
+}
+
+// returns the cached blocks of the pool to the system
+void release_pool( pool_t& p )
+{
+    std::vector<void*> bins[ num_classes ];
+    {
+        std::lock_guard< std::mutex > lock( p.mutex );
+        for (int c = 0; c < num_classes; ++c) {
+            bins[c].swap( p.bins[c] );
+        }
+    }
+    for (int c = 0; c < num_classes; ++c) {
+        for (void* ptr : bins[c]) {
+            system_free( p, ptr );
+            p.bytes_cached -= class_size( c );
+        }
+    }
+}
+
+
+/******************************************************************************/
+// Blocks cached by one thread. The mutex is only contended when another
+// thread releases the cache.
+struct thread_cache_t
+{
+    std::mutex mutex;
+    int   count [2][ thread_classes ];
+    void* blocks[2][ thread_classes ][ thread_depth ];
+
+    thread_cache_t()
+    {
+        memset( count, 0, sizeof(count) );
+        cache_t& c = cache();
+        std::lock_guard< std::mutex > lock( c.threads_mutex );
+        c.threads.push_back( this );
+    }
+
+    // on thread exit, the blocks go to the shared bins
+    ~thread_cache_t()
+    {
+        cache_t& c = cache();
+        std::lock_guard< std::mutex > lock( c.threads_mutex );
+        c.threads.erase( std::find( c.threads.begin(), c.threads.end(), this ));
+        drain();
+        if (! c.enabled) {
+            release_pool( c.pools[0] );
+            release_pool( c.pools[1] );
+        }
+    }
+
+    // moves the blocks to the shared bins
+    void drain()
+    {
+        std::lock_guard< std::mutex > lock( mutex );
+        for (int id = 0; id < 2; ++id) {
+            pool_t& p = cache().pools[id];
+            std::lock_guard< std::mutex > pool_lock( p.mutex );
+            for (int c = 0; c < thread_classes; ++c) {
+                for (int i = 0; i < count[id][c]; ++i) {
+                    p.bins[c].push_back( blocks[id][c][i] );
+                }
+                count[id][c] = 0;
+            }
+        }
+    }
+};
+
+thread_local thread_cache_t t_cache;
+
+
+/******************************************************************************/
+// cached block of class c, or NULL
+void* get_block( magma_host_cache_pool_t id, int c )
+{
+    pool_t& p = cache().pools[id];
+    void* ptr = NULL;
+    if (c < thread_classes) {
+        std::lock_guard< std::mutex > lock( t_cache.mutex );
+        if (t_cache.count[id][c] > 0) {
+            ptr = t_cache.blocks[id][c][ --t_cache.count[id][c] ];
+        }
+    }
+    if (ptr == NULL) {
+        std::lock_guard< std::mutex > lock( p.mutex );
+        if (! p.bins[c].empty()) {
+            ptr = p.bins[c].back();
+            p.bins[c].pop_back();
+        }
+    }
+    if (ptr != NULL) {
+        p.bytes_cached -= class_size( c );
+    }
+    return ptr;
+}
+
+// caches the free block ptr of class c, or returns it to the system if
+// the pool is at its limit
+void put_block( magma_host_cache_pool_t id, void* ptr, int c )
+{
+    cache_t& ca = cache();
+    pool_t& p = ca.pools[id];
+    long long bytes = class_size( c );
+    if (p.bytes_cached + bytes > ca.limit) {
+        system_free( p, ptr );
+        return;
+    }
+    p.bytes_cached += bytes;
+    update_peak( p );
+    if (c < thread_classes) {
+        std::lock_guard< std::mutex > lock( t_cache.mutex );
+        if (t_cache.count[id][c] < thread_depth) {
+            t_cache.blocks[id][c][ t_cache.count[id][c]++ ] = ptr;
+            return;
+        }
+    }
+    std::lock_guard< std::mutex > lock( p.mutex );
+    p.bins[c].push_back( ptr );
+}
+
+}  // namespace
+
+
+/******************************************************************************/
+bool magma_host_cache_malloc(
+    magma_host_cache_pool_t id, size_t bytes, void** ptr,
+    const magma_host_cache_backend_t* backend )
+{
+    cache_t& ca = cache();
+    if (! ca.enabled) {
+        return false;
+    }
+    size_t cbytes;
+    int c = size_class( bytes, &cbytes );
+    if (c < 0) {
+        return false;
+    }
+    pool_t& p = ca.pools[id];
+    p.backend = backend;
+
+    void* block = get_block( id, c );
+    if (block != NULL) {
+        ++p.hits;
+    }
+    else {
+        ++p.misses;
+        block = system_alloc( id, cbytes );
+        if (block == NULL) {
+            // out of memory: return the cached blocks to the system and retry
+            magma_host_cache_release();
+            block = system_alloc( id, cbytes );
+        }
+        if (block == NULL) {
+            *ptr = NULL;
+            return true;
+        }
+        registry_insert( p, block, c );
+    }
+    p.bytes_in_use += cbytes;
+    update_peak( p );
+    *ptr = block;
+    return true;
+}
+
+
+/******************************************************************************/
+bool magma_host_cache_free( magma_host_cache_pool_t id, void* ptr )
+{
+    cache_t& ca = cache();
+    pool_t& p = ca.pools[id];
+    if (ptr == NULL || p.owned == 0) {
+        return false;
+    }
+    int c = registry_find( p, ptr );
+    if (c < 0) {
+        return false;
+    }
+    p.bytes_in_use -= class_size( c );
+    if (ca.enabled) {
+        put_block( id, ptr, c );
+    }
+    else {
+        system_free( p, ptr );
+    }
+    return true;
+}
+
+
+/***************************************************************************//**
+    Enables or disables the caching of host memory allocated by
+    magma_malloc_cpu() and magma_malloc_pinned().
+
+    While enabled, freed blocks are kept for reuse by later allocations of
+    a similar size, instead of being returned to the system, which saves the
+    page faults and zeroing of fresh memory, and the cost of pinning it.
+    Sizes are rounded up to 4 size classes per power of 2. Blocks of 2 MiB
+    and larger are aligned to 2 MiB and advised to use transparent huge
+    pages on Linux. At most 1 GiB is cached per pool.
+
+    The cache is disabled by default. The environment variables
+    MAGMA_HOST_CACHE=1 enables it at the first allocation,
+    MAGMA_HOST_CACHE_LIMIT sets the limit in MiB, and
+    MAGMA_HOST_CACHE_HUGEPAGES=0 disables the huge page advice.
+
+    The cache can be switched at any time; memory is always freed correctly,
+    whichever state it was allocated in. Disabling it releases the cached
+    blocks, see magma_host_cache_release().
+
+    @param[in]
+    enable  If nonzero, enables the cache; otherwise disables it.
+
+    @ingroup magma_malloc_cpu
+*******************************************************************************/
+extern "C" void
+magma_host_cache_set_enabled( magma_int_t enable )
+{
+    cache().enabled = (enable != 0);
+    if (! enable) {
+        magma_host_cache_release();
+    }
+}
+
+
+/***************************************************************************//**
+    @return true if the host memory cache is enabled,
+    see magma_host_cache_set_enabled().
+
+    @ingroup magma_malloc_cpu
+*******************************************************************************/
+extern "C" magma_int_t
+magma_host_cache_get_enabled()
+{
+    return cache().enabled;
+}
+
+
+/***************************************************************************//**
+    Returns the blocks held by the host memory cache to the system,
+    in all threads. Blocks in use are not affected.
+    Called by magma_finalize().
+
+    @ingroup magma_malloc_cpu
+*******************************************************************************/
+extern "C" void
+magma_host_cache_release()
+{
+    cache_t& c = cache();
+    {
+        std::lock_guard< std::mutex > lock( c.threads_mutex );
+        for (thread_cache_t* t : c.threads) {
+            t->drain();
+        }
+    }
+    release_pool( c.pools[ MagmaHostCacheCPU    ] );
+    release_pool( c.pools[ MagmaHostCachePinned ] );
+}
+
+
+/***************************************************************************//**
+    Returns statistics of the host memory cache, accumulated since the
+    start of the program.
+
+    @param[out]
+    cpu_stats       Statistics of magma_malloc_cpu(). May be NULL.
+
+    @param[out]
+    pinned_stats    Statistics of magma_malloc_pinned(). May be NULL.
+
+    @ingroup magma_malloc_cpu
+*******************************************************************************/
+extern "C" void
+magma_host_cache_get_stats(
+    magma_host_cache_stats_t* cpu_stats,
+    magma_host_cache_stats_t* pinned_stats )
+{
+    magma_host_cache_stats_t* stats[2] = { cpu_stats, pinned_stats };
+    for (int id = 0; id < 2; ++id) {
+        if (stats[id] != NULL) {
+            pool_t& p = cache().pools[id];
+            stats[id]->hits         = p.hits;
+            stats[id]->misses       = p.misses;
+            stats[id]->bytes_in_use = p.bytes_in_use;
+            stats[id]->bytes_cached = p.bytes_cached;
+            stats[id]->peak_bytes   = p.peak_bytes;
+        }
+    }
+}
@@ -0,0 +1,53 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+
+#ifndef MAGMA_HOST_CACHE_H
+#define MAGMA_HOST_CACHE_H
+
+#include <stddef.h>
+
+// =============================================================================
+// Internal routines
+//
+// Caching allocator behind magma_malloc_cpu and magma_malloc_pinned, see
+// magma_host_cache_set_enabled. Requests are rounded up to size classes with
+// 4 classes per power of 2, and freed blocks are kept in per-class bins for
+// reuse instead of being returned to the system. Blocks up to 1 MiB first go
+// to a small per-thread cache that needs no shared lock. CPU blocks of 2 MiB
+// and larger are aligned to 2 MiB and marked for transparent huge pages.
+//
+// The pools do not depend on the GPU runtime; the system allocation of each
+// pool is passed in by the caller.
+
+typedef enum {
+    MagmaHostCacheCPU    = 0,
+    MagmaHostCachePinned = 1
+} magma_host_cache_pool_t;
+
+// System allocator of a pool. alloc returns NULL on failure; alignment is a
+// power of 2 that pools without alignment control may ignore.
+typedef struct {
+    void* (*alloc)( size_t bytes, size_t alignment );
+    void  (*free) ( void* ptr );
+} magma_host_cache_backend_t;
+
+/// Allocates bytes from the pool, if the cache is enabled.
+/// Returns false if the caller has to allocate itself;
+/// otherwise *ptr is the block, or NULL if the allocation failed.
+/// backend must stay valid for the lifetime of the program.
+bool magma_host_cache_malloc(
+    magma_host_cache_pool_t pool, size_t bytes, void** ptr,
+    const magma_host_cache_backend_t* backend );
+
+/// Frees ptr if it was allocated by magma_host_cache_malloc from the pool,
+/// whether or not the cache is still enabled.
+/// Returns false if the caller has to free ptr itself.
+bool magma_host_cache_free(
+    magma_host_cache_pool_t pool, void* ptr );
+
+#endif // MAGMA_HOST_CACHE_H
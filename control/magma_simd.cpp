@@ -0,0 +1,662 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+    Vectorised host BLAS-1 style kernels, see magma_simd.h.
+
+    Each kernel is written once with the GCC/clang vector extension and
+    compiled into AVX2 and AVX-512 variants through target attributes, so the
+    library itself is built for the baseline ISA and picks the widest variant
+    the CPU supports at runtime. Other compilers and architectures get the
+    scalar loops only.
+*/
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include "magma_internal.h"
+#include "magma_simd.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define MAGMA_SIMD_X86
+#endif
+
+
+/******************************************************************************/
+// Table of kernels for one precision and one instruction set.
+// Lengths are in reals, except dot_complex, which takes complex elements.
+template< typename T >
+struct magma_simd_kernels
+{
+    T           (*asum)       ( magma_int_t n, const T *x );
+    T           (*amax)       ( magma_int_t n, const T *x );  // NAN if any x_i is NAN
+    T           (*sumsq)      ( magma_int_t n, const T *x, T s );  // sum (s x_i)^2
+    T           (*dot)        ( magma_int_t n, const T *x, const T *y );
+    void        (*dot_complex)( magma_int_t n, const T *x, const T *y, T sums[4] );
+    magma_int_t (*nonfinite)  ( magma_int_t n, const T *x );  // # of NAN or INF x_i
+};
+
+
+/******************************************************************************/
+// Scalar kernels. Used as the fallback, and for remainders of vector kernels.
+template< typename T >
+static T asum_scalar( magma_int_t n, const T *x )
+{
+    T sum = 0;
+    for (magma_int_t i = 0; i < n; ++i) {
+        sum += std::abs( x[i] );
+    }
+    return sum;
+}
+
+template< typename T >
+static T amax_scalar( magma_int_t n, const T *x )
+{
+    T amax = 0;
+    for (magma_int_t i = 0; i < n; ++i) {
+        T a = std::abs( x[i] );
+        if (a != a) {
+            return a;
+        }
+        amax = (a > amax ? a : amax);
+    }
+    return amax;
+}
+
+template< typename T >
+static T sumsq_scalar( magma_int_t n, const T *x, T s )
+{
+    T sum = 0;
+    for (magma_int_t i = 0; i < n; ++i) {
+        T t = s * x[i];
+        sum += t * t;
+    }
+    return sum;
+}
+
+template< typename T >
+static T dot_scalar( magma_int_t n, const T *x, const T *y )
+{
+    T sum = 0;
+    for (magma_int_t i = 0; i < n; ++i) {
+        sum += x[i] * y[i];
+    }
+    return sum;
+}
+
+// sums = [ sum xr*yr, sum xi*yi, sum xr*yi, sum xi*yr ]
+template< typename T >
+static void dot_complex_scalar( magma_int_t n, const T *x, const T *y, T sums[4] )
+{
+    for (magma_int_t i = 0; i < n; ++i) {
+        sums[0] += x[2*i  ] * y[2*i  ];
+        sums[1] += x[2*i+1] * y[2*i+1];
+        sums[2] += x[2*i  ] * y[2*i+1];
+        sums[3] += x[2*i+1] * y[2*i  ];
+    }
+}
+
+template< typename T >
+static magma_int_t nonfinite_scalar( magma_int_t n, const T *x )
+{
+    const T big = (std::numeric_limits<T>::max)();
+    magma_int_t cnt = 0;
+    for (magma_int_t i = 0; i < n; ++i) {
+        cnt += ! (std::abs( x[i] ) <= big);
+    }
+    return cnt;
+}
+
+template< typename T >
+static const magma_simd_kernels<T>& magma_simd_scalar_kernels()
+{
+    static const magma_simd_kernels<T> kernels = {
+        asum_scalar<T>, amax_scalar<T>, sumsq_scalar<T>,
+        dot_scalar<T>, dot_complex_scalar<T>, nonfinite_scalar<T>
+    };
+    return kernels;
+}
+
+
+#ifdef MAGMA_SIMD_X86
+/******************************************************************************/
+// Vector kernels. V is a vector of reals T; M is the integer vector of the
+// same shape with elements I, which comparisons produce and masks use.
+// Loads are unaligned, since the callers pass arbitrary offsets into
+// matrices. Each kernel is always inlined into a target-specific wrapper
+// below, which decides the instruction set it is compiled for.
+
+#define MAGMA_SIMD_INLINE  inline __attribute__((always_inline))
+
+typedef double    magma_v4d  __attribute__((vector_size(32)));
+typedef long long magma_v4l  __attribute__((vector_size(32)));
+typedef float     magma_v8f  __attribute__((vector_size(32)));
+typedef int       magma_v8i  __attribute__((vector_size(32)));
+typedef double    magma_v8d  __attribute__((vector_size(64)));
+typedef long long magma_v8l  __attribute__((vector_size(64)));
+typedef float     magma_v16f __attribute__((vector_size(64)));
+typedef int       magma_v16i __attribute__((vector_size(64)));
+
+#define VLOAD( v_, ptr_ )  memcpy( &(v_), (ptr_), sizeof(v_) )
+#define VABS( v_ )         ((V) ((M) (v_) & absmask))
+
+// V() is a zero vector; V() + a broadcasts scalar a.
+
+template< typename T, typename V, typename I, typename M >
+static MAGMA_SIMD_INLINE T asum_vec( magma_int_t n, const T *x )
+{
+    const magma_int_t W = sizeof(V)/sizeof(T);
+    const M absmask = M() + (std::numeric_limits<I>::max)();
+    V s0 = V(), s1 = s0, s2 = s0, s3 = s0, v0, v1, v2, v3;
+    magma_int_t i = 0;
+    for (; i + 4*W <= n; i += 4*W) {
+        VLOAD( v0, x + i       );
+        VLOAD( v1, x + i +   W );
+        VLOAD( v2, x + i + 2*W );
+        VLOAD( v3, x + i + 3*W );
+        s0 += VABS( v0 );
+        s1 += VABS( v1 );
+        s2 += VABS( v2 );
+        s3 += VABS( v3 );
+    }
+    for (; i + W <= n; i += W) {
+        VLOAD( v0, x + i );
+        s0 += VABS( v0 );
+    }
+    s0 = (s0 + s1) + (s2 + s3);
+    T sum = 0;
+    for (magma_int_t l = 0; l < W; ++l) {
+        sum += s0[l];
+    }
+    return sum + asum_scalar( n - i, x + i );
+}
+
+template< typename T, typename V, typename I, typename M >
+static MAGMA_SIMD_INLINE T amax_vec( magma_int_t n, const T *x )
+{
+    const magma_int_t W = sizeof(V)/sizeof(T);
+    const M absmask = M() + (std::numeric_limits<I>::max)();
+    V m0 = V(), m1 = m0, v0, v1;
+    M nan = M(), gt;
+    magma_int_t i = 0;
+    for (; i + 2*W <= n; i += 2*W) {
+        VLOAD( v0, x + i     );
+        VLOAD( v1, x + i + W );
+        v0 = VABS( v0 );
+        v1 = VABS( v1 );
+        nan |= (M) (v0 != v0);
+        nan |= (M) (v1 != v1);
+        gt = (M) (v0 > m0);  m0 = (V) (((M) v0 & gt) | ((M) m0 & ~gt));
+        gt = (M) (v1 > m1);  m1 = (V) (((M) v1 & gt) | ((M) m1 & ~gt));
+    }
+    T amax = amax_scalar( n - i, x + i );
+    for (magma_int_t l = 0; l < W; ++l) {
+        if (nan[l]) {
+            return std::numeric_limits<T>::quiet_NaN();
+        }
+        amax = (m0[l] > amax ? m0[l] : amax);
+        amax = (m1[l] > amax ? m1[l] : amax);
+    }
+    return amax;
+}
+
+template< typename T, typename V, typename I, typename M >
+static MAGMA_SIMD_INLINE T sumsq_vec( magma_int_t n, const T *x, T s )
+{
+    const magma_int_t W = sizeof(V)/sizeof(T);
+    const V sv = V() + s;
+    V s0 = V(), s1 = s0, s2 = s0, s3 = s0, v0, v1, v2, v3;
+    magma_int_t i = 0;
+    for (; i + 4*W <= n; i += 4*W) {
+        VLOAD( v0, x + i       );
+        VLOAD( v1, x + i +   W );
+        VLOAD( v2, x + i + 2*W );
+        VLOAD( v3, x + i + 3*W );
+        v0 *= sv;  s0 += v0 * v0;
+        v1 *= sv;  s1 += v1 * v1;
+        v2 *= sv;  s2 += v2 * v2;
+        v3 *= sv;  s3 += v3 * v3;
+    }
+    s0 = (s0 + s1) + (s2 + s3);
+    T sum = 0;
+    for (magma_int_t l = 0; l < W; ++l) {
+        sum += s0[l];
+    }
+    return sum + sumsq_scalar( n - i, x + i, s );
+}
+
+template< typename T, typename V, typename I, typename M >
+static MAGMA_SIMD_INLINE T dot_vec( magma_int_t n, const T *x, const T *y )
+{
+    const magma_int_t W = sizeof(V)/sizeof(T);
+    V s0 = V(), s1 = s0, s2 = s0, s3 = s0, x0, x1, x2, x3, y0, y1, y2, y3;
+    magma_int_t i = 0;
+    for (; i + 4*W <= n; i += 4*W) {
+        VLOAD( x0, x + i       );  VLOAD( y0, y + i       );
+        VLOAD( x1, x + i +   W );  VLOAD( y1, y + i +   W );
+        VLOAD( x2, x + i + 2*W );  VLOAD( y2, y + i + 2*W );
+        VLOAD( x3, x + i + 3*W );  VLOAD( y3, y + i + 3*W );
+        s0 += x0 * y0;
+        s1 += x1 * y1;
+        s2 += x2 * y2;
+        s3 += x3 * y3;
+    }
+    s0 = (s0 + s1) + (s2 + s3);
+    T sum = 0;
+    for (magma_int_t l = 0; l < W; ++l) {
+        sum += s0[l];
+    }
+    return sum + dot_scalar( n - i, x + i, y + i );
+}
+
+// Interleaved complex: x*y gives xr*yr in even lanes and xi*yi in odd lanes.
+// The cross terms come from y shifted by one real either way: x*y[+1] has
+// xr*yi in even lanes, x*y[-1] has xi*yr in odd lanes. The shifted loads
+// stay in bounds by starting the vector loop at the second element and
+// leaving at least one real after it.
+template< typename T, typename V, typename I, typename M >
+static MAGMA_SIMD_INLINE void dot_complex_vec( magma_int_t n, const T *x, const T *y, T sums[4] )
+{
+    const magma_int_t W = sizeof(V)/sizeof(T);
+    V a0 = V(), a1 = a0, c0 = a0, c1 = a0, d0 = a0, d1 = a0;
+    V x0, x1, y0, y1, yp0, yp1, ym0, ym1;
+    dot_complex_scalar( min( n, 1 ), x, y, sums );
+    magma_int_t i = 2;  // in reals
+    for (; i + 2*W < 2*n; i += 2*W) {
+        VLOAD( x0,  x + i         );  VLOAD( x1,  x + i + W     );
+        VLOAD( y0,  y + i         );  VLOAD( y1,  y + i + W     );
+        VLOAD( yp0, y + i + 1     );  VLOAD( yp1, y + i + W + 1 );
+        VLOAD( ym0, y + i - 1     );  VLOAD( ym1, y + i + W - 1 );
+        a0 += x0 * y0;   a1 += x1 * y1;
+        c0 += x0 * yp0;  c1 += x1 * yp1;
+        d0 += x0 * ym0;  d1 += x1 * ym1;
+    }
+    a0 += a1;
+    c0 += c1;
+    d0 += d1;
+    for (magma_int_t l = 0; l < W; l += 2) {
+        sums[0] += a0[l];
+        sums[1] += a0[l+1];
+        sums[2] += c0[l];
+        sums[3] += d0[l+1];
+    }
+    if (n > 1) {
+        dot_complex_scalar( n - i/2, x + i, y + i, sums );
+    }
+}
+
+template< typename T, typename V, typename I, typename M >
+static MAGMA_SIMD_INLINE magma_int_t nonfinite_vec( magma_int_t n, const T *x )
+{
+    const magma_int_t W = sizeof(V)/sizeof(T);
+    const M absmask = M() + (std::numeric_limits<I>::max)();
+    const V big = V() + (std::numeric_limits<T>::max)();
+    // each lane counts at most n/W <= 2^31 for 32-bit I, as callers pass blocks
+    M c0 = M(), c1 = c0;
+    V v0, v1;
+    magma_int_t i = 0;
+    for (; i + 2*W <= n; i += 2*W) {
+        VLOAD( v0, x + i     );
+        VLOAD( v1, x + i + W );
+        c0 += (M) ~(VABS( v0 ) <= big);  // -1 where NAN or INF
+        c1 += (M) ~(VABS( v1 ) <= big);
+    }
+    c0 += c1;
+    magma_int_t cnt = 0;
+    for (magma_int_t l = 0; l < W; ++l) {
+        cnt -= c0[l];
+    }
+    return cnt + nonfinite_scalar( n - i, x + i );
+}
+
+#undef VLOAD
+#undef VABS
+
+#define MAGMA_SIMD_WRAPPERS( suffix_, target_, T, V, I, M )                     \
+    __attribute__((target(target_)))                                           \
+    static T asum_##suffix_( magma_int_t n, const T *x )                        \
+        { return asum_vec<T, V, I, M>( n, x ); }                                \
+    __attribute__((target(target_)))                                           \
+    static T amax_##suffix_( magma_int_t n, const T *x )                        \
+        { return amax_vec<T, V, I, M>( n, x ); }                                \
+    __attribute__((target(target_)))                                           \
+    static T sumsq_##suffix_( magma_int_t n, const T *x, T s )                  \
+        { return sumsq_vec<T, V, I, M>( n, x, s ); }                            \
+    __attribute__((target(target_)))                                           \
+    static T dot_##suffix_( magma_int_t n, const T *x, const T *y )             \
+        { return dot_vec<T, V, I, M>( n, x, y ); }                              \
+    __attribute__((target(target_)))                                           \
+    static void dot_complex_##suffix_( magma_int_t n, const T *x, const T *y, T sums[4] ) \
+        { dot_complex_vec<T, V, I, M>( n, x, y, sums ); }                       \
+    __attribute__((target(target_)))                                           \
+    static magma_int_t nonfinite_##suffix_( magma_int_t n, const T *x )         \
+        { return nonfinite_vec<T, V, I, M>( n, x ); }                           \
+    static const magma_simd_kernels<T> kernels_##suffix_ = {                    \
+        asum_##suffix_, amax_##suffix_, sumsq_##suffix_,                        \
+        dot_##suffix_, dot_complex_##suffix_, nonfinite_##suffix_ };
+
+MAGMA_SIMD_WRAPPERS( avx2_d,   "avx2,fma", double, magma_v4d,  long long, magma_v4l  )
+MAGMA_SIMD_WRAPPERS( avx2_s,   "avx2,fma", float,  magma_v8f,  int,       magma_v8i  )
+MAGMA_SIMD_WRAPPERS( avx512_d, "avx512f",  double, magma_v8d,  long long, magma_v8l  )
+MAGMA_SIMD_WRAPPERS( avx512_s, "avx512f",  float,  magma_v16f, int,       magma_v16i )
+
+#undef MAGMA_SIMD_WRAPPERS
+#endif  // MAGMA_SIMD_X86
+
+
+/******************************************************************************/
+// Instruction set selection.
+static magma_simd_t magma_simd_detect()
+{
+    #ifdef MAGMA_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports( "avx512f" )) {
+        return MagmaSimdAVX512;
+    }
+    if (__builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" )) {
+        return MagmaSimdAVX2;
+    }
+    #endif
+    return MagmaSimdScalar;
+}
+
+static magma_simd_t magma_simd_initial_level()
+{
+    magma_simd_t level = magma_simd_get_max_level();
+    const char* env = getenv( "MAGMA_SIMD" );
+    if (env != NULL) {
+        if      (strcmp( env, "scalar" ) == 0) { level = MagmaSimdScalar; }
+        else if (strcmp( env, "avx2"   ) == 0) { level = min( level, MagmaSimdAVX2 ); }
+        else if (strcmp( env, "avx512" ) == 0) { level = min( level, MagmaSimdAVX512 ); }
+    }
+    return level;
+}
+
+static magma_simd_t& magma_simd_current()
+{
+    static magma_simd_t level = magma_simd_initial_level();
+    return level;
+}
+
+magma_simd_t magma_simd_get_max_level()
+{
+    static const magma_simd_t max_level = magma_simd_detect();
+    return max_level;
+}
+
+magma_simd_t magma_simd_get_level()
+{
+    return magma_simd_current();
+}
+
+/// Sets the instruction set, limited to what the CPU supports.
+/// Intended for testing; not thread safe with concurrent kernel calls.
+void magma_simd_set_level( magma_simd_t level )
+{
+    magma_simd_current() = min( level, magma_simd_get_max_level() );
+}
+
+const char* magma_simd_name( magma_simd_t level )
+{
+    switch (level) {
+        case MagmaSimdAVX512: return "avx512";
+        case MagmaSimdAVX2:   return "avx2";
+        default:              return "scalar";
+    }
+}
+
+template< typename T >
+static const magma_simd_kernels<T>& magma_simd_get_kernels();
+
+template<>
+const magma_simd_kernels<double>& magma_simd_get_kernels<double>()
+{
+    #ifdef MAGMA_SIMD_X86
+    switch (magma_simd_current()) {
+        case MagmaSimdAVX512: return kernels_avx512_d;
+        case MagmaSimdAVX2:   return kernels_avx2_d;
+        default: break;
+    }
+    #endif
+    return magma_simd_scalar_kernels<double>();
+}
+
+template<>
+const magma_simd_kernels<float>& magma_simd_get_kernels<float>()
+{
+    #ifdef MAGMA_SIMD_X86
+    switch (magma_simd_current()) {
+        case MagmaSimdAVX512: return kernels_avx512_s;
+        case MagmaSimdAVX2:   return kernels_avx2_s;
+        default: break;
+    }
+    #endif
+    return magma_simd_scalar_kernels<float>();
+}
+
+
+/******************************************************************************/
+// Splits [0, n) into fixed chunks, applies f( begin, len ) to each, and
+// combines the partial results in chunk order. The chunking depends only on
+// n, so results are the same for any number of threads. Threads are used
+// only once there are enough chunks to amortize the fork, and only outside
+// an OpenMP parallel region; inside one, the caller already owns the cores.
+static const magma_int_t magma_simd_chunk      = 32768;  // multiple of 2 and of any W
+static const magma_int_t magma_simd_par_chunks = 8;
+
+template< typename R, typename F, typename C >
+static R magma_simd_reduce( magma_int_t n, magma_int_t chunk, F f, C combine )
+{
+    magma_int_t nchunk = magma_ceildiv( n, chunk );
+    if (nchunk <= 1) {
+        return f( 0, n );
+    }
+    std::vector<R> part( nchunk );
+    bool parallel = (nchunk >= magma_simd_par_chunks);
+    #if defined(_OPENMP)
+    parallel = parallel && ! omp_in_parallel();
+    #endif
+    #pragma omp parallel for schedule(static) if (parallel)
+    for (magma_int_t c = 0; c < nchunk; ++c) {
+        magma_int_t begin = c*chunk;
+        part[c] = f( begin, min( chunk, n - begin ));
+    }
+    R result = part[0];
+    for (magma_int_t c = 1; c < nchunk; ++c) {
+        result = combine( result, part[c] );
+    }
+    return result;
+}
+
+template< typename T >
+struct magma_simd_sum { T operator()( T a, T b ) const { return a + b; } };
+
+
+/******************************************************************************/
+template< typename T >
+static T magma_simd_asum_t( magma_int_t n, const T *x )
+{
+    if (n <= 0) {
+        return 0;
+    }
+    const magma_simd_kernels<T>& k = magma_simd_get_kernels<T>();
+    return magma_simd_reduce<T>( n, magma_simd_chunk,
+        [&]( magma_int_t i, magma_int_t len ) { return k.asum( len, x + i ); },
+        magma_simd_sum<T>() );
+}
+
+double magma_simd_asum( magma_int_t n, const double *x ) { return magma_simd_asum_t( n, x ); }
+float  magma_simd_asum( magma_int_t n, const float  *x ) { return magma_simd_asum_t( n, x ); }
+
+
+/******************************************************************************/
+// Two passes: amax first, then the sum of squares. If amax is in the range
+// where no square can overflow and any that underflows is negligible
+// (as in Blue's algorithm), the squares are summed unscaled; otherwise x is
+// scaled by the power of two nearest 1/amax, which is exact. Vectors whose
+// largest entry is subnormal use the one pass [sd]lassq recurrence.
+template< typename T >
+static T magma_simd_nrm2_t( magma_int_t n, const T *x )
+{
+    if (n <= 0) {
+        return 0;
+    }
+    const magma_simd_kernels<T>& k = magma_simd_get_kernels<T>();
+    T amax = magma_simd_reduce<T>( n, magma_simd_chunk,
+        [&]( magma_int_t i, magma_int_t len ) { return k.amax( len, x + i ); },
+        []( T a, T b ) { return (a != a || a > b ? a : b); } );
+    if (amax != amax || amax == 0 || amax > (std::numeric_limits<T>::max)()) {
+        return amax;  // NAN, zero vector, or INF
+    }
+
+    const T sfmin = (std::numeric_limits<T>::min)();
+    const T tsml  = std::sqrt( sfmin / std::numeric_limits<T>::epsilon() );
+    const T tbig  = std::sqrt( (std::numeric_limits<T>::max)() / T(n) );
+    int e = 0;
+    T s = 1;
+    if (amax < tsml || amax > tbig) {
+        if (amax < sfmin) {
+            T scale = 0, ssq = 1;
+            for (magma_int_t i = 0; i < n; ++i) {
+                if (x[i] != 0) {
+                    T temp = std::abs( x[i] );
+                    if (scale < temp) {
+                        ssq = 1 + ssq * (scale/temp) * (scale/temp);
+                        scale = temp;
+                    }
+                    else {
+                        ssq += (temp/scale) * (temp/scale);
+                    }
+                }
+            }
+            return scale * std::sqrt( ssq );
+        }
+        e = std::ilogb( amax );
+        s = std::scalbn( T(1), -e );
+    }
+    T ssq = magma_simd_reduce<T>( n, magma_simd_chunk,
+        [&]( magma_int_t i, magma_int_t len ) { return k.sumsq( len, x + i, s ); },
+        magma_simd_sum<T>() );
+    return std::scalbn( std::sqrt( ssq ), e );
+}
+
+double magma_simd_nrm2( magma_int_t n, const double *x ) { return magma_simd_nrm2_t( n, x ); }
+float  magma_simd_nrm2( magma_int_t n, const float  *x ) { return magma_simd_nrm2_t( n, x ); }
+
+
+/******************************************************************************/
+template< typename T >
+static T magma_simd_dot_t( magma_int_t n, const T *x, const T *y )
+{
+    if (n <= 0) {
+        return 0;
+    }
+    const magma_simd_kernels<T>& k = magma_simd_get_kernels<T>();
+    return magma_simd_reduce<T>( n, magma_simd_chunk,
+        [&]( magma_int_t i, magma_int_t len ) { return k.dot( len, x + i, y + i ); },
+        magma_simd_sum<T>() );
+}
+
+double magma_simd_dot( magma_int_t n, const double *x, const double *y ) { return magma_simd_dot_t( n, x, y ); }
+float  magma_simd_dot( magma_int_t n, const float  *x, const float  *y ) { return magma_simd_dot_t( n, x, y ); }
+
+
+/******************************************************************************/
+template< typename T >
+struct magma_simd_sums4 { T s[4]; };
+
+template< typename T >
+static void magma_simd_dot_complex_t(
+    magma_int_t n, const T *x, const T *y, bool conjx, T result[2] )
+{
+    result[0] = 0;
+    result[1] = 0;
+    if (n <= 0) {
+        return;
+    }
+    typedef magma_simd_sums4<T> sums4;
+    const magma_simd_kernels<T>& k = magma_simd_get_kernels<T>();
+    sums4 sums = magma_simd_reduce<sums4>( n, magma_simd_chunk/2,
+        [&]( magma_int_t i, magma_int_t len ) {
+            sums4 r = {{ 0, 0, 0, 0 }};
+            k.dot_complex( len, x + 2*i, y + 2*i, r.s );
+            return r;
+        },
+        []( sums4 a, const sums4& b ) {
+            for (int l = 0; l < 4; ++l) { a.s[l] += b.s[l]; }
+            return a;
+        } );
+    if (conjx) {
+        result[0] = sums.s[0] + sums.s[1];
+        result[1] = sums.s[2] - sums.s[3];
+    }
+    else {
+        result[0] = sums.s[0] - sums.s[1];
+        result[1] = sums.s[2] + sums.s[3];
+    }
+}
+
+void magma_simd_dot_complex( magma_int_t n, const double *x, const double *y, bool conjx, double result[2] )
+    { magma_simd_dot_complex_t( n, x, y, conjx, result ); }
+void magma_simd_dot_complex( magma_int_t n, const float  *x, const float  *y, bool conjx, float  result[2] )
+    { magma_simd_dot_complex_t( n, x, y, conjx, result ); }
+
+
+/******************************************************************************/
+// Blocks are scanned with the vector kernel; the rare blocks that contain a
+// NAN or INF are then classified element by element.
+struct magma_simd_counts { magma_int_t nan, inf; };
+
+template< typename T >
+static void magma_simd_nan_inf_t(
+    magma_int_t n, magma_int_t ncomp, const T *x,
+    magma_int_t *cnt_nan, magma_int_t *cnt_inf )
+{
+    const magma_int_t block = 512;  // multiple of ncomp
+    const magma_simd_kernels<T>& k = magma_simd_get_kernels<T>();
+    magma_simd_counts cnt = { 0, 0 };
+    if (n > 0) {
+        cnt = magma_simd_reduce<magma_simd_counts>( n*ncomp, magma_simd_chunk,
+            [&]( magma_int_t begin, magma_int_t len ) {
+                magma_simd_counts r = { 0, 0 };
+                for (magma_int_t b = begin; b < begin + len; b += block) {
+                    magma_int_t nb = min( block, begin + len - b );
+                    if (k.nonfinite( nb, x + b ) == 0) {
+                        continue;
+                    }
+                    for (magma_int_t i = b; i < b + nb; i += ncomp) {
+                        bool is_nan = false, is_inf = false;
+                        for (magma_int_t c = 0; c < ncomp; ++c) {
+                            is_nan |= std::isnan( x[i+c] );
+                            is_inf |= std::isinf( x[i+c] );
+                        }
+                        if      (is_nan) { r.nan += 1; }
+                        else if (is_inf) { r.inf += 1; }
+                    }
+                }
+                return r;
+            },
+            []( magma_simd_counts a, const magma_simd_counts& b ) {
+                a.nan += b.nan;
+                a.inf += b.inf;
+                return a;
+            } );
+    }
+    if (cnt_nan != NULL) { *cnt_nan = cnt.nan; }
+    if (cnt_inf != NULL) { *cnt_inf = cnt.inf; }
+}
+
+void magma_simd_nan_inf( magma_int_t n, magma_int_t ncomp, const double *x, magma_int_t *cnt_nan, magma_int_t *cnt_inf )
+    { magma_simd_nan_inf_t( n, ncomp, x, cnt_nan, cnt_inf ); }
+void magma_simd_nan_inf( magma_int_t n, magma_int_t ncomp, const float  *x, magma_int_t *cnt_nan, magma_int_t *cnt_inf )
+    { magma_simd_nan_inf_t( n, ncomp, x, cnt_nan, cnt_inf ); }
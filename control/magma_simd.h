@@ -0,0 +1,59 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+
+#ifndef MAGMA_SIMD_H
+#define MAGMA_SIMD_H
+
+#include "magma_types.h"
+
+// =============================================================================
+// Internal routines
+//
+// Vectorised host kernels behind magma_cblas_[dz]asum, magma_cblas_[dz]nrm2,
+// magma_cblas_[zd]dot[uc], and magma_[sdcz]nan_inf. They operate on arrays
+// of reals; a complex vector of n elements is passed as 2n reals.
+// The AVX2 or AVX-512 variant is selected at runtime from the CPU features,
+// with a scalar fallback; the environment variable MAGMA_SIMD=scalar|avx2|avx512
+// lowers the selection. Long vectors are split across OpenMP threads when
+// called outside a parallel region.
+
+typedef enum {
+    MagmaSimdScalar = 0,
+    MagmaSimdAVX2   = 1,
+    MagmaSimdAVX512 = 2
+} magma_simd_t;
+
+magma_simd_t magma_simd_get_max_level();
+magma_simd_t magma_simd_get_level();
+void         magma_simd_set_level( magma_simd_t level );
+const char*  magma_simd_name( magma_simd_t level );
+
+// sum_i |x_i|
+double magma_simd_asum( magma_int_t n, const double *x );
+float  magma_simd_asum( magma_int_t n, const float  *x );
+
+// sqrt( sum_i x_i^2 ), with the over/underflow protection of [sd]nrm2
+double magma_simd_nrm2( magma_int_t n, const double *x );
+float  magma_simd_nrm2( magma_int_t n, const float  *x );
+
+// sum_i x_i y_i
+double magma_simd_dot( magma_int_t n, const double *x, const double *y );
+float  magma_simd_dot( magma_int_t n, const float  *x, const float  *y );
+
+// complex dot product of n interleaved (re, im) pairs; x is conjugated if conjx;
+// result[0] and result[1] are the real and imaginary parts.
+void magma_simd_dot_complex( magma_int_t n, const double *x, const double *y, bool conjx, double result[2] );
+void magma_simd_dot_complex( magma_int_t n, const float  *x, const float  *y, bool conjx, float  result[2] );
+
+// counts NAN and INF elements among n elements of ncomp = 1 (real)
+// or 2 (complex) consecutive values; an element is NAN if any component is
+// NAN, otherwise INF if any component is INF.
+void magma_simd_nan_inf( magma_int_t n, magma_int_t ncomp, const double *x, magma_int_t *cnt_nan, magma_int_t *cnt_inf );
+void magma_simd_nan_inf( magma_int_t n, magma_int_t ncomp, const float  *x, magma_int_t *cnt_nan, magma_int_t *cnt_inf );
+
+#endif  // MAGMA_SIMD_H
@@ -12,6 +12,7 @@
 #include <limits>
 
 #include "magma_internal.h"
+#include "magma_simd.h"  // internal header
 
 #define COMPLEX
 
@@ -148,31 +149,33 @@ magma_int_t magma_znan_inf(
         return info;
     }
     
-    int c_nan = 0;
-    int c_inf = 0;
+    #ifdef COMPLEX
+    const magma_int_t ncomp = 2;  // reals per element
+    #else
+    const magma_int_t ncomp = 1;
+    #endif
     
-    if (uplo == MagmaLower) {
-        for (int j = 0; j < n; ++j) {
-            for (int i = j; i < m; ++i) {  // i >= j
-                if      (magma_z_isnan( *A(i,j) )) { c_nan++; }
-                else if (magma_z_isinf( *A(i,j) )) { c_inf++; }
-            }
-        }
+    // scan columns, or the whole matrix at once if it is contiguous,
+    // with the vectorised kernel; see magma_simd.cpp
+    magma_int_t c_nan = 0;
+    magma_int_t c_inf = 0;
+    magma_int_t col_nan, col_inf;
+    
+    if (uplo == MagmaFull && lda == m) {
+        magma_simd_nan_inf( m*n, ncomp, (const double*) A, &c_nan, &c_inf );
     }
-    else if (uplo == MagmaUpper) {
-        for (int j = 0; j < n; ++j) {
-            for (int i = 0; i < m && i <= j; ++i) {  // i <= j
-                if      (magma_z_isnan( *A(i,j) )) { c_nan++; }
-                else if (magma_z_isinf( *A(i,j) )) { c_inf++; }
+    else {
+        for (magma_int_t j = 0; j < n; ++j) {
+            magma_int_t i1 = 0, i2 = m;  // rows [i1, i2) of column j
+            if (uplo == MagmaLower) {
+                i1 = min( j, m );      // i >= j
             }
-        }
-    }
-    else if (uplo == MagmaFull) {
-        for (int j = 0; j < n; ++j) {
-            for (int i = 0; i < m; ++i) {
-                if      (magma_z_isnan( *A(i,j) )) { c_nan++; }
-                else if (magma_z_isinf( *A(i,j) )) { c_inf++; }
+            else if (uplo == MagmaUpper) {
+                i2 = min( j+1, m );    // i <= j
             }
+            magma_simd_nan_inf( i2 - i1, ncomp, (const double*) A(i1,j), &col_nan, &col_inf );
+            c_nan += col_nan;
+            c_inf += col_inf;
         }
     }
     
@@ -288,3 +288,31 @@ magma_int_t magma_thread_queue::get_thread_index( pthread_t thread ) const
     }
     return -1;
 }
+
+
+/***************************************************************************//**
+    Adds a dependency: this task will not be pushed until task has run.
+    Must be called before either task is pushed to the queue.
+    @param[in] task    Task that must run before this task.
+*******************************************************************************/
+void magma_graph_task::add_dependency( magma_graph_task* task )
+{
+    task->successors.push_back( this );
+    ndep += 1;
+}
+
+
+/***************************************************************************//**
+    Executes task, then pushes each successor whose last dependency this was.
+    Successors are pushed before this task is marked done, so the queue's
+    count of outstanding tasks does not drop to zero in between.
+*******************************************************************************/
+void magma_graph_task::run()
+{
+    run_task();
+    for( size_t i=0; i < successors.size(); ++i ) {
+        if ( --successors[i]->ndep == 0 ) {
+            queue->push_task( successors[i] );
+        }
+    }
+}
@@ -11,7 +11,9 @@
 #ifndef MAGMA_THREAD_HPP
 #define MAGMA_THREAD_HPP
 
+#include <atomic>
 #include <queue>
+#include <vector>
 
 #include "magma_internal.h"
 
@@ -66,4 +68,34 @@ private:
     magma_int_t     nthread;      ///<  number of threads
 };
 
+
+/***************************************************************************//**
+    Super class for tasks with dependencies, used with \ref magma_thread_queue.
+    A task is pushed to the queue when all tasks it depends on have run.
+    Build the whole graph with add_dependency() before pushing any task,
+    then push the tasks that are ready(); successors are pushed by the
+    worker thread that completes their last dependency, so sync() waits
+    for the whole graph. Each sub-class implements run_task().
+    @ingroup magma_thread
+*******************************************************************************/
+class magma_graph_task: public magma_task
+{
+public:
+    magma_graph_task( magma_thread_queue* in_queue ):
+        queue( in_queue ),
+        ndep( 0 )
+    {}
+    
+    void add_dependency( magma_graph_task* task );
+    bool ready() const { return ndep == 0; }
+    
+    virtual void run();
+    virtual void run_task() = 0;  // pure virtual function to execute task
+    
+private:
+    magma_thread_queue* queue;
+    std::atomic< magma_int_t > ndep;    ///<  number of unfinished dependencies
+    std::vector< magma_graph_task* > successors;
+};
+
 #endif        //  #ifndef MAGMA_THREAD_HPP
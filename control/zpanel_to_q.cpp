@@ -8,6 +8,8 @@
        @author Mark Gates
        @precisions normal z -> s d c
 */
+#include <string.h>
+
 #include "magma_internal.h"
 
 /***************************************************************************//**
@@ -19,6 +21,8 @@
 extern "C"
 void magma_zpanel_to_q(magma_uplo_t uplo, magma_int_t ib, magmaDoubleComplex *A, magma_int_t lda, magmaDoubleComplex *work)
 {
+    // each column's saved part is contiguous, in both A and work,
+    // so copy it as one block, then overwrite it
     magma_int_t i, j, k = 0;
     magmaDoubleComplex *col;
     magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
@@ -27,27 +31,22 @@ void magma_zpanel_to_q(magma_uplo_t uplo, magma_int_t ib, magmaDoubleComplex *A,
     if (uplo == MagmaUpper) {
         for (i = 0; i < ib; ++i) {
             col = A + i*lda;
+            memcpy( work + k, col, (i+1)*sizeof(magmaDoubleComplex) );
+            k += i+1;
             for (j = 0; j < i; ++j) {
-                work[k] = col[j];
-                col [j] = c_zero;
-                ++k;
+                col[j] = c_zero;
             }
-            
-            work[k] = col[i];
-            col [j] = c_one;
-            ++k;
+            col[i] = c_one;
         }
     }
     else {
-        for (i=0; i < ib; ++i) {
+        for (i = 0; i < ib; ++i) {
             col = A + i*lda;
-            work[k] = col[i];
-            col [i] = c_one;
-            ++k;
-            for (j=i+1; j < ib; ++j) {
-                work[k] = col[j];
-                col [j] = c_zero;
-                ++k;
+            memcpy( work + k, col + i, (ib-i)*sizeof(magmaDoubleComplex) );
+            k += ib-i;
+            col[i] = c_one;
+            for (j = i+1; j < ib; ++j) {
+                col[j] = c_zero;
             }
         }
     }
@@ -62,25 +61,18 @@ void magma_zpanel_to_q(magma_uplo_t uplo, magma_int_t ib, magmaDoubleComplex *A,
 extern "C"
 void magma_zq_to_panel(magma_uplo_t uplo, magma_int_t ib, magmaDoubleComplex *A, magma_int_t lda, magmaDoubleComplex *work)
 {
-    magma_int_t i, j, k = 0;
-    magmaDoubleComplex *col;
+    magma_int_t i, k = 0;
     
     if (uplo == MagmaUpper) {
         for (i = 0; i < ib; ++i) {
-            col = A + i*lda;
-            for (j = 0; j <= i; ++j) {
-                col[j] = work[k];
-                ++k;
-            }
+            memcpy( A + i*lda, work + k, (i+1)*sizeof(magmaDoubleComplex) );
+            k += i+1;
         }
     }
     else {
         for (i = 0; i < ib; ++i) {
-            col = A + i*lda;
-            for (j = i; j < ib; ++j) {
-                col[j] = work[k];
-                ++k;
-            }
+            memcpy( A + i + i*lda, work + k, (ib-i)*sizeof(magmaDoubleComplex) );
+            k += ib-i;
         }
     }
 }
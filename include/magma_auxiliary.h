@@ -106,6 +106,30 @@ magma_free_pinned_internal(
     void *ptr,
     const char* func, const char* file, int line );
 
+// caching of host memory from magma_malloc_cpu and magma_malloc_pinned,
+// disabled by default
+typedef struct magma_host_cache_stats {
+    long long hits;          // allocations served from the cache
+    long long misses;        // allocations passed to the system
+    long long bytes_in_use;  // bytes allocated through the cache, not yet freed
+    long long bytes_cached;  // bytes kept for reuse
+    long long peak_bytes;    // max. of bytes_in_use + bytes_cached
+} magma_host_cache_stats_t;
+
+void
+magma_host_cache_set_enabled( magma_int_t enable );
+
+magma_int_t
+magma_host_cache_get_enabled( void );
+
+void
+magma_host_cache_release( void );
+
+void
+magma_host_cache_get_stats(
+    magma_host_cache_stats_t *cpu_stats,
+    magma_host_cache_stats_t *pinned_stats );
+
 // returns memory info (basically a wrapper around cudaMemGetInfo
 magma_int_t
 magma_mem_info(size_t* freeMem, size_t* totalMem);
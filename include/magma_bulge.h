@@ -38,6 +38,14 @@ extern "C" {
 
     magma_int_t magma_bulge_get_blkcnt(magma_int_t n, magma_int_t nb, magma_int_t Vblksiz);
 
+    magma_int_t magma_bulge_get_cachesize(magma_int_t level);
+
+    void magma_bulge_get_applyQ_blk(magma_int_t n, magma_int_t nb, magma_int_t Vblksiz, magma_int_t ncol,
+                                    magma_int_t threads, magma_int_t elsize,
+                                    magma_int_t *nb_loc, magma_int_t *grsiz);
+
+    magma_int_t magma_bulge_get_gcperf();
+
     void findVTpos(magma_int_t n, magma_int_t nb, magma_int_t Vblksiz, magma_int_t sweep, magma_int_t st, magma_int_t *Vpos, magma_int_t *TAUpos, magma_int_t *Tpos, magma_int_t *myblkid);
 
 #ifdef __cplusplus
@@ -730,7 +730,8 @@ typedef enum {
     Magma_CSRCOO       = 629,
     Magma_CUCSR        = 630,
     Magma_COOLIST      = 631,
-    Magma_CSR5         = 632
+    Magma_CSR5         = 632,
+    Magma_STENCIL      = 633
 } magma_storage_t;
 
 
@@ -792,7 +793,12 @@ typedef enum {
     Magma_VBJACOBI     = 508,
     Magma_PARDISO      = 509,
     Magma_SYNCFREESOLVE= 510,
-    Magma_ILUT         = 511
+    Magma_ILUT         = 511,
+    Magma_PIPECG       = 512,
+    Magma_AMG          = 513,
+    Magma_CHEBYSHEV    = 514,
+    Magma_SGS          = 515,
+    Magma_RAS          = 516
 } magma_solver_type;
 
 typedef enum {
@@ -832,6 +838,7 @@ typedef enum {
     Magma_UNITCOL      = 514,
     Magma_UNITROWCOL   = 515, // to be deprecated
     Magma_UNITDIAGCOL  = 516, // to be deprecated
+    Magma_RUIZ         = 517,
 } magma_scale_t;
 
 
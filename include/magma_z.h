@@ -98,6 +98,29 @@ magma_zvrange(
 void
 magma_zirange(
     magma_int_t k, magma_int_t *indxq, magma_int_t *iil, magma_int_t *iiu, magma_int_t il, magma_int_t iu);
+
+// bidiagonal divide and conquer SVD, used by [zcds]gesdd
+magma_int_t
+magma_zbdsdc(
+    magma_uplo_t uplo, magma_vec_t compq, magma_range_t range,
+    magma_int_t n, double *d, double *e,
+    double *U, magma_int_t ldu,
+    double *VT, magma_int_t ldvt,
+    double vl, double vu, magma_int_t il, magma_int_t iu,
+    magma_int_t *nfound,
+    double *work, magma_int_t *iwork,
+    magma_int_t *info);
+
+// bisection for symmetric tridiagonal eigenvalues, used by [zcds]{he,sy}ev[xr]
+magma_int_t
+magma_zstebz(
+    magma_range_t range, magma_bool_t byblock, magma_int_t n,
+    double vl, double vu, magma_int_t il, magma_int_t iu, double abstol,
+    const double *d, const double *e,
+    magma_int_t *m, magma_int_t *nsplit,
+    double *w, magma_int_t *iblock, magma_int_t *isplit,
+    double *work, magma_int_t *iwork,
+    magma_int_t *info);
 #endif  // MAGMA_REAL
 
 // ---------------------------------------------------------------- zgb routines
@@ -1267,6 +1290,14 @@ magma_dlaex1_m(
     magma_range_t range, double vl, double vu,
     magma_int_t il, magma_int_t iu, magma_int_t *info);
 
+void
+magma_dlaed4_range(
+    magma_int_t n, magma_int_t ifirst, magma_int_t ilast,
+    const double *d, const double *z,
+    double *delta, magma_int_t lddelta,
+    double rho, double *dlam,
+    magma_int_t *info);
+
 magma_int_t
 magma_dlaex3(
     magma_int_t k, magma_int_t n, magma_int_t n1, double *d,
@@ -1293,6 +1324,21 @@ magma_dlaex3_m(
     magma_int_t *info);
 #endif  // MAGMA_REAL
 
+// ------------------------------------------------------------ zhs routines
+magma_int_t
+magma_zhseqr_mt(
+    magma_vec_t jobt, magma_vec_t compz,
+    magma_int_t n, magma_int_t ilo, magma_int_t ihi,
+    magmaDoubleComplex *H, magma_int_t ldh,
+    #ifdef MAGMA_COMPLEX
+    magmaDoubleComplex *w,
+    #else
+    double *wr, double *wi,
+    #endif
+    magmaDoubleComplex *Z, magma_int_t ldz,
+    magmaDoubleComplex *work, magma_int_t lwork,
+    magma_int_t *info);
+
 magma_int_t
 magma_zlabrd_gpu(
     magma_int_t m, magma_int_t n, magma_int_t nb,
@@ -1669,6 +1715,28 @@ magma_zstedx(
     magmaDouble_ptr dwork,
     magma_int_t *info);
 
+magma_int_t
+magma_zstein(
+    magma_int_t n, const double *d, const double *e,
+    magma_int_t m, const double *w,
+    const magma_int_t *iblock, const magma_int_t *isplit,
+    magmaDoubleComplex *Z, magma_int_t ldz,
+    double *work, magma_int_t *iwork,
+    magma_int_t *ifail,
+    magma_int_t *info);
+
+magma_int_t
+magma_zstemr(
+    magma_vec_t jobz, magma_range_t range, magma_int_t n,
+    double *d, double *e,
+    double vl, double vu, magma_int_t il, magma_int_t iu,
+    magma_int_t *m, double *w,
+    magmaDoubleComplex *Z, magma_int_t ldz, magma_int_t nzc,
+    magma_int_t *isuppz, magma_int_t *tryrac,
+    double *work, magma_int_t lwork,
+    magma_int_t *iwork, magma_int_t liwork,
+    magma_int_t *info);
+
 // CUDA MAGMA only
 magma_int_t
 magma_zstedx_m(
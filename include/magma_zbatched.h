@@ -1254,6 +1254,46 @@ magma_zpotrf_v33_batched(
     magma_int_t batchCount, magma_queue_t queue);
 
 // host interface
+magma_int_t
+magma_zgetrf_batched_cpu(
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    magma_int_t **ipiv_array, magma_int_t *info_array,
+    magma_int_t batchCount );
+
+magma_int_t
+magma_zpotrf_batched_cpu(
+    magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    magma_int_t *info_array,
+    magma_int_t batchCount );
+
+magma_int_t
+magma_zgeqrf_batched_cpu(
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    magmaDoubleComplex **tau_array,
+    magma_int_t *info_array,
+    magma_int_t batchCount );
+
+magma_int_t
+magma_zheevj_batched_cpu(
+    magma_vec_t jobz, magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    double **hW_array,
+    magma_int_t *info_array,
+    magma_int_t batchCount );
+
+magma_int_t
+magma_zgesvdj_batched_cpu(
+    magma_vec_t jobz, magma_int_t m, magma_int_t n,
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    double **hS_array,
+    magmaDoubleComplex **hU_array, magma_int_t ldu,
+    magmaDoubleComplex **hV_array, magma_int_t ldv,
+    magma_int_t *info_array,
+    magma_int_t batchCount );
+
 void
 blas_zlacpy_batched(
     magma_uplo_t uplo, magma_int_t m, magma_int_t n,
@@ -53,6 +53,16 @@ magma_zcgetrs_gpu(
     magmaFloatComplex_ptr dSX,
     magma_int_t *info);
 
+magma_int_t
+magma_zcheevd(
+    magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda,
+    double *w,
+    double *resid,
+    real_Double_t *time,
+    magma_int_t *iter,
+    magma_int_t *info);
+
 // CUDA MAGMA only
 magma_int_t
 magma_zchesv_gpu(
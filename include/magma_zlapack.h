@@ -53,9 +53,24 @@ extern "C" {
 
 #define lapackf77_dlaed2   FORTRAN_NAME( dlaed2, DLAED2 )
 #define lapackf77_dlaed4   FORTRAN_NAME( dlaed4, DLAED4 )
+#define lapackf77_dlaed5   FORTRAN_NAME( dlaed5, DLAED5 )
+#define lapackf77_dlaed6   FORTRAN_NAME( dlaed6, DLAED6 )
+#define lapackf77_dlagtf   FORTRAN_NAME( dlagtf, DLAGTF )
+#define lapackf77_dlagts   FORTRAN_NAME( dlagts, DLAGTS )
 #define lapackf77_dlaln2   FORTRAN_NAME( dlaln2, DLALN2 )
 #define lapackf77_dlamc3   FORTRAN_NAME( dlamc3, DLAMC3 )
 #define lapackf77_dlamrg   FORTRAN_NAME( dlamrg, DLAMRG )
+#define lapackf77_dlar1v   FORTRAN_NAME( dlar1v, DLAR1V )
+#define lapackf77_dlarrb   FORTRAN_NAME( dlarrb, DLARRB )
+#define lapackf77_dlarre   FORTRAN_NAME( dlarre, DLARRE )
+#define lapackf77_dlarrf   FORTRAN_NAME( dlarrf, DLARRF )
+#define lapackf77_dlarrj   FORTRAN_NAME( dlarrj, DLARRJ )
+#define lapackf77_dlarrr   FORTRAN_NAME( dlarrr, DLARRR )
+#define lapackf77_dlasd2   FORTRAN_NAME( dlasd2, DLASD2 )
+#define lapackf77_dlasd4   FORTRAN_NAME( dlasd4, DLASD4 )
+#define lapackf77_dlasdq   FORTRAN_NAME( dlasdq, DLASDQ )
+#define lapackf77_dlasdt   FORTRAN_NAME( dlasdt, DLASDT )
+#define lapackf77_dlasr    FORTRAN_NAME( dlasr,  DLASR  )
 #define lapackf77_dlasrt   FORTRAN_NAME( dlasrt, DLASRT )
 #define lapackf77_dstebz   FORTRAN_NAME( dstebz, DSTEBZ )
 
@@ -108,6 +123,7 @@ extern "C" {
 #define lapackf77_zlacrm   FORTRAN_NAME( zlacrm, ZLACRM )
 #define lapackf77_zladiv   FORTRAN_NAME( zladiv, ZLADIV )
 #define lapackf77_zlahef   FORTRAN_NAME( zlahef, ZLAHEF )
+#define lapackf77_zlahqr   FORTRAN_NAME( zlahqr, ZLAHQR )
 #define lapackf77_zlangb   FORTRAN_NAME( zlangb, ZLANGB )
 #define lapackf77_zlange   FORTRAN_NAME( zlange, ZLANGE )
 #define lapackf77_zlanhe   FORTRAN_NAME( zlanhe, ZLANHE )
@@ -144,6 +160,7 @@ extern "C" {
 #define lapackf77_zsysv    FORTRAN_NAME( zsysv,  ZSYSV  )
 #define lapackf77_ztrevc   FORTRAN_NAME( ztrevc, ZTREVC )
 #define lapackf77_ztrevc3  FORTRAN_NAME( ztrevc3, ZTREVC3 )
+#define lapackf77_ztrexc   FORTRAN_NAME( ztrexc, ZTREXC )
 #define lapackf77_ztrtri   FORTRAN_NAME( ztrtri, ZTRTRI )
 #define lapackf77_zung2r   FORTRAN_NAME( zung2r, ZUNG2R )
 #define lapackf77_zungbr   FORTRAN_NAME( zungbr, ZUNGBR )
@@ -154,6 +171,7 @@ extern "C" {
 #define lapackf77_zungtr   FORTRAN_NAME( zungtr, ZUNGTR )
 #define lapackf77_zunm2r   FORTRAN_NAME( zunm2r, ZUNM2R )
 #define lapackf77_zunmbr   FORTRAN_NAME( zunmbr, ZUNMBR )
+#define lapackf77_zunmhr   FORTRAN_NAME( zunmhr, ZUNMHR )
 #define lapackf77_zunmlq   FORTRAN_NAME( zunmlq, ZUNMLQ )
 #define lapackf77_zunmql   FORTRAN_NAME( zunmql, ZUNMQL )
 #define lapackf77_zunmqr   FORTRAN_NAME( zunmqr, ZUNMQR )
@@ -785,6 +803,19 @@ void   lapackf77_zlahef( const char *uplo,
                          magmaDoubleComplex *work, const magma_int_t *ldwork,
                          magma_int_t *info );
 
+void   lapackf77_zlahqr( const magma_int_t *wantt, const magma_int_t *wantz,
+                         const magma_int_t *n,
+                         const magma_int_t *ilo, const magma_int_t *ihi,
+                         magmaDoubleComplex *H, const magma_int_t *ldh,
+                         #ifdef MAGMA_COMPLEX
+                         magmaDoubleComplex *w,
+                         #else
+                         double *wr, double *wi,
+                         #endif
+                         const magma_int_t *iloz, const magma_int_t *ihiz,
+                         magmaDoubleComplex *Z, const magma_int_t *ldz,
+                         magma_int_t *info );
+
 double lapackf77_zlangb( const char *norm,
                          const magma_int_t *n, const magma_int_t *kl, const magma_int_t *ku,
                          const magmaDoubleComplex *AB, const magma_int_t *ldab,
@@ -1034,6 +1065,18 @@ void   lapackf77_ztrevc3( const char *side, const char *howmny,
                           #endif
                           magma_int_t *info );
 
+void   lapackf77_ztrexc( const char *compq,
+                         const magma_int_t *n,
+                         magmaDoubleComplex *T, const magma_int_t *ldt,
+                         magmaDoubleComplex *Q, const magma_int_t *ldq,
+                         #ifdef MAGMA_COMPLEX
+                         const magma_int_t *ifst, const magma_int_t *ilst,
+                         #else
+                         magma_int_t *ifst, magma_int_t *ilst,
+                         double *work,
+                         #endif
+                         magma_int_t *info );
+
 void   lapackf77_ztrtri( const char *uplo, const char *diag,
                          const magma_int_t *n,
                          magmaDoubleComplex *A, const magma_int_t *lda,
@@ -1100,6 +1143,15 @@ void   lapackf77_zunmbr( const char *vect, const char *side, const char *trans,
                          magmaDoubleComplex *work, const magma_int_t *lwork,
                          magma_int_t *info );
 
+void   lapackf77_zunmhr( const char *side, const char *trans,
+                         const magma_int_t *m, const magma_int_t *n,
+                         const magma_int_t *ilo, const magma_int_t *ihi,
+                         const magmaDoubleComplex *A, const magma_int_t *lda,
+                         const magmaDoubleComplex *tau,
+                         magmaDoubleComplex *C, const magma_int_t *ldc,
+                         magmaDoubleComplex *work, const magma_int_t *lwork,
+                         magma_int_t *info );
+
 void   lapackf77_zunmlq( const char *side, const char *trans,
                          const magma_int_t *m, const magma_int_t *n, const magma_int_t *k,
                          const magmaDoubleComplex *A, const magma_int_t *lda,
@@ -1194,6 +1246,137 @@ void   lapackf77_dlaed4( const magma_int_t *n, const magma_int_t *i,
                          double *dlam,
                          magma_int_t *info );
 
+void   lapackf77_dlaed5( const magma_int_t *i,
+                         const double *d,
+                         const double *z,
+                         double *delta,
+                         const double *rho,
+                         double *dlam );
+
+void   lapackf77_dlaed6( const magma_int_t *kniter, const magma_int_t *orgati,
+                         const double *rho,
+                         const double *d,
+                         const double *z,
+                         const double *finit,
+                         double *tau,
+                         magma_int_t *info );
+
+void   lapackf77_dlagtf( const magma_int_t *n,
+                         double *a, const double *lambda,
+                         double *b, double *c,
+                         const double *tol, double *d,
+                         magma_int_t *in,
+                         magma_int_t *info );
+
+void   lapackf77_dlagts( const magma_int_t *job, const magma_int_t *n,
+                         const double *a, const double *b,
+                         const double *c, const double *d,
+                         const magma_int_t *in,
+                         double *y, double *tol,
+                         magma_int_t *info );
+
+void   lapackf77_dlar1v( const magma_int_t *n,
+                         const magma_int_t *b1, const magma_int_t *bn,
+                         const double *lambda,
+                         const double *d, const double *l,
+                         const double *ld, const double *lld,
+                         const double *pivmin, const double *gaptol,
+                         double *z, const magma_int_t *wantnc,
+                         magma_int_t *negcnt, double *ztz, double *mingma,
+                         magma_int_t *r, magma_int_t *isuppz,
+                         double *nrminv, double *resid, double *rqcorr,
+                         double *work );
+
+void   lapackf77_dlarrb( const magma_int_t *n,
+                         const double *d, const double *lld,
+                         const magma_int_t *ifirst, const magma_int_t *ilast,
+                         const double *rtol1, const double *rtol2,
+                         const magma_int_t *offset,
+                         double *w, double *wgap, double *werr,
+                         double *work, magma_int_t *iwork,
+                         const double *pivmin, const double *spdiam,
+                         const magma_int_t *twist,
+                         magma_int_t *info );
+
+void   lapackf77_dlarre( const char *range, const magma_int_t *n,
+                         double *vl, double *vu,
+                         const magma_int_t *il, const magma_int_t *iu,
+                         double *d, double *e, double *e2,
+                         const double *rtol1, const double *rtol2,
+                         const double *spltol,
+                         magma_int_t *nsplit, magma_int_t *isplit,
+                         magma_int_t *m,
+                         double *w, double *werr, double *wgap,
+                         magma_int_t *iblock, magma_int_t *indexw,
+                         double *gers, double *pivmin,
+                         double *work, magma_int_t *iwork,
+                         magma_int_t *info );
+
+void   lapackf77_dlarrf( const magma_int_t *n,
+                         const double *d, const double *l, const double *ld,
+                         const magma_int_t *clstrt, const magma_int_t *clend,
+                         const double *w, double *wgap, const double *werr,
+                         const double *spdiam,
+                         const double *clgapl, const double *clgapr,
+                         const double *pivmin, double *sigma,
+                         double *dplus, double *lplus,
+                         double *work,
+                         magma_int_t *info );
+
+void   lapackf77_dlarrj( const magma_int_t *n,
+                         const double *d, const double *e2,
+                         const magma_int_t *ifirst, const magma_int_t *ilast,
+                         const double *rtol, const magma_int_t *offset,
+                         double *w, double *werr,
+                         double *work, magma_int_t *iwork,
+                         const double *pivmin, const double *spdiam,
+                         magma_int_t *info );
+
+void   lapackf77_dlarrr( const magma_int_t *n,
+                         const double *d, double *e,
+                         magma_int_t *info );
+
+void   lapackf77_dlasd2( const magma_int_t *nl, const magma_int_t *nr, const magma_int_t *sqre,
+                         magma_int_t *k,
+                         double *d, double *z,
+                         const double *alpha, const double *beta,
+                         double *U, const magma_int_t *ldu,
+                         double *VT, const magma_int_t *ldvt,
+                         double *dsigma,
+                         double *U2, const magma_int_t *ldu2,
+                         double *VT2, const magma_int_t *ldvt2,
+                         magma_int_t *idxp, magma_int_t *idx, magma_int_t *idxc,
+                         magma_int_t *idxq, magma_int_t *coltyp,
+                         magma_int_t *info );
+
+void   lapackf77_dlasd4( const magma_int_t *n, const magma_int_t *i,
+                         const double *d,
+                         const double *z,
+                         double *delta,
+                         const double *rho,
+                         double *sigma,
+                         double *work,
+                         magma_int_t *info );
+
+void   lapackf77_dlasdq( const char *uplo, const magma_int_t *sqre,
+                         const magma_int_t *n, const magma_int_t *ncvt,
+                         const magma_int_t *nru, const magma_int_t *ncc,
+                         double *d, double *e,
+                         double *VT, const magma_int_t *ldvt,
+                         double *U, const magma_int_t *ldu,
+                         double *C, const magma_int_t *ldc,
+                         double *work,
+                         magma_int_t *info );
+
+void   lapackf77_dlasdt( const magma_int_t *n, magma_int_t *lvl, magma_int_t *nd,
+                         magma_int_t *inode, magma_int_t *ndiml, magma_int_t *ndimr,
+                         const magma_int_t *msub );
+
+void   lapackf77_dlasr( const char *side, const char *pivot, const char *direct,
+                        const magma_int_t *m, const magma_int_t *n,
+                        const double *c, const double *s,
+                        double *A, const magma_int_t *lda );
+
 void   lapackf77_dlasrt( const char *id, const magma_int_t *n, double *d,
                          magma_int_t *info );
 
@@ -884,6 +884,20 @@ magmablas_zlacpy_vbatched(
     magmaDoubleComplex**               dBarray, magma_int_t* lddb,
     magma_int_t batchCount, magma_queue_t queue );
 
+  /*
+   *  host interface
+   */
+void
+blas_zgemm_vbatched(
+    magma_trans_t transA, magma_trans_t transB,
+    magma_int_t *m, magma_int_t *n, magma_int_t *k,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex const * const * hA_array, magma_int_t *lda,
+    magmaDoubleComplex const * const * hB_array, magma_int_t *ldb,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex **hC_array, magma_int_t *ldc,
+    magma_int_t batchCount );
+
   /*
    *  Aux. vbatched routines
    */
@@ -21,6 +21,7 @@
 #include "magma_v2.h"
 #include "magma_internal.h"
 #include "error.h"
+#include "magma_host_cache.h"
 
 //#ifdef MAGMA_HAVE_CUDA
 
@@ -33,6 +34,52 @@ std::map< void*, size_t > g_pointers_pin;
 #endif
 
 
+/******************************************************************************/
+// System allocators behind the host memory cache, see magma_host_cache.h.
+static void* magma_malloc_cpu_system( size_t size, size_t alignment )
+{
+#if defined( _WIN32 ) || defined( _WIN64 )
+    return _aligned_malloc( size, alignment );
+#else
+    void* ptr;
+    if ( posix_memalign( &ptr, alignment, size ) != 0 ) {
+        return NULL;
+    }
+    return ptr;
+#endif
+}
+
+static void magma_free_cpu_system( void* ptr )
+{
+#if defined( _WIN32 ) || defined( _WIN64 )
+    _aligned_free( ptr );
+#else
+    free( ptr );
+#endif
+}
+
+// cudaHostAlloc returns page aligned memory; the alignment is ignored
+static void* magma_malloc_pinned_system( size_t size, size_t /* alignment */ )
+{
+    void* ptr;
+    if ( cudaSuccess != cudaHostAlloc( &ptr, size, cudaHostAllocPortable )) {
+        return NULL;
+    }
+    return ptr;
+}
+
+static void magma_free_pinned_system( void* ptr )
+{
+    cudaFreeHost( ptr );
+}
+
+static const magma_host_cache_backend_t g_cpu_backend =
+    { magma_malloc_cpu_system, magma_free_cpu_system };
+
+static const magma_host_cache_backend_t g_pinned_backend =
+    { magma_malloc_pinned_system, magma_free_pinned_system };
+
+
 /***************************************************************************//**
     Allocates memory on the GPU. CUDA imposes a synchronization.
     Use magma_free() to free this memory.
@@ -120,6 +167,8 @@ magma_free_internal( magma_ptr ptr,
     for vector (SSE, AVX) instructions. The default implementation uses
     posix_memalign (on Linux, MacOS, etc.) or _aligned_malloc (on Windows)
     to align memory to a 64 byte boundary (typical cache line size).
+    If the host memory cache is enabled, the memory is taken from it,
+    see magma_host_cache_set_enabled().
     Use magma_free_cpu() to free this memory.
 
     @param[out]
@@ -148,25 +197,12 @@ magma_malloc_cpu( void** ptrPtr, size_t size )
     // malloc and free sometimes don't work for size=0, so allocate some minimal size
     if ( size == 0 )
         size = sizeof(magmaDoubleComplex);
-#if 1
-#if defined( _WIN32 ) || defined( _WIN64 )
-    *ptrPtr = _aligned_malloc( size, 64 );
-    if ( *ptrPtr == NULL ) {
-        return MAGMA_ERR_HOST_ALLOC;
+    if ( ! magma_host_cache_malloc( MagmaHostCacheCPU, size, ptrPtr, &g_cpu_backend )) {
+        *ptrPtr = magma_malloc_cpu_system( size, 64 );
     }
-#else
-    int err = posix_memalign( ptrPtr, 64, size );
-    if ( err != 0 ) {
-        *ptrPtr = NULL;
-        return MAGMA_ERR_HOST_ALLOC;
-    }
-#endif
-#else
-    *ptrPtr = malloc( size );
     if ( *ptrPtr == NULL ) {
         return MAGMA_ERR_HOST_ALLOC;
     }
-#endif
 
     #ifdef DEBUG_MEMORY
     g_pointers_mutex.lock();
@@ -183,6 +219,7 @@ magma_malloc_cpu( void** ptrPtr, size_t size )
     The default implementation uses free(),
     which works for both malloc and posix_memalign.
     For Windows, _aligned_free() is used.
+    Memory from the host memory cache is returned to it.
 
     @param[in]
     ptr     Pointer to free.
@@ -206,17 +243,17 @@ magma_free_cpu( void* ptr )
     g_pointers_mutex.unlock();
     #endif
 
-#if defined( _WIN32 ) || defined( _WIN64 )
-    _aligned_free( ptr );
-#else
-    free( ptr );
-#endif
+    if ( ! magma_host_cache_free( MagmaHostCacheCPU, ptr )) {
+        magma_free_cpu_system( ptr );
+    }
     return MAGMA_SUCCESS;
 }
 
 
 /***************************************************************************//**
     Allocates memory on the CPU in pinned memory.
+    If the host memory cache is enabled, the memory is taken from it,
+    see magma_host_cache_set_enabled().
     Use magma_free_pinned() to free this memory.
 
     @param[out]
@@ -246,7 +283,12 @@ magma_malloc_pinned( void** ptrPtr, size_t size )
     // (for pinned memory, the error is detected in free)
     if ( size == 0 )
         size = sizeof(magmaDoubleComplex);
-    if ( cudaSuccess != cudaHostAlloc( ptrPtr, size, cudaHostAllocPortable )) {
+    if ( magma_host_cache_malloc( MagmaHostCachePinned, size, ptrPtr, &g_pinned_backend )) {
+        if ( *ptrPtr == NULL ) {
+            return MAGMA_ERR_HOST_ALLOC;
+        }
+    }
+    else if ( cudaSuccess != cudaHostAlloc( ptrPtr, size, cudaHostAllocPortable )) {
         return MAGMA_ERR_HOST_ALLOC;
     }
 
@@ -288,6 +330,9 @@ magma_free_pinned_internal( void* ptr,
     g_pointers_mutex.unlock();
     #endif
 
+    if ( magma_host_cache_free( MagmaHostCachePinned, ptr )) {
+        return MAGMA_SUCCESS;
+    }
     cudaError_t err = cudaFreeHost( ptr );
     check_xerror( err, func, file, line );
     if ( cudaSuccess != err ) {
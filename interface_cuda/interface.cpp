@@ -306,6 +306,8 @@ magma_finalize()
                 #endif
                 #endif // MAGMA_NO_V1
 
+                magma_host_cache_release();
+
                 #ifdef DEBUG_MEMORY
                 magma_warn_leaks( g_pointers_dev, "device" );
                 magma_warn_leaks( g_pointers_cpu, "CPU" );
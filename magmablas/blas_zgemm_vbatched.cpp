@@ -0,0 +1,548 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+       Implementation of variable-size batch GEMM on the host ( CPU ) using
+       OpenMP, with size binning and a work-stealing scheduler.
+*/
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "magma_internal.h"
+#include "commonblas_z.h"
+
+#if defined(_OPENMP)
+#include <omp.h>
+#include "magma_threadsetting.h"
+#endif
+
+#define COMPLEX
+
+#ifdef COMPLEX
+#define NCOMP 2
+#else
+#define NCOMP 1
+#endif
+
+// Problems with m, n <= this are computed by register-blocked kernels.
+#define ZGEMM_VBATCHED_CPU_TINY 16
+
+// Problems with more than this many flops (m*n*k) may be split into tiles
+// of C, if they are also large relative to the per-thread share of work.
+#define ZGEMM_VBATCHED_CPU_SPLIT ((double) 128*128*128)
+
+// Number of tasks per thread targeted when splitting large problems.
+#define ZGEMM_VBATCHED_CPU_TASKS_PER_THREAD 4
+
+
+// Size classes, each computed by its own kernel.
+enum {
+    zgemm_blas = 0,     // blasf77_zgemm on one problem or a tile of one
+    zgemm_tiny16,
+    zgemm_tiny8,
+    zgemm_tiny4,
+    zgemm_tiny2,
+};
+
+
+// One unit of work: the mb-by-nb tile of C at (i,j) of problem id.
+struct zgemm_vbatched_task
+{
+    magma_int_t id, i, j, mb, nb;
+    int kind;
+    double cost;
+};
+
+
+/******************************************************************************/
+// C(:, 0:JB-1) = alpha*Ap*op(B)(:, 0:JB-1) + beta*C(:, 0:JB-1), for packed
+// Ap (see zgemm_tiny). The BM-by-JB accumulator stays in registers; JB
+// independent columns hide the latency of the multiply-adds.
+template< magma_int_t BM, magma_int_t JB >
+static inline void
+zgemm_tiny_cols(
+    magma_int_t m, magma_int_t k,
+    magmaDoubleComplex alpha,
+    const double *Ar, const double *Ai,
+    const magmaDoubleComplex *B, magma_int_t incb, magma_int_t ldb2, double conjb,
+    magmaDoubleComplex beta, bool beta_zero,
+    magmaDoubleComplex *C, magma_int_t ldc )
+{
+    double cr[ JB ][ BM ] = {};
+    #ifdef COMPLEX
+    double ci[ JB ][ BM ] = {};
+    #endif
+    for (magma_int_t p = 0; p < k; ++p) {
+        const double *ar = Ar + p*BM;
+        #ifdef COMPLEX
+        const double *ai = Ai + p*BM;
+        #endif
+        for (magma_int_t jj = 0; jj < JB; ++jj) {
+            magmaDoubleComplex b = B[ p*incb + jj*ldb2 ];
+            double br = MAGMA_Z_REAL( b );
+            #ifdef COMPLEX
+            double bi = conjb * MAGMA_Z_IMAG( b );
+            #endif
+            #pragma omp simd
+            for (magma_int_t i = 0; i < BM; ++i) {
+                #ifdef COMPLEX
+                cr[jj][i] += ar[i]*br - ai[i]*bi;
+                ci[jj][i] += ar[i]*bi + ai[i]*br;
+                #else
+                cr[jj][i] += ar[i]*br;
+                #endif
+            }
+        }
+    }
+
+    for (magma_int_t jj = 0; jj < JB; ++jj) {
+        magmaDoubleComplex *c = C + jj*ldc;
+        for (magma_int_t i = 0; i < m; ++i) {
+            #ifdef COMPLEX
+            magmaDoubleComplex cij = alpha * MAGMA_Z_MAKE( cr[jj][i], ci[jj][i] );
+            #else
+            magmaDoubleComplex cij = alpha * cr[jj][i];
+            #endif
+            if (! beta_zero) {
+                cij += beta * c[i];
+            }
+            c[i] = cij;
+        }
+    }
+}
+
+
+/***************************************************************************//**
+    C = alpha*op(A)*op(B) + beta*C for one problem with m <= BM rows.
+    op(A) is copied to a zero-padded BM-by-k panel with separate real and
+    imaginary planes, then C is computed 4 columns at a time in a BM-by-4
+    register block, so the update has compile-time trip counts and
+    vectorizes over rows. op(B) is read in place. C is not read if beta = 0,
+    as in BLAS.
+
+    work is a workspace of NCOMP*BM*k doubles.
+*******************************************************************************/
+template< magma_int_t BM >
+static void
+zgemm_tiny(
+    magma_trans_t transA, magma_trans_t transB,
+    magma_int_t m, magma_int_t n, magma_int_t k,
+    magmaDoubleComplex alpha,
+    const magmaDoubleComplex *A, magma_int_t lda,
+    const magmaDoubleComplex *B, magma_int_t ldb,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex *C, magma_int_t ldc,
+    double *work )
+{
+    double *Ar = work;
+    double *Ai = NULL;
+    #ifdef COMPLEX
+    Ai = Ar + BM*k;
+    #endif
+
+    // pack op(A) as Ar[ p*BM + i ]
+    magma_int_t inca = (transA == MagmaNoTrans ? 1   : lda);
+    magma_int_t lda2 = (transA == MagmaNoTrans ? lda : 1  );
+    #ifdef COMPLEX
+    double conja = (transA == MagmaConjTrans ? -1 : 1);
+    #endif
+    for (magma_int_t p = 0; p < k; ++p) {
+        const magmaDoubleComplex *a = A + p*lda2;
+        for (magma_int_t i = 0; i < m; ++i) {
+            Ar[ p*BM + i ] = MAGMA_Z_REAL( a[ i*inca ] );
+            #ifdef COMPLEX
+            Ai[ p*BM + i ] = conja * MAGMA_Z_IMAG( a[ i*inca ] );
+            #endif
+        }
+        for (magma_int_t i = m; i < BM; ++i) {
+            Ar[ p*BM + i ] = 0;
+            #ifdef COMPLEX
+            Ai[ p*BM + i ] = 0;
+            #endif
+        }
+    }
+
+    // op(B)(p,j) is B[ p*incb + j*ldb2 ]
+    magma_int_t incb = (transB == MagmaNoTrans ? 1   : ldb);
+    magma_int_t ldb2 = (transB == MagmaNoTrans ? ldb : 1  );
+    double conjb = (transB == MagmaConjTrans ? -1 : 1);
+    bool beta_zero = MAGMA_Z_EQUAL( beta, MAGMA_Z_ZERO );
+
+    magma_int_t j = 0;
+    for (; j + 4 <= n; j += 4) {
+        zgemm_tiny_cols< BM, 4 >( m, k, alpha, Ar, Ai, B + j*ldb2, incb, ldb2, conjb,
+                                  beta, beta_zero, C + j*ldc, ldc );
+    }
+    for (; j < n; ++j) {
+        zgemm_tiny_cols< BM, 1 >( m, k, alpha, Ar, Ai, B + j*ldb2, incb, ldb2, conjb,
+                                  beta, beta_zero, C + j*ldc, ldc );
+    }
+}
+
+
+/******************************************************************************/
+// runs one task: a tiny kernel on a whole problem, or BLAS on a tile of C
+static void
+zgemm_vbatched_run_task(
+    const zgemm_vbatched_task& t,
+    magma_trans_t transA, magma_trans_t transB,
+    magma_int_t *k,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex const * const * hA_array, magma_int_t *lda,
+    magmaDoubleComplex const * const * hB_array, magma_int_t *ldb,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex **hC_array, magma_int_t *ldc,
+    double *work )
+{
+    magma_int_t s = t.id;
+    switch (t.kind) {
+        #define CASE( kind_, B_ ) \
+        case kind_: \
+            zgemm_tiny< B_ >( transA, transB, t.mb, t.nb, k[s], \
+                                  alpha, hA_array[s], lda[s], hB_array[s], ldb[s], \
+                                  beta, hC_array[s], ldc[s], work ); \
+            break;
+        CASE( zgemm_tiny2,   2 )
+        CASE( zgemm_tiny4,   4 )
+        CASE( zgemm_tiny8,   8 )
+        CASE( zgemm_tiny16, 16 )
+        #undef CASE
+
+        default: {
+            // offset A to rows i:i+mb of op(A), and B to columns j:j+nb of op(B)
+            const magmaDoubleComplex *A = hA_array[s];
+            const magmaDoubleComplex *B = hB_array[s];
+            A += (transA == MagmaNoTrans ? t.i : t.i*lda[s]);
+            B += (transB == MagmaNoTrans ? t.j*ldb[s] : t.j);
+            blasf77_zgemm( lapack_trans_const(transA),
+                           lapack_trans_const(transB),
+                           &t.mb, &t.nb, &k[s],
+                           &alpha, A, &lda[s],
+                                   B, &ldb[s],
+                           &beta,  hC_array[s] + t.i + t.j*ldc[s], &ldc[s] );
+            break;
+        }
+    }
+}
+
+
+/******************************************************************************/
+// Per-thread task queue, holding the range [head, tail) of the thread's
+// tasks packed in one 64-bit word, so the owner (taking from the head) and
+// thieves (taking from the tail) claim tasks with a single compare-and-swap.
+// Padded to a cache line to avoid false sharing between threads.
+struct zgemm_vbatched_queue
+{
+    std::atomic< unsigned long long > range;
+    char pad[ 64 - sizeof(std::atomic< unsigned long long >) ];
+
+    void init( unsigned head, unsigned tail )
+    {
+        range.store( ((unsigned long long) tail << 32) | head );
+    }
+
+    // returns index of claimed task, or -1 if the queue is empty
+    long long pop( bool from_tail )
+    {
+        unsigned long long r = range.load();
+        while (true) {
+            unsigned head = (unsigned) r;
+            unsigned tail = (unsigned) (r >> 32);
+            if (head >= tail) {
+                return -1;
+            }
+            unsigned long long next = from_tail
+                ? ((unsigned long long) (tail - 1) << 32) | head
+                : ((unsigned long long)  tail      << 32) | (head + 1);
+            if (range.compare_exchange_weak( r, next )) {
+                return from_tail ? tail - 1 : head;
+            }
+        }
+    }
+};
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    BLAS_ZGEMM_VBATCHED performs one of the matrix-matrix operations
+
+        C_i = alpha*op( A_i )*op( B_i ) + beta*C_i,
+
+    on a batch of problems of different sizes, where op( X ) is one of
+        op( X ) = X      or
+        op( X ) = X**T   or
+        op( X ) = X**H,
+
+    alpha and beta are scalars, and A_i, B_i and C_i are matrices in CPU
+    memory, with op( A_i ) an m_i by k_i matrix, op( B_i ) a k_i by n_i
+    matrix, and C_i an m_i by n_i matrix.
+    This is the host counterpart of magmablas_zgemm_vbatched.
+
+    Problems are sorted into size bins. Tiny problems (m_i, n_i <= 16)
+    are computed by register-blocked kernels specialized for 2, 4, 8, and 16
+    rows. Other problems call BLAS on one thread; problems that
+    are large relative to the per-thread share of the total work are split
+    into tiles of C, so one problem can be computed by several threads.
+    Large tasks are pre-assigned to threads, largest first, to balance the
+    estimated work, and tiny problems are given to threads in runs of
+    consecutive problems; threads that finish early steal tasks from others.
+
+    Arguments
+    ----------
+    @param[in]
+    transA  magma_trans_t.
+            On entry, transA specifies the form of op( A ) to be used in
+            the matrix multiplication as follows:
+      -     = MagmaNoTrans:    op( A ) = A.
+      -     = MagmaTrans:      op( A ) = A**T.
+      -     = MagmaConjTrans:  op( A ) = A**H.
+
+    @param[in]
+    transB  magma_trans_t.
+            On entry, transB specifies the form of op( B ) to be used in
+            the matrix multiplication as follows:
+      -     = MagmaNoTrans:    op( B ) = B.
+      -     = MagmaTrans:      op( B ) = B**T.
+      -     = MagmaConjTrans:  op( B ) = B**H.
+
+    @param[in]
+    m       Array of integers, dimension (batchCount).
+            Each is the number of rows of op( A_i ) and of C_i.  m_i >= 0.
+
+    @param[in]
+    n       Array of integers, dimension (batchCount).
+            Each is the number of columns of op( B_i ) and of C_i.  n_i >= 0.
+
+    @param[in]
+    k       Array of integers, dimension (batchCount).
+            Each is the number of columns of op( A_i ) and rows of
+            op( B_i ).  k_i >= 0.
+
+    @param[in]
+    alpha   COMPLEX_16
+            On entry, ALPHA specifies the scalar alpha.
+
+    @param[in]
+    hA_array    Array of pointers, dimension (batchCount).
+            Each is a COMPLEX_16 array A_i in CPU memory, of dimension
+            ( lda_i, k_i ) if transA = MagmaNoTrans, or ( lda_i, m_i ) otherwise.
+
+    @param[in]
+    lda     Array of integers, dimension (batchCount).
+            Each is the leading dimension of A_i. If transA = MagmaNoTrans,
+            lda_i >= max( 1, m_i ), otherwise lda_i >= max( 1, k_i ).
+
+    @param[in]
+    hB_array    Array of pointers, dimension (batchCount).
+            Each is a COMPLEX_16 array B_i in CPU memory, of dimension
+            ( ldb_i, n_i ) if transB = MagmaNoTrans, or ( ldb_i, k_i ) otherwise.
+
+    @param[in]
+    ldb     Array of integers, dimension (batchCount).
+            Each is the leading dimension of B_i. If transB = MagmaNoTrans,
+            ldb_i >= max( 1, k_i ), otherwise ldb_i >= max( 1, n_i ).
+
+    @param[in]
+    beta    COMPLEX_16.
+            On entry, BETA specifies the scalar beta. When BETA is
+            supplied as zero then C_i need not be set on input.
+
+    @param[in,out]
+    hC_array    Array of pointers, dimension (batchCount).
+            Each is a COMPLEX_16 array C_i in CPU memory, of dimension
+            ( ldc_i, n_i ). On exit, overwritten by the m_i by n_i matrix
+            ( alpha*op( A_i )*op( B_i ) + beta*C_i ).
+
+    @param[in]
+    ldc     Array of integers, dimension (batchCount).
+            Each is the leading dimension of C_i.  ldc_i >= max( 1, m_i ).
+
+    @param[in]
+    batchCount  INTEGER
+                The number of problems to operate on.
+
+    @ingroup magma_gemm_batched
+*******************************************************************************/
+extern "C" void
+blas_zgemm_vbatched(
+        magma_trans_t transA, magma_trans_t transB,
+        magma_int_t *m, magma_int_t *n, magma_int_t *k,
+        magmaDoubleComplex alpha,
+        magmaDoubleComplex const * const * hA_array, magma_int_t *lda,
+        magmaDoubleComplex const * const * hB_array, magma_int_t *ldb,
+        magmaDoubleComplex beta,
+        magmaDoubleComplex **hC_array, magma_int_t *ldc,
+        magma_int_t batchCount )
+{
+    magma_int_t info = 0;
+    if ( transA != MagmaNoTrans && transA != MagmaTrans && transA != MagmaConjTrans )
+        info = -1;
+    else if ( transB != MagmaNoTrans && transB != MagmaTrans && transB != MagmaConjTrans )
+        info = -2;
+    else if ( batchCount < 0 )
+        info = -14;
+    for (magma_int_t s = 0; s < batchCount && info == 0; ++s) {
+        magma_int_t Am = (transA == MagmaNoTrans ? m[s] : k[s]);
+        magma_int_t Bk = (transB == MagmaNoTrans ? k[s] : n[s]);
+        if ( m[s] < 0 )
+            info = -3;
+        else if ( n[s] < 0 )
+            info = -4;
+        else if ( k[s] < 0 )
+            info = -5;
+        else if ( lda[s] < max( 1, Am ))
+            info = -8;
+        else if ( ldb[s] < max( 1, Bk ))
+            info = -10;
+        else if ( ldc[s] < max( 1, m[s] ))
+            info = -13;
+    }
+    if (info != 0) {
+        magma_xerbla( __func__, -(info) );
+        return;
+    }
+
+    magma_int_t nthreads = 1;
+    #if defined(_OPENMP)
+    nthreads = magma_get_lapack_numthreads();
+    #endif
+
+    /* Bin the problems and estimate the cost of each */
+    double total = 0;
+    magma_int_t kmax_tiny = 0;
+    for (magma_int_t s = 0; s < batchCount; ++s) {
+        total += (double) m[s] * n[s] * max( 1, k[s] );
+    }
+
+    std::vector< zgemm_vbatched_task > tasks;
+    tasks.reserve( batchCount );
+    double grain = max( ZGEMM_VBATCHED_CPU_SPLIT,
+                        total / (nthreads * ZGEMM_VBATCHED_CPU_TASKS_PER_THREAD) );
+    for (magma_int_t s = 0; s < batchCount; ++s) {
+        if (m[s] == 0 || n[s] == 0) {
+            continue;
+        }
+        double cost = (double) m[s] * n[s] * max( 1, k[s] );
+        if (m[s] <= ZGEMM_VBATCHED_CPU_TINY && n[s] <= ZGEMM_VBATCHED_CPU_TINY) {
+            int kind = (m[s] <= 2 ? zgemm_tiny2 :
+                        m[s] <= 4 ? zgemm_tiny4 :
+                        m[s] <= 8 ? zgemm_tiny8 : zgemm_tiny16);
+            tasks.push_back( { s, 0, 0, m[s], n[s], kind, cost } );
+            kmax_tiny = max( kmax_tiny, k[s] );
+        }
+        else if (nthreads > 1 && cost > grain) {
+            // split C into roughly square tiles of about grain flops,
+            // with dimensions a multiple of 32
+            double side = sqrt( grain / max( 1, k[s] ) );
+            magma_int_t tb = max( 32, magma_roundup( (magma_int_t) side, 32 ));
+            magma_int_t mb = min( m[s], tb );
+            magma_int_t nb = min( n[s], tb );
+            for (magma_int_t j = 0; j < n[s]; j += nb) {
+                for (magma_int_t i = 0; i < m[s]; i += mb) {
+                    magma_int_t ib = min( mb, m[s] - i );
+                    magma_int_t jb = min( nb, n[s] - j );
+                    tasks.push_back( { s, i, j, ib, jb, zgemm_blas,
+                                       (double) ib * jb * max( 1, k[s] ) } );
+                }
+            }
+        }
+        else {
+            tasks.push_back( { s, 0, 0, m[s], n[s], zgemm_blas, cost } );
+        }
+    }
+    if (tasks.empty()) {
+        return;
+    }
+    nthreads = min( nthreads, (magma_int_t) tasks.size() );
+
+    /* Pre-assign BLAS tasks to threads, largest first, each to the least
+       loaded thread. Then fill the threads up to an equal share of the work
+       with runs of consecutive tiny problems, so each thread walks through
+       its tiny problems in memory order. */
+    std::vector< magma_int_t > order;
+    order.reserve( tasks.size() );
+    double share = 0;
+    for (size_t t = 0; t < tasks.size(); ++t) {
+        if (tasks[t].kind == zgemm_blas) {
+            order.push_back( t );
+        }
+        share += tasks[t].cost / nthreads;
+    }
+    std::stable_sort( order.begin(), order.end(),
+        [&]( magma_int_t a, magma_int_t b ) { return tasks[a].cost > tasks[b].cost; } );
+
+    std::vector< double > load( nthreads, 0. );
+    std::vector< magma_int_t > owner( tasks.size() );
+    for (magma_int_t t : order) {
+        magma_int_t th = std::min_element( load.begin(), load.end() ) - load.begin();
+        load[th] += tasks[t].cost;
+        owner[t] = th;
+    }
+    magma_int_t th = 0;
+    for (size_t t = 0; t < tasks.size(); ++t) {
+        if (tasks[t].kind != zgemm_blas) {
+            while (th < nthreads-1 && load[th] + tasks[t].cost > share) {
+                th += 1;
+            }
+            load[th] += tasks[t].cost;
+            owner[t] = th;
+            order.push_back( t );
+        }
+    }
+
+    // group by owner, keeping the order above within each thread
+    std::vector< magma_int_t > count( nthreads + 1, 0 );
+    for (size_t t = 0; t < tasks.size(); ++t) {
+        count[ owner[t] + 1 ] += 1;
+    }
+    for (th = 0; th < nthreads; ++th) {
+        count[th+1] += count[th];
+    }
+    std::vector< magma_int_t > queued( tasks.size() ), next( count );
+    for (magma_int_t t : order) {
+        queued[ next[ owner[t] ]++ ] = t;
+    }
+
+    std::vector< zgemm_vbatched_queue > queues( nthreads );
+    for (th = 0; th < nthreads; ++th) {
+        queues[th].init( count[th], count[th+1] );
+    }
+
+    size_t lwork = NCOMP * ZGEMM_VBATCHED_CPU_TINY * kmax_tiny;
+
+    #if defined(_OPENMP)
+    magma_int_t lapack_nthreads = magma_get_lapack_numthreads();
+    magma_set_lapack_numthreads(1);
+    // the num_threads clause caps the team; the global OpenMP setting stays
+    #pragma omp parallel num_threads( nthreads )
+    #endif
+    {
+        magma_int_t tid = 0;
+        #if defined(_OPENMP)
+        tid = omp_get_thread_num();
+        #endif
+        std::vector< double > work( lwork );
+
+        // drain own queue from the head, then steal from the tail of others
+        for (magma_int_t v = 0; v < nthreads; ++v) {
+            zgemm_vbatched_queue& q = queues[ (tid + v) % nthreads ];
+            long long t;
+            while ((t = q.pop( v != 0 )) >= 0) {
+                zgemm_vbatched_run_task(
+                    tasks[ queued[t] ], transA, transB, k,
+                    alpha, hA_array, lda, hB_array, ldb,
+                    beta, hC_array, ldc, work.data() );
+            }
+        }
+    }
+    #if defined(_OPENMP)
+    magma_set_lapack_numthreads(lapack_nthreads);
+    #endif
+}
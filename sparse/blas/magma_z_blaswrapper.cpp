@@ -259,6 +259,10 @@ magma_z_spmv(
                    (cuDoubleComplex*)&alpha, descr, (cuDoubleComplex*)A.dval, A.drow, A.dcol, A.blocksize, (cuDoubleComplex*)x.dval,
                    (cuDoubleComplex*)&beta, (cuDoubleComplex*)y.dval );
             }
+            else if ( A.storage_type == Magma_STENCIL ) {
+                CHECK( magma_zgestencilmv( A.stencil_nx, A.stencil_ny, A.stencil_nz,
+                                alpha, A.dval, x.dval, beta, y.dval, queue ));
+            }
             else {
                 printf("error: format not supported.\n");
                 info = MAGMA_ERR_NOT_SUPPORTED; 
@@ -327,6 +331,16 @@ magma_z_spmv(
             }
         }
     }
+    // the matrix-free stencil runs on the CPU directly
+    else if ( A.storage_type == Magma_STENCIL &&
+              A.num_cols == x.num_rows && x.num_cols == 1 ) {
+        CHECK( magma_zgestencilmv_cpu( alpha, A, x.val, beta, y.val, queue ));
+    }
+    // blocks of vectors are multiplied on the CPU directly
+    else if ( ( A.storage_type == Magma_CSR || A.storage_type == Magma_SELLP ) &&
+              ( A.num_cols < x.num_rows || x.num_cols > 1 ) ) {
+        CHECK( magma_zspmm_cpu( alpha, A, x, beta, y, queue ));
+    }
     // CPU case missing!
     else {
         CHECK( magma_zmtransfer( x, &dx, x.memory_location, Magma_DEV, queue ));
@@ -0,0 +1,1210 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "magmasparse_internal.h"
+
+/*
+    Host counterparts of the merged GPU kernels used by the Krylov solvers
+    on Magma_CPU data. Each routine is a single OpenMP pass over the vectors,
+    fusing the vector updates with the dot products that follow them.
+
+    All loops over vector entries and matrix rows use the same static
+    schedule, so each thread keeps working on the entries it touched first.
+    Vectors initialized with magma_zfill_cpu are thus placed in the memory
+    of the NUMA node of the thread using them.
+
+    Complex dot products are reduced as separate real and imaginary parts,
+    as OpenMP has no built-in complex reduction.
+*/
+
+
+/**
+    Purpose
+    -------
+
+    Sets all entries of a vector on the CPU to alpha. Used to place the
+    pages of newly allocated solver vectors by first touch, with the
+    static schedule of the other routines in this file.
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                vector length
+
+    @param[in]
+    alpha       magmaDoubleComplex
+                value
+
+    @param[out]
+    x           magmaDoubleComplex*
+                vector
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zfill_cpu(
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex *x,
+    magma_queue_t queue )
+{
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i<n; i++ ){
+        x[i] = alpha;
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Returns the Euclidean norm of a vector on the CPU.
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                vector length
+
+    @param[in]
+    x           magmaDoubleComplex*
+                vector
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" double
+magma_dznrm2_cpu(
+    magma_int_t n,
+    magmaDoubleComplex *x,
+    magma_queue_t queue )
+{
+    double nrm = 0.0;
+
+    #pragma omp parallel for schedule(static) reduction(+:nrm)
+    for( magma_int_t i=0; i<n; i++ ){
+        nrm += MAGMA_Z_REAL( MAGMA_Z_CONJ( x[i] ) * x[i] );
+    }
+    return sqrt( nrm );
+}
+
+
+/***************************************************************************//**
+    Tiling of the matrix-free Magma_STENCIL sweeps: tiles of
+    STENCIL_XBLOCK x STENCIL_YBLOCK x STENCIL_ZBLOCK grid points are handed
+    out to the threads. Within a tile the grid lines are traversed with x
+    fastest, so the three planes of x touched by STENCIL_YBLOCK + 2 lines
+    stay in cache while the tile marches through z.
+*******************************************************************************/
+#define STENCIL_XBLOCK 256
+#define STENCIL_YBLOCK 16
+#define STENCIL_ZBLOCK 16
+
+
+/*****************************************************************************/
+// t[0..x1-x0) = A * x for the grid points x0 <= ix < x1 of line (iy, iz).
+// Lines outside the grid and all-zero coefficient rows are skipped, the
+// interior of the line runs without boundary checks.
+static void
+zstencil_line(
+    const magma_z_matrix *A,
+    const magmaDoubleComplex *x,
+    magma_int_t x0, magma_int_t x1,
+    magma_int_t iy, magma_int_t iz,
+    magmaDoubleComplex *t )
+{
+    magma_int_t nx = A->stencil_nx, ny = A->stencil_ny, nz = A->stencil_nz;
+    magma_int_t lo = max( x0, 1 ), hi = min( x1, nx-1 );
+    magma_int_t ends[4] = { x0, min( lo, x1 ), max( hi, lo ), x1 };
+
+    for( magma_int_t i=0; i<x1-x0; i++ ){
+        t[i] = MAGMA_Z_ZERO;
+    }
+    for( magma_int_t dz=-1; dz<=1; dz++ ){
+        if ( iz+dz < 0 || iz+dz >= nz ) {
+            continue;
+        }
+        for( magma_int_t dy=-1; dy<=1; dy++ ){
+            if ( iy+dy < 0 || iy+dy >= ny ) {
+                continue;
+            }
+            const magmaDoubleComplex *c = A->val + (dz+1)*9 + (dy+1)*3;
+            if ( MAGMA_Z_ABS( c[0] ) == 0.0 && MAGMA_Z_ABS( c[1] ) == 0.0
+                    && MAGMA_Z_ABS( c[2] ) == 0.0 ) {
+                continue;
+            }
+            const magmaDoubleComplex *xl = x + ( (iz+dz)*ny + (iy+dy) )*nx;
+            magmaDoubleComplex c0 = c[0], c1 = c[1], c2 = c[2];
+            // interior, all three neighbours exist
+            #pragma omp simd
+            for( magma_int_t ix=lo; ix<hi; ix++ ){
+                t[ix-x0] += c0 * xl[ix-1] + c1 * xl[ix] + c2 * xl[ix+1];
+            }
+            // the line ends
+            for( magma_int_t e=0; e<4; e+=2 ){
+                for( magma_int_t ix=ends[e]; ix<ends[e+1]; ix++ ){
+                    magmaDoubleComplex s = c1 * xl[ix];
+                    if ( ix > 0 ) {
+                        s += c0 * xl[ix-1];
+                    }
+                    if ( ix < nx-1 ) {
+                        s += c2 * xl[ix+1];
+                    }
+                    t[ix-x0] += s;
+                }
+            }
+        }
+    }
+}
+
+
+/*****************************************************************************/
+// y = alpha * A * x + beta * b for a Magma_STENCIL matrix, b may be NULL
+// (then beta is ignored) and y may alias b or be NULL. In the same pass
+// d1 = w' * y (if w is not NULL) and d2 = y' * y.
+static void
+zstencil_sweep(
+    const magma_z_matrix *A,
+    magmaDoubleComplex alpha,
+    const magmaDoubleComplex *x,
+    magmaDoubleComplex beta,
+    const magmaDoubleComplex *b,
+    magmaDoubleComplex *y,
+    const magmaDoubleComplex *w,
+    double *d1r, double *d1i, double *d2 )
+{
+    magma_int_t nx = A->stencil_nx, ny = A->stencil_ny, nz = A->stencil_nz;
+    magma_int_t nxb = magma_ceildiv( nx, STENCIL_XBLOCK );
+    magma_int_t nyb = magma_ceildiv( ny, STENCIL_YBLOCK );
+    magma_int_t nzb = magma_ceildiv( nz, STENCIL_ZBLOCK );
+    double sr = 0.0, si = 0.0, s2 = 0.0;
+
+    #pragma omp parallel for schedule(static) reduction(+:sr,si,s2)
+    for( magma_int_t tile=0; tile<nxb*nyb*nzb; tile++ ){
+        magmaDoubleComplex t[ STENCIL_XBLOCK ];
+        magma_int_t bx = tile % nxb;
+        magma_int_t by = ( tile / nxb ) % nyb;
+        magma_int_t bz = tile / ( nxb * nyb );
+        magma_int_t x0 = bx * STENCIL_XBLOCK, x1 = min( x0 + STENCIL_XBLOCK, nx );
+        magma_int_t y0 = by * STENCIL_YBLOCK, y1 = min( y0 + STENCIL_YBLOCK, ny );
+        magma_int_t z0 = bz * STENCIL_ZBLOCK, z1 = min( z0 + STENCIL_ZBLOCK, nz );
+
+        for( magma_int_t iz=z0; iz<z1; iz++ ){
+            for( magma_int_t iy=y0; iy<y1; iy++ ){
+                zstencil_line( A, x, x0, x1, iy, iz, t );
+                magma_int_t row = ( iz*ny + iy )*nx + x0;
+                for( magma_int_t i=0; i<x1-x0; i++ ){
+                    magmaDoubleComplex v = alpha * t[i];
+                    if ( b != NULL ) {
+                        v += beta * b[row+i];
+                    }
+                    if ( y != NULL ) {
+                        y[row+i] = v;
+                    }
+                    if ( w != NULL ) {
+                        magmaDoubleComplex p = MAGMA_Z_CONJ( w[row+i] ) * v;
+                        sr += MAGMA_Z_REAL( p );
+                        si += MAGMA_Z_IMAG( p );
+                    }
+                    s2 += MAGMA_Z_REAL( MAGMA_Z_CONJ( v ) * v );
+                }
+            }
+        }
+    }
+    *d1r = sr;
+    *d1i = si;
+    *d2 = s2;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes y = alpha * A * x + beta * y for a matrix-free stencil
+    operator A in Magma_STENCIL format on the CPU, see magma_zm_stencil.
+    The grid is swept in cache-sized tiles; only the MAGMA_STENCIL_SIZE
+    coefficients are read besides x and y.
+
+    Arguments
+    ---------
+
+    @param[in]
+    alpha       magmaDoubleComplex
+                scalar multiplier
+
+    @param[in]
+    A           magma_z_matrix
+                STENCIL matrix on the CPU
+
+    @param[in]
+    x           magmaDoubleComplex*
+                input vector of length A.num_cols
+
+    @param[in]
+    beta        magmaDoubleComplex
+                scalar multiplier
+
+    @param[in,out]
+    y           magmaDoubleComplex*
+                input/output vector of length A.num_rows
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zblas
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zgestencilmv_cpu(
+    magmaDoubleComplex alpha,
+    magma_z_matrix A,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex *y,
+    magma_queue_t queue )
+{
+    double d1r, d1i, d2;
+
+    if ( A.storage_type != Magma_STENCIL || A.memory_location != Magma_CPU ) {
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
+    zstencil_sweep( &A, alpha, x, beta,
+                    MAGMA_Z_ABS( beta ) == 0.0 ? NULL : y, y,
+                    NULL, &d1r, &d1i, &d2 );
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes y = A * x for a CSR or STENCIL matrix A on the CPU, and in the same pass
+    dot1 = w' * y and dot2 = y' * y. w, dot1 and dot2 may be NULL to skip
+    the respective product.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                CSR or STENCIL matrix on the CPU
+
+    @param[in]
+    x           magmaDoubleComplex*
+                input vector of length A.num_cols
+
+    @param[out]
+    y           magmaDoubleComplex*
+                output vector of length A.num_rows
+
+    @param[in]
+    w           magmaDoubleComplex*
+                vector of length A.num_rows, or NULL
+
+    @param[out]
+    dot1        magmaDoubleComplex*
+                w' * y, or NULL
+
+    @param[out]
+    dot2        double*
+                y' * y, or NULL
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zspmv_dot_cpu(
+    magma_z_matrix A,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex *y,
+    magmaDoubleComplex *w,
+    magmaDoubleComplex *dot1,
+    double *dot2,
+    magma_queue_t queue )
+{
+    double d1r = 0.0, d1i = 0.0, d2 = 0.0;
+
+    if ( A.storage_type == Magma_STENCIL && A.memory_location == Magma_CPU ) {
+        zstencil_sweep( &A, MAGMA_Z_ONE, x, MAGMA_Z_ZERO, NULL, y, w,
+                        &d1r, &d1i, &d2 );
+        if ( dot1 != NULL ) {
+            *dot1 = MAGMA_Z_MAKE( d1r, d1i );
+        }
+        if ( dot2 != NULL ) {
+            *dot2 = d2;
+        }
+        return MAGMA_SUCCESS;
+    }
+    if ( A.storage_type != Magma_CSR || A.memory_location != Magma_CPU ) {
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
+
+    #pragma omp parallel for schedule(static) reduction(+:d1r,d1i,d2)
+    for( magma_int_t i=0; i<A.num_rows; i++ ){
+        magmaDoubleComplex t = MAGMA_Z_ZERO;
+        for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+            t += A.val[k] * x[ A.col[k] ];
+        }
+        y[i] = t;
+        if ( w != NULL ) {
+            magmaDoubleComplex p = MAGMA_Z_CONJ( w[i] ) * t;
+            d1r += MAGMA_Z_REAL( p );
+            d1i += MAGMA_Z_IMAG( p );
+        }
+        d2 += MAGMA_Z_REAL( MAGMA_Z_CONJ( t ) * t );
+    }
+
+    if ( dot1 != NULL ) {
+        *dot1 = MAGMA_Z_MAKE( d1r, d1i );
+    }
+    if ( dot2 != NULL ) {
+        *dot2 = d2;
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes r = b - A * x for a CSR or STENCIL matrix A on the CPU and
+    res = ||r||.
+    r may be NULL if only the norm is needed.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                CSR or STENCIL matrix on the CPU
+
+    @param[in]
+    b           magmaDoubleComplex*
+                right hand side
+
+    @param[in]
+    x           magmaDoubleComplex*
+                solution approximation
+
+    @param[out]
+    r           magmaDoubleComplex*
+                residual vector, or NULL
+
+    @param[out]
+    res         double*
+                residual norm
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zresidual_cpu(
+    magma_z_matrix A,
+    magmaDoubleComplex *b,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex *r,
+    double *res,
+    magma_queue_t queue )
+{
+    double nrm = 0.0;
+
+    if ( A.storage_type == Magma_STENCIL && A.memory_location == Magma_CPU ) {
+        double d1r, d1i;
+        zstencil_sweep( &A, MAGMA_Z_NEG_ONE, x, MAGMA_Z_ONE, b, r, NULL,
+                        &d1r, &d1i, &nrm );
+        *res = sqrt( nrm );
+        return MAGMA_SUCCESS;
+    }
+    if ( A.storage_type != Magma_CSR || A.memory_location != Magma_CPU ) {
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
+
+    #pragma omp parallel for schedule(static) reduction(+:nrm)
+    for( magma_int_t i=0; i<A.num_rows; i++ ){
+        magmaDoubleComplex t = b[i];
+        for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+            t -= A.val[k] * x[ A.col[k] ];
+        }
+        if ( r != NULL ) {
+            r[i] = t;
+        }
+        nrm += MAGMA_Z_REAL( MAGMA_Z_CONJ( t ) * t );
+    }
+
+    *res = sqrt( nrm );
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Merges the CG updates x = x + alpha * d, r = r - alpha * z with the
+    computation of rr = r' * r.
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                vector length
+
+    @param[in]
+    alpha       magmaDoubleComplex
+                step length
+
+    @param[in,out]
+    x           magmaDoubleComplex*
+                solution approximation
+
+    @param[in,out]
+    r           magmaDoubleComplex*
+                residual
+
+    @param[in]
+    d           magmaDoubleComplex*
+                search direction
+
+    @param[in]
+    z           magmaDoubleComplex*
+                A * d
+
+    @param[out]
+    rr          double*
+                r' * r of the updated residual
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zcgmerge_xr_cpu(
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *d,
+    magmaDoubleComplex *z,
+    double *rr,
+    magma_queue_t queue )
+{
+    double nrm = 0.0;
+
+    #pragma omp parallel for schedule(static) reduction(+:nrm)
+    for( magma_int_t i=0; i<n; i++ ){
+        x[i] += alpha * d[i];
+        magmaDoubleComplex t = r[i] - alpha * z[i];
+        r[i] = t;
+        nrm += MAGMA_Z_REAL( MAGMA_Z_CONJ( t ) * t );
+    }
+
+    *rr = nrm;
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes the new CG search direction d = r + beta * d.
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                vector length
+
+    @param[in]
+    beta        magmaDoubleComplex
+                scalar
+
+    @param[in]
+    r           magmaDoubleComplex*
+                residual
+
+    @param[in,out]
+    d           magmaDoubleComplex*
+                search direction
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zcgmerge_d_cpu(
+    magma_int_t n,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *d,
+    magma_queue_t queue )
+{
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i<n; i++ ){
+        d[i] = r[i] + beta * d[i];
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    SpMV of the pipelined CG: computes q = A * m and, in the same pass, the
+    reductions of the iteration, gamma = u' * r, delta = u' * w and
+    rr = r' * r. The reductions are thus overlapped with the SpMV instead
+    of requiring separate passes and synchronization points.
+    Without preconditioner u = r and m = w.
+    For a STENCIL matrix, the SpMV is a tiled sweep of the grid and the
+    reductions take a second pass.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                CSR or STENCIL matrix on the CPU
+
+    @param[in]
+    m           magmaDoubleComplex*
+                m = M^{-1} * w
+
+    @param[out]
+    q           magmaDoubleComplex*
+                q = A * m
+
+    @param[in]
+    r           magmaDoubleComplex*
+                residual
+
+    @param[in]
+    u           magmaDoubleComplex*
+                u = M^{-1} * r
+
+    @param[in]
+    w           magmaDoubleComplex*
+                w = A * u
+
+    @param[out]
+    gamma       double*
+                u' * r
+
+    @param[out]
+    delta       magmaDoubleComplex*
+                u' * w
+
+    @param[out]
+    rr          double*
+                r' * r
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zpipecg_spmv_cpu(
+    magma_z_matrix A,
+    magmaDoubleComplex *m,
+    magmaDoubleComplex *q,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *u,
+    magmaDoubleComplex *w,
+    double *gamma,
+    magmaDoubleComplex *delta,
+    double *rr,
+    magma_queue_t queue )
+{
+    double g = 0.0, dr = 0.0, di = 0.0, rn = 0.0;
+    bool stencil = ( A.storage_type == Magma_STENCIL );
+
+    if ( ( A.storage_type != Magma_CSR && ! stencil )
+            || A.memory_location != Magma_CPU ) {
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
+    if ( stencil ) {
+        // the sweep runs over grid tiles, the dots below over the rows
+        double d1r, d1i, d2;
+        zstencil_sweep( &A, MAGMA_Z_ONE, m, MAGMA_Z_ZERO, NULL, q, NULL,
+                        &d1r, &d1i, &d2 );
+    }
+
+    #pragma omp parallel for schedule(static) reduction(+:g,dr,di,rn)
+    for( magma_int_t i=0; i<A.num_rows; i++ ){
+        if ( ! stencil ) {
+            magmaDoubleComplex t = MAGMA_Z_ZERO;
+            for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+                t += A.val[k] * m[ A.col[k] ];
+            }
+            q[i] = t;
+        }
+        magmaDoubleComplex uc = MAGMA_Z_CONJ( u[i] );
+        magmaDoubleComplex p = uc * w[i];
+        g  += MAGMA_Z_REAL( uc * r[i] );
+        dr += MAGMA_Z_REAL( p );
+        di += MAGMA_Z_IMAG( p );
+        rn += MAGMA_Z_REAL( MAGMA_Z_CONJ( r[i] ) * r[i] );
+    }
+
+    *gamma = g;
+    *delta = MAGMA_Z_MAKE( dr, di );
+    *rr = rn;
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Vector updates of the pipelined CG, merged into one pass:
+
+        z = q + beta * z,   s = w + beta * s,   p = r + beta * p,
+        x = x + alpha * p,  r = r - alpha * s,  w = w - alpha * z.
+
+    With preconditioner, u = M^{-1} r and its recurrence c = M^{-1} s
+    are updated as well, and p follows u instead of r:
+
+        c = m + beta * c,   p = u + beta * p,   u = u - alpha * c.
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                vector length
+
+    @param[in]
+    alpha       magmaDoubleComplex
+                step length
+
+    @param[in]
+    beta        magmaDoubleComplex
+                direction update
+
+    @param[in,out]
+    x           magmaDoubleComplex*
+                solution approximation
+
+    @param[in,out]
+    r           magmaDoubleComplex*
+                residual
+
+    @param[in,out]
+    w           magmaDoubleComplex*
+                A * u
+
+    @param[in,out]
+    p           magmaDoubleComplex*
+                search direction
+
+    @param[in,out]
+    s           magmaDoubleComplex*
+                A * p
+
+    @param[in,out]
+    z           magmaDoubleComplex*
+                A * c
+
+    @param[in]
+    q           magmaDoubleComplex*
+                A * m
+
+    @param[in,out]
+    u           magmaDoubleComplex*
+                M^{-1} * r, or NULL without preconditioner
+
+    @param[in]
+    m           magmaDoubleComplex*
+                M^{-1} * w, or NULL without preconditioner
+
+    @param[in,out]
+    c           magmaDoubleComplex*
+                M^{-1} * s, or NULL without preconditioner
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zpipecg_update_cpu(
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *w,
+    magmaDoubleComplex *p,
+    magmaDoubleComplex *s,
+    magmaDoubleComplex *z,
+    magmaDoubleComplex *q,
+    magmaDoubleComplex *u,
+    magmaDoubleComplex *m,
+    magmaDoubleComplex *c,
+    magma_queue_t queue )
+{
+    if ( u == NULL ) {
+        #pragma omp parallel for schedule(static)
+        for( magma_int_t i=0; i<n; i++ ){
+            magmaDoubleComplex zi = q[i] + beta * z[i];
+            magmaDoubleComplex si = w[i] + beta * s[i];
+            magmaDoubleComplex pi = r[i] + beta * p[i];
+            z[i] = zi;
+            s[i] = si;
+            p[i] = pi;
+            x[i] += alpha * pi;
+            r[i] -= alpha * si;
+            w[i] -= alpha * zi;
+        }
+    }
+    else {
+        #pragma omp parallel for schedule(static)
+        for( magma_int_t i=0; i<n; i++ ){
+            magmaDoubleComplex zi = q[i] + beta * z[i];
+            magmaDoubleComplex ci = m[i] + beta * c[i];
+            magmaDoubleComplex si = w[i] + beta * s[i];
+            magmaDoubleComplex pi = u[i] + beta * p[i];
+            z[i] = zi;
+            c[i] = ci;
+            s[i] = si;
+            p[i] = pi;
+            x[i] += alpha * pi;
+            r[i] -= alpha * si;
+            u[i] -= alpha * ci;
+            w[i] -= alpha * zi;
+        }
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes the BiCGSTAB search direction p = r + beta * ( p - omega * v ).
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                vector length
+
+    @param[in]
+    beta        magmaDoubleComplex
+                scalar
+
+    @param[in]
+    omega       magmaDoubleComplex
+                scalar
+
+    @param[in]
+    r           magmaDoubleComplex*
+                residual
+
+    @param[in]
+    v           magmaDoubleComplex*
+                A * p
+
+    @param[in,out]
+    p           magmaDoubleComplex*
+                search direction
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zbicgmerge_p_cpu(
+    magma_int_t n,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex omega,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *v,
+    magmaDoubleComplex *p,
+    magma_queue_t queue )
+{
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i<n; i++ ){
+        p[i] = r[i] + beta * ( p[i] - omega * v[i] );
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes the BiCGSTAB intermediate residual s = r - alpha * v and
+    ss = s' * s in one pass.
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                vector length
+
+    @param[in]
+    alpha       magmaDoubleComplex
+                scalar
+
+    @param[in]
+    r           magmaDoubleComplex*
+                residual
+
+    @param[in]
+    v           magmaDoubleComplex*
+                A * p
+
+    @param[out]
+    s           magmaDoubleComplex*
+                intermediate residual
+
+    @param[out]
+    ss          double*
+                s' * s
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zbicgmerge_s_cpu(
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *v,
+    magmaDoubleComplex *s,
+    double *ss,
+    magma_queue_t queue )
+{
+    double nrm = 0.0;
+
+    #pragma omp parallel for schedule(static) reduction(+:nrm)
+    for( magma_int_t i=0; i<n; i++ ){
+        magmaDoubleComplex t = r[i] - alpha * v[i];
+        s[i] = t;
+        nrm += MAGMA_Z_REAL( MAGMA_Z_CONJ( t ) * t );
+    }
+
+    *ss = nrm;
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Merges the BiCGSTAB updates x = x + alpha * p + omega * sh and
+    r = s - omega * t with the computation of rho = rr' * r and
+    nrm = r' * r of the updated residual. With a right preconditioner,
+    p and sh are the preconditioned vectors M^{-1} p and M^{-1} s;
+    otherwise sh = s.
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                vector length
+
+    @param[in]
+    alpha       magmaDoubleComplex
+                scalar
+
+    @param[in]
+    omega       magmaDoubleComplex
+                scalar
+
+    @param[in]
+    p           magmaDoubleComplex*
+                search direction
+
+    @param[in]
+    s           magmaDoubleComplex*
+                intermediate residual
+
+    @param[in]
+    sh          magmaDoubleComplex*
+                M^{-1} s, or s without preconditioner
+
+    @param[in]
+    t           magmaDoubleComplex*
+                A * sh
+
+    @param[in]
+    rr          magmaDoubleComplex*
+                shadow residual
+
+    @param[in,out]
+    x           magmaDoubleComplex*
+                solution approximation
+
+    @param[out]
+    r           magmaDoubleComplex*
+                residual
+
+    @param[out]
+    rho         magmaDoubleComplex*
+                rr' * r
+
+    @param[out]
+    nrm         double*
+                r' * r
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zbicgmerge_xr_cpu(
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex omega,
+    magmaDoubleComplex *p,
+    magmaDoubleComplex *s,
+    magmaDoubleComplex *sh,
+    magmaDoubleComplex *t,
+    magmaDoubleComplex *rr,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *rho,
+    double *nrm,
+    magma_queue_t queue )
+{
+    double rhor = 0.0, rhoi = 0.0, rn = 0.0;
+
+    #pragma omp parallel for schedule(static) reduction(+:rhor,rhoi,rn)
+    for( magma_int_t i=0; i<n; i++ ){
+        x[i] += alpha * p[i] + omega * sh[i];
+        magmaDoubleComplex ri = s[i] - omega * t[i];
+        r[i] = ri;
+        magmaDoubleComplex d = MAGMA_Z_CONJ( rr[i] ) * ri;
+        rhor += MAGMA_Z_REAL( d );
+        rhoi += MAGMA_Z_IMAG( d );
+        rn   += MAGMA_Z_REAL( MAGMA_Z_CONJ( ri ) * ri );
+    }
+
+    *rho = MAGMA_Z_MAKE( rhor, rhoi );
+    *nrm = rn;
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes the k dot products h = V' * w of the columns of V with w in a
+    single pass over the vectors, as used for the classical Gram-Schmidt
+    orthogonalization in GMRES and the projections in IDR(s).
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                vector length
+
+    @param[in]
+    k           magma_int_t
+                number of columns of V
+
+    @param[in]
+    V           magmaDoubleComplex*
+                n x k matrix, column major
+
+    @param[in]
+    ldv         magma_int_t
+                leading dimension of V
+
+    @param[in]
+    w           magmaDoubleComplex*
+                vector
+
+    @param[out]
+    h           magmaDoubleComplex*
+                vector of length k
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmdotc_cpu(
+    magma_int_t n,
+    magma_int_t k,
+    magmaDoubleComplex *V,
+    magma_int_t ldv,
+    magmaDoubleComplex *w,
+    magmaDoubleComplex *h,
+    magma_queue_t queue )
+{
+    for( magma_int_t j=0; j<k; j++ ){
+        h[j] = MAGMA_Z_ZERO;
+    }
+
+    #pragma omp parallel
+    {
+        // each thread accumulates its rows for all columns, then adds
+        // its partial sums to h
+        magmaDoubleComplex part[ 64 ];
+        for( magma_int_t j0=0; j0<k; j0+=64 ){
+            magma_int_t kb = min( k-j0, 64 );
+            for( magma_int_t j=0; j<kb; j++ ){
+                part[j] = MAGMA_Z_ZERO;
+            }
+            #pragma omp for schedule(static) nowait
+            for( magma_int_t i=0; i<n; i++ ){
+                magmaDoubleComplex wi = w[i];
+                for( magma_int_t j=0; j<kb; j++ ){
+                    part[j] += MAGMA_Z_CONJ( V[ i + (j0+j)*ldv ] ) * wi;
+                }
+            }
+            #pragma omp critical
+            {
+                for( magma_int_t j=0; j<kb; j++ ){
+                    h[j0+j] += part[j];
+                }
+            }
+        }
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes w = w - V * h for the k columns of V and nrm = ||w|| of the
+    updated vector in a single pass.
+
+    Arguments
+    ---------
+
+    @param[in]
+    n           magma_int_t
+                vector length
+
+    @param[in]
+    k           magma_int_t
+                number of columns of V
+
+    @param[in]
+    V           magmaDoubleComplex*
+                n x k matrix, column major
+
+    @param[in]
+    ldv         magma_int_t
+                leading dimension of V
+
+    @param[in]
+    h           magmaDoubleComplex*
+                vector of length k
+
+    @param[in,out]
+    w           magmaDoubleComplex*
+                vector
+
+    @param[out]
+    nrm         double*
+                ||w|| after the update, may be NULL
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmaxpy_cpu(
+    magma_int_t n,
+    magma_int_t k,
+    magmaDoubleComplex *V,
+    magma_int_t ldv,
+    magmaDoubleComplex *h,
+    magmaDoubleComplex *w,
+    double *nrm,
+    magma_queue_t queue )
+{
+    double sum = 0.0;
+
+    #pragma omp parallel for schedule(static) reduction(+:sum)
+    for( magma_int_t i=0; i<n; i++ ){
+        magmaDoubleComplex t = w[i];
+        for( magma_int_t j=0; j<k; j++ ){
+            t -= V[ i + j*ldv ] * h[j];
+        }
+        w[i] = t;
+        sum += MAGMA_Z_REAL( MAGMA_Z_CONJ( t ) * t );
+    }
+
+    if ( nrm != NULL ) {
+        *nrm = sqrt( sum );
+    }
+    return MAGMA_SUCCESS;
+}
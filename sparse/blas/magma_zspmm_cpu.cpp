@@ -0,0 +1,299 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*
+    Host SpMM: Y = alpha * A * X + beta * Y for a sparse matrix A in CSR or
+    SELL-P format and a block of dense vectors X, Y.
+
+    Every matrix entry is loaded once per block of SPMM_MAX_VECS vectors,
+    and the partial results of a row are kept in registers for the whole
+    block, so the matrix traffic is amortized over the vectors. The rows
+    are split among the threads by equal numbers of stored entries.
+*/
+
+// widest block of vectors handled in one sweep over the matrix
+#define SPMM_MAX_VECS 16
+
+
+/*****************************************************************************/
+// first row (or slice) i with ptr[i] >= part/parts of the entries
+static magma_int_t
+zspmm_split(
+    const magma_index_t *ptr,
+    magma_int_t n,
+    magma_int_t part,
+    magma_int_t parts )
+{
+    magma_int_t lo = 0, hi = n;
+    double target = (double) ptr[n] * part / parts;
+
+    if ( part >= parts ) {
+        return n;
+    }
+    while ( lo < hi ) {
+        magma_int_t mid = lo + (hi - lo) / 2;
+        if ( ptr[mid] < target ) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+
+/*****************************************************************************/
+// y(i,0:W) = alpha * t + beta * y(i,0:W), y is not read if beta is zero.
+// For interleaved vectors (I) the stride yj is 1 at compile time.
+template< magma_int_t W, bool I >
+static inline void
+zspmm_store(
+    const magmaDoubleComplex *t,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex *y,
+    magma_int_t yj )
+{
+    if ( I ) {
+        yj = 1;
+    }
+    if ( MAGMA_Z_ABS( beta ) == 0.0 ) {
+        for( magma_int_t w=0; w<W; w++ ){
+            y[ w*yj ] = alpha * t[w];
+        }
+    } else {
+        for( magma_int_t w=0; w<W; w++ ){
+            y[ w*yj ] = alpha * t[w] + beta * y[ w*yj ];
+        }
+    }
+}
+
+
+/*****************************************************************************/
+// W vectors starting at x, y for the CSR rows r0 <= i < r1.
+// Entry (i,j) of x is x[ i*xs + j*xj ], the same for y.
+template< magma_int_t W, bool I >
+static void
+zspmm_csr(
+    const magma_z_matrix *A,
+    magma_int_t r0, magma_int_t r1,
+    magmaDoubleComplex alpha,
+    const magmaDoubleComplex *x, magma_int_t xs, magma_int_t xj,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex *y, magma_int_t ys, magma_int_t yj )
+{
+    if ( I ) {
+        xj = 1;
+    }
+    for( magma_int_t i=r0; i<r1; i++ ){
+        magmaDoubleComplex t[W];
+        for( magma_int_t w=0; w<W; w++ ){
+            t[w] = MAGMA_Z_ZERO;
+        }
+        for( magma_int_t k=A->row[i]; k<A->row[i+1]; k++ ){
+            magmaDoubleComplex v = A->val[k];
+            const magmaDoubleComplex *xk = x + A->col[k] * xs;
+            for( magma_int_t w=0; w<W; w++ ){
+                t[w] += v * xk[ w*xj ];
+            }
+        }
+        zspmm_store<W, I>( t, alpha, beta, y + i*ys, yj );
+    }
+}
+
+
+/*****************************************************************************/
+// the same for the SELL-P slices s0 <= s < s1, the padding entries are
+// zero and do not change the result
+template< magma_int_t W, bool I >
+static void
+zspmm_sellp(
+    const magma_z_matrix *A,
+    magma_int_t s0, magma_int_t s1,
+    magmaDoubleComplex alpha,
+    const magmaDoubleComplex *x, magma_int_t xs, magma_int_t xj,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex *y, magma_int_t ys, magma_int_t yj )
+{
+    magma_int_t C = A->blocksize;
+    if ( I ) {
+        xj = 1;
+    }
+    for( magma_int_t s=s0; s<s1; s++ ){
+        magma_int_t len = ( A->row[s+1] - A->row[s] ) / C;
+        for( magma_int_t j=0; j<C && s*C+j<A->num_rows; j++ ){
+            magmaDoubleComplex t[W];
+            for( magma_int_t w=0; w<W; w++ ){
+                t[w] = MAGMA_Z_ZERO;
+            }
+            for( magma_int_t k=0; k<len; k++ ){
+                magma_int_t idx = A->row[s] + j + k*C;
+                magmaDoubleComplex v = A->val[idx];
+                const magmaDoubleComplex *xk = x + A->col[idx] * xs;
+                for( magma_int_t w=0; w<W; w++ ){
+                    t[w] += v * xk[ w*xj ];
+                }
+            }
+            zspmm_store<W, I>( t, alpha, beta, y + (s*C+j)*ys, yj );
+        }
+    }
+}
+
+
+/*****************************************************************************/
+template< magma_int_t W, bool I >
+static void
+zspmm_block(
+    const magma_z_matrix *A,
+    magma_int_t p0, magma_int_t p1,
+    magmaDoubleComplex alpha,
+    const magmaDoubleComplex *x, magma_int_t xs, magma_int_t xj,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex *y, magma_int_t ys, magma_int_t yj )
+{
+    if ( A->storage_type == Magma_SELLP ) {
+        zspmm_sellp<W, I>( A, p0, p1, alpha, x, xs, xj, beta, y, ys, yj );
+    } else {
+        zspmm_csr<W, I>( A, p0, p1, alpha, x, xs, xj, beta, y, ys, yj );
+    }
+}
+
+
+/*****************************************************************************/
+// all num_vecs vectors for the rows (slices) p0 <= p < p1, in blocks of
+// SPMM_MAX_VECS, 8, 4 and single vectors
+template< bool I >
+static void
+zspmm_blocks(
+    const magma_z_matrix *A,
+    magma_int_t p0, magma_int_t p1,
+    magma_int_t num_vecs,
+    magmaDoubleComplex alpha,
+    const magmaDoubleComplex *x, magma_int_t xs, magma_int_t xj,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex *y, magma_int_t ys, magma_int_t yj )
+{
+    magma_int_t j = 0;
+    for( ; j+SPMM_MAX_VECS <= num_vecs; j+=SPMM_MAX_VECS ){
+        zspmm_block<SPMM_MAX_VECS, I>( A, p0, p1, alpha, x + j*xj, xs, xj,
+                                       beta, y + j*yj, ys, yj );
+    }
+    for( ; j+8 <= num_vecs; j+=8 ){
+        zspmm_block<8, I>( A, p0, p1, alpha, x + j*xj, xs, xj,
+                           beta, y + j*yj, ys, yj );
+    }
+    for( ; j+4 <= num_vecs; j+=4 ){
+        zspmm_block<4, I>( A, p0, p1, alpha, x + j*xj, xs, xj,
+                           beta, y + j*yj, ys, yj );
+    }
+    for( ; j < num_vecs; j++ ){
+        zspmm_block<1, I>( A, p0, p1, alpha, x + j*xj, xs, xj,
+                           beta, y + j*yj, ys, yj );
+    }
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes Y = alpha * A * X + beta * Y on the CPU for a sparse matrix A
+    in CSR or SELL-P format and num_vecs = X.num_rows / A.num_cols *
+    X.num_cols dense vectors.
+
+    The vectors are processed in blocks of 16, 8, 4 and 1, one sweep over
+    A per block. With X.major == MagmaRowMajor the vectors are interleaved,
+    entry (i,j) is stored at i * num_vecs + j, and the vectors of a block
+    are contiguous in memory. Otherwise they are stored one after the
+    other with leading dimension A.num_cols (A.num_rows for Y).
+
+    Arguments
+    ---------
+
+    @param[in]
+    alpha       magmaDoubleComplex
+                scalar multiplier
+
+    @param[in]
+    A           magma_z_matrix
+                CSR or SELLP matrix on the CPU
+
+    @param[in]
+    x           magma_z_matrix
+                input vectors on the CPU
+
+    @param[in]
+    beta        magmaDoubleComplex
+                scalar multiplier
+
+    @param[in,out]
+    y           magma_z_matrix
+                input/output vectors on the CPU, same layout as x
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zblas
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zspmm_cpu(
+    magmaDoubleComplex alpha,
+    magma_z_matrix A,
+    magma_z_matrix x,
+    magmaDoubleComplex beta,
+    magma_z_matrix y,
+    magma_queue_t queue )
+{
+    magma_int_t num_vecs, parts, xs, xj, ys, yj;
+
+    if ( ( A.storage_type != Magma_CSR && A.storage_type != Magma_SELLP ) ||
+         A.memory_location != Magma_CPU || x.memory_location != Magma_CPU ||
+         y.memory_location != Magma_CPU || A.num_cols == 0 ) {
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
+
+    num_vecs = x.num_rows / A.num_cols * x.num_cols;
+    if ( x.major == MagmaRowMajor ) {
+        xs = num_vecs; xj = 1;
+        ys = num_vecs; yj = 1;
+    } else {
+        xs = 1; xj = A.num_cols;
+        ys = 1; yj = A.num_rows;
+    }
+    // rows for CSR, slices for SELL-P
+    parts = ( A.storage_type == Magma_SELLP ) ? A.numblocks : A.num_rows;
+
+    #pragma omp parallel
+    {
+        magma_int_t tid = 0, nthreads = 1;
+        #ifdef _OPENMP
+        tid = omp_get_thread_num();
+        nthreads = omp_get_num_threads();
+        #endif
+        magma_int_t p0 = zspmm_split( A.row, parts, tid, nthreads );
+        magma_int_t p1 = zspmm_split( A.row, parts, tid+1, nthreads );
+
+        if ( x.major == MagmaRowMajor ) {
+            zspmm_blocks<true>( &A, p0, p1, num_vecs, alpha, x.val, xs, xj,
+                                beta, y.val, ys, yj );
+        } else {
+            zspmm_blocks<false>( &A, p0, p1, num_vecs, alpha, x.val, xs, xj,
+                                 beta, y.val, ys, yj );
+        }
+    }
+
+    return MAGMA_SUCCESS;
+}
@@ -0,0 +1,170 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+
+*/
+#include "magmasparse_internal.h"
+
+#define BLOCK_X 32
+#define BLOCK_Y 8
+// planes of the grid handled by one thread block
+#define BLOCK_Z 16
+
+#define TILE(p, ly, lx) tile[ ( (p) * (BLOCK_Y+2) + (ly) ) * (BLOCK_X+2) + (lx) ]
+
+
+// loads plane z of x, including the halo of the thread block, into the
+// shared memory slot p. Points outside the grid are zero.
+__device__ void
+zgestencilmv_load(
+    int nx, int ny, int nz,
+    int z,
+    int p,
+    const magmaDoubleComplex * __restrict__ dx,
+    magmaDoubleComplex *tile )
+{
+    int tid = threadIdx.y * BLOCK_X + threadIdx.x;
+    for( int i=tid; i<(BLOCK_X+2)*(BLOCK_Y+2); i+=BLOCK_X*BLOCK_Y ){
+        int lx = i % (BLOCK_X+2);
+        int ly = i / (BLOCK_X+2);
+        int gx = blockIdx.x * BLOCK_X + lx - 1;
+        int gy = blockIdx.y * BLOCK_Y + ly - 1;
+        TILE( p, ly, lx ) = ( z >= 0 && z < nz && gx >= 0 && gx < nx
+                              && gy >= 0 && gy < ny )
+                            ? dx[ ( (size_t) z * ny + gy ) * nx + gx ]
+                            : MAGMA_Z_ZERO;
+    }
+}
+
+
+// 27-point stencil kernel: every thread block marches through BLOCK_Z
+// planes of a BLOCK_X x BLOCK_Y column, keeping three planes of x in
+// shared memory, so each entry of x is read once from global memory
+__global__ void
+zgestencilmv_kernel(
+    int nx, int ny, int nz,
+    magmaDoubleComplex alpha,
+    const magmaDoubleComplex * __restrict__ dcoef,
+    const magmaDoubleComplex * __restrict__ dx,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex * dy )
+{
+    __shared__ magmaDoubleComplex coef[ MAGMA_STENCIL_SIZE ];
+    __shared__ magmaDoubleComplex tile[ 3 * (BLOCK_Y+2) * (BLOCK_X+2) ];
+
+    int tx = threadIdx.x;
+    int ty = threadIdx.y;
+    int x = blockIdx.x * BLOCK_X + tx;
+    int y = blockIdx.y * BLOCK_Y + ty;
+    int z0 = blockIdx.z * BLOCK_Z;
+    int z1 = min( z0 + BLOCK_Z, nz );
+
+    int tid = ty * BLOCK_X + tx;
+    if( tid < MAGMA_STENCIL_SIZE ){
+        coef[ tid ] = dcoef[ tid ];
+    }
+    // plane z is kept in slot (z+1)%3
+    zgestencilmv_load( nx, ny, nz, z0-1, z0%3, dx, tile );
+    zgestencilmv_load( nx, ny, nz, z0, (z0+1)%3, dx, tile );
+
+    for( int z=z0; z<z1; z++ ){
+        zgestencilmv_load( nx, ny, nz, z+1, (z+2)%3, dx, tile );
+        __syncthreads();
+
+        if( x < nx && y < ny ){
+            magmaDoubleComplex sum = MAGMA_Z_ZERO;
+            #pragma unroll
+            for( int dz=0; dz<3; dz++ ){
+                int p = (z+dz)%3;
+                #pragma unroll
+                for( int dy=0; dy<3; dy++ ){
+                    #pragma unroll
+                    for( int dx=0; dx<3; dx++ ){
+                        sum += coef[ dz*9 + dy*3 + dx ] * TILE( p, ty+dy, tx+dx );
+                    }
+                }
+            }
+            size_t row = ( (size_t) z * ny + y ) * nx + x;
+            dy[ row ] = alpha * sum + beta * dy[ row ];
+        }
+        __syncthreads();
+    }
+}
+
+
+/**
+    Purpose
+    -------
+
+    This routine computes y = alpha * A * x + beta * y for a matrix-free
+    stencil operator A in Magma_STENCIL format on a nx x ny x nz grid,
+    see magma_zm_stencil. Only the 27 coefficients are read from memory
+    besides x and y; the thread blocks keep three planes of x in shared
+    memory while marching through the grid in z.
+
+    Arguments
+    ---------
+
+    @param[in]
+    nx          magma_int_t
+                grid points in x
+
+    @param[in]
+    ny          magma_int_t
+                grid points in y
+
+    @param[in]
+    nz          magma_int_t
+                grid points in z
+
+    @param[in]
+    alpha       magmaDoubleComplex
+                scalar multiplier
+
+    @param[in]
+    dcoef       magmaDoubleComplex_ptr
+                stencil coefficients (length MAGMA_STENCIL_SIZE)
+
+    @param[in]
+    dx          magmaDoubleComplex_ptr
+                input vector x
+
+    @param[in]
+    beta        magmaDoubleComplex
+                scalar multiplier
+
+    @param[out]
+    dy          magmaDoubleComplex_ptr
+                input/output vector y
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zblas
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zgestencilmv(
+    magma_int_t nx,
+    magma_int_t ny,
+    magma_int_t nz,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_ptr dcoef,
+    magmaDoubleComplex_ptr dx,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr dy,
+    magma_queue_t queue )
+{
+    dim3 grid( magma_ceildiv( nx, BLOCK_X ), magma_ceildiv( ny, BLOCK_Y ),
+               magma_ceildiv( nz, BLOCK_Z ) );
+    dim3 threads( BLOCK_X, BLOCK_Y, 1 );
+    zgestencilmv_kernel<<< grid, threads, 0, queue->cuda_stream() >>>
+                  ( nx, ny, nz, alpha, dcoef, dx, beta, dy );
+    return MAGMA_SUCCESS;
+}
@@ -1119,6 +1119,14 @@ magma_zcgmerge_spmv1(
         magma_zcgmerge_spmvellpackrt_kernel2<<< Gs, Bs, Ms, queue->cuda_stream() >>>
                       ( A.num_rows, dz, dd, d1 );
     }
+    else if ( A.storage_type == Magma_STENCIL ) {
+        // the matrix-free SpMV uses a 2D grid over the x-y planes,
+        // the dot product is a separate pass
+        magma_zgestencilmv( A.stencil_nx, A.stencil_ny, A.stencil_nz,
+                            MAGMA_Z_ONE, A.dval, dd, MAGMA_Z_ZERO, dz, queue );
+        magma_zcgmerge_spmvellpackrt_kernel2<<< Gs, Bs, Ms, queue->cuda_stream() >>>
+                      ( A.num_rows, dz, dd, d1 );
+    }
     else if ( A.storage_type == Magma_SELLP && A.alignment == 1 ) {
             magma_zcgmerge_spmvell_kernelb1<<< Gs, Bs, Ms, queue->cuda_stream() >>>
             ( A.num_rows, A.blocksize, 
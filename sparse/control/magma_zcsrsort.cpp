@@ -0,0 +1,336 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <stdint.h>
+
+// Rows of up to SEGSORT_SHORT entries, and of more than SEGSORT_NETWORK up
+// to SEGSORT_INSERTION entries, are sorted by insertion sort, rows in
+// between by a sorting network, and longer rows by radix sort. For the very
+// short rows of stencil matrices, insertion sort does fewer comparisons than
+// the network on 8 inputs.
+#define SEGSORT_SHORT       8
+#define SEGSORT_NETWORK    16
+#define SEGSORT_INSERTION  32
+
+// radix sort digit width, in bits
+#define SEGSORT_RADIX_BITS 8
+#define SEGSORT_RADIX      (1 << SEGSORT_RADIX_BITS)
+
+// full unrolling of the sorting network loops
+#if defined(__GNUC__)
+#define SEGSORT_UNROLL     _Pragma("GCC unroll 16")
+#else
+#define SEGSORT_UNROLL
+#endif
+
+
+/******************************************************************************/
+// Order-preserving map of a signed index to an unsigned one.
+static inline uint32_t
+segsort_ukey( magma_index_t key )
+{
+    return uint32_t( key ) ^ 0x80000000u;
+}
+
+
+/******************************************************************************/
+// Sorts one row of n <= N entries with Batcher's odd-even merge network on N
+// inputs. Each key is extended by its position in the row, which makes the
+// keys distinct, so the network sorts stably; the padding sorts last.
+// The compare-exchanges are branch-free min/max on 64-bit words, and the
+// loops are unrolled into a straight sequence of them.
+template< int N >
+static void
+segsort_network(
+    magma_int_t n,
+    magma_index_t *key,
+    magmaDoubleComplex *val )
+{
+    uint64_t a[N];
+    magmaDoubleComplex v[N];
+
+    for (int i = 0; i < N; ++i) {
+        a[i] = (i < n ? (uint64_t( segsort_ukey( key[i] )) << 32) | uint64_t( i )
+                      : UINT64_MAX);
+    }
+
+    SEGSORT_UNROLL
+    for (int p = 1; p < N; p <<= 1) {
+        SEGSORT_UNROLL
+        for (int k = p; k >= 1; k >>= 1) {
+            SEGSORT_UNROLL
+            for (int j = k % p; j + k < N; j += 2*k) {
+                SEGSORT_UNROLL
+                for (int i = 0; i < k && i + j + k < N; ++i) {
+                    if ((i + j) / (2*p) == (i + j + k) / (2*p)) {
+                        uint64_t lo = a[i+j], hi = a[i+j+k];
+                        a[i+j]   = (lo < hi ? lo : hi);
+                        a[i+j+k] = (lo < hi ? hi : lo);
+                    }
+                }
+            }
+        }
+    }
+
+    if (val != NULL) {
+        for (magma_int_t i = 0; i < n; ++i) {
+            v[i] = val[i];
+        }
+        for (magma_int_t i = 0; i < n; ++i) {
+            val[i] = v[ a[i] & 0xffffffffu ];
+        }
+    }
+    for (magma_int_t i = 0; i < n; ++i) {
+        key[i] = magma_index_t( uint32_t( a[i] >> 32 ) ^ 0x80000000u );
+    }
+}
+
+
+/******************************************************************************/
+// Stable insertion sort of one row.
+static void
+segsort_insertion(
+    magma_int_t n,
+    magma_index_t *key,
+    magmaDoubleComplex *val )
+{
+    for (magma_int_t i = 1; i < n; ++i) {
+        magma_index_t k = key[i];
+        magma_int_t j = i - 1;
+        if (key[j] <= k)
+            continue;
+        if (val != NULL) {
+            magmaDoubleComplex v = val[i];
+            for (; j >= 0 && key[j] > k; --j) {
+                key[j+1] = key[j];
+                val[j+1] = val[j];
+            }
+            key[j+1] = k;
+            val[j+1] = v;
+        }
+        else {
+            for (; j >= 0 && key[j] > k; --j) {
+                key[j+1] = key[j];
+            }
+            key[j+1] = k;
+        }
+    }
+}
+
+
+/******************************************************************************/
+// Stable LSD radix sort of one row, one pass per SEGSORT_RADIX_BITS digit of
+// (key - min key), so rows spanning a narrow range of columns need fewer
+// passes. tkey and tval are workspaces of length n; tval is not referenced
+// if val is NULL.
+static void
+segsort_radix(
+    magma_int_t n,
+    magma_index_t *key,
+    magmaDoubleComplex *val,
+    magma_index_t *tkey,
+    magmaDoubleComplex *tval )
+{
+    magma_index_t kmin = key[0], kmax = key[0];
+    for (magma_int_t i = 1; i < n; ++i) {
+        kmin = min( kmin, key[i] );
+        kmax = max( kmax, key[i] );
+    }
+    uint32_t range = uint32_t( kmax ) - uint32_t( kmin );
+
+    magma_index_t *src_k = key, *dst_k = tkey;
+    magmaDoubleComplex *src_v = val, *dst_v = tval;
+    magma_int_t count[ SEGSORT_RADIX ];
+    for (int shift = 0; shift < 32 && (range >> shift) != 0; shift += SEGSORT_RADIX_BITS) {
+        for (int d = 0; d < SEGSORT_RADIX; ++d) {
+            count[d] = 0;
+        }
+        for (magma_int_t i = 0; i < n; ++i) {
+            uint32_t d = ((uint32_t( src_k[i] ) - uint32_t( kmin )) >> shift) & (SEGSORT_RADIX - 1);
+            count[d]++;
+        }
+        magma_int_t sum = 0;
+        for (int d = 0; d < SEGSORT_RADIX; ++d) {
+            magma_int_t c = count[d];
+            count[d] = sum;
+            sum += c;
+        }
+        for (magma_int_t i = 0; i < n; ++i) {
+            uint32_t d = ((uint32_t( src_k[i] ) - uint32_t( kmin )) >> shift) & (SEGSORT_RADIX - 1);
+            magma_int_t pos = count[d]++;
+            dst_k[pos] = src_k[i];
+            if (val != NULL)
+                dst_v[pos] = src_v[i];
+        }
+        magma_index_t *tk = src_k;  src_k = dst_k;  dst_k = tk;
+        magmaDoubleComplex *tv = src_v;  src_v = dst_v;  dst_v = tv;
+    }
+
+    // after an odd number of passes, the result is in the workspace
+    if (src_k != key) {
+        for (magma_int_t i = 0; i < n; ++i) {
+            key[i] = src_k[i];
+        }
+        if (val != NULL) {
+            for (magma_int_t i = 0; i < n; ++i) {
+                val[i] = src_v[i];
+            }
+        }
+    }
+}
+
+
+/******************************************************************************/
+// First row r in [0, num_rows] with row[r] >= target.
+static magma_int_t
+segsort_lower_bound(
+    magma_int_t num_rows,
+    const magma_index_t *row,
+    magma_int_t target )
+{
+    magma_int_t lo = 0, hi = num_rows;
+    while (lo < hi) {
+        magma_int_t mid = lo + (hi - lo) / 2;
+        if (row[mid] < target)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Sorts the entries of every row of a CSR structure by increasing column
+    index, carrying the values along. The sort is stable, so entries with
+    equal column index keep their order.
+
+    Each row is sorted by the algorithm suited to its length: a sorting
+    network for rows of 9 to 16 entries, insertion sort for shorter rows
+    and rows of up to 32 entries, and a radix sort on the column indices
+    relative to the smallest one for longer rows. Rows that are already
+    sorted are left untouched. The rows are split among the OpenMP threads
+    in contiguous blocks of about equal numbers of nonzeros rather than
+    rows, so a few long rows do not serialize the sort.
+
+    Arguments
+    ---------
+
+    @param[in]
+    num_rows    magma_int_t
+                Number of rows.
+
+    @param[in]
+    row         magma_index_t*
+                Row pointer, of length num_rows+1.
+
+    @param[in,out]
+    col         magma_index_t*
+                Column indices, sorted within each row on output.
+
+    @param[in,out]
+    val         magmaDoubleComplex*
+                Values, permuted along with the column indices.
+                May be NULL, to sort the column indices only.
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+*******************************************************************************/
+
+extern "C" magma_int_t
+magma_zcsr_segsort(
+    magma_int_t num_rows,
+    const magma_index_t *row,
+    magma_index_t *col,
+    magmaDoubleComplex *val,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_index_t *tkey = NULL;
+    magmaDoubleComplex *tval = NULL;
+    magma_int_t num_threads = 1, maxlen = 0;
+    magma_int_t nnz = row[num_rows] - row[0];
+
+    if (num_rows <= 0 || nnz == 0)
+        return info;
+
+    #pragma omp parallel for reduction(max:maxlen)
+    for (magma_int_t r = 0; r < num_rows; r++) {
+        maxlen = max( maxlen, magma_int_t( row[r+1] - row[r] ));
+    }
+
+#ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+#endif
+
+    // radix sort workspace, one row per thread
+    if (maxlen > SEGSORT_INSERTION) {
+        CHECK( magma_index_malloc_cpu( &tkey, num_threads * maxlen ));
+        if (val != NULL) {
+            CHECK( magma_zmalloc_cpu( &tval, num_threads * maxlen ));
+        }
+    }
+
+    #pragma omp parallel num_threads( num_threads )
+    {
+#ifdef _OPENMP
+        magma_int_t id = omp_get_thread_num();
+        magma_int_t nt = omp_get_num_threads();
+#else
+        magma_int_t id = 0;
+        magma_int_t nt = 1;
+#endif
+        // the rows whose first nonzero falls in this thread's share of nnz
+        magma_int_t rbeg = segsort_lower_bound( num_rows, row, row[0] + (nnz *  id   ) / nt );
+        magma_int_t rend = segsort_lower_bound( num_rows, row, row[0] + (nnz * (id+1)) / nt );
+        if (id == nt-1)
+            rend = num_rows;
+
+        magma_index_t *my_tkey = (tkey != NULL ? tkey + id * maxlen : NULL);
+        magmaDoubleComplex *my_tval = (tval != NULL ? tval + id * maxlen : NULL);
+
+        for (magma_int_t r = rbeg; r < rend; r++) {
+            magma_int_t n = row[r+1] - row[r];
+            magma_index_t *key = col + row[r];
+            magmaDoubleComplex *v = (val != NULL ? val + row[r] : NULL);
+
+            magma_int_t i = 1;
+            while (i < n && key[i-1] <= key[i])
+                i++;
+            if (i >= n)
+                continue;
+
+            if (n <= SEGSORT_SHORT)
+                segsort_insertion( n, key, v );
+            else if (n <= SEGSORT_NETWORK)
+                segsort_network< SEGSORT_NETWORK >( n, key, v );
+            else if (n <= SEGSORT_INSERTION)
+                segsort_insertion( n, key, v );
+            else
+                segsort_radix( n, key, v, my_tkey, my_tval );
+        }
+    }
+
+cleanup:
+    magma_free_cpu( tkey );
+    magma_free_cpu( tval );
+    return info;
+}
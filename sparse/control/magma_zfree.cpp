@@ -163,6 +163,17 @@ magma_zmfree(
             A->num_cols = 0;
             A->nnz = 0; A->true_nnz = 0;
         }
+        if ( A->storage_type == Magma_STENCIL ) {
+            if (A->ownership) {
+                magma_free_cpu( A->val );
+            }
+            A->num_rows = 0;
+            A->num_cols = 0;
+            A->nnz = 0; A->true_nnz = 0;
+            A->stencil_nx = 0;
+            A->stencil_ny = 0;
+            A->stencil_nz = 0;
+        }
         A->val = NULL;
         A->col = NULL;
         A->row = NULL;
@@ -406,6 +417,20 @@ magma_zmfree(
             A->num_cols = 0;
             A->nnz = 0; A->true_nnz = 0;
         }
+        if ( A->storage_type == Magma_STENCIL ) {
+            if (A->ownership) {
+                if ( magma_free( A->dval ) != MAGMA_SUCCESS ) {
+                    printf("Memory Free Error.\n");
+                    return MAGMA_ERR_INVALID_PTR; 
+                }
+            }
+            A->num_rows = 0;
+            A->num_cols = 0;
+            A->nnz = 0; A->true_nnz = 0;
+            A->stencil_nx = 0;
+            A->stencil_ny = 0;
+            A->stencil_nz = 0;
+        }
         A->val = NULL;
         A->col = NULL;
         A->row = NULL;
@@ -738,6 +763,54 @@ magma_zprecondfree(
         magma_free( precond_par->U_dgraphindegree_bak );
         precond_par->U_dgraphindegree_bak = NULL;
     }
+    if ( precond_par->amg != NULL ) {
+        for( magma_int_t l=0; l<precond_par->amg_levels; l++ ){
+            magma_z_amg_level *lev = &precond_par->amg[l];
+            magma_zmfree( &lev->A, queue );
+            magma_zmfree( &lev->P, queue );
+            magma_zmfree( &lev->R, queue );
+            magma_free_cpu( lev->dinv );
+            magma_free_cpu( lev->x );
+            magma_free_cpu( lev->b );
+            magma_free_cpu( lev->r );
+            magma_free_cpu( lev->d );
+            magma_free_cpu( lev->LU );
+            magma_free_cpu( lev->ipiv );
+        }
+        magma_free_cpu( precond_par->amg );
+        precond_par->amg = NULL;
+        precond_par->amg_levels = 0;
+    }
+    if ( precond_par->perm != NULL ) {
+        magma_free_cpu( precond_par->color_ptr );
+        magma_free_cpu( precond_par->perm );
+        magma_free_cpu( precond_par->dinv );
+        precond_par->color_ptr = NULL;
+        precond_par->perm = NULL;
+        precond_par->dinv = NULL;
+        precond_par->colors = 0;
+    }
+    if ( precond_par->ras != NULL ) {
+        for( magma_int_t d=0; d<precond_par->ras_domains; d++ ){
+            magma_z_ras_domain *dom = &precond_par->ras[d];
+            magma_zmfree( &dom->LU, queue );
+            magma_free_cpu( dom->idx );
+            magma_free_cpu( dom->diag );
+            magma_free_cpu( dom->dense );
+            magma_free_cpu( dom->ipiv );
+            magma_free_cpu( dom->work );
+        }
+        magma_free_cpu( precond_par->ras );
+        precond_par->ras = NULL;
+        precond_par->ras_domains = 0;
+    }
+    if ( precond_par->hwork != NULL ) {
+        magma_free_cpu( precond_par->hwork );
+        precond_par->hwork = NULL;
+    }
+    if ( precond_par->symLA != NULL ) {
+        magma_zparilu_refresh_free( precond_par, queue );
+    }
 
     precond_par->solver = Magma_NONE;
     
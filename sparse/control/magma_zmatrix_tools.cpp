@@ -1296,7 +1296,8 @@ magma_zmatrix_abssum(
 /***************************************************************************//**
     Purpose
     -------
-    SOrts the elements in a CSR matrix for increasing column index.
+    Sorts the elements in a CSR matrix for increasing column index,
+    carrying the values along. See magma_zcsr_segsort.
 
     Arguments
     ---------
@@ -1320,11 +1321,7 @@ magma_zcsr_sort(
     magma_int_t info = 0;
     
     if (A->memory_location == Magma_CPU && A->storage_type == Magma_CSR){
-        #pragma omp parallel  
-        for (int row=0; row<A->num_rows; row++) {
-            magma_zindexsort(&A->col[A->row[row]], 0, 
-                A->row[row+1]-A->row[row]-1, queue);
-        }
+        info = magma_zcsr_segsort( A->num_rows, A->row, A->col, A->val, queue );
     } else {
         info = MAGMA_ERR_NOT_SUPPORTED;
     }
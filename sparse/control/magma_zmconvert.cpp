@@ -1234,14 +1234,7 @@ magma_zmconvert(
             // CSRD to CSR (diagonal elements first)
             else if ( old_format == Magma_CSRD ) {
                 CHECK( magma_zmconvert( A, B, Magma_CSR, Magma_CSR, queue ));
-                for( magma_int_t i=0; i < A.num_rows; i++) {
-                    magma_zindexsortval(
-                    B->col,
-                    B->val,
-                    B->row[i],
-                    B->row[i+1]-1,
-                    queue );
-                }
+                CHECK( magma_zcsr_segsort( B->num_rows, B->row, B->col, B->val, queue ));
             }
 
             // CSRCOO to CSR
@@ -1268,14 +1261,7 @@ magma_zmconvert(
                     B->row[ row+1 ] = numnnz;
                 }
                 // sort elements in every row according to col
-                for( magma_int_t i=0; i < A.num_rows; i++) {
-                    magma_zindexsortval(
-                    B->col,
-                    B->val,
-                    B->row[i],
-                    B->row[i+1]-1,
-                    queue );
-                }
+                CHECK( magma_zcsr_segsort( B->num_rows, B->row, B->col, B->val, queue ));
             }
 
             // ELL/ELLPACK to CSR
@@ -1599,6 +1585,59 @@ magma_zmconvert(
                 //printf( "done\n" );
             }
 
+            // STENCIL to CSR
+            else if ( old_format == Magma_STENCIL ) {
+                // fill in information for B
+                B->storage_type = Magma_CSR;
+                B->memory_location = A.memory_location;
+                B->fill_mode = A.fill_mode;
+                B->num_rows = A.num_rows; B->true_nnz = A.true_nnz;
+                B->num_cols = A.num_cols;
+                B->nnz = A.nnz;
+                B->max_nnz_row = A.max_nnz_row;
+                B->diameter = A.diameter;
+
+                magma_int_t nx = A.stencil_nx, ny = A.stencil_ny, nz = A.stencil_nz;
+
+                CHECK( magma_zmalloc_cpu( &B->val, B->nnz ));
+                CHECK( magma_index_malloc_cpu( &B->row, B->num_rows+1 ));
+                CHECK( magma_index_malloc_cpu( &B->col, B->nnz ));
+
+                // the coefficients run through increasing offsets, so the
+                // columns of a row come out sorted
+                B->row[0] = 0;
+                #pragma omp parallel for
+                for( magma_int_t i=0; i < A.num_rows; i++) {
+                    magma_int_t x = i%nx, y = (i/nx)%ny, z = i/(nx*ny);
+                    magma_int_t count = 0;
+                    for( magma_int_t k=0; k < MAGMA_STENCIL_SIZE; k++) {
+                        magma_int_t xx = x + k%3 - 1, yy = y + (k/3)%3 - 1, zz = z + k/9 - 1;
+                        if ( MAGMA_Z_ABS( A.val[k] ) != 0.0 &&
+                             xx >= 0 && xx < nx && yy >= 0 && yy < ny && zz >= 0 && zz < nz ) {
+                            count++;
+                        }
+                    }
+                    B->row[i+1] = count;
+                }
+                for( magma_int_t i=0; i < A.num_rows; i++) {
+                    B->row[i+1] += B->row[i];
+                }
+                #pragma omp parallel for
+                for( magma_int_t i=0; i < A.num_rows; i++) {
+                    magma_int_t x = i%nx, y = (i/nx)%ny, z = i/(nx*ny);
+                    magma_int_t j = B->row[i];
+                    for( magma_int_t k=0; k < MAGMA_STENCIL_SIZE; k++) {
+                        magma_int_t xx = x + k%3 - 1, yy = y + (k/3)%3 - 1, zz = z + k/9 - 1;
+                        if ( MAGMA_Z_ABS( A.val[k] ) != 0.0 &&
+                             xx >= 0 && xx < nx && yy >= 0 && yy < ny && zz >= 0 && zz < nz ) {
+                            B->val[j] = A.val[k];
+                            B->col[j] = (zz*ny + yy)*nx + xx;
+                            j++;
+                        }
+                    }
+                }
+            }
+
             // BCSR to CSR
             else if ( old_format == Magma_BCSR ) {
                 CHECK( magma_zmtransfer(A, &dA, Magma_CPU, Magma_DEV, queue ) );
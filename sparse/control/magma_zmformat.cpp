@@ -0,0 +1,922 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define PRECISION_z
+
+#if defined(PRECISION_z)
+#define FMT_PRECISION 'z'
+#elif defined(PRECISION_c)
+#define FMT_PRECISION 'c'
+#elif defined(PRECISION_d)
+#define FMT_PRECISION 'd'
+#else
+#define FMT_PRECISION 's'
+#endif
+
+// formats of the model, in the order of magma_spmv_model.coef
+#define FMT_CSR     0
+#define FMT_CSR5    1
+#define FMT_ELL     2
+#define FMT_SELLP   3
+#define FMT_BCSR    4
+
+// formats storing more than FMT_MAXFILL times the nonzeros are not considered
+#define FMT_MAXFILL 4.0
+
+// size of the synthetic matrices of the calibration
+#define FMT_CALIB_ROWS  262144
+#define FMT_CALIB_REPS  20
+
+static const char *fmt_name[ MAGMA_SPMV_FORMATS ] =
+    { "CSR", "CSR5", "ELL", "SELLP", "BCSR" };
+
+static const magma_storage_t fmt_storage[ MAGMA_SPMV_FORMATS ] =
+    { Magma_CSR, Magma_CSR5, Magma_ELL, Magma_SELLP, Magma_BCSR };
+
+static const magma_int_t fmt_align[ MAGMA_SPMV_ALIGNS ] = { 1, 4, 8, 16, 32 };
+
+
+/******************************************************************************/
+// Terms of the model for format f with SELL-P slice size 8<<c and alignment
+// fmt_align[t], or BCSR block size 2<<c. Returns 0 if the format does not
+// fit the matrix.
+static int
+fmt_terms(
+    magma_spmv_features *F,
+    magma_int_t f,
+    magma_int_t c,
+    magma_int_t t,
+    real_Double_t *x )
+{
+    real_Double_t nnz = (real_Double_t) F->nnz;
+    real_Double_t rows = (real_Double_t) F->num_rows;
+    real_Double_t rmax = (real_Double_t) F->row_max;
+
+    x[1] = rows;
+    switch( f ){
+        case FMT_CSR:
+            x[0] = nnz;
+            x[2] = rmax;
+            break;
+        case FMT_CSR5:
+            // the tiles balance the work, long rows cost nothing extra
+            x[0] = nnz;
+            x[2] = 0.0;
+            break;
+        case FMT_ELL:
+            x[0] = rows * rmax;
+            x[2] = rmax;
+            break;
+        case FMT_SELLP:
+            if( (8<<c) * fmt_align[t] > 1024 ){
+                return 0;
+            }
+            x[0] = F->sellp[c][t];
+            x[2] = (real_Double_t) magma_ceildiv( F->row_max, fmt_align[t] );
+            break;
+        case FMT_BCSR:
+            // one column index per block, in units of values
+            x[0] = F->bcsr[c] * ( 1.0 + sizeof(magma_index_t)
+                        / ( (real_Double_t) sizeof(magmaDoubleComplex) * (2<<c) * (2<<c) ));
+            x[2] = (real_Double_t) magma_roundup( F->row_max, 2<<c );
+            break;
+        default:
+            return 0;
+    }
+    return ( x[0] <= FMT_MAXFILL * nnz || nnz == 0 );
+}
+
+
+/******************************************************************************/
+// Default model: a bandwidth estimate of the device memory traffic. Values
+// and column indices are read once per stored entry, about a quarter of the
+// gathered entries of x miss the cache. The critical path is the longest
+// sequential loop of a thread, in memory latency units.
+static void
+fmt_model_default( magma_spmv_model *model )
+{
+    const real_Double_t bw = 200.e9;        // bytes per second
+    const real_Double_t lat = 2.e-9;        // seconds per dependent load
+    real_Double_t e = sizeof(magmaDoubleComplex) + sizeof(magma_index_t)
+                    + 0.25 * sizeof(magmaDoubleComplex);
+    real_Double_t r = sizeof(magmaDoubleComplex) + sizeof(magma_index_t);
+
+    // CSR (cuSPARSE) loses coalescing on short rows, CSR5 pays the tile
+    // descriptors, the BCSR terms count the indices already
+    model->coef[FMT_CSR][0]   = e / ( 0.85 * bw );
+    model->coef[FMT_CSR][1]   = r / bw;
+    model->coef[FMT_CSR][2]   = 0.1 * lat;
+    model->coef[FMT_CSR5][0]  = e / ( 0.8 * bw );
+    model->coef[FMT_CSR5][1]  = r / bw;
+    model->coef[FMT_CSR5][2]  = 0.0;
+    model->coef[FMT_ELL][0]   = e / bw;
+    model->coef[FMT_ELL][1]   = sizeof(magmaDoubleComplex) / bw;
+    model->coef[FMT_ELL][2]   = lat;
+    model->coef[FMT_SELLP][0] = e / bw;
+    model->coef[FMT_SELLP][1] = r / bw;
+    model->coef[FMT_SELLP][2] = lat;
+    model->coef[FMT_BCSR][0]  = 1.25 * sizeof(magmaDoubleComplex) / ( 0.9 * bw );
+    model->coef[FMT_BCSR][1]  = r / bw;
+    model->coef[FMT_BCSR][2]  = lat;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Extracts the features of a sparse matrix that determine the performance
+    of the SpMV in the different storage formats: the mean, variance,
+    maximum and log2-histogram of the row lengths, the bandwidth, the
+    occupied diagonals, the entries SELL-P stores for all slice sizes
+    8, ..., 256 and alignments 1, 4, 8, 16, 32, and the entries BCSR stores
+    for the block sizes 2, 4, 8. Bin k > 0 of the histogram counts the rows
+    of length 2^(k-1) ... 2^k-1, bin 0 the empty rows, the last bin all
+    longer rows.
+
+    The analysis is a single parallel pass over the matrix, plus one pass
+    per BCSR block size.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                sparse matrix, if not CSR on the CPU, a copy is converted
+
+    @param[out]
+    features    magma_spmv_features*
+                features of A
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmfeatures(
+    magma_z_matrix A,
+    magma_spmv_features *features,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR};
+    magma_z_matrix *M = &A;
+    magma_index_t *slicemax = NULL, *mark = NULL;
+    magma_int_t *hist = NULL;
+    unsigned char *diag = NULL;
+    magma_int_t num_threads = 1;
+    magma_int_t nslices, ndiag;
+    real_Double_t sum = 0.0, sumsq = 0.0, bsum = 0.0;
+    magma_int_t rmax = 0, bw = 0, dcount = 0;
+
+    if( A.memory_location != Magma_CPU || A.storage_type != Magma_CSR ){
+        CHECK( magma_zmtransfer( A, &hA, A.memory_location, Magma_CPU, queue ));
+        CHECK( magma_zmconvert( hA, &CSRA, hA.storage_type, Magma_CSR, queue ));
+        M = &CSRA;
+    }
+
+    #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    #endif
+
+    memset( features, 0, sizeof(magma_spmv_features) );
+    features->num_rows = M->num_rows;
+    features->num_cols = M->num_cols;
+    features->nnz = M->row[ M->num_rows ];
+    if( M->num_rows == 0 ){
+        goto cleanup;
+    }
+
+    nslices = magma_ceildiv( M->num_rows, 8 );
+    ndiag = M->num_rows + M->num_cols;
+    CHECK( magma_index_malloc_cpu( &slicemax, nslices ));
+    CHECK( magma_imalloc_cpu( &hist, num_threads * MAGMA_SPMV_HIST ));
+    diag = (unsigned char*) calloc( ndiag, sizeof(unsigned char) );
+    if( diag == NULL ){
+        info = MAGMA_ERR_HOST_ALLOC;
+        goto cleanup;
+    }
+    for( magma_int_t k=0; k<num_threads * MAGMA_SPMV_HIST; k++ ){
+        hist[k] = 0;
+    }
+
+    // row lengths, bandwidth, diagonals and the SELL-P slices of size 8
+    #pragma omp parallel for reduction(+:sum,sumsq,bsum) reduction(max:rmax,bw)
+    for( magma_int_t s=0; s<nslices; s++ ){
+        magma_int_t tid = 0;
+        #ifdef _OPENMP
+        tid = omp_get_thread_num();
+        #endif
+        magma_index_t smax = 0;
+        for( magma_int_t i=s*8; i<min( (s+1)*8, M->num_rows ); i++ ){
+            magma_int_t len = M->row[i+1] - M->row[i];
+            magma_int_t bin = 0;
+            while( bin < MAGMA_SPMV_HIST-1 && ( len >> bin ) > 0 ){
+                bin++;
+            }
+            hist[ tid*MAGMA_SPMV_HIST + bin ]++;
+            sum += (real_Double_t) len;
+            sumsq += (real_Double_t) len * (real_Double_t) len;
+            rmax = max( rmax, len );
+            smax = max( smax, (magma_index_t) len );
+            for( magma_int_t k=M->row[i]; k<M->row[i+1]; k++ ){
+                magma_int_t d = M->col[k] - i;
+                bw = max( bw, ( d < 0 ) ? -d : d );
+                bsum += (real_Double_t) ( ( d < 0 ) ? -d : d );
+                #pragma omp atomic write
+                diag[ d + M->num_rows ] = 1;
+            }
+        }
+        slicemax[s] = smax;
+    }
+
+    #pragma omp parallel for reduction(+:dcount)
+    for( magma_int_t d=0; d<ndiag; d++ ){
+        dcount += diag[d];
+    }
+
+    features->row_mean = sum / M->num_rows;
+    features->row_var = sumsq / M->num_rows
+                        - features->row_mean * features->row_mean;
+    features->row_max = rmax;
+    for( magma_int_t t=0; t<num_threads; t++ ){
+        for( magma_int_t k=0; k<MAGMA_SPMV_HIST; k++ ){
+            features->row_hist[k] += hist[ t*MAGMA_SPMV_HIST + k ];
+        }
+    }
+    features->bandwidth = bw;
+    features->band_mean = ( features->nnz > 0 ) ? bsum / features->nnz : 0.0;
+    features->diagonals = dcount;
+    features->diag_fill = ( dcount > 0 ) ?
+                (real_Double_t) features->nnz / ( (real_Double_t) dcount * M->num_rows )
+                : 0.0;
+
+    // SELL-P: a slice of size 8<<c is padded to its longest row, rounded
+    // up to the alignment
+    for( magma_int_t c=0; c<MAGMA_SPMV_SLICES; c++ ){
+        magma_int_t merge = 1 << c;
+        magma_int_t C = 8 << c;
+        real_Double_t s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0, s4 = 0.0;
+        #pragma omp parallel for reduction(+:s0,s1,s2,s3,s4)
+        for( magma_int_t s=0; s<magma_ceildiv( nslices, merge ); s++ ){
+            magma_int_t m = 0;
+            for( magma_int_t k=s*merge; k<min( (s+1)*merge, nslices ); k++ ){
+                m = max( m, (magma_int_t) slicemax[k] );
+            }
+            s0 += (real_Double_t) C * magma_roundup( m, fmt_align[0] );
+            s1 += (real_Double_t) C * magma_roundup( m, fmt_align[1] );
+            s2 += (real_Double_t) C * magma_roundup( m, fmt_align[2] );
+            s3 += (real_Double_t) C * magma_roundup( m, fmt_align[3] );
+            s4 += (real_Double_t) C * magma_roundup( m, fmt_align[4] );
+        }
+        features->sellp[c][0] = s0;
+        features->sellp[c][1] = s1;
+        features->sellp[c][2] = s2;
+        features->sellp[c][3] = s3;
+        features->sellp[c][4] = s4;
+    }
+
+    // BCSR: nonzero blocks per block row, with a marker per thread and
+    // block column
+    CHECK( magma_index_malloc_cpu( &mark,
+                    num_threads * magma_ceildiv( M->num_cols, 2 ) ));
+    for( magma_int_t c=0; c<MAGMA_SPMV_BLOCKS; c++ ){
+        magma_int_t b = 2 << c;
+        magma_int_t nbr = magma_ceildiv( M->num_rows, b );
+        magma_int_t nbc = magma_ceildiv( M->num_cols, b );
+        magma_int_t blocks = 0;
+        for( magma_int_t k=0; k<num_threads * nbc; k++ ){
+            mark[k] = -1;
+        }
+        #pragma omp parallel for schedule(dynamic,64) reduction(+:blocks)
+        for( magma_int_t I=0; I<nbr; I++ ){
+            magma_int_t tid = 0;
+            #ifdef _OPENMP
+            tid = omp_get_thread_num();
+            #endif
+            magma_index_t *tmark = mark + tid * nbc;
+            for( magma_int_t i=I*b; i<min( (I+1)*b, M->num_rows ); i++ ){
+                for( magma_int_t k=M->row[i]; k<M->row[i+1]; k++ ){
+                    magma_index_t J = M->col[k] / b;
+                    if( tmark[J] != I ){
+                        tmark[J] = I;
+                        blocks++;
+                    }
+                }
+            }
+        }
+        features->bcsr[c] = (real_Double_t) blocks * b * b;
+    }
+
+cleanup:
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &CSRA, queue );
+    magma_free_cpu( slicemax );
+    magma_free_cpu( mark );
+    magma_free_cpu( hist );
+    free( diag );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Reads the SpMV performance model of this precision from a text file
+    written by magma_zmformat_model_write. Each line holds the precision,
+    the format, and the seconds per stored entry, per row, and per entry of
+    the longest row. Later lines override earlier ones, formats missing in
+    the file keep the default model.
+
+    Arguments
+    ---------
+
+    @param[in]
+    filename    const char*
+                model file
+
+    @param[out]
+    model       magma_spmv_model*
+                performance model
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmformat_model_read(
+    const char *filename,
+    magma_spmv_model *model,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    char line[256], prec, name[32];
+    real_Double_t a, b, c;
+
+    fmt_model_default( model );
+
+    FILE *fid = fopen( filename, "r" );
+    if( fid == NULL ){
+        info = MAGMA_ERR_NOT_FOUND;
+        goto cleanup;
+    }
+    while( fgets( line, sizeof(line), fid ) != NULL ){
+        if( line[0] == '#' ||
+            sscanf( line, " %c %31s %lg %lg %lg", &prec, name, &a, &b, &c ) != 5 ||
+            prec != FMT_PRECISION ){
+            continue;
+        }
+        for( magma_int_t f=0; f<MAGMA_SPMV_FORMATS; f++ ){
+            if( strcmp( name, fmt_name[f] ) == 0 ){
+                model->coef[f][0] = a;
+                model->coef[f][1] = b;
+                model->coef[f][2] = c;
+            }
+        }
+    }
+    fclose( fid );
+
+cleanup:
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Appends the SpMV performance model of this precision to a text file,
+    in the format read by magma_zmformat_model_read. The models of the four
+    precisions can share one file.
+
+    Arguments
+    ---------
+
+    @param[in]
+    filename    const char*
+                model file
+
+    @param[in]
+    model       magma_spmv_model*
+                performance model
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmformat_model_write(
+    const char *filename,
+    magma_spmv_model *model,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    FILE *fid = fopen( filename, "a" );
+    if( fid == NULL ){
+        info = MAGMA_ERR_NOT_FOUND;
+        goto cleanup;
+    }
+    fprintf( fid, "# %c: format, s per stored entry, s per row, s per entry of the longest row\n",
+             FMT_PRECISION );
+    for( magma_int_t f=0; f<MAGMA_SPMV_FORMATS; f++ ){
+        fprintf( fid, "%c %-6s %.6e %.6e %.6e\n", FMT_PRECISION, fmt_name[f],
+                 model->coef[f][0], model->coef[f][1], model->coef[f][2] );
+    }
+    fclose( fid );
+
+cleanup:
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Selects the SpMV storage format for a matrix with the given features
+    that has the smallest time predicted by the performance model, among
+    CSR, CSR5, ELL, SELL-P with all slice sizes and alignments, and BCSR
+    with block sizes 2, 4, 8. Formats storing more than four times the
+    nonzeros are not considered.
+
+    If model is NULL, the model is read from the file named by the
+    environment variable MAGMA_SPMV_MODEL, as written by the calibration
+    tester testing_zspmv_calibrate, and the default bandwidth model is used
+    if there is none.
+
+    Arguments
+    ---------
+
+    @param[in]
+    features    magma_spmv_features*
+                features of the matrix, see magma_zmfeatures
+
+    @param[in]
+    model       magma_spmv_model*
+                performance model or NULL
+
+    @param[out]
+    format      magma_storage_t*
+                selected format
+
+    @param[out]
+    blocksize   magma_int_t*
+                slice size for SELL-P, block size for BCSR, 0 otherwise
+
+    @param[out]
+    alignment   magma_int_t*
+                alignment for SELL-P, 1 otherwise
+
+    @param[out]
+    time        real_Double_t*
+                predicted time of the SpMV in seconds, may be NULL
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmformat_select(
+    magma_spmv_features *features,
+    magma_spmv_model *model,
+    magma_storage_t *format,
+    magma_int_t *blocksize,
+    magma_int_t *alignment,
+    real_Double_t *time,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_spmv_model env_model;
+    real_Double_t x[3], best = -1.0;
+
+    if( model == NULL ){
+        const char *filename = getenv( "MAGMA_SPMV_MODEL" );
+        if( filename == NULL ||
+            magma_zmformat_model_read( filename, &env_model, queue ) != MAGMA_SUCCESS ){
+            fmt_model_default( &env_model );
+        }
+        model = &env_model;
+    }
+
+    *format = Magma_CSR;
+    *blocksize = 0;
+    *alignment = 1;
+    for( magma_int_t f=0; f<MAGMA_SPMV_FORMATS; f++ ){
+        magma_int_t nc = 1, nt = 1;
+        if( f == FMT_SELLP ){
+            nc = MAGMA_SPMV_SLICES;
+            nt = MAGMA_SPMV_ALIGNS;
+        } else if( f == FMT_BCSR ){
+            nc = MAGMA_SPMV_BLOCKS;
+        }
+        for( magma_int_t c=0; c<nc; c++ ){
+            for( magma_int_t t=0; t<nt; t++ ){
+                if( ! fmt_terms( features, f, c, t, x ) ){
+                    continue;
+                }
+                real_Double_t p = model->coef[f][0] * x[0] + model->coef[f][1] * x[1]
+                         + model->coef[f][2] * x[2];
+                if( best < 0.0 || p < best ){
+                    best = p;
+                    *format = fmt_storage[f];
+                    *blocksize = ( f == FMT_SELLP ) ? ( 8 << c ) :
+                                 ( f == FMT_BCSR ) ? ( 2 << c ) : 0;
+                    *alignment = ( f == FMT_SELLP ) ? fmt_align[t] : 1;
+                }
+            }
+        }
+    }
+    if( time != NULL ){
+        *time = best;
+    }
+
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Converts a matrix into the SpMV storage format selected by
+    magma_zmformat_select. The result is on the CPU, ready for
+    magma_zmtransfer to the device.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                sparse matrix
+
+    @param[out]
+    B           magma_z_matrix*
+                A in the selected format, on the CPU
+
+    @param[in]
+    model       magma_spmv_model*
+                performance model or NULL, see magma_zmformat_select
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmconvert_auto(
+    magma_z_matrix A,
+    magma_z_matrix *B,
+    magma_spmv_model *model,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR};
+    magma_spmv_features features;
+    magma_storage_t format;
+    magma_int_t blocksize, alignment;
+
+    CHECK( magma_zmtransfer( A, &hA, A.memory_location, Magma_CPU, queue ));
+    CHECK( magma_zmconvert( hA, &CSRA, hA.storage_type, Magma_CSR, queue ));
+    CHECK( magma_zmfeatures( CSRA, &features, queue ));
+    CHECK( magma_zmformat_select( &features, model, &format, &blocksize,
+                                  &alignment, NULL, queue ));
+    B->blocksize = blocksize;
+    B->alignment = alignment;
+    CHECK( magma_zmconvert( CSRA, B, Magma_CSR, format, queue ));
+
+cleanup:
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &CSRA, queue );
+    return info;
+}
+
+
+/******************************************************************************/
+// uniform random number in (0,1]
+static real_Double_t
+fmt_rand( unsigned long long *state )
+{
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return ( (real_Double_t) ( *state >> 11 ) + 1.0 ) / 9007199254740992.0;
+}
+
+
+/******************************************************************************/
+// Synthetic CSR matrix of the calibration on the CPU:
+//  0: 7-point stencil          1: 27 entries per row in a narrow band
+//  2: 1 ... 63 random entries  3: power law row lengths up to 2048
+//  4: dense 4x4 blocks         5: 8 entries per row, every 1000th row 4000
+static magma_int_t
+fmt_synthetic(
+    magma_int_t kind,
+    magma_int_t n,
+    magma_z_matrix *A,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    unsigned long long state = 4711 + kind;
+    magma_int_t k3 = (magma_int_t) cbrt( (real_Double_t) n );
+
+    A->storage_type = Magma_CSR;
+    A->memory_location = Magma_CPU;
+    A->num_rows = n;
+    A->num_cols = n;
+    CHECK( magma_index_malloc_cpu( &A->row, n+1 ));
+
+    A->row[0] = 0;
+    for( magma_int_t i=0; i<n; i++ ){
+        magma_int_t len;
+        real_Double_t u = fmt_rand( &state );
+        switch( kind ){
+            case 0:  len = 7; break;
+            case 1:  len = 27; break;
+            case 2:  len = 1 + (magma_int_t) ( 62.0 * u ); break;
+            case 3:  len = (magma_int_t) min( 2048.0, pow( u, -1.2 ) ); break;
+            case 4:  len = 16; break;
+            default: len = ( i % 1000 == 0 ) ? 4000 : 8; break;
+        }
+        A->row[i+1] = A->row[i] + min( len, n );
+    }
+    A->nnz = A->row[n];
+    A->true_nnz = A->nnz;
+    CHECK( magma_index_malloc_cpu( &A->col, A->nnz ));
+    CHECK( magma_zmalloc_cpu( &A->val, A->nnz ));
+
+    for( magma_int_t i=0; i<n; i++ ){
+        magma_int_t len = A->row[i+1] - A->row[i];
+        magma_index_t *col = A->col + A->row[i];
+        if( kind == 0 ){
+            // offsets 0, +-1, +-k, +-k^2 of a 3D grid, wrapped around
+            magma_int_t off[7] = { -k3*k3, -k3, -1, 0, 1, k3, k3*k3 };
+            for( magma_int_t k=0; k<7; k++ ){
+                col[k] = ( i + off[k] + n ) % n;
+            }
+            magma_zindexsort( col, 0, 6, queue );
+        } else if( kind == 4 ){
+            // block row of 4 blocks around the block diagonal
+            magma_int_t J = max( 0, min( i/4 - 1, n/4 - 4 ));
+            for( magma_int_t k=0; k<16; k++ ){
+                col[k] = 4*J + k;
+            }
+        } else {
+            // entries with a random gap in a window around the diagonal
+            magma_int_t gap = ( kind == 1 ) ? 1 : 1 + (magma_int_t) ( 2.0 * fmt_rand( &state ) );
+            magma_int_t width = gap * len;
+            magma_int_t start = i - width/2 + (magma_int_t) ( 64.0 * ( fmt_rand( &state ) - 0.5 ) );
+            if( width > n ){
+                gap = 1;
+                width = len;
+            }
+            start = max( 0, min( start, n - width ));
+            for( magma_int_t k=0; k<len; k++ ){
+                col[k] = start + k * gap;
+            }
+        }
+        for( magma_int_t k=0; k<len; k++ ){
+            A->val[ A->row[i] + k ] = MAGMA_Z_MAKE( 1.0 / len, 0.0 );
+        }
+    }
+
+cleanup:
+    return info;
+}
+
+
+/******************************************************************************/
+// Least squares fit of t = X coef with coef >= 0: normal equations on the
+// scaled columns, columns with a negative coefficient are dropped.
+static void
+fmt_fit(
+    magma_int_t m,
+    real_Double_t *X,
+    real_Double_t *t,
+    real_Double_t *coef )
+{
+    real_Double_t scale[3] = { 0.0, 0.0, 0.0 };
+    int active[3] = { 1, 1, 1 };
+
+    for( magma_int_t i=0; i<m; i++ ){
+        for( int j=0; j<3; j++ ){
+            scale[j] = max( scale[j], X[3*i+j] );
+        }
+    }
+    for( int j=0; j<3; j++ ){
+        active[j] = ( scale[j] > 0.0 );
+    }
+
+    for( int pass=0; pass<3; pass++ ){
+        real_Double_t N[3][4] = {{0.0}};
+        for( magma_int_t i=0; i<m; i++ ){
+            for( int j=0; j<3; j++ ){
+                real_Double_t xj = active[j] ? X[3*i+j] / scale[j] : 0.0;
+                for( int k=0; k<3; k++ ){
+                    real_Double_t xk = active[k] ? X[3*i+k] / scale[k] : 0.0;
+                    N[j][k] += xj * xk;
+                }
+                N[j][3] += xj * t[i];
+            }
+        }
+        for( int j=0; j<3; j++ ){
+            if( ! active[j] ){
+                N[j][j] = 1.0;
+                N[j][3] = 0.0;
+            }
+        }
+        // Gaussian elimination, the matrix is symmetric positive definite
+        for( int j=0; j<3; j++ ){
+            for( int i=j+1; i<3; i++ ){
+                real_Double_t l = N[i][j] / N[j][j];
+                for( int k=j; k<4; k++ ){
+                    N[i][k] -= l * N[j][k];
+                }
+            }
+        }
+        real_Double_t c[3];
+        for( int j=2; j>=0; j-- ){
+            c[j] = N[j][3];
+            for( int k=j+1; k<3; k++ ){
+                c[j] -= N[j][k] * c[k];
+            }
+            c[j] /= N[j][j];
+        }
+        int negative = 0;
+        for( int j=0; j<3; j++ ){
+            if( active[j] && c[j] < 0.0 ){
+                active[j] = 0;
+                negative = 1;
+            }
+        }
+        if( ! negative ){
+            for( int j=0; j<3; j++ ){
+                coef[j] = active[j] ? c[j] / scale[j] : 0.0;
+            }
+            return;
+        }
+    }
+    // all columns dropped: keep the entry term only
+    real_Double_t xt = 0.0, xx = 0.0;
+    for( magma_int_t i=0; i<m; i++ ){
+        xt += X[3*i] * t[i];
+        xx += X[3*i] * X[3*i];
+    }
+    coef[0] = ( xx > 0.0 ) ? xt / xx : 0.0;
+    coef[1] = 0.0;
+    coef[2] = 0.0;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Calibrates the SpMV performance model on the current device. The
+    micro-benchmark times magma_z_spmv for six synthetic matrices with
+    regular, random, power law, blocked and few long rows in all formats
+    that fit, and fits the coefficients of each format to the measured
+    times by nonnegative least squares.
+
+    The calibration is meant to run once per installation, see the tester
+    testing_zspmv_calibrate, which stores the model for
+    magma_zmformat_model_read.
+
+    Arguments
+    ---------
+
+    @param[out]
+    model       magma_spmv_model*
+                calibrated performance model
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmformat_calibrate(
+    magma_spmv_model *model,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    const magma_int_t kinds = 6;
+    const magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    const magma_int_t slices[3] = { 0, 2, 5 };     // slice sizes 8, 32, 256
+    magma_int_t n = FMT_CALIB_ROWS;
+    magma_int_t maxsamples = kinds * MAGMA_SPMV_SLICES * MAGMA_SPMV_ALIGNS;
+
+    magma_z_matrix hA={Magma_CSR}, hB={Magma_CSR}, dB={Magma_CSR};
+    magma_z_matrix dx={Magma_CSR}, dy={Magma_CSR};
+    magma_spmv_features F;
+    real_Double_t *X = NULL, *t = NULL;
+    magma_int_t *m = NULL;
+    real_Double_t x[3];
+
+    fmt_model_default( model );
+
+    CHECK( magma_malloc_cpu( (void**) &X,
+                    3 * MAGMA_SPMV_FORMATS * maxsamples * sizeof(real_Double_t) ));
+    CHECK( magma_malloc_cpu( (void**) &t,
+                    MAGMA_SPMV_FORMATS * maxsamples * sizeof(real_Double_t) ));
+    CHECK( magma_imalloc_cpu( &m, MAGMA_SPMV_FORMATS ));
+    for( magma_int_t f=0; f<MAGMA_SPMV_FORMATS; f++ ){
+        m[f] = 0;
+    }
+    CHECK( magma_zvinit( &dx, Magma_DEV, n, 1, c_one, queue ));
+    CHECK( magma_zvinit( &dy, Magma_DEV, n, 1, c_zero, queue ));
+
+    for( magma_int_t kind=0; kind<kinds; kind++ ){
+        CHECK( fmt_synthetic( kind, n, &hA, queue ));
+        CHECK( magma_zmfeatures( hA, &F, queue ));
+
+        for( magma_int_t f=0; f<MAGMA_SPMV_FORMATS; f++ ){
+            magma_int_t nc = 1, nt = 1;
+            if( f == FMT_SELLP ){
+                nc = 3;
+                nt = MAGMA_SPMV_ALIGNS;
+            } else if( f == FMT_BCSR ){
+                nc = MAGMA_SPMV_BLOCKS;
+            }
+            for( magma_int_t ic=0; ic<nc; ic++ ){
+                for( magma_int_t it=0; it<nt; it++ ){
+                    magma_int_t c = ( f == FMT_SELLP ) ? slices[ic] : ic;
+                    if( ! fmt_terms( &F, f, c, it, x ) ){
+                        continue;
+                    }
+                    hB.blocksize = ( f == FMT_SELLP ) ? ( 8 << c ) : ( 2 << c );
+                    hB.alignment = ( f == FMT_SELLP ) ? fmt_align[it] : 1;
+                    CHECK( magma_zmconvert( hA, &hB, Magma_CSR, fmt_storage[f], queue ));
+                    CHECK( magma_zmtransfer( hB, &dB, Magma_CPU, Magma_DEV, queue ));
+
+                    CHECK( magma_z_spmv( c_one, dB, dx, c_zero, dy, queue ));
+                    real_Double_t start = magma_sync_wtime( queue );
+                    for( magma_int_t r=0; r<FMT_CALIB_REPS; r++ ){
+                        CHECK( magma_z_spmv( c_one, dB, dx, c_zero, dy, queue ));
+                    }
+                    real_Double_t end = magma_sync_wtime( queue );
+
+                    magma_int_t s = f * maxsamples + m[f];
+                    X[3*s+0] = x[0];
+                    X[3*s+1] = x[1];
+                    X[3*s+2] = x[2];
+                    t[s] = ( end - start ) / FMT_CALIB_REPS;
+                    m[f]++;
+                    magma_zmfree( &hB, queue );
+                    magma_zmfree( &dB, queue );
+                }
+            }
+        }
+        magma_zmfree( &hA, queue );
+    }
+
+    // formats with too few samples keep the default model
+    for( magma_int_t f=0; f<MAGMA_SPMV_FORMATS; f++ ){
+        if( m[f] >= 3 ){
+            fmt_fit( m[f], X + 3 * f * maxsamples, t + f * maxsamples,
+                     model->coef[f] );
+        }
+    }
+
+cleanup:
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &hB, queue );
+    magma_zmfree( &dB, queue );
+    magma_zmfree( &dx, queue );
+    magma_zmfree( &dy, queue );
+    magma_free_cpu( X );
+    magma_free_cpu( t );
+    magma_free_cpu( m );
+    return info;
+}
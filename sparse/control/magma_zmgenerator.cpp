@@ -346,3 +346,90 @@ cleanup:
     magma_zmfree( &hA, queue );
     return info;
 }
+
+
+
+/**
+    Purpose
+    -------
+
+    Generate a matrix-free stencil operator on a nx x ny x nz grid. The
+    STENCIL matrix keeps only the grid size and the 27 coefficients of the
+    3 x 3 x 3 neighbourhood, coef[ (dz+1)*9 + (dy+1)*3 + (dx+1) ] couples
+    grid point (x,y,z) with (x+dx,y+dy,z+dz). Grid points are numbered with
+    x fastest, neighbours outside the grid are dropped (Dirichlet boundary).
+    A 2D stencil uses nz = 1.
+
+    Arguments
+    ---------
+
+    @param[in]
+    nx          magma_int_t
+                grid points in x
+
+    @param[in]
+    ny          magma_int_t
+                grid points in y
+
+    @param[in]
+    nz          magma_int_t
+                grid points in z
+
+    @param[in]
+    coef        magmaDoubleComplex*
+                stencil coefficients   (length MAGMA_STENCIL_SIZE)
+
+    @param[out]
+    A           magma_z_matrix*
+                matrix to generate, STENCIL on the CPU
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C"
+magma_int_t
+magma_zm_stencil(
+    magma_int_t nx,
+    magma_int_t ny,
+    magma_int_t nz,
+    magmaDoubleComplex *coef,
+    magma_z_matrix *A,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_zmfree( A, queue );
+    A->ownership = MagmaTrue;
+    A->storage_type = Magma_STENCIL;
+    A->memory_location = Magma_CPU;
+    A->fill_mode = MagmaFull;
+    A->stencil_nx = nx;
+    A->stencil_ny = ny;
+    A->stencil_nz = nz;
+    A->num_rows = nx * ny * nz;
+    A->num_cols = nx * ny * nz;
+    A->nnz = 0;
+    A->max_nnz_row = 0;
+    A->diameter = 0;
+
+    CHECK( magma_zmalloc_cpu( &A->val, MAGMA_STENCIL_SIZE ));
+    for( magma_int_t k=0; k<MAGMA_STENCIL_SIZE; k++ ) {
+        magma_int_t dx = k%3 - 1, dy = (k/3)%3 - 1, dz = k/9 - 1;
+        A->val[k] = coef[k];
+        if ( MAGMA_Z_ABS( coef[k] ) == 0.0 ||
+             nx <= abs(dx) || ny <= abs(dy) || nz <= abs(dz) ) {
+            continue;
+        }
+        // every grid point whose neighbour lies inside the grid
+        A->nnz += (nx - abs(dx)) * (ny - abs(dy)) * (nz - abs(dz));
+        A->max_nnz_row++;
+        A->diameter = max( A->diameter, abs( dx + dy*nx + dz*nx*ny ));
+    }
+    A->true_nnz = A->nnz;
+
+cleanup:
+    return info;
+}
@@ -31,7 +31,10 @@
 
     @param[in]
     scaling     magma_scale_t
-                scaling type (unit rownorm / unit diagonal)
+                scaling type (unit rownorm / unit diagonal);
+                Magma_RUIZ is not supported, as the row and column
+                factors are needed to rescale the right hand side and
+                the solution; use magma_zmscale_ruiz
 
     @param[in]
     queue       magma_queue_t
@@ -51,6 +54,12 @@ magma_zmscale(
     
     magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR};
     
+    if ( scaling == Magma_RUIZ ) {
+        printf( "%%error: Ruiz scaling needs magma_zmscale_ruiz.\n" );
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+    
     if( A->num_rows != A->num_cols && scaling != Magma_NOSCALE ){
         printf("%% warning: non-square matrix.\n");
         printf("%% Fallback: no scaling.\n");
@@ -643,6 +652,187 @@ cleanup:
 }
 
 
+/**
+    Purpose
+    -------
+
+    Equilibrates a matrix by Ruiz scaling: iteratively scales rows and
+    columns by the inverse square roots of their max norms, until all row
+    and column max norms are within tol of 1, or maxiter sweeps are done.
+    On output A is overwritten by Dr * A * Dc. The matrix may be rectangular.
+
+    The system A x = b then becomes (Dr A Dc) y = Dr b with x = Dc y, so the
+    right hand side is scaled with dr and the solution with dc, e.g., using
+    magma_zdimv. For a symmetric matrix, dr and dc are equal and the scaled
+    matrix is symmetric.
+
+    Empty rows and columns are left unscaled. Rows and columns are processed
+    in parallel; the column norms use a transposed index of the nonzeros
+    that is built once.
+
+    Arguments
+    ---------
+
+    @param[in,out]
+    A           magma_z_matrix*
+                input/output matrix
+
+    @param[in]
+    maxiter     magma_int_t
+                maximum number of scaling sweeps
+
+    @param[in]
+    tol         double
+                tolerance on the deviation of the row and column max norms
+                from 1
+
+    @param[out]
+    dr          magma_z_matrix*
+                row scaling factors, a vector of length A->num_rows on the CPU
+
+    @param[out]
+    dc          magma_z_matrix*
+                column scaling factors, a vector of length A->num_cols on the
+                CPU
+
+    @param[out]
+    iter        magma_int_t*
+                number of scaling sweeps applied
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmscale_ruiz(
+    magma_z_matrix *A,
+    magma_int_t maxiter,
+    double tol,
+    magma_z_matrix *dr,
+    magma_z_matrix *dc,
+    magma_int_t *iter,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magmaDoubleComplex one = MAGMA_Z_ONE;
+    double *rs=NULL, *cs=NULL;
+    magma_index_t *colptr=NULL, *colidx=NULL;
+
+    magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR};
+
+    *iter = 0;
+
+    if ( A->memory_location == Magma_CPU &&
+         ( A->storage_type == Magma_CSR || A->storage_type == Magma_CSRCOO ) ) {
+        magma_int_t m = A->num_rows, n = A->num_cols;
+
+        CHECK( magma_zvinit( dr, Magma_CPU, m, 1, one, queue ));
+        CHECK( magma_zvinit( dc, Magma_CPU, n, 1, one, queue ));
+        CHECK( magma_dmalloc_cpu( &rs, m ));
+        CHECK( magma_dmalloc_cpu( &cs, n ));
+
+        // transposed index: colidx[ colptr[j] .. colptr[j+1]-1 ] are the
+        // positions of the nonzeros of column j in A->val
+        CHECK( magma_index_malloc_cpu( &colptr, n+1 ));
+        CHECK( magma_index_malloc_cpu( &colidx, A->row[m] ));
+        for( magma_int_t j=0; j<n+1; j++ ) {
+            colptr[j] = 0;
+        }
+        for( magma_int_t k=0; k<A->row[m]; k++ ) {
+            colptr[ A->col[k]+1 ]++;
+        }
+        for( magma_int_t j=0; j<n; j++ ) {
+            colptr[j+1] += colptr[j];
+        }
+        for( magma_int_t i=0; i<m; i++ ) {
+            for( magma_int_t k=A->row[i]; k<A->row[i+1]; k++ ) {
+                colidx[ colptr[A->col[k]]++ ] = k;
+            }
+        }
+        for( magma_int_t j=n; j>0; j-- ) {
+            colptr[j] = colptr[j-1];
+        }
+        colptr[0] = 0;
+
+        for( magma_int_t it=0; it<maxiter; it++ ) {
+            double dev = 0.0;
+
+            // row and column max norms of the current matrix
+            #pragma omp parallel for reduction(max:dev)
+            for( magma_int_t i=0; i<m; i++ ) {
+                double s = 0.0;
+                for( magma_int_t k=A->row[i]; k<A->row[i+1]; k++ ) {
+                    s = max( s, MAGMA_Z_ABS( A->val[k] ));
+                }
+                rs[i] = s;
+                if ( s > 0.0 ) {
+                    dev = max( dev, fabs( 1.0 - s ));
+                }
+            }
+            #pragma omp parallel for reduction(max:dev)
+            for( magma_int_t j=0; j<n; j++ ) {
+                double s = 0.0;
+                for( magma_int_t k=colptr[j]; k<colptr[j+1]; k++ ) {
+                    s = max( s, MAGMA_Z_ABS( A->val[ colidx[k] ] ));
+                }
+                cs[j] = s;
+                if ( s > 0.0 ) {
+                    dev = max( dev, fabs( 1.0 - s ));
+                }
+            }
+            if ( dev <= tol ) {
+                break;
+            }
+
+            // turn the norms into this sweep's scaling factors
+            #pragma omp parallel for
+            for( magma_int_t i=0; i<m; i++ ) {
+                rs[i] = ( rs[i] > 0.0 ? 1.0/sqrt( rs[i] ) : 1.0 );
+                dr->val[i] = dr->val[i] * rs[i];
+            }
+            #pragma omp parallel for
+            for( magma_int_t j=0; j<n; j++ ) {
+                cs[j] = ( cs[j] > 0.0 ? 1.0/sqrt( cs[j] ) : 1.0 );
+                dc->val[j] = dc->val[j] * cs[j];
+            }
+            #pragma omp parallel for
+            for( magma_int_t i=0; i<m; i++ ) {
+                for( magma_int_t k=A->row[i]; k<A->row[i+1]; k++ ) {
+                    A->val[k] = A->val[k] * ( rs[i] * cs[ A->col[k] ] );
+                }
+            }
+            (*iter)++;
+        }
+    }
+    else {
+        magma_storage_t A_storage = A->storage_type;
+        magma_location_t A_location = A->memory_location;
+        CHECK( magma_zmtransfer( *A, &hA, A->memory_location, Magma_CPU, queue ));
+        CHECK( magma_zmconvert( hA, &CSRA, hA.storage_type, Magma_CSR, queue ));
+
+        CHECK( magma_zmscale_ruiz( &CSRA, maxiter, tol, dr, dc, iter, queue ));
+
+        magma_zmfree( &hA, queue );
+        magma_zmfree( A, queue );
+        CHECK( magma_zmconvert( CSRA, &hA, Magma_CSR, A_storage, queue ));
+        CHECK( magma_zmtransfer( hA, A, Magma_CPU, A_location, queue ));
+    }
+
+cleanup:
+    magma_free_cpu( rs );
+    magma_free_cpu( cs );
+    magma_free_cpu( colptr );
+    magma_free_cpu( colidx );
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &CSRA, queue );
+    return info;
+}
+
+
 /**
     Purpose
     -------
@@ -366,6 +366,27 @@ magma_zmtransfer(
             // data transfer
             magma_zsetvector( A.num_rows * A.num_cols, A.val, 1, B->dval, 1, queue );
         }
+        //STENCIL-type
+        else if ( A.storage_type == Magma_STENCIL ) {
+            // fill in information for B
+            B->storage_type = A.storage_type;
+            B->memory_location = Magma_DEV;
+            B->sym = A.sym;
+            B->diagorder_type = A.diagorder_type;
+            B->fill_mode = A.fill_mode;
+            B->num_rows = A.num_rows;
+            B->num_cols = A.num_cols;
+            B->nnz = A.nnz; B->true_nnz = A.true_nnz;
+            B->max_nnz_row = A.max_nnz_row;
+            B->diameter = A.diameter;
+            B->stencil_nx = A.stencil_nx;
+            B->stencil_ny = A.stencil_ny;
+            B->stencil_nz = A.stencil_nz;
+            // memory allocation
+            CHECK( magma_zmalloc( &B->dval, MAGMA_STENCIL_SIZE ));
+            // data transfer
+            magma_zsetvector( MAGMA_STENCIL_SIZE, A.val, 1, B->dval, 1, queue );
+        }
     }
 
     // second case: copy matrix from host to host
@@ -723,6 +744,29 @@ magma_zmtransfer(
                 B->val[i] = A.val[i];
             }
         }
+        //STENCIL-type
+        else if ( A.storage_type == Magma_STENCIL ) {
+            // fill in information for B
+            B->storage_type = A.storage_type;
+            B->memory_location = Magma_CPU;
+            B->sym = A.sym;
+            B->diagorder_type = A.diagorder_type;
+            B->fill_mode = A.fill_mode;
+            B->num_rows = A.num_rows;
+            B->num_cols = A.num_cols;
+            B->nnz = A.nnz; B->true_nnz = A.true_nnz;
+            B->max_nnz_row = A.max_nnz_row;
+            B->diameter = A.diameter;
+            B->stencil_nx = A.stencil_nx;
+            B->stencil_ny = A.stencil_ny;
+            B->stencil_nz = A.stencil_nz;
+            // memory allocation
+            CHECK( magma_zmalloc_cpu( &B->val, MAGMA_STENCIL_SIZE ));
+            // data transfer
+            for( magma_int_t i=0; i<MAGMA_STENCIL_SIZE; i++ ) {
+                B->val[i] = A.val[i];
+            }
+        }
     }
 
     // third case: copy matrix from device to host
@@ -1005,6 +1049,27 @@ magma_zmtransfer(
             // data transfer
             magma_zgetvector( A.num_rows * A.num_cols, A.dval, 1, B->val, 1, queue );
         }
+        //STENCIL-type
+        else if ( A.storage_type == Magma_STENCIL ) {
+            // fill in information for B
+            B->storage_type = A.storage_type;
+            B->memory_location = Magma_CPU;
+            B->sym = A.sym;
+            B->diagorder_type = A.diagorder_type;
+            B->fill_mode = A.fill_mode;
+            B->num_rows = A.num_rows;
+            B->num_cols = A.num_cols;
+            B->nnz = A.nnz; B->true_nnz = A.true_nnz;
+            B->max_nnz_row = A.max_nnz_row;
+            B->diameter = A.diameter;
+            B->stencil_nx = A.stencil_nx;
+            B->stencil_ny = A.stencil_ny;
+            B->stencil_nz = A.stencil_nz;
+            // memory allocation
+            CHECK( magma_zmalloc_cpu( &B->val, MAGMA_STENCIL_SIZE ));
+            // data transfer
+            magma_zgetvector( MAGMA_STENCIL_SIZE, A.dval, 1, B->val, 1, queue );
+        }
     }
 
     // fourth case: copy matrix from device to device
@@ -1287,6 +1352,27 @@ magma_zmtransfer(
             // data transfer
             magma_zcopyvector( A.num_rows * A.num_cols, A.dval, 1, B->dval, 1, queue );
         }
+        //STENCIL-type
+        else if ( A.storage_type == Magma_STENCIL ) {
+            // fill in information for B
+            B->storage_type = A.storage_type;
+            B->memory_location = Magma_DEV;
+            B->sym = A.sym;
+            B->diagorder_type = A.diagorder_type;
+            B->fill_mode = A.fill_mode;
+            B->num_rows = A.num_rows;
+            B->num_cols = A.num_cols;
+            B->nnz = A.nnz; B->true_nnz = A.true_nnz;
+            B->max_nnz_row = A.max_nnz_row;
+            B->diameter = A.diameter;
+            B->stencil_nx = A.stencil_nx;
+            B->stencil_ny = A.stencil_ny;
+            B->stencil_nz = A.stencil_nz;
+            // memory allocation
+            CHECK( magma_zmalloc( &B->dval, MAGMA_STENCIL_SIZE ));
+            // data transfer
+            magma_zcopyvector( MAGMA_STENCIL_SIZE, A.dval, 1, B->dval, 1, queue );
+        }
     }
     
     
@@ -490,3 +490,229 @@ cleanup:
     return info;
 }
 
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    This function computes for every entry e of L the position of the entry
+    of A in the same location, map[e] = -1 if A has no entry there. The map
+    only depends on the patterns, it is recomputed when the pattern of L
+    changes and then used by all sweeps magma_zparict_sweep_map on this
+    pattern. The rows of A and L need not be sorted.
+
+    The map array is reallocated only if L has more than *map_size entries.
+    The marker work space holds one row of A per thread. It is all -1
+    between calls, so it is kept by the caller and reallocated (and reset)
+    only if it is shorter than num_threads * A.num_cols.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                System matrix in CSR.
+
+    @param[in]
+    L           magma_z_matrix
+                Current lower triangular factor in CSR.
+
+    @param[in,out]
+    map         magma_index_t**
+                Position in A of every entry of L.
+
+    @param[in,out]
+    map_size    magma_int_t*
+                Allocated length of map.
+
+    @param[in,out]
+    marker      magma_index_t**
+                Work space, NULL on the first call.
+
+    @param[in,out]
+    marker_size magma_int_t*
+                Allocated length of marker.
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+*******************************************************************************/
+
+extern "C" magma_int_t
+magma_zparict_map(
+    magma_z_matrix A,
+    magma_z_matrix L,
+    magma_index_t **map,
+    magma_int_t *map_size,
+    magma_index_t **marker,
+    magma_int_t *marker_size,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t num_threads = 1;
+
+    if( L.nnz > *map_size ){
+        magma_free_cpu( *map );
+        *map = NULL;
+        *map_size = 0;
+        CHECK( magma_index_malloc_cpu( map, L.nnz ));
+        *map_size = L.nnz;
+    }
+
+    #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    #endif
+    if( num_threads * A.num_cols > *marker_size ){
+        magma_free_cpu( *marker );
+        *marker = NULL;
+        *marker_size = 0;
+        CHECK( magma_index_malloc_cpu( marker, num_threads * A.num_cols ));
+        *marker_size = num_threads * A.num_cols;
+        #pragma omp parallel for schedule(static)
+        for( magma_int_t j=0; j<*marker_size; j++ ){
+            (*marker)[j] = -1;
+        }
+    }
+
+    #pragma omp parallel
+    {
+        magma_int_t tid = 0;
+        #ifdef _OPENMP
+        tid = omp_get_thread_num();
+        #endif
+        magma_index_t *mark = *marker + tid * A.num_cols;
+        // scatter the positions of row i of A, gather them for row i of L
+        #pragma omp for schedule(dynamic,256)
+        for( magma_int_t i=0; i<L.num_rows; i++ ){
+            for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+                mark[ A.col[k] ] = k;
+            }
+            for( magma_int_t e=L.row[i]; e<L.row[i+1]; e++ ){
+                (*map)[ e ] = mark[ L.col[e] ];
+            }
+            for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+                mark[ A.col[k] ] = -1;
+            }
+        }
+    }
+
+cleanup:
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    This function does one synchronized ParICT sweep, like
+    magma_zparict_sweep_sync, with the values of A read through the
+    precomputed positions of magma_zparict_map instead of searching the rows
+    of A.
+
+    L is stored in sorted CSR with row index. The dot product
+    L(row,1:col-1) * L(col,1:col-1) of an entry e = (row,col) then streams
+    the entries of row "row" in front of e and the entries of row "col" in
+    front of its diagonal, both contiguous in memory.
+
+    The new values are written to *buffer, which is then swapped with L->val.
+    The buffer is reallocated only if L has more than *buffer_size entries,
+    so a sequence of sweeps on the same pattern does not allocate memory.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                System matrix.
+
+    @param[in,out]
+    L           magma_z_matrix*
+                Current approximation for the lower triangular factor
+                The format is sorted CSR with row index.
+
+    @param[in]
+    map         magma_index_t*
+                Position in A of every entry of L, from magma_zparict_map.
+
+    @param[in,out]
+    buffer      magmaDoubleComplex**
+                Value buffer, swapped with L->val.
+
+    @param[in,out]
+    buffer_size magma_int_t*
+                Allocated length of buffer.
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+*******************************************************************************/
+
+extern "C" magma_int_t
+magma_zparict_sweep_map(
+    magma_z_matrix A,
+    magma_z_matrix *L,
+    magma_index_t *map,
+    magmaDoubleComplex **buffer,
+    magma_int_t *buffer_size,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magmaDoubleComplex *L_new_val, *val_swap;
+
+    if( L->nnz > *buffer_size ){
+        magma_free_cpu( *buffer );
+        *buffer = NULL;
+        *buffer_size = 0;
+        CHECK( magma_zmalloc_cpu( buffer, L->nnz ));
+        *buffer_size = L->nnz;
+    }
+    L_new_val = *buffer;
+
+    #pragma omp parallel for
+    for( magma_int_t e=0; e<L->nnz; e++){
+        magma_index_t row = L->rowidx[ e ];
+        magma_index_t col = L->col[ e ];
+        magmaDoubleComplex A_e = ( map[e] >= 0 ) ? A.val[ map[e] ] : MAGMA_Z_ZERO;
+
+        // rows are sorted: the entries left of e in row "row" and left of
+        // the diagonal in row "col" are the ones with column index < col
+        magma_int_t i = L->row[ row ];
+        magma_int_t j = L->row[ col ];
+        magma_int_t endi = e;
+        magma_int_t endj = L->row[ col+1 ] - 1;
+        magmaDoubleComplex sum = MAGMA_Z_ZERO;
+        while( i<endi && j<endj ){
+            magma_index_t icol = L->col[i];
+            magma_index_t jcol = L->col[j];
+            if( icol == jcol ){
+                sum = sum + L->val[i] * L->val[j];
+                i++;
+                j++;
+            }
+            else if( icol<jcol ){
+                i++;
+            }
+            else {
+                j++;
+            }
+        }
+        if( row == col ){
+            L_new_val[ e ] = MAGMA_Z_MAKE( sqrt( fabs( MAGMA_Z_REAL(A_e - sum) )), 0.0 );
+        } else {
+            L_new_val[ e ] = ( A_e - sum ) / L->val[ endj ];
+        }
+    }
+
+    // the old values become the buffer of the next sweep
+    val_swap = L->val;
+    L->val = L_new_val;
+    *buffer = val_swap;
+    *buffer_size = L->nnz;
+
+cleanup:
+    return info;
+}
@@ -65,6 +65,10 @@ magma_zsolverinfo(
                 printf("%%   CG (merged) performance analysis every %lld iterations\n",
                         (long long) k );
                 break;
+            case Magma_PIPECG:
+                printf("%%   CG (pipelined) performance analysis every %lld iterations\n",
+                        (long long) k );
+                break;
             case Magma_BICGSTAB:
                 printf("%%   BiCGSTAB performance analysis every %lld iterations\n",
                         (long long) k );
@@ -241,6 +245,23 @@ magma_zsolverinfo(
             case Magma_ISAI:
                 printf("%%   Preconditioner used: ParILU-SPAI.\n" );
                 break;
+            case Magma_GS:
+            case Magma_SGS:
+                printf("%%   Preconditioner used: multicolor %s(%lld colors).\n",
+                        ( precond_par->solver == Magma_SGS ) ? "SGS" : "GS",
+                        (long long) precond_par->colors );
+                break;
+            case Magma_RAS:
+                printf("%%   Preconditioner used: RAS(%lld subdomains, overlap %lld).\n",
+                        (long long) precond_par->ras_domains,
+                        (long long) precond_par->levels );
+                break;
+            case Magma_AMG:
+                printf("%%   Preconditioner used: AMG(%lld levels, %s smoother).\n",
+                        (long long) precond_par->amg_levels,
+                        ( precond_par->trisolver == Magma_CHEBYSHEV ) ?
+                        "Chebyshev" : "Jacobi" );
+                break;
             default:
                 break;
         }
@@ -250,6 +271,7 @@ magma_zsolverinfo(
             case Magma_CG:
             case Magma_PCG:
             case Magma_CGMERGE:
+            case Magma_PIPECG:
             case Magma_BICGSTAB:
             case Magma_PBICGSTAB:
             case Magma_BICGSTABMERGE:
@@ -325,6 +347,9 @@ magma_zsolverinfo(
         case Magma_CGMERGE:
             printf("%% CG solver summary:\n");
             break;
+        case Magma_PIPECG:
+            printf("%% Pipelined CG solver summary:\n");
+            break;
         case Magma_BICGSTAB:
             printf("%% BiCGSTAB solver summary:\n");
             break;
@@ -422,6 +447,17 @@ magma_zsolverinfo(
            "%%    runtime: %.4f sec\n",
             solver_par->final_res, solver_par->runtime);
     printf("%%    preconditioner runtime: %.4f sec\n", precond_par->runtime );
+    if ( ( precond_par->solver == Magma_GS || precond_par->solver == Magma_SGS )
+         && precond_par->spmv_count > 0 && precond_par->runtime > 0.0 ) {
+        // one sweep reads M, the RHS and the inverse diagonal, and updates x
+        double bytes = (double) precond_par->M.nnz
+                        * ( sizeof(magmaDoubleComplex) + sizeof(magma_index_t) )
+                     + (double) precond_par->M.num_rows
+                        * ( 3 * sizeof(magmaDoubleComplex) + sizeof(magma_index_t) );
+        printf("%%    preconditioner sweeps: %lld, %.2f GB/s\n",
+                (long long) precond_par->spmv_count,
+                bytes * precond_par->spmv_count / precond_par->runtime / 1e9 );
+    }
 cleanup:
     printf("%%=================================================================================%%\n");
     return MAGMA_SUCCESS;
@@ -609,6 +645,36 @@ magma_zsolverinfo_init(
     precond_par->L_dgraphindegree_bak = NULL;
     precond_par->U_dgraphindegree_bak = NULL;
 
+    precond_par->amg = NULL;
+    precond_par->amg_levels = 0;
+
+    precond_par->colors = 0;
+    precond_par->color_ptr = NULL;
+    precond_par->perm = NULL;
+    precond_par->dinv = NULL;
+    precond_par->hwork = NULL;
+
+    precond_par->ras = NULL;
+    precond_par->ras_domains = 0;
+
+    precond_par->symLA = NULL;
+    precond_par->symUA = NULL;
+    precond_par->symUT = NULL;
+    precond_par->symnnz = 0;
+    precond_par->requested = precond_par->solver;
+    // freeze counts ParILUT steps: 0 (never) ... sweeps
+    if( precond_par->freeze < 0 ) {
+        printf("%% warning: freeze = %lld is negative, the pattern is never fixed.\n",
+               (long long) precond_par->freeze );
+        precond_par->freeze = 0;
+    }
+    else if( precond_par->freeze > precond_par->sweeps ) {
+        printf("%% warning: freeze = %lld exceeds the %lld ParILUT steps, using %lld.\n",
+               (long long) precond_par->freeze, (long long) precond_par->sweeps,
+               (long long) precond_par->sweeps );
+        precond_par->freeze = precond_par->sweeps;
+    }
+
 cleanup:
     if( info != 0 ){
         magma_free( solver_par->timing );
@@ -699,6 +765,7 @@ magma_zKrylov_check( magma_solver_type solver )
     switch( solver ) {
         case  Magma_CG:
         case  Magma_CGMERGE:
+        case  Magma_PIPECG:
         case  Magma_BICGSTAB:
         case  Magma_BICGSTABMERGE:
         case  Magma_BICGSTABMERGE2:
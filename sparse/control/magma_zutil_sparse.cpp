@@ -26,7 +26,7 @@ static const char *usage_sparse =
 " --solver      Possibility to choose a solver:\n"
 "               CG, PCG, BICGSTAB, PBICGSTAB, GMRES, PGMRES, LOBPCG, JACOBI,\n"
 "               BAITER, IDR, PIDR, CGS, PCGS, TFQMR, PTFQMR, QMR, PQMR, BICG,\n"
-"               PBICG, BOMBARDMENT, ITERREF.\n"
+"               PBICG, PIPECG, BOMBARDMENT, ITERREF.\n"
 " --basic       Use non-optimized version\n"
 " --ev x        For eigensolvers, set number of eigenvalues/eigenvectors to compute.\n"
 " --restart     For GMRES: possibility to choose the restart.\n"
@@ -42,10 +42,13 @@ static const char *usage_sparse =
 " --mscale      Possibility to scale the original matrix:\n"
 "               NOSCALE   no scaling\n"
 "               UNITDIAG   symmetric scaling to unit diagonal\n"
+"               RUIZ       iterative row and column equilibration;\n"
+"                          only testing_zsolver_rhs_scaling, which\n"
+"                          rescales the rhs and the solution\n"
 " --precond x   Possibility to choose a preconditioner:\n"
 "               CG, BICGSTAB, GMRES, LOBPCG, JACOBI,\n"
 "               BAITER, IDR, CGS, TFQMR, QMR, BICG\n"
-"               BOMBARDMENT, ITERREF, ILU, PARILU, PARILUT, NONE.\n"
+"               BOMBARDMENT, ITERREF, ILU, PARILU, PARILUT, AMG, GS, SGS, RAS, NONE.\n"
 "                   --patol atol  Absolute residual stopping criterion for preconditioner.\n"
 "                   --prtol rtol  Relative residual stopping criterion for preconditioner.\n"
 "                   --piters k    Iteration count for iterative preconditioner.\n"
@@ -53,8 +56,15 @@ static const char *usage_sparse =
 "                   --triolver k  Solver for triangular ILU factors: e.g. CUSOLVE, JACOBI, ISAI.\n"
 "                   --ppattern k  Pattern used for ISAI preconditioner.\n"
 "                   --psweeps x   Number of iterative ParILU sweeps.\n"
+"                   --pfreeze k   ParILUT: fix the pattern after k steps (0: never).\n"
+"                   --plevels k   AMG: maximum number of levels (0: automatic).\n"
+"                   --psweeps x   AMG: pre- and post-smoothing steps per level.\n"
+"                   --trisolver k AMG: smoother, JACOBI (default) or CHEBYSHEV.\n"
+"                   --plevels k   GS, SGS: distance-k coloring, k = 1 (default) or 2.\n"
+"                   --psweeps x   GS, SGS: number of multicolor sweeps.\n"
+"                   --plevels k   RAS: overlap in layers of neighbours (0: block Jacobi).\n"
 " --trisolver   Possibility to choose a triangular solver for ILU preconditioning: \n"
-"               e.g. CUSOLVE, ISPTRSV, JACOBI, VBJACOBI, ISAI.\n"
+"               e.g. CUSOLVE, ISPTRSV, JACOBI, VBJACOBI, ISAI, CHEBYSHEV (AMG smoother).\n"
 " --ppattern k  Possibility to choose a pattern for the trisolver: ISAI(k) or Block Jacobi.\n"
 " --piters k    Number of preconditioner relaxation steps, e.g. for ISAI or (Block) Jacobi trisolver.\n"
 " --patol x     Set an absolute residual stopping criterion for the preconditioner.\n"
@@ -139,6 +149,7 @@ magma_zparse_opts(
     opts->precond_par.restart = 10;
     opts->precond_par.levels = 0;
     opts->precond_par.sweeps = 5;
+    opts->precond_par.freeze = 0;
     opts->precond_par.maxiter = 1;
     opts->precond_par.pattern = 1;
     opts->solver_par.solver = Magma_CGMERGE;
@@ -186,6 +197,9 @@ magma_zparse_opts(
             else if ( strcmp("UNITROWCOL", argv[i]) == 0 ) {
                 opts->scaling = Magma_UNITROWCOL;
             }
+            else if ( strcmp("RUIZ", argv[i]) == 0 ) {
+                opts->scaling = Magma_RUIZ;
+            }
             else {
                 printf( "%%error: invalid scaling, use default.\n" );
             }
@@ -263,6 +277,9 @@ magma_zparse_opts(
             else if ( strcmp("PARDISO", argv[i]) == 0 ) {
                 opts->solver_par.solver = Magma_PARDISO;
             }
+            else if ( strcmp("PIPECG", argv[i]) == 0 ) {
+                opts->solver_par.solver = Magma_PIPECG;
+            }
             else {
                 printf( "%%error: invalid solver.\n" );
             }
@@ -351,6 +368,18 @@ magma_zparse_opts(
             else if ( strcmp("ISAI", argv[i]) == 0 ) {
                 opts->precond_par.solver = Magma_ISAI;
             }
+            else if ( strcmp("AMG", argv[i]) == 0 ) {
+                opts->precond_par.solver = Magma_AMG;
+            }
+            else if ( strcmp("GS", argv[i]) == 0 ) {
+                opts->precond_par.solver = Magma_GS;
+            }
+            else if ( strcmp("SGS", argv[i]) == 0 ) {
+                opts->precond_par.solver = Magma_SGS;
+            }
+            else if ( strcmp("RAS", argv[i]) == 0 ) {
+                opts->precond_par.solver = Magma_RAS;
+            }
             else if ( strcmp("NONE", argv[i]) == 0 ) {
                 opts->precond_par.solver = Magma_NONE;
             }
@@ -401,6 +430,9 @@ magma_zparse_opts(
             else if ( strcmp("ISAI", argv[i]) == 0 ) {
                 opts->precond_par.trisolver = Magma_ISAI;
             }
+            else if ( strcmp("CHEBYSHEV", argv[i]) == 0 ) {
+                opts->precond_par.trisolver = Magma_CHEBYSHEV;
+            }
             else if ( strcmp("NONE", argv[i]) == 0 ) {
                 opts->precond_par.trisolver = Magma_NONE;
             }
@@ -423,6 +455,8 @@ magma_zparse_opts(
             opts->precond_par.sweeps = atoi( argv[++i] );
         } else if ( strcmp("--plevels", argv[i]) == 0 && i+1 < argc ) {
             opts->precond_par.levels = atoi( argv[++i] );
+        } else if ( strcmp("--pfreeze", argv[i]) == 0 && i+1 < argc ) {
+            opts->precond_par.freeze = atoi( argv[++i] );
         } else if ( strcmp("--blocksize", argv[i]) == 0 && i+1 < argc ) {
             opts->blocksize = atoi( argv[++i] );
         } else if ( strcmp("--alignment", argv[i]) == 0 && i+1 < argc ) {
@@ -45,6 +45,9 @@ extern "C"
 
 #define MAGMA_CSR5_OMEGA 32
 
+// coefficients of a STENCIL matrix: 3 x 3 x 3 neighbours, x fastest
+#define MAGMA_STENCIL_SIZE 27
+
     typedef struct magma_z_matrix
     {
         magma_storage_t storage_type;     // matrix format - CSR, ELL, SELL-P, CSR5
@@ -127,6 +130,9 @@ extern "C"
         magma_index_t csr5_tail_tile_start;  // opt: info for CSR5
         magma_order_t major;                 // opt: row/col major for dense matrices
         magma_int_t ld;                      // opt: leading dimension for dense
+        magma_int_t stencil_nx;              // opt: grid size for STENCIL
+        magma_int_t stencil_ny;              // opt: grid size for STENCIL
+        magma_int_t stencil_nz;              // opt: grid size for STENCIL
     } magma_z_matrix;
 
     typedef struct magma_c_matrix
@@ -211,6 +217,9 @@ extern "C"
         magma_index_t csr5_tail_tile_start;  // opt: info for CSR5
         magma_order_t major;                 // opt: row/col major for dense matrices
         magma_int_t ld;                      // opt: leading dimension for dense
+        magma_int_t stencil_nx;              // opt: grid size for STENCIL
+        magma_int_t stencil_ny;              // opt: grid size for STENCIL
+        magma_int_t stencil_nz;              // opt: grid size for STENCIL
     } magma_c_matrix;
 
     typedef struct magma_d_matrix
@@ -295,6 +304,9 @@ extern "C"
         magma_index_t csr5_tail_tile_start;  // opt: info for CSR5
         magma_order_t major;                 // opt: row/col major for dense matrices
         magma_int_t ld;                      // opt: leading dimension for dense
+        magma_int_t stencil_nx;              // opt: grid size for STENCIL
+        magma_int_t stencil_ny;              // opt: grid size for STENCIL
+        magma_int_t stencil_nz;              // opt: grid size for STENCIL
     } magma_d_matrix;
 
     typedef struct magma_s_matrix
@@ -379,6 +391,9 @@ extern "C"
         magma_index_t csr5_tail_tile_start;  // opt: info for CSR5
         magma_order_t major;                 // opt: row/col major for dense matrices
         magma_int_t ld;                      // opt: leading dimension for dense
+        magma_int_t stencil_nx;              // opt: grid size for STENCIL
+        magma_int_t stencil_ny;              // opt: grid size for STENCIL
+        magma_int_t stencil_nz;              // opt: grid size for STENCIL
     } magma_s_matrix;
 
     // for backwards compatability, make these aliases.
@@ -567,6 +582,34 @@ typedef struct magma_solve_info_t
 #define magma_ilu_info_t csrsm2Info_t
 #endif
 
+    typedef struct magma_z_ras_domain
+    {
+        magma_int_t n;              // rows of the subdomain, including the overlap
+        magma_int_t first;          // owned rows first ... last-1 of the global matrix
+        magma_int_t last;
+        magma_index_t *idx;         // global indices of the subdomain rows, sorted
+        magma_z_matrix LU;          // ILU(0) factors of the subdomain matrix, CSR
+        magma_index_t *diag;        // position of the diagonal in the rows of LU
+        magmaDoubleComplex *dense;  // small subdomains: dense LU factors
+        magma_int_t *ipiv;
+        magmaDoubleComplex *work;   // local vector
+    } magma_z_ras_domain;
+
+    typedef struct magma_z_amg_level
+    {
+        magma_z_matrix A;           // level matrix, CSR on the CPU
+        magma_z_matrix P;           // prolongation from the next coarser level
+        magma_z_matrix R;           // restriction to the next coarser level
+        magmaDoubleComplex *dinv;   // inverse of the diagonal of A
+        double lambda;              // estimate of the spectral radius of D^-1 A
+        magmaDoubleComplex *x;      // work vectors of the V-cycle
+        magmaDoubleComplex *b;
+        magmaDoubleComplex *r;
+        magmaDoubleComplex *d;
+        magmaDoubleComplex *LU;     // coarsest level: dense LU factors of A
+        magma_int_t *ipiv;
+    } magma_z_amg_level;
+
     typedef struct magma_z_preconditioner
     {
         magma_solver_type solver;
@@ -621,6 +664,23 @@ typedef struct magma_solve_info_t
         magma_solve_info_t cuinfoUT;
 
         magma_bool_t transpose; // need the transpose for the solver?
+        magma_int_t amg_levels;   // AMG: number of levels
+        magma_z_amg_level *amg;   // AMG: multigrid hierarchy on the CPU
+        magma_int_t colors;       // multicolor GS: number of colors
+        magma_index_t *color_ptr; // multicolor GS: first row of each color in M
+        magma_index_t *perm;      // multicolor GS: row i of M is row perm[i] of A
+        magmaDoubleComplex *dinv;   // multicolor GS: inverse diagonal of M, on the CPU
+        magmaDoubleComplex *hwork;  // multicolor GS, RAS: CPU work space
+        magma_int_t ras_domains;    // RAS: number of subdomains
+        magma_z_ras_domain *ras;   // RAS: subdomains with their factorizations
+        magma_z_matrix symL;        // ParILU(T) refresh: L, CSR with row index, on the CPU
+        magma_z_matrix symU;        // ParILU(T) refresh: U^T, CSR with row index, on the CPU
+        magma_index_t *symLA;       // ParILU(T) refresh: position of the entries of symL in A
+        magma_index_t *symUA;       // ParILU(T) refresh: position of the entries of symU in A
+        magma_index_t *symUT;       // ParILU(T) refresh: position of the entries of symU in U
+        magma_int_t symnnz;         // ParILU(T) refresh: nonzeros of A in the setup
+        magma_int_t freeze;         // ParILUT: pattern fixed after this many steps, 0: never
+        magma_solver_type requested; // type passed to the setup, which may rewrite solver
 #if defined(MAGMA_HAVE_PASTIX)
         pastix_data_t *pastix_data;
         magma_int_t *iparm;
@@ -628,6 +688,34 @@ typedef struct magma_solve_info_t
 #endif
     } magma_z_preconditioner;
 
+    typedef struct magma_c_ras_domain
+    {
+        magma_int_t n;              // rows of the subdomain, including the overlap
+        magma_int_t first;          // owned rows first ... last-1 of the global matrix
+        magma_int_t last;
+        magma_index_t *idx;         // global indices of the subdomain rows, sorted
+        magma_c_matrix LU;          // ILU(0) factors of the subdomain matrix, CSR
+        magma_index_t *diag;        // position of the diagonal in the rows of LU
+        magmaFloatComplex *dense;   // small subdomains: dense LU factors
+        magma_int_t *ipiv;
+        magmaFloatComplex *work;    // local vector
+    } magma_c_ras_domain;
+
+    typedef struct magma_c_amg_level
+    {
+        magma_c_matrix A;           // level matrix, CSR on the CPU
+        magma_c_matrix P;           // prolongation from the next coarser level
+        magma_c_matrix R;           // restriction to the next coarser level
+        magmaFloatComplex *dinv;    // inverse of the diagonal of A
+        float lambda;               // estimate of the spectral radius of D^-1 A
+        magmaFloatComplex *x;       // work vectors of the V-cycle
+        magmaFloatComplex *b;
+        magmaFloatComplex *r;
+        magmaFloatComplex *d;
+        magmaFloatComplex *LU;      // coarsest level: dense LU factors of A
+        magma_int_t *ipiv;
+    } magma_c_amg_level;
+
     typedef struct magma_c_preconditioner
     {
         magma_solver_type solver;
@@ -681,6 +769,23 @@ typedef struct magma_solve_info_t
         magma_solve_info_t cuinfoUT;
 
         magma_bool_t transpose; // need the transpose for the solver?
+        magma_int_t amg_levels;   // AMG: number of levels
+        magma_c_amg_level *amg;   // AMG: multigrid hierarchy on the CPU
+        magma_int_t colors;       // multicolor GS: number of colors
+        magma_index_t *color_ptr; // multicolor GS: first row of each color in M
+        magma_index_t *perm;      // multicolor GS: row i of M is row perm[i] of A
+        magmaFloatComplex *dinv;   // multicolor GS: inverse diagonal of M, on the CPU
+        magmaFloatComplex *hwork;  // multicolor GS, RAS: CPU work space
+        magma_int_t ras_domains;    // RAS: number of subdomains
+        magma_c_ras_domain *ras;   // RAS: subdomains with their factorizations
+        magma_c_matrix symL;        // ParILU(T) refresh: L, CSR with row index, on the CPU
+        magma_c_matrix symU;        // ParILU(T) refresh: U^T, CSR with row index, on the CPU
+        magma_index_t *symLA;       // ParILU(T) refresh: position of the entries of symL in A
+        magma_index_t *symUA;       // ParILU(T) refresh: position of the entries of symU in A
+        magma_index_t *symUT;       // ParILU(T) refresh: position of the entries of symU in U
+        magma_int_t symnnz;         // ParILU(T) refresh: nonzeros of A in the setup
+        magma_int_t freeze;         // ParILUT: pattern fixed after this many steps, 0: never
+        magma_solver_type requested; // type passed to the setup, which may rewrite solver
 #if defined(MAGMA_HAVE_PASTIX)
         pastix_data_t *pastix_data;
         magma_int_t *iparm;
@@ -688,6 +793,34 @@ typedef struct magma_solve_info_t
 #endif
     } magma_c_preconditioner;
 
+    typedef struct magma_d_ras_domain
+    {
+        magma_int_t n;              // rows of the subdomain, including the overlap
+        magma_int_t first;          // owned rows first ... last-1 of the global matrix
+        magma_int_t last;
+        magma_index_t *idx;         // global indices of the subdomain rows, sorted
+        magma_d_matrix LU;          // ILU(0) factors of the subdomain matrix, CSR
+        magma_index_t *diag;        // position of the diagonal in the rows of LU
+        double *dense;              // small subdomains: dense LU factors
+        magma_int_t *ipiv;
+        double *work;               // local vector
+    } magma_d_ras_domain;
+
+    typedef struct magma_d_amg_level
+    {
+        magma_d_matrix A;           // level matrix, CSR on the CPU
+        magma_d_matrix P;           // prolongation from the next coarser level
+        magma_d_matrix R;           // restriction to the next coarser level
+        double *dinv;               // inverse of the diagonal of A
+        double lambda;              // estimate of the spectral radius of D^-1 A
+        double *x;                  // work vectors of the V-cycle
+        double *b;
+        double *r;
+        double *d;
+        double *LU;                 // coarsest level: dense LU factors of A
+        magma_int_t *ipiv;
+    } magma_d_amg_level;
+
     typedef struct magma_d_preconditioner
     {
         magma_solver_type solver;
@@ -741,6 +874,23 @@ typedef struct magma_solve_info_t
         magma_solve_info_t cuinfoUT;
 
         magma_bool_t transpose; // need the transpose for the solver?
+        magma_int_t amg_levels;   // AMG: number of levels
+        magma_d_amg_level *amg;   // AMG: multigrid hierarchy on the CPU
+        magma_int_t colors;       // multicolor GS: number of colors
+        magma_index_t *color_ptr; // multicolor GS: first row of each color in M
+        magma_index_t *perm;      // multicolor GS: row i of M is row perm[i] of A
+        double *dinv;   // multicolor GS: inverse diagonal of M, on the CPU
+        double *hwork;  // multicolor GS, RAS: CPU work space
+        magma_int_t ras_domains;    // RAS: number of subdomains
+        magma_d_ras_domain *ras;   // RAS: subdomains with their factorizations
+        magma_d_matrix symL;        // ParILU(T) refresh: L, CSR with row index, on the CPU
+        magma_d_matrix symU;        // ParILU(T) refresh: U^T, CSR with row index, on the CPU
+        magma_index_t *symLA;       // ParILU(T) refresh: position of the entries of symL in A
+        magma_index_t *symUA;       // ParILU(T) refresh: position of the entries of symU in A
+        magma_index_t *symUT;       // ParILU(T) refresh: position of the entries of symU in U
+        magma_int_t symnnz;         // ParILU(T) refresh: nonzeros of A in the setup
+        magma_int_t freeze;         // ParILUT: pattern fixed after this many steps, 0: never
+        magma_solver_type requested; // type passed to the setup, which may rewrite solver
 #if defined(MAGMA_HAVE_PASTIX)
         pastix_data_t *pastix_data;
         magma_int_t *iparm;
@@ -748,6 +898,34 @@ typedef struct magma_solve_info_t
 #endif
     } magma_d_preconditioner;
 
+    typedef struct magma_s_ras_domain
+    {
+        magma_int_t n;              // rows of the subdomain, including the overlap
+        magma_int_t first;          // owned rows first ... last-1 of the global matrix
+        magma_int_t last;
+        magma_index_t *idx;         // global indices of the subdomain rows, sorted
+        magma_s_matrix LU;          // ILU(0) factors of the subdomain matrix, CSR
+        magma_index_t *diag;        // position of the diagonal in the rows of LU
+        float *dense;               // small subdomains: dense LU factors
+        magma_int_t *ipiv;
+        float *work;                // local vector
+    } magma_s_ras_domain;
+
+    typedef struct magma_s_amg_level
+    {
+        magma_s_matrix A;           // level matrix, CSR on the CPU
+        magma_s_matrix P;           // prolongation from the next coarser level
+        magma_s_matrix R;           // restriction to the next coarser level
+        float *dinv;                // inverse of the diagonal of A
+        float lambda;               // estimate of the spectral radius of D^-1 A
+        float *x;                   // work vectors of the V-cycle
+        float *b;
+        float *r;
+        float *d;
+        float *LU;                  // coarsest level: dense LU factors of A
+        magma_int_t *ipiv;
+    } magma_s_amg_level;
+
     typedef struct magma_s_preconditioner
     {
         magma_solver_type solver;
@@ -801,6 +979,23 @@ typedef struct magma_solve_info_t
         magma_solve_info_t cuinfoUT;
 
         magma_bool_t transpose; // need the transpose for the solver?
+        magma_int_t amg_levels;   // AMG: number of levels
+        magma_s_amg_level *amg;   // AMG: multigrid hierarchy on the CPU
+        magma_int_t colors;       // multicolor GS: number of colors
+        magma_index_t *color_ptr; // multicolor GS: first row of each color in M
+        magma_index_t *perm;      // multicolor GS: row i of M is row perm[i] of A
+        float *dinv;   // multicolor GS: inverse diagonal of M, on the CPU
+        float *hwork;  // multicolor GS, RAS: CPU work space
+        magma_int_t ras_domains;    // RAS: number of subdomains
+        magma_s_ras_domain *ras;   // RAS: subdomains with their factorizations
+        magma_s_matrix symL;        // ParILU(T) refresh: L, CSR with row index, on the CPU
+        magma_s_matrix symU;        // ParILU(T) refresh: U^T, CSR with row index, on the CPU
+        magma_index_t *symLA;       // ParILU(T) refresh: position of the entries of symL in A
+        magma_index_t *symUA;       // ParILU(T) refresh: position of the entries of symU in A
+        magma_index_t *symUT;       // ParILU(T) refresh: position of the entries of symU in U
+        magma_int_t symnnz;         // ParILU(T) refresh: nonzeros of A in the setup
+        magma_int_t freeze;         // ParILUT: pattern fixed after this many steps, 0: never
+        magma_solver_type requested; // type passed to the setup, which may rewrite solver
 #if defined(MAGMA_HAVE_PASTIX)
         pastix_data_t *pastix_data;
         magma_int_t *iparm;
@@ -808,6 +1003,42 @@ typedef struct magma_solve_info_t
 #endif
     } magma_s_preconditioner;
 
+    //##############################################################################
+    //
+    //              SpMV format selection
+    //
+    //##############################################################################
+
+    #define MAGMA_SPMV_HIST      16  // row length histogram: empty rows, 1, 2-3, 4-7, ...
+    #define MAGMA_SPMV_SLICES     6  // SELL-P slice sizes 8, 16, ..., 256
+    #define MAGMA_SPMV_ALIGNS     5  // SELL-P alignments 1, 4, 8, 16, 32
+    #define MAGMA_SPMV_BLOCKS     3  // BCSR block sizes 2, 4, 8
+    #define MAGMA_SPMV_FORMATS    5  // CSR, CSR5, ELL, SELLP, BCSR
+
+    typedef struct magma_spmv_features
+    {
+        magma_int_t num_rows;
+        magma_int_t num_cols;
+        magma_int_t nnz;
+        double row_mean;            // mean nonzeros per row
+        double row_var;             // variance of the nonzeros per row
+        magma_int_t row_max;        // longest row
+        magma_int_t row_hist[MAGMA_SPMV_HIST];
+        magma_int_t bandwidth;      // largest |i-j| of a nonzero
+        double band_mean;           // mean |i-j| of the nonzeros
+        magma_int_t diagonals;      // occupied diagonals
+        double diag_fill;           // nnz / ( diagonals * num_rows )
+        double sellp[MAGMA_SPMV_SLICES][MAGMA_SPMV_ALIGNS];  // stored entries in SELL-P
+        double bcsr[MAGMA_SPMV_BLOCKS];     // stored entries in BCSR
+    } magma_spmv_features;
+
+    typedef struct magma_spmv_model
+    {
+        // per format: seconds per stored entry, per row, and per entry of
+        // the longest row as processed by one thread
+        double coef[MAGMA_SPMV_FORMATS][3];
+    } magma_spmv_model;
+
     //##############################################################################
     //
     //              opts for the testers
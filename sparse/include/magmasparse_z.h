@@ -279,6 +279,16 @@ magma_zmscale_apply(
       magma_z_matrix* A,
     magma_queue_t queue );
 
+magma_int_t
+magma_zmscale_ruiz(
+    magma_z_matrix *A,
+    magma_int_t maxiter,
+    double tol,
+    magma_z_matrix *dr,
+    magma_z_matrix *dc,
+    magma_int_t *iter,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zdimv(
   magma_z_matrix* vecA,
@@ -612,6 +622,46 @@ magma_zrowentries(
     magma_z_matrix *A,
     magma_queue_t queue );
 
+magma_int_t
+magma_zmfeatures(
+    magma_z_matrix A,
+    magma_spmv_features *features,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmformat_select(
+    magma_spmv_features *features,
+    magma_spmv_model *model,
+    magma_storage_t *format,
+    magma_int_t *blocksize,
+    magma_int_t *alignment,
+    real_Double_t *time,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmconvert_auto(
+    magma_z_matrix A,
+    magma_z_matrix *B,
+    magma_spmv_model *model,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmformat_model_read(
+    const char *filename,
+    magma_spmv_model *model,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmformat_model_write(
+    const char *filename,
+    magma_spmv_model *model,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmformat_calibrate(
+    magma_spmv_model *model,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zmfree(
     magma_z_matrix *A,
@@ -665,6 +715,15 @@ magma_zm_5stencil(
     magma_z_matrix *A,
     magma_queue_t queue );
 
+magma_int_t
+magma_zm_stencil(
+    magma_int_t nx,
+    magma_int_t ny,
+    magma_int_t nz,
+    magmaDoubleComplex *coef,
+    magma_z_matrix *A,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zsolverinfo(
     magma_z_solver_par *solver_par,
@@ -701,6 +760,26 @@ magma_zKrylov_check( magma_solver_type solver );
  -- MAGMA_SPARSE parallel incomplete factorizations (ParILU / ParILUT)
 */
 
+// numeric refactorization reusing the symbolic data of the setup
+magma_int_t
+magma_zparilu_refresh_setup(
+    magma_z_matrix A,
+    magma_z_matrix L,
+    magma_z_matrix U,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zparilu_refresh(
+    magma_z_matrix A,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zparilu_refresh_free(
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
 /// @deprecated
 /// @ingroup magma_deprecated_sparse
 MAGMA_DEPRECATE("magma_zparilusetup is deprecated and will be removed in the next release")
@@ -1278,6 +1357,25 @@ magma_zparict_sweep_sync(
     magma_z_matrix *L,
     magma_queue_t queue );
 
+magma_int_t
+magma_zparict_map(
+    magma_z_matrix A,
+    magma_z_matrix L,
+    magma_index_t **map,
+    magma_int_t *map_size,
+    magma_index_t **marker,
+    magma_int_t *marker_size,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zparict_sweep_map(
+    magma_z_matrix A,
+    magma_z_matrix *L,
+    magma_index_t *map,
+    magmaDoubleComplex **buffer,
+    magma_int_t *buffer_size,
+    magma_queue_t queue );
+
 /// @deprecated
 /// @ingroup magma_deprecated_sparse
 MAGMA_DEPRECATE("magma_zparilut_sweep_sync is deprecated and will be removed in the next release")
@@ -1953,6 +2051,14 @@ magma_zcsr_sort(
     magma_z_matrix *A,
     magma_queue_t queue);
 
+magma_int_t
+magma_zcsr_segsort(
+    magma_int_t num_rows,
+    const magma_index_t *row,
+    magma_index_t *col,
+    magmaDoubleComplex *val,
+    magma_queue_t queue);
+
 magma_int_t
 magma_zcsr_sort_gpu(
     magma_z_matrix *A,
@@ -1995,6 +2101,52 @@ magma_zmvarsizeblockstruct(
  -- MAGMA_SPARSE function definitions / Data on CPU / Multi-GPU
 */
 
+/* ////////////////////////////////////////////////////////////////////////////
+ -- MAGMA_SPARSE iterative solvers (Data on CPU)
+*/
+
+magma_int_t
+magma_zcg_cpu(
+    magma_z_matrix A, magma_z_matrix b,
+    magma_z_matrix *x, magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zpipecg_cpu(
+    magma_z_matrix A, magma_z_matrix b,
+    magma_z_matrix *x, magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zbicgstab_cpu(
+    magma_z_matrix A, magma_z_matrix b,
+    magma_z_matrix *x, magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zgmres_cpu(
+    magma_z_matrix A, magma_z_matrix b,
+    magma_z_matrix *x, magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zidr_cpu(
+    magma_z_matrix A, magma_z_matrix b,
+    magma_z_matrix *x, magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zbaiter_cpu(
+    magma_z_matrix A, magma_z_matrix b,
+    magma_z_matrix *x, magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue );
+
 /* ////////////////////////////////////////////////////////////////////////////
  -- MAGMA_SPARSE iterative solvers (Data on GPU)
 */
@@ -2447,6 +2599,57 @@ magma_zapplycustomprecond_r(
     magma_queue_t queue );
 
 
+// algebraic multigrid preconditioner, hierarchy on the CPU
+
+magma_int_t
+magma_zamgsetup(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zapplyamg(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+
+// multicolor Gauss-Seidel preconditioner on the CPU
+
+magma_int_t
+magma_zmcgssetup(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zapplymcgs(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+
+// restricted additive Schwarz preconditioner on the CPU
+
+magma_int_t
+magma_zrassetup(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zapplyras(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+
 // CUSPARSE preconditioner
 
 magma_int_t
@@ -2695,12 +2898,27 @@ magma_z_precondsetup(
     magma_z_preconditioner *precond,
     magma_queue_t queue );
 
+magma_int_t
+magma_z_precondrefresh(
+    magma_z_matrix A, magma_z_matrix b,
+    magma_z_solver_par *solver,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
 magma_int_t
 magma_z_applyprecond(
     magma_z_matrix A, magma_z_matrix b,
     magma_z_matrix *x, magma_z_preconditioner *precond,
     magma_queue_t queue );
 
+magma_int_t
+magma_z_applyprecond_cpu(
+    magma_z_matrix A,
+    magmaDoubleComplex *b,
+    magmaDoubleComplex *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
 
 magma_int_t
 magma_z_applyprecond_left(
@@ -3497,6 +3715,162 @@ magma_ztfqmr_5(
     magmaDoubleComplex_ptr Ad,
     magma_queue_t queue );
 
+magma_int_t
+magma_zfill_cpu(
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex *x,
+    magma_queue_t queue );
+
+double
+magma_dznrm2_cpu(
+    magma_int_t n,
+    magmaDoubleComplex *x,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zspmm_cpu(
+    magmaDoubleComplex alpha,
+    magma_z_matrix A,
+    magma_z_matrix x,
+    magmaDoubleComplex beta,
+    magma_z_matrix y,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zgestencilmv_cpu(
+    magmaDoubleComplex alpha,
+    magma_z_matrix A,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex *y,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zspmv_dot_cpu(
+    magma_z_matrix A,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex *y,
+    magmaDoubleComplex *w,
+    magmaDoubleComplex *dot1,
+    double *dot2,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zresidual_cpu(
+    magma_z_matrix A,
+    magmaDoubleComplex *b,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex *r,
+    double *res,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zcgmerge_xr_cpu(
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *d,
+    magmaDoubleComplex *z,
+    double *rr,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zcgmerge_d_cpu(
+    magma_int_t n,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *d,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zpipecg_spmv_cpu(
+    magma_z_matrix A,
+    magmaDoubleComplex *m,
+    magmaDoubleComplex *q,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *u,
+    magmaDoubleComplex *w,
+    double *gamma,
+    magmaDoubleComplex *delta,
+    double *rr,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zpipecg_update_cpu(
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *w,
+    magmaDoubleComplex *p,
+    magmaDoubleComplex *s,
+    magmaDoubleComplex *z,
+    magmaDoubleComplex *q,
+    magmaDoubleComplex *u,
+    magmaDoubleComplex *m,
+    magmaDoubleComplex *c,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zbicgmerge_p_cpu(
+    magma_int_t n,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex omega,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *v,
+    magmaDoubleComplex *p,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zbicgmerge_s_cpu(
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *v,
+    magmaDoubleComplex *s,
+    double *ss,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zbicgmerge_xr_cpu(
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex omega,
+    magmaDoubleComplex *p,
+    magmaDoubleComplex *s,
+    magmaDoubleComplex *sh,
+    magmaDoubleComplex *t,
+    magmaDoubleComplex *rr,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex *r,
+    magmaDoubleComplex *rho,
+    double *nrm,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmdotc_cpu(
+    magma_int_t n,
+    magma_int_t k,
+    magmaDoubleComplex *V,
+    magma_int_t ldv,
+    magmaDoubleComplex *w,
+    magmaDoubleComplex *h,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmaxpy_cpu(
+    magma_int_t n,
+    magma_int_t k,
+    magmaDoubleComplex *V,
+    magma_int_t ldv,
+    magmaDoubleComplex *h,
+    magmaDoubleComplex *w,
+    double *nrm,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zcgmerge_spmv1(
     magma_z_matrix A,
@@ -3787,6 +4161,18 @@ magma_zge3pt(
     magmaDoubleComplex_ptr dy,
     magma_queue_t queue );
 
+magma_int_t
+magma_zgestencilmv(
+    magma_int_t nx,
+    magma_int_t ny,
+    magma_int_t nz,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_ptr dcoef,
+    magmaDoubleComplex_ptr dx,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr dy,
+    magma_queue_t queue );
+
 //#############  Big data analytics
 magma_int_t
 magma_zjaccard_weights(
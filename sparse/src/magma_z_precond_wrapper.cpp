@@ -96,6 +96,28 @@ cleanup:
 
 
 
+// ISAI for both factors of an incomplete factorization. Magma_CUSOLVE
+// from either factor (pattern too large) switches to the exact triangular
+// solves; other errors are returned.
+static magma_int_t
+zprecond_isai_setup(
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    CHECK( magma_ziluisaisetup_lower( precond->L, precond->L, &precond->LD, queue ));
+    CHECK( magma_ziluisaisetup_upper( precond->U, precond->U, &precond->UD, queue ));
+
+cleanup:
+    if ( info == Magma_CUSOLVE ) {
+        precond->trisolver = Magma_CUSOLVE;
+        info = 0;
+    }
+    return info;
+}
+
+
 /**
     Purpose
     -------
@@ -147,6 +169,9 @@ magma_z_precondsetup(
     
     tempo1 = magma_sync_wtime( queue );
     
+    // ParILUT, ParICT and the custom factorizations rewrite precond->solver
+    precond->requested = precond->solver;
+    
     if( A.num_rows != A.num_cols ){
         printf("%% warning: non-square matrix.\n");
         printf("%% Fallback: no preconditioner.\n");
@@ -156,6 +181,16 @@ magma_z_precondsetup(
     if ( precond->solver == Magma_JACOBI ) {
         info = magma_zjacobisetup_diagscal( A, &(precond->d), queue );
     }
+    else if ( precond->solver == Magma_AMG ) {
+        info = magma_zamgsetup( A, b, precond, queue );
+    }
+    else if ( precond->solver == Magma_GS ||
+              precond->solver == Magma_SGS ) {
+        info = magma_zmcgssetup( A, b, precond, queue );
+    }
+    else if ( precond->solver == Magma_RAS ) {
+        info = magma_zrassetup( A, b, precond, queue );
+    }
     else if ( precond->solver == Magma_PASTIX ) {
         //info = magma_zpastixsetup( A, b, precond, queue );
         info = MAGMA_ERR_NOT_SUPPORTED;
@@ -165,28 +200,18 @@ magma_z_precondsetup(
         if ( precond->trisolver == Magma_ISAI ||
             precond->trisolver == Magma_JACOBI ||
             precond->trisolver == Magma_VBJACOBI ){
-            info = magma_zcumilusetup( A, precond, queue );
-            info = magma_ziluisaisetup_lower( precond->L, precond->L, &precond->LD, queue );
-            info = magma_ziluisaisetup_upper( precond->U, precond->U, &precond->UD, queue );
-            if (info == Magma_CUSOLVE) {
-                precond->trisolver = Magma_CUSOLVE;
-                info = 0;
-            }
+            CHECK( magma_zcumilusetup( A, precond, queue ));
+            CHECK( zprecond_isai_setup( precond, queue ));
         } else {
             info = magma_zcumilusetup( A, precond, queue );
         }
     }
     else if ( precond->solver == Magma_PARILU ) {
-        info = magma_zparilu_gpu( A, b, precond, queue );
+        CHECK( magma_zparilu_gpu( A, b, precond, queue ));
         if ( precond->trisolver == Magma_ISAI ||
              precond->trisolver == Magma_JACOBI ||
              precond->trisolver == Magma_VBJACOBI ){
-             info = magma_ziluisaisetup_lower( precond->L, precond->L, &precond->LD, queue );
-             info = magma_ziluisaisetup_upper( precond->U, precond->U, &precond->UD, queue );
-             if (info == Magma_CUSOLVE) {
-                precond->trisolver = Magma_CUSOLVE;
-                info = 0;
-             }
+            CHECK( zprecond_isai_setup( precond, queue ));
         }
     }
     else if ( precond->solver == Magma_ILUT ) {
@@ -199,20 +224,15 @@ magma_z_precondsetup(
         #ifdef _OPENMP
         /* Here, use No-Dynamic-Parallelism vresion or normal version depending on platform */
             #ifdef MAGMA_HAVE_HIP
-            info = magma_zparilut_gpu_nodp(A, b, precond, queue);
+            CHECK( magma_zparilut_gpu_nodp(A, b, precond, queue) );
             #else
-            info = magma_zparilut_gpu( A, b, precond, queue );
+            CHECK( magma_zparilut_gpu( A, b, precond, queue ) );
             #endif
             if ( precond->trisolver == Magma_ISAI  ||
                 precond->trisolver == Magma_JACOBI ||
                 precond->trisolver == Magma_VBJACOBI ){
-                info = magma_ziluisaisetup_lower( precond->L, precond->L, &precond->LD, queue );
-                info = magma_ziluisaisetup_upper( precond->U, precond->U, &precond->UD, queue );
-                if (info == Magma_CUSOLVE) {
-                    precond->trisolver = Magma_CUSOLVE;
-                    info = 0;
-                }
-             }
+                CHECK( zprecond_isai_setup( precond, queue ));
+            }
             precond->solver = Magma_PARILU; // handle as PARILU
         #else
             printf( "error: preconditioner requires OpenMP.\n" );
@@ -228,9 +248,8 @@ magma_z_precondsetup(
         if ( precond->trisolver == Magma_ISAI  ||
              precond->trisolver == Magma_JACOBI ||
              precond->trisolver == Magma_VBJACOBI ){
-            info = magma_zcumiccsetup( A, precond, queue );
-            info = magma_ziluisaisetup_lower( precond->L, precond->L, &precond->LD, queue );
-            info = magma_ziluisaisetup_upper( precond->U, precond->U, &precond->UD, queue );
+            CHECK( magma_zcumiccsetup( A, precond, queue ));
+            CHECK( zprecond_isai_setup( precond, queue ));
         } else {
             info = magma_zcumiccsetup( A, precond, queue );
         }
@@ -281,6 +300,7 @@ magma_z_precondsetup(
         }
     }
     
+cleanup:
     tempo2 = magma_sync_wtime( queue );
     precond->setuptime = tempo2-tempo1;
     
@@ -289,6 +309,94 @@ magma_z_precondsetup(
 
 
 
+/**
+    Purpose
+    -------
+
+    Updates the preconditioner for a matrix A with new values but the
+    sparsity pattern of the matrix passed to magma_z_precondsetup, as in
+    time-stepping or Newton iterations.
+    For ParILU and ParILUT, the symbolic data of the setup is reused, and
+    only precond->sweeps numeric sweeps are run, starting from the previous
+    factors. Other preconditioners, or solvers that need the transposed
+    factors, fall back to a full setup of the type originally passed to
+    magma_z_precondsetup, e.g., ParICT rather than the ICC it is applied as.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                sparse matrix with the pattern used in the setup
+
+    @param[in]
+    b           magma_z_matrix
+                input vector y
+    
+    @param[in]
+    solver      magma_z_solver_par
+                solver structure using the preconditioner
+                
+    @param[in,out]
+    precond     magma_z_preconditioner
+                preconditioner
+                
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_z_precondrefresh(
+    magma_z_matrix A, magma_z_matrix b,
+    magma_z_solver_par *solver,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_solver_type type = precond->requested;
+    
+    //Chronometry
+    real_Double_t tempo1, tempo2;
+    
+    tempo1 = magma_sync_wtime( queue );
+    
+    if ( precond->solver == Magma_PARILU &&
+         solver->solver != Magma_PQMR &&
+         solver->solver != Magma_PQMRMERGE &&
+         solver->solver != Magma_PBICG &&
+         solver->solver != Magma_LSQR ) {
+        info = magma_zparilu_refresh( A, precond, queue );
+        if ( info == 0 &&
+            ( precond->trisolver == Magma_ISAI ||
+              precond->trisolver == Magma_JACOBI ||
+              precond->trisolver == Magma_VBJACOBI ) ){
+            magma_zmfree( &precond->LD, queue );
+            magma_zmfree( &precond->UD, queue );
+            CHECK( zprecond_isai_setup( precond, queue ));
+        }
+    } else {
+        info = MAGMA_ERR_NOT_SUPPORTED;
+    }
+    
+    if ( info == MAGMA_ERR_NOT_SUPPORTED ) {
+        // nothing to reuse: full setup
+        magma_zprecondfree( precond, queue );
+        precond->solver = type;
+        info = magma_z_precondsetup( A, b, solver, precond, queue );
+    } else {
+        tempo2 = magma_sync_wtime( queue );
+        precond->setuptime = tempo2-tempo1;
+    }
+    
+cleanup:
+    return info;
+}
+
+
+
 /**
     Purpose
     -------
@@ -339,6 +447,16 @@ magma_z_applyprecond(
     if ( precond->solver == Magma_JACOBI ) {
         CHECK( magma_zjacobi_diagscal( b.num_rows, precond->d, b, x, queue ));
     }
+    else if ( precond->solver == Magma_AMG ) {
+        CHECK( magma_zapplyamg( b, x, precond, queue ));
+    }
+    else if ( precond->solver == Magma_GS ||
+              precond->solver == Magma_SGS ) {
+        CHECK( magma_zapplymcgs( b, x, precond, queue ));
+    }
+    else if ( precond->solver == Magma_RAS ) {
+        CHECK( magma_zapplyras( b, x, precond, queue ));
+    }
     else if ( precond->solver == Magma_PASTIX ) {
         //CHECK( magma_zapplypastix( b, x, precond, queue ));
         info = MAGMA_ERR_NOT_SUPPORTED;
@@ -363,6 +481,91 @@ cleanup:
 }
 
 
+/**
+    Purpose
+    -------
+
+    Applies the preconditioner x = M^{-1} b for the CPU solvers, on vectors
+    of length A.num_rows in the CPU memory. Only the host preconditioners
+    AMG, GS, SGS and RAS are supported. If precond is NULL or of type
+    Magma_NONE, x = b. The time spent is added to precond->runtime.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                sparse matrix A, on the CPU
+
+    @param[in]
+    b           magmaDoubleComplex*
+                input vector b, on the CPU
+
+    @param[out]
+    x           magmaDoubleComplex*
+                output vector x, on the CPU; must not alias b
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner, or NULL
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_z_applyprecond_cpu(
+    magma_z_matrix A,
+    magmaDoubleComplex *b,
+    magmaDoubleComplex *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t n = A.num_rows;
+
+    magma_z_matrix hb={Magma_DENSE}, hx={Magma_DENSE};
+
+    //Chronometry
+    real_Double_t tempo1, tempo2;
+
+    if ( precond == NULL || precond->solver == Magma_NONE || precond->solver == 0 ) {
+        #pragma omp parallel for schedule(static)
+        for( magma_int_t i=0; i<n; i++ ){
+            x[i] = b[i];
+        }
+        return info;
+    }
+    if ( precond->solver != Magma_AMG && precond->solver != Magma_GS &&
+         precond->solver != Magma_SGS && precond->solver != Magma_RAS ) {
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
+
+    tempo1 = magma_wtime();
+
+    // wrap the CPU vectors, they are not owned by hb and hx
+    hb.memory_location = Magma_CPU;
+    hb.num_rows = n;
+    hb.num_cols = 1;
+    hb.nnz = n;
+    hb.ld = n;
+    hb.major = MagmaColMajor;
+    hx = hb;
+    hb.val = b;
+    hx.val = x;
+
+    info = magma_z_applyprecond( A, hb, &hx, precond, queue );
+
+    tempo2 = magma_wtime();
+    precond->runtime += tempo2-tempo1;
+
+    return info;
+}
+
+
 /**
     Purpose
     -------
@@ -431,6 +634,16 @@ magma_z_applyprecond_left(
         if ( precond->solver == Magma_JACOBI ) {
             CHECK( magma_zjacobi_diagscal( b.num_rows, precond->d, b, x, queue ));
         }
+        else if ( precond->solver == Magma_AMG ) {
+            CHECK( magma_zapplyamg( b, x, precond, queue ));
+        }
+        else if ( precond->solver == Magma_GS ||
+                  precond->solver == Magma_SGS ) {
+            CHECK( magma_zapplymcgs( b, x, precond, queue ));
+        }
+        else if ( precond->solver == Magma_RAS ) {
+            CHECK( magma_zapplyras( b, x, precond, queue ));
+        }
         else if ( ( precond->solver == Magma_ILU ||
                     precond->solver == Magma_PARILU ) && 
                   ( precond->trisolver == Magma_CUSOLVE ||
@@ -487,6 +700,16 @@ magma_z_applyprecond_left(
         if ( precond->solver == Magma_JACOBI ) {
             CHECK( magma_zjacobi_diagscal( b.num_rows, precond->d, b, x, queue ));
         }
+        else if ( precond->solver == Magma_AMG ) {
+            CHECK( magma_zapplyamg( b, x, precond, queue ));
+        }
+        else if ( precond->solver == Magma_GS ||
+                  precond->solver == Magma_SGS ) {
+            CHECK( magma_zapplymcgs( b, x, precond, queue ));
+        }
+        else if ( precond->solver == Magma_RAS ) {
+            CHECK( magma_zapplyras( b, x, precond, queue ));
+        }
         else if ( ( precond->solver == Magma_ILU ||
                     precond->solver == Magma_PARILU ) && 
                   ( precond->trisolver == Magma_CUSOLVE ||
@@ -598,7 +821,11 @@ magma_z_applyprecond_right(
     zopts.solver_par.rtol = 1e-10;
     
     if( trans == MagmaNoTrans ) {
-        if ( precond->solver == Magma_JACOBI ) {
+        if ( precond->solver == Magma_JACOBI ||
+             precond->solver == Magma_AMG ||
+             precond->solver == Magma_GS ||
+             precond->solver == Magma_SGS ||
+             precond->solver == Magma_RAS ) {
             magma_zcopy( b.num_rows*b.num_cols, b.dval, 1, x->dval, 1, queue );    // x = b
         }
         else if ( ( precond->solver == Magma_ILU ||
@@ -658,7 +885,11 @@ magma_z_applyprecond_right(
             info = MAGMA_ERR_NOT_SUPPORTED;
         }
     } else if ( trans == MagmaTrans ){
-        if ( precond->solver == Magma_JACOBI ) {
+        if ( precond->solver == Magma_JACOBI ||
+             precond->solver == Magma_AMG ||
+             precond->solver == Magma_GS ||
+             precond->solver == Magma_SGS ||
+             precond->solver == Magma_RAS ) {
             magma_zcopy( b.num_rows*b.num_cols, b.dval, 1, x->dval, 1, queue );    // x = b
         }
         else if ( ( precond->solver == Magma_ILU ||
@@ -30,6 +30,15 @@
     Please see magmasparse_types.h for details about the fields and
     magma_zutil_sparse.cpp for the possible options.
 
+    If A, b and x are located in the CPU memory, the system is solved on the
+    host with the OpenMP solvers: CG, pipelined CG, BiCGSTAB, GMRES and IDR.
+    CSR and STENCIL matrices are used as they are; other formats, and STENCIL
+    for the block-asynchronous iteration, are converted to CSR. Like on the
+    device, the preconditioned variants (PCG, PBICGSTAB, PIDR), GMRES and
+    pipelined CG apply the preconditioner in zopts->precond_par, which has
+    to be one of the host preconditioners AMG, GS, SGS or RAS, set up with
+    magma_z_precondsetup.
+
     Arguments
     ---------
 
@@ -63,12 +72,72 @@ magma_z_solver(
 {
     magma_int_t info = 0;
     
+    magma_z_matrix hA={Magma_CSR};
+    
     // make sure RHS is a dense matrix
     if ( b.storage_type != Magma_DENSE ) {
         printf( "error: sparse RHS not yet supported.\n" );
         return MAGMA_ERR_NOT_SUPPORTED;
     }
-    if( b.num_cols == 1 ){
+    if ( A.memory_location == Magma_CPU ) {
+        // host solvers, with host preconditioners only
+        if ( b.memory_location != Magma_CPU || x->memory_location != Magma_CPU
+                || b.num_cols != 1 ) {
+            printf( "error: A, b and x have to be CPU vectors for the CPU solvers.\n" );
+            info = MAGMA_ERR_NOT_SUPPORTED;
+            goto cleanup;
+        }
+        if ( zopts->precond_par.solver != Magma_NONE
+                && zopts->precond_par.solver != 0
+                && zopts->precond_par.solver != Magma_AMG
+                && zopts->precond_par.solver != Magma_GS
+                && zopts->precond_par.solver != Magma_SGS
+                && zopts->precond_par.solver != Magma_RAS ) {
+            printf( "error: preconditioner not supported on the CPU.\n" );
+            info = MAGMA_ERR_NOT_SUPPORTED;
+            goto cleanup;
+        }
+        // the Krylov solvers run matrix-free on STENCIL, the
+        // block-asynchronous iteration splits the matrix entries
+        if ( A.storage_type == Magma_CSR ||
+             ( A.storage_type == Magma_STENCIL
+               && zopts->solver_par.solver != Magma_BAITER ) ) {
+            hA = A;
+        } else {
+            CHECK( magma_zmconvert( A, &hA, A.storage_type, Magma_CSR, queue ));
+        }
+        switch( zopts->solver_par.solver ) {
+            case  Magma_CG:
+            case  Magma_CGMERGE:
+                    CHECK( magma_zcg_cpu( hA, b, x, &zopts->solver_par, NULL, queue )); break;
+            case  Magma_PCG:
+            case  Magma_PCGMERGE:
+                    CHECK( magma_zcg_cpu( hA, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
+            case  Magma_PIPECG:
+                    CHECK( magma_zpipecg_cpu( hA, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
+            case  Magma_BICGSTAB:
+            case  Magma_BICGSTABMERGE:
+                    CHECK( magma_zbicgstab_cpu( hA, b, x, &zopts->solver_par, NULL, queue )); break;
+            case  Magma_PBICGSTAB:
+            case  Magma_PBICGSTABMERGE:
+                    CHECK( magma_zbicgstab_cpu( hA, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
+            case  Magma_GMRES:
+            case  Magma_PGMRES:
+                    CHECK( magma_zgmres_cpu( hA, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
+            case  Magma_IDR:
+            case  Magma_IDRMERGE:
+                    CHECK( magma_zidr_cpu( hA, b, x, &zopts->solver_par, NULL, queue )); break;
+            case  Magma_PIDR:
+            case  Magma_PIDRMERGE:
+                    CHECK( magma_zidr_cpu( hA, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
+            case  Magma_BAITER:
+                    CHECK( magma_zbaiter_cpu( hA, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
+            default:
+                    printf("error: solver class not supported on the CPU.\n");
+                    info = MAGMA_ERR_NOT_SUPPORTED; break;
+        }
+    }
+    else if( b.num_cols == 1 ){
         switch( zopts->solver_par.solver ) {
             case  Magma_BICG:
                     CHECK( magma_zbicg( A, b, x, &zopts->solver_par, queue )); break;
@@ -159,5 +228,8 @@ magma_z_solver(
         }
     }
 cleanup:
+    if ( A.memory_location == Magma_CPU && hA.val != A.val ) {
+        magma_zmfree( &hA, queue );
+    }
     return info; 
 }
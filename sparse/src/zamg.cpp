@@ -0,0 +1,926 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// the coarsening stops at this size, the coarsest level is solved with a
+// dense LU factorization
+#define AMG_COARSE_SIZE    500
+
+// if the coarsening stagnates above this size, the coarsest level is only
+// smoothed instead of factorized
+#define AMG_COARSE_LIMIT   2000
+
+// default upper limit for the number of levels
+#define AMG_MAX_LEVELS     20
+
+// strength of connection threshold on the finest level, halved on each
+// coarser level
+#define AMG_THETA          0.025
+
+// power iterations for the spectral radius of D^-1 A
+#define AMG_POWER_ITERS    15
+
+// the Chebyshev smoother targets the interval
+// [ 1.1 lambda / AMG_CHEB_RATIO, 1.1 lambda ]
+#define AMG_CHEB_RATIO     30.0
+
+// states in the distance-2 maximal independent set
+#define AMG_OUT           -1
+#define AMG_UNDECIDED      0
+#define AMG_ROOT           1
+
+
+/******************************************************************************/
+// allocates a CSR matrix on the CPU
+static magma_int_t
+amg_csr_create(
+    magma_int_t num_rows,
+    magma_int_t num_cols,
+    magma_int_t nnz,
+    magma_z_matrix *M )
+{
+    magma_int_t info = 0;
+
+    M->storage_type    = Magma_CSR;
+    M->memory_location = Magma_CPU;
+    M->fill_mode       = MagmaFull;
+    M->num_rows        = num_rows;
+    M->num_cols        = num_cols;
+    M->nnz             = nnz;
+    M->true_nnz        = nnz;
+    CHECK( magma_index_malloc_cpu( &M->row, num_rows+1 ));
+    CHECK( magma_index_malloc_cpu( &M->col, max( nnz, 1 ) ));
+    CHECK( magma_zmalloc_cpu( &M->val, max( nnz, 1 ) ));
+
+cleanup:
+    return info;
+}
+
+
+/******************************************************************************/
+// C = A * B for CSR matrices on the CPU (Gustavson). The first pass counts
+// the nonzeros of each row of C, the second one accumulates the products.
+// Each thread marks the columns of its current row in a private array of
+// length B.num_cols; a column is new in the row if its mark is older than
+// the row start.
+static magma_int_t
+amg_spgemm(
+    magma_z_matrix A,
+    magma_z_matrix B,
+    magma_z_matrix *C,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t num_threads = 1;
+    magma_index_t *marker = NULL, *rowptr = NULL;
+    magma_int_t nnz = 0;
+
+    #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    #endif
+    CHECK( magma_index_malloc_cpu( &marker, num_threads * max( B.num_cols, 1 ) ));
+    CHECK( magma_index_malloc_cpu( &rowptr, A.num_rows+1 ));
+
+    // symbolic pass
+    #pragma omp parallel
+    {
+        magma_int_t tid = 0;
+        #ifdef _OPENMP
+        tid = omp_get_thread_num();
+        #endif
+        magma_index_t *mark = marker + tid * B.num_cols;
+        for( magma_int_t j=0; j<B.num_cols; j++ ){
+            mark[j] = -1;
+        }
+        #pragma omp for schedule(dynamic,256)
+        for( magma_int_t i=0; i<A.num_rows; i++ ){
+            magma_index_t cnt = 0;
+            for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+                magma_index_t r = A.col[k];
+                for( magma_int_t l=B.row[r]; l<B.row[r+1]; l++ ){
+                    magma_index_t c = B.col[l];
+                    if( mark[c] != i ){
+                        mark[c] = i;
+                        cnt++;
+                    }
+                }
+            }
+            rowptr[i+1] = cnt;
+        }
+    }
+    rowptr[0] = 0;
+    for( magma_int_t i=0; i<A.num_rows; i++ ){
+        rowptr[i+1] += rowptr[i];
+    }
+    nnz = rowptr[A.num_rows];
+
+    CHECK( amg_csr_create( A.num_rows, B.num_cols, nnz, C ));
+    for( magma_int_t i=0; i<A.num_rows+1; i++ ){
+        C->row[i] = rowptr[i];
+    }
+
+    // numeric pass
+    #pragma omp parallel
+    {
+        magma_int_t tid = 0;
+        #ifdef _OPENMP
+        tid = omp_get_thread_num();
+        #endif
+        magma_index_t *mark = marker + tid * B.num_cols;
+        for( magma_int_t j=0; j<B.num_cols; j++ ){
+            mark[j] = -1;
+        }
+        #pragma omp for schedule(dynamic,256)
+        for( magma_int_t i=0; i<A.num_rows; i++ ){
+            magma_index_t start = C->row[i], pos = C->row[i];
+            for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+                magma_index_t r = A.col[k];
+                magmaDoubleComplex a = A.val[k];
+                for( magma_int_t l=B.row[r]; l<B.row[r+1]; l++ ){
+                    magma_index_t c = B.col[l];
+                    if( mark[c] < start ){
+                        mark[c] = pos;
+                        C->col[pos] = c;
+                        C->val[pos] = a * B.val[l];
+                        pos++;
+                    } else {
+                        C->val[mark[c]] += a * B.val[l];
+                    }
+                }
+            }
+        }
+    }
+    CHECK( magma_zcsr_segsort( C->num_rows, C->row, C->col, C->val, queue ));
+
+cleanup:
+    magma_free_cpu( marker );
+    magma_free_cpu( rowptr );
+    if( info != 0 ){
+        magma_zmfree( C, queue );
+    }
+    return info;
+}
+
+
+/******************************************************************************/
+// B = A^H for a rectangular CSR matrix on the CPU, by counting sort over the
+// columns of A; the rows of B come out sorted
+static magma_int_t
+amg_transpose(
+    magma_z_matrix A,
+    magma_z_matrix *B )
+{
+    magma_int_t info = 0;
+    magma_index_t *pos = NULL;
+
+    CHECK( amg_csr_create( A.num_cols, A.num_rows, A.nnz, B ));
+    CHECK( magma_index_malloc_cpu( &pos, A.num_cols+1 ));
+    for( magma_int_t j=0; j<A.num_cols+1; j++ ){
+        pos[j] = 0;
+    }
+    for( magma_int_t k=0; k<A.nnz; k++ ){
+        pos[ A.col[k]+1 ]++;
+    }
+    for( magma_int_t j=0; j<A.num_cols; j++ ){
+        pos[j+1] += pos[j];
+    }
+    for( magma_int_t j=0; j<A.num_cols+1; j++ ){
+        B->row[j] = pos[j];
+    }
+    for( magma_int_t i=0; i<A.num_rows; i++ ){
+        for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+            magma_index_t dst = pos[ A.col[k] ]++;
+            B->col[dst] = i;
+            B->val[dst] = MAGMA_Z_CONJ( A.val[k] );
+        }
+    }
+
+cleanup:
+    magma_free_cpu( pos );
+    return info;
+}
+
+
+/******************************************************************************/
+// inverse diagonal of A, zero for rows without diagonal entry
+static void
+amg_dinv(
+    magma_z_matrix A,
+    magmaDoubleComplex *dinv )
+{
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i<A.num_rows; i++ ){
+        dinv[i] = MAGMA_Z_ZERO;
+        for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+            if( A.col[k] == i && MAGMA_Z_ABS( A.val[k] ) > 0.0 ){
+                dinv[i] = MAGMA_Z_ONE / A.val[k];
+            }
+        }
+    }
+}
+
+
+/******************************************************************************/
+// estimates the spectral radius of D^-1 A with a few power iterations,
+// x and y are work vectors of length A.num_rows
+static double
+amg_lambda(
+    magma_z_matrix A,
+    magmaDoubleComplex *dinv,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex *y,
+    magma_queue_t queue )
+{
+    magma_int_t n = A.num_rows;
+    double nrm = 0.0, lambda = 0.0;
+
+    // deterministic start vector with components of both signs
+    for( magma_int_t i=0; i<n; i++ ){
+        x[i] = MAGMA_Z_MAKE( 1.0 + ( (i*7919) % 101 ) / 100.0 * ( (i % 2) ? -1.0 : 1.0 ), 0.0 );
+    }
+    nrm = magma_dznrm2_cpu( n, x, queue );
+    for( magma_int_t it=0; it<AMG_POWER_ITERS && nrm > 0.0; it++ ){
+        magma_zspmv_dot_cpu( A, x, y, NULL, NULL, NULL, queue );
+        double ny = 0.0;
+        #pragma omp parallel for schedule(static) reduction(+:ny)
+        for( magma_int_t i=0; i<n; i++ ){
+            y[i] = dinv[i] * y[i];
+            ny += MAGMA_Z_REAL( MAGMA_Z_CONJ( y[i] ) * y[i] );
+        }
+        ny = sqrt( ny );
+        lambda = ny / nrm;
+        if( ny == 0.0 ){
+            break;
+        }
+        double s = 1.0 / ny;
+        #pragma omp parallel for schedule(static)
+        for( magma_int_t i=0; i<n; i++ ){
+            x[i] = y[i] * s;
+        }
+        nrm = 1.0;
+    }
+    return lambda;
+}
+
+
+/******************************************************************************/
+// key of a node for the independent set: state, pseudo-random priority and
+// index, ordered such that roots > undecided > out
+static inline unsigned long long
+amg_key( magma_int_t state, magma_int_t i )
+{
+    unsigned long long h = (unsigned long long) i;
+    h ^= h >> 16;
+    h *= 0x45d9f3bULL;
+    h ^= h >> 16;
+    return ( (unsigned long long)( state + 1 ) << 62 )
+         | ( ( h & 0x3fffffffULL ) << 32 )
+         | (unsigned long long) i;
+}
+
+
+/******************************************************************************/
+// Parallel aggregation. Node j is strongly connected to node i if
+// |a_ij|^2 > theta^2 |a_ii a_jj|. The aggregate roots form a maximal
+// independent set of distance 2 in the strength graph, computed in rounds:
+// every undecided node takes the maximum key over its distance-2
+// neighbourhood and becomes a root if it is its own key, or leaves the set
+// if it is the key of a root (Bell, Dalton, Olson). Then the neighbours of
+// the roots join their aggregate, the remaining nodes join a neighbouring
+// aggregate, and nodes without strong connections form their own aggregate.
+static magma_int_t
+amg_aggregate(
+    magma_z_matrix A,
+    double theta,
+    magma_index_t *agg,
+    magma_int_t *num_agg,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t n = A.num_rows;
+    magma_int_t undecided = n, nagg = 0;
+    double *diag = NULL;
+    char *strong = NULL;
+    magma_int_t *state = NULL;
+    magma_index_t *agg1 = NULL;
+    unsigned long long *key = NULL, *t1 = NULL, *t2 = NULL;
+
+    CHECK( magma_dmalloc_cpu( &diag, n ));
+    CHECK( magma_malloc_cpu( (void**) &strong, max( A.nnz, 1 ) * sizeof(char) ));
+    CHECK( magma_imalloc_cpu( &state, n ));
+    CHECK( magma_index_malloc_cpu( &agg1, n ));
+    CHECK( magma_malloc_cpu( (void**) &key, n * sizeof(unsigned long long) ));
+    CHECK( magma_malloc_cpu( (void**) &t1,  n * sizeof(unsigned long long) ));
+    CHECK( magma_malloc_cpu( (void**) &t2,  n * sizeof(unsigned long long) ));
+
+    // strength of connection
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i<n; i++ ){
+        diag[i] = 0.0;
+        for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+            if( A.col[k] == i ){
+                diag[i] = MAGMA_Z_ABS( A.val[k] );
+            }
+        }
+    }
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i<n; i++ ){
+        for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+            magma_index_t j = A.col[k];
+            double a = MAGMA_Z_ABS( A.val[k] );
+            strong[k] = ( j != i && a > 0.0 && a*a > theta*theta*diag[i]*diag[j] );
+        }
+        state[i] = AMG_UNDECIDED;
+        key[i] = amg_key( AMG_UNDECIDED, i );
+    }
+
+    // distance-2 maximal independent set
+    while( undecided > 0 ){
+        #pragma omp parallel for schedule(static)
+        for( magma_int_t i=0; i<n; i++ ){
+            unsigned long long m = key[i];
+            for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+                if( strong[k] ){
+                    m = max( m, key[ A.col[k] ] );
+                }
+            }
+            t1[i] = m;
+        }
+        #pragma omp parallel for schedule(static)
+        for( magma_int_t i=0; i<n; i++ ){
+            unsigned long long m = t1[i];
+            for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+                if( strong[k] ){
+                    m = max( m, t1[ A.col[k] ] );
+                }
+            }
+            t2[i] = m;
+        }
+        undecided = 0;
+        #pragma omp parallel for schedule(static) reduction(+:undecided)
+        for( magma_int_t i=0; i<n; i++ ){
+            if( state[i] == AMG_UNDECIDED ){
+                if( t2[i] == key[i] ){
+                    state[i] = AMG_ROOT;
+                    key[i] = amg_key( AMG_ROOT, i );
+                } else if( ( t2[i] >> 62 ) == AMG_ROOT + 1 ){
+                    state[i] = AMG_OUT;
+                    key[i] = amg_key( AMG_OUT, i );
+                } else {
+                    undecided++;
+                }
+            }
+        }
+    }
+
+    // number the aggregates by their roots
+    for( magma_int_t i=0; i<n; i++ ){
+        agg[i] = ( state[i] == AMG_ROOT ) ? nagg++ : -1;
+    }
+    // neighbours of the roots
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i<n; i++ ){
+        if( state[i] != AMG_ROOT ){
+            for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+                if( strong[k] && state[ A.col[k] ] == AMG_ROOT ){
+                    agg[i] = agg[ A.col[k] ];
+                    break;
+                }
+            }
+        }
+    }
+    // distance-2 neighbours of the roots
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i<n; i++ ){
+        agg1[i] = agg[i];
+    }
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i<n; i++ ){
+        if( agg1[i] < 0 ){
+            for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+                if( strong[k] && agg1[ A.col[k] ] >= 0 ){
+                    agg[i] = agg1[ A.col[k] ];
+                    break;
+                }
+            }
+        }
+    }
+    // everything left forms its own aggregate
+    for( magma_int_t i=0; i<n; i++ ){
+        if( agg[i] < 0 ){
+            agg[i] = nagg++;
+        }
+    }
+    *num_agg = nagg;
+
+cleanup:
+    magma_free_cpu( diag );
+    magma_free_cpu( strong );
+    magma_free_cpu( state );
+    magma_free_cpu( agg1 );
+    magma_free_cpu( key );
+    magma_free_cpu( t1 );
+    magma_free_cpu( t2 );
+    return info;
+}
+
+
+/******************************************************************************/
+// smoothed prolongation P = ( I - omega D^-1 A ) T with the tentative
+// prolongation T(i,agg(i)) = 1/sqrt(|agg(i)|), omega = 4 / (3 lambda).
+// T has one nonzero per row, so row i of P has the columns agg(k) of the
+// nonzeros a_ik plus agg(i).
+static magma_int_t
+amg_prolongation(
+    magma_z_matrix A,
+    magmaDoubleComplex *dinv,
+    double lambda,
+    magma_index_t *agg,
+    magma_int_t nagg,
+    magma_z_matrix *P,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t n = A.num_rows;
+    magma_int_t num_threads = 1;
+    magma_index_t *marker = NULL, *rowptr = NULL;
+    double *t = NULL, *size = NULL;
+    double omega = ( lambda > 0.0 ) ? 4.0 / ( 3.0 * lambda ) : 0.0;
+
+    #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    #endif
+    CHECK( magma_index_malloc_cpu( &marker, num_threads * nagg ));
+    CHECK( magma_index_malloc_cpu( &rowptr, n+1 ));
+    CHECK( magma_dmalloc_cpu( &t, n ));
+    CHECK( magma_dmalloc_cpu( &size, nagg ));
+
+    for( magma_int_t a=0; a<nagg; a++ ){
+        size[a] = 0.0;
+    }
+    for( magma_int_t i=0; i<n; i++ ){
+        size[ agg[i] ] += 1.0;
+    }
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i<n; i++ ){
+        t[i] = 1.0 / sqrt( size[ agg[i] ] );
+    }
+
+    #pragma omp parallel
+    {
+        magma_int_t tid = 0;
+        #ifdef _OPENMP
+        tid = omp_get_thread_num();
+        #endif
+        magma_index_t *mark = marker + tid * nagg;
+        for( magma_int_t j=0; j<nagg; j++ ){
+            mark[j] = -1;
+        }
+        #pragma omp for schedule(static)
+        for( magma_int_t i=0; i<n; i++ ){
+            magma_index_t cnt = 1;
+            mark[ agg[i] ] = i;
+            for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+                magma_index_t c = agg[ A.col[k] ];
+                if( mark[c] != i ){
+                    mark[c] = i;
+                    cnt++;
+                }
+            }
+            rowptr[i+1] = cnt;
+        }
+    }
+    rowptr[0] = 0;
+    for( magma_int_t i=0; i<n; i++ ){
+        rowptr[i+1] += rowptr[i];
+    }
+
+    CHECK( amg_csr_create( n, nagg, rowptr[n], P ));
+    for( magma_int_t i=0; i<n+1; i++ ){
+        P->row[i] = rowptr[i];
+    }
+
+    #pragma omp parallel
+    {
+        magma_int_t tid = 0;
+        #ifdef _OPENMP
+        tid = omp_get_thread_num();
+        #endif
+        magma_index_t *mark = marker + tid * nagg;
+        for( magma_int_t j=0; j<nagg; j++ ){
+            mark[j] = -1;
+        }
+        #pragma omp for schedule(static)
+        for( magma_int_t i=0; i<n; i++ ){
+            magma_index_t pos = P->row[i];
+            magmaDoubleComplex s = MAGMA_Z_MAKE( -omega, 0.0 ) * dinv[i];
+            mark[ agg[i] ] = pos;
+            P->col[pos] = agg[i];
+            P->val[pos] = MAGMA_Z_MAKE( t[i], 0.0 );
+            pos++;
+            for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+                magma_index_t c = agg[ A.col[k] ];
+                magmaDoubleComplex v = s * A.val[k] * MAGMA_Z_MAKE( t[ A.col[k] ], 0.0 );
+                if( mark[c] < P->row[i] ){
+                    mark[c] = pos;
+                    P->col[pos] = c;
+                    P->val[pos] = v;
+                    pos++;
+                } else {
+                    P->val[ mark[c] ] += v;
+                }
+            }
+        }
+    }
+    CHECK( magma_zcsr_segsort( P->num_rows, P->row, P->col, P->val, queue ));
+
+cleanup:
+    magma_free_cpu( marker );
+    magma_free_cpu( rowptr );
+    magma_free_cpu( t );
+    magma_free_cpu( size );
+    if( info != 0 ){
+        magma_zmfree( P, queue );
+    }
+    return info;
+}
+
+
+/******************************************************************************/
+// dense LU factorization of the coarsest level
+static magma_int_t
+amg_coarse_factor(
+    magma_z_amg_level *lev )
+{
+    magma_int_t info = 0, linfo = 0;
+    magma_int_t n = lev->A.num_rows;
+
+    CHECK( magma_zmalloc_cpu( &lev->LU, n*n ));
+    CHECK( magma_imalloc_cpu( &lev->ipiv, n ));
+    for( magma_int_t k=0; k<n*n; k++ ){
+        lev->LU[k] = MAGMA_Z_ZERO;
+    }
+    for( magma_int_t i=0; i<n; i++ ){
+        for( magma_int_t k=lev->A.row[i]; k<lev->A.row[i+1]; k++ ){
+            lev->LU[ i + lev->A.col[k]*n ] = lev->A.val[k];
+        }
+    }
+    lapackf77_zgetrf( &n, &n, lev->LU, &n, lev->ipiv, &linfo );
+    if( linfo != 0 ){
+        // singular coarse operator, fall back to smoothing
+        magma_free_cpu( lev->LU );
+        magma_free_cpu( lev->ipiv );
+        lev->LU = NULL;
+        lev->ipiv = NULL;
+    }
+
+cleanup:
+    return info;
+}
+
+
+/******************************************************************************/
+// x = x + P xc
+static void
+amg_prolongate(
+    magma_z_matrix P,
+    magmaDoubleComplex *xc,
+    magmaDoubleComplex *x )
+{
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i<P.num_rows; i++ ){
+        magmaDoubleComplex s = x[i];
+        for( magma_int_t k=P.row[i]; k<P.row[i+1]; k++ ){
+            s += P.val[k] * xc[ P.col[k] ];
+        }
+        x[i] = s;
+    }
+}
+
+
+/******************************************************************************/
+// nu steps of the smoother on A x = b, x is used as initial guess
+static void
+amg_smooth(
+    magma_z_amg_level *lev,
+    magma_solver_type smoother,
+    magma_int_t nu,
+    magma_queue_t queue )
+{
+    magma_int_t n = lev->A.num_rows;
+    double nrm;
+    magmaDoubleComplex *x = lev->x, *r = lev->r, *d = lev->d, *dinv = lev->dinv;
+
+    if( smoother == Magma_CHEBYSHEV ){
+        // Chebyshev iteration for D^-1 A on [ lower, upper ]
+        double upper = 1.1 * lev->lambda;
+        double lower = upper / AMG_CHEB_RATIO;
+        double theta = 0.5 * ( upper + lower );
+        double delta = 0.5 * ( upper - lower );
+        double sigma = theta / delta;
+        double rho = 1.0 / sigma, rho_new;
+
+        magma_zresidual_cpu( lev->A, lev->b, x, r, &nrm, queue );
+        #pragma omp parallel for schedule(static)
+        for( magma_int_t i=0; i<n; i++ ){
+            d[i] = dinv[i] * r[i] / theta;
+        }
+        for( magma_int_t k=0; k<nu; k++ ){
+            #pragma omp parallel for schedule(static)
+            for( magma_int_t i=0; i<n; i++ ){
+                x[i] += d[i];
+            }
+            if( k == nu-1 ){
+                break;
+            }
+            magma_zresidual_cpu( lev->A, lev->b, x, r, &nrm, queue );
+            rho_new = 1.0 / ( 2.0*sigma - rho );
+            double c1 = rho_new * rho, c2 = 2.0 * rho_new / delta;
+            #pragma omp parallel for schedule(static)
+            for( magma_int_t i=0; i<n; i++ ){
+                d[i] = c1 * d[i] + c2 * dinv[i] * r[i];
+            }
+            rho = rho_new;
+        }
+    }
+    else {
+        // damped Jacobi
+        double omega = ( lev->lambda > 0.0 ) ? 4.0 / ( 3.0 * lev->lambda ) : 0.0;
+        for( magma_int_t k=0; k<nu; k++ ){
+            magma_zresidual_cpu( lev->A, lev->b, x, r, &nrm, queue );
+            #pragma omp parallel for schedule(static)
+            for( magma_int_t i=0; i<n; i++ ){
+                x[i] += omega * dinv[i] * r[i];
+            }
+        }
+    }
+}
+
+
+/******************************************************************************/
+// V-cycle on level l for the right hand side in amg[l].b, the result is
+// returned in amg[l].x
+static void
+amg_vcycle(
+    magma_z_preconditioner *precond,
+    magma_int_t l,
+    magma_solver_type smoother,
+    magma_int_t nu,
+    magma_queue_t queue )
+{
+    magma_z_amg_level *lev = &precond->amg[l];
+    magma_int_t n = lev->A.num_rows;
+    magma_int_t ione = 1, linfo;
+    double nrm;
+
+    if( l == precond->amg_levels-1 ){
+        if( lev->LU != NULL ){
+            for( magma_int_t i=0; i<n; i++ ){
+                lev->x[i] = lev->b[i];
+            }
+            lapackf77_zgetrs( "N", &n, &ione, lev->LU, &n, lev->ipiv, lev->x, &n, &linfo );
+        } else {
+            magma_zfill_cpu( n, MAGMA_Z_ZERO, lev->x, queue );
+            amg_smooth( lev, smoother, 2*nu, queue );
+        }
+        return;
+    }
+
+    magma_z_amg_level *next = &precond->amg[l+1];
+
+    // pre-smoothing
+    magma_zfill_cpu( n, MAGMA_Z_ZERO, lev->x, queue );
+    amg_smooth( lev, smoother, nu, queue );
+
+    // restrict the residual
+    magma_zresidual_cpu( lev->A, lev->b, lev->x, lev->r, &nrm, queue );
+    magma_zspmv_dot_cpu( lev->R, lev->r, next->b, NULL, NULL, NULL, queue );
+
+    // coarse grid correction
+    amg_vcycle( precond, l+1, smoother, nu, queue );
+    amg_prolongate( lev->P, next->x, lev->x );
+
+    // post-smoothing
+    amg_smooth( lev, smoother, nu, queue );
+}
+
+
+/**
+    Purpose
+    -------
+
+    Prepares the smoothed aggregation algebraic multigrid preconditioner.
+    The hierarchy is built on the CPU, from a CSR copy of A:
+
+    - aggregation: the roots of the aggregates form a distance-2 maximal
+      independent set in the graph of the strong connections, which is
+      computed in parallel rounds; the other nodes join a neighbouring
+      aggregate
+    - prolongation: the tentative prolongation for the constant vector is
+      smoothed with one damped Jacobi step, P = ( I - 4/(3 lambda) D^-1 A ) T,
+      where lambda estimates the spectral radius of D^-1 A
+    - coarse operator: Galerkin product R A P with R = P^H
+
+    The coarsening stops at AMG_COARSE_SIZE unknowns, or after
+    precond->levels levels if this is positive. The coarsest level is
+    solved with a dense LU factorization.
+
+    The smoother is damped Jacobi, or Chebyshev if precond->trisolver is
+    Magma_CHEBYSHEV, with precond->sweeps steps (or polynomial degree)
+    before and after the coarse grid correction.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A
+
+    @param[in]
+    b           magma_z_matrix
+                input RHS b
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zamgsetup(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hA={Magma_CSR}, AP={Magma_CSR};
+    magma_index_t *agg = NULL;
+    magma_int_t maxlevels, nagg, l;
+    double theta = AMG_THETA;
+
+    maxlevels = ( precond->levels > 0 ) ? precond->levels : AMG_MAX_LEVELS;
+    precond->amg = NULL;
+    precond->amg_levels = 0;
+    CHECK( magma_malloc_cpu( (void**) &precond->amg, maxlevels * sizeof(magma_z_amg_level) ));
+    for( l=0; l<maxlevels; l++ ){
+        magma_z_amg_level *lev = &precond->amg[l];
+        magma_z_matrix empty={Magma_CSR};
+        lev->A = empty;
+        lev->P = empty;
+        lev->R = empty;
+        lev->dinv = NULL;
+        lev->x = NULL;
+        lev->b = NULL;
+        lev->r = NULL;
+        lev->d = NULL;
+        lev->LU = NULL;
+        lev->ipiv = NULL;
+        lev->lambda = 0.0;
+    }
+
+    // CSR copy of A on the CPU
+    CHECK( magma_zmtransfer( A, &hA, A.memory_location, Magma_CPU, queue ));
+    CHECK( magma_zmconvert( hA, &precond->amg[0].A, hA.storage_type, Magma_CSR, queue ));
+
+    for( l=0; l<maxlevels; l++ ){
+        magma_z_amg_level *lev = &precond->amg[l];
+        magma_int_t n = lev->A.num_rows;
+        precond->amg_levels = l+1;
+
+        CHECK( magma_zmalloc_cpu( &lev->dinv, n ));
+        CHECK( magma_zmalloc_cpu( &lev->x, n ));
+        CHECK( magma_zmalloc_cpu( &lev->b, n ));
+        CHECK( magma_zmalloc_cpu( &lev->r, n ));
+        CHECK( magma_zmalloc_cpu( &lev->d, n ));
+        magma_zfill_cpu( n, MAGMA_Z_ZERO, lev->x, queue );
+        magma_zfill_cpu( n, MAGMA_Z_ZERO, lev->b, queue );
+        magma_zfill_cpu( n, MAGMA_Z_ZERO, lev->r, queue );
+        magma_zfill_cpu( n, MAGMA_Z_ZERO, lev->d, queue );
+        amg_dinv( lev->A, lev->dinv );
+        lev->lambda = amg_lambda( lev->A, lev->dinv, lev->x, lev->r, queue );
+
+        if( n <= AMG_COARSE_SIZE || l == maxlevels-1 ){
+            break;
+        }
+
+        CHECK( magma_index_malloc_cpu( &agg, n ));
+        CHECK( amg_aggregate( lev->A, theta, agg, &nagg, queue ));
+        if( nagg == 0 || nagg > 0.9 * n ){
+            // coarsening stagnates
+            magma_free_cpu( agg );
+            agg = NULL;
+            break;
+        }
+        CHECK( amg_prolongation( lev->A, lev->dinv, lev->lambda, agg, nagg, &lev->P, queue ));
+        magma_free_cpu( agg );
+        agg = NULL;
+
+        // R = P^H, A_c = R A P
+        CHECK( amg_transpose( lev->P, &lev->R ));
+        CHECK( amg_spgemm( lev->A, lev->P, &AP, queue ));
+        CHECK( amg_spgemm( lev->R, AP, &precond->amg[l+1].A, queue ));
+        magma_zmfree( &AP, queue );
+
+        theta *= 0.5;
+    }
+
+    if( precond->amg[ precond->amg_levels-1 ].A.num_rows <= AMG_COARSE_LIMIT ){
+        CHECK( amg_coarse_factor( &precond->amg[ precond->amg_levels-1 ] ));
+    }
+
+cleanup:
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &AP, queue );
+    magma_free_cpu( agg );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Applies one V-cycle of the algebraic multigrid preconditioner,
+    x = M^-1 b. The cycle runs on the CPU; vectors on the device are
+    copied to and from the CPU.
+
+    Arguments
+    ---------
+
+    @param[in]
+    b           magma_z_matrix
+                RHS
+
+    @param[out]
+    x           magma_z_matrix*
+                vector to precondition
+
+    @param[in]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zapplyamg(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_z_amg_level *lev;
+    magma_int_t n, nu;
+    magma_solver_type smoother;
+
+    if( precond->amg == NULL || precond->amg_levels < 1 ){
+        return MAGMA_ERR_NOT_INITIALIZED;
+    }
+    lev = &precond->amg[0];
+    n = lev->A.num_rows;
+    nu = ( precond->sweeps > 0 ) ? precond->sweeps : 1;
+    smoother = ( precond->trisolver == Magma_CHEBYSHEV ) ? Magma_CHEBYSHEV : Magma_JACOBI;
+
+    if( b.memory_location == Magma_DEV ){
+        magma_zgetvector( n, b.dval, 1, lev->b, 1, queue );
+    } else {
+        for( magma_int_t i=0; i<n; i++ ){
+            lev->b[i] = b.val[i];
+        }
+    }
+
+    amg_vcycle( precond, 0, smoother, nu, queue );
+
+    if( x->memory_location == Magma_DEV ){
+        magma_zsetvector( n, lev->x, 1, x->dval, 1, queue );
+    } else {
+        for( magma_int_t i=0; i<n; i++ ){
+            x->val[i] = lev->x[i];
+        }
+    }
+
+    return info;
+}
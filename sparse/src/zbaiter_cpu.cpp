@@ -0,0 +1,338 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define PRECISION_z
+
+#define ATOLERANCE     lapackf77_dlamch( "E" )
+
+// default size of the diagonal blocks, as in magma_zbaiter
+#define BAITER_BSIZE   256
+
+
+/******************************************************************************/
+// Relaxed atomic access to the shared iterate. Complex values are accessed
+// componentwise: a value combining components of two different updates is
+// still a legal state of the asynchronous iteration.
+static inline magmaDoubleComplex
+baiter_load( magmaDoubleComplex *p )
+{
+#if defined(PRECISION_z) || defined(PRECISION_c)
+    double *q = (double*) p;
+    double re, im;
+    #pragma omp atomic read
+    re = q[0];
+    #pragma omp atomic read
+    im = q[1];
+    return MAGMA_Z_MAKE( re, im );
+#else
+    double v;
+    #pragma omp atomic read
+    v = *p;
+    return v;
+#endif
+}
+
+static inline void
+baiter_store( magmaDoubleComplex *p, magmaDoubleComplex v )
+{
+#if defined(PRECISION_z) || defined(PRECISION_c)
+    double *q = (double*) p;
+    double re = MAGMA_Z_REAL( v ), im = MAGMA_Z_IMAG( v );
+    #pragma omp atomic write
+    q[0] = re;
+    #pragma omp atomic write
+    q[1] = im;
+#else
+    #pragma omp atomic write
+    *p = v;
+#endif
+}
+
+
+/******************************************************************************/
+// rhs = b - R x for the rows first ... last-1, reading the latest values of x
+static void
+baiter_rhs(
+    magma_z_matrix R,
+    magmaDoubleComplex *b,
+    magmaDoubleComplex *x,
+    magmaDoubleComplex *rhs,
+    magma_int_t first,
+    magma_int_t last )
+{
+    for( magma_int_t i=first; i<last; i++ ){
+        magmaDoubleComplex s = b[i];
+        for( magma_int_t k=R.row[i]; k<R.row[i+1]; k++ ){
+            s -= R.val[k] * baiter_load( &x[ R.col[k] ] );
+        }
+        rhs[i] = s;
+    }
+}
+
+
+/******************************************************************************/
+// localiter in-place sweeps on D x = rhs for the rows first ... last-1.
+// Rows of D hold the diagonal first (magma_zcsrsplit). Returns the squared
+// norm of the residual of the block before the sweeps.
+static double
+baiter_local(
+    magma_z_matrix D,
+    magmaDoubleComplex *rhs,
+    magmaDoubleComplex *x,
+    magma_int_t first,
+    magma_int_t last,
+    magma_int_t localiter )
+{
+    double res = 0.0;
+    for( magma_int_t it=0; it<localiter; it++ ){
+        for( magma_int_t i=first; i<last; i++ ){
+            magmaDoubleComplex s = rhs[i];
+            for( magma_int_t k=D.row[i]; k<D.row[i+1]; k++ ){
+                s -= D.val[k] * x[ D.col[k] ];
+            }
+            if( it == 0 ){
+                res += MAGMA_Z_REAL( MAGMA_Z_CONJ( s ) * s );
+            }
+            baiter_store( &x[i], x[i] + s / D.val[ D.row[i] ] );
+        }
+    }
+    return res;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Solves a system of linear equations
+       A * x = b
+    via the block asynchronous iteration method on the CPU, for matrices and
+    vectors in Magma_CPU memory.
+
+    A is split with magma_zcsrsplit into diagonal blocks D and the remainder
+    R, and each OpenMP thread owns a contiguous range of blocks. A thread
+    repeatedly computes the local right hand side b - R x from the latest
+    values of its neighbours and runs precond_par->maxiter in-place sweeps
+    on its diagonal blocks. There are no barriers: x is shared through
+    relaxed atomic loads and stores, so a thread never waits for a slower
+    one.
+
+    Each thread publishes the residual norm of its rows seen in its last
+    sweep. Any thread that finds the sum below the tolerance raises a
+    flag that stops all threads. This lock-free estimate mixes residuals of
+    different moments, so the exact residual is checked afterwards, and the
+    iteration resumes if it misses the tolerance.
+
+    If solver_par->version is 1, the threads synchronize after computing
+    the right hand sides and after the local sweeps, which is the
+    synchronous block-Jacobi method, for comparison.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A, CSR on the CPU
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b, on the CPU
+
+    @param[in,out]
+    x           magma_z_matrix*
+                solution approximation, on the CPU
+
+    @param[in,out]
+    solver_par  magma_z_solver_par*
+                solver parameters
+
+    @param[in]
+    precond_par magma_z_preconditioner*
+                preconditioner parameters, maxiter is the number of local
+                sweeps, bsize the size of the diagonal blocks
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgesv
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zbaiter_cpu(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue )
+{
+    magma_int_t info = MAGMA_NOTCONVERGED;
+
+    // prepare solver feedback
+    solver_par->solver = Magma_BAITER;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+
+    magma_int_t dofs = A.num_rows;
+    magma_int_t localiter = ( precond_par->maxiter > 0 ) ? precond_par->maxiter : 1;
+    magma_int_t bsize = ( precond_par->bsize > 0 ) ? precond_par->bsize : BAITER_BSIZE;
+    magma_int_t nblocks = magma_ceildiv( dofs, bsize );
+    magma_int_t num_threads = 1;
+    magma_int_t synchronous = ( solver_par->version == 1 );
+    int done = 0;
+    double nomb, tol, residual;
+
+    magma_z_matrix D={Magma_CSR}, R={Magma_CSR};
+    magmaDoubleComplex *rhs = NULL;
+    double *tres = NULL;
+    magma_int_t *titer = NULL;
+
+    //Chronometry
+    real_Double_t tempo1, tempo2;
+
+    #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    #endif
+    num_threads = max( 1, min( num_threads, nblocks ));
+
+    CHECK( magma_zmalloc_cpu( &rhs, dofs ));
+    CHECK( magma_dmalloc_cpu( &tres, num_threads ));
+    CHECK( magma_imalloc_cpu( &titer, num_threads ));
+    for( magma_int_t t=0; t<num_threads; t++ ){
+        titer[t] = 0;
+    }
+
+    CHECK( magma_zresidual_cpu( A, b.val, x->val, rhs, &residual, queue ));
+    solver_par->init_res = residual;
+    solver_par->final_res = residual;
+    solver_par->iter_res = residual;
+    if ( solver_par->verbose > 0 ) {
+        solver_par->res_vec[0] = (real_Double_t) residual;
+        solver_par->timing[0] = 0.0;
+    }
+    nomb = magma_dznrm2_cpu( dofs, b.val, queue );
+    if ( nomb == 0.0 ){
+        nomb=1.0;
+    }
+    tol = max( solver_par->rtol * nomb, solver_par->atol );
+    tol = max( tol, ATOLERANCE );
+    if ( residual <= tol ) {
+        info = MAGMA_SUCCESS;
+        goto cleanup;
+    }
+
+    // setup
+    CHECK( magma_zcsrsplit( 0, bsize, A, &D, &R, queue ));
+
+    tempo1 = magma_wtime();
+
+    // The estimate can be too optimistic when the threads drift apart; if
+    // the exact residual misses the tolerance, the iteration resumes.
+    do
+    {
+        done = 0;
+        // until a thread publishes its residual, it counts with the full one
+        for( magma_int_t t=0; t<num_threads; t++ ){
+            tres[t] = residual * residual;
+        }
+
+        #pragma omp parallel num_threads(num_threads)
+        {
+            magma_int_t tid = 0, nt = 1;
+            #ifdef _OPENMP
+            tid = omp_get_thread_num();
+            nt = omp_get_num_threads();
+            #endif
+            // subdomain of the thread: rows first ... last-1, whole blocks
+            magma_int_t first = min( dofs, ( tid * nblocks / nt ) * bsize );
+            magma_int_t last  = min( dofs, ( (tid+1) * nblocks / nt ) * bsize );
+            magma_int_t iter = titer[tid];
+            int stop = 0;
+
+            while( ! stop && iter < solver_par->maxiter ){
+                iter++;
+                baiter_rhs( R, b.val, x->val, rhs, first, last );
+                if( synchronous ){
+                    #pragma omp barrier
+                }
+                double res = baiter_local( D, rhs, x->val, first, last, localiter );
+                #pragma omp atomic write
+                tres[tid] = res;
+                if( synchronous ){
+                    #pragma omp barrier
+                }
+
+                // lock-free convergence check
+                double est = 0.0;
+                for( magma_int_t t=0; t<nt; t++ ){
+                    double rt;
+                    #pragma omp atomic read
+                    rt = tres[t];
+                    est += rt;
+                }
+                est = sqrt( est );
+                if( est <= tol ){
+                    #pragma omp atomic write
+                    done = 1;
+                }
+                if ( tid == 0 && solver_par->verbose > 0
+                        && iter%solver_par->verbose == 0 ) {
+                    solver_par->res_vec[iter/solver_par->verbose] = (real_Double_t) est;
+                    solver_par->timing[iter/solver_par->verbose]
+                            = (real_Double_t) magma_wtime() - tempo1;
+                }
+                if( synchronous ){
+                    // all threads see the same estimate
+                    stop = ( est <= tol );
+                } else {
+                    #pragma omp atomic read
+                    stop = done;
+                }
+            }
+            titer[tid] = iter;
+        }
+
+        solver_par->numiter = 0;
+        for( magma_int_t t=0; t<num_threads; t++ ){
+            solver_par->numiter = max( solver_par->numiter, titer[t] );
+        }
+        CHECK( magma_zresidual_cpu( A, b.val, x->val, rhs, &residual, queue ));
+    }
+    while ( residual > tol && solver_par->numiter < solver_par->maxiter );
+
+    tempo2 = magma_wtime();
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    solver_par->iter_res = residual;
+    solver_par->final_res = residual;
+
+    if ( solver_par->final_res <= tol ) {
+        info = MAGMA_SUCCESS;
+    } else if ( solver_par->init_res > solver_par->final_res ) {
+        info = MAGMA_SLOW_CONVERGENCE;
+    } else {
+        info = MAGMA_DIVERGENCE;
+    }
+
+cleanup:
+    magma_zmfree( &D, queue );
+    magma_zmfree( &R, queue );
+    magma_free_cpu( rhs );
+    magma_free_cpu( tres );
+    magma_free_cpu( titer );
+
+    solver_par->info = info;
+    return info;
+}   /* magma_zbaiter_cpu */
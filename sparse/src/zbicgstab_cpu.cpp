@@ -0,0 +1,270 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+
+#define RTOLERANCE     lapackf77_dlamch( "E" )
+#define ATOLERANCE     lapackf77_dlamch( "E" )
+
+
+/**
+    Purpose
+    -------
+
+    Solves a system of linear equations
+       A * X = B
+    where A is a general complex matrix A.
+    This is a CPU implementation of the Biconjugate Gradient Stabilized
+    method for matrices and vectors in Magma_CPU memory, with the operations
+    merged like in magma_zbicgstab_merge. Each iteration makes five OpenMP
+    passes: the update of p, the two SpMVs each fused with the dot products
+    of their result, the computation of s fused with its norm, and the x and
+    r updates fused with the dot products for the next iteration.
+
+    If precond_par is given and not of type Magma_NONE, the system is
+    preconditioned from the right with magma_z_applyprecond_cpu, which is
+    applied to p and s before the SpMVs.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A, CSR on the CPU
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b, on the CPU
+
+    @param[in,out]
+    x           magma_z_matrix*
+                solution approximation, on the CPU
+
+    @param[in,out]
+    solver_par  magma_z_solver_par*
+                solver parameters
+
+    @param[in,out]
+    precond_par magma_z_preconditioner*
+                preconditioner, or NULL
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgesv
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zbicgstab_cpu(
+    magma_z_matrix A, magma_z_matrix b, magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue )
+{
+    magma_int_t info = MAGMA_NOTCONVERGED;
+
+    bool precond = precond_par != NULL && precond_par->solver != Magma_NONE
+                                       && precond_par->solver != 0;
+
+    // prepare solver feedback
+    solver_par->solver = precond ? Magma_PBICGSTABMERGE : Magma_BICGSTABMERGE;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+
+    // some useful variables
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+
+    magma_int_t dofs = A.num_rows;
+
+    // workspace
+    magmaDoubleComplex *r=NULL, *rr=NULL, *p=NULL, *v=NULL, *s=NULL, *t=NULL;
+    magmaDoubleComplex *ph=NULL, *sh=NULL;
+
+    // solver variables
+    magmaDoubleComplex alpha, beta, omega, rho_old, rho_new, rrv, st;
+    double betanom, nom0, r0, res, nomb, nrm, tt;
+
+    //Chronometry
+    real_Double_t tempo1, tempo2;
+
+    // CPU workspace, placed by first touch
+    CHECK( magma_zmalloc_cpu( &r,  dofs ));
+    CHECK( magma_zmalloc_cpu( &rr, dofs ));
+    CHECK( magma_zmalloc_cpu( &p,  dofs ));
+    CHECK( magma_zmalloc_cpu( &v,  dofs ));
+    CHECK( magma_zmalloc_cpu( &s,  dofs ));
+    CHECK( magma_zmalloc_cpu( &t,  dofs ));
+    magma_zfill_cpu( dofs, c_zero, r,  queue );
+    magma_zfill_cpu( dofs, c_zero, rr, queue );
+    magma_zfill_cpu( dofs, c_zero, p,  queue );
+    magma_zfill_cpu( dofs, c_zero, v,  queue );
+    magma_zfill_cpu( dofs, c_zero, s,  queue );
+    magma_zfill_cpu( dofs, c_zero, t,  queue );
+    if ( precond ) {
+        CHECK( magma_zmalloc_cpu( &ph, dofs ));
+        CHECK( magma_zmalloc_cpu( &sh, dofs ));
+        magma_zfill_cpu( dofs, c_zero, ph, queue );
+        magma_zfill_cpu( dofs, c_zero, sh, queue );
+    } else {
+        ph = p;
+        sh = s;
+    }
+
+    // solver setup
+    CHECK( magma_zresidual_cpu( A, b.val, x->val, r, &nom0, queue ));   // r = b - A x
+    CHECK( magma_zcgmerge_d_cpu( dofs, c_zero, r, rr, queue ));         // rr = r
+    betanom = res = nom0;
+    rho_new = MAGMA_Z_MAKE( nom0 * nom0, 0.0 );                       // rho=<rr,r>
+    rho_old = omega = alpha = MAGMA_Z_MAKE( 1.0, 0. );
+    solver_par->init_res = nom0;
+
+    nomb = magma_dznrm2_cpu( dofs, b.val, queue );
+    if ( nomb == 0.0 ){
+        nomb=1.0;
+    }
+    if ( (r0 = nomb * solver_par->rtol) < ATOLERANCE ){
+        r0 = ATOLERANCE;
+    }
+
+    solver_par->final_res = solver_par->init_res;
+    solver_par->iter_res = solver_par->init_res;
+    if ( solver_par->verbose > 0 ) {
+        solver_par->res_vec[0] = nom0;
+        solver_par->timing[0] = 0.0;
+    }
+    if ( nom0 < r0 || nom0 <= solver_par->atol ) {
+        info = MAGMA_SUCCESS;
+        goto cleanup;
+    }
+
+    tempo1 = magma_wtime();
+
+    // start iteration
+    do
+    {
+        solver_par->numiter++;
+
+        // p = r + beta * ( p - omega * v )
+        beta = rho_new/rho_old * alpha/omega;
+        CHECK( magma_zbicgmerge_p_cpu( dofs, beta, omega, r, v, p, queue ));
+
+        // v = A ph, rrv = <rr,v>, with ph = M^{-1} p
+        if ( precond ) {
+            CHECK( magma_z_applyprecond_cpu( A, p, ph, precond_par, queue ));
+        }
+        CHECK( magma_zspmv_dot_cpu( A, ph, v, rr, &rrv, NULL, queue ));
+        solver_par->spmv_count++;
+        if ( MAGMA_Z_EQUAL( rrv, c_zero ) ) {
+            info = MAGMA_DIVERGENCE;
+            break;
+        }
+        alpha = rho_new / rrv;
+
+        // s = r - alpha v
+        CHECK( magma_zbicgmerge_s_cpu( dofs, alpha, r, v, s, &nrm, queue ));
+        if ( sqrt( nrm )/nomb <= solver_par->rtol || sqrt( nrm ) <= solver_par->atol ) {
+            // x = x + alpha ph, r = s
+            rho_old = rho_new;
+            CHECK( magma_zbicgmerge_xr_cpu( dofs, alpha, c_zero, ph, s, s, t, rr,
+                                            x->val, r, &rho_new, &nrm, queue ));
+            res = betanom = sqrt( nrm );
+        }
+        else {
+            // t = A sh, st = <s,t>, tt = <t,t>, with sh = M^{-1} s
+            if ( precond ) {
+                CHECK( magma_z_applyprecond_cpu( A, s, sh, precond_par, queue ));
+            }
+            CHECK( magma_zspmv_dot_cpu( A, sh, t, s, &st, &tt, queue ));
+            solver_par->spmv_count++;
+            if ( tt == 0.0 ) {
+                info = MAGMA_DIVERGENCE;
+                break;
+            }
+            omega = MAGMA_Z_CONJ( st ) / MAGMA_Z_MAKE( tt, 0.0 );   // omega = <t,s>/<t,t>
+
+            // x = x + alpha ph + omega sh, r = s - omega t, rho = <rr,r>
+            rho_old = rho_new;
+            CHECK( magma_zbicgmerge_xr_cpu( dofs, alpha, omega, ph, s, sh, t, rr,
+                                            x->val, r, &rho_new, &nrm, queue ));
+            res = betanom = sqrt( nrm );
+        }
+
+        if ( solver_par->verbose > 0 ) {
+            tempo2 = magma_wtime();
+            if ( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) res;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+
+        if ( res/nomb <= solver_par->rtol || res <= solver_par->atol ){
+            break;
+        }
+        if ( magma_z_isnan_inf( rho_new ) || MAGMA_Z_EQUAL( omega, c_zero ) ) {
+            info = MAGMA_DIVERGENCE;
+            break;
+        }
+    }
+    while ( solver_par->numiter+1 <= solver_par->maxiter );
+
+    tempo2 = magma_wtime();
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    double residual;
+    CHECK( magma_zresidual_cpu( A, b.val, x->val, r, &residual, queue ));
+    solver_par->iter_res = res;
+    solver_par->final_res = residual;
+
+    if ( solver_par->numiter < solver_par->maxiter && info != MAGMA_DIVERGENCE ) {
+        info = MAGMA_SUCCESS;
+    } else if ( solver_par->init_res > solver_par->final_res ) {
+        if ( solver_par->verbose > 0 ) {
+            if ( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        info = MAGMA_SLOW_CONVERGENCE;
+        if( solver_par->iter_res < solver_par->rtol*nomb ||
+            solver_par->iter_res < solver_par->atol ) {
+            info = MAGMA_SUCCESS;
+        }
+    }
+    else {
+        if ( solver_par->verbose > 0 ) {
+            if ( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        info = MAGMA_DIVERGENCE;
+    }
+
+cleanup:
+    magma_free_cpu( r  );
+    magma_free_cpu( rr );
+    magma_free_cpu( p  );
+    magma_free_cpu( v  );
+    magma_free_cpu( s  );
+    magma_free_cpu( t  );
+    if ( precond ) {
+        magma_free_cpu( ph );
+        magma_free_cpu( sh );
+    }
+
+    solver_par->info = info;
+    return info;
+}   /* magma_zbicgstab_cpu */
@@ -0,0 +1,233 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+
+
+/**
+    Purpose
+    -------
+
+    Solves a system of linear equations
+       A * X = B
+    where A is a complex Hermitian positive definite matrix A.
+    This is a CPU implementation of the Conjugate Gradient method for
+    matrices and vectors in Magma_CPU memory, with the operations merged
+    like in magma_zcg_merge: each iteration makes three OpenMP passes,
+    the SpMV fused with d' * A d, the x and r updates fused with r' * r,
+    and the update of the search direction.
+
+    If precond_par is given and not of type Magma_NONE, this is the
+    preconditioned CG; the preconditioner is applied with
+    magma_z_applyprecond_cpu and has to be set up before. An iteration then
+    needs one more pass for r' * M^{-1} r.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A, CSR on the CPU
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b, on the CPU
+
+    @param[in,out]
+    x           magma_z_matrix*
+                solution approximation, on the CPU
+
+    @param[in,out]
+    solver_par  magma_z_solver_par*
+                solver parameters
+
+    @param[in,out]
+    precond_par magma_z_preconditioner*
+                preconditioner, or NULL
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zposv
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zcg_cpu(
+    magma_z_matrix A, magma_z_matrix b, magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue )
+{
+    magma_int_t info = MAGMA_NOTCONVERGED;
+
+    bool precond = precond_par != NULL && precond_par->solver != Magma_NONE
+                                       && precond_par->solver != 0;
+
+    // prepare solver feedback
+    solver_par->solver = precond ? Magma_PCGMERGE : Magma_CGMERGE;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+
+    // solver variables
+    magmaDoubleComplex alpha, beta, den, rho, rhoold;
+    double nom, nom0, betanom, nomb;
+
+    // some useful variables
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    magma_int_t dofs = A.num_rows;
+
+    magmaDoubleComplex *r=NULL, *d=NULL, *z=NULL, *h=NULL;
+
+    //Chronometry
+    real_Double_t tempo1, tempo2;
+
+    // CPU workspace, placed by first touch
+    CHECK( magma_zmalloc_cpu( &r, dofs ));
+    CHECK( magma_zmalloc_cpu( &d, dofs ));
+    CHECK( magma_zmalloc_cpu( &z, dofs ));
+    magma_zfill_cpu( dofs, c_zero, r, queue );
+    magma_zfill_cpu( dofs, c_zero, d, queue );
+    magma_zfill_cpu( dofs, c_zero, z, queue );
+    if ( precond ) {
+        CHECK( magma_zmalloc_cpu( &h, dofs ));
+        magma_zfill_cpu( dofs, c_zero, h, queue );
+    }
+
+    // solver setup
+    CHECK( magma_zresidual_cpu( A, b.val, x->val, r, &nom0, queue ));  // r = b - A x
+    betanom = nom0;
+    nom = nom0 * nom0;                                               // nom = r' * r
+    if ( precond ) {
+        CHECK( magma_z_applyprecond_cpu( A, r, h, precond_par, queue ));  // h = M^{-1} r
+        CHECK( magma_zmdotc_cpu( dofs, 1, r, dofs, h, &rho, queue ));     // rho = r' * h
+        CHECK( magma_zcgmerge_d_cpu( dofs, c_zero, h, d, queue ));        // d = h
+    } else {
+        rho = MAGMA_Z_MAKE( nom, 0.0 );
+        CHECK( magma_zcgmerge_d_cpu( dofs, c_zero, r, d, queue ));        // d = r
+    }
+    solver_par->init_res = nom0;
+
+    nomb = magma_dznrm2_cpu( dofs, b.val, queue );
+    if ( nomb == 0.0 ){
+        nomb=1.0;
+    }
+
+    solver_par->final_res = solver_par->init_res;
+    solver_par->iter_res = solver_par->init_res;
+    if( nom0 < solver_par->atol ||
+        nom0/nomb < solver_par->rtol ){
+        info = MAGMA_SUCCESS;
+        goto cleanup;
+    }
+    if ( solver_par->verbose > 0 ) {
+        solver_par->res_vec[0] = (real_Double_t) nom0;
+        solver_par->timing[0] = 0.0;
+    }
+
+    tempo1 = magma_wtime();
+
+    // start iteration
+    do
+    {
+        solver_par->numiter++;
+
+        // z = A d and den = d' * z
+        CHECK( magma_zspmv_dot_cpu( A, d, z, d, &den, NULL, queue ));
+        solver_par->spmv_count++;
+
+        // check positive definite
+        if ( MAGMA_Z_REAL( den ) <= 0.0 ) {
+            info = MAGMA_NONSPD;
+            break;
+        }
+        alpha = rho / MAGMA_Z_MAKE( MAGMA_Z_REAL( den ), 0.0 );
+
+        // x = x + alpha d, r = r - alpha z, nom = r' * r
+        CHECK( magma_zcgmerge_xr_cpu( dofs, alpha, x->val, r, d, z, &nom, queue ));
+        betanom = sqrt( nom );
+
+        if ( solver_par->verbose > 0 ) {
+            tempo2 = magma_wtime();
+            if ( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+
+        if (  betanom  < solver_par->atol ||
+              betanom/nomb < solver_par->rtol ) {
+            break;
+        }
+
+        // d = h + beta d, with h = M^{-1} r
+        rhoold = rho;
+        if ( precond ) {
+            CHECK( magma_z_applyprecond_cpu( A, r, h, precond_par, queue ));
+            CHECK( magma_zmdotc_cpu( dofs, 1, r, dofs, h, &rho, queue ));
+            beta = rho / rhoold;
+            CHECK( magma_zcgmerge_d_cpu( dofs, beta, h, d, queue ));
+        } else {
+            rho = MAGMA_Z_MAKE( nom, 0.0 );
+            beta = rho / rhoold;
+            CHECK( magma_zcgmerge_d_cpu( dofs, beta, r, d, queue ));
+        }
+    }
+    while ( solver_par->numiter+1 <= solver_par->maxiter );
+
+    tempo2 = magma_wtime();
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    double residual;
+    CHECK( magma_zresidual_cpu( A, b.val, x->val, r, &residual, queue ));
+    solver_par->iter_res = betanom;
+    solver_par->final_res = residual;
+
+    if ( info == MAGMA_NONSPD ) {
+        ;
+    } else if ( solver_par->numiter < solver_par->maxiter ) {
+        info = MAGMA_SUCCESS;
+    } else if ( solver_par->init_res > solver_par->final_res ) {
+        if ( solver_par->verbose > 0 ) {
+            if ( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        info = MAGMA_SLOW_CONVERGENCE;
+        if( solver_par->iter_res < solver_par->atol ||
+            solver_par->iter_res/solver_par->init_res < solver_par->rtol ){
+            info = MAGMA_SUCCESS;
+        }
+    }
+    else {
+        if ( solver_par->verbose > 0 ) {
+            if ( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        info = MAGMA_DIVERGENCE;
+    }
+
+cleanup:
+    magma_free_cpu( r );
+    magma_free_cpu( d );
+    magma_free_cpu( z );
+    magma_free_cpu( h );
+
+    solver_par->info = info;
+    return info;
+}   /* magma_zcg_cpu */
@@ -0,0 +1,348 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "magmasparse_internal.h"
+
+#define PRECISION_z
+
+// simulate 2-D arrays at the cost of some arithmetic
+#define V(i) (V+(i)*dofs)
+#define H(i,j) (H[(j)*m1+(i)])
+
+// reorthogonalize if the norm drops by more than this factor
+// in the Gram-Schmidt step ("twice is enough")
+#define GMRES_REORTH   0.7
+
+#define RTOLERANCE     lapackf77_dlamch( "E" )
+#define ATOLERANCE     lapackf77_dlamch( "E" )
+
+
+static void
+GeneratePlaneRotation(magmaDoubleComplex dx, magmaDoubleComplex dy, magmaDoubleComplex *cs, magmaDoubleComplex *sn)
+{
+#if defined(PRECISION_s) | defined(PRECISION_d)
+    if (dy == MAGMA_Z_ZERO) {
+        *cs = MAGMA_Z_ONE;
+        *sn = MAGMA_Z_ZERO;
+    } else if (MAGMA_Z_ABS((dy)) > MAGMA_Z_ABS((dx))) {
+        magmaDoubleComplex temp = dx / dy;
+        *sn = MAGMA_Z_ONE / magma_zsqrt( ( MAGMA_Z_ONE + temp*temp));
+        *cs = temp * (*sn);
+    } else {
+        magmaDoubleComplex temp = dy / dx;
+        *cs = MAGMA_Z_ONE / magma_zsqrt( ( MAGMA_Z_ONE + temp*temp ));
+        *sn = temp * (*cs);
+    }
+#else
+    real_Double_t rho = sqrt(MAGMA_Z_REAL(MAGMA_Z_CONJ(dx)*dx + MAGMA_Z_CONJ(dy)*dy));
+    *cs = dx / rho;
+    *sn = dy / rho;
+#endif
+}
+
+static void ApplyPlaneRotation(magmaDoubleComplex *dx, magmaDoubleComplex *dy, magmaDoubleComplex cs, magmaDoubleComplex sn)
+{
+#if defined(PRECISION_s) | defined(PRECISION_d)
+      magmaDoubleComplex temp = (*dx);
+      *dx =  cs * (*dx) + sn * (*dy);
+      *dy = -sn * temp + cs * (*dy);
+#else
+    magmaDoubleComplex temp  =  MAGMA_Z_CONJ(cs) * (*dx) +  MAGMA_Z_CONJ(sn) * (*dy);
+    *dy = -(sn) * (*dx) + cs * (*dy);
+    *dx = temp;
+#endif
+}
+
+
+/**
+    Purpose
+    -------
+
+    Solves a system of linear equations
+       A * X = B
+    where A is a complex sparse matrix stored in the CPU memory.
+    X and B are complex vectors stored in the CPU memory.
+    This is a CPU implementation of the restarted GMRES method.
+
+    The Arnoldi basis is orthogonalized by classical Gram-Schmidt, where all
+    projections of a new vector are computed in one OpenMP pass and
+    subtracted in a second one that also returns the new norm. The norm of
+    the vector before orthogonalization comes with the SpMV, and a second
+    Gram-Schmidt sweep is done only if the norm dropped by more than a
+    factor GMRES_REORTH, which keeps the basis orthogonal to working
+    precision.
+
+    If precond_par is given and not of type Magma_NONE, the system is
+    preconditioned from the right with magma_z_applyprecond_cpu: the Arnoldi
+    vectors are multiplied by A M^{-1}, and the correction V s of a restart
+    cycle by M^{-1}.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                descriptor for matrix A, CSR on the CPU
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b vector, on the CPU
+
+    @param[in,out]
+    x           magma_z_matrix*
+                solution approximation, on the CPU
+
+    @param[in,out]
+    solver_par  magma_z_solver_par*
+                solver parameters
+
+    @param[in,out]
+    precond_par magma_z_preconditioner*
+                preconditioner, or NULL
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgesv
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zgmres_cpu(
+    magma_z_matrix A, magma_z_matrix b, magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue )
+{
+    magma_int_t info = MAGMA_NOTCONVERGED;
+
+    magma_int_t dofs = A.num_rows;
+
+    bool precond = precond_par != NULL && precond_par->solver != Magma_NONE
+                                       && precond_par->solver != 0;
+
+    // prepare solver feedback
+    solver_par->solver = precond ? Magma_PGMRES : Magma_GMRES;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+
+    //Chronometry
+    real_Double_t tempo1, tempo2;
+
+    magma_int_t dim = solver_par->restart;
+    magma_int_t m1 = dim+1; // used inside H macro
+    magma_int_t i, j, k;
+    magmaDoubleComplex beta, temp;
+
+    double rel_resid = 1.0, resid0=1, r0=0.0, betanom = 0.0, nomb, nrm, wnrm2;
+
+    magmaDoubleComplex *V=NULL, *H=NULL, *h=NULL, *s=NULL, *cs=NULL, *sn=NULL;
+    magmaDoubleComplex *z=NULL;
+
+    CHECK( magma_zmalloc_cpu( &H, (dim+1)*dim ));
+    CHECK( magma_zmalloc_cpu( &h,  dim+1 ));
+    CHECK( magma_zmalloc_cpu( &s,  dim+1 ));
+    CHECK( magma_zmalloc_cpu( &cs, dim ));
+    CHECK( magma_zmalloc_cpu( &sn, dim ));
+
+    // CPU workspace, placed by first touch
+    CHECK( magma_zmalloc_cpu( &V, dofs*(dim+1) ));
+    for (k = 0; k < dim+1; k++) {
+        magma_zfill_cpu( dofs, MAGMA_Z_ZERO, V(k), queue );
+    }
+    if ( precond ) {
+        CHECK( magma_zmalloc_cpu( &z, dofs ));
+        magma_zfill_cpu( dofs, MAGMA_Z_ZERO, z, queue );
+    }
+
+    nomb = magma_dznrm2_cpu( dofs, b.val, queue );
+    if ( nomb == 0.0 ){
+        nomb=1.0;
+    }
+    if ( (r0 = nomb * solver_par->rtol) < ATOLERANCE ){
+        r0 = ATOLERANCE;
+    }
+
+    tempo1 = magma_wtime();
+    do
+    {
+        // V(0) = b - A x
+        CHECK( magma_zresidual_cpu( A, b.val, x->val, V(0), &nrm, queue ));
+        solver_par->numiter++;
+        solver_par->spmv_count++;
+        beta = MAGMA_Z_MAKE( nrm, 0.0 );
+        if( magma_z_isnan_inf( beta ) ){
+            info = MAGMA_DIVERGENCE;
+            break;
+        }
+
+        if (solver_par->numiter == 1){
+            solver_par->init_res = nrm;
+            resid0 = nrm;
+            betanom = nrm;
+
+            if ( resid0 < r0 || resid0 <= solver_par->atol ) {
+                solver_par->final_res = solver_par->init_res;
+                solver_par->iter_res = solver_par->init_res;
+                info = MAGMA_SUCCESS;
+                goto cleanup;
+            }
+        }
+        tempo2 = magma_wtime();
+        if ( solver_par->verbose > 0 ) {
+            solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+            solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+        }
+
+        // V(0) = V(0) / beta
+        temp = MAGMA_Z_ONE / beta;
+        #pragma omp parallel for schedule(static)
+        for (magma_int_t l = 0; l < dofs; l++) {
+            V(0)[l] = V(0)[l] * temp;
+        }
+
+        for (i = 1; i < dim+1; i++)
+            s[i] = MAGMA_Z_ZERO;
+        s[0] = beta;
+
+        i = -1;
+        do {
+            i++;
+
+            // V(i+1) = A M^{-1} V(i), wnrm2 = ||V(i+1)||^2
+            if ( precond ) {
+                CHECK( magma_z_applyprecond_cpu( A, V(i), z, precond_par, queue ));
+                CHECK( magma_zspmv_dot_cpu( A, z, V(i+1), NULL, NULL, &wnrm2, queue ));
+            } else {
+                CHECK( magma_zspmv_dot_cpu( A, V(i), V(i+1), NULL, NULL, &wnrm2, queue ));
+            }
+            solver_par->numiter++;
+            solver_par->spmv_count++;
+
+            // H(0:i,i) = V(0:i)' V(i+1), V(i+1) = V(i+1) - V(0:i) H(0:i,i)
+            CHECK( magma_zmdotc_cpu( dofs, i+1, V(0), dofs, V(i+1), &H(0,i), queue ));
+            CHECK( magma_zmaxpy_cpu( dofs, i+1, V(0), dofs, &H(0,i), V(i+1), &nrm, queue ));
+            if ( nrm < GMRES_REORTH * sqrt( wnrm2 ) ) {
+                CHECK( magma_zmdotc_cpu( dofs, i+1, V(0), dofs, V(i+1), h, queue ));
+                CHECK( magma_zmaxpy_cpu( dofs, i+1, V(0), dofs, h, V(i+1), &nrm, queue ));
+                for (k = 0; k <= i; k++)
+                    H(k,i) += h[k];
+            }
+
+            H(i+1, i) = MAGMA_Z_MAKE( nrm, 0. );                   // H(i+1,i) = ||r||
+            if ( nrm > 0.0 ) {
+                // V(i+1) = V(i+1) / H(i+1, i)
+                temp = MAGMA_Z_ONE / H(i+1, i);
+                #pragma omp parallel for schedule(static)
+                for (magma_int_t l = 0; l < dofs; l++) {
+                    V(i+1)[l] = V(i+1)[l] * temp;
+                }
+            }
+
+            for (k = 0; k < i; k++)
+                ApplyPlaneRotation(&H(k,i), &H(k+1,i), cs[k], sn[k]);
+
+            GeneratePlaneRotation(H(i,i), H(i+1,i), &cs[i], &sn[i]);
+            ApplyPlaneRotation(&H(i,i), &H(i+1,i), cs[i], sn[i]);
+            ApplyPlaneRotation(&s[i], &s[i+1], cs[i], sn[i]);
+
+            betanom = MAGMA_Z_ABS( s[i+1] );
+            rel_resid = betanom / nomb;
+            if ( solver_par->verbose > 0 ) {
+                tempo2 = magma_wtime();
+                if ( (solver_par->numiter)%solver_par->verbose==0 ) {
+                    solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                            = (real_Double_t) betanom;
+                    solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                            = (real_Double_t) tempo2-tempo1;
+                }
+            }
+            if (rel_resid <= solver_par->rtol || betanom <= solver_par->atol
+                                              || nrm == 0.0 ){
+                info = MAGMA_SUCCESS;
+                break;
+            }
+        }
+        while (i+1 < dim && solver_par->numiter+1 <= solver_par->maxiter);
+
+        // solve upper triangular system in place
+        for (j = i; j >= 0; j--)
+        {
+            s[j] /= H(j,j);
+            for (k = j-1; k >= 0; k--)
+                s[k] -= H(k,j) * s[j];
+        }
+
+        // update the solution, x = x + M^{-1} V(0:i) s(0:i)
+        for (j = 0; j <= i; j++)
+            h[j] = -s[j];
+        if ( precond ) {
+            // z = V(0:i) s(0:i), V(i+1) = M^{-1} z is not needed anymore
+            magma_zfill_cpu( dofs, MAGMA_Z_ZERO, z, queue );
+            CHECK( magma_zmaxpy_cpu( dofs, i+1, V(0), dofs, h, z, NULL, queue ));
+            CHECK( magma_z_applyprecond_cpu( A, z, V(i+1), precond_par, queue ));
+            h[0] = MAGMA_Z_NEG_ONE;
+            CHECK( magma_zmaxpy_cpu( dofs, 1, V(i+1), dofs, h, x->val, NULL, queue ));
+        } else {
+            CHECK( magma_zmaxpy_cpu( dofs, i+1, V(0), dofs, h, x->val, NULL, queue ));
+        }
+    }
+    while (rel_resid > solver_par->rtol && betanom > solver_par->atol
+                && solver_par->numiter+1 <= solver_par->maxiter);
+
+    tempo2 = magma_wtime();
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    double residual;
+    CHECK( magma_zresidual_cpu( A, b.val, x->val, NULL, &residual, queue ));
+    solver_par->iter_res = betanom;
+    solver_par->final_res = residual;
+
+    if ( solver_par->numiter < solver_par->maxiter && info == MAGMA_SUCCESS ) {
+        info = MAGMA_SUCCESS;
+    } else if ( solver_par->init_res > solver_par->final_res ) {
+        if ( solver_par->verbose > 0 ) {
+            if ( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        info = MAGMA_SLOW_CONVERGENCE;
+        if( solver_par->iter_res < solver_par->rtol*nomb ||
+            solver_par->iter_res < solver_par->atol ) {
+            info = MAGMA_SUCCESS;
+        }
+    }
+    else {
+        if ( solver_par->verbose > 0 ) {
+            if ( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        info = MAGMA_DIVERGENCE;
+    }
+
+cleanup:
+    magma_free_cpu( H );
+    magma_free_cpu( h );
+    magma_free_cpu( s );
+    magma_free_cpu( cs );
+    magma_free_cpu( sn );
+    magma_free_cpu( V );
+    magma_free_cpu( z );
+
+    solver_par->info = info;
+    return info;
+} /* magma_zgmres_cpu */
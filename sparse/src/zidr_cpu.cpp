@@ -0,0 +1,512 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+
+#define RTOLERANCE     lapackf77_dlamch( "E" )
+#define ATOLERANCE     lapackf77_dlamch( "E" )
+
+// simulate 2-D arrays at the cost of some arithmetic
+#define P(k) (P+(k)*n)
+#define G(k) (G+(k)*n)
+#define U(k) (U+(k)*n)
+#define M(i,j) (M[(j)*s+(i)])
+
+
+/******************************************************************************/
+// v = r - G(:,k:s) c(k:s), U(:,k) = om * v + U(:,k:s) c(k:s)
+// in one pass over the rows. U(:,k) is part of the sum, each row reads it
+// before overwriting it. If Gk is NULL, v = r.
+static void
+idr_cpu_uk(
+    magma_int_t n, magma_int_t sk,
+    magmaDoubleComplex om, magmaDoubleComplex *c,
+    magmaDoubleComplex *r, magmaDoubleComplex *Gk, magmaDoubleComplex *Uk )
+{
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t l=0; l<n; l++ ){
+        magmaDoubleComplex v = r[l], u = MAGMA_Z_ZERO;
+        for( magma_int_t j=0; j<sk; j++ ){
+            if ( Gk != NULL ) {
+                v -= Gk[ l + j*n ] * c[j];
+            }
+            u += Uk[ l + j*n ] * c[j];
+        }
+        Uk[l] = om * v + u;
+    }
+}
+
+
+/******************************************************************************/
+// v = r - G(:,k:s) c(k:s), for the preconditioned variant where v is
+// preconditioned before it enters U(:,k).
+static void
+idr_cpu_v(
+    magma_int_t n, magma_int_t sk, magmaDoubleComplex *c,
+    magmaDoubleComplex *r, magmaDoubleComplex *Gk, magmaDoubleComplex *v )
+{
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t l=0; l<n; l++ ){
+        magmaDoubleComplex vl = r[l];
+        for( magma_int_t j=0; j<sk; j++ ){
+            vl -= Gk[ l + j*n ] * c[j];
+        }
+        v[l] = vl;
+    }
+}
+
+
+/******************************************************************************/
+// x = x + beta u, r = r - beta g, followed by the minimal residual
+// smoothing of (xs, rs): with t = rs - r, gamma = t' rs / t' t,
+// rs = rs - gamma t and xs = xs - gamma (xs - x). The first pass does the
+// updates, the two dot products and |r|, the second one the smoothing and
+// the norm of rs, which is returned. u may alias r.
+static double
+idr_cpu_update_smooth(
+    magma_int_t n, magmaDoubleComplex beta,
+    magmaDoubleComplex *u, magmaDoubleComplex *g,
+    magmaDoubleComplex *x, magmaDoubleComplex *r,
+    magmaDoubleComplex *xs, magmaDoubleComplex *rs,
+    double *nrmr )
+{
+    double tt = 0.0, trr = 0.0, tri = 0.0, rr = 0.0, nrm = 0.0;
+    magmaDoubleComplex gamma;
+
+    #pragma omp parallel for schedule(static) reduction(+:tt,trr,tri,rr)
+    for( magma_int_t l=0; l<n; l++ ){
+        magmaDoubleComplex xl = x[l] + beta * u[l];
+        magmaDoubleComplex rl = r[l] - beta * g[l];
+        magmaDoubleComplex t = rs[l] - rl;
+        magmaDoubleComplex p = MAGMA_Z_CONJ( t ) * rs[l];
+        x[l] = xl;
+        r[l] = rl;
+        rr  += MAGMA_Z_REAL( MAGMA_Z_CONJ( rl ) * rl );
+        tt  += MAGMA_Z_REAL( MAGMA_Z_CONJ( t ) * t );
+        trr += MAGMA_Z_REAL( p );
+        tri += MAGMA_Z_IMAG( p );
+    }
+    *nrmr = sqrt( rr );
+    gamma = ( tt > 0.0 ) ? MAGMA_Z_MAKE( trr/tt, tri/tt ) : MAGMA_Z_ZERO;
+
+    #pragma omp parallel for schedule(static) reduction(+:nrm)
+    for( magma_int_t l=0; l<n; l++ ){
+        magmaDoubleComplex rl = rs[l] - gamma * ( rs[l] - r[l] );
+        rs[l] = rl;
+        xs[l] = xs[l] - gamma * ( xs[l] - x[l] );
+        nrm += MAGMA_Z_REAL( MAGMA_Z_CONJ( rl ) * rl );
+    }
+    return sqrt( nrm );
+}
+
+
+/**
+    Purpose
+    -------
+
+    Solves a system of linear equations
+       A * X = B
+    where A is a general complex N-by-N matrix A stored in the CPU memory.
+    X and B are complex vectors stored in the CPU memory.
+    This is a CPU implementation of the Induced Dimension Reduction method
+    with residual smoothing, following magma_zidr. The shadow space
+    dimension is taken from solver_par->restart like there.
+
+    The basis updates of one shadow space step are fused into one pass over
+    the rows, and each solution and residual update is fused with the
+    smoothing dot products, so a step makes its SpMV and five more passes
+    plus the k dot products of the bi-orthogonalization.
+
+    If precond_par is given and not of type Magma_NONE, this is the
+    preconditioned IDR like magma_zpidr: v = r - G c is preconditioned with
+    magma_z_applyprecond_cpu before it enters U(:,k), and so is r in the
+    minimal residual step. A shadow space step then needs one more pass.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A, CSR on the CPU
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b, on the CPU
+
+    @param[in,out]
+    x           magma_z_matrix*
+                solution approximation, on the CPU
+
+    @param[in,out]
+    solver_par  magma_z_solver_par*
+                solver parameters
+
+    @param[in,out]
+    precond_par magma_z_preconditioner*
+                preconditioner, or NULL
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgesv
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zidr_cpu(
+    magma_z_matrix A, magma_z_matrix b, magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue )
+{
+    magma_int_t info = MAGMA_NOTCONVERGED;
+
+    bool precond = precond_par != NULL && precond_par->solver != Magma_NONE
+                                       && precond_par->solver != 0;
+
+    // prepare solver feedback
+    solver_par->solver = precond ? Magma_PIDRMERGE : Magma_IDRMERGE;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+    solver_par->init_res = 0.0;
+    solver_par->final_res = 0.0;
+    solver_par->iter_res = 0.0;
+    solver_par->runtime = 0.0;
+
+    // constants
+    const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+
+    // internal user parameters
+    const double angle = 0.7;          // [0-1]
+
+    // local variables
+    magma_int_t iseed[4] = {0, 0, 0, 1};
+    magma_int_t n = A.num_rows;
+    magma_int_t s, ione = 1;
+    magma_int_t distr, dof, lwork, linfo;
+    magma_int_t k, i, sk;
+    magma_int_t innerflag;
+    double residual;
+    double nrm = 0.0;
+    double nrmb;
+    double nrmr;
+    double nrmt;
+    double rho;
+    magmaDoubleComplex om;
+    magmaDoubleComplex tr;
+    magmaDoubleComplex alpha;
+    magmaDoubleComplex beta;
+
+    // matrices and vectors
+    magmaDoubleComplex *P=NULL, *G=NULL, *U=NULL, *M=NULL;
+    magmaDoubleComplex *f=NULL, *c=NULL, *tau=NULL, *work=NULL;
+    magmaDoubleComplex *r=NULL, *rs=NULL, *xs=NULL, *t=NULL, *v=NULL;
+
+    // chronometry
+    real_Double_t tempo1, tempo2;
+
+    // initial s space, same convention as magma_zidr
+    s = 1;
+    if ( solver_par->restart != 50 ) {
+        if ( solver_par->restart > A.num_cols ) {
+            s = A.num_cols;
+        } else {
+            s = solver_par->restart;
+        }
+    }
+    solver_par->restart = s;
+
+    // set max iterations
+    solver_par->maxiter = min( 2 * A.num_cols, solver_par->maxiter );
+
+    // check if matrix A is square
+    if ( A.num_rows != A.num_cols ) {
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    // CPU workspace, placed by first touch
+    CHECK( magma_zmalloc_cpu( &r,  n ));
+    CHECK( magma_zmalloc_cpu( &rs, n ));
+    CHECK( magma_zmalloc_cpu( &xs, n ));
+    CHECK( magma_zmalloc_cpu( &t,  n ));
+    CHECK( magma_zmalloc_cpu( &G,  n*s ));
+    CHECK( magma_zmalloc_cpu( &U,  n*s ));
+    CHECK( magma_zmalloc_cpu( &P,  n*s ));
+    CHECK( magma_zmalloc_cpu( &M,  s*s ));
+    CHECK( magma_zmalloc_cpu( &f,  s ));
+    CHECK( magma_zmalloc_cpu( &c,  s ));
+    CHECK( magma_zmalloc_cpu( &tau, s ));
+    magma_zfill_cpu( n, c_zero, t, queue );
+    magma_zfill_cpu( n*s, c_zero, G, queue );
+    magma_zfill_cpu( n*s, c_zero, U, queue );
+    magma_zfill_cpu( n*s, c_zero, P, queue );
+    if ( precond ) {
+        CHECK( magma_zmalloc_cpu( &v, n ));
+        magma_zfill_cpu( n, c_zero, v, queue );
+    }
+
+    // |b|
+    nrmb = magma_dznrm2_cpu( n, b.val, queue );
+    if ( nrmb == 0.0 ) {
+        magma_zfill_cpu( n, c_zero, x->val, queue );
+        info = MAGMA_SUCCESS;
+        goto cleanup;
+    }
+
+    // r = b - A x
+    CHECK( magma_zresidual_cpu( A, b.val, x->val, r, &nrmr, queue ));
+
+    // |r|
+    solver_par->init_res = nrmr;
+    solver_par->final_res = solver_par->init_res;
+    solver_par->iter_res = solver_par->init_res;
+    if ( solver_par->verbose > 0 ) {
+        solver_par->res_vec[0] = (real_Double_t)nrmr;
+    }
+
+    // check if initial is guess good enough
+    if ( nrmr <= solver_par->atol ||
+        nrmr/nrmb <= solver_par->rtol ) {
+        info = MAGMA_SUCCESS;
+        goto cleanup;
+    }
+
+    // P = randn(n, s), P = ortho(P)
+    distr = 3;        // 1 = unif (0,1), 2 = unif (-1,1), 3 = normal (0,1)
+    dof = n * s;
+    lapackf77_zlarnv( &distr, iseed, &dof, P );
+    lwork = -1;
+    lapackf77_zgeqrf( &n, &s, P, &n, tau, &alpha, &lwork, &linfo );
+    lwork = max( n*s, (magma_int_t) MAGMA_Z_REAL( alpha ) );
+    CHECK( magma_zmalloc_cpu( &work, lwork ));
+    lapackf77_zgeqrf( &n, &s, P, &n, tau, work, &lwork, &linfo );
+    lapackf77_zungqr( &n, &s, &s, P, &n, tau, work, &lwork, &linfo );
+    if ( linfo != 0 ) {
+        info = MAGMA_ERR;
+        goto cleanup;
+    }
+
+    // M(s,s) = I
+    for ( k = 0; k < s*s; ++k ) {
+        M[k] = c_zero;
+    }
+    for ( k = 0; k < s; ++k ) {
+        M(k,k) = MAGMA_Z_ONE;
+    }
+
+    // xs = x, rs = r
+    CHECK( magma_zcgmerge_d_cpu( n, c_zero, x->val, xs, queue ));
+    CHECK( magma_zcgmerge_d_cpu( n, c_zero, r, rs, queue ));
+
+    //--------------START TIME---------------
+    // chronometry
+    tempo1 = magma_wtime();
+    if ( solver_par->verbose > 0 ) {
+        solver_par->timing[0] = 0.0;
+    }
+
+    om = MAGMA_Z_ONE;
+    innerflag = 0;
+
+    // start iteration
+    do
+    {
+        solver_par->numiter++;
+
+        // new RHS for small systems
+        // f = P' r
+        CHECK( magma_zmdotc_cpu( n, s, P, n, r, f, queue ));
+
+        // shadow space loop
+        for ( k = 0; k < s; ++k ) {
+            sk = s - k;
+
+            // solve M(k:s,k:s) c(k:s) = f(k:s)
+            for ( i = k; i < s; ++i ) {
+                c[i] = f[i];
+            }
+            blasf77_ztrsv( "Lower", "NoTrans", "NonUnit", &sk, &M(k,k), &s, &c[k], &ione );
+
+            // v = r - G(:,k:s) c(k:s)
+            // U(:,k) = om * v + U(:,k:s) c(k:s)
+            if ( precond ) {
+                // v = M^{-1} ( r - G(:,k:s) c(k:s) ), t is free here
+                idr_cpu_v( n, sk, &c[k], r, G(k), t );
+                CHECK( magma_z_applyprecond_cpu( A, t, v, precond_par, queue ));
+                idr_cpu_uk( n, sk, om, &c[k], v, NULL, U(k) );
+            } else {
+                idr_cpu_uk( n, sk, om, &c[k], r, G(k), U(k) );
+            }
+
+            // G(:,k) = A U(:,k)
+            CHECK( magma_zspmv_dot_cpu( A, U(k), G(k), NULL, NULL, NULL, queue ));
+            solver_par->spmv_count++;
+
+            // bi-orthogonalize the new basis vectors
+            for ( i = 0; i < k; ++i ) {
+                // alpha = P(:,i)' G(:,k) / M(i,i)
+                CHECK( magma_zmdotc_cpu( n, 1, P(i), n, G(k), &alpha, queue ));
+                alpha = alpha / M(i,i);
+
+                // G(:,k) = G(:,k) - alpha * G(:,i)
+                // U(:,k) = U(:,k) - alpha * U(:,i)
+                magmaDoubleComplex *Gk = G(k), *Gi = G(i), *Uk = U(k), *Ui = U(i);
+                #pragma omp parallel for schedule(static)
+                for ( magma_int_t l = 0; l < n; ++l ) {
+                    Gk[l] -= alpha * Gi[l];
+                    Uk[l] -= alpha * Ui[l];
+                }
+            }
+
+            // new column of M = P'G, first k-1 entries are zero
+            // M(k:s,k) = P(:,k:s)' G(:,k)
+            CHECK( magma_zmdotc_cpu( n, sk, P(k), n, G(k), &M(k,k), queue ));
+
+            // check M(k,k) == 0
+            if ( MAGMA_Z_EQUAL( M(k,k), MAGMA_Z_ZERO ) ) {
+                innerflag = 1;
+                info = MAGMA_DIVERGENCE;
+                break;
+            }
+
+            // beta = f(k) / M(k,k)
+            beta = f[k] / M(k,k);
+
+            // check for nan
+            if ( magma_z_isnan( beta ) || magma_z_isinf( beta )) {
+                innerflag = 1;
+                info = MAGMA_DIVERGENCE;
+                break;
+            }
+
+            // r = r - beta * G(:,k), x = x + beta * U(:,k), smoothing
+            nrmr = idr_cpu_update_smooth( n, beta, U(k), G(k), x->val, r, xs, rs, &nrm );
+
+            // store current timing and residual
+            if ( solver_par->verbose > 0 ) {
+                tempo2 = magma_wtime();
+                if ( (solver_par->numiter) % solver_par->verbose == 0 ) {
+                    solver_par->res_vec[(solver_par->numiter) / solver_par->verbose]
+                            = (real_Double_t)nrmr;
+                    solver_par->timing[(solver_par->numiter) / solver_par->verbose]
+                            = (real_Double_t)tempo2 - tempo1;
+                }
+            }
+
+            // check convergence
+            if ( nrmr <= solver_par->atol ||
+                nrmr/nrmb <= solver_par->rtol ) {
+                innerflag = 2;
+                info = MAGMA_SUCCESS;
+                break;
+            }
+
+            // non-last s iteration
+            // f(k+1:s) = f(k+1:s) - beta * M(k+1:s,k)
+            for ( i = k+1; i < s; ++i ) {
+                f[i] = f[i] - beta * M(i,k);
+            }
+        }
+
+        // check convergence or iteration limit or invalid result of inner loop
+        if ( innerflag > 0 ) {
+            break;
+        }
+
+        // t = A v, with t' r and |t|, v = M^{-1} r or v = r
+        if ( precond ) {
+            CHECK( magma_z_applyprecond_cpu( A, r, v, precond_par, queue ));
+            CHECK( magma_zspmv_dot_cpu( A, v, t, r, &tr, &nrmt, queue ));
+        } else {
+            CHECK( magma_zspmv_dot_cpu( A, r, t, r, &tr, &nrmt, queue ));
+        }
+        solver_par->spmv_count++;
+        tr = MAGMA_Z_CONJ( tr );
+        nrmt = sqrt( nrmt );
+
+        // computation of a new omega
+        // rho = abs(t' * r) / (|t| * |r|))
+        rho = MAGMA_D_ABS( MAGMA_Z_REAL(tr) / (nrmt * nrm) );
+
+        // om = (t' * r) / (|t| * |t|)
+        om = tr / (nrmt * nrmt);
+        if ( rho < angle ) {
+            om = (om * angle) / rho;
+        }
+        if ( MAGMA_Z_EQUAL(om, MAGMA_Z_ZERO) || magma_z_isnan_inf( om ) ) {
+            info = MAGMA_DIVERGENCE;
+            break;
+        }
+
+        // x = x + om * v, r = r - om * t, smoothing
+        nrmr = idr_cpu_update_smooth( n, om, ( precond ? v : r ), t,
+                                      x->val, r, xs, rs, &nrm );
+
+        // store current timing and residual
+        if ( solver_par->verbose > 0 ) {
+            tempo2 = magma_wtime();
+            if ( (solver_par->numiter) % solver_par->verbose == 0 ) {
+                solver_par->res_vec[(solver_par->numiter) / solver_par->verbose]
+                        = (real_Double_t)nrmr;
+                solver_par->timing[(solver_par->numiter) / solver_par->verbose]
+                        = (real_Double_t)tempo2 - tempo1;
+            }
+        }
+
+        // check convergence
+        if ( nrmr <= solver_par->atol ||
+            nrmr/nrmb <= solver_par->rtol ) {
+            info = MAGMA_SUCCESS;
+            break;
+        }
+    }
+    while ( solver_par->numiter + 1 <= solver_par->maxiter );
+
+    // x = xs
+    CHECK( magma_zcgmerge_d_cpu( n, c_zero, xs, x->val, queue ));
+
+    // get last iteration timing
+    tempo2 = magma_wtime();
+    solver_par->runtime = (real_Double_t)tempo2 - tempo1;
+//--------------STOP TIME----------------
+
+    // get final stats
+    solver_par->iter_res = nrmr;
+    CHECK( magma_zresidual_cpu( A, b.val, x->val, r, &residual, queue ));
+    solver_par->final_res = residual;
+
+    // set solver conclusion
+    if ( info != MAGMA_SUCCESS && info != MAGMA_DIVERGENCE ) {
+        if ( solver_par->init_res > solver_par->final_res ) {
+            info = MAGMA_SLOW_CONVERGENCE;
+        }
+    }
+
+cleanup:
+    // free resources
+    magma_free_cpu( r );
+    magma_free_cpu( rs );
+    magma_free_cpu( xs );
+    magma_free_cpu( t );
+    magma_free_cpu( v );
+    magma_free_cpu( G );
+    magma_free_cpu( U );
+    magma_free_cpu( P );
+    magma_free_cpu( M );
+    magma_free_cpu( f );
+    magma_free_cpu( c );
+    magma_free_cpu( tau );
+    magma_free_cpu( work );
+
+    solver_par->info = info;
+    return info;
+    /* magma_zidr_cpu */
+}
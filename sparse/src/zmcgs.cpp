@@ -0,0 +1,452 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+/******************************************************************************/
+// adjacency of the symmetrized pattern of A, without the diagonal:
+// row i of G lists the columns of row i of A and the rows with an entry in
+// column i. Entries present in both A and A^T appear twice, which does not
+// matter for the coloring.
+static magma_int_t
+mcgs_graph(
+    magma_z_matrix A,
+    magma_index_t **Grow,
+    magma_index_t **Gcol )
+{
+    magma_int_t info = 0;
+    magma_int_t n = A.num_rows;
+    magma_index_t *pos = NULL;
+
+    CHECK( magma_index_malloc_cpu( Grow, n+1 ));
+    CHECK( magma_index_malloc_cpu( &pos, n+1 ));
+    for( magma_int_t i=0; i<n+1; i++ ){
+        pos[i] = 0;
+    }
+    for( magma_int_t i=0; i<n; i++ ){
+        for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+            magma_index_t j = A.col[k];
+            if( j != i ){
+                pos[i+1]++;
+                pos[j+1]++;
+            }
+        }
+    }
+    for( magma_int_t i=0; i<n; i++ ){
+        pos[i+1] += pos[i];
+    }
+    for( magma_int_t i=0; i<n+1; i++ ){
+        (*Grow)[i] = pos[i];
+    }
+    CHECK( magma_index_malloc_cpu( Gcol, max( pos[n], 1 ) ));
+    for( magma_int_t i=0; i<n; i++ ){
+        for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+            magma_index_t j = A.col[k];
+            if( j != i ){
+                (*Gcol)[ pos[i]++ ] = j;
+                (*Gcol)[ pos[j]++ ] = i;
+            }
+        }
+    }
+
+cleanup:
+    magma_free_cpu( pos );
+    return info;
+}
+
+
+/******************************************************************************/
+// Parallel speculative greedy coloring (Gebremedhin, Manne). All nodes of
+// the work list pick the smallest color not used in their distance-1 or
+// distance-2 neighbourhood, concurrently. Then every node that shares its
+// color with a smaller neighbour goes back to the work list; the rest is
+// final. Each thread flags forbidden colors with the current node index, so
+// the flag array never needs to be reset.
+static magma_int_t
+mcgs_color(
+    magma_int_t n,
+    magma_index_t *Grow,
+    magma_index_t *Gcol,
+    magma_int_t distance,
+    magma_index_t *color,
+    magma_int_t *num_colors )
+{
+    magma_int_t info = 0;
+    magma_int_t num_threads = 1, maxcolors = 1, nwork = n, ncolors = 0;
+    magma_index_t *work = NULL, *conflict = NULL, *forbidden = NULL;
+
+    #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    #endif
+    // a node has at most maxcolors-1 neighbours within the distance
+    for( magma_int_t i=0; i<n; i++ ){
+        magma_int_t deg = Grow[i+1] - Grow[i];
+        if( distance == 2 ){
+            for( magma_int_t k=Grow[i]; k<Grow[i+1]; k++ ){
+                deg += Grow[ Gcol[k]+1 ] - Grow[ Gcol[k] ];
+            }
+        }
+        maxcolors = max( maxcolors, deg+1 );
+    }
+    maxcolors = min( maxcolors, n+1 );
+
+    CHECK( magma_index_malloc_cpu( &work, max( n, 1 ) ));
+    CHECK( magma_index_malloc_cpu( &conflict, max( n, 1 ) ));
+    CHECK( magma_index_malloc_cpu( &forbidden, num_threads * maxcolors ));
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i<n; i++ ){
+        color[i] = -1;
+        work[i] = i;
+    }
+
+    while( nwork > 0 ){
+        // tentative coloring
+        #pragma omp parallel
+        {
+            magma_int_t tid = 0;
+            #ifdef _OPENMP
+            tid = omp_get_thread_num();
+            #endif
+            magma_index_t *mark = forbidden + tid * maxcolors;
+            for( magma_int_t c=0; c<maxcolors; c++ ){
+                mark[c] = -1;
+            }
+            #pragma omp for schedule(dynamic,256)
+            for( magma_int_t w=0; w<nwork; w++ ){
+                magma_index_t v = work[w];
+                for( magma_int_t k=Grow[v]; k<Grow[v+1]; k++ ){
+                    magma_index_t u = Gcol[k];
+                    if( color[u] >= 0 ){
+                        mark[ color[u] ] = v;
+                    }
+                    if( distance == 2 ){
+                        for( magma_int_t l=Grow[u]; l<Grow[u+1]; l++ ){
+                            magma_index_t t = Gcol[l];
+                            if( t != v && color[t] >= 0 ){
+                                mark[ color[t] ] = v;
+                            }
+                        }
+                    }
+                }
+                magma_index_t c = 0;
+                while( mark[c] == v ){
+                    c++;
+                }
+                color[v] = c;
+            }
+        }
+        // conflict detection, the larger index gives way
+        #pragma omp parallel for schedule(dynamic,256)
+        for( magma_int_t w=0; w<nwork; w++ ){
+            magma_index_t v = work[w];
+            magma_index_t clash = 0;
+            for( magma_int_t k=Grow[v]; k<Grow[v+1] && !clash; k++ ){
+                magma_index_t u = Gcol[k];
+                if( color[u] == color[v] && u < v ){
+                    clash = 1;
+                }
+                if( distance == 2 ){
+                    for( magma_int_t l=Grow[u]; l<Grow[u+1] && !clash; l++ ){
+                        magma_index_t t = Gcol[l];
+                        if( color[t] == color[v] && t < v ){
+                            clash = 1;
+                        }
+                    }
+                }
+            }
+            conflict[w] = clash;
+        }
+        magma_int_t nnew = 0;
+        for( magma_int_t w=0; w<nwork; w++ ){
+            if( conflict[w] ){
+                work[ nnew++ ] = work[w];
+            }
+        }
+        nwork = nnew;
+    }
+
+    for( magma_int_t i=0; i<n; i++ ){
+        ncolors = max( ncolors, color[i]+1 );
+    }
+    *num_colors = ncolors;
+
+cleanup:
+    magma_free_cpu( work );
+    magma_free_cpu( conflict );
+    magma_free_cpu( forbidden );
+    return info;
+}
+
+
+/******************************************************************************/
+// One Gauss-Seidel sweep over the colors first ... last (or last ... first
+// if last < first) of the color-permuted matrix M. The rows of a color do
+// not couple, so each color is updated in parallel; the loop over the row
+// computes the full residual, including the diagonal, which keeps it free
+// of branches.
+static void
+mcgs_sweep(
+    magma_z_matrix M,
+    magma_index_t *color_ptr,
+    magmaDoubleComplex *dinv,
+    magmaDoubleComplex *b,
+    magmaDoubleComplex *x,
+    magma_int_t first,
+    magma_int_t last )
+{
+    magma_int_t step = ( last >= first ) ? 1 : -1;
+
+    #pragma omp parallel
+    {
+        for( magma_int_t c=first; c != last+step; c+=step ){
+            #pragma omp for schedule(static)
+            for( magma_int_t i=color_ptr[c]; i<color_ptr[c+1]; i++ ){
+                magmaDoubleComplex r = b[i];
+                for( magma_int_t k=M.row[i]; k<M.row[i+1]; k++ ){
+                    r -= M.val[k] * x[ M.col[k] ];
+                }
+                x[i] += dinv[i] * r;
+            }
+        }
+    }
+}
+
+
+/**
+    Purpose
+    -------
+
+    Prepares the multicolor Gauss-Seidel preconditioner (precond->solver
+    Magma_GS) or symmetric Gauss-Seidel preconditioner (Magma_SGS) on the
+    CPU.
+
+    The graph of the symmetrized pattern of A is colored in parallel, with
+    distance-1 coloring, or distance-2 coloring if precond->levels is 2.
+    The rows are then permuted once such that each color forms a contiguous
+    block, and the permuted matrix is stored in precond->M, CSR on the CPU.
+    Rows of the same color do not couple, so the sweep over one color is
+    fully parallel.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A
+
+    @param[in]
+    b           magma_z_matrix
+                input RHS b
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmcgssetup(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR};
+    magma_index_t *Grow = NULL, *Gcol = NULL, *color = NULL, *iperm = NULL;
+    magma_int_t n, ncolors = 0;
+
+    CHECK( magma_zmtransfer( A, &hA, A.memory_location, Magma_CPU, queue ));
+    CHECK( magma_zmconvert( hA, &CSRA, hA.storage_type, Magma_CSR, queue ));
+    n = CSRA.num_rows;
+
+    // coloring
+    CHECK( magma_index_malloc_cpu( &color, max( n, 1 ) ));
+    CHECK( mcgs_graph( CSRA, &Grow, &Gcol ));
+    CHECK( mcgs_color( n, Grow, Gcol, ( precond->levels == 2 ) ? 2 : 1,
+                       color, &ncolors ));
+
+    // color-contiguous permutation
+    CHECK( magma_index_malloc_cpu( &precond->color_ptr, ncolors+1 ));
+    CHECK( magma_index_malloc_cpu( &precond->perm, max( n, 1 ) ));
+    CHECK( magma_index_malloc_cpu( &iperm, max( n, 1 ) ));
+    for( magma_int_t c=0; c<ncolors+1; c++ ){
+        precond->color_ptr[c] = 0;
+    }
+    for( magma_int_t i=0; i<n; i++ ){
+        precond->color_ptr[ color[i]+1 ]++;
+    }
+    for( magma_int_t c=0; c<ncolors; c++ ){
+        precond->color_ptr[c+1] += precond->color_ptr[c];
+    }
+    for( magma_int_t i=0; i<n; i++ ){
+        magma_index_t pos = precond->color_ptr[ color[i] ]++;
+        precond->perm[pos] = i;
+        iperm[i] = pos;
+    }
+    for( magma_int_t c=ncolors; c>0; c-- ){
+        precond->color_ptr[c] = precond->color_ptr[c-1];
+    }
+    precond->color_ptr[0] = 0;
+    precond->colors = ncolors;
+
+    // M = P A P^T, with the inverse of its diagonal
+    precond->M.storage_type    = Magma_CSR;
+    precond->M.memory_location = Magma_CPU;
+    precond->M.fill_mode       = MagmaFull;
+    precond->M.num_rows        = n;
+    precond->M.num_cols        = n;
+    precond->M.nnz             = CSRA.nnz;
+    precond->M.true_nnz        = CSRA.nnz;
+    CHECK( magma_index_malloc_cpu( &precond->M.row, n+1 ));
+    CHECK( magma_index_malloc_cpu( &precond->M.col, max( CSRA.nnz, 1 ) ));
+    CHECK( magma_zmalloc_cpu( &precond->M.val, max( CSRA.nnz, 1 ) ));
+    CHECK( magma_zmalloc_cpu( &precond->dinv, max( n, 1 ) ));
+    CHECK( magma_zmalloc_cpu( &precond->hwork, 2*max( n, 1 ) ));
+    precond->M.row[0] = 0;
+    for( magma_int_t i=0; i<n; i++ ){
+        magma_index_t old = precond->perm[i];
+        precond->M.row[i+1] = precond->M.row[i] + CSRA.row[old+1] - CSRA.row[old];
+    }
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i<n; i++ ){
+        magma_index_t old = precond->perm[i];
+        magma_index_t pos = precond->M.row[i];
+        precond->dinv[i] = MAGMA_Z_ZERO;
+        precond->hwork[i] = MAGMA_Z_ZERO;
+        precond->hwork[n+i] = MAGMA_Z_ZERO;
+        for( magma_int_t k=CSRA.row[old]; k<CSRA.row[old+1]; k++ ){
+            precond->M.col[pos] = iperm[ CSRA.col[k] ];
+            precond->M.val[pos] = CSRA.val[k];
+            if( CSRA.col[k] == old && MAGMA_Z_ABS( CSRA.val[k] ) > 0.0 ){
+                precond->dinv[i] = MAGMA_Z_ONE / CSRA.val[k];
+            }
+            pos++;
+        }
+    }
+    CHECK( magma_zcsr_segsort( n, precond->M.row, precond->M.col, precond->M.val, queue ));
+    precond->spmv_count = 0;
+
+cleanup:
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &CSRA, queue );
+    magma_free_cpu( Grow );
+    magma_free_cpu( Gcol );
+    magma_free_cpu( color );
+    magma_free_cpu( iperm );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Applies the multicolor Gauss-Seidel preconditioner: precond->sweeps
+    sweeps on M x = b, starting from x = 0. For Magma_SGS each sweep is a
+    forward sweep over the colors followed by a backward sweep, which makes
+    the preconditioner symmetric, so it can be used with CG. The sweeps run
+    on the CPU; vectors on the device are copied to and from the CPU.
+
+    The number of sweeps is accumulated in precond->spmv_count.
+
+    Arguments
+    ---------
+
+    @param[in]
+    b           magma_z_matrix
+                RHS
+
+    @param[out]
+    x           magma_z_matrix*
+                vector to precondition
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zapplymcgs(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t n = precond->M.num_rows;
+    magma_int_t sweeps = ( precond->sweeps > 0 ) ? precond->sweeps : 1;
+    magmaDoubleComplex *hb, *hx;
+
+    if( precond->perm == NULL || precond->hwork == NULL ){
+        return MAGMA_ERR_NOT_INITIALIZED;
+    }
+    hb = precond->hwork;
+    hx = precond->hwork + n;
+
+    // hb = P b, hx = 0
+    if( b.memory_location == Magma_DEV ){
+        magma_zgetvector( n, b.dval, 1, hx, 1, queue );
+        #pragma omp parallel for schedule(static)
+        for( magma_int_t i=0; i<n; i++ ){
+            hb[i] = hx[ precond->perm[i] ];
+            hx[ precond->perm[i] ] = MAGMA_Z_ZERO;
+        }
+    } else {
+        #pragma omp parallel for schedule(static)
+        for( magma_int_t i=0; i<n; i++ ){
+            hb[i] = b.val[ precond->perm[i] ];
+            hx[i] = MAGMA_Z_ZERO;
+        }
+    }
+
+    for( magma_int_t k=0; k<sweeps; k++ ){
+        mcgs_sweep( precond->M, precond->color_ptr, precond->dinv, hb, hx,
+                    0, precond->colors-1 );
+        precond->spmv_count++;
+        if( precond->solver == Magma_SGS ){
+            mcgs_sweep( precond->M, precond->color_ptr, precond->dinv, hb, hx,
+                        precond->colors-1, 0 );
+            precond->spmv_count++;
+        }
+    }
+
+    // x = P^T hx
+    if( x->memory_location == Magma_DEV ){
+        #pragma omp parallel for schedule(static)
+        for( magma_int_t i=0; i<n; i++ ){
+            hb[ precond->perm[i] ] = hx[i];
+        }
+        magma_zsetvector( n, hb, 1, x->dval, 1, queue );
+    } else {
+        #pragma omp parallel for schedule(static)
+        for( magma_int_t i=0; i<n; i++ ){
+            x->val[ precond->perm[i] ] = hx[i];
+        }
+    }
+
+    return info;
+}
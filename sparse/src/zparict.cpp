@@ -80,7 +80,7 @@ magma_zparict(
     real_Double_t start, end;
     real_Double_t t_rm=0.0, t_add=0.0, t_res=0.0, t_sweep1=0.0, t_sweep2=0.0, t_cand=0.0,
                     t_transpose1=0.0, t_transpose2=0.0, t_selectrm=0.0,
-                    t_selectadd=0.0, t_nrm=0.0, t_total = 0.0, accum=0.0;
+                    t_selectadd=0.0, t_nrm=0.0, t_map=0.0, t_total = 0.0, accum=0.0;
                     
     double sum, sumL;//, sumU, thrsL_old=1e9, thrsU_old=1e9;
 
@@ -90,6 +90,11 @@ magma_zparict(
     magma_z_matrix L0={Magma_CSR};  
     magma_int_t num_rmL;
     double thrsL = 0.0;
+    // position of the L entries in A, the work space to compute it,
+    // and the value buffer of the sweeps
+    magma_index_t *map = NULL, *marker = NULL;
+    magmaDoubleComplex *buffer = NULL;
+    magma_int_t map_size = 0, marker_size = 0, buffer_size = 0;
 
     magma_int_t num_threads, timing = 1; // print timing
     magma_int_t L0nnz;
@@ -120,7 +125,7 @@ magma_zparict(
     if (timing == 1) {
         printf("ilut_fill_ratio = %.6f;\n\n", precond->atol ); 
 
-        printf("performance_%d = [\n%%iter L.nnz U.nnz    ILU-Norm     candidat  resid     ILU-norm  selectad  add       transp1   sweep1    selectrm  remove    sweep2    transp2   total       accum\n", (int) num_threads);
+        printf("performance_%d = [\n%%iter L.nnz U.nnz    ILU-Norm     candidat  resid     ILU-norm  selectad  add       transp1   map       sweep1    selectrm  remove    sweep2    transp2   total       accum\n", (int) num_threads);
     }
 
     //##########################################################################
@@ -128,7 +133,7 @@ magma_zparict(
     for( magma_int_t iters =0; iters<precond->sweeps; iters++ ) {
     t_rm=0.0; t_add=0.0; t_res=0.0; t_sweep1=0.0; t_sweep2=0.0; t_cand=0.0;
                         t_transpose1=0.0; t_transpose2=0.0; t_selectrm=0.0;
-                        t_selectadd=0.0; t_nrm=0.0; t_total = 0.0;
+                        t_selectadd=0.0; t_nrm=0.0; t_map=0.0; t_total = 0.0;
      
         num_rmL = max( (L_new.nnz-L0nnz*(1+precond->atol*(iters+1)/precond->sweeps)), 0 );
         start = magma_sync_wtime( queue );
@@ -137,10 +142,7 @@ magma_zparict(
         end = magma_sync_wtime( queue ); t_transpose1+=end-start;
         start = magma_sync_wtime( queue ); 
         magma_zparict_candidates( L0, L, LT, &hL, queue );
-        #pragma omp parallel        
-        for(int row=0; row<hL.num_rows; row++){
-            magma_zindexsort( &hL.col[hL.row[row]], 0, hL.row[row+1]-hL.row[row]-1, queue );
-        }
+        CHECK( magma_zcsr_segsort( hL.num_rows, hL.row, hL.col, NULL, queue ));
         end = magma_sync_wtime( queue ); t_cand=+end-start;
         
         start = magma_sync_wtime( queue );
@@ -157,7 +159,10 @@ magma_zparict(
         magma_zmfree( &hL, queue );
        
         start = magma_sync_wtime( queue );
-         CHECK( magma_zparict_sweep_sync( &A0, &L_new, queue ) );
+        CHECK( magma_zparict_map( A0, L_new, &map, &map_size, &marker, &marker_size, queue ) );
+        end = magma_sync_wtime( queue ); t_map+=end-start;
+        start = magma_sync_wtime( queue );
+        CHECK( magma_zparict_sweep_map( A0, &L_new, map, &buffer, &buffer_size, queue ) );
         end = magma_sync_wtime( queue ); t_sweep1+=end-start;
         num_rmL = max( (L_new.nnz-L0nnz*(1+(precond->atol-1.)*(iters+1)/precond->sweeps)), 0 );
         start = magma_sync_wtime( queue );
@@ -179,15 +184,18 @@ magma_zparict(
         end = magma_sync_wtime( queue ); t_rm=end-start;
         
         start = magma_sync_wtime( queue );
-        CHECK( magma_zparict_sweep_sync( &A0, &L, queue ) );
+        CHECK( magma_zparict_map( A0, L, &map, &map_size, &marker, &marker_size, queue ) );
+        end = magma_sync_wtime( queue ); t_map+=end-start;
+        start = magma_sync_wtime( queue );
+        CHECK( magma_zparict_sweep_map( A0, &L, map, &buffer, &buffer_size, queue ) );
         end = magma_sync_wtime( queue ); t_sweep2+=end-start;
 
         if( timing == 1 ){
-            t_total = t_cand+t_res+t_nrm+t_selectadd+t_add+t_transpose1+t_sweep1+t_selectrm+t_rm+t_sweep2+t_transpose2;
+            t_total = t_cand+t_res+t_nrm+t_selectadd+t_add+t_transpose1+t_map+t_sweep1+t_selectrm+t_rm+t_sweep2+t_transpose2;
             accum = accum + t_total;
-            printf("%5lld %5lld %5lld  %.4e   %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e    %.2e\n",
+            printf("%5lld %5lld %5lld  %.4e   %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e    %.2e\n",
                     (long long) iters, (long long) L.nnz, (long long) L.nnz, (double) sum, 
-                    t_cand, t_res, t_nrm, t_selectadd, t_add, t_transpose1, t_sweep1, t_selectrm, t_rm, t_sweep2, t_transpose2, t_total, accum );
+                    t_cand, t_res, t_nrm, t_selectadd, t_add, t_transpose1, t_map, t_sweep1, t_selectrm, t_rm, t_sweep2, t_transpose2, t_total, accum );
             fflush(stdout);
         }
     }
@@ -249,6 +257,9 @@ magma_zparict(
     magma_zmfree( &hL, queue );
     magma_zmfree( &L, queue );
     magma_zmfree( &L_new, queue );
+    magma_free_cpu( map );
+    magma_free_cpu( marker );
+    magma_free_cpu( buffer );
 #endif
     return info;
 }
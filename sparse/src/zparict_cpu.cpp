@@ -79,7 +79,7 @@ magma_zparict_cpu(
     real_Double_t start, end;
     real_Double_t t_rm=0.0, t_add=0.0, t_res=0.0, t_sweep1=0.0, t_sweep2=0.0, 
         t_cand=0.0, t_transpose1=0.0, t_transpose2=0.0, t_selectrm=0.0,
-        t_selectadd=0.0, t_nrm=0.0, t_total = 0.0, accum=0.0;
+        t_selectadd=0.0, t_nrm=0.0, t_map=0.0, t_total = 0.0, accum=0.0;
                     
     double sum, sumL;
 
@@ -88,6 +88,11 @@ magma_zparict_cpu(
         L={Magma_CSR}, L_new={Magma_CSR}, L0={Magma_CSR};  
     magma_int_t num_rmL;
     double thrsL = 0.0;
+    // position of the L entries in A, the work space to compute it,
+    // and the value buffer of the sweeps
+    magma_index_t *map = NULL, *marker = NULL;
+    magmaDoubleComplex *buffer = NULL;
+    magma_int_t map_size = 0, marker_size = 0, buffer_size = 0;
 
     magma_int_t num_threads = 1, timing = 1; // 1 = print timing
     magma_int_t L0nnz;
@@ -112,7 +117,7 @@ magma_zparict_cpu(
     if (timing == 1) {
         printf("ilut_fill_ratio = %.6f;\n\n", precond->atol); 
 
-        printf("performance_%d = [\n%%iter L.nnz U.nnz    ILU-Norm     candidat  resid     ILU-norm  selectad  add       transp1   sweep1    selectrm  remove    sweep2    transp2   total       accum\n", (int) num_threads);
+        printf("performance_%d = [\n%%iter L.nnz U.nnz    ILU-Norm     candidat  resid     ILU-norm  selectad  add       transp1   map       sweep1    selectrm  remove    sweep2    transp2   total       accum\n", (int) num_threads);
     }
 
     //##########################################################################
@@ -120,7 +125,7 @@ magma_zparict_cpu(
     for (magma_int_t iters =0; iters<precond->sweeps; iters++) {
         t_rm=0.0; t_add=0.0; t_res=0.0; t_sweep1=0.0; t_sweep2=0.0; t_cand=0.0;
         t_transpose1=0.0; t_transpose2=0.0; t_selectrm=0.0;
-        t_selectadd=0.0; t_nrm=0.0; t_total = 0.0;
+        t_selectadd=0.0; t_nrm=0.0; t_map=0.0; t_total = 0.0;
 
         // step 1: find candidates
         start = magma_sync_wtime(queue);
@@ -151,7 +156,10 @@ magma_zparict_cpu(
 
         // step 4: sweep
         start = magma_sync_wtime(queue);
-        CHECK(magma_zparict_sweep_sync(&hA, &L_new, queue));
+        CHECK(magma_zparict_map(hA, L_new, &map, &map_size, &marker, &marker_size, queue));
+        end = magma_sync_wtime(queue); t_map+=end-start;
+        start = magma_sync_wtime(queue);
+        CHECK(magma_zparict_sweep_map(hA, &L_new, map, &buffer, &buffer_size, queue));
         end = magma_sync_wtime(queue); t_sweep1+=end-start;
 
         // step 5: select threshold to remove elements
@@ -178,17 +186,20 @@ magma_zparict_cpu(
         
         // step 7: sweep
         start = magma_sync_wtime(queue);
-        CHECK(magma_zparict_sweep_sync(&hA, &L, queue));
+        CHECK(magma_zparict_map(hA, L, &map, &map_size, &marker, &marker_size, queue));
+        end = magma_sync_wtime(queue); t_map+=end-start;
+        start = magma_sync_wtime(queue);
+        CHECK(magma_zparict_sweep_map(hA, &L, map, &buffer, &buffer_size, queue));
         end = magma_sync_wtime(queue); t_sweep2+=end-start;
 
         if (timing == 1) {
             t_total = t_cand+t_res+t_nrm+t_selectadd+t_add+t_transpose1
-            +t_sweep1+t_selectrm+t_rm+t_sweep2+t_transpose2;
+            +t_map+t_sweep1+t_selectrm+t_rm+t_sweep2+t_transpose2;
             accum = accum + t_total;
-            printf("%5lld %5lld %5lld  %.4e   %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e    %.2e\n",
+            printf("%5lld %5lld %5lld  %.4e   %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e    %.2e\n",
                     (long long) iters, (long long) L.nnz, (long long) L.nnz, 
                     (double) sum, t_cand, t_res, t_nrm, t_selectadd, t_add, 
-                    t_transpose1, t_sweep1, t_selectrm, t_rm, t_sweep2, 
+                    t_transpose1, t_map, t_sweep1, t_selectrm, t_rm, t_sweep2, 
                     t_transpose2, t_total, accum);
             fflush(stdout);
         }
@@ -229,6 +240,9 @@ cleanup:
     magma_zmfree(&L, queue);
     magma_zmfree(&LT, queue);
     magma_zmfree(&L_new, queue);
+    magma_free_cpu(map);
+    magma_free_cpu(marker);
+    magma_free_cpu(buffer);
 #endif
     return info;
 }
@@ -111,6 +111,8 @@ magma_zparilu_cpu(
 
     CHECK(magma_zmtransfer(hAL, &precond->L, Magma_CPU, Magma_DEV, queue));
     CHECK(magma_zmtransfer(hAUT, &precond->U, Magma_CPU, Magma_DEV, queue));
+    // keep the symbolic data for magma_zparilu_refresh
+    CHECK(magma_zparilu_refresh_setup(A, hAL, hAU, precond, queue));
     
     if (precond->trisolver == 0 || precond->trisolver == Magma_CUSOLVE) {
         CHECK(magma_zcumilugeneratesolverinfo(precond, queue));
@@ -109,6 +109,8 @@ magma_zparilu_gpu(
 
     CHECK(magma_zmtransfer(dAL, &precond->L, Magma_DEV, Magma_DEV, queue));
     CHECK(magma_zmtransfer(dAUT, &precond->U, Magma_DEV, Magma_DEV, queue));
+    // keep the symbolic data for magma_zparilu_refresh
+    CHECK(magma_zparilu_refresh_setup(A, dAL, dAU, precond, queue));
     
     if (precond->trisolver == 0 || precond->trisolver == Magma_CUSOLVE) {
         CHECK(magma_zcumilugeneratesolverinfo(precond, queue));
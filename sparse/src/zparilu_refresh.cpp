@@ -0,0 +1,393 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+#include "../blas/magma_trisolve.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define PRECISION_z
+#define SWAP(a, b)  { val_swap = a; a = b; b = val_swap; }
+
+
+/******************************************************************************/
+// Position of the entry (row,col) in the sorted CSR matrix A, -1 if A has no
+// entry in this location.
+static magma_index_t
+parilu_find(
+    magma_z_matrix A,
+    magma_index_t row,
+    magma_index_t col )
+{
+    magma_index_t lo = A.row[row], hi = A.row[row+1]-1;
+    while( lo <= hi ){
+        magma_index_t mid = lo + (hi-lo)/2;
+        if( A.col[mid] == col ){
+            return mid;
+        } else if( A.col[mid] < col ){
+            lo = mid+1;
+        } else {
+            hi = mid-1;
+        }
+    }
+    return -1;
+}
+
+
+/******************************************************************************/
+// One synchronous ParILU sweep on the fixed patterns of L (CSR) and U (CSC,
+// stored as U^T in CSR), both with row index. The values of A are read
+// through the precomputed positions Lmap and Umap, instead of searching the
+// rows of A as magma_zparilut_sweep_sync does.
+static magma_int_t
+parilu_refresh_sweep(
+    magmaDoubleComplex *Aval,
+    magma_z_matrix *L,
+    magma_z_matrix *U,
+    magma_index_t *Lmap,
+    magma_index_t *Umap,
+    magmaDoubleComplex *Lnew,
+    magmaDoubleComplex *Unew )
+{
+    #pragma omp parallel for
+    for (magma_int_t e=0; e<U->nnz; e++) {
+        magma_index_t row = U->col[ e ];
+        magma_index_t col = U->rowidx[ e ];
+        magmaDoubleComplex A_e = ( Umap[e] >= 0 ) ? Aval[ Umap[e] ] : MAGMA_Z_ZERO;
+        magma_int_t i = L->row[ row ], endi = L->row[ row+1 ];
+        magma_int_t j = U->row[ col ], endj = U->row[ col+1 ];
+        magmaDoubleComplex sum = MAGMA_Z_ZERO, lsum = MAGMA_Z_ZERO;
+        do {
+            lsum = MAGMA_Z_ZERO;
+            magma_index_t icol = L->col[i], jcol = U->col[j];
+            if (icol == jcol) {
+                lsum = L->val[i] * U->val[j];
+                sum = sum + lsum;
+                i++;
+                j++;
+            } else if (icol < jcol) {
+                i++;
+            } else {
+                j++;
+            }
+        } while (i < endi && j < endj);
+        // the last product is L(row,row) U(row,col) itself
+        Unew[ e ] = A_e - (sum - lsum);
+    }
+
+    #pragma omp parallel for
+    for (magma_int_t e=0; e<L->nnz; e++) {
+        magma_index_t row = L->rowidx[ e ];
+        magma_index_t col = L->col[ e ];
+        if (row == col) {
+            Lnew[ e ] = MAGMA_Z_ONE;
+            continue;
+        }
+        magmaDoubleComplex A_e = ( Lmap[e] >= 0 ) ? Aval[ Lmap[e] ] : MAGMA_Z_ZERO;
+        magma_int_t i = L->row[ row ], endi = L->row[ row+1 ];
+        magma_int_t j = U->row[ col ], endj = U->row[ col+1 ], jold = j;
+        magmaDoubleComplex sum = MAGMA_Z_ZERO, lsum = MAGMA_Z_ZERO;
+        do {
+            lsum = MAGMA_Z_ZERO;
+            jold = j;
+            magma_index_t icol = L->col[i], jcol = U->col[j];
+            if (icol == jcol) {
+                lsum = L->val[i] * Unew[j];
+                sum = sum + lsum;
+                i++;
+                j++;
+            } else if (icol < jcol) {
+                i++;
+            } else {
+                j++;
+            }
+        } while (i < endi && j < endj);
+        // the last product is L(row,col) U(col,col), jold points to U(col,col)
+        Lnew[ e ] = (A_e - (sum - lsum)) / Unew[ jold ];
+    }
+
+    return MAGMA_SUCCESS;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+
+    Keeps the symbolic data of a ParILU or ParILUT factorization for later
+    numeric refactorizations with magma_zparilu_refresh: CPU copies of the
+    factors L and U with their row indices, the position of every entry of
+    the factors in A, and the position of every entry of U in precond->U.
+    It is called by the ParILU and ParILUT setup routines once the final
+    pattern is known and precond->L, precond->U are generated.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                system matrix the factorization was generated for, sorted CSR
+
+    @param[in]
+    L           magma_z_matrix
+                lower triangular factor, CSR, unit diagonal stored
+
+    @param[in]
+    U           magma_z_matrix
+                upper triangular factor in CSC, i.e., U^T in CSR
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+*******************************************************************************/
+extern "C"
+magma_int_t
+magma_zparilu_refresh_setup(
+    magma_z_matrix A,
+    magma_z_matrix L,
+    magma_z_matrix U,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue)
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hAT={Magma_CSR}, hA={Magma_CSR};
+    magma_index_t *ptr = NULL;
+
+    if (A.memory_location != Magma_CPU || A.storage_type != Magma_CSR) {
+        CHECK(magma_zmtransfer(A, &hAT, A.memory_location, Magma_CPU, queue));
+        CHECK(magma_zmconvert(hAT, &hA, hAT.storage_type, Magma_CSR, queue));
+    } else {
+        hA = A;
+    }
+    CHECK(magma_zmtransfer(L, &precond->symL, L.memory_location, Magma_CPU, queue));
+    CHECK(magma_zmtransfer(U, &precond->symU, U.memory_location, Magma_CPU, queue));
+    // CSR plus row index
+    precond->symL.storage_type = Magma_CSRCOO;
+    precond->symU.storage_type = Magma_CSRCOO;
+    magma_free_cpu(precond->symL.rowidx);
+    magma_free_cpu(precond->symU.rowidx);
+    precond->symL.rowidx = NULL;
+    precond->symU.rowidx = NULL;
+    CHECK(magma_zmatrix_addrowindex(&precond->symL, queue));
+    CHECK(magma_zmatrix_addrowindex(&precond->symU, queue));
+
+    CHECK(magma_index_malloc_cpu(&precond->symLA, max(precond->symL.nnz, 1)));
+    CHECK(magma_index_malloc_cpu(&precond->symUA, max(precond->symU.nnz, 1)));
+    CHECK(magma_index_malloc_cpu(&precond->symUT, max(precond->symU.nnz, 1)));
+    precond->symnnz = hA.nnz;
+
+    // positions in A; the entry e of U^T is U(col,rowidx)
+    #pragma omp parallel for
+    for (magma_int_t e=0; e<precond->symL.nnz; e++) {
+        precond->symLA[e] = parilu_find(hA, precond->symL.rowidx[e],
+                                        precond->symL.col[e]);
+    }
+    #pragma omp parallel for
+    for (magma_int_t e=0; e<precond->symU.nnz; e++) {
+        precond->symUA[e] = parilu_find(hA, precond->symU.col[e],
+                                        precond->symU.rowidx[e]);
+    }
+
+    // positions in precond->U, the sorted CSR transpose of U^T: a counting
+    // sort over the rows of U^T reproduces its order
+    CHECK(magma_index_malloc_cpu(&ptr, precond->symU.num_cols+1));
+    for (magma_int_t i=0; i<=precond->symU.num_cols; i++) {
+        ptr[i] = 0;
+    }
+    for (magma_int_t e=0; e<precond->symU.nnz; e++) {
+        ptr[ precond->symU.col[e]+1 ]++;
+    }
+    for (magma_int_t i=0; i<precond->symU.num_cols; i++) {
+        ptr[i+1] += ptr[i];
+    }
+    for (magma_int_t e=0; e<precond->symU.nnz; e++) {
+        precond->symUT[e] = ptr[ precond->symU.col[e] ]++;
+    }
+
+cleanup:
+    if (hA.val != A.val) {
+        magma_zmfree(&hA, queue);
+    }
+    magma_zmfree(&hAT, queue);
+    magma_free_cpu(ptr);
+    if (info != 0) {
+        magma_zparilu_refresh_free( precond, queue );
+    }
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+
+    Numeric refactorization of a ParILU or ParILUT preconditioner for a
+    matrix A with new values but the pattern of the matrix used in the setup.
+    The symbolic data kept by magma_zparilu_refresh_setup is reused: no
+    transposes, pattern analysis, candidate search or threshold selection
+    are done, only precond->sweeps fixed-point sweeps on the frozen pattern,
+    starting from the previous factors. Afterwards, the values of precond->L
+    and precond->U are updated in place, and the data of the triangular
+    solves is regenerated (cuSPARSE analysis or the diagonals for the
+    iterative solves).
+
+    Returns MAGMA_ERR_NOT_SUPPORTED if there is no symbolic data, or the
+    number of nonzeros of A changed; then a full setup is needed.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                system matrix with updated values, same pattern as in setup
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+*******************************************************************************/
+extern "C"
+magma_int_t
+magma_zparilu_refresh(
+    magma_z_matrix A,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue)
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hAT={Magma_CSR}, hA={Magma_CSR};
+    magmaDoubleComplex *Aval = NULL, *Aval_tmp = NULL;
+    magmaDoubleComplex *Lnew = NULL, *Unew = NULL, *Uval = NULL, *val_swap = NULL;
+    magma_int_t sweeps = max(precond->sweeps, 1);
+
+    if (precond->symLA == NULL || precond->symUA == NULL ||
+        precond->L.nnz != precond->symL.nnz ||
+        precond->U.nnz != precond->symU.nnz ||
+        A.nnz != precond->symnnz) {
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    // values of A on the CPU
+    if (A.storage_type == Magma_CSR && A.memory_location == Magma_CPU) {
+        Aval = A.val;
+    } else if (A.storage_type == Magma_CSR && A.memory_location == Magma_DEV) {
+        CHECK(magma_zmalloc_cpu(&Aval_tmp, A.nnz));
+        magma_zgetvector(A.nnz, A.dval, 1, Aval_tmp, 1, queue);
+        Aval = Aval_tmp;
+    } else {
+        CHECK(magma_zmtransfer(A, &hAT, A.memory_location, Magma_CPU, queue));
+        CHECK(magma_zmconvert(hAT, &hA, hAT.storage_type, Magma_CSR, queue));
+        Aval = hA.val;
+    }
+
+    CHECK(magma_zmalloc_cpu(&Lnew, max(precond->symL.nnz, 1)));
+    CHECK(magma_zmalloc_cpu(&Unew, max(precond->symU.nnz, 1)));
+    CHECK(magma_zmalloc_cpu(&Uval, max(precond->symU.nnz, 1)));
+    for (magma_int_t i=0; i<sweeps; i++) {
+        parilu_refresh_sweep(Aval, &precond->symL, &precond->symU,
+                             precond->symLA, precond->symUA, Lnew, Unew);
+        SWAP(Lnew, precond->symL.val);
+        SWAP(Unew, precond->symU.val);
+    }
+
+    // new values of precond->L and precond->U
+    #pragma omp parallel for
+    for (magma_int_t e=0; e<precond->symU.nnz; e++) {
+        Uval[ precond->symUT[e] ] = precond->symU.val[e];
+    }
+    if (precond->L.memory_location == Magma_DEV) {
+        magma_zsetvector(precond->L.nnz, precond->symL.val, 1, precond->L.dval, 1, queue);
+        magma_zsetvector(precond->U.nnz, Uval, 1, precond->U.dval, 1, queue);
+    } else {
+        #pragma omp parallel for
+        for (magma_int_t e=0; e<precond->L.nnz; e++) {
+            precond->L.val[e] = precond->symL.val[e];
+        }
+        #pragma omp parallel for
+        for (magma_int_t e=0; e<precond->U.nnz; e++) {
+            precond->U.val[e] = Uval[e];
+        }
+    }
+
+    // the analysis of the triangular solves may depend on the values
+    if (precond->trisolver == 0 || precond->trisolver == Magma_CUSOLVE) {
+        magma_trisolve_free(&precond->cuinfoL);
+        magma_trisolve_free(&precond->cuinfoU);
+        CHECK(magma_ztrisolve_analysis(precond->L, &precond->cuinfoL, false, false, false, queue));
+        CHECK(magma_ztrisolve_analysis(precond->U, &precond->cuinfoU, true, false, false, queue));
+    } else {
+        magma_zmfree(&precond->d, queue);
+        magma_zmfree(&precond->d2, queue);
+        CHECK(magma_zjacobisetup_diagscal(precond->L, &precond->d, queue));
+        CHECK(magma_zjacobisetup_diagscal(precond->U, &precond->d2, queue));
+    }
+
+cleanup:
+    magma_zmfree(&hAT, queue);
+    magma_zmfree(&hA, queue);
+    magma_free_cpu(Aval_tmp);
+    magma_free_cpu(Lnew);
+    magma_free_cpu(Unew);
+    magma_free_cpu(Uval);
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+
+    Frees the symbolic data kept by magma_zparilu_refresh_setup.
+
+    Arguments
+    ---------
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+*******************************************************************************/
+extern "C"
+magma_int_t
+magma_zparilu_refresh_free(
+    magma_z_preconditioner *precond,
+    magma_queue_t queue)
+{
+    magma_zmfree(&precond->symL, queue);
+    magma_zmfree(&precond->symU, queue);
+    magma_free_cpu(precond->symLA);
+    magma_free_cpu(precond->symUA);
+    magma_free_cpu(precond->symUT);
+    precond->symLA = NULL;
+    precond->symUA = NULL;
+    precond->symUT = NULL;
+    precond->symnnz = 0;
+
+    return MAGMA_SUCCESS;
+}
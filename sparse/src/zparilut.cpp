@@ -293,15 +293,8 @@ magma_zparilut(
         end = magma_sync_wtime( queue ); t_selectadd+=end-start;
         
         start = magma_sync_wtime( queue );
-        #pragma omp parallel        
-        for(int row=0; row<hL.num_rows; row++){
-            magma_zindexsort( &hL.col[hL.row[row]], 0, hL.row[row+1]-hL.row[row]-1, queue );
-        }
-
-        #pragma omp parallel  
-        for(int row=0; row<hL.num_rows; row++){
-            magma_zindexsort( &hU.col[hU.row[row]], 0, hU.row[row+1]-hU.row[row]-1, queue );
-        }
+        CHECK( magma_zcsr_segsort( hL.num_rows, hL.row, hL.col, NULL, queue ));
+        CHECK( magma_zcsr_segsort( hU.num_rows, hU.row, hU.col, NULL, queue ));
         CHECK( magma_zmatrix_cup(  L, oneL, &L_new, queue ) );   
         CHECK( magma_zmatrix_cup(  U, oneU, &U_new, queue ) );
         //magma_zmatrix_addrowindex( &U, queue );
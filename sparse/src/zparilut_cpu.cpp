@@ -42,6 +42,8 @@
     
     precond.sweeps : number of ParILUT steps
     precond.atol   : absolute fill ratio (1.0 keeps nnz count constant)
+    precond.freeze : number of steps adapting the pattern, the remaining
+                     steps are sweeps on the fixed pattern (0: all steps)
 
 
     Arguments
@@ -134,6 +136,12 @@ magma_zparilut_cpu(
         t_rm=0.0; t_add=0.0; t_res=0.0; t_sweep1=0.0; t_sweep2=0.0; t_cand=0.0;
         t_transpose1=0.0; t_transpose2=0.0;  t_selectrm=0.0; t_sort = 0;
         t_sort=0.0; t_nrm=0.0; t_total = 0.0;
+
+        // pattern frozen: only the fixed-point sweep
+        if (precond->freeze > 0 && iters >= precond->freeze) {
+            CHECK(magma_zparilut_sweep_sync(&hA, &L, &U, queue));
+            continue;
+        }
      
         // step 1: transpose U
         start = magma_sync_wtime(queue);
@@ -254,6 +262,8 @@ magma_zparilut_cpu(
     CHECK(magma_zcsrcoo_transpose(U, &UT, queue));
     //magma_zmtranspose(U, &UT, queue);
     CHECK(magma_zmtransfer(UT, &precond->U, Magma_CPU, Magma_DEV , queue));
+    // keep the symbolic data for magma_zparilu_refresh
+    CHECK(magma_zparilu_refresh_setup(A, L, U, precond, queue));
     
     if (precond->trisolver == 0 || precond->trisolver == Magma_CUSOLVE) {
         CHECK(magma_zcumilugeneratesolverinfo(precond, queue));
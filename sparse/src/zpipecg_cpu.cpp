@@ -0,0 +1,269 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+
+
+/**
+    Purpose
+    -------
+
+    Solves a system of linear equations
+       A * X = B
+    where A is a complex Hermitian positive definite matrix A.
+    This is a CPU implementation of the pipelined Conjugate Gradient method
+    (Ghysels and Vanroose) for matrices and vectors in Magma_CPU memory.
+
+    Compared to magma_zcg_cpu, the recurrences for A * p and A * r are
+    carried along, so the two dot products of an iteration, r' * r and
+    r' * A r, do not depend on the SpMV of the same iteration. They are
+    computed in the same pass as the SpMV, and all vector updates are done
+    in a second pass, giving two passes and one global reduction per
+    iteration instead of three passes and two reductions. The price is one
+    more SpMV at startup and three more vectors, and the recursively updated
+    residual may drift further from the true one than in standard CG.
+
+    If precond_par is given and not of type Magma_NONE, this is the
+    preconditioned pipelined CG; u = M^{-1} r and M^{-1} s are carried
+    along with three more vectors, and the preconditioner, applied with
+    magma_z_applyprecond_cpu to A * u, runs right before the SpMV.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A, CSR on the CPU
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b, on the CPU
+
+    @param[in,out]
+    x           magma_z_matrix*
+                solution approximation, on the CPU
+
+    @param[in,out]
+    solver_par  magma_z_solver_par*
+                solver parameters
+
+    @param[in,out]
+    precond_par magma_z_preconditioner*
+                preconditioner, or NULL
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zposv
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zpipecg_cpu(
+    magma_z_matrix A, magma_z_matrix b, magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue )
+{
+    magma_int_t info = MAGMA_NOTCONVERGED;
+
+    bool precond = precond_par != NULL && precond_par->solver != Magma_NONE
+                                       && precond_par->solver != 0;
+
+    // prepare solver feedback
+    solver_par->solver = Magma_PIPECG;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+
+    // solver variables
+    magmaDoubleComplex delta;
+    double alpha = 1.0, beta = 0.0, gamma, gammaold = 1.0, den, rr;
+    double nom0, betanom, nomb;
+
+    // some useful variables
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    magma_int_t dofs = A.num_rows;
+
+    magmaDoubleComplex *r=NULL, *w=NULL, *p=NULL, *s=NULL, *z=NULL, *q=NULL;
+    magmaDoubleComplex *u=NULL, *m=NULL, *c=NULL;
+
+    //Chronometry
+    real_Double_t tempo1, tempo2;
+
+    // CPU workspace, placed by first touch
+    CHECK( magma_zmalloc_cpu( &r, dofs ));
+    CHECK( magma_zmalloc_cpu( &w, dofs ));
+    CHECK( magma_zmalloc_cpu( &p, dofs ));
+    CHECK( magma_zmalloc_cpu( &s, dofs ));
+    CHECK( magma_zmalloc_cpu( &z, dofs ));
+    CHECK( magma_zmalloc_cpu( &q, dofs ));
+    magma_zfill_cpu( dofs, c_zero, r, queue );
+    magma_zfill_cpu( dofs, c_zero, w, queue );
+    magma_zfill_cpu( dofs, c_zero, p, queue );
+    magma_zfill_cpu( dofs, c_zero, s, queue );
+    magma_zfill_cpu( dofs, c_zero, z, queue );
+    magma_zfill_cpu( dofs, c_zero, q, queue );
+    if ( precond ) {
+        CHECK( magma_zmalloc_cpu( &u, dofs ));
+        CHECK( magma_zmalloc_cpu( &m, dofs ));
+        CHECK( magma_zmalloc_cpu( &c, dofs ));
+        magma_zfill_cpu( dofs, c_zero, u, queue );
+        magma_zfill_cpu( dofs, c_zero, m, queue );
+        magma_zfill_cpu( dofs, c_zero, c, queue );
+    }
+
+    // solver setup
+    CHECK( magma_zresidual_cpu( A, b.val, x->val, r, &nom0, queue ));  // r = b - A x
+    solver_par->init_res = nom0;
+    betanom = nom0;
+
+    nomb = magma_dznrm2_cpu( dofs, b.val, queue );
+    if ( nomb == 0.0 ){
+        nomb=1.0;
+    }
+
+    solver_par->final_res = solver_par->init_res;
+    solver_par->iter_res = solver_par->init_res;
+    if( nom0 < solver_par->atol ||
+        nom0/nomb < solver_par->rtol ){
+        info = MAGMA_SUCCESS;
+        goto cleanup;
+    }
+    if ( solver_par->verbose > 0 ) {
+        solver_par->res_vec[0] = (real_Double_t) nom0;
+        solver_par->timing[0] = 0.0;
+    }
+
+    tempo1 = magma_wtime();
+
+    if ( precond ) {
+        // u = M^{-1} r, w = A u, m = M^{-1} w
+        CHECK( magma_z_applyprecond_cpu( A, r, u, precond_par, queue ));
+        CHECK( magma_zspmv_dot_cpu( A, u, w, NULL, NULL, NULL, queue ));
+        solver_par->spmv_count++;
+        CHECK( magma_z_applyprecond_cpu( A, w, m, precond_par, queue ));
+        // q = A m, gamma = u' * r, delta = u' * w
+        CHECK( magma_zpipecg_spmv_cpu( A, m, q, r, u, w, &gamma, &delta, &rr, queue ));
+    } else {
+        // w = A r
+        CHECK( magma_zspmv_dot_cpu( A, r, w, NULL, NULL, NULL, queue ));
+        solver_par->spmv_count++;
+        // q = A w, gamma = r' * r, delta = r' * w
+        CHECK( magma_zpipecg_spmv_cpu( A, w, q, r, r, w, &gamma, &delta, &rr, queue ));
+    }
+    solver_par->spmv_count++;
+
+    // start iteration
+    do
+    {
+        solver_par->numiter++;
+
+        // step length and direction update
+        if ( solver_par->numiter > 1 ) {
+            beta = gamma / gammaold;
+            den = MAGMA_Z_REAL( delta ) - beta * gamma / alpha;
+        } else {
+            beta = 0.0;
+            den = MAGMA_Z_REAL( delta );
+        }
+        // check positive definite
+        if ( den <= 0.0 ) {
+            info = MAGMA_NONSPD;
+            break;
+        }
+        alpha = gamma / den;
+        gammaold = gamma;
+
+        // z = q + beta z, s = w + beta s, p = r + beta p,
+        // x = x + alpha p, r = r - alpha s, w = w - alpha z
+        // with preconditioner also c = m + beta c, u = u - alpha c, p = u + beta p
+        CHECK( magma_zpipecg_update_cpu( dofs,
+                    MAGMA_Z_MAKE( alpha, 0.0 ), MAGMA_Z_MAKE( beta, 0.0 ),
+                    x->val, r, w, p, s, z, q, u, m, c, queue ));
+
+        // q = A m, with the reductions for the next iteration
+        if ( precond ) {
+            CHECK( magma_z_applyprecond_cpu( A, w, m, precond_par, queue ));
+            CHECK( magma_zpipecg_spmv_cpu( A, m, q, r, u, w, &gamma, &delta, &rr, queue ));
+        } else {
+            CHECK( magma_zpipecg_spmv_cpu( A, w, q, r, r, w, &gamma, &delta, &rr, queue ));
+        }
+        solver_par->spmv_count++;
+        betanom = sqrt( rr );
+
+        if ( solver_par->verbose > 0 ) {
+            tempo2 = magma_wtime();
+            if ( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+
+        if (  betanom  < solver_par->atol ||
+              betanom/nomb < solver_par->rtol ) {
+            break;
+        }
+    }
+    while ( solver_par->numiter+1 <= solver_par->maxiter );
+
+    tempo2 = magma_wtime();
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    double residual;
+    CHECK( magma_zresidual_cpu( A, b.val, x->val, r, &residual, queue ));
+    solver_par->iter_res = betanom;
+    solver_par->final_res = residual;
+
+    if ( info == MAGMA_NONSPD ) {
+        ;
+    } else if ( solver_par->numiter < solver_par->maxiter ) {
+        info = MAGMA_SUCCESS;
+    } else if ( solver_par->init_res > solver_par->final_res ) {
+        if ( solver_par->verbose > 0 ) {
+            if ( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        info = MAGMA_SLOW_CONVERGENCE;
+        if( solver_par->iter_res < solver_par->atol ||
+            solver_par->iter_res/solver_par->init_res < solver_par->rtol ){
+            info = MAGMA_SUCCESS;
+        }
+    }
+    else {
+        if ( solver_par->verbose > 0 ) {
+            if ( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        info = MAGMA_DIVERGENCE;
+    }
+
+cleanup:
+    magma_free_cpu( r );
+    magma_free_cpu( w );
+    magma_free_cpu( p );
+    magma_free_cpu( s );
+    magma_free_cpu( z );
+    magma_free_cpu( q );
+    magma_free_cpu( u );
+    magma_free_cpu( m );
+    magma_free_cpu( c );
+
+    solver_par->info = info;
+    return info;
+}   /* magma_zpipecg_cpu */
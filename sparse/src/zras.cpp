@@ -0,0 +1,406 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// subdomains up to this size (including the overlap) are factorized with a
+// dense LU, larger ones with ILU(0)
+#define RAS_DENSE_SIZE   128
+
+
+/******************************************************************************/
+// Builds subdomain dom: the owned rows first ... last-1, extended by levels
+// layers of graph neighbours in A, the subdomain matrix A(idx,idx) and its
+// factorization. map is a work array of length A.num_rows holding -1, it is
+// restored on return.
+static magma_int_t
+ras_domain_setup(
+    magma_z_matrix A,
+    magma_int_t levels,
+    magma_index_t *map,
+    magma_z_ras_domain *dom,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t n = 0, cap, layer_start, layer_end, nnz;
+    magma_index_t *idx = NULL;
+
+    // owned rows, then the overlap layer by layer
+    cap = 2 * ( dom->last - dom->first ) + 16;
+    CHECK( magma_index_malloc_cpu( &idx, cap ));
+    n = 0;
+    for( magma_int_t i=dom->first; i<dom->last; i++ ){
+        idx[n++] = i;
+        map[i] = -2;
+    }
+    layer_start = 0;
+    for( magma_int_t l=0; l<levels; l++ ){
+        layer_end = n;
+        for( magma_int_t p=layer_start; p<layer_end; p++ ){
+            magma_index_t i = idx[p];
+            for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+                magma_index_t j = A.col[k];
+                if( map[j] == -1 ){
+                    if( n == cap ){
+                        magma_index_t *tmp = NULL;
+                        CHECK( magma_index_malloc_cpu( &tmp, 2*cap ));
+                        for( magma_int_t q=0; q<n; q++ ){
+                            tmp[q] = idx[q];
+                        }
+                        magma_free_cpu( idx );
+                        idx = tmp;
+                        cap *= 2;
+                    }
+                    idx[n++] = j;
+                    map[j] = -2;
+                }
+            }
+        }
+        layer_start = layer_end;
+    }
+    CHECK( magma_index_malloc_cpu( &dom->idx, n ));
+    for( magma_int_t p=0; p<n; p++ ){
+        dom->idx[p] = idx[p];
+    }
+    // with sorted indices the local rows inherit the column order of A
+    CHECK( magma_zindexsort( dom->idx, 0, n-1, queue ));
+    for( magma_int_t p=0; p<n; p++ ){
+        map[ dom->idx[p] ] = p;
+    }
+    dom->n = n;
+
+    // subdomain matrix A(idx,idx)
+    nnz = 0;
+    for( magma_int_t p=0; p<n; p++ ){
+        magma_index_t i = dom->idx[p];
+        for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+            if( map[ A.col[k] ] >= 0 ){
+                nnz++;
+            }
+        }
+    }
+    dom->LU.storage_type    = Magma_CSR;
+    dom->LU.memory_location = Magma_CPU;
+    dom->LU.num_rows        = n;
+    dom->LU.num_cols        = n;
+    dom->LU.nnz             = nnz;
+    CHECK( magma_index_malloc_cpu( &dom->LU.row, n+1 ));
+    CHECK( magma_index_malloc_cpu( &dom->LU.col, max( nnz, 1 ) ));
+    CHECK( magma_zmalloc_cpu( &dom->LU.val, max( nnz, 1 ) ));
+    CHECK( magma_zmalloc_cpu( &dom->work, n ));
+    nnz = 0;
+    dom->LU.row[0] = 0;
+    for( magma_int_t p=0; p<n; p++ ){
+        magma_index_t i = dom->idx[p];
+        for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+            magma_index_t q = map[ A.col[k] ];
+            if( q >= 0 ){
+                dom->LU.col[nnz] = q;
+                dom->LU.val[nnz] = A.val[k];
+                nnz++;
+            }
+        }
+        dom->LU.row[p+1] = nnz;
+    }
+
+    if( n <= RAS_DENSE_SIZE ){
+        // dense LU
+        magma_int_t linfo = 0;
+        CHECK( magma_zmalloc_cpu( &dom->dense, n*n ));
+        CHECK( magma_imalloc_cpu( &dom->ipiv, n ));
+        for( magma_int_t k=0; k<n*n; k++ ){
+            dom->dense[k] = MAGMA_Z_ZERO;
+        }
+        for( magma_int_t p=0; p<n; p++ ){
+            for( magma_int_t k=dom->LU.row[p]; k<dom->LU.row[p+1]; k++ ){
+                dom->dense[ p + dom->LU.col[k]*n ] = dom->LU.val[k];
+            }
+        }
+        lapackf77_zgetrf( &n, &n, dom->dense, &n, dom->ipiv, &linfo );
+        if( linfo != 0 ){
+            info = MAGMA_ERR_BADPRECOND;
+            goto cleanup;
+        }
+    }
+    else {
+        // ILU(0), IKJ variant; map marks the positions of the current row
+        CHECK( magma_index_malloc_cpu( &dom->diag, n ));
+        for( magma_int_t p=0; p<n; p++ ){
+            dom->diag[p] = -1;
+            for( magma_int_t k=dom->LU.row[p]; k<dom->LU.row[p+1]; k++ ){
+                if( dom->LU.col[k] == p ){
+                    dom->diag[p] = k;
+                }
+            }
+            if( dom->diag[p] < 0 ){
+                info = MAGMA_ERR_BADPRECOND;
+                goto cleanup;
+            }
+        }
+        for( magma_int_t p=0; p<n; p++ ){
+            map[ dom->idx[p] ] = -1;
+        }
+        for( magma_int_t p=0; p<n; p++ ){
+            for( magma_int_t k=dom->LU.row[p]; k<dom->LU.row[p+1]; k++ ){
+                map[ dom->LU.col[k] ] = k;
+            }
+            for( magma_int_t k=dom->LU.row[p]; k<dom->diag[p]; k++ ){
+                magma_index_t j = dom->LU.col[k];
+                magmaDoubleComplex lij = dom->LU.val[k] / dom->LU.val[ dom->diag[j] ];
+                dom->LU.val[k] = lij;
+                for( magma_int_t kk=dom->diag[j]+1; kk<dom->LU.row[j+1]; kk++ ){
+                    magma_index_t pos = map[ dom->LU.col[kk] ];
+                    if( pos >= 0 ){
+                        dom->LU.val[pos] -= lij * dom->LU.val[kk];
+                    }
+                }
+            }
+            for( magma_int_t k=dom->LU.row[p]; k<dom->LU.row[p+1]; k++ ){
+                map[ dom->LU.col[k] ] = -1;
+            }
+            if( MAGMA_Z_ABS( dom->LU.val[ dom->diag[p] ] ) == 0.0 ){
+                info = MAGMA_ERR_BADPRECOND;
+                goto cleanup;
+            }
+        }
+    }
+
+cleanup:
+    // restore map: the subdomain rows, and the local markers of the ILU(0)
+    for( magma_int_t p=0; p<n; p++ ){
+        map[ idx[p] ] = -1;
+        map[p] = -1;
+    }
+    magma_free_cpu( idx );
+    return info;
+}
+
+
+/******************************************************************************/
+// x = A_i^-1 b for the local vectors of subdomain dom
+static void
+ras_domain_solve(
+    magma_z_ras_domain *dom,
+    magmaDoubleComplex *x )
+{
+    magma_int_t n = dom->n;
+
+    if( dom->dense != NULL ){
+        magma_int_t ione = 1, linfo;
+        lapackf77_zgetrs( "N", &n, &ione, dom->dense, &n, dom->ipiv, x, &n, &linfo );
+        return;
+    }
+    // L has a unit diagonal
+    for( magma_int_t p=0; p<n; p++ ){
+        magmaDoubleComplex s = x[p];
+        for( magma_int_t k=dom->LU.row[p]; k<dom->diag[p]; k++ ){
+            s -= dom->LU.val[k] * x[ dom->LU.col[k] ];
+        }
+        x[p] = s;
+    }
+    for( magma_int_t p=n-1; p>=0; p-- ){
+        magmaDoubleComplex s = x[p];
+        for( magma_int_t k=dom->diag[p]+1; k<dom->LU.row[p+1]; k++ ){
+            s -= dom->LU.val[k] * x[ dom->LU.col[k] ];
+        }
+        x[p] = s / dom->LU.val[ dom->diag[p] ];
+    }
+}
+
+
+/**
+    Purpose
+    -------
+
+    Prepares the restricted additive Schwarz preconditioner on the CPU.
+
+    The rows of A are split into contiguous blocks, one per OpenMP thread,
+    or of precond->bsize rows each if this is positive. Each block is
+    extended by precond->levels layers of graph neighbours to form an
+    overlapping subdomain. The subdomain matrices are factorized
+    independently and concurrently: with a dense LU if they have at most
+    RAS_DENSE_SIZE rows, with ILU(0) otherwise. The factorizations are
+    kept in the preconditioner and reused by every application.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A
+
+    @param[in]
+    b           magma_z_matrix
+                input RHS b
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zrassetup(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR};
+    magma_index_t *map = NULL;
+    magma_int_t n, ndom, bsize, num_threads = 1;
+    magma_int_t levels = max( precond->levels, 0 );
+
+    CHECK( magma_zmtransfer( A, &hA, A.memory_location, Magma_CPU, queue ));
+    CHECK( magma_zmconvert( hA, &CSRA, hA.storage_type, Magma_CSR, queue ));
+    CHECK( magma_zcsr_segsort( CSRA.num_rows, CSRA.row, CSRA.col, CSRA.val, queue ));
+    n = CSRA.num_rows;
+
+    #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    #endif
+    if( precond->bsize > 0 ){
+        bsize = precond->bsize;
+    } else {
+        bsize = magma_ceildiv( n, num_threads );
+    }
+    bsize = max( bsize, 1 );
+    ndom = magma_ceildiv( n, bsize );
+
+    CHECK( magma_malloc_cpu( (void**) &precond->ras, max( ndom, 1 ) * sizeof(magma_z_ras_domain) ));
+    precond->ras_domains = ndom;
+    for( magma_int_t d=0; d<ndom; d++ ){
+        magma_z_ras_domain *dom = &precond->ras[d];
+        magma_z_matrix empty={Magma_CSR};
+        dom->first = d * bsize;
+        dom->last  = min( n, (d+1) * bsize );
+        dom->n     = 0;
+        dom->idx   = NULL;
+        dom->LU    = empty;
+        dom->diag  = NULL;
+        dom->dense = NULL;
+        dom->ipiv  = NULL;
+        dom->work  = NULL;
+    }
+    CHECK( magma_zmalloc_cpu( &precond->hwork, 2*max( n, 1 ) ));
+    CHECK( magma_index_malloc_cpu( &map, num_threads * max( n, 1 ) ));
+    for( magma_int_t i=0; i<num_threads * n; i++ ){
+        map[i] = -1;
+    }
+
+    // every thread sets up and factorizes its subdomains
+    #pragma omp parallel for schedule(dynamic,1)
+    for( magma_int_t d=0; d<ndom; d++ ){
+        magma_int_t tid = 0;
+        #ifdef _OPENMP
+        tid = omp_get_thread_num();
+        #endif
+        magma_int_t dinfo = ras_domain_setup( CSRA, levels, map + tid * n,
+                                              &precond->ras[d], queue );
+        if( dinfo != 0 ){
+            #pragma omp critical
+            info = dinfo;
+        }
+    }
+
+cleanup:
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &CSRA, queue );
+    magma_free_cpu( map );
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Applies the restricted additive Schwarz preconditioner,
+    x = sum_i R_i^0 A_i^-1 R_i b, where R_i restricts to subdomain i and
+    R_i^0 to its owned rows. All subdomain solves run concurrently with the
+    factorizations from magma_zrassetup; as the owned rows do not overlap,
+    they write to x without conflicts. The solves run on the CPU; vectors on
+    the device are copied to and from the CPU.
+
+    Arguments
+    ---------
+
+    @param[in]
+    b           magma_z_matrix
+                RHS
+
+    @param[out]
+    x           magma_z_matrix*
+                vector to precondition
+
+    @param[in]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zapplyras(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t n = b.num_rows;
+    magmaDoubleComplex *hb, *hx;
+
+    if( precond->ras == NULL || precond->hwork == NULL ){
+        return MAGMA_ERR_NOT_INITIALIZED;
+    }
+    if( b.memory_location == Magma_DEV ){
+        hb = precond->hwork;
+        magma_zgetvector( n, b.dval, 1, hb, 1, queue );
+    } else {
+        hb = b.val;
+    }
+    hx = ( x->memory_location == Magma_DEV ) ? precond->hwork + n : x->val;
+
+    #pragma omp parallel for schedule(dynamic,1)
+    for( magma_int_t d=0; d<precond->ras_domains; d++ ){
+        magma_z_ras_domain *dom = &precond->ras[d];
+        for( magma_int_t p=0; p<dom->n; p++ ){
+            dom->work[p] = hb[ dom->idx[p] ];
+        }
+        ras_domain_solve( dom, dom->work );
+        for( magma_int_t p=0; p<dom->n; p++ ){
+            magma_index_t i = dom->idx[p];
+            if( i >= dom->first && i < dom->last ){
+                hx[i] = dom->work[p];
+            }
+        }
+    }
+
+    if( x->memory_location == Magma_DEV ){
+        magma_zsetvector( n, hx, 1, x->dval, 1, queue );
+    }
+
+    return info;
+}
@@ -23,6 +23,8 @@
 
 /* ////////////////////////////////////////////////////////////////////////////
    -- testing any solver
+   Times the preconditioner, and the refresh for the matrix with a scaled
+   diagonal against the setup.
 */
 int main(  int argc, char** argv )
 {
@@ -36,12 +38,13 @@ int main(  int argc, char** argv )
     
     magmaDoubleComplex one = MAGMA_Z_MAKE(1.0, 0.0);
     magmaDoubleComplex zero = MAGMA_Z_MAKE(0.0, 0.0);
+    magmaDoubleComplex diag_scale = MAGMA_Z_MAKE(1.5, 0.0);
     magma_z_matrix A={Magma_CSR}, B={Magma_CSR}, dB={Magma_CSR};
     magma_z_matrix x={Magma_CSR}, b={Magma_CSR}, t={Magma_CSR};
     magma_z_matrix x1={Magma_CSR}, x2={Magma_CSR};
     
     //Chronometry
-    real_Double_t tempo1, tempo2;
+    real_Double_t tempo1, tempo2, setuptime;
     
     int i=1;
     TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
@@ -123,6 +126,32 @@ int main(  int argc, char** argv )
         
         magma_zsolverinfo( &zopts.solver_par, &zopts.precond_par, queue );
 
+        // new values on the same pattern, as in time stepping:
+        // scale the diagonal and refresh the preconditioner
+        printf("%%runtime setup, runtime refresh, residual left preconditioner:\n");
+        setuptime = zopts.precond_par.setuptime;
+        for( magma_int_t row=0; row < A.num_rows; row++ ) {
+            for( magma_int_t k=A.row[row]; k < A.row[row+1]; k++ ) {
+                if ( A.col[k] == row ) {
+                    A.val[k] = MAGMA_Z_MUL( A.val[k], diag_scale );
+                }
+            }
+        }
+        magma_zmfree(&dB, queue );
+        magma_zmfree(&B, queue );
+        magma_zmfree(&x1, queue );
+        TESTING_CHECK( magma_zmconvert( A, &B, Magma_CSR, zopts.output_format, queue ));
+        TESTING_CHECK( magma_zmtransfer( B, &dB, Magma_CPU, Magma_DEV, queue ));
+        TESTING_CHECK( magma_zvinit( &x1, Magma_DEV, A.num_cols, 1, zero, queue ));
+        TESTING_CHECK( magma_z_precondrefresh( dB, b, &zopts.solver_par, &zopts.precond_par, queue ) );
+        info = magma_z_applyprecond_left( MagmaNoTrans, dB, b, &x1, &zopts.precond_par, queue ); 
+        if( info != 0 ){
+            printf("error: preconditioner returned: %s (%lld).\n",
+                    magma_strerror( info ), (long long) info );
+        }
+        TESTING_CHECK( magma_zresidual( dB, b, x1, &residual, queue ));
+        printf("%.8e  %.8e  %.8e\n", setuptime, zopts.precond_par.setuptime, residual );
+
         magma_zmfree(&dB, queue );
         magma_zmfree(&B, queue );
         magma_zmfree(&A, queue );
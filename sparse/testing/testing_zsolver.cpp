@@ -23,6 +23,8 @@
 
 /* ////////////////////////////////////////////////////////////////////////////
    -- testing any solver
+      With --cpu in front of the matrices, the systems stay in the CPU memory
+      and are solved by the host solvers, with the host preconditioners.
 */
 int main(  int argc, char** argv )
 {
@@ -39,6 +41,7 @@ int main(  int argc, char** argv )
     magma_z_matrix x={Magma_CSR}, b={Magma_CSR};
     
     int i=1;
+    int on_cpu = 0;
     TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
     B.blocksize = zopts.blocksize;
     B.alignment = zopts.alignment;
@@ -46,6 +49,11 @@ int main(  int argc, char** argv )
     TESTING_CHECK( magma_zsolverinfo_init( &zopts.solver_par, &zopts.precond_par, queue ));
 
     while( i < argc ) {
+        if ( strcmp("--cpu", argv[i]) == 0 ) {   // host solvers
+            on_cpu = 1;
+            i++;
+            continue;
+        }
         if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
             i++;
             magma_int_t laplace_size = atoi( argv[i] );
@@ -80,14 +88,15 @@ int main(  int argc, char** argv )
         printf("%%============================================================================%%\n");
         printf("];\n");
 
-        TESTING_CHECK( magma_zmtransfer( B, &dB, Magma_CPU, Magma_DEV, queue ));
+        magma_location_t location = ( on_cpu ? Magma_CPU : Magma_DEV );
+        TESTING_CHECK( magma_zmtransfer( B, &dB, Magma_CPU, location, queue ));
 
         // vectors and initial guess
-        TESTING_CHECK( magma_zvinit_rand( &b, Magma_DEV, A.num_rows, 1, queue ));
+        TESTING_CHECK( magma_zvinit_rand( &b, location, A.num_rows, 1, queue ));
         //magma_zvinit( &x, Magma_DEV, A.num_cols, 1, one, queue );
         //magma_z_spmv( one, dB, x, zero, b, queue );                 //  b = A x
         //magma_zmfree(&x, queue );
-        TESTING_CHECK( magma_zvinit_rand( &x, Magma_DEV, A.num_cols, 1, queue ));
+        TESTING_CHECK( magma_zvinit_rand( &x, location, A.num_cols, 1, queue ));
         
         info = magma_z_solver( dB, b, &x, &zopts, queue );
         if( info != 0 ) {
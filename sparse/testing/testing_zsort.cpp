@@ -111,6 +111,42 @@ int main(  int argc, char** argv )
         }
         printf("\n\n");
         magma_free_cpu( x );
+
+        // shuffle the entries of every row, then sort them back per row with
+        // quicksort and with magma_zcsr_sort and compare against A
+        magma_z_matrix B={Magma_CSR}, C={Magma_CSR};
+        real_Double_t t_qsort, t_segsort;
+        magma_int_t errors = 0;
+        TESTING_CHECK( magma_zmtransfer( A, &B, Magma_CPU, Magma_CPU, queue ));
+        for(magma_int_t r = 0; r < B.num_rows; r++ ){
+            for(magma_int_t j = B.row[r+1]-1; j > B.row[r]; j-- ){
+                magma_int_t k = B.row[r] + rand() % (j - B.row[r] + 1);
+                magma_index_t tc = B.col[j]; B.col[j] = B.col[k]; B.col[k] = tc;
+                magmaDoubleComplex tv = B.val[j]; B.val[j] = B.val[k]; B.val[k] = tv;
+            }
+        }
+        TESTING_CHECK( magma_zmtransfer( B, &C, Magma_CPU, Magma_CPU, queue ));
+
+        t_qsort = magma_wtime();
+        for(magma_int_t r = 0; r < B.num_rows; r++ ){
+            TESTING_CHECK( magma_zindexsortval( B.col, B.val, B.row[r], B.row[r+1]-1, queue ));
+        }
+        t_qsort = magma_wtime() - t_qsort;
+
+        t_segsort = magma_wtime();
+        TESTING_CHECK( magma_zcsr_sort( &C, queue ));
+        t_segsort = magma_wtime() - t_segsort;
+
+        for(magma_int_t j = 0; j < A.nnz; j++ ){
+            if ( C.col[j] != A.col[j] || ! MAGMA_Z_EQUAL( C.val[j], A.val[j] ) ) {
+                errors++;
+            }
+        }
+        printf("row sort: quicksort %.4f sec, magma_zcsr_sort %.4f sec, %lld errors %s\n\n",
+                t_qsort, t_segsort, (long long) errors, (errors == 0 ? "ok" : "failed"));
+        info += (errors != 0);
+        magma_zmfree(&B, queue);
+        magma_zmfree(&C, queue);
         magma_zmfree(&A, queue);
         
         i++;
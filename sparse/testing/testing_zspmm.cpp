@@ -79,6 +79,30 @@
   #endif
 #endif
 
+/* ////////////////////////////////////////////////////////////////////////////
+   -- ||Y - Yref||_F / ||Yref||_F over all vectors. Yref is column major,
+      Y is interleaved if Y.major is MagmaRowMajor.
+*/
+static double
+zspmm_error( magma_z_matrix Y, magma_z_matrix Yref )
+{
+    magma_int_t m = Yref.num_rows, n = Yref.num_cols;
+    double diff = 0.0, nrm = 0.0;
+
+    for( magma_int_t k=0; k < n; k++ ) {
+        for( magma_int_t i=0; i < m; i++ ) {
+            magmaDoubleComplex y = ( Y.major == MagmaRowMajor )
+                                   ? Y.val[ i*n + k ] : Y.val[ i + k*m ];
+            double d = MAGMA_Z_ABS( MAGMA_Z_SUB( y, Yref.val[ i + k*m ] ));
+            double r = MAGMA_Z_ABS( Yref.val[ i + k*m ] );
+            diff += d*d;
+            nrm  += r*r;
+        }
+    }
+    return ( nrm > 0.0 ) ? sqrt( diff / nrm ) : sqrt( diff );
+}
+
+
 /* ////////////////////////////////////////////////////////////////////////////
    -- testing sparse matrix vector product
 */
@@ -95,6 +119,9 @@ int main(  int argc, char** argv )
     
     magma_z_matrix hx={Magma_CSR}, hy={Magma_CSR}, dx={Magma_CSR}, 
     dy={Magma_CSR}, hrefvec={Magma_CSR}, hcheck={Magma_CSR};
+    magma_z_matrix hxj={Magma_CSR}, hyj={Magma_CSR};
+    magma_z_matrix hxr={Magma_CSR}, hyr={Magma_CSR};
+    magma_int_t ione = 1, ISEED[4] = {0,0,0,1};
         
     hA_SELLP.blocksize = 8;
     hA_SELLP.alignment = 8;
@@ -154,12 +181,24 @@ int main(  int argc, char** argv )
         m = hA.num_rows;
         n = 48;
 
-        // init CPU vectors
-        TESTING_CHECK( magma_zvinit( &hx, Magma_CPU, m, n, c_one, queue ));
+        // init CPU vectors, random and different for every vector
+        magma_int_t mn = m*n;
+        TESTING_CHECK( magma_zvinit( &hx, Magma_CPU, m, n, c_zero, queue ));
         TESTING_CHECK( magma_zvinit( &hy, Magma_CPU, m, n, c_zero, queue ));
+        lapackf77_zlarnv( &ione, ISEED, &mn, hx.val );
+
+        // the same vectors interleaved, for the MagmaRowMajor SpMM
+        TESTING_CHECK( magma_zvinit( &hxr, Magma_CPU, m, n, c_zero, queue ));
+        TESTING_CHECK( magma_zvinit( &hyr, Magma_CPU, m, n, c_zero, queue ));
+        hxr.major = hyr.major = MagmaRowMajor;
+        for( magma_int_t k=0; k < n; k++ ) {
+            for( magma_int_t t=0; t < m; t++ ) {
+                hxr.val[ t*n + k ] = hx.val[ t + k*m ];
+            }
+        }
 
         // init DEV vectors
-        TESTING_CHECK( magma_zvinit( &dx, Magma_DEV, m, n, c_one, queue ));
+        TESTING_CHECK( magma_zmtransfer( hx, &dx, Magma_CPU, Magma_DEV, queue ));
         TESTING_CHECK( magma_zvinit( &dy, Magma_DEV, m, n, c_zero, queue ));
 
 
@@ -238,7 +277,7 @@ int main(  int argc, char** argv )
 
         // copy matrix to GPU
         TESTING_CHECK( magma_zmtransfer( hA, &dA, Magma_CPU, Magma_DEV, queue ));
-        // SpMV on GPU (CSR)
+        // SpMV on GPU (CSR), the reference for the other products
         start = magma_sync_wtime( queue );
         for (j=0; j < 10; j++) {
             TESTING_CHECK( magma_z_spmv( c_one, dA, dx, c_zero, dy, queue ));
@@ -250,6 +289,56 @@ int main(  int argc, char** argv )
         TESTING_CHECK( magma_zmtransfer( dy, &hrefvec , Magma_DEV, Magma_CPU, queue ));
         magma_zmfree(&dA, queue );
 
+        // SpMM on the CPU, against one SpMV per vector with the same kernel
+        hxj = hx;
+        hyj = hy;
+        hxj.num_cols = hyj.num_cols = 1;
+        start = magma_wtime();
+        for (j=0; j < 10; j++) {
+            for( magma_int_t k=0; k < n; k++ ) {
+                hxj.val = hx.val + k*m;
+                hyj.val = hy.val + k*m;
+                TESTING_CHECK( magma_zspmm_cpu( c_one, hA, hxj, c_zero, hyj, queue ));
+            }
+        }
+        end = magma_wtime();
+        printf( " > MAGMA CPU: %.2e seconds %.2e GFLOP/s    (CSR, single SpMVs).\n",
+                                        (end-start)/10, FLOPS*10.*n/(end-start) );
+        res = zspmm_error( hy, hrefvec );
+        printf("%% |Y-Yref|_F / |Yref|_F = %8.2e\n", res);
+        if ( res < accuracy )
+            printf("%% tester spmm CPU single SpMVs:  ok\n");
+        else
+            printf("%% tester spmm CPU single SpMVs:  failed\n");
+
+        start = magma_wtime();
+        for (j=0; j < 10; j++) {
+            TESTING_CHECK( magma_z_spmv( c_one, hA, hxr, c_zero, hyr, queue ));
+        }
+        end = magma_wtime();
+        printf( " > MAGMA CPU: %.2e seconds %.2e GFLOP/s    (CSR, interleaved SpMM).\n",
+                                        (end-start)/10, FLOPS*10.*n/(end-start) );
+        res = zspmm_error( hyr, hrefvec );
+        printf("%% |Y-Yref|_F / |Yref|_F = %8.2e\n", res);
+        if ( res < accuracy )
+            printf("%% tester spmm CPU interleaved:  ok\n");
+        else
+            printf("%% tester spmm CPU interleaved:  failed\n");
+
+        start = magma_wtime();
+        for (j=0; j < 10; j++) {
+            TESTING_CHECK( magma_z_spmv( c_one, hA, hx, c_zero, hy, queue ));
+        }
+        end = magma_wtime();
+        printf( " > MAGMA CPU: %.2e seconds %.2e GFLOP/s    (CSR, SpMM).\n",
+                                        (end-start)/10, FLOPS*10.*n/(end-start) );
+        res = zspmm_error( hy, hrefvec );
+        printf("%% |Y-Yref|_F / |Yref|_F = %8.2e\n", res);
+        if ( res < accuracy )
+            printf("%% tester spmm CPU:  ok\n");
+        else
+            printf("%% tester spmm CPU:  failed\n");
+
 
         // convert to SELLP and copy to GPU
         TESTING_CHECK( magma_zmconvert(  hA, &hA_SELLP, Magma_CSR, Magma_SELLP, queue ));
@@ -267,11 +356,8 @@ int main(  int argc, char** argv )
                                         (end-start)/10, FLOPS*10.*n/(end-start) );
 
         TESTING_CHECK( magma_zmtransfer( dy, &hcheck , Magma_DEV, Magma_CPU, queue ));
-        res = 0.0;
-        for(magma_int_t k=0; k < hA.num_rows; k++ ) {
-            res=res + MAGMA_Z_REAL(hcheck.val[k]) - MAGMA_Z_REAL(hrefvec.val[k]);
-        }
-        printf("%% |x-y|_F = %8.2e\n", res);
+        res = zspmm_error( hcheck, hrefvec );
+        printf("%% |Y-Yref|_F / |Yref|_F = %8.2e\n", res);
         if ( res < accuracy )
             printf("%% tester spmm SELL-P:  ok\n");
         else
@@ -311,11 +397,8 @@ int main(  int argc, char** argv )
                                         (end-start)/10, FLOPS*10*n/(end-start) );
 
         TESTING_CHECK( magma_zmtransfer( dy, &hcheck , Magma_DEV, Magma_CPU, queue ));
-        res = 0.0;
-        for(magma_int_t k=0; k < hA.num_rows; k++ ) {
-            res = res + MAGMA_Z_REAL(hcheck.val[k]) - MAGMA_Z_REAL(hrefvec.val[k]);
-        }
-        printf("%% |x-y|_F = %8.2e\n", res);
+        res = zspmm_error( hcheck, hrefvec );
+        printf("%% |Y-Yref|_F / |Yref|_F = %8.2e\n", res);
         if ( res < accuracy )
             printf("%% tester spmm cuSPARSE:  ok\n");
         else
@@ -334,6 +417,8 @@ int main(  int argc, char** argv )
         magma_zmfree( &hA, queue );
         magma_zmfree( &hx, queue );
         magma_zmfree( &hy, queue );
+        magma_zmfree( &hxr, queue );
+        magma_zmfree( &hyr, queue );
         magma_zmfree( &hrefvec, queue );
         // free GPU memory
         magma_zmfree( &dx, queue );
@@ -0,0 +1,137 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "testings.h"
+
+
+static const char*
+format_name( magma_storage_t format )
+{
+    switch( format ){
+        case Magma_CSR:   return "CSR";
+        case Magma_CSR5:  return "CSR5";
+        case Magma_ELL:   return "ELL";
+        case Magma_SELLP: return "SELLP";
+        case Magma_BCSR:  return "BCSR";
+        default:          return "?";
+    }
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- calibrates the SpMV format selection, run once after the installation.
+      The model is appended to the file named by MAGMA_SPMV_MODEL, or
+      magma_spmv_model.txt. For the matrices given, the selected format is
+      compared against CSR.
+*/
+int main(  int argc, char** argv )
+{
+    magma_int_t info = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts;
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    const magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    const magma_int_t reps = 20;
+
+    magma_z_matrix Z={Magma_CSR}, hB={Magma_CSR}, dB={Magma_CSR}, dA={Magma_CSR};
+    magma_z_matrix dx={Magma_CSR}, dy={Magma_CSR};
+    magma_spmv_model model;
+    magma_spmv_features features;
+    magma_storage_t format;
+    magma_int_t blocksize, alignment;
+    real_Double_t predicted;
+    real_Double_t start, end, t_csr, t_auto;
+
+    const char *filename = getenv( "MAGMA_SPMV_MODEL" );
+    if( filename == NULL ){
+        filename = "magma_spmv_model.txt";
+    }
+
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+
+    printf("%% calibrating the SpMV model ...\n");
+    TESTING_CHECK( magma_zmformat_calibrate( &model, queue ));
+    TESTING_CHECK( magma_zmformat_model_write( filename, &model, queue ));
+    printf("%% model written to %s\n", filename );
+
+    printf("%%   size (n)   ||   nnz   ||   format   ||   C / b   ||   T   ||"
+           "   CSR (ms)   ||   selected (ms)   ||   predicted (ms)\n");
+    printf("%%=============================================================%%\n");
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &Z, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &Z,  argv[i], queue ));
+        }
+
+        TESTING_CHECK( magma_zmfeatures( Z, &features, queue ));
+        TESTING_CHECK( magma_zmformat_select( &features, &model, &format,
+                                &blocksize, &alignment, &predicted, queue ));
+        TESTING_CHECK( magma_zvinit( &dx, Magma_DEV, Z.num_cols, 1, c_one, queue ));
+        TESTING_CHECK( magma_zvinit( &dy, Magma_DEV, Z.num_rows, 1, c_zero, queue ));
+
+        // CSR
+        TESTING_CHECK( magma_zmtransfer( Z, &dA, Magma_CPU, Magma_DEV, queue ));
+        TESTING_CHECK( magma_z_spmv( c_one, dA, dx, c_zero, dy, queue ));
+        start = magma_sync_wtime( queue );
+        for (int j=0; j < reps; j++) {
+            TESTING_CHECK( magma_z_spmv( c_one, dA, dx, c_zero, dy, queue ));
+        }
+        end = magma_sync_wtime( queue );
+        t_csr = ( end - start ) / reps;
+
+        // selected format
+        TESTING_CHECK( magma_zmconvert_auto( Z, &hB, &model, queue ));
+        TESTING_CHECK( magma_zmtransfer( hB, &dB, Magma_CPU, Magma_DEV, queue ));
+        TESTING_CHECK( magma_z_spmv( c_one, dB, dx, c_zero, dy, queue ));
+        start = magma_sync_wtime( queue );
+        for (int j=0; j < reps; j++) {
+            TESTING_CHECK( magma_z_spmv( c_one, dB, dx, c_zero, dy, queue ));
+        }
+        end = magma_sync_wtime( queue );
+        t_auto = ( end - start ) / reps;
+
+        printf("   %10lld   %10lld   %8s   %6lld   %4lld   %10.4f   %10.4f   %10.4f\n",
+               (long long) Z.num_rows, (long long) Z.nnz, format_name( format ),
+               (long long) blocksize, (long long) alignment,
+               t_csr * 1e3, t_auto * 1e3, predicted * 1e3 );
+
+        magma_zmfree(&Z, queue );
+        magma_zmfree(&hB, queue );
+        magma_zmfree(&dB, queue );
+        magma_zmfree(&dA, queue );
+        magma_zmfree(&dx, queue );
+        magma_zmfree(&dy, queue );
+
+        i++;
+    }
+    printf("%%=============================================================%%\n");
+
+    magma_queue_destroy( queue );
+    TESTING_CHECK( magma_finalize() );
+    return info;
+}
@@ -0,0 +1,126 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- compares the matrix-free STENCIL SpMV against CSR for the 27-point
+      Laplace operator on n x n x n grids, given as arguments,
+      on the GPU and the CPU
+*/
+int main(  int argc, char** argv )
+{
+    magma_int_t info = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    const magmaDoubleComplex c_zero    = MAGMA_Z_ZERO;
+    const magma_int_t reps = 20;
+    magma_int_t ione = 1, ISEED[4] = {0,0,0,1};
+
+    magma_z_matrix S={Magma_CSR}, A={Magma_CSR}, dS={Magma_CSR}, dA={Magma_CSR};
+    magma_z_matrix hx={Magma_CSR}, hy={Magma_CSR};
+    magma_z_matrix dx={Magma_CSR}, dy={Magma_CSR}, dz={Magma_CSR};
+    magmaDoubleComplex coef[ MAGMA_STENCIL_SIZE ];
+    real_Double_t start, end, t_stencil, t_csr, t_cpu;
+    double nrm, err, res;
+
+    for( magma_int_t k=0; k<MAGMA_STENCIL_SIZE; k++ ){
+        coef[k] = c_neg_one;
+    }
+    coef[ MAGMA_STENCIL_SIZE/2 ] = MAGMA_Z_MAKE( 26.0, 0.0 );
+
+    printf("%%   grid   ||   nnz   ||   STENCIL (ms)   ||   CSR (ms)   ||"
+           "   CPU (ms)   ||   error GPU   ||   error CPU\n");
+    printf("%%=============================================================%%\n");
+    int i=1;
+    while( i < argc ) {
+        magma_int_t n = atoi( argv[i] );
+        TESTING_CHECK( magma_zm_stencil( n, n, n, coef, &S, queue ));
+        TESTING_CHECK( magma_zmconvert( S, &A, Magma_STENCIL, Magma_CSR, queue ));
+        magma_int_t m = A.num_rows;
+
+        TESTING_CHECK( magma_zvinit( &hx, Magma_CPU, m, 1, c_zero, queue ));
+        TESTING_CHECK( magma_zvinit( &hy, Magma_CPU, m, 1, c_zero, queue ));
+        lapackf77_zlarnv( &ione, ISEED, &m, hx.val );
+        TESTING_CHECK( magma_zmtransfer( hx, &dx, Magma_CPU, Magma_DEV, queue ));
+        TESTING_CHECK( magma_zmtransfer( hy, &dy, Magma_CPU, Magma_DEV, queue ));
+        TESTING_CHECK( magma_zmtransfer( hy, &dz, Magma_CPU, Magma_DEV, queue ));
+        TESTING_CHECK( magma_zmtransfer( S, &dS, Magma_CPU, Magma_DEV, queue ));
+        TESTING_CHECK( magma_zmtransfer( A, &dA, Magma_CPU, Magma_DEV, queue ));
+
+        // STENCIL on the GPU
+        TESTING_CHECK( magma_z_spmv( c_one, dS, dx, c_zero, dy, queue ));
+        start = magma_sync_wtime( queue );
+        for (int j=0; j < reps; j++) {
+            TESTING_CHECK( magma_z_spmv( c_one, dS, dx, c_zero, dy, queue ));
+        }
+        end = magma_sync_wtime( queue );
+        t_stencil = ( end - start ) / reps;
+
+        // CSR on the GPU
+        TESTING_CHECK( magma_z_spmv( c_one, dA, dx, c_zero, dz, queue ));
+        start = magma_sync_wtime( queue );
+        for (int j=0; j < reps; j++) {
+            TESTING_CHECK( magma_z_spmv( c_one, dA, dx, c_zero, dz, queue ));
+        }
+        end = magma_sync_wtime( queue );
+        t_csr = ( end - start ) / reps;
+
+        nrm = magma_dznrm2( m, dz.dval, 1, queue );
+        magma_zaxpy( m, c_neg_one, dz.dval, 1, dy.dval, 1, queue );
+        err = magma_dznrm2( m, dy.dval, 1, queue ) / nrm;
+
+        // STENCIL on the CPU, checked by the CSR residual of its result
+        start = magma_wtime();
+        for (int j=0; j < reps; j++) {
+            TESTING_CHECK( magma_z_spmv( c_one, S, hx, c_zero, hy, queue ));
+        }
+        end = magma_wtime();
+        t_cpu = ( end - start ) / reps;
+        TESTING_CHECK( magma_zresidual_cpu( A, hy.val, hx.val, NULL, &res, queue ));
+
+        printf("   %4lld^3   %10lld   %10.4f   %10.4f   %10.4f   %8.2e   %8.2e\n",
+               (long long) n, (long long) A.nnz, t_stencil * 1e3, t_csr * 1e3,
+               t_cpu * 1e3, err, res / nrm );
+
+        magma_zmfree(&S, queue );
+        magma_zmfree(&A, queue );
+        magma_zmfree(&dS, queue );
+        magma_zmfree(&dA, queue );
+        magma_zmfree(&hx, queue );
+        magma_zmfree(&hy, queue );
+        magma_zmfree(&dx, queue );
+        magma_zmfree(&dy, queue );
+        magma_zmfree(&dz, queue );
+
+        i++;
+    }
+    printf("%%=============================================================%%\n");
+
+    magma_queue_destroy( queue );
+    TESTING_CHECK( magma_finalize() );
+    return info;
+}
@@ -26,15 +26,23 @@
 
 */
 #include "magma_internal.h"
+#include "magma_simd.h"  // internal header
 
 #define COMPLEX
 
+#ifdef COMPLEX
+static const magma_int_t ncomp = 2;  // reals per element
+#else
+static const magma_int_t ncomp = 1;
+#endif
+
 /***************************************************************************//**
     @return Sum of absolute values of vector x;
             \f$ \sum_i | real(x_i) | + | imag(x_i) | \f$.
 
     To avoid dependence on CBLAS and incompatability issues between BLAS
     libraries, MAGMA uses its own implementation, following BLAS reference.
+    Unit stride vectors use the vectorised kernels in control/magma_simd.cpp.
     
     @param[in]
     n       Number of elements in vector x. n >= 0.
@@ -58,9 +66,7 @@ double magma_cblas_dzasum(
     }
     double result = 0;
     if ( incx == 1 ) {
-        for( magma_int_t i=0; i < n; ++i ) {
-            result += MAGMA_Z_ABS1( x[i] );
-        }
+        result = magma_simd_asum( n*ncomp, (const double*) x );
     }
     else {
         magma_int_t nincx = n*incx;
@@ -79,6 +85,9 @@ static inline double sqr( double x ) { return x*x; }
 
     To avoid dependence on CBLAS and incompatability issues between BLAS
     libraries, MAGMA uses its own implementation, following BLAS reference.
+    Unit stride vectors use the vectorised kernels in control/magma_simd.cpp,
+    which scale by a power of two near 1/max_i |x_i| instead of updating
+    the scale per element.
     
     @param[in]
     n       Number of elements in vector x. n >= 0.
@@ -100,6 +109,9 @@ double magma_cblas_dznrm2(
     if (n <= 0 || incx <= 0) {
         return 0;
     }
+    else if (incx == 1) {
+        return magma_simd_nrm2( n*ncomp, (const double*) x );
+    }
     else {
         double scale = 0;
         double ssq   = 1;
@@ -171,9 +183,9 @@ magmaDoubleComplex magma_cblas_zdotc(
     magmaDoubleComplex value = MAGMA_Z_ZERO;
     magma_int_t i;
     if ( incx == 1 && incy == 1 ) {
-        for( i=0; i < n; ++i ) {
-            value = value + conj( x[i] ) * y[i];
-        }
+        double v[2];
+        magma_simd_dot_complex( n, (const double*) x, (const double*) y, true, v );
+        value = MAGMA_Z_MAKE( v[0], v[1] );
     }
     else {
         magma_int_t ix=0, iy=0;
@@ -225,9 +237,13 @@ magmaDoubleComplex magma_cblas_zdotu(
     magmaDoubleComplex value = MAGMA_Z_ZERO;
     magma_int_t i;
     if ( incx == 1 && incy == 1 ) {
-        for( i=0; i < n; ++i ) {
-            value = value + x[i] * y[i];
-        }
+        #ifdef COMPLEX
+        double v[2];
+        magma_simd_dot_complex( n, (const double*) x, (const double*) y, false, v );
+        value = MAGMA_Z_MAKE( v[0], v[1] );
+        #else
+        value = magma_simd_dot( n, (const double*) x, (const double*) y );
+        #endif
     }
     else {
         magma_int_t ix=0, iy=0;
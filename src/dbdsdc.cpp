@@ -0,0 +1,809 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal d -> s
+*/
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "magma_internal.h"
+
+#define REAL
+
+// size of the leaf subproblems, as ilaenv( 9, "dbdsdc", ... )
+const magma_int_t magma_dbdsdc_smlsiz = 25;
+
+
+/******************************************************************************/
+// Selection of singular values for the last merge, in the merge's scaled
+// units. For MagmaRangeI, il, iu are ranks in decreasing order.
+struct dbdsdc_select
+{
+    magma_range_t range;
+    double vl, vu;
+    magma_int_t il, iu;
+};
+
+
+/******************************************************************************/
+// Solves the secular equation and updates the singular vectors of a merged
+// node, as LAPACK's dlasd3, except:
+//  - the roots, and the vectors of the modified diagonal matrix, are
+//    computed in parallel with OpenMP (serially when already inside a
+//    parallel region, i.e., when several nodes are merged concurrently);
+//  - if sel is set, the updated vectors are computed only for the roots
+//    selected, which are contiguous; the others are left undefined.
+// Returns idxq, the permutation that sorts d into ascending order, since
+// the selection needs it.
+static void dbdsdc_secular(
+    magma_int_t nl, magma_int_t nr, magma_int_t sqre, magma_int_t k,
+    double *d, double *Q, magma_int_t ldq, double *dsigma,
+    double *U, magma_int_t ldu, double *U2, magma_int_t ldu2,
+    double *VT, magma_int_t ldvt, double *VT2, magma_int_t ldvt2,
+    const magma_int_t *idxc, const magma_int_t *ctot, double *z,
+    magma_int_t *idxq, double scale, const dbdsdc_select *sel,
+    magma_int_t *info )
+{
+    #define   Q(i_,j_) (Q   + (i_) + (j_)*ldq)
+    #define   U(i_,j_) (U   + (i_) + (j_)*ldu)
+    #define  U2(i_,j_) (U2  + (i_) + (j_)*ldu2)
+    #define  VT(i_,j_) (VT  + (i_) + (j_)*ldvt)
+    #define VT2(i_,j_) (VT2 + (i_) + (j_)*ldvt2)
+
+    const double c_one  = 1;
+    const double c_zero = 0;
+    const magma_int_t izero = 0;
+    const magma_int_t ione = 1;
+    const magma_int_t ineg_one = -1;
+
+    magma_int_t n    = nl + nr + 1;
+    magma_int_t m    = n + sqre;
+    magma_int_t nlp1 = nl + 1;
+    magma_int_t nk   = n - k;
+    magma_int_t i, j, ktemp, ctemp, iinfo;
+    double rho;
+
+    *info = 0;
+    if (k == 1) {
+        d[0] = fabs( z[0] );
+        blasf77_dcopy( &m, VT2(0,0), &ldvt2, VT(0,0), &ldvt );
+        if (z[0] > 0) {
+            blasf77_dcopy( &n, U2(0,0), &ione, U(0,0), &ione );
+        }
+        else {
+            for (i = 0; i < n; ++i) {
+                *U(i,0) = -*U2(i,0);
+            }
+        }
+        lapackf77_dlamrg( &k, &nk, d, &ione, &ineg_one, idxq );
+        return;
+    }
+
+    // keep a copy of z, and normalize it
+    blasf77_dcopy( &k, z, &ione, Q, &ione );
+    rho = magma_cblas_dnrm2( k, z, ione );
+    lapackf77_dlascl( "G", &izero, &izero, &rho, &c_one, &k, &ione, z, &k, &iinfo );
+    rho = rho*rho;
+
+    // find the new singular values
+    #pragma omp parallel for schedule(dynamic, 16) private(iinfo)
+    for (j = 0; j < k; ++j) {
+        magma_int_t jj = j + 1;
+        lapackf77_dlasd4( &k, &jj, dsigma, z, U(0,j), &rho, &d[j], VT(0,j), &iinfo );
+        if (iinfo != 0) {
+            #pragma omp critical (magma_dbdsdc)
+            *info = iinfo;
+        }
+    }
+    if (*info != 0) {
+        return;
+    }
+
+    // prepare the idxq sorting permutation, and the roots selected
+    lapackf77_dlamrg( &k, &nk, d, &ione, &ineg_one, idxq );
+    magma_int_t jlo = 0, jhi = k - 1;
+    if (sel != NULL && sel->range != MagmaRangeAll) {
+        // widen (vl,vu] by a few ulps, to cover rounding in the unscaling
+        double slack = 8*lapackf77_dlamch( "Precision" );
+        double vl = sel->vl*(1 - slack);
+        double vu = sel->vu*(1 + slack);
+        jlo = k;
+        jhi = -1;
+        for (i = 0; i < n; ++i) {
+            // ascending position i is rank n - i in decreasing order
+            magma_int_t jj = idxq[i] - 1;
+            bool wanted = (sel->range == MagmaRangeI
+                           ? (n - i >= sel->il && n - i <= sel->iu)
+                           : (d[jj]*scale > vl && d[jj]*scale <= vu));
+            if (wanted && jj < k) {
+                jlo = min( jlo, jj );
+                jhi = max( jhi, jj );
+            }
+        }
+        if (jhi < jlo) {
+            return;
+        }
+    }
+    magma_int_t ksel = jhi - jlo + 1;
+
+    // compute updated z
+    #pragma omp parallel for schedule(static) private(j)
+    for (i = 0; i < k; ++i) {
+        double zi = *U(i,k-1) * *VT(i,k-1);
+        for (j = 0; j < i; ++j) {
+            zi *= ( *U(i,j) * *VT(i,j) / (dsigma[i] - dsigma[j]) / (dsigma[i] + dsigma[j]) );
+        }
+        for (j = i; j < k-1; ++j) {
+            zi *= ( *U(i,j) * *VT(i,j) / (dsigma[i] - dsigma[j+1]) / (dsigma[i] + dsigma[j+1]) );
+        }
+        z[i] = copysign( sqrt( fabs( zi )), *Q(i,0) );
+    }
+
+    // left singular vectors of the modified diagonal matrix, and
+    // the related information for the right singular vectors
+    #pragma omp parallel for schedule(static) private(j)
+    for (i = jlo; i <= jhi; ++i) {
+        *VT(0,i) = z[0] / *U(0,i) / *VT(0,i);
+        *U(0,i) = -1;
+        for (j = 1; j < k; ++j) {
+            *VT(j,i) = z[j] / *U(j,i) / *VT(j,i);
+            *U(j,i) = dsigma[j] * *VT(j,i);
+        }
+        double temp = magma_cblas_dnrm2( k, U(0,i), ione );
+        *Q(0,i) = *U(0,i) / temp;
+        for (j = 1; j < k; ++j) {
+            *Q(j,i) = *U(idxc[j]-1, i) / temp;
+        }
+    }
+
+    // update the left singular vectors
+    if (k == 2) {
+        blasf77_dgemm( "N", "N", &n, &ksel, &k,
+                       &c_one,  U2, &ldu2, Q(0,jlo), &ldq,
+                       &c_zero, U(0,jlo), &ldu );
+    }
+    else {
+        if (ctot[0] > 0) {
+            blasf77_dgemm( "N", "N", &nl, &ksel, &ctot[0],
+                           &c_one,  U2(0,1), &ldu2, Q(1,jlo), &ldq,
+                           &c_zero, U(0,jlo), &ldu );
+            if (ctot[2] > 0) {
+                ktemp = 1 + ctot[0] + ctot[1];
+                blasf77_dgemm( "N", "N", &nl, &ksel, &ctot[2],
+                               &c_one, U2(0,ktemp), &ldu2, Q(ktemp,jlo), &ldq,
+                               &c_one, U(0,jlo), &ldu );
+            }
+        }
+        else if (ctot[2] > 0) {
+            ktemp = 1 + ctot[0] + ctot[1];
+            blasf77_dgemm( "N", "N", &nl, &ksel, &ctot[2],
+                           &c_one,  U2(0,ktemp), &ldu2, Q(ktemp,jlo), &ldq,
+                           &c_zero, U(0,jlo), &ldu );
+        }
+        else {
+            lapackf77_dlacpy( "F", &nl, &ksel, U2, &ldu2, U(0,jlo), &ldu );
+        }
+        blasf77_dcopy( &ksel, Q(0,jlo), &ldq, U(nl,jlo), &ldu );
+        ktemp = 1 + ctot[0];
+        ctemp = ctot[1] + ctot[2];
+        blasf77_dgemm( "N", "N", &nr, &ksel, &ctemp,
+                       &c_one,  U2(nlp1,ktemp), &ldu2, Q(ktemp,jlo), &ldq,
+                       &c_zero, U(nlp1,jlo), &ldu );
+    }
+
+    // generate the right singular vectors
+    #pragma omp parallel for schedule(static) private(j)
+    for (i = jlo; i <= jhi; ++i) {
+        double temp = magma_cblas_dnrm2( k, VT(0,i), ione );
+        *Q(i,0) = *VT(0,i) / temp;
+        for (j = 1; j < k; ++j) {
+            *Q(i,j) = *VT(idxc[j]-1, i) / temp;
+        }
+    }
+
+    // update the right singular vectors
+    if (k == 2) {
+        blasf77_dgemm( "N", "N", &ksel, &m, &k,
+                       &c_one,  Q(jlo,0), &ldq, VT2, &ldvt2,
+                       &c_zero, VT(jlo,0), &ldvt );
+        return;
+    }
+    ktemp = 1 + ctot[0];
+    blasf77_dgemm( "N", "N", &ksel, &nlp1, &ktemp,
+                   &c_one,  Q(jlo,0), &ldq, VT2(0,0), &ldvt2,
+                   &c_zero, VT(jlo,0), &ldvt );
+    ktemp = 1 + ctot[0] + ctot[1];
+    if (ktemp < ldvt2) {
+        blasf77_dgemm( "N", "N", &ksel, &nlp1, &ctot[2],
+                       &c_one, Q(jlo,ktemp), &ldq, VT2(ktemp,0), &ldvt2,
+                       &c_one, VT(jlo,0), &ldvt );
+    }
+    ktemp = ctot[0];
+    magma_int_t nrp1 = nr + sqre;
+    if (ktemp > 0) {
+        for (i = jlo; i <= jhi; ++i) {
+            *Q(i,ktemp) = *Q(i,0);
+        }
+        for (i = nlp1; i < m; ++i) {
+            *VT2(ktemp,i) = *VT2(0,i);
+        }
+    }
+    ctemp = 1 + ctot[1] + ctot[2];
+    blasf77_dgemm( "N", "N", &ksel, &nrp1, &ctemp,
+                   &c_one,  Q(jlo,ktemp), &ldq, VT2(ktemp,nlp1), &ldvt2,
+                   &c_zero, VT(jlo,nlp1), &ldvt );
+
+    #undef Q
+    #undef U
+    #undef U2
+    #undef VT
+    #undef VT2
+}
+
+
+/******************************************************************************/
+// Merges two solved subproblems, as LAPACK's dlasd1, with dlasd2 for the
+// deflation, and dbdsdc_secular for the rest.
+// work is 3*m^2 + 2*m, iwork is 4*n, for n = nl + nr + 1, m = n + sqre.
+static void dbdsdc_merge(
+    magma_int_t nl, magma_int_t nr, magma_int_t sqre,
+    double *d, double alpha, double beta,
+    double *U, magma_int_t ldu, double *VT, magma_int_t ldvt,
+    magma_int_t *idxq, magma_int_t *iwork, double *work,
+    const dbdsdc_select *sel,
+    magma_int_t *info )
+{
+    const double c_one = 1;
+    const magma_int_t izero = 0;
+    const magma_int_t ione = 1;
+
+    magma_int_t n = nl + nr + 1;
+    magma_int_t m = n + sqre;
+    magma_int_t ldu2 = n, ldvt2 = m, k, iinfo;
+
+    double *z      = work;
+    double *dsigma = z + m;
+    double *U2     = dsigma + n;
+    double *VT2    = U2 + ldu2*n;
+    double *Q      = VT2 + ldvt2*m;
+
+    magma_int_t *idx    = iwork;
+    magma_int_t *idxc   = idx + n;
+    magma_int_t *coltyp = idxc + n;
+    magma_int_t *idxp   = coltyp + n;
+
+    // scale
+    double orgnrm = max( fabs( alpha ), fabs( beta ));
+    d[nl] = 0;
+    for (magma_int_t i = 0; i < n; ++i) {
+        orgnrm = max( orgnrm, fabs( d[i] ));
+    }
+    lapackf77_dlascl( "G", &izero, &izero, &orgnrm, &c_one, &n, &ione, d, &n, &iinfo );
+    alpha /= orgnrm;
+    beta  /= orgnrm;
+
+    // deflate singular values
+    lapackf77_dlasd2( &nl, &nr, &sqre, &k, d, z, &alpha, &beta,
+                      U, &ldu, VT, &ldvt, dsigma, U2, &ldu2, VT2, &ldvt2,
+                      idxp, idx, idxc, idxq, coltyp, info );
+
+    // solve the secular equation and update the singular vectors
+    dbdsdc_secular( nl, nr, sqre, k, d, Q, k, dsigma, U, ldu, U2, ldu2,
+                    VT, ldvt, VT2, ldvt2, idxc, coltyp, z, idxq, orgnrm, sel, info );
+    if (*info != 0) {
+        return;
+    }
+
+    // unscale
+    lapackf77_dlascl( "G", &izero, &izero, &c_one, &orgnrm, &n, &ione, d, &n, &iinfo );
+}
+
+
+/******************************************************************************/
+// Divide and conquer on an upper bidiagonal n-by-(n+sqre) subproblem,
+// as LAPACK's dlasd0. Leaves are solved concurrently by dlasdq.
+// Each level of the tree is merged either a node per thread, when it has
+// at least as many nodes as threads, or one node at a time, with the
+// parallel secular solver and multithreaded BLAS.
+// If sel is set, the last merge computes only the selected vectors.
+// idxq is n, iwork is 7*n. work is 3*(n+1)^2 + 2*(n+1), but larger
+// levels are allocated separately.
+static void dbdsdc_dc(
+    magma_int_t n, magma_int_t sqre, double *d, double *e,
+    double *U, magma_int_t ldu, double *VT, magma_int_t ldvt,
+    magma_int_t *idxq, magma_int_t *iwork, double *work, magma_int_t lwork,
+    const dbdsdc_select *sel,
+    magma_int_t *info )
+{
+    #define  U(i_,j_) (U  + (i_) + (j_)*ldu)
+    #define VT(i_,j_) (VT + (i_) + (j_)*ldvt)
+
+    const magma_int_t smlsiz = magma_dbdsdc_smlsiz;
+    const magma_int_t izero = 0;
+
+    magma_int_t m = n + sqre;
+    *info = 0;
+    if (n <= smlsiz) {
+        lapackf77_dlasdq( "U", &sqre, &n, &m, &n, &izero, d, e,
+                          VT, &ldvt, U, &ldu, U, &ldu, work, info );
+        for (magma_int_t j = 0; j < n; ++j) {
+            idxq[j] = j + 1;  // dlasdq sorts into ascending order
+        }
+        return;
+    }
+
+    magma_int_t *inode = iwork;
+    magma_int_t *ndiml = inode + n;
+    magma_int_t *ndimr = ndiml + n;
+    magma_int_t *iwk   = ndimr + n;
+    magma_int_t nlvl, nd;
+    lapackf77_dlasdt( &n, &nlvl, &nd, inode, ndiml, ndimr, &smlsiz );
+
+    magma_int_t nthread = magma_get_parallel_numthreads();
+    magma_int_t lapack_nthread = magma_get_lapack_numthreads();
+
+    // solve the leaves with dlasdq; each uses 4*(smlsiz+1) of work
+    magma_int_t ndb1 = (nd + 1) / 2;
+    magma_int_t lwleaf = 4*(smlsiz + 1);
+    magma_set_lapack_numthreads( 1 );
+    #pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (magma_int_t i = ndb1 - 1; i < nd; ++i) {
+        magma_int_t ic   = inode[i] - 1;
+        magma_int_t nl   = ndiml[i];
+        magma_int_t nr   = ndimr[i];
+        magma_int_t nlf  = ic - nl;
+        magma_int_t nrf  = ic + 1;
+        magma_int_t sqrei = 1, nlp1 = nl + 1, nrp1, iinfo;
+        double *wleaf = work + (i - (ndb1 - 1))*lwleaf;
+        lapackf77_dlasdq( "U", &sqrei, &nl, &nlp1, &nl, &izero, &d[nlf], &e[nlf],
+                          VT(nlf,nlf), &ldvt, U(nlf,nlf), &ldu, U(nlf,nlf), &ldu,
+                          wleaf, &iinfo );
+        for (magma_int_t j = 0; j < nl; ++j) {
+            idxq[nlf + j] = j + 1;
+        }
+        sqrei = (i == nd - 1 ? sqre : 1);
+        nrp1 = nr + sqrei;
+        if (iinfo == 0) {
+            lapackf77_dlasdq( "U", &sqrei, &nr, &nrp1, &nr, &izero, &d[nrf], &e[nrf],
+                              VT(nrf,nrf), &ldvt, U(nrf,nrf), &ldu, U(nrf,nrf), &ldu,
+                              wleaf, &iinfo );
+        }
+        for (magma_int_t j = 0; j < nr; ++j) {
+            idxq[nrf + j] = j + 1;
+        }
+        if (iinfo != 0) {
+            #pragma omp critical (magma_dbdsdc)
+            *info = iinfo;
+        }
+    }
+    magma_set_lapack_numthreads( lapack_nthread );
+    if (*info != 0) {
+        return;
+    }
+
+    // conquer each level bottom-up
+    std::vector< magma_int_t > woff( nd + 1 );
+    std::vector< double > wlevel;
+    for (magma_int_t lvl = nlvl; lvl >= 1; --lvl) {
+        magma_int_t lf = (lvl == 1 ? 1 : (1 << (lvl-1)));
+        magma_int_t ll = (lvl == 1 ? 1 : 2*lf - 1);
+        magma_int_t nnode = ll - lf + 1;
+
+        // workspace for the nodes of this level
+        woff[0] = 0;
+        for (magma_int_t i = lf - 1; i < ll; ++i) {
+            magma_int_t sqrei = (sqre == 0 && i == ll - 1 ? sqre : 1);
+            magma_int_t mi = ndiml[i] + ndimr[i] + 1 + sqrei;
+            woff[i - lf + 2] = woff[i - lf + 1] + 3*mi*mi + 2*mi;
+        }
+        double *wbase = work;
+        if (woff[nnode] > lwork) {
+            wlevel.resize( woff[nnode] );
+            wbase = &wlevel[0];
+        }
+
+        bool concurrent = (nnode >= nthread && nthread > 1);
+        if (concurrent) {
+            magma_set_lapack_numthreads( 1 );
+        }
+        #pragma omp parallel for schedule(dynamic) num_threads(nthread) if (concurrent)
+        for (magma_int_t i = lf - 1; i < ll; ++i) {
+            magma_int_t ic  = inode[i] - 1;
+            magma_int_t nl  = ndiml[i];
+            magma_int_t nr  = ndimr[i];
+            magma_int_t nlf = ic - nl;
+            magma_int_t sqrei = (sqre == 0 && i == ll - 1 ? sqre : 1);
+            magma_int_t iinfo = 0;
+            dbdsdc_merge( nl, nr, sqrei, &d[nlf], d[ic], e[ic],
+                          U(nlf,nlf), ldu, VT(nlf,nlf), ldvt,
+                          &idxq[nlf], &iwk[4*nlf], wbase + woff[i - lf + 1],
+                          (lvl == 1 ? sel : NULL), &iinfo );
+            if (iinfo != 0) {
+                #pragma omp critical (magma_dbdsdc)
+                *info = iinfo;
+            }
+        }
+        if (concurrent) {
+            magma_set_lapack_numthreads( lapack_nthread );
+        }
+        if (*info != 0) {
+            return;
+        }
+    }
+
+    #undef U
+    #undef VT
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    DBDSDC computes the singular value decomposition (SVD) of a real
+    N-by-N (upper or lower) bidiagonal matrix B:  B = U * S * VT,
+    using a divide and conquer method, where S is a diagonal matrix
+    with non-negative diagonal elements (the singular values of B), and
+    U and VT are orthogonal matrices of left and right singular vectors,
+    respectively. Optionally, only a subset of the singular values and
+    vectors is returned.
+
+    This is a multi-threaded replacement for LAPACK's dbdsdc, with
+    COMPQ = 'N' or 'I'. Independent subproblems of the divide and conquer
+    tree are solved concurrently; near the root, the roots of each secular
+    equation are found in parallel with OpenMP, and the singular vectors
+    are updated by multithreaded dgemm. With a subset selected, the last
+    merge computes only the selected singular vectors.
+
+    Arguments
+    ---------
+    @param[in]
+    uplo    magma_uplo_t
+      -     = MagmaUpper:  B is upper bidiagonal.
+      -     = MagmaLower:  B is lower bidiagonal.
+
+    @param[in]
+    compq   magma_vec_t
+            Specifies whether singular vectors are to be computed:
+      -     = MagmaNoVec:  Compute singular values only;
+      -     = MagmaIVec:   Compute singular values and singular vectors.
+
+    @param[in]
+    range   magma_range_t
+      -     = MagmaRangeAll: all singular values will be found.
+      -     = MagmaRangeV:   all singular values in the half-open interval
+                             (VL,VU] will be found.
+      -     = MagmaRangeI:   the IL-th through IU-th singular values
+                             will be found, counting from the largest.
+
+    @param[in]
+    n       INTEGER
+            The order of the matrix B.  N >= 0.
+
+    @param[in,out]
+    d       DOUBLE PRECISION array, dimension (N)
+            On entry, the n diagonal elements of the bidiagonal matrix B.
+            On exit, if INFO=0, the first NFOUND elements contain the
+            selected singular values of B, in decreasing order.
+
+    @param[in,out]
+    e       DOUBLE PRECISION array, dimension (N-1)
+            On entry, the elements of E contain the offdiagonal
+            elements of the bidiagonal matrix whose SVD is desired.
+            On exit, E has been destroyed.
+
+    @param[out]
+    U       DOUBLE PRECISION array, dimension (LDU,N)
+            If COMPQ = MagmaIVec, then:
+               On exit, if INFO = 0, the first NFOUND columns of U contain
+               the left singular vectors of the bidiagonal matrix.
+            For other values of COMPQ, U is not referenced.
+
+    @param[in]
+    ldu     INTEGER
+            The leading dimension of the array U.  LDU >= 1.
+            If singular vectors are desired, then LDU >= max( 1, N ).
+
+    @param[out]
+    VT      DOUBLE PRECISION array, dimension (LDVT,N)
+            If COMPQ = MagmaIVec, then:
+               On exit, if INFO = 0, the first NFOUND rows of VT contain
+               the right singular vectors of the bidiagonal matrix.
+            For other values of COMPQ, VT is not referenced.
+
+    @param[in]
+    ldvt    INTEGER
+            The leading dimension of the array VT.  LDVT >= 1.
+            If singular vectors are desired, then LDVT >= max( 1, N ).
+
+    @param[in]
+    vl      DOUBLE PRECISION
+    @param[in]
+    vu      DOUBLE PRECISION
+            If RANGE = MagmaRangeV, the lower and upper bounds of the
+            interval to be searched for singular values. 0 <= VL < VU.
+            Not referenced if RANGE = MagmaRangeAll or MagmaRangeI.
+
+    @param[in]
+    il      INTEGER
+    @param[in]
+    iu      INTEGER
+            If RANGE = MagmaRangeI, the indices of the largest and smallest
+            singular values to be returned, with 1 the largest.
+            1 <= IL <= IU <= N, if N > 0; IL = 1 and IU = 0 if N = 0.
+            Not referenced if RANGE = MagmaRangeAll or MagmaRangeV.
+
+    @param[out]
+    nfound  INTEGER
+            The number of singular values found. 0 <= NFOUND <= N.
+            If RANGE = MagmaRangeAll, NFOUND = N; if RANGE = MagmaRangeI,
+            NFOUND = IU - IL + 1.
+
+    @param
+    work    (workspace) DOUBLE PRECISION array, dimension (MAX(1,LWORK))
+            If COMPQ = MagmaNoVec, LWORK >= 4*N.
+            If COMPQ = MagmaIVec,  LWORK >= 3*N**2 + 4*N, as for dbdsdc.
+            Levels of the tree that need more, when their nodes are
+            merged concurrently, are allocated separately.
+
+    @param
+    iwork   (workspace) INTEGER array, dimension (8*N)
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit.
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value.
+      -     > 0:  The algorithm failed to compute a singular value.
+                  The update process of divide and conquer failed.
+
+    @ingroup magma_gesvd_comp
+*******************************************************************************/
+extern "C" magma_int_t
+magma_dbdsdc(
+    magma_uplo_t uplo, magma_vec_t compq, magma_range_t range,
+    magma_int_t n, double *d, double *e,
+    double *U, magma_int_t ldu,
+    double *VT, magma_int_t ldvt,
+    double vl, double vu, magma_int_t il, magma_int_t iu,
+    magma_int_t *nfound,
+    double *work, magma_int_t *iwork,
+    magma_int_t *info )
+{
+    #define  U(i_,j_) (U  + (i_) + (j_)*ldu)
+    #define VT(i_,j_) (VT + (i_) + (j_)*ldvt)
+
+    const double c_zero = 0;
+    const double c_one  = 1;
+    const magma_int_t izero = 0;
+    const magma_int_t ione  = 1;
+
+    bool wantq  = (compq == MagmaIVec);
+    bool alleig = (range == MagmaRangeAll);
+    bool valeig = (range == MagmaRangeV);
+    bool indeig = (range == MagmaRangeI);
+
+    *info = 0;
+    *nfound = 0;
+    if (uplo != MagmaUpper && uplo != MagmaLower) {
+        *info = -1;
+    } else if (compq != MagmaNoVec && ! wantq) {
+        *info = -2;
+    } else if (! (alleig || valeig || indeig)) {
+        *info = -3;
+    } else if (n < 0) {
+        *info = -4;
+    } else if (ldu < 1 || (wantq && ldu < n)) {
+        *info = -8;
+    } else if (ldvt < 1 || (wantq && ldvt < n)) {
+        *info = -10;
+    } else if (valeig && (vl < 0 || vu <= vl)) {
+        *info = -12;
+    } else if (indeig && (il < 1 || il > max( 1, n ))) {
+        *info = -13;
+    } else if (indeig && (iu < min( n, il ) || iu > n)) {
+        *info = -14;
+    }
+
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    // Quick return if possible
+    if (n == 0) {
+        return *info;
+    }
+
+    magma_int_t nm1 = n - 1;
+    magma_int_t i, j;
+
+    if (! wantq || n == 1) {
+        // singular values only, by dqds as in dbdsdc; or n == 1
+        if (n == 1) {
+            if (wantq) {
+                *U(0,0) = copysign( c_one, d[0] );
+                *VT(0,0) = c_one;
+            }
+            d[0] = fabs( d[0] );
+        }
+        else {
+            lapackf77_dlasdq( lapack_uplo_const( uplo ), &izero, &n, &izero, &izero, &izero,
+                              d, e, VT, &ldvt, U, &ldu, U, &ldu, work, info );
+            if (*info != 0) {
+                return *info;
+            }
+        }
+        std::sort( d, d + n, std::greater< double >() );
+        magma_int_t ilo = 0, ihi = n - 1;
+        if (valeig) {
+            ilo = n;
+            ihi = -1;
+            for (i = 0; i < n; ++i) {
+                if (d[i] > vl && d[i] <= vu) {
+                    ilo = min( ilo, i );
+                    ihi = max( ihi, i );
+                }
+            }
+        }
+        else if (indeig) {
+            ilo = il - 1;
+            ihi = iu - 1;
+        }
+        *nfound = max( 0, ihi - ilo + 1 );
+        if (ilo > 0) {
+            for (i = 0; i < *nfound; ++i) {
+                d[i] = d[ilo + i];
+            }
+        }
+        return *info;
+    }
+
+    // if B is lower bidiagonal, rotate it to upper bidiagonal, by
+    // Givens rotations on the left, saved in work[0:2n-2)
+    magma_int_t wstart = 0;
+    if (uplo == MagmaLower) {
+        for (i = 0; i < nm1; ++i) {
+            double cs, sn, r;
+            lapackf77_dlartg( &d[i], &e[i], &cs, &sn, &r );
+            d[i] = r;
+            e[i] = sn*d[i+1];
+            d[i+1] = cs*d[i+1];
+            work[i] = cs;
+            work[nm1 + i] = -sn;
+        }
+        wstart = 2*nm1;
+    }
+    double *dwork = work + wstart;
+    magma_int_t ldwork = 3*n*n + 4*n - wstart;
+
+    lapackf77_dlaset( "F", &n, &n, &c_zero, &c_one, U,  &ldu );
+    lapackf77_dlaset( "F", &n, &n, &c_zero, &c_one, VT, &ldvt );
+
+    // scale
+    double orgnrm = lapackf77_dlanst( "M", &n, d, e );
+    if (orgnrm == 0) {
+        *nfound = (indeig ? iu - il + 1 : (alleig ? n : 0));
+        return *info;
+    }
+    magma_int_t iinfo;
+    lapackf77_dlascl( "G", &izero, &izero, &orgnrm, &c_one, &n,   &ione, d, &n,   &iinfo );
+    lapackf77_dlascl( "G", &izero, &izero, &orgnrm, &c_one, &nm1, &ione, e, &nm1, &iinfo );
+
+    double eps = 0.9*lapackf77_dlamch( "Epsilon" );
+    for (i = 0; i < n; ++i) {
+        if (fabs( d[i] ) < eps) {
+            d[i] = copysign( eps, d[i] );
+        }
+    }
+
+    // split at negligible e[i], and apply divide and conquer to each
+    // subproblem. If B does not split, the selection is applied in the
+    // last merge; idxq then orders all n singular values.
+    magma_int_t *idxq  = iwork;
+    magma_int_t *iwk   = iwork + n;
+    dbdsdc_select sel = { range, vl/orgnrm, vu/orgnrm, il, iu };
+    bool whole = false;
+    magma_int_t start = 0;
+    for (i = 0; i < nm1; ++i) {
+        if (fabs( e[i] ) < eps || i == nm1 - 1) {
+            magma_int_t nsize;
+            if (i < nm1 - 1) {
+                nsize = i - start + 1;
+            }
+            else if (fabs( e[i] ) >= eps) {
+                nsize = n - start;
+            }
+            else {
+                // e[n-2] negligible; solve the 1-by-1 subproblem d[n-1] first
+                nsize = i - start + 1;
+                *U(nm1,nm1) = copysign( c_one, d[nm1] );
+                *VT(nm1,nm1) = c_one;
+                d[nm1] = fabs( d[nm1] );
+            }
+            whole = (nsize == n);
+            dbdsdc_dc( nsize, 0, &d[start], &e[start],
+                       U(start,start), ldu, VT(start,start), ldvt,
+                       &idxq[start], iwk, dwork, ldwork,
+                       (whole ? &sel : NULL), info );
+            if (*info != 0) {
+                return *info;
+            }
+            start = i + 1;
+        }
+    }
+
+    // unscale
+    lapackf77_dlascl( "G", &izero, &izero, &c_one, &orgnrm, &n, &ione, d, &n, &iinfo );
+
+    // order of the singular values, decreasing
+    std::vector< magma_int_t > perm( n );
+    if (whole) {
+        for (j = 0; j < n; ++j) {
+            perm[j] = idxq[n - 1 - j] - 1;
+        }
+    }
+    else {
+        for (j = 0; j < n; ++j) {
+            perm[j] = j;
+        }
+        std::stable_sort( perm.begin(), perm.end(),
+                          [d]( magma_int_t a, magma_int_t b ) { return d[a] > d[b]; } );
+    }
+
+    // selected range of the ordering
+    magma_int_t ilo = 0, ihi = n - 1;
+    if (valeig) {
+        ilo = n;
+        ihi = -1;
+        for (j = 0; j < n; ++j) {
+            double s = d[ perm[j] ];
+            if (s > vl && s <= vu) {
+                ilo = min( ilo, j );
+                ihi = max( ihi, j );
+            }
+        }
+    }
+    else if (indeig) {
+        ilo = il - 1;
+        ihi = iu - 1;
+    }
+    magma_int_t ns = max( 0, ihi - ilo + 1 );
+    *nfound = ns;
+
+    // gather the selected singular triplets, in order
+    if (ns > 0) {
+        std::vector< double > s( ns ), Us( n*ns ), VTs( ns*n );
+        #pragma omp parallel for schedule(static) private(i)
+        for (j = 0; j < ns; ++j) {
+            magma_int_t p = perm[ilo + j];
+            s[j] = d[p];
+            for (i = 0; i < n; ++i) {
+                Us[i + j*n] = *U(i,p);
+            }
+            for (i = 0; i < n; ++i) {
+                VTs[j + i*ns] = *VT(p,i);
+            }
+        }
+        blasf77_dcopy( &ns, &s[0], &ione, d, &ione );
+        lapackf77_dlacpy( "F", &n, &ns, &Us[0],  &n,  U,  &ldu  );
+        lapackf77_dlacpy( "F", &ns, &n, &VTs[0], &ns, VT, &ldvt );
+    }
+
+    // if B is lower bidiagonal, apply the rotations to U
+    if (uplo == MagmaLower && ns > 0) {
+        lapackf77_dlasr( "L", "V", "B", &n, &ns, &work[0], &work[nm1], U, &ldu );
+    }
+
+    return *info;
+
+    #undef U
+    #undef VT
+}
@@ -215,7 +215,7 @@ magma_dgesdd(
     double dummy[1], unused[1];
     double anrm, bignum, eps, smlnum;
     magma_int_t ivt, iscl;
-    magma_int_t idummy[1], ierr, itau;
+    magma_int_t ierr, itau, nfound;
     magma_int_t chunk, wrkbl, itaup, itauq;
     magma_int_t nwork;
     magma_int_t ldwrkl, ldwrkr, ldwrku, ldwrkvt, minwrk, maxwrk, mnthr;
@@ -723,7 +723,7 @@ magma_dgesdd(
 
                 // Perform bidiagonal SVD, computing singular values only
                 // Workspace: need   N [e] + 4*N [bdsdc work]
-                lapackf77_dbdsdc( "U", "N", &n, s, &work[ie], dummy, &ione, dummy, &ione, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaNoVec, MagmaRangeAll, n, s, &work[ie], NULL, 1, NULL, 1, 0, 0, 0, 0, &nfound, &work[nwork], iwork, info );
             }                                                     //
             else if (want_qo) {                                   //
                 // Path 2 (M >> N, JOBZ='O')
@@ -786,7 +786,7 @@ magma_dgesdd(
                 // computing left  singular vectors of bidiagonal matrix in WORK[IU] and
                 // computing right singular vectors of bidiagonal matrix in VT
                 // Workspace: need   N*N [R] + 3*N [e, tauq, taup] + N*N [U] + (3*N*N + 4*N) [bdsdc work]
-                lapackf77_dbdsdc( "U", "I", &n, s, &work[ie], &work[iu], &n, VT, &ldvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, n, s, &work[ie], &work[iu], n, VT, ldvt, 0, 0, 0, 0, &nfound, &work[nwork], iwork, info );
 
                 // Overwrite WORK[IU] by left  singular vectors of R, and
                 // overwrite VT       by right singular vectors of R
@@ -865,7 +865,7 @@ magma_dgesdd(
                 // computing left  singular vectors of bidiagonal matrix in U and
                 // computing right singular vectors of bidiagonal matrix in VT
                 // Workspace: need   N*N [R] + 3*N [e, tauq, taup] + (3*N*N + 4*N) [bdsdc work]
-                lapackf77_dbdsdc( "U", "I", &n, s, &work[ie], U, &ldu, VT, &ldvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, n, s, &work[ie], U, ldu, VT, ldvt, 0, 0, 0, 0, &nfound, &work[nwork], iwork, info );
 
                 // Overwrite U  by left  singular vectors of R, and
                 // overwrite VT by right singular vectors of R
@@ -940,7 +940,7 @@ magma_dgesdd(
                 // computing left  singular vectors of bidiagonal matrix in WORK[IU] and
                 // computing right singular vectors of bidiagonal matrix in VT
                 // Workspace: need   N*N [U] + 3*N [e, tauq, taup] + (3*N*N + 4*N) [bdsdc work]
-                lapackf77_dbdsdc( "U", "I", &n, s, &work[ie], &work[iu], &n, VT, &ldvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, n, s, &work[ie], &work[iu], n, VT, ldvt, 0, 0, 0, 0, &nfound, &work[nwork], iwork, info );
 
                 // Overwrite WORK[IU] by left  singular vectors of R, and
                 // overwrite VT       by right singular vectors of R
@@ -989,7 +989,7 @@ magma_dgesdd(
                 dgesdd_path = "5n";
                 // Perform bidiagonal SVD, computing singular values only
                 // Workspace: need   3*N [e, tauq, taup] + 4*N [bdsdc work]
-                lapackf77_dbdsdc( "U", "N", &n, s, &work[ie], dummy, &ione, dummy, &ione, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaNoVec, MagmaRangeAll, n, s, &work[ie], NULL, 1, NULL, 1, 0, 0, 0, 0, &nfound, &work[nwork], iwork, info );
             }                                                     //
             else if (want_qo) {                                   //
                 // Path 5o (M >= N, JOBZ='O')
@@ -1017,7 +1017,7 @@ magma_dgesdd(
                 // computing left  singular vectors of bidiagonal matrix in WORK[IU] and
                 // computing right singular vectors of bidiagonal matrix in VT
                 // Workspace: need   3*N [e, tauq, taup] + N*N [U] + (3*N*N + 4*N) [bdsdc work]
-                lapackf77_dbdsdc( "U", "I", &n, s, &work[ie], &work[iu], &ldwrku, VT, &ldvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, n, s, &work[ie], &work[iu], ldwrku, VT, ldvt, 0, 0, 0, 0, &nfound, &work[nwork], iwork, info );
 
                 // Overwrite VT by right singular vectors of A
                 // Workspace: need   3*N [e, tauq, taup] + N*N [U] + N    [ormbr work]
@@ -1075,7 +1075,7 @@ magma_dgesdd(
                 // computing right singular vectors of bidiagonal matrix in VT
                 // Workspace: need   3*N [e, tauq, taup] + (3*N*N + 4*N) [bdsdc work]
                 lapackf77_dlaset( "F", &m, &n, &c_zero, &c_zero, U, &ldu );
-                lapackf77_dbdsdc( "U", "I", &n, s, &work[ie], U, &ldu, VT, &ldvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, n, s, &work[ie], U, ldu, VT, ldvt, 0, 0, 0, 0, &nfound, &work[nwork], iwork, info );
 
                 // Overwrite U  by left  singular vectors of A, and
                 // overwrite VT by right singular vectors of A
@@ -1098,7 +1098,7 @@ magma_dgesdd(
                 // computing right singular vectors of bidiagonal matrix in VT
                 // Workspace: need   3*N [e, tauq, taup] + (3*N*N + 4*N) [bdsdc work]
                 lapackf77_dlaset( "F", &m, &m, &c_zero, &c_zero, U, &ldu );
-                lapackf77_dbdsdc( "U", "I", &n, s, &work[ie], U, &ldu, VT, &ldvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, n, s, &work[ie], U, ldu, VT, ldvt, 0, 0, 0, 0, &nfound, &work[nwork], iwork, info );
 
                 // Set the right corner of U to identity matrix
                 if (m > n) {
@@ -1163,7 +1163,7 @@ magma_dgesdd(
 
                 // Perform bidiagonal SVD, computing singular values only
                 // Workspace: need   M [e] + 4*M [bdsdc work]
-                lapackf77_dbdsdc( "U", "N", &m, s, &work[ie], dummy, &ione, dummy, &ione, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaNoVec, MagmaRangeAll, m, s, &work[ie], NULL, 1, NULL, 1, 0, 0, 0, 0, &nfound, &work[nwork], iwork, info );
             }                                                     //
             else if (want_qo) {                                   //
                 // Path 2t (N >> M, JOBZ='O')
@@ -1225,7 +1225,7 @@ magma_dgesdd(
                 // computing left  singular vectors of bidiagonal matrix in U, and
                 // computing right singular vectors of bidiagonal matrix in WORK[IVT]
                 // Workspace: need   M*M [VT] + M*M [L] + 3*M [e, tauq, taup] + (3*M*M + 4*M) [bdsdc work]
-                lapackf77_dbdsdc( "U", "I", &m, s, &work[ie], U, &ldu, &work[ivt], &m, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, m, s, &work[ie], U, ldu, &work[ivt], m, 0, 0, 0, 0, &nfound, &work[nwork], iwork, info );
 
                 // Overwrite U         by left  singular vectors of L, and
                 // overwrite WORK[IVT] by right singular vectors of L
@@ -1308,7 +1308,7 @@ magma_dgesdd(
                 // computing left  singular vectors of bidiagonal matrix in U and
                 // computing right singular vectors of bidiagonal matrix in VT
                 // Workspace: need   M*M [L] + 3*M [e, tauq, taup] + (3*M*M + 4*M) [bdsdc work]
-                lapackf77_dbdsdc( "U", "I", &m, s, &work[ie], U, &ldu, VT, &ldvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, m, s, &work[ie], U, ldu, VT, ldvt, 0, 0, 0, 0, &nfound, &work[nwork], iwork, info );
 
                 // Overwrite U  by left  singular vectors of L, and
                 // overwrite VT by right singular vectors of L
@@ -1383,7 +1383,7 @@ magma_dgesdd(
                 // computing left  singular vectors of bidiagonal matrix in U and
                 // computing right singular vectors of bidiagonal matrix in WORK[IVT]
                 // Workspace: need   M*M [VT] + 3*M [e, tauq, taup] + (3*M*M + 4*M) [bdsdc work]
-                lapackf77_dbdsdc( "U", "I", &m, s, &work[ie], U, &ldu, &work[ivt], &ldwrkvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, m, s, &work[ie], U, ldu, &work[ivt], ldwrkvt, 0, 0, 0, 0, &nfound, &work[nwork], iwork, info );
 
                 // Overwrite U         by left  singular vectors of L, and
                 // overwrite WORK[IVT] by right singular vectors of L
@@ -1432,7 +1432,7 @@ magma_dgesdd(
                 dgesdd_path = "5tn";
                 // Perform bidiagonal SVD, computing singular values only
                 // Workspace: need   3*M [e, tauq, taup] + 4*M [bdsdc work]
-                lapackf77_dbdsdc( "L", "N", &m, s, &work[ie], dummy, &ione, dummy, &ione, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaNoVec, MagmaRangeAll, m, s, &work[ie], NULL, 1, NULL, 1, 0, 0, 0, 0, &nfound, &work[nwork], iwork, info );
             }                                                     //
             else if (want_qo) {                                   //
                 // Path 5to (N > M, JOBZ='O')
@@ -1460,7 +1460,7 @@ magma_dgesdd(
                 // computing left  singular vectors of bidiagonal matrix in U and
                 // computing right singular vectors of bidiagonal matrix in WORK[IVT]
                 // Workspace: need   3*M [e, tauq, taup] + M*M [VT] + (3*M*M + 4*M) [bdsdc work]
-                lapackf77_dbdsdc( "L", "I", &m, s, &work[ie], U, &ldu, &work[ivt], &ldwrkvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaIVec, MagmaRangeAll, m, s, &work[ie], U, ldu, &work[ivt], ldwrkvt, 0, 0, 0, 0, &nfound, &work[nwork], iwork, info );
 
                 // Overwrite U by left singular vectors of A
                 // Workspace: need   3*M [e, tauq, taup] + M*M [VT] + M    [ormbr work]
@@ -1517,7 +1517,7 @@ magma_dgesdd(
                 // computing right singular vectors of bidiagonal matrix in VT
                 // Workspace: need   3*M [e, tauq, taup] + (3*M*M + 4*M) [bdsdc work]
                 lapackf77_dlaset( "F", &m, &n, &c_zero, &c_zero, VT, &ldvt );
-                lapackf77_dbdsdc( "L", "I", &m, s, &work[ie], U, &ldu, VT, &ldvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaIVec, MagmaRangeAll, m, s, &work[ie], U, ldu, VT, ldvt, 0, 0, 0, 0, &nfound, &work[nwork], iwork, info );
 
                 // Overwrite U  by left  singular vectors of A, and
                 // overwrite VT by right singular vectors of A
@@ -1540,7 +1540,7 @@ magma_dgesdd(
                 // computing right singular vectors of bidiagonal matrix in VT
                 // Workspace: need   3*M [e, tauq, taup] + (3*M*M + 4*M) [bdsdc work]
                 lapackf77_dlaset( "F", &n, &n, &c_zero, &c_zero, VT, &ldvt );
-                lapackf77_dbdsdc( "L", "I", &m, s, &work[ie], U, &ldu, VT, &ldvt, dummy, idummy, &work[nwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaIVec, MagmaRangeAll, m, s, &work[ie], U, ldu, VT, ldvt, 0, 0, 0, 0, &nfound, &work[nwork], iwork, info );
 
                 // Set the right corner of VT to identity matrix
                 if (n > m) {
@@ -0,0 +1,509 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal d -> s
+*/
+#include "magma_internal.h"
+
+// Maximum number of iterations for one root, as in LAPACK dlaed4, where the
+// initial guess counts as the first.
+const magma_int_t magma_dlaed4_maxit = 30;
+
+
+/******************************************************************************/
+// Shifts the poles and evaluates the two halves of the secular function.
+// For every pole j, delta(j) = (d(j) - dorg) - eta if init, otherwise
+// delta(j) -= eta. Then, with terms t_j = z(j)^2 / delta(j),
+//     psi = sum_{j <  jlo} t_j,   dpsi = sum_{j <  jlo} (z(j) / delta(j))^2,
+//     phi = sum_{j >= jhi} t_j,   dphi = sum_{j >= jhi} (z(j) / delta(j))^2,
+// and the rounding error bound that dlaed4 accumulates from the partial sums,
+//     erretm = |sum_{j < jlo} (jlo - j) t_j| + sum_{j >= jhi} (j - jhi + 1) t_j,
+// which is the same sum, weighted by the number of partial sums containing
+// each term. Unlike dlaed4, which makes separate passes to shift delta and to
+// form each sum in order, this makes one pass over the poles, and the sums
+// are reductions that vectorize. Reordering a sum of terms of one sign does
+// not change its error bound.
+template< bool init >
+static void
+dlaed4_eval(
+    magma_int_t n, magma_int_t jlo, magma_int_t jhi,
+    const double *d, double dorg, const double *z, double eta, double *delta,
+    double *psi, double *dpsi, double *phi, double *dphi, double *erretm )
+{
+    double s = 0, ds = 0, es = 0;
+    #pragma omp simd reduction(+:s,ds,es)
+    for (magma_int_t j = 0; j < jlo; ++j) {
+        double dj = (init ? (d[j] - dorg) - eta : delta[j] - eta);
+        delta[j] = dj;
+        double t = z[j] / dj;
+        s  += z[j]*t;
+        ds += t*t;
+        es += double(jlo - j) * (z[j]*t);
+    }
+    *psi  = s;
+    *dpsi = ds;
+    *erretm = fabs( es );
+
+    for (magma_int_t j = jlo; j < jhi; ++j) {
+        delta[j] = (init ? (d[j] - dorg) - eta : delta[j] - eta);
+    }
+
+    s = 0;  ds = 0;  es = 0;
+    #pragma omp simd reduction(+:s,ds,es)
+    for (magma_int_t j = jhi; j < n; ++j) {
+        double dj = (init ? (d[j] - dorg) - eta : delta[j] - eta);
+        delta[j] = dj;
+        double t = z[j] / dj;
+        s  += z[j]*t;
+        ds += t*t;
+        es += double(j - jhi + 1) * (z[j]*t);
+    }
+    *phi  = s;
+    *dphi = ds;
+    *erretm += es;
+}
+
+
+/******************************************************************************/
+// Sum of z(j)^2 / ((d(j) - dorg) - shift) over poles j in [jbeg, jend).
+static double
+dlaed4_sum(
+    magma_int_t jbeg, magma_int_t jend,
+    const double *d, double dorg, const double *z, double shift )
+{
+    double s = 0;
+    #pragma omp simd reduction(+:s)
+    for (magma_int_t j = jbeg; j < jend; ++j) {
+        s += z[j]*z[j] / ((d[j] - dorg) - shift);
+    }
+    return s;
+}
+
+
+/******************************************************************************/
+// Computes the largest root, i = n (1-based), as the I = N case of dlaed4.
+// On exit, delta(j) = d(j) - lambda and *dlam = lambda.
+static magma_int_t
+dlaed4_last(
+    magma_int_t n, const double *d, const double *z, double *delta,
+    double rho, double rhoinv, double eps, double *dlam )
+{
+    double a, b, c, w, tau, eta, temp, del, dltlb, dltub;
+    double psi, dpsi, phi, dphi, erretm;
+    magma_int_t ii = n-2;  // 0-based index of d(n-1)
+    magma_int_t in = n-1;  // 0-based index of d(n)
+
+    // initial guess
+    double midpt = rho / 2;
+    double zn1 = z[ii]*z[ii], zn = z[in]*z[in];
+    c = rhoinv + dlaed4_sum( 0, n-2, d, d[in], z, midpt );
+    w = c + zn1 / ((d[ii] - d[in]) - midpt) + zn / (-midpt);
+
+    del = d[in] - d[ii];
+    a = -c*del + zn1 + zn;
+    b = zn*del;
+    if (w <= 0) {
+        temp = zn1 / (del + rho) + zn / rho;
+        if (c <= temp) {
+            tau = rho;
+        }
+        else if (a < 0) {
+            tau = 2*b / (sqrt( a*a + 4*b*c ) - a);
+        }
+        else {
+            tau = (a + sqrt( a*a + 4*b*c )) / (2*c);
+        }
+        // d(n) + rho/2 <= lambda(n) < d(n) + tau <= d(n) + rho
+        dltlb = midpt;
+        dltub = rho;
+    }
+    else {
+        if (a < 0) {
+            tau = 2*b / (sqrt( a*a + 4*b*c ) - a);
+        }
+        else {
+            tau = (a + sqrt( a*a + 4*b*c )) / (2*c);
+        }
+        // d(n) < d(n) + tau < lambda(n) < d(n) + rho/2
+        dltlb = 0;
+        dltub = midpt;
+    }
+
+    dlaed4_eval< true >( n, n-1, n-1, d, d[in], z, tau, delta,
+                         &psi, &dpsi, &phi, &dphi, &erretm );
+    // here the bound of dlaed4 has only the psi terms; eval also added phi
+    erretm = 8*(-phi - psi) + (erretm - phi) - phi + rhoinv + fabs( tau )*(dpsi + dphi);
+    w = rhoinv + phi + psi;
+
+    for (magma_int_t niter = 1; niter < magma_dlaed4_maxit; ++niter) {
+        // test for convergence
+        if (fabs( w ) <= eps*erretm) {
+            *dlam = d[in] + tau;
+            return 0;
+        }
+        if (w <= 0) {
+            dltlb = max( dltlb, tau );
+        }
+        else {
+            dltub = min( dltub, tau );
+        }
+
+        // calculate the new step
+        c = w - delta[ii]*dpsi - delta[in]*dphi;
+        a = (delta[ii] + delta[in])*w - delta[ii]*delta[in]*(dpsi + dphi);
+        b = delta[ii]*delta[in]*w;
+        if (niter == 1 && c < 0) {
+            c = fabs( c );
+        }
+        if (niter == 1 && c == 0) {
+            eta = -w / (dpsi + dphi);
+        }
+        else if (a >= 0) {
+            eta = (a + sqrt( fabs( a*a - 4*b*c ))) / (2*c);
+        }
+        else {
+            eta = 2*b / (a - sqrt( fabs( a*a - 4*b*c )));
+        }
+        // eta should have the opposite sign of w; if roundoff says otherwise,
+        // take a Newton step instead
+        if (w*eta > 0) {
+            eta = -w / (dpsi + dphi);
+        }
+        temp = tau + eta;
+        if (temp > dltub || temp < dltlb) {
+            eta = (w < 0 ? (dltub - tau) / 2 : (dltlb - tau) / 2);
+        }
+        tau += eta;
+
+        dlaed4_eval< false >( n, n-1, n-1, d, d[in], z, eta, delta,
+                              &psi, &dpsi, &phi, &dphi, &erretm );
+        erretm = 8*(-phi - psi) + (erretm - phi) - phi + rhoinv + fabs( tau )*(dpsi + dphi);
+        w = rhoinv + phi + psi;
+    }
+
+    // not converged
+    *dlam = d[in] + tau;
+    return 1;
+}
+
+
+/******************************************************************************/
+// Computes root i < n (0-based i < n-1), as the I < N case of dlaed4,
+// interpolating with the two poles around the root, or three once the root is
+// known to lie away from them (the "middle way" and "fixed weight" schemes).
+// On exit, delta(j) = d(j) - lambda and *dlam = lambda.
+static magma_int_t
+dlaed4_interior(
+    magma_int_t n, magma_int_t i, const double *d, const double *z, double *delta,
+    double rhoinv, double eps, double *dlam )
+{
+    double a, b, c, w, dw, prew, tau, eta, temp, temp1, del, dltlb, dltub;
+    double psi, dpsi, phi, dphi, erretm, zz[3];
+    magma_int_t ip1 = i+1;
+    magma_int_t iinfo = 0;
+
+    // initial guess
+    del = d[ip1] - d[i];
+    double midpt = del / 2;
+    double zi = z[i]*z[i], zip1 = z[ip1]*z[ip1];
+    c = rhoinv + dlaed4_sum( 0, i, d, d[i], z, midpt )
+               + dlaed4_sum( i+2, n, d, d[i], z, midpt );
+    w = c + zi / (-midpt) + zip1 / (del - midpt);
+
+    bool orgati = (w > 0);
+    if (orgati) {
+        // d(i) < lambda(i) < (d(i) + d(i+1)) / 2; origin at d(i)
+        a = c*del + zi + zip1;
+        b = zi*del;
+        if (a > 0) {
+            tau = 2*b / (a + sqrt( fabs( a*a - 4*b*c )));
+        }
+        else {
+            tau = (a - sqrt( fabs( a*a - 4*b*c ))) / (2*c);
+        }
+        dltlb = 0;
+        dltub = midpt;
+    }
+    else {
+        // (d(i) + d(i+1)) / 2 <= lambda(i) < d(i+1); origin at d(i+1)
+        a = c*del - zi - zip1;
+        b = zip1*del;
+        if (a < 0) {
+            tau = 2*b / (a - sqrt( fabs( a*a + 4*b*c )));
+        }
+        else {
+            tau = -(a + sqrt( fabs( a*a + 4*b*c ))) / (2*c);
+        }
+        dltlb = -midpt;
+        dltub = 0;
+    }
+    double dorg = (orgati ? d[i] : d[ip1]);
+    magma_int_t ii   = (orgati ? i : ip1);
+    magma_int_t iim1 = ii - 1;
+    magma_int_t iip1 = ii + 1;
+
+    dlaed4_eval< true >( n, ii, ii+1, d, dorg, z, tau, delta,
+                         &psi, &dpsi, &phi, &dphi, &erretm );
+    w = rhoinv + phi + psi;
+
+    // w is the secular function with the ii-th term removed; if its sign
+    // says the root lies away from pole ii, use three poles
+    bool swtch3 = (orgati ? w < 0 : w > 0);
+    if (ii == 0 || ii == n-1) {
+        swtch3 = false;
+    }
+
+    temp = z[ii] / delta[ii];
+    dw = dpsi + dphi + temp*temp;
+    temp = z[ii]*temp;
+    w += temp;
+    erretm = 8*(phi - psi) + erretm + 2*rhoinv + 3*fabs( temp ) + fabs( tau )*dw;
+
+    bool swtch = false;
+    for (magma_int_t niter = 1; niter < magma_dlaed4_maxit; ++niter) {
+        // test for convergence
+        if (fabs( w ) <= eps*erretm) {
+            *dlam = dorg + tau;
+            return 0;
+        }
+        if (w <= 0) {
+            dltlb = max( dltlb, tau );
+        }
+        else {
+            dltub = min( dltub, tau );
+        }
+
+        // calculate the new step
+        if (! swtch3) {
+            if (! swtch) {
+                if (orgati) {
+                    temp = z[i] / delta[i];
+                    c = w - delta[ip1]*dw - (d[i] - d[ip1])*temp*temp;
+                }
+                else {
+                    temp = z[ip1] / delta[ip1];
+                    c = w - delta[i]*dw - (d[ip1] - d[i])*temp*temp;
+                }
+            }
+            else {
+                temp = z[ii] / delta[ii];
+                if (orgati) {
+                    dpsi += temp*temp;
+                }
+                else {
+                    dphi += temp*temp;
+                }
+                c = w - delta[i]*dpsi - delta[ip1]*dphi;
+            }
+            a = (delta[i] + delta[ip1])*w - delta[i]*delta[ip1]*dw;
+            b = delta[i]*delta[ip1]*w;
+            if (c == 0) {
+                if (a == 0) {
+                    if (! swtch) {
+                        a = (orgati
+                             ? zi   + delta[ip1]*delta[ip1]*(dpsi + dphi)
+                             : zip1 + delta[i]  *delta[i]  *(dpsi + dphi));
+                    }
+                    else {
+                        a = delta[i]*delta[i]*dpsi + delta[ip1]*delta[ip1]*dphi;
+                    }
+                }
+                eta = b / a;
+            }
+            else if (a <= 0) {
+                eta = (a - sqrt( fabs( a*a - 4*b*c ))) / (2*c);
+            }
+            else {
+                eta = 2*b / (a + sqrt( fabs( a*a - 4*b*c )));
+            }
+        }
+        else {
+            // interpolation using the three most relevant poles
+            temp = rhoinv + psi + phi;
+            if (swtch) {
+                c = temp - delta[iim1]*dpsi - delta[iip1]*dphi;
+                zz[0] = delta[iim1]*delta[iim1]*dpsi;
+                zz[2] = delta[iip1]*delta[iip1]*dphi;
+            }
+            else if (orgati) {
+                temp1 = z[iim1] / delta[iim1];
+                temp1 *= temp1;
+                c = temp - delta[iip1]*(dpsi + dphi) - (d[iim1] - d[iip1])*temp1;
+                zz[0] = z[iim1]*z[iim1];
+                zz[2] = delta[iip1]*delta[iip1]*((dpsi - temp1) + dphi);
+            }
+            else {
+                temp1 = z[iip1] / delta[iip1];
+                temp1 *= temp1;
+                c = temp - delta[iim1]*(dpsi + dphi) - (d[iip1] - d[iim1])*temp1;
+                zz[0] = delta[iim1]*delta[iim1]*(dpsi + (dphi - temp1));
+                zz[2] = z[iip1]*z[iip1];
+            }
+            zz[1] = z[ii]*z[ii];
+            magma_int_t kniter = niter + 1;
+            magma_int_t lorgati = orgati;
+            lapackf77_dlaed6( &kniter, &lorgati, &c, &delta[iim1], zz, &w, &eta, &iinfo );
+            if (iinfo != 0) {
+                *dlam = dorg + tau;
+                return iinfo;
+            }
+        }
+
+        // eta should have the opposite sign of w; if roundoff says otherwise,
+        // take a Newton step instead
+        if (w*eta >= 0) {
+            eta = -w / dw;
+        }
+        temp = tau + eta;
+        if (temp > dltub || temp < dltlb) {
+            eta = (w < 0 ? (dltub - tau) / 2 : (dltlb - tau) / 2);
+        }
+        tau += eta;
+        prew = w;
+
+        dlaed4_eval< false >( n, ii, ii+1, d, dorg, z, eta, delta,
+                              &psi, &dpsi, &phi, &dphi, &erretm );
+        temp = z[ii] / delta[ii];
+        dw = dpsi + dphi + temp*temp;
+        temp = z[ii]*temp;
+        w = rhoinv + phi + psi + temp;
+        erretm = 8*(phi - psi) + erretm + 2*rhoinv + 3*fabs( temp ) + fabs( tau )*dw;
+
+        // switch between the middle way and fixed weight schemes when w does
+        // not decrease fast enough
+        if (niter == 1) {
+            swtch = (orgati ? -w > fabs( prew ) / 10 : w > fabs( prew ) / 10);
+        }
+        else if (w*prew > 0 && fabs( w ) > fabs( prew ) / 10) {
+            swtch = ! swtch;
+        }
+    }
+
+    // not converged
+    *dlam = dorg + tau;
+    return 1;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    DLAED4_RANGE computes roots ifirst through ilast of the secular equation
+        1/rho + sum_{j=1}^n z(j)^2 / (d(j) - lambda) = 0,
+    i.e., eigenvalues ifirst through ilast of the rank-one modification
+    diag(d) + rho z z^T. It is the multi-root counterpart of LAPACK dlaed4,
+    used for the deflated merge in the divide and conquer eigensolver
+    (magma_dlaex3). A caller that needs only a subset of the roots, such as
+    one restricted by magma_dvrange or magma_dirange, passes that index range.
+
+    It follows dlaed4's iteration: the initial guesses, the middle way and
+    fixed weight schemes, the three-pole interpolation (via dlaed6), and
+    the stopping test on the accumulated rounding error bound are the same,
+    so the roots and the differences d(j) - lambda keep dlaed4's accuracy.
+    What differs is the evaluation of the secular function, which dominates
+    the cost for large n: each iteration makes one pass over the n poles,
+    shifting d(j) - lambda and accumulating the sums together, with the sums
+    written as SIMD reductions, instead of dlaed4's separate scalar passes.
+
+    Arguments
+    ---------
+    @param[in]
+    n       INTEGER
+            The length of all arrays.  N >= 1.
+
+    @param[in]
+    ifirst  INTEGER
+    @param[in]
+    ilast   INTEGER
+            The indices of the first and last roots to compute;
+            1 <= IFIRST <= ILAST <= N, or ILAST = IFIRST - 1 to compute none.
+
+    @param[in]
+    d       DOUBLE PRECISION array, dimension (N)
+            The original eigenvalues. It is assumed that they are in order,
+            D(I) < D(J) for I < J.
+
+    @param[in]
+    z       DOUBLE PRECISION array, dimension (N)
+            The components of the updating vector.
+
+    @param[out]
+    delta   DOUBLE PRECISION array, dimension (LDDELTA, ILAST-IFIRST+1)
+            Column j holds D(1:N) - LAMBDA(IFIRST+j-1), the information
+            needed to construct the corresponding eigenvector, as the DELTA
+            output of dlaed4.
+
+    @param[in]
+    lddelta INTEGER
+            The leading dimension of the array DELTA.  LDDELTA >= N.
+
+    @param[in]
+    rho     DOUBLE PRECISION
+            The scalar in the symmetric updating formula.  RHO > 0.
+
+    @param[out]
+    dlam    DOUBLE PRECISION array, dimension (ILAST-IFIRST+1)
+            The computed eigenvalues LAMBDA(IFIRST:ILAST).
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     > 0:  if INFO = 1, the updating process failed for some root,
+                  which is the first root in IFIRST:ILAST that failed.
+                  The remaining roots are still computed.
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value.
+
+    @ingroup magma_laex3
+*******************************************************************************/
+extern "C" void
+magma_dlaed4_range(
+    magma_int_t n, magma_int_t ifirst, magma_int_t ilast,
+    const double *d, const double *z,
+    double *delta, magma_int_t lddelta,
+    double rho, double *dlam,
+    magma_int_t *info )
+{
+    *info = 0;
+    if (n < 1)
+        *info = -1;
+    else if (ifirst < 1 || ifirst > n+1)
+        *info = -2;
+    else if (ilast < ifirst-1 || ilast > n)
+        *info = -3;
+    else if (lddelta < n)
+        *info = -7;
+
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return;
+    }
+
+    const double eps = lapackf77_dlamch( "Epsilon" );
+    const double rhoinv = 1 / rho;
+
+    for (magma_int_t i = ifirst; i <= ilast; ++i) {
+        double *del_i = delta + (i - ifirst)*lddelta;
+        double *lam_i = dlam  + (i - ifirst);
+        magma_int_t iinfo = 0;
+        if (n == 1) {
+            *lam_i = d[0] + rho*z[0]*z[0];
+            del_i[0] = 1;
+        }
+        else if (n == 2) {
+            lapackf77_dlaed5( &i, d, z, del_i, &rho, lam_i );
+        }
+        else if (i == n) {
+            iinfo = dlaed4_last( n, d, z, del_i, rho, rhoinv, eps, lam_i );
+        }
+        else {
+            iinfo = dlaed4_interior( n, i-1, d, z, del_i, rhoinv, eps, lam_i );
+        }
+        if (iinfo != 0 && *info == 0) {
+            *info = iinfo;
+        }
+    }
+}
@@ -331,15 +331,13 @@ magma_dlaex3(
         for (i = ibegin; i < iend; ++i)
             dlamda[i] = lapackf77_dlamc3(&dlamda[i], &dlamda[i]) - dlamda[i];
 
-        for (j = ibegin; j < iend; ++j) {
-            magma_int_t tmpp = j+1;
+        if (iend > ibegin) {
             magma_int_t iinfo = 0;
-            lapackf77_dlaed4(&k, &tmpp, dlamda, w, Q(0,j), &rho, &d[j], &iinfo);
+            magma_dlaed4_range( k, ibegin+1, iend, dlamda, w, Q(0,ibegin), ldq, rho, &d[ibegin], &iinfo );
             // If the zero finder fails, the computation is terminated.
             if (iinfo != 0) {
                 #pragma omp critical (magma_dlaex3)
                 *info = iinfo;
-                break;
             }
         }
 
@@ -445,14 +443,8 @@ magma_dlaex3(
     for (i = 0; i < k; ++i)
         dlamda[i] = lapackf77_dlamc3(&dlamda[i], &dlamda[i]) - dlamda[i];
 
-    for (j = 0; j < k; ++j) {
-        magma_int_t tmpp = j+1;
-        magma_int_t iinfo = 0;
-        lapackf77_dlaed4(&k, &tmpp, dlamda, w, Q(0,j), &rho, &d[j], &iinfo);
-        // If the zero finder fails, the computation is terminated.
-        if (iinfo != 0)
-            *info = iinfo;
-    }
+    // If the zero finder fails, the computation is terminated.
+    magma_dlaed4_range( k, 1, k, dlamda, w, Q(0,0), ldq, rho, d, info );
     if (*info != 0)
         return *info;
 
@@ -354,15 +354,13 @@ magma_dlaex3_m(
         for (i = ib; i < ie; ++i)
             dlamda[i]=lapackf77_dlamc3(&dlamda[i], &dlamda[i]) - dlamda[i];
 
-        for (j = ib; j < ie; ++j) {
-            magma_int_t tmpp=j+1;
+        if (ie > ib) {
             magma_int_t iinfo = 0;
-            lapackf77_dlaed4( &k, &tmpp, dlamda, w, Q(0,j), &rho, &d[j], &iinfo );
+            magma_dlaed4_range( k, ib+1, ie, dlamda, w, Q(0,ib), ldq, rho, &d[ib], &iinfo );
             // If the zero finder fails, the computation is terminated.
             if (iinfo != 0) {
                 #pragma omp critical (magma_dlaex3_m)
                 *info = iinfo;
-                break;
             }
         }
 
@@ -468,14 +466,8 @@ magma_dlaex3_m(
     for (i = 0; i < k; ++i)
         dlamda[i]=lapackf77_dlamc3(&dlamda[i], &dlamda[i]) - dlamda[i];
 
-    for (j = 0; j < k; ++j) {
-        magma_int_t tmpp=j+1;
-        magma_int_t iinfo = 0;
-        lapackf77_dlaed4( &k, &tmpp, dlamda, w, Q(0,j), &rho, &d[j], &iinfo );
-        // If the zero finder fails, the computation is terminated.
-        if (iinfo != 0)
-            *info=iinfo;
-    }
+    // If the zero finder fails, the computation is terminated.
+    magma_dlaed4_range( k, 1, k, dlamda, w, Q(0,0), ldq, rho, d, info );
     if (*info != 0)
         return *info;
 
@@ -0,0 +1,583 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal d -> s
+*/
+#include <algorithm>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "magma_internal.h"
+
+#define REAL
+
+// number of shifts per Sturm count; the recurrences for different shifts
+// are independent, so they are evaluated together, in SIMD lanes.
+#define NSHIFT 8
+
+
+/******************************************************************************/
+// Sturm counts of the n-by-n symmetric tridiagonal matrix with diagonal d
+// and squared off-diagonal e2, at the NSHIFT shifts x:
+// cnt[k] is the number of eigenvalues less than x[k], as in LAPACK's dlaebz.
+static void dstebz_count(
+    magma_int_t n, const double *d, const double *e2, double pivmin,
+    const double *x, magma_int_t *cnt )
+{
+    double q[NSHIFT];
+    magma_int_t c[NSHIFT];
+
+    #pragma omp simd
+    for (int k = 0; k < NSHIFT; ++k) {
+        q[k] = d[0] - x[k];
+        q[k] = (fabs( q[k] ) < pivmin ? -pivmin : q[k]);
+        c[k] = (q[k] <= 0);
+    }
+    for (magma_int_t j = 1; j < n; ++j) {
+        double dj = d[j], ej = e2[j-1];
+        #pragma omp simd
+        for (int k = 0; k < NSHIFT; ++k) {
+            q[k] = (dj - x[k]) - ej / q[k];
+            q[k] = (fabs( q[k] ) < pivmin ? -pivmin : q[k]);
+            c[k] += (q[k] <= 0);
+        }
+    }
+    for (int k = 0; k < NSHIFT; ++k) {
+        cnt[k] = c[k];
+    }
+}
+
+
+/******************************************************************************/
+// True if the interval [a, b] is small enough, as in LAPACK's dlaebz.
+static inline bool dstebz_converged(
+    double a, double b, double atol, double rtol, double pivmin )
+{
+    double tmp = max( fabs( a ), fabs( b ));
+    return (b - a) < max( atol, max( pivmin, rtol*tmp ));
+}
+
+
+/******************************************************************************/
+// Finds, by multisection, a point wl with count(wl) <= target (upper = false),
+// or wu with count(wu) >= target (upper = true), within the tolerance of the
+// eigenvalue that crosses target. [a, b] must enclose all eigenvalues.
+static void dstebz_threshold(
+    magma_int_t n, const double *d, const double *e2, double pivmin,
+    double a, double b, double atol, double rtol,
+    magma_int_t target, bool upper, double *x_out, magma_int_t *cnt_out )
+{
+    double x[NSHIFT];
+    magma_int_t cnt[NSHIFT];
+    magma_int_t na = 0, nb = n;
+
+    while (! dstebz_converged( a, b, atol, rtol, pivmin )) {
+        double h = (b - a) / (NSHIFT + 1);
+        for (int k = 0; k < NSHIFT; ++k) {
+            x[k] = a + (k + 1)*h;
+        }
+        dstebz_count( n, d, e2, pivmin, x, cnt );
+        double a0 = a, b0 = b;
+        for (int k = 0; k < NSHIFT; ++k) {
+            bool below = (upper ? cnt[k] < target : cnt[k] <= target);
+            if (below) {
+                a = x[k];
+                na = cnt[k];
+            }
+            else {
+                b = x[k];
+                nb = cnt[k];
+                break;
+            }
+        }
+        if (a == a0 && b == b0) {
+            break;  // no representable point in between
+        }
+    }
+    *x_out   = (upper ? b  : a );
+    *cnt_out = (upper ? nb : na);
+}
+
+
+/******************************************************************************/
+// A contiguous range ilo..ihi (1-based) of the eigenvalues of one block.
+struct dstebz_chunk
+{
+    magma_int_t block;    // block index, 0-based
+    magma_int_t ilo, ihi; // eigenvalue indices within the block, 1-based
+};
+
+// Interval [a, b], with counts na = count(a), nb = count(b).
+struct dstebz_interval
+{
+    double a, b;
+    magma_int_t na, nb;
+};
+
+
+/******************************************************************************/
+// Finds the eigenvalues ilo..ihi of the block of order nb starting at d, by
+// multisection of [a, b], with count(a) = na < ilo and count(b) = nb >= ihi.
+// Eigenvalue i is stored in w[i - ilo].
+static void dstebz_multisect(
+    magma_int_t n, const double *d, const double *e2, double pivmin,
+    double a, double b, magma_int_t na, magma_int_t nb,
+    double atol, double rtol,
+    magma_int_t ilo, magma_int_t ihi, double *w )
+{
+    double x[NSHIFT];
+    magma_int_t cnt[NSHIFT];
+
+    std::vector< dstebz_interval > stack;
+    stack.push_back( dstebz_interval{ a, b, na, nb } );
+    while (! stack.empty()) {
+        dstebz_interval iv = stack.back();
+        stack.pop_back();
+
+        magma_int_t lo = max( iv.na, ilo - 1 );
+        magma_int_t hi = min( iv.nb, ihi );
+        if (hi <= lo) {
+            continue;
+        }
+        if (dstebz_converged( iv.a, iv.b, atol, rtol, pivmin )) {
+            double mid = 0.5*(iv.a + iv.b);
+            for (magma_int_t i = lo + 1; i <= hi; ++i) {
+                w[i - ilo] = mid;
+            }
+            continue;
+        }
+
+        double h = (iv.b - iv.a) / (NSHIFT + 1);
+        for (int k = 0; k < NSHIFT; ++k) {
+            x[k] = iv.a + (k + 1)*h;
+        }
+        dstebz_count( n, d, e2, pivmin, x, cnt );
+
+        // push the subintervals, highest first, so the lowest is next
+        double xr = iv.b;
+        magma_int_t cr = iv.nb;
+        for (int k = NSHIFT - 1; k >= -1; --k) {
+            double xl = (k >= 0 ? x[k] : iv.a);
+            // counts are monotonic in exact arithmetic; enforce it
+            magma_int_t cl = (k >= 0 ? min( max( cnt[k], iv.na ), cr ) : iv.na);
+            if (cr > cl && xr > xl) {
+                stack.push_back( dstebz_interval{ xl, xr, cl, cr } );
+            }
+            else if (cr > cl) {
+                // not representable; the eigenvalues are at xl
+                for (magma_int_t i = max( cl, ilo - 1 ) + 1; i <= min( cr, ihi ); ++i) {
+                    w[i - ilo] = xl;
+                }
+            }
+            xr = xl;
+            cr = cl;
+        }
+    }
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    DSTEBZ computes the eigenvalues of a symmetric tridiagonal
+    matrix T.  The user may ask for all eigenvalues, all eigenvalues
+    in the half-open interval (VL, VU], or the IL-th through IU-th
+    eigenvalues.
+
+    This is a multi-threaded replacement for LAPACK's dstebz, with the same
+    splitting, tolerances, and outputs. The wanted eigenvalues of each block
+    are divided into chunks that are solved concurrently with OpenMP.
+    Each chunk is isolated by multisection: Sturm counts are evaluated at
+    several shifts at once, which vectorizes the recurrence across shifts.
+
+    To avoid overflow, the matrix must be scaled so that its
+    largest element is no greater than overflow**(1/2) * underflow**(1/4)
+    in absolute value, and for greatest accuracy, it should not be much
+    smaller than that.
+
+    See W. Kahan "Accurate Eigenvalues of a Symmetric Tridiagonal
+    Matrix", Report CS41, Computer Science Dept., Stanford
+    University, July 21, 1966.
+
+    Arguments
+    ---------
+    @param[in]
+    range   magma_range_t
+      -     = MagmaRangeAll: all eigenvalues will be found.
+      -     = MagmaRangeV:   all eigenvalues in the half-open interval
+                             (VL,VU] will be found.
+      -     = MagmaRangeI:   the IL-th through IU-th eigenvalues will be found.
+
+    @param[in]
+    byblock magma_bool_t
+      -     = MagmaTrue:  the eigenvalues are grouped by split-off block,
+                          and ordered from smallest to largest within each
+                          block, as magma_zstein requires (LAPACK's ORDER='B').
+      -     = MagmaFalse: the eigenvalues of the entire matrix are ordered
+                          from smallest to largest (LAPACK's ORDER='E').
+
+    @param[in]
+    n       INTEGER
+            The order of the tridiagonal matrix T.  N >= 0.
+
+    @param[in]
+    vl      DOUBLE PRECISION
+    @param[in]
+    vu      DOUBLE PRECISION
+            If RANGE=MagmaRangeV, the lower and upper bounds of the interval
+            to be searched for eigenvalues.  Eigenvalues less than or equal
+            to VL, or greater than VU, will not be returned.  VL < VU.
+            Not referenced if RANGE = MagmaRangeAll or MagmaRangeI.
+
+    @param[in]
+    il      INTEGER
+    @param[in]
+    iu      INTEGER
+            If RANGE=MagmaRangeI, the indices (in ascending order) of the
+            smallest and largest eigenvalues to be returned.
+            1 <= IL <= IU <= N, if N > 0; IL = 1 and IU = 0 if N = 0.
+            Not referenced if RANGE = MagmaRangeAll or MagmaRangeV.
+
+    @param[in]
+    abstol  DOUBLE PRECISION
+            The absolute tolerance for the eigenvalues.  An eigenvalue
+            (or cluster) is considered to be located if it has been
+            determined to lie in an interval whose width is ABSTOL or
+            less.  If ABSTOL is less than or equal to zero, then ULP*|T|
+            will be used, where |T| means the 1-norm of T.
+
+    @param[in]
+    d       DOUBLE PRECISION array, dimension (N)
+            The n diagonal elements of the tridiagonal matrix T.
+
+    @param[in]
+    e       DOUBLE PRECISION array, dimension (N-1)
+            The (n-1) off-diagonal elements of the tridiagonal matrix T.
+
+    @param[out]
+    m       INTEGER
+            The actual number of eigenvalues found. 0 <= M <= N.
+
+    @param[out]
+    nsplit  INTEGER
+            The number of diagonal blocks in the matrix T.
+            1 <= NSPLIT <= N.
+
+    @param[out]
+    w       DOUBLE PRECISION array, dimension (N)
+            On exit, the first M elements of W will contain the
+            eigenvalues, ordered according to BYBLOCK.
+
+    @param[out]
+    iblock  INTEGER array, dimension (N)
+            At each row/column j where E(j) is zero or small, the
+            matrix T is considered to split into a block diagonal
+            matrix.  On exit, IBLOCK(i) specifies to which block
+            (from 1 to the number of blocks) the eigenvalue W(i)
+            belongs.
+
+    @param[out]
+    isplit  INTEGER array, dimension (N)
+            The splitting points, at which T breaks up into submatrices.
+            The first submatrix consists of rows/columns 1 to ISPLIT(1),
+            the second of rows/columns ISPLIT(1)+1 through ISPLIT(2),
+            etc., and the NSPLIT-th consists of rows/columns
+            ISPLIT(NSPLIT-1)+1 through ISPLIT(NSPLIT)=N.
+
+    @param
+    work    (workspace) DOUBLE PRECISION array, dimension (4*N)
+
+    @param
+    iwork   (workspace) INTEGER array, dimension (3*N)
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+      -     = 4:  RANGE=MagmaRangeI, and the Gershgorin interval
+                  initially used was too small.  No eigenvalues
+                  were computed.
+
+    @ingroup magma_heev_comp
+*******************************************************************************/
+extern "C" magma_int_t
+magma_dstebz(
+    magma_range_t range, magma_bool_t byblock, magma_int_t n,
+    double vl, double vu, magma_int_t il, magma_int_t iu, double abstol,
+    const double *d, const double *e,
+    magma_int_t *m, magma_int_t *nsplit,
+    double *w, magma_int_t *iblock, magma_int_t *isplit,
+    double *work, magma_int_t *iwork,
+    magma_int_t *info )
+{
+    const double fudge  = 2.1;
+    const double relfac = 2;
+
+    bool alleig = (range == MagmaRangeAll);
+    bool valeig = (range == MagmaRangeV);
+    bool indeig = (range == MagmaRangeI);
+
+    *info = 0;
+    if (! (alleig || valeig || indeig)) {
+        *info = -1;
+    } else if (byblock != MagmaTrue && byblock != MagmaFalse) {
+        *info = -2;
+    } else if (n < 0) {
+        *info = -3;
+    } else if (valeig && vl >= vu) {
+        *info = -5;
+    } else if (indeig && (il < 1 || il > max( 1, n ))) {
+        *info = -6;
+    } else if (indeig && (iu < min( n, il ) || iu > n)) {
+        *info = -7;
+    }
+
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    // all eigenvalues, by index
+    if (indeig && il == 1 && iu == n) {
+        alleig = true;
+        indeig = false;
+    }
+
+    *m = 0;
+    *nsplit = 0;
+    if (n == 0) {
+        return *info;
+    }
+
+    double safemn = lapackf77_dlamch( "Safe minimum" );
+    double ulp    = lapackf77_dlamch( "Precision" );
+    double rtoli  = ulp*relfac;
+    magma_int_t i, j, ib;
+
+    // compute splitting points, and squares of the off-diagonal
+    double *e2 = work;
+    double pivmin = 1;
+    *nsplit = 1;
+    e2[n-1] = 0;
+    for (j = 1; j < n; ++j) {
+        double tmp = e[j-1]*e[j-1];
+        if (fabs( d[j]*d[j-1] )*ulp*ulp + safemn > tmp) {
+            isplit[*nsplit - 1] = j;
+            *nsplit += 1;
+            e2[j-1] = 0;
+        }
+        else {
+            e2[j-1] = tmp;
+            pivmin = max( pivmin, tmp );
+        }
+    }
+    isplit[*nsplit - 1] = n;
+    pivmin *= safemn;
+
+    // compute the interval (wl, wu]
+    double wl = 0, wu = 0, atoli = abstol;
+    magma_int_t nwl = 0, nwu = 0;
+    if (valeig) {
+        wl = vl;
+        wu = vu;
+    }
+    else if (indeig) {
+        // Gershgorin interval of the entire matrix
+        double gu = d[0], gl = d[0], tmp = 0;
+        for (j = 0; j < n - 1; ++j) {
+            double tmp2 = sqrt( e2[j] );
+            gu = max( gu, d[j] + tmp + tmp2 );
+            gl = min( gl, d[j] - tmp - tmp2 );
+            tmp = tmp2;
+        }
+        gu = max( gu, d[n-1] + tmp );
+        gl = min( gl, d[n-1] - tmp );
+        double tnorm = max( fabs( gl ), fabs( gu ));
+        gl = gl - fudge*tnorm*ulp*n - fudge*2*pivmin;
+        gu = gu + fudge*tnorm*ulp*n + fudge*pivmin;
+        if (abstol <= 0) {
+            atoli = ulp*tnorm;
+        }
+
+        dstebz_threshold( n, d, e2, pivmin, gl, gu, atoli, rtoli, il-1, false, &wl, &nwl );
+        dstebz_threshold( n, d, e2, pivmin, gl, gu, atoli, rtoli, iu,   true,  &wu, &nwu );
+        if (nwl < 0 || nwl >= n || nwu < 1 || nwu > n) {
+            *info = 4;
+            return *info;
+        }
+    }
+
+    // per block: the interval to search and its counts,
+    // and the offset of its eigenvalues in w
+    double      *bl    = work + n;
+    double      *bu    = bl + n;
+    double      *batol = bu + n;
+    magma_int_t *bcl   = iwork;
+    magma_int_t *bcu   = bcl + n;
+    magma_int_t *boff  = bcu + n;
+
+    std::vector< dstebz_chunk > chunks;
+    magma_int_t nthread = magma_get_parallel_numthreads();
+    magma_int_t total = 0;
+    nwl = 0;
+    nwu = 0;
+    for (ib = 0; ib < *nsplit; ++ib) {
+        magma_int_t ioff = (ib == 0 ? 0 : isplit[ib-1]);
+        magma_int_t in   = isplit[ib] - ioff;
+        boff[ib] = total;
+        bcl[ib] = 0;
+        bcu[ib] = 0;
+
+        if (in == 1) {
+            // special case -- in = 1
+            double dd = d[ioff] - pivmin;
+            if (alleig || wl >= dd) {
+                nwl += 1;
+            }
+            if (alleig || wu >= dd) {
+                nwu += 1;
+            }
+            if (alleig || (wl < dd && wu >= dd)) {
+                bl[ib] = bu[ib] = d[ioff];
+                bcu[ib] = 1;
+                total += 1;
+            }
+            continue;
+        }
+
+        // Gershgorin interval of the block
+        double gu = d[ioff], gl = d[ioff], tmp = 0;
+        for (j = ioff; j < ioff + in - 1; ++j) {
+            double tmp2 = sqrt( e2[j] );
+            gu = max( gu, d[j] + tmp + tmp2 );
+            gl = min( gl, d[j] - tmp - tmp2 );
+            tmp = tmp2;
+        }
+        gu = max( gu, d[ioff + in - 1] + tmp );
+        gl = min( gl, d[ioff + in - 1] - tmp );
+        double bnorm = max( fabs( gl ), fabs( gu ));
+        gl = gl - fudge*bnorm*ulp*in - fudge*pivmin;
+        gu = gu + fudge*bnorm*ulp*in + fudge*pivmin;
+        batol[ib] = (abstol <= 0 ? ulp*max( fabs( gl ), fabs( gu )) : abstol);
+
+        if (! alleig) {
+            if (gu < wl) {
+                nwl += in;
+                nwu += in;
+                continue;
+            }
+            gl = max( gl, wl );
+            gu = min( gu, wu );
+            if (gl >= gu) {
+                continue;
+            }
+        }
+
+        // counts at both ends, shared by all chunks of this block
+        double x[NSHIFT];
+        magma_int_t cnt[NSHIFT];
+        for (int k = 0; k < NSHIFT; ++k) {
+            x[k] = (k % 2 == 0 ? gl : gu);
+        }
+        dstebz_count( in, &d[ioff], &e2[ioff], pivmin, x, cnt );
+        bl[ib]  = gl;
+        bu[ib]  = gu;
+        bcl[ib] = cnt[0];
+        bcu[ib] = cnt[1];
+        nwl += cnt[0];
+        nwu += cnt[1];
+        total += cnt[1] - cnt[0];
+    }
+
+    // split the wanted eigenvalues into chunks, a few per thread
+    magma_int_t chunk = max( 1, magma_ceildiv( total, 8*nthread ));
+    for (ib = 0; ib < *nsplit; ++ib) {
+        magma_int_t in = isplit[ib] - (ib == 0 ? 0 : isplit[ib-1]);
+        if (in == 1) {
+            continue;
+        }
+        for (i = bcl[ib] + 1; i <= bcu[ib]; i += chunk) {
+            chunks.push_back( dstebz_chunk{ ib, i, min( i + chunk - 1, bcu[ib] ) } );
+        }
+    }
+
+    // find the eigenvalues; single element blocks are already known
+    for (ib = 0; ib < *nsplit; ++ib) {
+        magma_int_t in = isplit[ib] - (ib == 0 ? 0 : isplit[ib-1]);
+        for (i = 0; i < (in == 1 ? bcu[ib] : bcu[ib] - bcl[ib]); ++i) {
+            iblock[ boff[ib] + i ] = ib + 1;
+        }
+        if (in == 1 && bcu[ib] == 1) {
+            w[ boff[ib] ] = bl[ib];
+        }
+    }
+    magma_int_t nchunk = chunks.size();
+    #pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (magma_int_t c = 0; c < nchunk; ++c) {
+        const dstebz_chunk& ch = chunks[c];
+        magma_int_t b    = ch.block;
+        magma_int_t ioff = (b == 0 ? 0 : isplit[b-1]);
+        magma_int_t in   = isplit[b] - ioff;
+        dstebz_multisect( in, &d[ioff], &e2[ioff], pivmin,
+                          bl[b], bu[b], bcl[b], bcu[b], batol[b], rtoli,
+                          ch.ilo, ch.ihi, &w[ boff[b] + ch.ilo - bcl[b] - 1 ] );
+    }
+    *m = total;
+
+    // if RANGE='I', and all eigenvalues in (wl, wu] do not fit, discard the
+    // smallest il-1-nwl and largest nwu-iu, as in LAPACK
+    std::vector< magma_int_t > perm;
+    if (indeig) {
+        magma_int_t idiscl = il - 1 - nwl;
+        magma_int_t idiscu = nwu - iu;
+        if (idiscl > 0 || idiscu > 0) {
+            perm.resize( *m );
+            for (j = 0; j < *m; ++j) {
+                perm[j] = j;
+            }
+            std::stable_sort( perm.begin(), perm.end(),
+                              [w]( magma_int_t a, magma_int_t b ) { return w[a] < w[b]; } );
+            std::vector< char > keep( *m, 1 );
+            for (j = 0; j < max( 0, idiscl ); ++j) {
+                keep[ perm[j] ] = 0;
+            }
+            for (j = 0; j < max( 0, idiscu ); ++j) {
+                keep[ perm[*m - 1 - j] ] = 0;
+            }
+            magma_int_t im = 0;
+            for (j = 0; j < *m; ++j) {
+                if (keep[j]) {
+                    w[im] = w[j];
+                    iblock[im] = iblock[j];
+                    ++im;
+                }
+            }
+            *m = im;
+        }
+    }
+
+    // if ORDER='E', sort the eigenvalues from smallest to largest
+    if (byblock == MagmaFalse && *nsplit > 1) {
+        perm.resize( *m );
+        for (j = 0; j < *m; ++j) {
+            perm[j] = j;
+        }
+        std::stable_sort( perm.begin(), perm.end(),
+                          [w]( magma_int_t a, magma_int_t b ) { return w[a] < w[b]; } );
+        std::vector< double > ws( w, w + *m );
+        std::vector< magma_int_t > bs( iblock, iblock + *m );
+        for (j = 0; j < *m; ++j) {
+            w[j] = ws[ perm[j] ];
+            iblock[j] = bs[ perm[j] ];
+        }
+    }
+
+    return *info;
+}
@@ -21,12 +21,13 @@
 static void *magma_zapplyQ_parallel_section(void *arg);
 
 static void magma_ztile_bulge_applyQ(
-    magma_int_t core_id, magma_side_t side, magma_int_t n_loc,
-    magma_int_t n, magma_int_t nb, magma_int_t Vblksiz,
+    magma_side_t side, magma_int_t n_loc,
+    magma_int_t n, magma_int_t nb, magma_int_t Vblksiz, magma_int_t grsiz,
     magmaDoubleComplex *E, magma_int_t lde,
     magmaDoubleComplex *V, magma_int_t ldv,
     magmaDoubleComplex *TAU,
-    magmaDoubleComplex *T, magma_int_t ldt);
+    magmaDoubleComplex *T, magma_int_t ldt,
+    magmaDoubleComplex *work);
 
 /******************************************************************************/
 typedef struct magma_zapplyQ_data_s {
@@ -45,6 +46,12 @@ typedef struct magma_zapplyQ_data_s {
     magma_int_t ldt;
     magmaDoubleComplex* dE;
     magma_int_t ldde;
+    magma_int_t nb_loc;             // columns of E per chunk
+    magma_int_t grsiz;              // V column blocks applied together
+    magma_int_t nchunk;
+    magma_int_t next_chunk;         // next chunk to apply, protected by chunk_mutex
+    pthread_mutex_t chunk_mutex;
+    magmaDoubleComplex** work;      // per-thread workspace, work[ thread ]
     pthread_barrier_t barrier;
 } magma_zapplyQ_data;
 
@@ -58,7 +65,9 @@ void magma_zapplyQ_data_init(
     magmaDoubleComplex *V, magma_int_t ldv,
     magmaDoubleComplex *TAU,
     magmaDoubleComplex *T, magma_int_t ldt,
-    magmaDoubleComplex *dE, magma_int_t ldde)
+    magmaDoubleComplex *dE, magma_int_t ldde,
+    magma_int_t nb_loc, magma_int_t grsiz,
+    magmaDoubleComplex **work)
 {
     zapplyQ_data->threads_num = threads_num;
     zapplyQ_data->n = n;
@@ -75,6 +84,13 @@ void magma_zapplyQ_data_init(
     zapplyQ_data->ldt = ldt;
     zapplyQ_data->dE = dE;
     zapplyQ_data->ldde = ldde;
+    zapplyQ_data->nb_loc = nb_loc;
+    zapplyQ_data->grsiz = grsiz;
+    zapplyQ_data->nchunk = magma_ceildiv(ne - n_gpu, nb_loc);
+    zapplyQ_data->next_chunk = 0;
+    zapplyQ_data->work = work;
+
+    pthread_mutex_init(&(zapplyQ_data->chunk_mutex), NULL);
 
     magma_int_t count = zapplyQ_data->threads_num;
 
@@ -90,6 +106,7 @@ void magma_zapplyQ_data_destroy(
     magma_zapplyQ_data *zapplyQ_data)
 {
     pthread_barrier_destroy(&(zapplyQ_data->barrier));
+    pthread_mutex_destroy(&(zapplyQ_data->chunk_mutex));
 }
 
 
@@ -144,8 +161,10 @@ magma_zbulge_back(
     //    double gpu_cpu_perf = 130;   // gpu over cpu performance  //100% ev // Bulldozer - Kepler (K20X)
     //#endif
 
-    magma_int_t gpu_cpu_perf = magma_get_zbulge_gcperf();
-    if (threads > 1) {
+    // split between GPU and CPU only for a measured ratio, otherwise GPU only;
+    // see magma_bulge_get_gcperf
+    magma_int_t gpu_cpu_perf = magma_bulge_get_gcperf();
+    if (threads > 1 && gpu_cpu_perf > 0) {
         f = 1. / (1. + (double)(threads-1)/ ((double)gpu_cpu_perf)    );
         n_gpu = (magma_int_t)(f*ne);
     }
@@ -153,14 +172,6 @@ magma_zbulge_back(
     /* --------------------------------------------------
      *  apply V2 from left to the eigenvectors Z. dZ = (I-V2*T2*V2')*Z
      * -------------------------------------------------- */
-    //$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
-    //$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
-    //$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
-    n_gpu=ne;
-    //$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
-    //$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
-    //$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
-    //$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
     timeaplQ2 = magma_wtime();
     /*============================
      *  use GPU+CPU's
@@ -172,8 +183,29 @@ magma_zbulge_back(
         #ifdef ENABLE_DEBUG
         printf("---> calling GPU + CPU(if N_CPU > 0) to apply V2 to Z with NE %lld     N_GPU %lld   N_CPU %lld\n",ne, n_gpu, ne-n_gpu);
         #endif
+        // CPU threads 1:threads-1 apply Q to chunks of nb_loc columns,
+        // each with its own workspace from the pool
+        magma_int_t nb_loc, grsiz;
+        magma_bulge_get_applyQ_blk(n, nb, Vblksiz, ne-n_gpu, threads-1, sizeof(magmaDoubleComplex), &nb_loc, &grsiz);
+        magma_int_t lwork = nb_loc*Vblksiz;
+
+        magmaDoubleComplex *work_pool;
+        magmaDoubleComplex **work;
+        if (MAGMA_SUCCESS != magma_zmalloc_cpu(&work_pool, threads*lwork) ||
+            MAGMA_SUCCESS != magma_malloc_cpu((void**) &work, threads*sizeof(magmaDoubleComplex*))) {
+            *info = MAGMA_ERR_HOST_ALLOC;
+            magma_free_cpu(work_pool);
+            magma_queue_destroy( queue );
+            magma_set_lapack_numthreads(mklth);
+            return *info;
+        }
+        for (magma_int_t thread = 0; thread < threads; thread++) {
+            work[thread] = work_pool + thread*lwork;
+        }
+
         magma_zapplyQ_data data_applyQ;
-        magma_zapplyQ_data_init(&data_applyQ, threads, n, ne, n_gpu, nb, Vblksiz, Z, ldz, V, ldv, TAU, T, ldt, dZ, lddz);
+        magma_zapplyQ_data_init(&data_applyQ, threads, n, ne, n_gpu, nb, Vblksiz, Z, ldz, V, ldv, TAU, T, ldt, dZ, lddz,
+                                nb_loc, grsiz, work);
 
         magma_zapplyQ_id_data* arg;
         magma_malloc_cpu((void**) &arg, threads*sizeof(magma_zapplyQ_id_data));
@@ -208,6 +240,8 @@ magma_zbulge_back(
         magma_free_cpu(thread_id);
         magma_free_cpu(arg);
         magma_zapplyQ_data_destroy(&data_applyQ);
+        magma_free_cpu(work);
+        magma_free_cpu(work_pool);
 
 
         magma_zsetmatrix( n, ne-n_gpu, Z + n_gpu*ldz, ldz, dZ + n_gpu*ldz, lddz, queue );
@@ -234,12 +268,14 @@ static void *magma_zapplyQ_parallel_section(void *arg)
     magma_int_t my_core_id   = ((magma_zapplyQ_id_data*)arg) -> id;
     magma_zapplyQ_data* data = ((magma_zapplyQ_id_data*)arg) -> data;
 
-    magma_int_t allcores_num   = data -> threads_num;
     magma_int_t n              = data -> n;
     magma_int_t ne             = data -> ne;
     magma_int_t n_gpu          = data -> n_gpu;
     magma_int_t nb             = data -> nb;
     magma_int_t Vblksiz        = data -> Vblksiz;
+    magma_int_t nb_loc         = data -> nb_loc;
+    magma_int_t grsiz          = data -> grsiz;
+    magma_int_t nchunk         = data -> nchunk;
     magmaDoubleComplex *E      = data -> E;
     magma_int_t lde            = data -> lde;
     magmaDoubleComplex *V      = data -> V;
@@ -316,11 +352,22 @@ static void *magma_zapplyQ_parallel_section(void *arg)
             timeQcpu = magma_wtime();
         #endif
 
-        magma_int_t n_loc = magma_ceildiv(n_cpu, allcores_num-1);
-        magmaDoubleComplex* E_loc = E + (n_gpu+ n_loc * (my_core_id-1))*lde;
-        n_loc = min(n_loc,n_cpu - n_loc * (my_core_id-1));
-
-        magma_ztile_bulge_applyQ(my_core_id, MagmaLeft, n_loc, n, nb, Vblksiz, E_loc, lde, V, ldv, TAU, T, ldt);
+        // threads take chunks of nb_loc columns dynamically; threads
+        // applying Q to neighboring chunks read the same V and T blocks
+        // at about the same time, so those are shared in the last level cache.
+        magmaDoubleComplex* work = data -> work[my_core_id];
+        while (1) {
+            pthread_mutex_lock(&(data -> chunk_mutex));
+            magma_int_t chunk = data -> next_chunk;
+            data -> next_chunk += 1;
+            pthread_mutex_unlock(&(data -> chunk_mutex));
+            if (chunk >= nchunk)
+                break;
+
+            magma_int_t n_loc = min(nb_loc, n_cpu - chunk*nb_loc);
+            magmaDoubleComplex* E_loc = E + (n_gpu + chunk*nb_loc)*lde;
+            magma_ztile_bulge_applyQ(MagmaLeft, n_loc, n, nb, Vblksiz, grsiz, E_loc, lde, V, ldv, TAU, T, ldt, work);
+        }
         pthread_barrier_wait(barrier);
 
         #ifdef ENABLE_TIMER
@@ -350,15 +397,30 @@ static void *magma_zapplyQ_parallel_section(void *arg)
 #define T(m)     &(T[(m)])
 
 /******************************************************************************/
-// TODO: this is identical to function in zbulge_back_m.cpp
+// Applies Q2 to an n-by-n_loc chunk of E (side left) or n_loc-by-n chunk
+// (side right), using workspace work of size n_loc*Vblksiz.
+//
+// Side left applies E = Q*E = (q_1*q_2*...*q_n) * E, so it traverses the
+// V column blocks bg in reverse order, from the last to the first; within
+// column block bg, it applies the V blocks j top to bottom. Block t (from the
+// top) of column block bg applies to rows fst = t*nb + (bg-1)*Vblksiz + 1
+// through at most fst + nb + Vblksiz - 2. Blocks overlapping those rows and
+// applied earlier are in column blocks > bg with blocks t' <= t, so the
+// blocks of grsiz consecutive column blocks can be applied in a skewed
+// (diamond) order: for each t, block t of every column block in the group,
+// in reverse order. The rows of E in use then stay within a window of about
+// grsiz*Vblksiz + nb rows, kept in cache, instead of sweeping all n rows of E
+// once per column block.
+//
+// Side right applies E = E*Q = E * (q_1*q_2*...*q_n), traversing V in order.
 static void magma_ztile_bulge_applyQ(
-    magma_int_t core_id, magma_side_t side, magma_int_t n_loc,
-    magma_int_t n, magma_int_t nb, magma_int_t Vblksiz,
+    magma_side_t side, magma_int_t n_loc,
+    magma_int_t n, magma_int_t nb, magma_int_t Vblksiz, magma_int_t grsiz,
     magmaDoubleComplex *E, magma_int_t lde,
     magmaDoubleComplex *V, magma_int_t ldv,
     magmaDoubleComplex *TAU,
-    magmaDoubleComplex *T, magma_int_t ldt)
-    //, magma_int_t* info)
+    magmaDoubleComplex *T, magma_int_t ldt,
+    magmaDoubleComplex *work)
 {
     //%===========================
     //%   local variables
@@ -375,62 +437,33 @@ static void magma_ztile_bulge_applyQ(
     if (n_loc <= 0)
         return;
 
-    //info = 0;
-    magma_int_t INFO=0;
-
     magma_int_t nbGblk  = magma_ceildiv(n-1, Vblksiz);
 
-    /*
-     * version v1: for each chunck it apply all the V's then move to
-     *                    the other chunck. the locality here inside each
-     *                    chunck meaning that thread t apply V_k then move
-     *                    to V_k+1 which overlap with V_k meaning that the
-     *                    E_k+1 overlap with E_k. so here is the
-     *                    locality however thread t had to read V_k+1 and
-     *                    T_k+1 at each apply. note that all thread if they
-     *                    run at same speed they might reading the same V_k
-     *                    and T_k at the same time.
-     * */
-
-    magma_int_t nb_loc = 128; //$$$$$$$$
-
-    magma_int_t     lwork = 2*nb_loc*max(Vblksiz,64);
-    magmaDoubleComplex *work, *work2;
-
-    magma_zmalloc_cpu(&work, lwork);
-    magma_zmalloc_cpu(&work2, lwork);
-
-    magma_int_t nbchunk =  magma_ceildiv(n_loc, nb_loc);
-
-    /* SIDE LEFT  meaning apply E = Q*E = (q_1*q_2*.....*q_n) * E ==> so traverse Vs in reverse order (forward) from q_n to q_1
-     *            each q_i consist of applying V to a block of row E(row_i,:) and applies are overlapped meaning
-     *            that q_i+1 overlap a portion of the E(row_i, :).
-     *            IN parallel E is splitten in vertical block over the threads  */
-    /* SIDE RIGHT meaning apply E = E*Q = E * (q_1*q_2*.....*q_n) ==> so tarverse Vs in normal  order (forward) from q_1 to q_n
-     *            each q_i consist of applying V to a block of col E(:, col_i,:) and the applies are overlapped meaning
-     *            that q_i+1 overlap a portion of the E(:, col_i).
-     *            IN parallel E is splitten in horizontal block over the threads  */
     #ifdef ENABLE_DEBUG
-    if ((core_id == 0) || (core_id == 1))
-        printf("  APPLY Q2_cpu zbulge_back   N %lld  N_loc %lld  nbchunk %lld  NB %lld  Vblksiz %lld  SIDE %c\n", n, n_loc, nbchunk, nb, Vblksiz, side);
+    printf("  APPLY Q2_cpu zbulge_back   N %lld  N_loc %lld  NB %lld  Vblksiz %lld  grsiz %lld  SIDE %c\n", n, n_loc, nb, Vblksiz, grsiz, side);
     #endif
 
-    for (magma_int_t i = 0; i < nbchunk; i++) {
-        magma_int_t ib_loc = min(nb_loc, (n_loc - i*nb_loc));
-
-        if (side == MagmaLeft) {
-            for (bg = nbGblk; bg > 0; bg--) {
-                firstcolj = (bg-1)*Vblksiz + 1;
-                rownbm    = magma_ceildiv((n-(firstcolj+1)),nb);
-                if (bg == nbGblk) rownbm = magma_ceildiv((n-(firstcolj)),nb);  // last blk has size=1 used for complex to handle A(N,N-1)
-                for (magma_int_t j = rownbm; j > 0; j--) {
+    if (side == MagmaLeft) {
+        for (magma_int_t bglast = nbGblk; bglast > 0; bglast -= grsiz) {
+            magma_int_t bgfirst = max(bglast - grsiz + 1, 1);
+            // the first column block in the group has the most V blocks
+            firstcolj = (bgfirst-1)*Vblksiz + 1;
+            magma_int_t tmax = magma_ceildiv((n-(firstcolj+1)),nb);
+            if (bgfirst == nbGblk) tmax = magma_ceildiv((n-(firstcolj)),nb);
+            for (magma_int_t t = 0; t < tmax; t++) {
+                for (bg = bglast; bg >= bgfirst; bg--) {
+                    firstcolj = (bg-1)*Vblksiz + 1;
+                    rownbm    = magma_ceildiv((n-(firstcolj+1)),nb);
+                    if (bg == nbGblk) rownbm = magma_ceildiv((n-(firstcolj)),nb);  // last blk has size=1 used for complex to handle A(N,N-1)
+                    if (t >= rownbm)
+                        continue;
                     vlen = 0;
                     vnb  = 0;
-                    colj = (bg-1)*Vblksiz; // for k=0; I compute the fst and then can remove it from the loop
-                    fst  = (rownbm -j)*nb+colj +1;
+                    colj = (bg-1)*Vblksiz;
+                    fst  = t*nb+colj +1;
                     for (magma_int_t k=0; k < Vblksiz; k++) {
                         colj = (bg-1)*Vblksiz + k;
-                        st   = (rownbm -j)*nb+colj +1;
+                        st   = t*nb+colj +1;
                         ed   = min(st+nb-1,n-1);
                         if (st > ed)
                             break;
@@ -443,48 +476,43 @@ static void magma_ztile_bulge_applyQ(
                     magma_bulge_findVTpos(n, nb, Vblksiz, colst, fst, ldv, ldt, &vpos, &tpos);
 
                     if ((vlen > 0) && (vnb > 0)) {
-                        lapackf77_zlarfb( "L", "N", "F", "C", &vlen, &ib_loc, &vnb, V(vpos), &ldv, T(tpos), &ldt, E(fst,i*nb_loc), &lde, work, &ib_loc);
+                        lapackf77_zlarfb( "L", "N", "F", "C", &vlen, &n_loc, &vnb, V(vpos), &ldv, T(tpos), &ldt, E(fst,0), &lde, work, &n_loc);
                     }
-                    if (INFO != 0)
-                        printf("ERROR ZUNMQR INFO %lld\n", (long long) INFO );
                 }
             }
-        } else if (side == MagmaRight) {
-            rownbm    = magma_ceildiv((n-1),nb);
-            for (magma_int_t k = 1; k <= rownbm; k++) {
-                ncolinvolvd = min(n-1, k*nb);
-                avai_blksiz = min(Vblksiz,ncolinvolvd);
-                nbgr = magma_ceildiv(ncolinvolvd,avai_blksiz);
-                for (magma_int_t j = 1; j <= nbgr; j++) {
-                    vlen = 0;
-                    vnb  = 0;
-                    cur_blksiz = min(ncolinvolvd-(j-1)*avai_blksiz, avai_blksiz);
-                    colst = (j-1)*avai_blksiz;
-                    coled = colst + cur_blksiz -1;
-                    fst   = (rownbm -k)*nb+colst +1;
-                    for (colj=colst; colj <= coled; colj++) {
-                        st = (rownbm -k)*nb+colj +1;
-                        ed = min(st+nb-1,n-1);
-                        if (st > ed)
-                            break;
-                        if ((st == ed) && (colj != n-2))
-                            break;
-                        vlen = ed-fst+1;
-                        vnb = vnb+1;
-                    }
-                    magma_bulge_findVTpos(n, nb, Vblksiz, colst, fst, ldv, ldt, &vpos, &tpos);
-                    if ((vlen > 0) && (vnb > 0)) {
-                        lapackf77_zlarfb( "R", "N", "F", "C", &ib_loc, &vlen, &vnb, V(vpos), &ldv, T(tpos), &ldt, E(i*nb_loc,fst), &lde, work, &ib_loc);
-                    }
+        }
+    } else if (side == MagmaRight) {
+        rownbm    = magma_ceildiv((n-1),nb);
+        for (magma_int_t k = 1; k <= rownbm; k++) {
+            ncolinvolvd = min(n-1, k*nb);
+            avai_blksiz = min(Vblksiz,ncolinvolvd);
+            nbgr = magma_ceildiv(ncolinvolvd,avai_blksiz);
+            for (magma_int_t j = 1; j <= nbgr; j++) {
+                vlen = 0;
+                vnb  = 0;
+                cur_blksiz = min(ncolinvolvd-(j-1)*avai_blksiz, avai_blksiz);
+                colst = (j-1)*avai_blksiz;
+                coled = colst + cur_blksiz -1;
+                fst   = (rownbm -k)*nb+colst +1;
+                for (colj=colst; colj <= coled; colj++) {
+                    st = (rownbm -k)*nb+colj +1;
+                    ed = min(st+nb-1,n-1);
+                    if (st > ed)
+                        break;
+                    if ((st == ed) && (colj != n-2))
+                        break;
+                    vlen = ed-fst+1;
+                    vnb = vnb+1;
+                }
+                magma_bulge_findVTpos(n, nb, Vblksiz, colst, fst, ldv, ldt, &vpos, &tpos);
+                if ((vlen > 0) && (vnb > 0)) {
+                    lapackf77_zlarfb( "R", "N", "F", "C", &n_loc, &vlen, &vnb, V(vpos), &ldv, T(tpos), &ldt, E(0,fst), &lde, work, &n_loc);
                 }
             }
-        } else {
-            printf("ERROR SIDE %d\n", side);
         }
-    } // END loop over the chunks
-
-    magma_free_cpu(work);
-    magma_free_cpu(work2);
+    } else {
+        printf("ERROR SIDE %d\n", side);
+    }
 }
 
 #undef E
@@ -0,0 +1,613 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions mixed zc -> ds
+
+*/
+#include "magma_internal.h"
+
+#define PRECISION_z
+
+/******************************************************************************/
+// Makes S and R Hermitian: S := (S + S^H) / 2 from the full S, and the
+// upper triangle of R from its lower triangle, as left by zherk.
+// S may be NULL.
+static void
+magma_zcheevd_symmetrize(
+    magma_int_t n,
+    magmaDoubleComplex *S, magmaDoubleComplex *R, magma_int_t ld )
+{
+    #define S(i_,j_) (S + (i_) + (j_)*ld)
+    #define R(i_,j_) (R + (i_) + (j_)*ld)
+
+    for (magma_int_t j = 0; j < n; ++j) {
+        if (S != NULL) {
+            *S(j,j) = MAGMA_Z_MAKE( MAGMA_Z_REAL( *S(j,j) ), 0 );
+            for (magma_int_t i = j+1; i < n; ++i) {
+                magmaDoubleComplex s = *S(i,j) + MAGMA_Z_CONJ( *S(j,i) );
+                s = MAGMA_Z_MAKE( MAGMA_Z_REAL( s ) / 2, MAGMA_Z_IMAG( s ) / 2 );
+                *S(i,j) = s;
+                *S(j,i) = MAGMA_Z_CONJ( s );
+            }
+        }
+        for (magma_int_t i = j+1; i < n; ++i) {
+            *R(j,i) = MAGMA_Z_CONJ( *R(i,j) );
+        }
+    }
+
+    #undef S
+    #undef R
+}
+
+
+/******************************************************************************/
+// The Ogita-Aishima correction E, such that X + X E refines X, given
+//     S = X^H A X,   R = I - X^H X,
+// both Hermitian. On exit, w holds the Ritz values s_ii / (1 - r_ii) of X,
+// and E overwrites S, where
+//     E_ij = (s_ij + w_j r_ij) / (w_j - w_i)   if i and j are in different clusters,
+//     E_ij = r_ij / 2                          otherwise,
+//     delta = 2 (|S - diag(w)|_F + max |w_i| |R|_F).
+// The return value measures how far X is from an eigenbasis,
+//     max( max_{i != j} |s_ij + w_j r_ij| / max |w_i|,  max |r_ij| ),
+// which, unlike E, does not grow with the inverse of the gaps, so it
+// reaches the rounding level of A rather than that of the eigenvectors.
+// Since S and R are Hermitian, E + E^H = R, which keeps X + X E orthonormal
+// to first order whatever the error in S.
+// Clusters are ranges of consecutive indices, given in clusters[0..*ncluster]
+// as the starting index of each cluster, with clusters[*ncluster] = n.
+// On entry, they hold the clusters of the previous step; neighboring clusters
+// whose Ritz values are no more than delta apart are merged. Clusters are
+// never split, so eigenvalues that could not be separated at an earlier step
+// stay together instead of being divided by gaps that the current accuracy
+// does not resolve, and w_j - w_i > delta between different clusters.
+static double
+magma_zcheevd_correction(
+    magma_int_t n,
+    magmaDoubleComplex *S, magmaDoubleComplex *R, magma_int_t ld,
+    double *w, magma_int_t *clusters, magma_int_t *ncluster )
+{
+    #define S(i_,j_) (S + (i_) + (j_)*ld)
+    #define R(i_,j_) (R + (i_) + (j_)*ld)
+
+    magma_int_t i, j;
+
+    // Ritz values, and the separation bound delta
+    double wmax = 0, offS = 0, nrmR = 0;
+    for (i = 0; i < n; ++i) {
+        w[i] = MAGMA_Z_REAL( *S(i,i) ) / (1 - MAGMA_Z_REAL( *R(i,i) ));
+        wmax = max( wmax, fabs( w[i] ));
+    }
+    for (j = 0; j < n; ++j) {
+        for (i = 0; i < n; ++i) {
+            double s = MAGMA_Z_ABS( *S(i,j) );
+            double r = MAGMA_Z_ABS( *R(i,j) );
+            if (i == j)
+                s = fabs( MAGMA_Z_REAL( *S(i,i) ) - w[i] );
+            offS += s*s;
+            nrmR += r*r;
+        }
+    }
+    double delta = 2*(sqrt( offS ) + wmax*sqrt( nrmR ));
+
+    // merge neighboring clusters of consecutive Ritz values
+    magma_int_t k, kk = 1;
+    for (k = 1; k < *ncluster; ++k) {
+        i = clusters[k];
+        if (fabs( w[i] - w[i-1] ) > delta)
+            clusters[ kk++ ] = i;
+    }
+    *ncluster = kk;
+    clusters[ *ncluster ] = n;
+
+    // E, in place of S; column j is in cluster [ clusters[k], clusters[k+1] )
+    double wscal = (wmax > 0 ? 1 / wmax : 1);
+    double eta = 0;
+    k = 0;
+    for (j = 0; j < n; ++j) {
+        if (j == clusters[k+1])
+            ++k;
+        for (i = 0; i < n; ++i) {
+            double gap = w[j] - w[i];
+            magmaDoubleComplex e = *S(i,j) + MAGMA_Z_MAKE( w[j], 0 ) * *R(i,j);
+            if (i != j)
+                eta = max( eta, MAGMA_Z_ABS( e ) * wscal );
+            eta = max( eta, MAGMA_Z_ABS( *R(i,j) ));
+            if (i < clusters[k] || i >= clusters[k+1]) {
+                e = MAGMA_Z_MAKE( MAGMA_Z_REAL( e ) / gap, MAGMA_Z_IMAG( e ) / gap );
+            }
+            else {
+                e = MAGMA_Z_MAKE( MAGMA_Z_REAL( *R(i,j) ) / 2, MAGMA_Z_IMAG( *R(i,j) ) / 2 );
+            }
+            *S(i,j) = e;
+        }
+    }
+
+    return eta;
+
+    #undef S
+    #undef R
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZCHEEVD computes all eigenvalues and eigenvectors of a complex
+    Hermitian matrix A to complex DOUBLE PRECISION accuracy.
+
+    ZCHEEVD first computes the eigendecomposition in complex SINGLE PRECISION
+    with magma_cheevd, then refines all eigenpairs to DOUBLE PRECISION
+    with the iterative refinement of Ogita and Aishima (Japan J. Indust.
+    Appl. Math. 35, 2018). Each step costs four matrix products on the
+    host BLAS and roughly doubles the number of correct digits, so two or
+    three steps usually suffice. Eigenvalues that cannot be separated at the
+    accuracy of the first steps form clusters, which are kept, and only
+    merged, in the later steps; each refinement step orthonormalizes the
+    vectors within a cluster, and a Rayleigh-Ritz step on each cluster
+    rotates them onto the eigenvectors. Multiple and tightly clustered
+    eigenvalues thus converge in as many steps as well separated ones.
+
+    If narrowing the precision overflows, the single precision eigensolver
+    fails, or the refinement does not converge, ZCHEEVD falls back to
+    magma_zheevd in DOUBLE PRECISION.
+
+    The refinement is not going to be a winning strategy if the ratio of
+    SINGLE PRECISION performance over DOUBLE PRECISION performance is too
+    small, since the refinement itself costs about as much as a DOUBLE
+    PRECISION back transformation per step.
+
+    With S = Z^H A Z, R = I - Z^H Z, and W the Ritz values of the current
+    eigenvectors Z, the refinement has converged when
+        ETA = max( max_{i != j} |S_ij + W_j R_ij| / max |W_i|,  max |R_ij| )
+            <= N*EPS,
+    where EPS is DLAMCH('Epsilon'), the rounding level of the inner products
+    in S and R; or when ETA stops decreasing below 4*N*EPS. ETA may grow in
+    the first steps when single precision cannot separate the eigenvectors
+    well, but then decreases quadratically. The refinement fails if
+    ETA >= 1, if ETA stops decreasing below sqrt(EPS) without reaching
+    4*N*EPS, if the Rayleigh-Ritz step on a cluster fails, or if it has not
+    converged after ITERMAX = 10 steps.
+
+    Arguments
+    ---------
+    @param[in]
+    uplo    magma_uplo_t
+      -     = MagmaUpper:  Upper triangle of A is stored;
+      -     = MagmaLower:  Lower triangle of A is stored.
+
+    @param[in]
+    n       INTEGER
+            The order of the matrix A.  N >= 0.
+
+    @param[in,out]
+    A       COMPLEX_16 array, dimension (LDA, N)
+            On entry, the Hermitian matrix A.  If UPLO = MagmaUpper, the
+            leading N-by-N upper triangular part of A contains the
+            upper triangular part of the matrix A.  If UPLO = MagmaLower,
+            the leading N-by-N lower triangular part of A contains
+            the lower triangular part of the matrix A.
+            On exit, if INFO = 0, A contains the orthonormal
+            eigenvectors of the matrix A.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of the array A.  LDA >= max(1,N).
+
+    @param[out]
+    w       DOUBLE PRECISION array, dimension (N)
+            If INFO = 0, the eigenvalues in ascending order.
+
+    @param[out]
+    resid   DOUBLE PRECISION array, dimension (2)
+            If INFO = 0, the achieved residuals
+            resid[0] = |A Z - Z W|_1 / (N |A|_1), and
+            resid[1] = |I - Z^H Z|_1 / N,
+            where Z holds the computed eigenvectors and W the eigenvalues.
+
+    @param[out]
+    time    DOUBLE PRECISION array, dimension (2)
+            The wall-clock time in seconds of the
+            time[0]: eigensolver, in SINGLE PRECISION, or in
+                     DOUBLE PRECISION after a fallback;
+            time[1]: refinement, including the residuals.
+            If time is NULL, it is not referenced.
+
+    @param[out]
+    iter    INTEGER
+      -     < 0: iterative refinement has failed, double precision
+                 eigensolver has been used
+        +        -2 : narrowing the precision induced an overflow,
+                      the routine fell back to full precision
+        +        -3 : failure of magma_cheevd
+        +        -31: the refinement did not converge or stagnated
+      -     >= 0: iterative refinement has been successfully used.
+                 Returns the number of refinement steps
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+      -     > 0:  if INFO = i, magma_zheevd failed to converge, see
+                  magma_zheevd for details.
+
+    @ingroup magma_heevd
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zcheevd(
+    magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex *A, magma_int_t lda,
+    double *w,
+    double *resid,
+    real_Double_t *time,
+    magma_int_t *iter,
+    magma_int_t *info)
+{
+    #define A(i_,j_)  (A  + (i_) + (j_)*lda)
+    #define X(i_,j_)  (X  + (i_) + (j_)*ld)
+    #define AX(i_,j_) (AX + (i_) + (j_)*ld)
+    #define R(i_,j_)  (R  + (i_) + (j_)*ld)
+
+    // Constants
+    const magma_int_t ITERMAX = 10;
+    const magmaDoubleComplex c_zero    = MAGMA_Z_ZERO;
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const double d_one     = 1;
+    const double d_neg_one = -1;
+    const magma_int_t ione = 1;
+    const char* uplo_ = lapack_uplo_const( uplo );
+
+    // Local variables
+    magmaDoubleComplex *X = NULL, *AX = NULL, *S = NULL, *R = NULL;
+    magmaFloatComplex *sA = NULL, *swork = NULL;
+    float *sw = NULL;
+    #if defined(PRECISION_z)
+    float *srwork = NULL;
+    double *rwork = NULL;
+    magma_int_t lrwork;
+    #endif
+    magmaDoubleComplex *work = NULL, *hwork = NULL;
+    magma_int_t *iwork = NULL, *clusters = NULL;
+    double *dwork = NULL;
+    double eta, eta_prev, eps, cte, Anrm;
+    magma_int_t j, k, iiter, ld, lwork, lhwork, liwork, ncluster, iinfo;
+    real_Double_t t0;
+
+    /* Check arguments */
+    *iter = 0;
+    *info = 0;
+    if ( uplo != MagmaLower && uplo != MagmaUpper )
+        *info = -1;
+    else if ( n < 0 )
+        *info = -2;
+    else if ( lda < max(1,n) )
+        *info = -4;
+
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    if (time != NULL) {
+        time[0] = 0;
+        time[1] = 0;
+    }
+    resid[0] = 0;
+    resid[1] = 0;
+
+    if ( n == 0 )
+        return *info;
+
+    ld = n;
+    eps = lapackf77_dlamch("Epsilon");
+    cte = n * eps;
+
+    if (MAGMA_SUCCESS != magma_zmalloc_cpu( &X,  ld*n ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &AX, ld*n ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &S,  ld*n ) ||
+        MAGMA_SUCCESS != magma_zmalloc_cpu( &R,  ld*n ) ||
+        MAGMA_SUCCESS != magma_dmalloc_cpu( &dwork, 4*n ) ||
+        MAGMA_SUCCESS != magma_imalloc_cpu( &clusters, n+1 ))
+    {
+        *info = MAGMA_ERR_HOST_ALLOC;
+        goto cleanup;
+    }
+
+    // workspace of zheev for the Rayleigh-Ritz step on clusters of up to
+    // n eigenvalues; its rwork is dwork + n, of size 3n >= 3n-2
+    {
+        magmaDoubleComplex aux_hwork[1];
+        magma_int_t lquery = -1;
+        lapackf77_zheev( "V", "L", &n, R, &ld, dwork, aux_hwork, &lquery,
+                         #if defined(PRECISION_z)
+                         dwork + n,
+                         #endif
+                         &iinfo );
+        lhwork = magma_int_t( MAGMA_Z_REAL( aux_hwork[0] ));
+        if (MAGMA_SUCCESS != magma_zmalloc_cpu( &hwork, lhwork )) {
+            *info = MAGMA_ERR_HOST_ALLOC;
+            goto cleanup;
+        }
+    }
+
+    /* ====================================================================
+       Eigendecomposition in single precision
+       =================================================================== */
+    t0 = magma_wtime();
+    {
+        magmaFloatComplex aux_swork[1];
+        #if defined(PRECISION_z)
+        float aux_srwork[1];
+        magma_int_t lsrwork;
+        #endif
+        magma_int_t aux_iwork[1], lswork, lquery = -1;
+
+        magma_cheevd( MagmaVec, uplo, n, NULL, ld, NULL,
+                      aux_swork, lquery,
+                      #if defined(PRECISION_z)
+                      aux_srwork, lquery,
+                      #endif
+                      aux_iwork, lquery, &iinfo );
+        lswork  = magma_int_t( MAGMA_C_REAL( aux_swork[0] ));
+        #if defined(PRECISION_z)
+        lsrwork = magma_int_t( aux_srwork[0] );
+        #endif
+        liwork  = aux_iwork[0];
+
+        if (MAGMA_SUCCESS != magma_cmalloc_cpu( &sA, ld*n ) ||
+            MAGMA_SUCCESS != magma_smalloc_cpu( &sw, n ) ||
+            MAGMA_SUCCESS != magma_cmalloc_pinned( &swork, lswork ) ||
+            #if defined(PRECISION_z)
+            MAGMA_SUCCESS != magma_smalloc_cpu( &srwork, lsrwork ) ||
+            #endif
+            MAGMA_SUCCESS != magma_imalloc_cpu( &iwork, liwork ))
+        {
+            *info = MAGMA_ERR_HOST_ALLOC;
+            goto cleanup;
+        }
+
+        lapackf77_zlat2c( uplo_, &n, A, &lda, sA, &ld, &iinfo );
+        if (iinfo != 0) {
+            *iter = -2;
+            goto fallback;
+        }
+
+        magma_cheevd( MagmaVec, uplo, n, sA, ld, sw,
+                      swork, lswork,
+                      #if defined(PRECISION_z)
+                      srwork, lsrwork,
+                      #endif
+                      iwork, liwork, &iinfo );
+        if (iinfo != 0) {
+            *iter = -3;
+            goto fallback;
+        }
+
+        lapackf77_clag2z( &n, &n, sA, &ld, X, &ld, &iinfo );
+    }
+    if (time != NULL)
+        time[0] = magma_wtime() - t0;
+
+    /* ====================================================================
+       Iterative refinement
+       =================================================================== */
+    t0 = magma_wtime();
+    eta_prev = 1;
+    ncluster = n;
+    for (k = 0; k <= n; ++k) {
+        clusters[k] = k;
+    }
+    for (iiter = 0; iiter < ITERMAX; ++iiter) {
+        // AX = A X,  S = X^H A X,  R = I - X^H X
+        blasf77_zhemm( "L", uplo_, &n, &n,
+                       &c_one,  A,  &lda,
+                                X,  &ld,
+                       &c_zero, AX, &ld );
+        blasf77_zgemm( MagmaConjTransStr, "N", &n, &n, &n,
+                       &c_one,  X,  &ld,
+                                AX, &ld,
+                       &c_zero, S,  &ld );
+        lapackf77_zlaset( "F", &n, &n, &c_zero, &c_one, R, &ld );
+        blasf77_zherk( "L", MagmaConjTransStr, &n, &n,
+                       &d_neg_one, X, &ld,
+                       &d_one,     R, &ld );
+        magma_zcheevd_symmetrize( n, S, R, ld );
+
+        // if X is already an eigenbasis to working accuracy, it is
+        // converged, and w, AX, and R are kept for the residuals.
+        eta = magma_zcheevd_correction( n, S, R, ld, w, clusters, &ncluster );
+        if (eta <= cte || (eta <= 4*cte && eta > eta_prev / 2)) {
+            // converged, or stagnated at the rounding level of S and R
+            break;
+        }
+        if (! (eta < 1) || (eta <= magma_dsqrt( eps ) && eta > eta_prev / 2)) {
+            // X is too far from an eigenbasis for the first-order
+            // correction, eta is NaN, or the refinement has stagnated
+            // above the rounding level
+            iiter = ITERMAX;
+            break;
+        }
+        eta_prev = eta;
+
+        // X := X + X E, formed in AX
+        lapackf77_zlacpy( "F", &n, &n, X, &ld, AX, &ld );
+        blasf77_zgemm( "N", "N", &n, &n, &n,
+                       &c_one, X,  &ld,
+                               S,  &ld,
+                       &c_one, AX, &ld );
+        magmaDoubleComplex *tmp = X;
+        X  = AX;
+        AX = tmp;
+
+        // Rayleigh-Ritz on each cluster: Q^H A Q = V T V^H, Q := Q V,
+        // using AX as workspace for A Q and Q V, and R for Q^H A Q.
+        iinfo = 0;
+        for (k = 0; k < ncluster; ++k) {
+            magma_int_t j0 = clusters[k];
+            magma_int_t nc = clusters[k+1] - j0;
+            if (nc == 1)
+                continue;
+            magmaDoubleComplex *T = R;
+            blasf77_zhemm( "L", uplo_, &n, &nc,
+                           &c_one,  A,       &lda,
+                                    X(0,j0), &ld,
+                           &c_zero, AX,      &ld );
+            blasf77_zgemm( MagmaConjTransStr, "N", &nc, &nc, &n,
+                           &c_one,  X(0,j0), &ld,
+                                    AX,      &ld,
+                           &c_zero, T,       &nc );
+            lapackf77_zheev( "V", "L", &nc, T, &nc, dwork, hwork, &lhwork,
+                             #if defined(PRECISION_z)
+                             dwork + n,
+                             #endif
+                             &iinfo );
+            if (iinfo != 0)
+                break;
+            blasf77_zgemm( "N", "N", &n, &nc, &nc,
+                           &c_one,  X(0,j0), &ld,
+                                    T,       &nc,
+                           &c_zero, AX,      &ld );
+            lapackf77_zlacpy( "F", &n, &nc, AX, &ld, X(0,j0), &ld );
+        }
+        if (iinfo != 0) {
+            iiter = ITERMAX;
+            break;
+        }
+    }
+
+    if (iiter < ITERMAX) {
+        *iter = iiter;
+
+        // the Ritz values need not be in order within or across clusters;
+        // sort them in ascending order, with the columns of X and AX = A X.
+        // The 1-norm of R is invariant under the symmetric permutation.
+        for (j = 0; j < n-1; ++j) {
+            magma_int_t jmin = j;
+            for (k = j+1; k < n; ++k) {
+                if (w[k] < w[jmin])
+                    jmin = k;
+            }
+            if (jmin != j) {
+                double tmp = w[j];
+                w[j] = w[jmin];
+                w[jmin] = tmp;
+                blasf77_zswap( &n, X(0,j),  &ione, X(0,jmin),  &ione );
+                blasf77_zswap( &n, AX(0,j), &ione, AX(0,jmin), &ione );
+            }
+        }
+    }
+    else {
+        *iter = -31;
+        if (time != NULL)
+            time[1] = magma_wtime() - t0;
+        goto fallback;
+    }
+    goto residual;
+
+    /* ====================================================================
+       Fall back to the eigensolver in double precision
+       =================================================================== */
+fallback:
+    t0 = magma_wtime();
+    {
+        magmaDoubleComplex aux_work[1];
+        #if defined(PRECISION_z)
+        double aux_rwork[1];
+        #endif
+        magma_int_t aux_iwork[1], lquery = -1;
+
+        magma_zheevd( MagmaVec, uplo, n, NULL, ld, NULL,
+                      aux_work, lquery,
+                      #if defined(PRECISION_z)
+                      aux_rwork, lquery,
+                      #endif
+                      aux_iwork, lquery, &iinfo );
+        lwork  = magma_int_t( MAGMA_Z_REAL( aux_work[0] ));
+        #if defined(PRECISION_z)
+        lrwork = magma_int_t( aux_rwork[0] );
+        #endif
+        liwork = aux_iwork[0];
+
+        magma_free_cpu( iwork );
+        iwork = NULL;
+        if (MAGMA_SUCCESS != magma_zmalloc_pinned( &work, lwork ) ||
+            #if defined(PRECISION_z)
+            MAGMA_SUCCESS != magma_dmalloc_cpu( &rwork, lrwork ) ||
+            #endif
+            MAGMA_SUCCESS != magma_imalloc_cpu( &iwork, liwork ))
+        {
+            *info = MAGMA_ERR_HOST_ALLOC;
+            goto cleanup;
+        }
+
+        lapackf77_zlacpy( uplo_, &n, &n, A, &lda, X, &ld );
+        magma_zheevd( MagmaVec, uplo, n, X, ld, w,
+                      work, lwork,
+                      #if defined(PRECISION_z)
+                      rwork, lrwork,
+                      #endif
+                      iwork, liwork, info );
+        if (*info != 0)
+            goto cleanup;
+    }
+    if (time != NULL)
+        time[0] += magma_wtime() - t0;
+    t0 = magma_wtime();
+
+    // AX = A X,  R = I - X^H X, as the refinement leaves them
+    blasf77_zhemm( "L", uplo_, &n, &n,
+                   &c_one,  A,  &lda,
+                            X,  &ld,
+                   &c_zero, AX, &ld );
+    lapackf77_zlaset( "F", &n, &n, &c_zero, &c_one, R, &ld );
+    blasf77_zherk( "L", MagmaConjTransStr, &n, &n,
+                   &d_neg_one, X, &ld,
+                   &d_one,     R, &ld );
+    magma_zcheevd_symmetrize( n, NULL, R, ld );
+
+    /* ====================================================================
+       Residuals |A X - X W| / (N |A|) and |I - X^H X| / N
+       =================================================================== */
+residual:
+    for (k = 0; k < n; ++k) {
+        magmaDoubleComplex wk = MAGMA_Z_MAKE( -w[k], 0 );
+        blasf77_zaxpy( &n, &wk, X(0,k), &ione, AX(0,k), &ione );
+    }
+    Anrm = lapackf77_zlanhe( "1", uplo_, &n, A, &lda, dwork );
+    Anrm = (Anrm > 0 ? Anrm : 1);
+    resid[0] = lapackf77_zlange( "1", &n, &n, AX, &ld, dwork ) / (n * Anrm);
+    resid[1] = lapackf77_zlange( "1", &n, &n, R,  &ld, dwork ) / n;
+
+    lapackf77_zlacpy( "F", &n, &n, X, &ld, A, &lda );
+    if (time != NULL)
+        time[1] += magma_wtime() - t0;
+
+cleanup:
+    magma_free_cpu( X );
+    magma_free_cpu( AX );
+    magma_free_cpu( S );
+    magma_free_cpu( R );
+    magma_free_cpu( dwork );
+    magma_free_cpu( clusters );
+    magma_free_cpu( hwork );
+    magma_free_cpu( sA );
+    magma_free_cpu( sw );
+    magma_free_pinned( swork );
+    #if defined(PRECISION_z)
+    magma_free_cpu( srwork );
+    magma_free_cpu( rwork );
+    #endif
+    magma_free_pinned( work );
+    magma_free_cpu( iwork );
+
+    return *info;
+
+    #undef A
+    #undef X
+    #undef AX
+    #undef R
+}
@@ -0,0 +1,388 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "magma_internal.h"
+#include "batched_cpu.hpp"
+
+#define COMPLEX
+
+#ifdef COMPLEX
+#define NCOMP 2
+#else
+#define NCOMP 1
+#endif
+
+// element (i,j) of the interleaved group; real plane, imaginary plane at +L
+#define A(i_, j_)  (A + ((j_)*N + (i_))*NCOMP*L)
+#define tau(i_)    (tau + (i_)*NCOMP*L)
+
+
+/***************************************************************************//**
+    Unblocked Householder QR factorization of one interleaved group of N-by-N
+    matrices (see batched_cpu.hpp), with the same output as LAPACK zgeqr2:
+    R in the upper triangle, the Householder vectors v (with implicit
+    v(k) = 1) below the diagonal, and the scalar factors in tau.
+
+    Reflectors are generated as in zlarfg, with the norm of x computed with
+    scaling to avoid overflow. The case tau = 0 (x = 0 and alpha real) is
+    handled with per-lane selects. zlarfg's iterative rescaling for
+    |beta| < safmin is not done; it only matters for matrices with entries
+    near the underflow threshold.
+*******************************************************************************/
+template< magma_int_t N >
+static void
+zgeqrf_interleaved( double *A, double *tau )
+{
+    const magma_int_t L = magma_batched_cpu_lanes< double >();
+    double scl[ L ], ssq[ L ], sclr[ L ];
+    #ifdef COMPLEX
+    double scli[ L ];
+    #endif
+
+    for (magma_int_t k = 0; k < N; ++k) {
+        // scaled 2-norm of x = A(k+1:N-1, k)
+        #pragma omp simd
+        for (magma_int_t l = 0; l < L; ++l) {
+            scl[l] = 0;
+            ssq[l] = 0;
+        }
+        for (magma_int_t i = k+1; i < N; ++i) {
+            const double *a = A(i,k);
+            #pragma omp simd
+            for (magma_int_t l = 0; l < L; ++l) {
+                #ifdef COMPLEX
+                scl[l] = max( scl[l], max( fabs( a[l] ), fabs( a[L+l] ) ) );
+                #else
+                scl[l] = max( scl[l], fabs( a[l] ) );
+                #endif
+            }
+        }
+        for (magma_int_t i = k+1; i < N; ++i) {
+            const double *a = A(i,k);
+            #pragma omp simd
+            for (magma_int_t l = 0; l < L; ++l) {
+                double s  = (scl[l] == 0 ? 1 : scl[l]);
+                double xr = a[l] / s;
+                #ifdef COMPLEX
+                double xi = a[L+l] / s;
+                ssq[l] += xr*xr + xi*xi;
+                #else
+                ssq[l] += xr*xr;
+                #endif
+            }
+        }
+
+        // generate elementary reflector H(k)
+        double *akk = A(k,k);
+        double *t   = tau(k);
+        #pragma omp simd
+        for (magma_int_t l = 0; l < L; ++l) {
+            double xnorm = scl[l] * sqrt( ssq[l] );
+            double alphr = akk[l];
+            #ifdef COMPLEX
+            double alphi = akk[L+l];
+            #else
+            double alphi = 0;
+            #endif
+            bool noop = (xnorm == 0 && alphi == 0);
+
+            // beta = -sign( alphr ) * lapy3( alphr, alphi, xnorm )
+            double w  = max( fabs( alphr ), max( fabs( alphi ), xnorm ) );
+            double ws = (w == 0 ? 1 : w);
+            double r1 = alphr / ws, r2 = alphi / ws, r3 = xnorm / ws;
+            double beta = -copysign( w * sqrt( r1*r1 + r2*r2 + r3*r3 ), alphr );
+            double bs   = (noop ? 1 : beta);
+
+            t[l]   = noop ? 0 : (beta - alphr) / bs;
+            #ifdef COMPLEX
+            t[L+l] = noop ? 0 : -alphi / bs;
+            #endif
+
+            // scale = 1 / (alpha - beta), with scaled complex division
+            double dr = noop ? 1 : alphr - beta;
+            #ifdef COMPLEX
+            double di = noop ? 0 : alphi;
+            double s  = max( fabs( dr ), fabs( di ) );
+            dr /= s;
+            di /= s;
+            double d  = s * (dr*dr + di*di);
+            sclr[l] =  dr / d;
+            scli[l] = -di / d;
+            akk[L+l] = noop ? alphi : 0;
+            #else
+            sclr[l] = 1 / dr;
+            #endif
+            akk[l] = noop ? alphr : beta;
+        }
+        for (magma_int_t i = k+1; i < N; ++i) {
+            double *a = A(i,k);
+            #pragma omp simd
+            for (magma_int_t l = 0; l < L; ++l) {
+                #ifdef COMPLEX
+                double ar = a[l], ai = a[L+l];
+                a[l]   = ar*sclr[l] - ai*scli[l];
+                a[L+l] = ar*scli[l] + ai*sclr[l];
+                #else
+                a[l] *= sclr[l];
+                #endif
+            }
+        }
+
+        // apply H(k)^H = I - conj(tau) v v^H to A(k:N-1, k+1:N-1) from the left
+        for (magma_int_t j = k+1; j < N; ++j) {
+            double wr[ L ];
+            #ifdef COMPLEX
+            double wi[ L ];
+            #endif
+            const double *akj = A(k,j);
+            // w = v^H A(:,j), with v(k) = 1
+            #pragma omp simd
+            for (magma_int_t l = 0; l < L; ++l) {
+                wr[l] = akj[l];
+                #ifdef COMPLEX
+                wi[l] = akj[L+l];
+                #endif
+            }
+            for (magma_int_t i = k+1; i < N; ++i) {
+                const double *v = A(i,k);
+                const double *a = A(i,j);
+                #pragma omp simd
+                for (magma_int_t l = 0; l < L; ++l) {
+                    #ifdef COMPLEX
+                    wr[l] += v[l]*a[l]   + v[L+l]*a[L+l];
+                    wi[l] += v[l]*a[L+l] - v[L+l]*a[l];
+                    #else
+                    wr[l] += v[l]*a[l];
+                    #endif
+                }
+            }
+            // w = conj(tau) * w
+            #pragma omp simd
+            for (magma_int_t l = 0; l < L; ++l) {
+                #ifdef COMPLEX
+                double r = t[l]*wr[l] + t[L+l]*wi[l];
+                double i = t[l]*wi[l] - t[L+l]*wr[l];
+                wr[l] = r;
+                wi[l] = i;
+                #else
+                wr[l] *= t[l];
+                #endif
+            }
+            // A(:,j) -= v * w
+            double *a = A(k,j);
+            #pragma omp simd
+            for (magma_int_t l = 0; l < L; ++l) {
+                a[l]   -= wr[l];
+                #ifdef COMPLEX
+                a[L+l] -= wi[l];
+                #endif
+            }
+            for (magma_int_t i = k+1; i < N; ++i) {
+                const double *v = A(i,k);
+                a = A(i,j);
+                #pragma omp simd
+                for (magma_int_t l = 0; l < L; ++l) {
+                    #ifdef COMPLEX
+                    a[l]   -= v[l]*wr[l] - v[L+l]*wi[l];
+                    a[L+l] -= v[l]*wi[l] + v[L+l]*wr[l];
+                    #else
+                    a[l]   -= v[l]*wr[l];
+                    #endif
+                }
+            }
+        }
+    }
+}
+
+
+/******************************************************************************/
+// factors one group of matrices: pack, factor, unpack
+template< magma_int_t N >
+static void
+zgeqrf_batched_cpu_group(
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    magmaDoubleComplex **tau_array,
+    magma_int_t count, double *buf )
+{
+    const magma_int_t L = magma_batched_cpu_lanes< double >();
+    double *A   = buf;
+    double *tau = A + N*N*NCOMP*L;
+
+    magma_batched_cpu_pack< double, NCOMP >(
+        N, (double const* const*) hA_array, lda, count, false, A );
+
+    zgeqrf_interleaved< N >( A, tau );
+
+    magma_batched_cpu_unpack< double, NCOMP >(
+        N, A, MagmaFull, count, false, (double* const*) hA_array, lda );
+    for (magma_int_t l = 0; l < count; ++l) {
+        for (magma_int_t k = 0; k < N; ++k) {
+            #ifdef COMPLEX
+            tau_array[l][k] = MAGMA_Z_MAKE( tau(k)[l], tau(k)[L+l] );
+            #else
+            tau_array[l][k] = tau(k)[l];
+            #endif
+        }
+    }
+}
+
+
+/******************************************************************************/
+template< magma_int_t N >
+static magma_int_t
+zgeqrf_batched_cpu_n(
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    magmaDoubleComplex **tau_array,
+    magma_int_t batchCount )
+{
+    const magma_int_t L = magma_batched_cpu_lanes< double >();
+    size_t bufsize = (N*N + N)*NCOMP*L;
+
+    return magma_batched_cpu_run< double >( batchCount, bufsize,
+        [=]( magma_int_t first, magma_int_t count, double *buf )
+        {
+            zgeqrf_batched_cpu_group< N >(
+                hA_array + first, lda, tau_array + first, count, buf );
+        });
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZGEQRF_BATCHED_CPU computes a QR factorization of each of a batch of
+    M-by-N matrices A on the host (CPU): A = Q * R. This is the host
+    counterpart of magma_zgeqrf_batched.
+
+    Square matrices of size up to 32 are repacked, a group of 8 (double) or
+    16 (single) matrices at a time, into a batch-interleaved layout, and
+    factored by kernels specialized at compile time for each size, so that
+    each SIMD lane factors a different matrix. Groups are distributed over
+    OpenMP threads. Other sizes are factored by LAPACK, one matrix per thread.
+
+    Arguments
+    ---------
+    @param[in]
+    m       INTEGER
+            The number of rows of each matrix A.  M >= 0.
+
+    @param[in]
+    n       INTEGER
+            The number of columns of each matrix A.  N >= 0.
+
+    @param[in,out]
+    hA_array Array of pointers, dimension (batchCount).
+            Each is a COMPLEX_16 array in CPU memory, dimension (LDA,N).
+            On entry, each pointer is an M-by-N matrix A.
+            On exit, the elements on and above the diagonal of the array
+            contain the min(M,N)-by-N upper trapezoidal matrix R (R is
+            upper triangular if m >= n); the elements below the diagonal,
+            with the array TAU, represent the orthogonal matrix Q as a
+            product of min(m,n) elementary reflectors (see Further Details
+            of LAPACK zgeqrf).
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of each array A.  LDA >= max(1,M).
+
+    @param[out]
+    tau_array Array of pointers, dimension (batchCount).
+            Each is a COMPLEX_16 array in CPU memory, dimension (min(M,N)).
+            The scalar factors of the elementary reflectors.
+
+    @param[out]
+    info_array  Array of INTEGERs in CPU memory, dimension (batchCount), for corresponding matrices.
+      -     = 0:  successful exit
+
+    @param[in]
+    batchCount  INTEGER
+                The number of matrices to operate on.
+
+    @return
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+                  or another error occured, such as memory allocation failed.
+
+    @ingroup magma_geqrf_batched
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zgeqrf_batched_cpu(
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    magmaDoubleComplex **tau_array,
+    magma_int_t *info_array,
+    magma_int_t batchCount )
+{
+    magma_int_t arginfo = 0;
+    if (m < 0)
+        arginfo = -1;
+    else if (n < 0)
+        arginfo = -2;
+    else if (lda < max(1,m))
+        arginfo = -4;
+    else if (batchCount < 0)
+        arginfo = -7;
+
+    if (arginfo != 0) {
+        magma_xerbla( __func__, -(arginfo) );
+        return arginfo;
+    }
+
+    for (magma_int_t s = 0; s < batchCount; ++s) {
+        info_array[s] = 0;
+    }
+
+    /* Quick return if possible */
+    if (m == 0 || n == 0 || batchCount == 0) {
+        return arginfo;
+    }
+
+    if (m == n && n <= MAGMA_BATCHED_CPU_MAX_N) {
+        switch (n) {
+            #define CASE( N_ ) \
+            case N_: return zgeqrf_batched_cpu_n< N_ >( hA_array, lda, tau_array, batchCount );
+            CASE( 1) CASE( 2) CASE( 3) CASE( 4) CASE( 5) CASE( 6) CASE( 7) CASE( 8)
+            CASE( 9) CASE(10) CASE(11) CASE(12) CASE(13) CASE(14) CASE(15) CASE(16)
+            CASE(17) CASE(18) CASE(19) CASE(20) CASE(21) CASE(22) CASE(23) CASE(24)
+            CASE(25) CASE(26) CASE(27) CASE(28) CASE(29) CASE(30) CASE(31) CASE(32)
+            #undef CASE
+        }
+    }
+
+    // general case: one LAPACK call per matrix, in parallel over the batch
+    #if defined(_OPENMP)
+    magma_int_t nthreads = magma_get_lapack_numthreads();
+    magma_set_lapack_numthreads(1);
+    magma_set_omp_numthreads(nthreads);
+    #endif
+    #pragma omp parallel
+    {
+        magmaDoubleComplex *work = NULL;
+        magma_int_t lwork = n * magma_get_zgeqrf_nb( m, n );
+        if (magma_zmalloc_cpu( &work, lwork ) != MAGMA_SUCCESS) {
+            lwork = -1;
+        }
+        #pragma omp for schedule(dynamic)
+        for (magma_int_t s = 0; s < batchCount; ++s) {
+            if (lwork > 0) {
+                lapackf77_zgeqrf( &m, &n, hA_array[s], &lda, tau_array[s],
+                                  work, &lwork, &info_array[s] );
+            }
+            else {
+                info_array[s] = MAGMA_ERR_HOST_ALLOC;
+            }
+        }
+        magma_free_cpu( work );
+    }
+    #if defined(_OPENMP)
+    magma_set_lapack_numthreads(nthreads);
+    #endif
+
+    return arginfo;
+}
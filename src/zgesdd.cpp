@@ -232,7 +232,7 @@ magma_zgesdd(
     double rdummy[1], runused[1];
     double anrm, bignum, eps, smlnum;
     magma_int_t ivt, iscl;
-    magma_int_t idummy[1], ierr, itau;
+    magma_int_t ierr, itau, nfound;
     magma_int_t chunk, wrkbl, itaup, itauq;
     magma_int_t nwork;
     magma_int_t ldwrkl, ldwrkr, ldwrku, ldwrkvt, minwrk, maxwrk, mnthr1, mnthr2;
@@ -811,7 +811,7 @@ magma_zgesdd(
                 // Perform bidiagonal SVD, computing singular values only
                 // Workspace:  need   0
                 // RWorkspace: need   N [e] + 4*N [bdsdc work]
-                lapackf77_dbdsdc( "U", "N", &n, s, &rwork[ie], rdummy, &ione, rdummy, &ione, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaNoVec, MagmaRangeAll, n, s, &rwork[ie], NULL, 1, NULL, 1, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
             }                                                     //
             else if (want_qo) {                                   //
                 // Path 2 (M >> N, JOBZ='O')
@@ -887,7 +887,7 @@ magma_zgesdd(
                 iru    = ie   + n;
                 irvt   = iru  + n*n;
                 nrwork = irvt + n*n;
-                lapackf77_dbdsdc( "U", "I", &n, s, &rwork[ie], &rwork[iru], &n, &rwork[irvt], &n, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, n, s, &rwork[ie], &rwork[iru], n, &rwork[irvt], n, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRU] to complex matrix WORK[IU]
                 // Overwrite WORK[IU] by the left singular vectors of R
@@ -987,7 +987,7 @@ magma_zgesdd(
                 iru    = ie   + n;
                 irvt   = iru  + n*n;
                 nrwork = irvt + n*n;
-                lapackf77_dbdsdc( "U", "I", &n, s, &rwork[ie], &rwork[iru], &n, &rwork[irvt], &n, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, n, s, &rwork[ie], &rwork[iru], n, &rwork[irvt], n, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRU] to complex matrix U
                 // Overwrite U by left singular vectors of R
@@ -1083,7 +1083,7 @@ magma_zgesdd(
                 iru    = ie   + n;
                 irvt   = iru  + n*n;
                 nrwork = irvt + n*n;
-                lapackf77_dbdsdc( "U", "I", &n, s, &rwork[ie], &rwork[iru], &n, &rwork[irvt], &n, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, n, s, &rwork[ie], &rwork[iru], n, &rwork[irvt], n, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRU] to complex matrix WORK[IU]
                 // Overwrite WORK[IU] by left singular vectors of R
@@ -1150,7 +1150,7 @@ magma_zgesdd(
                 // Perform bidiagonal SVD, computing singular values only
                 // Workspace:  need   0
                 // RWorkspace: need   N [e] + 4*N [bdsdc work]
-                lapackf77_dbdsdc( "U", "N", &n, s, &rwork[ie], rdummy, &ione, rdummy, &ione, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaNoVec, MagmaRangeAll, n, s, &rwork[ie], NULL, 1, NULL, 1, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
             }                                                     //
             else if (want_qo) {                                   //
                 // Path 5o (M >> N, JOBZ='O')
@@ -1199,7 +1199,7 @@ magma_zgesdd(
                 iru    = nrwork;
                 irvt   = iru  + n*n;
                 nrwork = irvt + n*n;
-                lapackf77_dbdsdc( "U", "I", &n, s, &rwork[ie], &rwork[iru], &n, &rwork[irvt], &n, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, n, s, &rwork[ie], &rwork[iru], n, &rwork[irvt], n, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
 
                 // Multiply real matrix RWORK[IRVT] by P**H in VT,
                 // storing the result in WORK[IU], copying to VT
@@ -1256,7 +1256,7 @@ magma_zgesdd(
                 iru    = nrwork;
                 irvt   = iru  + n*n;
                 nrwork = irvt + n*n;
-                lapackf77_dbdsdc( "U", "I", &n, s, &rwork[ie], &rwork[iru], &n, &rwork[irvt], &n, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, n, s, &rwork[ie], &rwork[iru], n, &rwork[irvt], n, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
 
                 // Multiply real matrix RWORK[IRVT] by P**H in VT,
                 // storing the result in A, copying to VT
@@ -1308,7 +1308,7 @@ magma_zgesdd(
                 iru    = nrwork;
                 irvt   = iru  + n*n;
                 nrwork = irvt + n*n;
-                lapackf77_dbdsdc( "U", "I", &n, s, &rwork[ie], &rwork[iru], &n, &rwork[irvt], &n, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, n, s, &rwork[ie], &rwork[iru], n, &rwork[irvt], n, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
 
                 // Multiply real matrix RWORK[IRVT] by P**H in VT,
                 // storing the result in A, copying to VT
@@ -1355,7 +1355,7 @@ magma_zgesdd(
                 // Perform bidiagonal SVD, computing singular values only
                 // Workspace:  need   0
                 // RWorkspace: need   N [e] + 4*N [bdsdc work]
-                lapackf77_dbdsdc( "U", "N", &n, s, &rwork[ie], rdummy, &ione, rdummy, &ione, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaNoVec, MagmaRangeAll, n, s, &rwork[ie], NULL, 1, NULL, 1, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
             }                                                     //
             else if (want_qo) {                                   //
                 // Path 6o (M >= N, JOBZ='O')
@@ -1379,7 +1379,7 @@ magma_zgesdd(
                 iru    = nrwork;
                 irvt   = iru  + n*n;
                 nrwork = irvt + n*n;
-                lapackf77_dbdsdc( "U", "I", &n, s, &rwork[ie], &rwork[iru], &n, &rwork[irvt], &n, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, n, s, &rwork[ie], &rwork[iru], n, &rwork[irvt], n, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRVT] to complex matrix VT
                 // Overwrite VT by right singular vectors of A
@@ -1451,7 +1451,7 @@ magma_zgesdd(
                 iru    = nrwork;
                 irvt   = iru  + n*n;
                 nrwork = irvt + n*n;
-                lapackf77_dbdsdc( "U", "I", &n, s, &rwork[ie], &rwork[iru], &n, &rwork[irvt], &n, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, n, s, &rwork[ie], &rwork[iru], n, &rwork[irvt], n, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRU] to complex matrix U
                 // Overwrite U by left singular vectors of A
@@ -1491,7 +1491,7 @@ magma_zgesdd(
                 iru    = nrwork;
                 irvt   = iru  + n*n;
                 nrwork = irvt + n*n;
-                lapackf77_dbdsdc( "U", "I", &n, s, &rwork[ie], &rwork[iru], &n, &rwork[irvt], &n, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, n, s, &rwork[ie], &rwork[iru], n, &rwork[irvt], n, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
 
                 // Set the right corner of U to identity matrix
                 lapackf77_zlaset( "F", &m, &m, &c_zero, &c_zero, U, &ldu );
@@ -1574,7 +1574,7 @@ magma_zgesdd(
                 // Perform bidiagonal SVD, computing singular values only
                 // Workspace:  need   0
                 // RWorkspace: need   M [e] + 4*M [bdsdc work]
-                lapackf77_dbdsdc( "U", "N", &m, s, &rwork[ie], rdummy, &ione, rdummy, &ione, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaNoVec, MagmaRangeAll, m, s, &rwork[ie], NULL, 1, NULL, 1, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
             }                                                     //
             else if (want_qo) {                                   //
                 // Path 2t (N >> M, JOBZ='O')
@@ -1650,7 +1650,7 @@ magma_zgesdd(
                 iru    = ie   + m;
                 irvt   = iru  + m*m;
                 nrwork = irvt + m*m;
-                lapackf77_dbdsdc( "U", "I", &m, s, &rwork[ie], &rwork[iru], &m, &rwork[irvt], &m, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, m, s, &rwork[ie], &rwork[iru], m, &rwork[irvt], m, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRU] to complex matrix WORK[IU]
                 // Overwrite WORK[IU] by the left singular vectors of L
@@ -1750,7 +1750,7 @@ magma_zgesdd(
                 iru    = ie   + m;
                 irvt   = iru  + m*m;
                 nrwork = irvt + m*m;
-                lapackf77_dbdsdc( "U", "I", &m, s, &rwork[ie], &rwork[iru], &m, &rwork[irvt], &m, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, m, s, &rwork[ie], &rwork[iru], m, &rwork[irvt], m, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRU] to complex matrix U
                 // Overwrite U by left singular vectors of L
@@ -1846,7 +1846,7 @@ magma_zgesdd(
                 iru    = ie   + m;
                 irvt   = iru  + m*m;
                 nrwork = irvt + m*m;
-                lapackf77_dbdsdc( "U", "I", &m, s, &rwork[ie], &rwork[iru], &m, &rwork[irvt], &m, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaUpper, MagmaIVec, MagmaRangeAll, m, s, &rwork[ie], &rwork[iru], m, &rwork[irvt], m, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRU] to complex matrix U
                 // Overwrite U by left singular vectors of L
@@ -1913,7 +1913,7 @@ magma_zgesdd(
                 // Perform bidiagonal SVD, computing singular values only
                 // Workspace:  need   0
                 // RWorkspace: need   M [e] + 4*M [bdsdc work]
-                lapackf77_dbdsdc( "L", "N", &m, s, &rwork[ie], rdummy, &ione, rdummy, &ione, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaNoVec, MagmaRangeAll, m, s, &rwork[ie], NULL, 1, NULL, 1, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
             }                                                     //
             else if (want_qo) {                                   //
                 // Path 5to (N >> M, JOBZ='O')
@@ -1964,7 +1964,7 @@ magma_zgesdd(
                 irvt   = nrwork;
                 iru    = irvt + m*m;
                 nrwork = iru  + m*m;
-                lapackf77_dbdsdc( "L", "I", &m, s, &rwork[ie], &rwork[iru], &m, &rwork[irvt], &m, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaIVec, MagmaRangeAll, m, s, &rwork[ie], &rwork[iru], m, &rwork[irvt], m, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
 
                 // Multiply Q in U by real matrix RWORK[IRVT]
                 // storing the result in WORK[IVT], copying to U
@@ -2021,7 +2021,7 @@ magma_zgesdd(
                 irvt   = nrwork;
                 iru    = irvt + m*m;
                 nrwork = iru  + m*m;
-                lapackf77_dbdsdc( "L", "I", &m, s, &rwork[ie], &rwork[iru], &m, &rwork[irvt], &m, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaIVec, MagmaRangeAll, m, s, &rwork[ie], &rwork[iru], m, &rwork[irvt], m, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
 
                 // Multiply Q in U by real matrix RWORK[IRU],
                 // storing the result in A, copying to U
@@ -2073,7 +2073,7 @@ magma_zgesdd(
                 irvt   = nrwork;
                 iru    = irvt + m*m;
                 nrwork = iru  + m*m;
-                lapackf77_dbdsdc( "L", "I", &m, s, &rwork[ie], &rwork[iru], &m, &rwork[irvt], &m, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaIVec, MagmaRangeAll, m, s, &rwork[ie], &rwork[iru], m, &rwork[irvt], m, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
 
                 // Multiply Q in U by real matrix RWORK[IRU],
                 // storing the result in A, copying to U
@@ -2122,7 +2122,7 @@ magma_zgesdd(
                 // Perform bidiagonal SVD, computing singular values only
                 // Workspace:  need   0
                 // RWorkspace: need   M [e] + 4*M [bdsdc work]
-                lapackf77_dbdsdc( "L", "N", &m, s, &rwork[ie], rdummy, &ione, rdummy, &ione, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaNoVec, MagmaRangeAll, m, s, &rwork[ie], NULL, 1, NULL, 1, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
             }                                                     //
             else if (want_qo) {                                   //
                 // Path 6to (N > M, JOBZ='O')
@@ -2150,7 +2150,7 @@ magma_zgesdd(
                 irvt   = nrwork;
                 iru    = irvt + m*m;
                 nrwork = iru  + m*m;
-                lapackf77_dbdsdc( "L", "I", &m, s, &rwork[ie], &rwork[iru], &m, &rwork[irvt], &m, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaIVec, MagmaRangeAll, m, s, &rwork[ie], &rwork[iru], m, &rwork[irvt], m, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRU] to complex matrix U
                 // Overwrite U by left singular vectors of A
@@ -2222,7 +2222,7 @@ magma_zgesdd(
                 irvt   = nrwork;
                 iru    = irvt + m*m;
                 nrwork = iru  + m*m;
-                lapackf77_dbdsdc( "L", "I", &m, s, &rwork[ie], &rwork[iru], &m, &rwork[irvt], &m, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaIVec, MagmaRangeAll, m, s, &rwork[ie], &rwork[iru], m, &rwork[irvt], m, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRU] to complex matrix U
                 // Overwrite U by left singular vectors of A
@@ -2262,7 +2262,7 @@ magma_zgesdd(
                 irvt   = nrwork;
                 iru    = irvt + m*m;
                 nrwork = iru  + m*m;
-                lapackf77_dbdsdc( "L", "I", &m, s, &rwork[ie], &rwork[iru], &m, &rwork[irvt], &m, rdummy, idummy, &rwork[nrwork], iwork, info );
+                magma_dbdsdc( MagmaLower, MagmaIVec, MagmaRangeAll, m, s, &rwork[ie], &rwork[iru], m, &rwork[irvt], m, 0, 0, 0, 0, &nfound, &rwork[nrwork], iwork, info );
 
                 // Copy real matrix RWORK[IRU] to complex matrix U
                 // Overwrite U by left singular vectors of A
@@ -0,0 +1,654 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "magma_internal.h"
+#include "batched_cpu.hpp"
+
+#define COMPLEX
+
+#ifdef COMPLEX
+#define NCOMP 2
+#else
+#define NCOMP 1
+#endif
+
+// Matrices with both dimensions up to this size are handled by the
+// interleaved Jacobi kernel; larger ones by LAPACK zgesvd, one matrix per
+// thread.
+const magma_int_t magma_zgesvdj_batched_max_n = 64;
+
+// Maximum number of Jacobi sweeps; a sweep visits every pair of columns.
+const magma_int_t magma_zgesvdj_max_sweeps = 30;
+
+// element (i,j) of the interleaved group; real plane, imaginary plane at +L
+#define A(i_, j_)  (A + ((j_)*m + (i_))*NCOMP*L)
+#define V(i_, j_)  (V + ((j_)*n + (i_))*NCOMP*L)
+
+
+/***************************************************************************//**
+    One-sided (Hestenes) Jacobi iteration on one interleaved group of m-by-n
+    matrices, m >= n (see batched_cpu.hpp). For N > 0 the number of columns
+    is fixed at compile time, so the pair loops of the small cases (2, 3, 4)
+    are fully unrolled; N = 0 takes it from n_.
+
+    For each pair of columns (p,q), the rotation G that diagonalizes their
+    Gram matrix
+        [ alpha       gamma ],  alpha = |a_p|^2,  beta = |a_q|^2,
+        [ conj(gamma) beta  ]   gamma = a_p^H a_q,
+    is applied to columns p and q of A (and of V). It has the same form as
+    in the Jacobi eigensolver, zheevj_batched_cpu. A rotation is applied only
+    where |gamma| > m eps sqrt( alpha beta ), i.e., where the columns are not
+    yet orthogonal to working accuracy; elsewhere the lane uses the identity.
+    |gamma| is computed with a scaled hypot, so (gamma / |gamma|) has unit
+    modulus and G stays unitary even when gamma is tiny.
+
+    A column with norm below eps |A|_F is negligible: for rank-deficient A,
+    such columns hold only rounding noise, and rotating them against each
+    other or against the large columns does not converge. A negligible
+    column is set to zero, which perturbs A by at most eps |A|_F per column,
+    and is not rotated. Its singular value is then zero, and its left
+    singular vector is completed by zgesvdj_left_vectors.
+
+    A lane is converged when a whole sweep applied no rotation; lanes that
+    are still rotating after the last sweep get info = 1.
+
+    On exit, the columns of A are orthogonal, with norms equal to the
+    (unsorted) singular values, and if wantv, V holds the right singular
+    vectors.
+*******************************************************************************/
+template< magma_int_t N >
+static void
+zgesvdj_interleaved(
+    magma_int_t m, magma_int_t n_, bool wantv, double *A, double *V, magma_int_t *info )
+{
+    const magma_int_t L = magma_batched_cpu_lanes< double >();
+    const magma_int_t n = (N > 0 ? N : n_);
+    const double eps = lapackf77_dlamch( "Epsilon" );
+    const double tol = m * eps;
+
+    bool   active[ L ], rotated[ L ];
+    double alpha[ L ], beta[ L ], c[ L ], s[ L ], zp[ L ], zq[ L ];
+    double small[ L ];  // (eps |A|_F)^2, squared norm of a negligible column
+    double ur[ L ];
+    #ifdef COMPLEX
+    double ui[ L ];
+    #endif
+
+    for (magma_int_t l = 0; l < L; ++l) {
+        active[l] = true;
+        small[l]  = 0;
+    }
+    for (magma_int_t j = 0; j < n; ++j) {
+        for (magma_int_t i = 0; i < m; ++i) {
+            const double *a = A(i,j);
+            #pragma omp simd
+            for (magma_int_t l = 0; l < L; ++l) {
+                #ifdef COMPLEX
+                small[l] += a[l]*a[l] + a[L+l]*a[L+l];
+                #else
+                small[l] += a[l]*a[l];
+                #endif
+            }
+        }
+    }
+    for (magma_int_t l = 0; l < L; ++l) {
+        small[l] *= eps*eps;
+    }
+    if (wantv) {
+        for (magma_int_t j = 0; j < n; ++j) {
+            for (magma_int_t i = 0; i < n; ++i) {
+                double *v = V(i,j);
+                for (magma_int_t l = 0; l < NCOMP*L; ++l) {
+                    v[l] = (i == j && l < L ? 1 : 0);
+                }
+            }
+        }
+    }
+
+    for (magma_int_t sweep = 0; sweep < magma_zgesvdj_max_sweeps; ++sweep) {
+        for (magma_int_t l = 0; l < L; ++l) {
+            rotated[l] = false;
+        }
+        for (magma_int_t p = 0; p < n-1; ++p) {
+            for (magma_int_t q = p+1; q < n; ++q) {
+                // Gram matrix of columns p and q; gamma accumulates in (ur, ui)
+                for (magma_int_t l = 0; l < L; ++l) {
+                    alpha[l] = 0;
+                    beta[l]  = 0;
+                    ur[l]    = 0;
+                    #ifdef COMPLEX
+                    ui[l]    = 0;
+                    #endif
+                }
+                for (magma_int_t k = 0; k < m; ++k) {
+                    const double *akp = A(k,p), *akq = A(k,q);
+                    #pragma omp simd
+                    for (magma_int_t l = 0; l < L; ++l) {
+                        #ifdef COMPLEX
+                        alpha[l] += akp[l]*akp[l] + akp[L+l]*akp[L+l];
+                        beta[l]  += akq[l]*akq[l] + akq[L+l]*akq[L+l];
+                        ur[l]    += akp[l]*akq[l] + akp[L+l]*akq[L+l];
+                        ui[l]    += akp[l]*akq[L+l] - akp[L+l]*akq[l];
+                        #else
+                        alpha[l] += akp[l]*akp[l];
+                        beta[l]  += akq[l]*akq[l];
+                        ur[l]    += akp[l]*akq[l];
+                        #endif
+                    }
+                }
+
+                // rotation for each lane
+                #pragma omp simd
+                for (magma_int_t l = 0; l < L; ++l) {
+                    #ifdef COMPLEX
+                    double gmax = max( fabs( ur[l] ), fabs( ui[l] ));
+                    double gmin = min( fabs( ur[l] ), fabs( ui[l] ));
+                    double g    = gmin / (gmax > 0 ? gmax : 1);
+                    double r    = gmax * sqrt( 1 + g*g );
+                    #else
+                    double r = fabs( ur[l] );
+                    #endif
+                    // negligible columns become exactly zero
+                    bool pzero = active[l] && alpha[l] <= small[l];
+                    bool qzero = active[l] && beta[l]  <= small[l];
+                    zp[l] = (pzero ? 0 : 1);
+                    zq[l] = (qzero ? 0 : 1);
+                    bool rot = active[l] && ! pzero && ! qzero && r > 0
+                            && r > tol * sqrt( alpha[l] ) * sqrt( beta[l] );
+                    double rr  = (rot ? r : 1);
+                    double tau = (beta[l] - alpha[l]) / (2*rr);
+                    double t   = (tau >= 0 ? 1 : -1) / (fabs( tau ) + sqrt( 1 + tau*tau ));
+                    t = (rot ? t : 0);
+                    c[l] = 1 / sqrt( 1 + t*t );
+                    s[l] = t * c[l];
+                    ur[l] = (rot ? ur[l] / rr : 1);
+                    #ifdef COMPLEX
+                    ui[l] = (rot ? ui[l] / rr : 0);
+                    #endif
+                    rotated[l] = rotated[l] || rot;
+                }
+
+                // columns p and q of A and V times G
+                for (magma_int_t k = 0; k < m; ++k) {
+                    double *akp = A(k,p), *akq = A(k,q);
+                    #pragma omp simd
+                    for (magma_int_t l = 0; l < L; ++l) {
+                        #ifdef COMPLEX
+                        double xr = akp[l], xi = akp[L+l], yr = akq[l], yi = akq[L+l];
+                        akp[l]   = zp[l]*(c[l]*xr - s[l]*(ur[l]*yr + ui[l]*yi));
+                        akp[L+l] = zp[l]*(c[l]*xi - s[l]*(ur[l]*yi - ui[l]*yr));
+                        akq[l]   = zq[l]*(s[l]*(ur[l]*xr - ui[l]*xi) + c[l]*yr);
+                        akq[L+l] = zq[l]*(s[l]*(ur[l]*xi + ui[l]*xr) + c[l]*yi);
+                        #else
+                        double x = akp[l], y = akq[l];
+                        akp[l] = zp[l]*(c[l]*x - s[l]*ur[l]*y);
+                        akq[l] = zq[l]*(s[l]*ur[l]*x + c[l]*y);
+                        #endif
+                    }
+                }
+                if (wantv) {
+                    for (magma_int_t k = 0; k < n; ++k) {
+                        double *vkp = V(k,p), *vkq = V(k,q);
+                        #pragma omp simd
+                        for (magma_int_t l = 0; l < L; ++l) {
+                            #ifdef COMPLEX
+                            double xr = vkp[l], xi = vkp[L+l], yr = vkq[l], yi = vkq[L+l];
+                            vkp[l]   = c[l]*xr - s[l]*(ur[l]*yr + ui[l]*yi);
+                            vkp[L+l] = c[l]*xi - s[l]*(ur[l]*yi - ui[l]*yr);
+                            vkq[l]   = s[l]*(ur[l]*xr - ui[l]*xi) + c[l]*yr;
+                            vkq[L+l] = s[l]*(ur[l]*xi + ui[l]*xr) + c[l]*yi;
+                            #else
+                            double x = vkp[l], y = vkq[l];
+                            vkp[l] = c[l]*x - s[l]*ur[l]*y;
+                            vkq[l] = s[l]*ur[l]*x + c[l]*y;
+                            #endif
+                        }
+                    }
+                }
+            }
+        }
+
+        bool any = false;
+        for (magma_int_t l = 0; l < L; ++l) {
+            active[l] = active[l] && rotated[l];
+            any = any || active[l];
+        }
+        if (! any) {
+            break;
+        }
+    }
+
+    for (magma_int_t l = 0; l < L; ++l) {
+        info[l] = (active[l] ? 1 : 0);
+    }
+}
+
+
+/******************************************************************************/
+// Normalizes the columns of A in lane l into left singular vectors.
+// Columns with zero singular value are replaced by unit vectors orthogonalized
+// (twice, by Gram-Schmidt) against the other columns, choosing the unit
+// vector e_i with the largest remaining component, 1 - |U(i,:)|^2, which is
+// at least (m - k)/m when k columns are set.
+// work is of size m*(NCOMP + 1).
+static void
+zgesvdj_left_vectors(
+    magma_int_t m, magma_int_t n, magma_int_t l, const double *sigma,
+    double *A, double *work )
+{
+    const magma_int_t L = magma_batched_cpu_lanes< double >();
+    #define a_r(i_, j_)  (A(i_, j_)[l])
+    #define a_i(i_, j_)  (A(i_, j_)[L+l])
+
+    double *rnorm = work + m*NCOMP;  // |U(i,:)|^2 over the columns already set
+    for (magma_int_t i = 0; i < m; ++i) {
+        rnorm[i] = 0;
+    }
+    for (magma_int_t j = 0; j < n; ++j) {
+        if (sigma[j] > 0) {
+            double inv = 1 / sigma[j];
+            for (magma_int_t i = 0; i < m; ++i) {
+                a_r(i,j) *= inv;
+                rnorm[i] += a_r(i,j)*a_r(i,j);
+                #ifdef COMPLEX
+                a_i(i,j) *= inv;
+                rnorm[i] += a_i(i,j)*a_i(i,j);
+                #endif
+            }
+        }
+    }
+    for (magma_int_t j = 0; j < n; ++j) {
+        if (sigma[j] > 0) {
+            continue;
+        }
+        magma_int_t e = 0;
+        for (magma_int_t i = 1; i < m; ++i) {
+            if (rnorm[i] < rnorm[e]) {
+                e = i;
+            }
+        }
+        // work = e_e - U U^H e_e, over the columns that are already set
+        for (magma_int_t i = 0; i < m; ++i) {
+            work[i*NCOMP] = (i == e ? 1 : 0);
+            #ifdef COMPLEX
+            work[i*NCOMP + 1] = 0;
+            #endif
+        }
+        for (magma_int_t pass = 0; pass < 2; ++pass) {
+            for (magma_int_t k = 0; k < n; ++k) {
+                if (k == j || (sigma[k] == 0 && k > j)) {
+                    continue;
+                }
+                double dr = 0;
+                #ifdef COMPLEX
+                double di = 0;
+                #endif
+                for (magma_int_t i = 0; i < m; ++i) {
+                    #ifdef COMPLEX
+                    dr += a_r(i,k)*work[i*NCOMP] + a_i(i,k)*work[i*NCOMP + 1];
+                    di += a_r(i,k)*work[i*NCOMP + 1] - a_i(i,k)*work[i*NCOMP];
+                    #else
+                    dr += a_r(i,k)*work[i];
+                    #endif
+                }
+                for (magma_int_t i = 0; i < m; ++i) {
+                    #ifdef COMPLEX
+                    work[i*NCOMP]     -= dr*a_r(i,k) - di*a_i(i,k);
+                    work[i*NCOMP + 1] -= dr*a_i(i,k) + di*a_r(i,k);
+                    #else
+                    work[i] -= dr*a_r(i,k);
+                    #endif
+                }
+            }
+        }
+        double nrm = 0;
+        for (magma_int_t i = 0; i < m*NCOMP; ++i) {
+            nrm += work[i]*work[i];
+        }
+        double inv = 1 / sqrt( nrm );
+        for (magma_int_t i = 0; i < m; ++i) {
+            a_r(i,j) = work[i*NCOMP] * inv;
+            rnorm[i] += a_r(i,j)*a_r(i,j);
+            #ifdef COMPLEX
+            a_i(i,j) = work[i*NCOMP + 1] * inv;
+            rnorm[i] += a_i(i,j)*a_i(i,j);
+            #endif
+        }
+    }
+    #undef a_r
+    #undef a_i
+}
+
+
+/******************************************************************************/
+// computes the SVD of one group of matrices: pack (A^H if m < n, so the
+// kernel always sees a tall matrix), iterate, then sort and unpack.
+// If A^H = U S V^H, then A = V S U^H, so U and V swap roles.
+template< magma_int_t N >
+static void
+zgesvdj_batched_cpu_group(
+    magma_vec_t jobz, magma_int_t m_, magma_int_t n_,
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    double **hS_array,
+    magmaDoubleComplex **hU_array, magma_int_t ldu,
+    magmaDoubleComplex **hV_array, magma_int_t ldv,
+    magma_int_t *info_array,
+    magma_int_t count, double *buf )
+{
+    const magma_int_t L = magma_batched_cpu_lanes< double >();
+    bool wide  = (m_ < n_);
+    bool wantv = (jobz == MagmaVec);
+    magma_int_t m = max( m_, n_ );
+    magma_int_t n = min( m_, n_ );
+
+    double *A     = buf;
+    double *V     = A + m*n*NCOMP*L;
+    double *sigma = V + n*n*NCOMP*L;
+    double *work  = sigma + n;
+    magma_int_t *info = (magma_int_t*) (work + m*(NCOMP + 1));
+    magma_int_t *perm = info + L;
+
+    magma_batched_cpu_pack< double, NCOMP >(
+        m, n, (double const* const*) hA_array, lda, count, wide, A );
+
+    zgesvdj_interleaved< N >( m, n, wantv, A, V, info );
+
+    for (magma_int_t l = 0; l < count; ++l) {
+        for (magma_int_t j = 0; j < n; ++j) {
+            double nrm = 0;
+            for (magma_int_t i = 0; i < m; ++i) {
+                nrm += A(i,j)[l] * A(i,j)[l];
+                #ifdef COMPLEX
+                nrm += A(i,j)[L+l] * A(i,j)[L+l];
+                #endif
+            }
+            sigma[j] = sqrt( nrm );
+        }
+
+        // singular values in descending order, vectors in the same order
+        for (magma_int_t j = 0; j < n; ++j) {
+            magma_int_t i = j;
+            for (; i > 0 && sigma[ perm[i-1] ] < sigma[j]; --i) {
+                perm[i] = perm[i-1];
+            }
+            perm[i] = j;
+        }
+        for (magma_int_t j = 0; j < n; ++j) {
+            hS_array[l][j] = sigma[ perm[j] ];
+        }
+
+        if (wantv) {
+            zgesvdj_left_vectors( m, n, l, sigma, A, work );
+            double *Ul = (double*) (wide ? hV_array[l] : hU_array[l]);
+            double *Vl = (double*) (wide ? hU_array[l] : hV_array[l]);
+            magma_int_t ldul = (wide ? ldv : ldu);
+            magma_int_t ldvl = (wide ? ldu : ldv);
+            for (magma_int_t j = 0; j < n; ++j) {
+                for (magma_int_t i = 0; i < m; ++i) {
+                    const double *a = A( i, perm[j] );
+                    Ul[ (i + j*ldul)*NCOMP ] = a[l];
+                    #ifdef COMPLEX
+                    Ul[ (i + j*ldul)*NCOMP + 1 ] = a[L+l];
+                    #endif
+                }
+                for (magma_int_t i = 0; i < n; ++i) {
+                    const double *v = V( i, perm[j] );
+                    Vl[ (i + j*ldvl)*NCOMP ] = v[l];
+                    #ifdef COMPLEX
+                    Vl[ (i + j*ldvl)*NCOMP + 1 ] = v[L+l];
+                    #endif
+                }
+            }
+        }
+        info_array[l] = info[l];
+    }
+}
+
+
+/******************************************************************************/
+template< magma_int_t N >
+static magma_int_t
+zgesvdj_batched_cpu_n(
+    magma_vec_t jobz, magma_int_t m, magma_int_t n,
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    double **hS_array,
+    magmaDoubleComplex **hU_array, magma_int_t ldu,
+    magmaDoubleComplex **hV_array, magma_int_t ldv,
+    magma_int_t *info_array,
+    magma_int_t batchCount )
+{
+    const magma_int_t L = magma_batched_cpu_lanes< double >();
+    magma_int_t mn = min( m, n );
+    magma_int_t mx = max( m, n );
+    size_t bufsize = (mx + mn)*mn*NCOMP*L + mn + mx*(NCOMP + 1)
+                   + magma_ceildiv( (L + mn)*sizeof(magma_int_t), sizeof(double) );
+
+    return magma_batched_cpu_run< double >( batchCount, bufsize,
+        [=]( magma_int_t first, magma_int_t count, double *buf )
+        {
+            zgesvdj_batched_cpu_group< N >(
+                jobz, m, n, hA_array + first, lda, hS_array + first,
+                hU_array + first, ldu, hV_array + first, ldv,
+                info_array + first, count, buf );
+        });
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZGESVDJ_BATCHED_CPU computes the singular value decomposition (SVD) of
+    each of a batch of complex m-by-n matrices A on the host (CPU), using the
+    one-sided Jacobi method. The SVD is written
+        A = U * SIGMA * V**H
+    where SIGMA is a min(m,n)-by-min(m,n) diagonal matrix, and U and V are
+    m-by-min(m,n) and n-by-min(m,n) matrices with orthonormal columns.
+    Note that V itself is returned, not V**H.
+
+    It is meant for large batches of tiny matrices, where zgesvd pays for a
+    workspace query, allocation, and the bidiagonal reduction for each
+    matrix. Matrices with m, n <= 64 are repacked, a group of 8 (double) or
+    16 (single) matrices at a time, into a batch-interleaved layout, so that
+    each SIMD lane works on a different matrix; a wide matrix is handled as
+    its conjugate-transpose. min(m,n) = 2, 3, and 4 use kernels specialized at
+    compile time. Sweeps continue only while some matrix in the group is not
+    converged; converged matrices are masked out. Groups are distributed over
+    OpenMP threads. Larger matrices are handled by LAPACK zgesvd, one matrix
+    per thread.
+
+    Jacobi computes the singular values to high relative accuracy.
+
+    Arguments
+    ---------
+    @param[in]
+    jobz    magma_vec_t
+      -     = MagmaNoVec:  Compute singular values only;
+      -     = MagmaVec:    Compute singular values and vectors.
+
+    @param[in]
+    m       INTEGER
+            The number of rows of each matrix A.  M >= 0.
+
+    @param[in]
+    n       INTEGER
+            The number of columns of each matrix A.  N >= 0.
+
+    @param[in,out]
+    hA_array Array of pointers, dimension (batchCount).
+            Each is a COMPLEX_16 array in CPU memory, dimension (LDA,N).
+            On entry, each pointer is an m-by-n matrix A.
+            On exit, if M <= 64 and N <= 64, A is unchanged; otherwise
+            A is destroyed.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of each array A.  LDA >= max(1,M).
+
+    @param[out]
+    hS_array Array of pointers, dimension (batchCount).
+            Each is a DOUBLE PRECISION array in CPU memory, dimension
+            (min(M,N)). On exit, the singular values of the corresponding
+            matrix, sorted so that S(i) >= S(i+1).
+
+    @param[out]
+    hU_array Array of pointers, dimension (batchCount).
+            Each is a COMPLEX_16 array in CPU memory, dimension (LDU,min(M,N)).
+            If JOBZ = MagmaVec, on exit, the left singular vectors, stored
+            columnwise. Not referenced if JOBZ = MagmaNoVec.
+
+    @param[in]
+    ldu     INTEGER
+            The leading dimension of each array U.  LDU >= 1;
+            if JOBZ = MagmaVec, LDU >= M.
+
+    @param[out]
+    hV_array Array of pointers, dimension (batchCount).
+            Each is a COMPLEX_16 array in CPU memory, dimension (LDV,min(M,N)).
+            If JOBZ = MagmaVec, on exit, the right singular vectors, stored
+            columnwise. Not referenced if JOBZ = MagmaNoVec.
+
+    @param[in]
+    ldv     INTEGER
+            The leading dimension of each array V.  LDV >= 1;
+            if JOBZ = MagmaVec, LDV >= N.
+
+    @param[out]
+    info_array  Array of INTEGERs in CPU memory, dimension (batchCount), for corresponding matrices.
+      -     = 0:  successful exit
+      -     > 0:  the Jacobi iteration (or zgesvd, for larger matrices)
+                  failed to converge.
+
+    @param[in]
+    batchCount  INTEGER
+                The number of matrices to operate on.
+
+    @return
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+                  or another error occured, such as memory allocation failed.
+
+    @ingroup magma_gesvdj_batched
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zgesvdj_batched_cpu(
+    magma_vec_t jobz, magma_int_t m, magma_int_t n,
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    double **hS_array,
+    magmaDoubleComplex **hU_array, magma_int_t ldu,
+    magmaDoubleComplex **hV_array, magma_int_t ldv,
+    magma_int_t *info_array,
+    magma_int_t batchCount )
+{
+    bool wantv = (jobz == MagmaVec);
+
+    magma_int_t arginfo = 0;
+    if (jobz != MagmaNoVec && jobz != MagmaVec)
+        arginfo = -1;
+    else if (m < 0)
+        arginfo = -2;
+    else if (n < 0)
+        arginfo = -3;
+    else if (lda < max(1,m))
+        arginfo = -5;
+    else if (ldu < 1 || (wantv && ldu < m))
+        arginfo = -8;
+    else if (ldv < 1 || (wantv && ldv < n))
+        arginfo = -10;
+    else if (batchCount < 0)
+        arginfo = -12;
+
+    if (arginfo != 0) {
+        magma_xerbla( __func__, -(arginfo) );
+        return arginfo;
+    }
+
+    /* Quick return if possible */
+    magma_int_t mn = min( m, n );
+    if (mn == 0 || batchCount == 0) {
+        for (magma_int_t s = 0; s < batchCount; ++s) {
+            info_array[s] = 0;
+        }
+        return arginfo;
+    }
+
+    if (max( m, n ) <= magma_zgesvdj_batched_max_n) {
+        switch (mn) {
+            case 1: return zgesvdj_batched_cpu_n< 1 >( jobz, m, n, hA_array, lda, hS_array, hU_array, ldu, hV_array, ldv, info_array, batchCount );
+            case 2: return zgesvdj_batched_cpu_n< 2 >( jobz, m, n, hA_array, lda, hS_array, hU_array, ldu, hV_array, ldv, info_array, batchCount );
+            case 3: return zgesvdj_batched_cpu_n< 3 >( jobz, m, n, hA_array, lda, hS_array, hU_array, ldu, hV_array, ldv, info_array, batchCount );
+            case 4: return zgesvdj_batched_cpu_n< 4 >( jobz, m, n, hA_array, lda, hS_array, hU_array, ldu, hV_array, ldv, info_array, batchCount );
+            default:
+                    return zgesvdj_batched_cpu_n< 0 >( jobz, m, n, hA_array, lda, hS_array, hU_array, ldu, hV_array, ldv, info_array, batchCount );
+        }
+    }
+
+    // general case: one LAPACK call per matrix, in parallel over the batch.
+    // zgesvd returns V^H in a per-thread workspace, transposed into V.
+    const char* job_ = (wantv ? "S" : "N");
+    magma_int_t lquery = -1, ldvt = max( 1, mn ), qinfo;
+    magmaDoubleComplex qwork;
+    #ifdef COMPLEX
+    magma_int_t lrwork = 5*mn;
+    lapackf77_zgesvd( job_, job_, &m, &n, NULL, &lda, NULL, NULL, &ldu, NULL, &ldvt,
+                      &qwork, &lquery, NULL, &qinfo );
+    #else
+    lapackf77_zgesvd( job_, job_, &m, &n, NULL, &lda, NULL, NULL, &ldu, NULL, &ldvt,
+                      &qwork, &lquery, &qinfo );
+    #endif
+    magma_int_t lwork = magma_int_t( MAGMA_Z_REAL( qwork ));
+
+    #if defined(_OPENMP)
+    magma_int_t nthreads = magma_get_lapack_numthreads();
+    magma_set_lapack_numthreads(1);
+    magma_set_omp_numthreads(nthreads);
+    #endif
+    #pragma omp parallel
+    {
+        magmaDoubleComplex *work = NULL, *VT = NULL;
+        double *rwork = NULL;
+        bool okay = (magma_zmalloc_cpu( &work, lwork ) == MAGMA_SUCCESS
+                  && magma_zmalloc_cpu( &VT, ldvt*n ) == MAGMA_SUCCESS);
+        #ifdef COMPLEX
+        okay = okay && magma_dmalloc_cpu( &rwork, lrwork ) == MAGMA_SUCCESS;
+        #endif
+        #pragma omp for schedule(dynamic)
+        for (magma_int_t s = 0; s < batchCount; ++s) {
+            if (okay) {
+                magmaDoubleComplex *U = (wantv ? hU_array[s] : NULL);
+                #ifdef COMPLEX
+                lapackf77_zgesvd( job_, job_, &m, &n, hA_array[s], &lda, hS_array[s],
+                                  U, &ldu, VT, &ldvt, work, &lwork, rwork,
+                                  &info_array[s] );
+                #else
+                lapackf77_zgesvd( job_, job_, &m, &n, hA_array[s], &lda, hS_array[s],
+                                  U, &ldu, VT, &ldvt, work, &lwork,
+                                  &info_array[s] );
+                #endif
+                if (wantv) {
+                    for (magma_int_t j = 0; j < mn; ++j) {
+                        for (magma_int_t i = 0; i < n; ++i) {
+                            hV_array[s][i + j*ldv] = MAGMA_Z_CONJ( VT[j + i*ldvt] );
+                        }
+                    }
+                }
+            }
+            else {
+                info_array[s] = MAGMA_ERR_HOST_ALLOC;
+            }
+        }
+        magma_free_cpu( work );
+        magma_free_cpu( VT );
+        magma_free_cpu( rwork );
+    }
+    #if defined(_OPENMP)
+    magma_set_lapack_numthreads(nthreads);
+    #endif
+
+    return arginfo;
+}
@@ -0,0 +1,334 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "magma_internal.h"
+#include "batched_cpu.hpp"
+
+#define COMPLEX
+
+#ifdef COMPLEX
+#define NCOMP 2
+#else
+#define NCOMP 1
+#endif
+
+// element (i,j) of the interleaved group; real plane, imaginary plane at +L
+#define A(i_, j_)  (A + ((j_)*N + (i_))*NCOMP*L)
+
+
+/***************************************************************************//**
+    Unblocked LU with partial pivoting of one interleaved group of N-by-N
+    matrices (see batched_cpu.hpp). N is a compile-time constant, so all
+    loops over rows and columns are fully unrolled and the innermost loop over
+    lanes vectorizes. Pivot search and row interchanges use per-lane selects
+    instead of branches, since every lane may choose a different pivot row.
+
+    The pivot is the first entry of largest |re| + |im|, as in izamax, and
+    columns with a zero pivot are left unscaled, as in LAPACK zgetf2.
+*******************************************************************************/
+template< magma_int_t N >
+static void
+zgetrf_interleaved( double *A, magma_int_t *ipiv, magma_int_t *info )
+{
+    const magma_int_t L = magma_batched_cpu_lanes< double >();
+    magma_int_t piv[ L ];
+    double amax[ L ], invr[ L ];
+    #ifdef COMPLEX
+    double invi[ L ];
+    #endif
+
+    for (magma_int_t l = 0; l < L; ++l) {
+        info[l] = 0;
+    }
+
+    for (magma_int_t k = 0; k < N; ++k) {
+        // find pivot
+        #pragma omp simd
+        for (magma_int_t l = 0; l < L; ++l) {
+            amax[l] = -1;
+            piv[l]  = k;
+        }
+        for (magma_int_t i = k; i < N; ++i) {
+            const double *a = A(i,k);
+            #pragma omp simd
+            for (magma_int_t l = 0; l < L; ++l) {
+                #ifdef COMPLEX
+                double v = fabs( a[l] ) + fabs( a[L+l] );
+                #else
+                double v = fabs( a[l] );
+                #endif
+                bool gt = v > amax[l];
+                amax[l] = gt ? v : amax[l];
+                piv[l]  = gt ? i : piv[l];
+            }
+        }
+        for (magma_int_t l = 0; l < L; ++l) {
+            ipiv[k*L + l] = piv[l] + 1;
+        }
+
+        // swap rows k and piv in every column with one sweep over rows k+1:N-1
+        for (magma_int_t j = 0; j < N; ++j) {
+            for (magma_int_t c = 0; c < NCOMP; ++c) {
+                double *ak = A(k,j) + c*L;
+                double vk[ L ];
+                #pragma omp simd
+                for (magma_int_t l = 0; l < L; ++l) {
+                    vk[l] = ak[l];
+                }
+                for (magma_int_t i = k+1; i < N; ++i) {
+                    double *ai = A(i,j) + c*L;
+                    #pragma omp simd
+                    for (magma_int_t l = 0; l < L; ++l) {
+                        bool s = (piv[l] == i);
+                        double t = ai[l];
+                        ai[l] = s ? ak[l] : t;
+                        vk[l] = s ? t : vk[l];
+                    }
+                }
+                #pragma omp simd
+                for (magma_int_t l = 0; l < L; ++l) {
+                    ak[l] = vk[l];
+                }
+            }
+        }
+
+        // reciprocal of pivot; zero pivot sets info and leaves column unscaled
+        const double *akk = A(k,k);
+        #pragma omp simd
+        for (magma_int_t l = 0; l < L; ++l) {
+            #ifdef COMPLEX
+            double pr = akk[l], pi = akk[L+l];
+            bool zero = (pr == 0 && pi == 0);
+            // scaled complex reciprocal, avoids overflow in |p|^2
+            double s  = zero ? 1 : max( fabs( pr ), fabs( pi ) );
+            pr = zero ? 1 : pr / s;
+            pi = zero ? 0 : pi / s;
+            double d = s * (pr*pr + pi*pi);
+            invr[l] =  pr / d;
+            invi[l] = -pi / d;
+            #else
+            double pr = akk[l];
+            bool zero = (pr == 0);
+            invr[l] = zero ? 1 : 1 / pr;
+            #endif
+            info[l] = (zero && info[l] == 0) ? k+1 : info[l];
+        }
+
+        // compute elements k+1:N-1 of column k
+        for (magma_int_t i = k+1; i < N; ++i) {
+            double *a = A(i,k);
+            #pragma omp simd
+            for (magma_int_t l = 0; l < L; ++l) {
+                #ifdef COMPLEX
+                double ar = a[l], ai = a[L+l];
+                a[l]   = ar*invr[l] - ai*invi[l];
+                a[L+l] = ar*invi[l] + ai*invr[l];
+                #else
+                a[l] *= invr[l];
+                #endif
+            }
+        }
+
+        // rank-1 update of trailing submatrix
+        for (magma_int_t j = k+1; j < N; ++j) {
+            const double *u = A(k,j);
+            for (magma_int_t i = k+1; i < N; ++i) {
+                const double *lk = A(i,k);
+                double *a = A(i,j);
+                #pragma omp simd
+                for (magma_int_t l = 0; l < L; ++l) {
+                    #ifdef COMPLEX
+                    a[l]   -= lk[l]*u[l]   - lk[L+l]*u[L+l];
+                    a[L+l] -= lk[l]*u[L+l] + lk[L+l]*u[l];
+                    #else
+                    a[l]   -= lk[l]*u[l];
+                    #endif
+                }
+            }
+        }
+    }
+}
+
+
+/******************************************************************************/
+// factors one group of matrices: pack, factor, unpack
+template< magma_int_t N >
+static void
+zgetrf_batched_cpu_group(
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    magma_int_t **ipiv_array, magma_int_t *info_array,
+    magma_int_t count, double *buf )
+{
+    const magma_int_t L = magma_batched_cpu_lanes< double >();
+    double *A = buf;
+    magma_int_t *ipiv = (magma_int_t*) (A + N*N*NCOMP*L);
+    magma_int_t *info = ipiv + N*L;
+
+    magma_batched_cpu_pack< double, NCOMP >(
+        N, (double const* const*) hA_array, lda, count, false, A );
+
+    zgetrf_interleaved< N >( A, ipiv, info );
+
+    magma_batched_cpu_unpack< double, NCOMP >(
+        N, A, MagmaFull, count, false, (double* const*) hA_array, lda );
+    for (magma_int_t l = 0; l < count; ++l) {
+        for (magma_int_t k = 0; k < N; ++k) {
+            ipiv_array[l][k] = ipiv[k*L + l];
+        }
+        info_array[l] = info[l];
+    }
+}
+
+
+/******************************************************************************/
+template< magma_int_t N >
+static magma_int_t
+zgetrf_batched_cpu_n(
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    magma_int_t **ipiv_array, magma_int_t *info_array,
+    magma_int_t batchCount )
+{
+    const magma_int_t L = magma_batched_cpu_lanes< double >();
+    // matrix, then ipiv and info as magma_int_t, rounded up to doubles
+    size_t bufsize = N*N*NCOMP*L
+                   + magma_ceildiv( (N + 1)*L*sizeof(magma_int_t), sizeof(double) );
+
+    return magma_batched_cpu_run< double >( batchCount, bufsize,
+        [=]( magma_int_t first, magma_int_t count, double *buf )
+        {
+            zgetrf_batched_cpu_group< N >(
+                hA_array + first, lda, ipiv_array + first, info_array + first,
+                count, buf );
+        });
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZGETRF_BATCHED_CPU computes an LU factorization of each of a batch of
+    general M-by-N matrices A on the host (CPU), using partial pivoting with
+    row interchanges. This is the host counterpart of magma_zgetrf_batched.
+
+    The factorization has the form
+        A = P * L * U
+    where P is a permutation matrix, L is lower triangular with unit
+    diagonal elements (lower trapezoidal if m > n), and U is upper
+    triangular (upper trapezoidal if m < n).
+
+    Square matrices of size up to 32 are repacked, a group of 8 (double) or
+    16 (single) matrices at a time, into a batch-interleaved layout, and
+    factored by kernels specialized at compile time for each size, so that
+    each SIMD lane factors a different matrix. Groups are distributed over
+    OpenMP threads. Other sizes are factored by LAPACK, one matrix per thread.
+
+    Arguments
+    ---------
+    @param[in]
+    m       INTEGER
+            The number of rows of each matrix A.  M >= 0.
+
+    @param[in]
+    n       INTEGER
+            The number of columns of each matrix A.  N >= 0.
+
+    @param[in,out]
+    hA_array Array of pointers, dimension (batchCount).
+            Each is a COMPLEX_16 array in CPU memory, dimension (LDA,N).
+            On entry, each pointer is an M-by-N matrix to be factored.
+            On exit, the factors L and U from the factorization
+            A = P*L*U; the unit diagonal elements of L are not stored.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of each array A.  LDA >= max(1,M).
+
+    @param[out]
+    ipiv_array  Array of pointers, dimension (batchCount), for corresponding matrices.
+            Each is an INTEGER array in CPU memory, dimension (min(M,N))
+            The pivot indices; for 1 <= i <= min(M,N), row i of the
+            matrix was interchanged with row IPIV(i).
+
+    @param[out]
+    info_array  Array of INTEGERs in CPU memory, dimension (batchCount), for corresponding matrices.
+      -     = 0:  successful exit
+      -     > 0:  if INFO = i, U(i,i) is exactly zero. The factorization
+                  has been completed, but the factor U is exactly
+                  singular, and division by zero will occur if it is used
+                  to solve a system of equations.
+
+    @param[in]
+    batchCount  INTEGER
+                The number of matrices to operate on.
+
+    @return
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+                  or another error occured, such as memory allocation failed.
+
+    @ingroup magma_getrf_batched
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zgetrf_batched_cpu(
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    magma_int_t **ipiv_array, magma_int_t *info_array,
+    magma_int_t batchCount )
+{
+    magma_int_t arginfo = 0;
+    if (m < 0)
+        arginfo = -1;
+    else if (n < 0)
+        arginfo = -2;
+    else if (lda < max(1,m))
+        arginfo = -4;
+    else if (batchCount < 0)
+        arginfo = -7;
+
+    if (arginfo != 0) {
+        magma_xerbla( __func__, -(arginfo) );
+        return arginfo;
+    }
+
+    /* Quick return if possible */
+    if (m == 0 || n == 0 || batchCount == 0) {
+        for (magma_int_t s = 0; s < batchCount; ++s) {
+            info_array[s] = 0;
+        }
+        return arginfo;
+    }
+
+    if (m == n && n <= MAGMA_BATCHED_CPU_MAX_N) {
+        switch (n) {
+            #define CASE( N_ ) \
+            case N_: return zgetrf_batched_cpu_n< N_ >( hA_array, lda, ipiv_array, info_array, batchCount );
+            CASE( 1) CASE( 2) CASE( 3) CASE( 4) CASE( 5) CASE( 6) CASE( 7) CASE( 8)
+            CASE( 9) CASE(10) CASE(11) CASE(12) CASE(13) CASE(14) CASE(15) CASE(16)
+            CASE(17) CASE(18) CASE(19) CASE(20) CASE(21) CASE(22) CASE(23) CASE(24)
+            CASE(25) CASE(26) CASE(27) CASE(28) CASE(29) CASE(30) CASE(31) CASE(32)
+            #undef CASE
+        }
+    }
+
+    // general case: one LAPACK call per matrix, in parallel over the batch
+    #if defined(_OPENMP)
+    magma_int_t nthreads = magma_get_lapack_numthreads();
+    magma_set_lapack_numthreads(1);
+    magma_set_omp_numthreads(nthreads);
+    #pragma omp parallel for schedule(dynamic)
+    #endif
+    for (magma_int_t s = 0; s < batchCount; ++s) {
+        lapackf77_zgetrf( &m, &n, hA_array[s], &lda, ipiv_array[s], &info_array[s] );
+    }
+    #if defined(_OPENMP)
+    magma_set_lapack_numthreads(nthreads);
+    #endif
+
+    return arginfo;
+}
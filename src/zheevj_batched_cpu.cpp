@@ -0,0 +1,459 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "magma_internal.h"
+#include "batched_cpu.hpp"
+
+#define COMPLEX
+
+#ifdef COMPLEX
+#define NCOMP 2
+#else
+#define NCOMP 1
+#endif
+
+// Matrices up to this size are diagonalized by the interleaved Jacobi
+// kernel; larger ones by LAPACK zheevd, one matrix per thread, which
+// is faster there.
+const magma_int_t magma_zheevj_batched_max_n = 24;
+
+// Maximum number of Jacobi sweeps; a sweep visits every off-diagonal pair.
+const magma_int_t magma_zheevj_max_sweeps = 30;
+
+// element (i,j) of the interleaved group; real plane, imaginary plane at +L
+#define A(i_, j_)  (A + ((j_)*n + (i_))*NCOMP*L)
+#define V(i_, j_)  (V + ((j_)*n + (i_))*NCOMP*L)
+
+
+/***************************************************************************//**
+    Cyclic Jacobi eigenvalue iteration on one interleaved group of n-by-n
+    Hermitian matrices (see batched_cpu.hpp), with both triangles stored.
+    For N > 0 the size is fixed at compile time, so the loops of the small
+    cases (2, 3, 4) are fully unrolled; N = 0 takes the size from n_.
+
+    Each pair (p,q) is annihilated by the rotation
+        G = [ c       s*u ]
+            [ -s*conj(u)  c ],   u = a_pq / |a_pq|,
+    which reduces the complex 2x2 problem to the real one. A rotation is
+    applied only where |a_pq| > eps * sqrt( |a_pp| |a_qq| ), which gives
+    eigenvalues to high relative accuracy; elsewhere the lane uses the
+    identity. A lane is converged when a whole sweep applied no rotation, and
+    the sweeps stop once every lane is converged; lanes that are still
+    rotating after the last sweep get info = 1.
+
+    On exit, the diagonal of A holds the unsorted eigenvalues, and if wantz,
+    V holds the eigenvectors.
+*******************************************************************************/
+template< magma_int_t N >
+static void
+zheevj_interleaved( magma_int_t n_, bool wantz, double *A, double *V, magma_int_t *info )
+{
+    const magma_int_t L = magma_batched_cpu_lanes< double >();
+    const magma_int_t n = (N > 0 ? N : n_);
+    const double eps = lapackf77_dlamch( "Epsilon" );
+
+    bool   active[ L ], rotated[ L ];
+    double c[ L ], s[ L ], ur[ L ];
+    #ifdef COMPLEX
+    double ui[ L ];
+    #endif
+
+    for (magma_int_t l = 0; l < L; ++l) {
+        active[l] = true;
+    }
+    if (wantz) {
+        for (magma_int_t j = 0; j < n; ++j) {
+            for (magma_int_t i = 0; i < n; ++i) {
+                double *v = V(i,j);
+                for (magma_int_t l = 0; l < NCOMP*L; ++l) {
+                    v[l] = (i == j && l < L ? 1 : 0);
+                }
+            }
+        }
+    }
+
+    for (magma_int_t sweep = 0; sweep < magma_zheevj_max_sweeps; ++sweep) {
+        for (magma_int_t l = 0; l < L; ++l) {
+            rotated[l] = false;
+        }
+        for (magma_int_t p = 0; p < n-1; ++p) {
+            for (magma_int_t q = p+1; q < n; ++q) {
+                // rotation for each lane, and its effect on the 2x2 block
+                double *app = A(p,p), *aqq = A(q,q), *apq = A(p,q), *aqp = A(q,p);
+                #pragma omp simd
+                for (magma_int_t l = 0; l < L; ++l) {
+                    #ifdef COMPLEX
+                    double r = sqrt( apq[l]*apq[l] + apq[L+l]*apq[L+l] );
+                    #else
+                    double r = fabs( apq[l] );
+                    #endif
+                    bool rot = active[l] && r > 0
+                            && r > eps * sqrt( fabs( app[l] )) * sqrt( fabs( aqq[l] ));
+                    double rr  = (rot ? r : 1);
+                    double tau = (aqq[l] - app[l]) / (2*rr);
+                    double t   = (tau >= 0 ? 1 : -1) / (fabs( tau ) + sqrt( 1 + tau*tau ));
+                    t = (rot ? t : 0);
+                    c[l] = 1 / sqrt( 1 + t*t );
+                    s[l] = t * c[l];
+                    ur[l] = (rot ? apq[l]   / rr : 1);
+                    #ifdef COMPLEX
+                    ui[l] = (rot ? apq[L+l] / rr : 0);
+                    apq[L+l] = (rot ? 0 : apq[L+l]);
+                    aqp[L+l] = (rot ? 0 : aqp[L+l]);
+                    #endif
+                    app[l] -= t*r;
+                    aqq[l] += t*r;
+                    apq[l] = (rot ? 0 : apq[l]);
+                    aqp[l] = (rot ? 0 : aqp[l]);
+                    rotated[l] = rotated[l] || rot;
+                }
+
+                // columns p and q times G; rows p and q are their conjugates
+                for (magma_int_t k = 0; k < n; ++k) {
+                    if (k == p || k == q) {
+                        continue;
+                    }
+                    double *akp = A(k,p), *akq = A(k,q), *apk = A(p,k), *aqk = A(q,k);
+                    #pragma omp simd
+                    for (magma_int_t l = 0; l < L; ++l) {
+                        #ifdef COMPLEX
+                        double xr = akp[l], xi = akp[L+l], yr = akq[l], yi = akq[L+l];
+                        double pr = c[l]*xr - s[l]*(ur[l]*yr + ui[l]*yi);
+                        double pi = c[l]*xi - s[l]*(ur[l]*yi - ui[l]*yr);
+                        double qr = s[l]*(ur[l]*xr - ui[l]*xi) + c[l]*yr;
+                        double qi = s[l]*(ur[l]*xi + ui[l]*xr) + c[l]*yi;
+                        akp[l] = pr;  akp[L+l] =  pi;
+                        akq[l] = qr;  akq[L+l] =  qi;
+                        apk[l] = pr;  apk[L+l] = -pi;
+                        aqk[l] = qr;  aqk[L+l] = -qi;
+                        #else
+                        double x = akp[l], y = akq[l];
+                        double pr = c[l]*x - s[l]*ur[l]*y;
+                        double qr = s[l]*ur[l]*x + c[l]*y;
+                        akp[l] = pr;
+                        akq[l] = qr;
+                        apk[l] = pr;
+                        aqk[l] = qr;
+                        #endif
+                    }
+                }
+
+                if (wantz) {
+                    for (magma_int_t k = 0; k < n; ++k) {
+                        double *vkp = V(k,p), *vkq = V(k,q);
+                        #pragma omp simd
+                        for (magma_int_t l = 0; l < L; ++l) {
+                            #ifdef COMPLEX
+                            double xr = vkp[l], xi = vkp[L+l], yr = vkq[l], yi = vkq[L+l];
+                            vkp[l]   = c[l]*xr - s[l]*(ur[l]*yr + ui[l]*yi);
+                            vkp[L+l] = c[l]*xi - s[l]*(ur[l]*yi - ui[l]*yr);
+                            vkq[l]   = s[l]*(ur[l]*xr - ui[l]*xi) + c[l]*yr;
+                            vkq[L+l] = s[l]*(ur[l]*xi + ui[l]*xr) + c[l]*yi;
+                            #else
+                            double x = vkp[l], y = vkq[l];
+                            vkp[l] = c[l]*x - s[l]*ur[l]*y;
+                            vkq[l] = s[l]*ur[l]*x + c[l]*y;
+                            #endif
+                        }
+                    }
+                }
+            }
+        }
+
+        bool any = false;
+        for (magma_int_t l = 0; l < L; ++l) {
+            active[l] = active[l] && rotated[l];
+            any = any || active[l];
+        }
+        // a single rotation diagonalizes a 2x2 matrix
+        if (! any || n <= 2) {
+            for (magma_int_t l = 0; l < L; ++l) {
+                active[l] = false;
+            }
+            break;
+        }
+    }
+
+    for (magma_int_t l = 0; l < L; ++l) {
+        info[l] = (active[l] ? 1 : 0);
+    }
+}
+
+
+/******************************************************************************/
+// diagonalizes one group of matrices: pack, complete the Hermitian matrix
+// from the given triangle, iterate, then sort and unpack.
+template< magma_int_t N >
+static void
+zheevj_batched_cpu_group(
+    magma_vec_t jobz, magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    double **hW_array, magma_int_t *info_array,
+    magma_int_t count, double *buf )
+{
+    const magma_int_t L = magma_batched_cpu_lanes< double >();
+    double *A = buf;
+    double *V = A + n*n*NCOMP*L;
+    magma_int_t *info = (magma_int_t*) (V + n*n*NCOMP*L);
+    magma_int_t *perm = info + L;
+    bool wantz = (jobz == MagmaVec);
+
+    magma_batched_cpu_pack< double, NCOMP >(
+        n, (double const* const*) hA_array, lda, count, false, A );
+
+    for (magma_int_t j = 0; j < n; ++j) {
+        for (magma_int_t i = j+1; i < n; ++i) {
+            double *src = (uplo == MagmaLower ? A(i,j) : A(j,i));
+            double *dst = (uplo == MagmaLower ? A(j,i) : A(i,j));
+            for (magma_int_t l = 0; l < L; ++l) {
+                dst[l] = src[l];
+                #ifdef COMPLEX
+                dst[L+l] = -src[L+l];
+                #endif
+            }
+        }
+        #ifdef COMPLEX
+        for (magma_int_t l = 0; l < L; ++l) {
+            A(j,j)[L+l] = 0;
+        }
+        #endif
+    }
+
+    zheevj_interleaved< N >( n, wantz, A, V, info );
+
+    // eigenvalues in ascending order, eigenvectors in the same order
+    for (magma_int_t l = 0; l < count; ++l) {
+        for (magma_int_t j = 0; j < n; ++j) {
+            double wj = A(j,j)[l];
+            magma_int_t i = j;
+            for (; i > 0 && A( perm[i-1], perm[i-1] )[l] > wj; --i) {
+                perm[i] = perm[i-1];
+            }
+            perm[i] = j;
+        }
+        for (magma_int_t j = 0; j < n; ++j) {
+            hW_array[l][j] = A( perm[j], perm[j] )[l];
+        }
+        if (wantz) {
+            double *Al = (double*) hA_array[l];
+            for (magma_int_t j = 0; j < n; ++j) {
+                for (magma_int_t i = 0; i < n; ++i) {
+                    const double *v = V( i, perm[j] );
+                    Al[ (i + j*lda)*NCOMP ] = v[l];
+                    #ifdef COMPLEX
+                    Al[ (i + j*lda)*NCOMP + 1 ] = v[L+l];
+                    #endif
+                }
+            }
+        }
+        info_array[l] = info[l];
+    }
+}
+
+
+/******************************************************************************/
+template< magma_int_t N >
+static magma_int_t
+zheevj_batched_cpu_n(
+    magma_vec_t jobz, magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    double **hW_array, magma_int_t *info_array,
+    magma_int_t batchCount )
+{
+    const magma_int_t L = magma_batched_cpu_lanes< double >();
+    size_t bufsize = 2*n*n*NCOMP*L
+                   + magma_ceildiv( (L + n)*sizeof(magma_int_t), sizeof(double) );
+
+    return magma_batched_cpu_run< double >( batchCount, bufsize,
+        [=]( magma_int_t first, magma_int_t count, double *buf )
+        {
+            zheevj_batched_cpu_group< N >(
+                jobz, uplo, n, hA_array + first, lda, hW_array + first,
+                info_array + first, count, buf );
+        });
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZHEEVJ_BATCHED_CPU computes all eigenvalues and, optionally, eigenvectors
+    of each of a batch of complex Hermitian matrices A on the host (CPU),
+    using the cyclic Jacobi method.
+
+    It is meant for large batches of tiny matrices, where zheevd pays for a
+    workspace query, allocation, and the tridiagonal reduction for each
+    matrix. Matrices of size up to 24 are repacked, a group of 8 (double) or
+    16 (single) matrices at a time, into a batch-interleaved layout, so that
+    each SIMD lane diagonalizes a different matrix. Sizes 2, 3, and 4 use
+    kernels specialized at compile time. Sweeps continue only while some
+    matrix in the group is not converged; converged matrices are masked out.
+    Groups are distributed over OpenMP threads. Larger matrices are solved
+    by LAPACK zheevd, one matrix per thread.
+
+    Each Jacobi sweep costs about as much as the whole of zheevd, and 5 to
+    10 sweeps are typical, so beyond n = 24 zheevd is faster even on tiny
+    matrices.
+
+    Arguments
+    ---------
+    @param[in]
+    jobz    magma_vec_t
+      -     = MagmaNoVec:  Compute eigenvalues only;
+      -     = MagmaVec:    Compute eigenvalues and eigenvectors.
+
+    @param[in]
+    uplo    magma_uplo_t
+      -     = MagmaUpper:  Upper triangle of A is stored;
+      -     = MagmaLower:  Lower triangle of A is stored.
+
+    @param[in]
+    n       INTEGER
+            The order of each matrix A.  N >= 0.
+
+    @param[in,out]
+    hA_array Array of pointers, dimension (batchCount).
+            Each is a COMPLEX_16 array in CPU memory, dimension (LDA,N).
+            On entry, each pointer is a Hermitian matrix A; only the triangle
+            given by uplo is referenced.
+            On exit, if JOBZ = MagmaVec, each A contains the orthonormal
+            eigenvectors of the matrix, in the order of the eigenvalues.
+            If JOBZ = MagmaNoVec and N <= 24, A is unchanged; otherwise
+            its triangle given by uplo is destroyed.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of each array A.  LDA >= max(1,N).
+
+    @param[out]
+    hW_array Array of pointers, dimension (batchCount).
+            Each is a DOUBLE PRECISION array in CPU memory, dimension (N).
+            On exit, the eigenvalues of the corresponding matrix in
+            ascending order.
+
+    @param[out]
+    info_array  Array of INTEGERs in CPU memory, dimension (batchCount), for corresponding matrices.
+      -     = 0:  successful exit
+      -     > 0:  the Jacobi iteration (or zheevd, for N > 24) failed to
+                  converge.
+
+    @param[in]
+    batchCount  INTEGER
+                The number of matrices to operate on.
+
+    @return
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+                  or another error occured, such as memory allocation failed.
+
+    @ingroup magma_heevj_batched
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zheevj_batched_cpu(
+    magma_vec_t jobz, magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    double **hW_array,
+    magma_int_t *info_array,
+    magma_int_t batchCount )
+{
+    magma_int_t arginfo = 0;
+    if (jobz != MagmaNoVec && jobz != MagmaVec)
+        arginfo = -1;
+    else if (uplo != MagmaUpper && uplo != MagmaLower)
+        arginfo = -2;
+    else if (n < 0)
+        arginfo = -3;
+    else if (lda < max(1,n))
+        arginfo = -5;
+    else if (batchCount < 0)
+        arginfo = -8;
+
+    if (arginfo != 0) {
+        magma_xerbla( __func__, -(arginfo) );
+        return arginfo;
+    }
+
+    /* Quick return if possible */
+    if (n == 0 || batchCount == 0) {
+        for (magma_int_t s = 0; s < batchCount; ++s) {
+            info_array[s] = 0;
+        }
+        return arginfo;
+    }
+
+    if (n <= magma_zheevj_batched_max_n) {
+        switch (n) {
+            case 1: return zheevj_batched_cpu_n< 1 >( jobz, uplo, n, hA_array, lda, hW_array, info_array, batchCount );
+            case 2: return zheevj_batched_cpu_n< 2 >( jobz, uplo, n, hA_array, lda, hW_array, info_array, batchCount );
+            case 3: return zheevj_batched_cpu_n< 3 >( jobz, uplo, n, hA_array, lda, hW_array, info_array, batchCount );
+            case 4: return zheevj_batched_cpu_n< 4 >( jobz, uplo, n, hA_array, lda, hW_array, info_array, batchCount );
+            default:
+                    return zheevj_batched_cpu_n< 0 >( jobz, uplo, n, hA_array, lda, hW_array, info_array, batchCount );
+        }
+    }
+
+    // general case: one LAPACK call per matrix, in parallel over the batch
+    const char* jobz_ = lapack_vec_const( jobz );
+    const char* uplo_ = lapack_uplo_const( uplo );
+    magma_int_t lquery = -1, qiwork, qinfo;
+    magmaDoubleComplex qwork;
+    #ifdef COMPLEX
+    double qrwork;
+    lapackf77_zheevd( jobz_, uplo_, &n, NULL, &lda, NULL,
+                      &qwork, &lquery, &qrwork, &lquery, &qiwork, &lquery, &qinfo );
+    magma_int_t lrwork = magma_int_t( qrwork );
+    #else
+    lapackf77_zheevd( jobz_, uplo_, &n, NULL, &lda, NULL,
+                      &qwork, &lquery, &qiwork, &lquery, &qinfo );
+    #endif
+    magma_int_t lwork  = magma_int_t( MAGMA_Z_REAL( qwork ));
+    magma_int_t liwork = qiwork;
+
+    #if defined(_OPENMP)
+    magma_int_t nthreads = magma_get_lapack_numthreads();
+    magma_set_lapack_numthreads(1);
+    magma_set_omp_numthreads(nthreads);
+    #endif
+    #pragma omp parallel
+    {
+        magmaDoubleComplex *work = NULL;
+        double *rwork = NULL;
+        magma_int_t *iwork = NULL;
+        bool okay = (magma_zmalloc_cpu( &work, lwork ) == MAGMA_SUCCESS
+                  && magma_imalloc_cpu( &iwork, liwork ) == MAGMA_SUCCESS);
+        #ifdef COMPLEX
+        okay = okay && magma_dmalloc_cpu( &rwork, lrwork ) == MAGMA_SUCCESS;
+        #endif
+        #pragma omp for schedule(dynamic)
+        for (magma_int_t s = 0; s < batchCount; ++s) {
+            if (okay) {
+                #ifdef COMPLEX
+                lapackf77_zheevd( jobz_, uplo_, &n, hA_array[s], &lda, hW_array[s],
+                                  work, &lwork, rwork, &lrwork, iwork, &liwork,
+                                  &info_array[s] );
+                #else
+                lapackf77_zheevd( jobz_, uplo_, &n, hA_array[s], &lda, hW_array[s],
+                                  work, &lwork, iwork, &liwork,
+                                  &info_array[s] );
+                #endif
+            }
+            else {
+                info_array[s] = MAGMA_ERR_HOST_ALLOC;
+            }
+        }
+        magma_free_cpu( work );
+        magma_free_cpu( rwork );
+        magma_free_cpu( iwork );
+    }
+    #if defined(_OPENMP)
+    magma_set_lapack_numthreads(nthreads);
+    #endif
+
+    return arginfo;
+}
@@ -426,10 +426,10 @@ magma_zheevr(
             lapackf77_dsterf(&n, &w[1], &rwork[indre], info);
             *m = n;
         } else {
-            lapackf77_dstebz(range_, "E", &n, &vl, &vu, &il, &iu, &abstol,
-                             &rwork[indrd], &rwork[indre], m,
-                             &nsplit, &w[1], &iwork[indibl], &iwork[indisp],
-                             &rwork[indrwk], &iwork[indiwo], info);
+            magma_dstebz(range, MagmaFalse, n, vl, vu, il, iu, abstol,
+                         &rwork[indrd], &rwork[indre], m,
+                         &nsplit, &w[1], &iwork[indibl], &iwork[indisp],
+                         &rwork[indrwk], &iwork[indiwo], info);
         }
         
         /* Otherwise call ZSTEMR if infinite and NaN arithmetic is supported */
@@ -445,9 +445,9 @@ magma_zheevr(
         else
             tryrac = 0;
         
-        lapackf77_zstemr(jobz_, range_, &n, &rwork[indrdd], &rwork[indree], &vl, &vu, &il,
-                         &iu, m, &w[1], Z, &ldz, &n, &isuppz[1], &tryrac, &rwork[indrwk],
-                         &llrwork, &iwork[1], &liwork, info);
+        magma_zstemr(jobz, range, n, &rwork[indrdd], &rwork[indree], vl, vu, il,
+                     iu, m, &w[1], Z, ldz, n, &isuppz[1], &tryrac, &rwork[indrwk],
+                     llrwork, &iwork[1], liwork, info);
         
         if (*info == 0 && wantz) {
             magma_zunmtr(MagmaLeft, uplo, MagmaNoTrans, n, *m, A, lda, &work[indtau],
@@ -460,11 +460,11 @@ magma_zheevr(
     if (wantz && (ieeeok == 0 || *info != 0)) {
         *info = 0;
         
-        lapackf77_dstebz(range_, "B", &n, &vl, &vu, &il, &iu, &abstol, &rwork[indrd], &rwork[indre], m,
-                         &nsplit, &w[1], &iwork[indibl], &iwork[indisp], &rwork[indrwk], &iwork[indiwo], info);
+        magma_dstebz(range, MagmaTrue, n, vl, vu, il, iu, abstol, &rwork[indrd], &rwork[indre], m,
+                     &nsplit, &w[1], &iwork[indibl], &iwork[indisp], &rwork[indrwk], &iwork[indiwo], info);
         
-        lapackf77_zstein(&n, &rwork[indrd], &rwork[indre], m, &w[1], &iwork[indibl], &iwork[indisp],
-                         Z, &ldz, &rwork[indrwk], &iwork[indiwo], &iwork[indifl], info);
+        magma_zstein(n, &rwork[indrd], &rwork[indre], *m, &w[1], &iwork[indibl], &iwork[indisp],
+                     Z, ldz, &rwork[indrwk], &iwork[indiwo], &iwork[indifl], info);
         
         /* Apply unitary matrix used in reduction to tridiagonal
            form to eigenvectors returned by ZSTEIN. */
@@ -470,10 +470,10 @@ magma_zheevr_gpu(
             lapackf77_dsterf(&n, &w[1], &rwork[indre], info);
             *m = n;
         } else {
-            lapackf77_dstebz(range_, "E", &n, &vl, &vu, &il, &iu, &abstol,
-                             &rwork[indrd], &rwork[indre], m,
-                             &nsplit, &w[1], &iwork[indibl], &iwork[indisp],
-                             &rwork[indrwk], &iwork[indiwo], info);
+            magma_dstebz(range, MagmaFalse, n, vl, vu, il, iu, abstol,
+                         &rwork[indrd], &rwork[indre], m,
+                         &nsplit, &w[1], &iwork[indibl], &iwork[indisp],
+                         &rwork[indrwk], &iwork[indiwo], info);
         }
 
         /* Otherwise call ZSTEMR if infinite and NaN arithmetic is supported */
@@ -490,9 +490,9 @@ magma_zheevr_gpu(
         else
             tryrac=0;
 
-        lapackf77_zstemr(jobz_, range_, &n, &rwork[indrdd], &rwork[indree], &vl, &vu, &il,
-                         &iu, m, &w[1], wZ, &ldwz, &n, &isuppz[1], &tryrac, &rwork[indrwk],
-                         &llrwork, &iwork[1], &liwork, info);
+        magma_zstemr(jobz, range, n, &rwork[indrdd], &rwork[indree], vl, vu, il,
+                     iu, m, &w[1], wZ, ldwz, n, &isuppz[1], &tryrac, &rwork[indrwk],
+                     llrwork, &iwork[1], liwork, info);
 
         if (*info == 0 && wantz) {
             magma_zsetmatrix( n, *m, wZ, ldwz, dZ, lddz, queue );
@@ -507,11 +507,11 @@ magma_zheevr_gpu(
         //printf("B/I\n");
         *info = 0;
 
-        lapackf77_dstebz(range_, "B", &n, &vl, &vu, &il, &iu, &abstol, &rwork[indrd], &rwork[indre], m,
-                         &nsplit, &w[1], &iwork[indibl], &iwork[indisp], &rwork[indrwk], &iwork[indiwo], info);
+        magma_dstebz(range, MagmaTrue, n, vl, vu, il, iu, abstol, &rwork[indrd], &rwork[indre], m,
+                     &nsplit, &w[1], &iwork[indibl], &iwork[indisp], &rwork[indrwk], &iwork[indiwo], info);
 
-        lapackf77_zstein(&n, &rwork[indrd], &rwork[indre], m, &w[1], &iwork[indibl], &iwork[indisp],
-                           wZ, &ldwz, &rwork[indrwk], &iwork[indiwo], &iwork[indifl], info);
+        magma_zstein(n, &rwork[indrd], &rwork[indre], *m, &w[1], &iwork[indibl], &iwork[indisp],
+                     wZ, ldwz, &rwork[indrwk], &iwork[indiwo], &iwork[indifl], info);
 
         /* Apply unitary matrix used in reduction to tridiagonal
            form to eigenvectors returned by ZSTEIN. */
@@ -190,7 +190,6 @@ magma_zheevx(
     const char* jobz_  = lapack_vec_const( jobz  );
     const char* range_ = lapack_range_const( range );
     
-    const char* order_;
     magma_int_t indd, inde;
     magma_int_t imax;
     magma_int_t lopt, itmp1, indee;
@@ -356,20 +355,15 @@ magma_zheevx(
     /* Otherwise, call DSTEBZ and, if eigenvectors are desired, ZSTEIN. */
     if (*m == 0) {
         *info = 0;
-        if (wantz) {
-            order_ = "B";
-        } else {
-            order_ = "E";
-        }
         indibl = 1;
         indisp = indibl + n;
         indiwk = indisp + n;
-        lapackf77_dstebz(range_, order_, &n, &vl, &vu, &il, &iu, &abstol, &rwork[indd], &rwork[inde], m,
-                         &nsplit, &w[1], &iwork[indibl], &iwork[indisp], &rwork[indrwk], &iwork[indiwk], info);
+        magma_dstebz(range, (wantz ? MagmaTrue : MagmaFalse), n, vl, vu, il, iu, abstol, &rwork[indd], &rwork[inde], m,
+                     &nsplit, &w[1], &iwork[indibl], &iwork[indisp], &rwork[indrwk], &iwork[indiwk], info);
         
         if (wantz) {
-            lapackf77_zstein(&n, &rwork[indd], &rwork[inde], m, &w[1], &iwork[indibl], &iwork[indisp],
-                             Z, &ldz, &rwork[indrwk], &iwork[indiwk], &ifail[1], info);
+            magma_zstein(n, &rwork[indd], &rwork[inde], *m, &w[1], &iwork[indibl], &iwork[indisp],
+                         Z, ldz, &rwork[indrwk], &iwork[indiwk], &ifail[1], info);
             
             /* Apply unitary matrix used in reduction to tridiagonal
                form to eigenvectors returned by ZSTEIN. */
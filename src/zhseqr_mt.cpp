@@ -0,0 +1,783 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c
+*/
+#include <atomic>
+#include <vector>
+
+#include "thread_queue.hpp"
+
+#include "magma_internal.h"  // after thread.hpp, so max, min are defined
+
+#define COMPLEX
+
+#define H(i_,j_) (d->H + (i_) + (j_)*d->ldh)
+#define Z(i_,j_) (d->Z + (i_) + (j_)*d->ldz)
+#define T(i_,j_) (T    + (i_) + (j_)*ldt)
+#define V(i_,j_) (V    + (i_) + (j_)*ldv)
+
+
+// ---------------------------------------------
+// Problem data shared by the QR sweep and the deflation window.
+// Indices are 0-based here, unlike the 1-based ilo, ihi of the interface.
+struct zhseqr_data
+{
+    bool wantt, wantz;
+    magma_int_t n;
+    magmaDoubleComplex *H;
+    magma_int_t ldh;
+    magmaDoubleComplex *Z;
+    magma_int_t ldz;
+    magma_int_t iloz, ihiz;     // rows of Z to update
+    double ulp, smlnum;
+    magma_thread_queue *queue;
+    magma_int_t nthread;
+    std::atomic< magma_int_t > pending;  // unfinished row updates of H
+};
+
+
+// ---------------------------------------------
+// Applies the unitary transform U of a window off the window:
+// A = U^H A (side = MagmaLeft, U is m-by-m), or A = A U (side = MagmaRight,
+// U is n-by-n). zgemm cannot work in place, so A is first copied.
+// If pending is set, it is decremented when done, so the caller can wait
+// for just these tasks, rather than the whole queue.
+class zhseqr_update_task: public magma_task
+{
+public:
+    zhseqr_update_task(
+        magma_side_t in_side, magma_int_t in_m, magma_int_t in_n,
+        const magmaDoubleComplex *in_U, magma_int_t in_ldu,
+        magmaDoubleComplex *in_A, magma_int_t in_lda,
+        std::atomic< magma_int_t > *in_pending
+    ):
+        side   ( in_side    ),
+        m      ( in_m       ),
+        n      ( in_n       ),
+        U      ( in_U       ),
+        ldu    ( in_ldu     ),
+        A      ( in_A       ),
+        lda    ( in_lda     ),
+        pending( in_pending )
+    {}
+
+    virtual void run()
+    {
+        const magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+        const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+        std::vector< magmaDoubleComplex > tmp( m*n );
+        lapackf77_zlacpy( "F", &m, &n, A, &lda, &tmp[0], &m );
+        if (side == MagmaLeft) {
+            blasf77_zgemm( "C", "N", &m, &n, &m,
+                           &c_one,  U, &ldu, &tmp[0], &m,
+                           &c_zero, A, &lda );
+        }
+        else {
+            blasf77_zgemm( "N", "N", &m, &n, &n,
+                           &c_one,  &tmp[0], &m, U, &ldu,
+                           &c_zero, A, &lda );
+        }
+        if (pending != NULL) {
+            --(*pending);
+        }
+    }
+
+private:
+    magma_side_t  side;
+    magma_int_t   m;
+    magma_int_t   n;
+    const magmaDoubleComplex *U;
+    magma_int_t   ldu;
+    magmaDoubleComplex *A;
+    magma_int_t   lda;
+    std::atomic< magma_int_t > *pending;
+};
+
+
+/******************************************************************************/
+// Queues A = U^H A or A = A U, split along the long dimension of A into
+// one block per thread.
+static void zhseqr_push_update(
+    zhseqr_data *d, magma_side_t side, magma_int_t m, magma_int_t n,
+    const magmaDoubleComplex *U, magma_int_t ldu,
+    magmaDoubleComplex *A, magma_int_t lda,
+    std::atomic< magma_int_t > *pending )
+{
+    if (m <= 0 || n <= 0) {
+        return;
+    }
+    magma_int_t len = (side == MagmaLeft ? n : m);
+    magma_int_t nb  = max( 32, magma_roundup( magma_ceildiv( len, d->nthread ), 16 ));
+    for (magma_int_t j = 0; j < len; j += nb) {
+        magma_int_t jb = min( nb, len - j );
+        if (pending != NULL) {
+            ++(*pending);
+        }
+        if (side == MagmaLeft) {
+            d->queue->push_task( new zhseqr_update_task(
+                side, m, jb, U, ldu, A + j*lda, lda, pending ));
+        }
+        else {
+            d->queue->push_task( new zhseqr_update_task(
+                side, jb, n, U, ldu, A + j, lda, pending ));
+        }
+    }
+}
+
+
+/******************************************************************************/
+// Queues the off-window part of the similarity U^H H U for the window
+// H(wlo:wlo+nw-1, wlo:wlo+nw-1) of active block [ktop, kbot], and Z = Z U.
+// The rows of H right of the window go first, and count in d->pending,
+// since the next window depends on them; the columns above the window and
+// Z can overlap with the next window's bulge chasing.
+static void zhseqr_push_window_update(
+    zhseqr_data *d, magma_int_t ktop, magma_int_t kbot,
+    magma_int_t wlo, magma_int_t nw,
+    const magmaDoubleComplex *U, magma_int_t ldu )
+{
+    magma_int_t whi  = wlo + nw - 1;
+    magma_int_t jend = (d->wantt ? d->n - 1 : kbot);
+    magma_int_t ibeg = (d->wantt ? 0 : ktop);
+    zhseqr_push_update( d, MagmaLeft,  nw, jend - whi, U, ldu, H(wlo, whi+1), d->ldh, &d->pending );
+    zhseqr_push_update( d, MagmaRight, wlo - ibeg, nw, U, ldu, H(ibeg, wlo),  d->ldh, NULL );
+    if (d->wantz) {
+        zhseqr_push_update( d, MagmaRight, d->ihiz - d->iloz + 1, nw, U, ldu,
+                            Z(d->iloz, wlo), d->ldz, NULL );
+    }
+}
+
+
+/******************************************************************************/
+// Waits for the queued row updates of H, but not the rest of the queue.
+static void zhseqr_wait_pending( zhseqr_data *d )
+{
+    while (d->pending > 0) {
+        magma_yield();
+    }
+}
+
+
+/******************************************************************************/
+// Applies the reflector I - tau v v^H, with v[0] = 1 and nr <= 3, from the
+// left as its conjugate-transpose, to columns [0, ncol) of A,
+// or from the right to rows [0, nrow) of A.
+static inline void zhseqr_reflect_left(
+    magma_int_t nr, const magmaDoubleComplex *v, magmaDoubleComplex tau,
+    magmaDoubleComplex *A, magma_int_t lda, magma_int_t ncol )
+{
+    tau = MAGMA_Z_CONJ( tau );
+    for (magma_int_t j = 0; j < ncol; ++j) {
+        magmaDoubleComplex *a = A + j*lda;
+        magmaDoubleComplex sum = a[0];
+        for (magma_int_t i = 1; i < nr; ++i) {
+            sum += MAGMA_Z_CONJ( v[i] ) * a[i];
+        }
+        sum *= tau;
+        a[0] -= sum;
+        for (magma_int_t i = 1; i < nr; ++i) {
+            a[i] -= v[i] * sum;
+        }
+    }
+}
+
+static inline void zhseqr_reflect_right(
+    magma_int_t nr, const magmaDoubleComplex *v, magmaDoubleComplex tau,
+    magmaDoubleComplex *A, magma_int_t lda, magma_int_t nrow )
+{
+    for (magma_int_t i = 0; i < nrow; ++i) {
+        magmaDoubleComplex sum = A[i];
+        for (magma_int_t j = 1; j < nr; ++j) {
+            sum += A[i + j*lda] * v[j];
+        }
+        sum *= tau;
+        A[i] -= sum;
+        for (magma_int_t j = 1; j < nr; ++j) {
+            A[i + j*lda] -= sum * MAGMA_Z_CONJ( v[j] );
+        }
+    }
+}
+
+
+/******************************************************************************/
+// One small-bulge multishift QR sweep on active block [ktop, kbot] with the
+// ns (even) shifts sh, as a chain of ns/2 double-shift 3x3 bulges.
+//
+// Bulge m is introduced at row ktop at step 4m and moves down one row per
+// step, so at step t its reflector acts on rows k = ktop + t - 4m .. k+2.
+// With 4 rows between bulges, the reflectors of one step touch disjoint
+// data, except where a left and a right update overlap, which commute.
+// Steps are chased in windows: within a window the reflectors update only
+// H(win, win), and accumulate into U; the rest of H and Z are then updated
+// with U by level-3 tasks on the thread queue, while the next window is
+// chased.
+static void zhseqr_sweep(
+    zhseqr_data *d, magma_int_t ktop, magma_int_t kbot,
+    magma_int_t ns, const magmaDoubleComplex *sh )
+{
+    const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    const magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    const magma_int_t ione = 1;
+
+    magma_int_t nbmps  = ns / 2;
+    magma_int_t nsteps = (kbot - ktop) + 4*(nbmps - 1);
+    magma_int_t nstep  = max( 4*nbmps, 16 );           // steps per window
+    magma_int_t ldu    = nstep + 4*(nbmps - 1) + 4;    // max window size
+    std::vector< magmaDoubleComplex > Ubuf( 2*ldu*ldu );
+    magmaDoubleComplex v[3], tau, alpha;
+    magma_int_t iwin = 0;
+
+    for (magma_int_t t0 = 0; t0 < nsteps; t0 += nstep, ++iwin) {
+        magma_int_t t1   = min( t0 + nstep, nsteps );
+        magma_int_t kmin = max( ktop,   ktop + t0 - 4*(nbmps - 1) );
+        magma_int_t kmax = min( kbot-1, ktop + t1 - 1 );
+        magma_int_t wlo  = max( ktop, kmin - 1 );
+        magma_int_t whi  = min( kbot, kmax + 3 );
+        magma_int_t nw   = whi - wlo + 1;
+        magmaDoubleComplex *U = &Ubuf[ (iwin % 2)*ldu*ldu ];
+        lapackf77_zlaset( "F", &nw, &nw, &c_zero, &c_one, U, &ldu );
+
+        // the previous window's updates right of it include this window
+        zhseqr_wait_pending( d );
+
+        for (magma_int_t t = t0; t < t1; ++t) {
+            for (magma_int_t m = 0; m < nbmps; ++m) {
+                magma_int_t k = ktop + t - 4*m;
+                if (k < ktop) {
+                    break;  // this and later bulges are not introduced yet
+                }
+                if (k > kbot - 1) {
+                    continue;
+                }
+                magma_int_t nr = min( 3, kbot - k + 1 );
+                if (k == ktop) {
+                    // first column of (H - s1 I)(H - s2 I), scaled, as in zlaqr1
+                    magmaDoubleComplex s1 = sh[2*m], s2 = sh[2*m+1];
+                    magmaDoubleComplex h00 = *H(k,k), h10 = *H(k+1,k);
+                    double s = MAGMA_Z_ABS1( h00 - s2 ) + MAGMA_Z_ABS1( h10 );
+                    if (nr == 3) {
+                        s += MAGMA_Z_ABS1( *H(k+2,k) );
+                    }
+                    if (s == 0) {
+                        v[0] = v[1] = v[2] = c_zero;
+                    }
+                    else {
+                        magmaDoubleComplex h10s = h10 / s;
+                        v[0] = h10s * *H(k,k+1) + (h00 - s1) * ((h00 - s2) / s);
+                        v[1] = h10s * (h00 + *H(k+1,k+1) - s1 - s2);
+                        if (nr == 3) {
+                            magmaDoubleComplex h20s = *H(k+2,k) / s;
+                            v[0] += h20s * *H(k,k+2);
+                            v[1] += h20s * *H(k+1,k+2);
+                            v[2]  = h20s * (h00 + *H(k+2,k+2) - s1 - s2) + h10s * *H(k+2,k+1);
+                        }
+                    }
+                    alpha = v[0];
+                    lapackf77_zlarfg( &nr, &alpha, &v[1], &ione, &tau );
+                }
+                else {
+                    // reflect the bulge in column k-1 down one row
+                    for (magma_int_t i = 0; i < nr; ++i) {
+                        v[i] = *H(k+i, k-1);
+                    }
+                    alpha = v[0];
+                    lapackf77_zlarfg( &nr, &alpha, &v[1], &ione, &tau );
+                    *H(k, k-1) = alpha;
+                    for (magma_int_t i = 1; i < nr; ++i) {
+                        *H(k+i, k-1) = c_zero;
+                    }
+                }
+                v[0] = c_one;
+                zhseqr_reflect_left(  nr, v, tau, H(k, k),   d->ldh, whi - k + 1 );
+                zhseqr_reflect_right( nr, v, tau, H(wlo, k), d->ldh, min( k+3, kbot ) - wlo + 1 );
+                zhseqr_reflect_right( nr, v, tau, U + (k - wlo)*ldu, ldu, nw );
+            }
+        }
+
+        // the previous window's U is free once its updates are done
+        d->queue->sync();
+        zhseqr_push_window_update( d, ktop, kbot, wlo, nw, U, ldu );
+    }
+    d->queue->sync();
+}
+
+
+/******************************************************************************/
+// Aggressive early deflation on the trailing nw-by-nw window of active
+// block [ktop, kbot], as in zlaqr3. Computes the Schur form of the window,
+// finds eigenvalues whose spike entries are negligible, and moves the
+// others to the top of the window. If anything deflated, the window is
+// returned to Hessenberg form and written back into H, with the
+// off-window updates on the thread queue.
+// Returns the number deflated in nd, with their eigenvalues in w, and the
+// ns undeflated eigenvalues in sh, for use as shifts.
+static void zhseqr_aed(
+    zhseqr_data *d, magma_int_t ktop, magma_int_t kbot, magma_int_t nw,
+    magmaDoubleComplex *w, magmaDoubleComplex *sh,
+    magma_int_t *ns_out, magma_int_t *nd_out )
+{
+    const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    const magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    const magma_int_t ione  = 1;
+    const magma_int_t itrue = 1;
+
+    magma_int_t kwtop = kbot - nw + 1;
+    magmaDoubleComplex s = (kwtop == ktop ? c_zero : *H(kwtop, kwtop-1));
+
+    if (kwtop == kbot) {
+        // 1-by-1 window
+        sh[0] = *H(kwtop, kwtop);
+        w[kwtop] = sh[0];
+        *ns_out = 1;
+        *nd_out = 0;
+        if (MAGMA_Z_ABS1( s ) <= max( d->smlnum, d->ulp * MAGMA_Z_ABS1( *H(kwtop, kwtop) ))) {
+            *ns_out = 0;
+            *nd_out = 1;
+            if (kwtop > ktop) {
+                *H(kwtop, kwtop-1) = c_zero;
+            }
+        }
+        return;
+    }
+
+    // Schur form T = V^H H V of the window
+    magma_int_t ldt = nw, ldv = nw, info, infqr;
+    std::vector< magmaDoubleComplex > Tbuf( nw*nw ), Vbuf( nw*nw ), tau( nw );
+    magmaDoubleComplex *T = &Tbuf[0], *V = &Vbuf[0];
+    lapackf77_zlaset( "F", &nw, &nw, &c_zero, &c_zero, T, &ldt );
+    lapackf77_zlacpy( "U", &nw, &nw, H(kwtop, kwtop), &d->ldh, T, &ldt );
+    for (magma_int_t j = 0; j < nw - 1; ++j) {
+        *T(j+1, j) = *H(kwtop+j+1, kwtop+j);
+    }
+    lapackf77_zlaset( "F", &nw, &nw, &c_zero, &c_one, V, &ldv );
+    lapackf77_zlahqr( &itrue, &itrue, &nw, &ione, &nw, T, &ldt, sh,
+                      &ione, &nw, V, &ldv, &infqr );
+
+    // deflation detection; eigenvalues that do not deflate move to the top
+    magma_int_t ns = nw;
+    magma_int_t ilst = infqr + 1;  // 1-based for ztrexc
+    for (magma_int_t knt = infqr; knt < nw; ++knt) {
+        double foo = MAGMA_Z_ABS1( *T(ns-1, ns-1) );
+        if (foo == 0) {
+            foo = MAGMA_Z_ABS1( s );
+        }
+        if (MAGMA_Z_ABS1( s ) * MAGMA_Z_ABS1( *V(0, ns-1) )
+            <= max( d->smlnum, d->ulp * foo )) {
+            ns -= 1;
+        }
+        else {
+            magma_int_t ifst = ns;
+            lapackf77_ztrexc( "V", &nw, T, &ldt, V, &ldv, &ifst, &ilst, &info );
+            ilst += 1;
+        }
+    }
+    if (ns == 0) {
+        s = c_zero;
+    }
+
+    for (magma_int_t i = 0; i < nw; ++i) {
+        if (i < ns) {
+            sh[i] = *T(i,i);
+        }
+        else {
+            w[kwtop + i] = *T(i,i);
+        }
+    }
+
+    if (ns < nw || MAGMA_Z_EQUAL( s, c_zero )) {
+        magma_int_t lwork = nw*64;
+        std::vector< magmaDoubleComplex > work( max( lwork, nw ));
+        if (ns > 1 && ! MAGMA_Z_EQUAL( s, c_zero )) {
+            // reflect the spike s V(0, 0:ns-1)^H back to a multiple of e1
+            std::vector< magmaDoubleComplex > spike( ns );
+            magmaDoubleComplex beta, t, ctau;
+            for (magma_int_t j = 0; j < ns; ++j) {
+                spike[j] = s * MAGMA_Z_CONJ( *V(0, j) );
+            }
+            beta = spike[0];
+            lapackf77_zlarfg( &ns, &beta, &spike[1], &ione, &t );
+            spike[0] = c_one;
+
+            magma_int_t nw2 = nw - 2;
+            lapackf77_zlaset( "L", &nw2, &nw2, &c_zero, &c_zero, T(2,0), &ldt );
+            ctau = MAGMA_Z_CONJ( t );
+            lapackf77_zlarf( "L", &ns, &nw, &spike[0], &ione, &ctau, T, &ldt, &work[0] );
+            lapackf77_zlarf( "R", &ns, &ns, &spike[0], &ione, &t,    T, &ldt, &work[0] );
+            lapackf77_zlarf( "R", &nw, &ns, &spike[0], &ione, &t,    V, &ldv, &work[0] );
+            lapackf77_zgehrd( &nw, &ione, &ns, T, &ldt, &tau[0], &work[0], &lwork, &info );
+        }
+
+        // copy the window back to H
+        if (kwtop > ktop) {
+            *H(kwtop, kwtop-1) = s * MAGMA_Z_CONJ( *V(0,0) );
+        }
+        lapackf77_zlacpy( "U", &nw, &nw, T, &ldt, H(kwtop, kwtop), &d->ldh );
+        for (magma_int_t j = 0; j < nw - 1; ++j) {
+            *H(kwtop+j+1, kwtop+j) = *T(j+1, j);
+        }
+
+        if (ns > 1 && ! MAGMA_Z_EQUAL( s, c_zero )) {
+            lapackf77_zunmhr( "R", "N", &nw, &ns, &ione, &ns, T, &ldt, &tau[0],
+                              V, &ldv, &work[0], &lwork, &info );
+        }
+
+        zhseqr_push_window_update( d, ktop, kbot, kwtop, nw, V, ldv );
+        d->queue->sync();
+    }
+
+    *ns_out = ns;
+    *nd_out = nw - ns;
+}
+
+
+/******************************************************************************/
+// Recommended number of shifts ns and deflation window size nw for an
+// active block of size nh, following LAPACK's iparmq.
+static void zhseqr_params( magma_int_t nh, magma_int_t *ns, magma_int_t *nw )
+{
+    magma_int_t s;
+    if      (nh <   30) { s = 2;  }
+    else if (nh <   60) { s = 4;  }
+    else if (nh <  150) { s = 10; }
+    else if (nh <  590) { s = max( 10, nh / magma_int_t( log( double(nh) ) / log( 2. ) + 0.5 )); }
+    else if (nh < 3000) { s = 64; }
+    else if (nh < 6000) { s = 128; }
+    else                { s = 256; }
+    s = max( 2, s - s % 2 );
+    *ns = s;
+    *nw = (nh <= 500 ? s : 3*s/2);
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZHSEQR_MT computes the eigenvalues of a Hessenberg matrix H
+    and, optionally, the matrices T and Z from the Schur decomposition
+    H = Z T Z**H, where T is an upper triangular matrix (the
+    Schur form), and Z is the unitary matrix of Schur vectors.
+
+    Optionally Z may be postmultiplied into an input unitary
+    matrix Q so that this routine can give the Schur factorization
+    of a matrix A which has been reduced to the Hessenberg form H
+    by the unitary matrix Q:  A = Q*H*Q**H = (QZ)*T*(QZ)**H.
+
+    This is a drop-in replacement for LAPACK's zhseqr, using a small-bulge
+    multishift QR algorithm with aggressive early deflation.
+    The bulges are chased as a chain, in windows; the updates off the
+    window are done by zgemm tasks on a multi-threaded queue, overlapped
+    with chasing the next window. Blocks smaller than 75 use zlahqr.
+
+    Arguments
+    ---------
+    @param[in]
+    jobt    magma_vec_t
+      -     = MagmaNoVec: compute eigenvalues only;
+      -     = MagmaVec:   compute eigenvalues and the Schur form T.
+
+    @param[in]
+    compz   magma_vec_t
+      -     = MagmaNoVec: no Schur vectors are computed;
+      -     = MagmaIVec:  Z is initialized to the unit matrix and the matrix
+                          Z of Schur vectors of H is returned;
+      -     = MagmaVec:   Z must contain a unitary matrix Q on entry, and
+                          the product Q*Z is returned.
+
+    @param[in]
+    n       INTEGER
+            The order of the matrix H.  N >= 0.
+
+    @param[in]
+    ilo     INTEGER
+    @param[in]
+    ihi     INTEGER
+            It is assumed that H is already upper triangular in rows
+            and columns 1:ILO-1 and IHI+1:N, as returned by zgebal.
+            1 <= ILO <= IHI <= N, if N > 0; ILO=1 and IHI=0, if N=0.
+
+    @param[in,out]
+    H       COMPLEX_16 array, dimension (LDH,N)
+            On entry, the upper Hessenberg matrix H.
+            On exit, if INFO = 0 and JOBT = MagmaVec, then H contains the
+            upper triangular matrix T from the Schur decomposition.
+            If JOBT = MagmaNoVec, the contents of H are unspecified on exit.
+
+    @param[in]
+    ldh     INTEGER
+            The leading dimension of the array H. LDH >= max(1,N).
+
+    @param[out]
+    w       COMPLEX_16 array, dimension (N)
+            The computed eigenvalues. If JOBT = MagmaVec, the eigenvalues
+            are stored in the same order as on the diagonal of T.
+
+    @param[in,out]
+    Z       COMPLEX_16 array, dimension (LDZ,N)
+            If COMPZ = MagmaNoVec, Z is not referenced.
+            Otherwise, on exit, if INFO = 0, Z contains Q*Z, where Q is
+            the input matrix (the identity for COMPZ = MagmaIVec).
+
+    @param[in]
+    ldz     INTEGER
+            The leading dimension of the array Z. LDZ >= 1, and if
+            COMPZ != MagmaNoVec, LDZ >= max(1,N).
+
+    @param[out]
+    work    (workspace) COMPLEX_16 array, dimension (MAX(1,LWORK))
+            On exit, if INFO = 0, WORK[0] returns the optimal LWORK.
+            Window and task buffers are allocated internally.
+
+    @param[in]
+    lwork   INTEGER
+            The dimension of the array WORK.  LWORK >= max(1,N).
+            If LWORK = -1, a workspace query is assumed.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+      -     > 0:  if INFO = i, the QR algorithm failed to compute all the
+                  eigenvalues; elements 1:ilo-1 and i+1:n of W contain
+                  those eigenvalues which have been successfully computed.
+
+    @ingroup magma_geev_comp
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zhseqr_mt(
+    magma_vec_t jobt, magma_vec_t compz,
+    magma_int_t n, magma_int_t ilo, magma_int_t ihi,
+    magmaDoubleComplex *H, magma_int_t ldh,
+    magmaDoubleComplex *w,
+    magmaDoubleComplex *Z, magma_int_t ldz,
+    magmaDoubleComplex *work, magma_int_t lwork,
+    magma_int_t *info )
+{
+    const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    const magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    const magma_int_t ione   = 1;
+    const magma_int_t nmin   = 75;  // smaller blocks use zlahqr
+    const magma_int_t nibble = 14;  // % deflated to skip a sweep
+    const magma_int_t kexnw  = 5;   // grow window after this many non-deflating its
+    const magma_int_t kexsh  = 6;   // exceptional shifts after this many
+
+    bool wantt = (jobt == MagmaVec);
+    bool initz = (compz == MagmaIVec);
+    bool wantz = (compz == MagmaVec || initz);
+    bool lquery = (lwork == -1);
+
+    *info = 0;
+    if (jobt != MagmaNoVec && jobt != MagmaVec) {
+        *info = -1;
+    } else if (compz != MagmaNoVec && ! wantz) {
+        *info = -2;
+    } else if (n < 0) {
+        *info = -3;
+    } else if (ilo < 1 || ilo > max( 1, n )) {
+        *info = -4;
+    } else if (ihi < min( ilo, n ) || ihi > n) {
+        *info = -5;
+    } else if (ldh < max( 1, n )) {
+        *info = -7;
+    } else if (ldz < 1 || (wantz && ldz < max( 1, n ))) {
+        *info = -10;
+    } else if (lwork < max( 1, n ) && ! lquery) {
+        *info = -12;
+    }
+
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    work[0] = magma_zmake_lwork( max( 1, n ));
+    if (lquery || n == 0) {
+        return *info;
+    }
+
+    // eigenvalues isolated by zgebal
+    for (magma_int_t i = 0; i < ilo - 1; ++i) {
+        w[i] = H[ i + i*ldh ];
+    }
+    for (magma_int_t i = ihi; i < n; ++i) {
+        w[i] = H[ i + i*ldh ];
+    }
+    if (initz) {
+        lapackf77_zlaset( "F", &n, &n, &c_zero, &c_one, Z, &ldz );
+    }
+    if (ilo == ihi) {
+        w[ilo-1] = H[ (ilo-1) + (ilo-1)*ldh ];
+        return *info;
+    }
+
+    magma_int_t wantt_ = wantt, wantz_ = wantz;
+    magma_int_t nh = ihi - ilo + 1;
+    if (nh < nmin) {
+        lapackf77_zlahqr( &wantt_, &wantz_, &n, &ilo, &ihi, H, &ldh, w,
+                          &ilo, &ihi, Z, &ldz, info );
+    }
+    else {
+        zhseqr_data data;
+        zhseqr_data *d = &data;
+        d->wantt  = wantt;
+        d->wantz  = wantz;
+        d->n      = n;
+        d->H      = H;
+        d->ldh    = ldh;
+        d->Z      = Z;
+        d->ldz    = ldz;
+        d->iloz   = ilo - 1;
+        d->ihiz   = ihi - 1;
+        d->ulp    = lapackf77_dlamch( "P" );
+        d->smlnum = lapackf77_dlamch( "S" ) * (nh / d->ulp);
+        d->pending = 0;
+
+        // launch threads -- each single-threaded MKL
+        magma_int_t nthread = magma_get_parallel_numthreads();
+        magma_int_t lapack_nthread = magma_get_lapack_numthreads();
+        magma_set_lapack_numthreads( 1 );
+        magma_thread_queue queue;
+        queue.launch( nthread );
+        d->queue   = &queue;
+        d->nthread = nthread;
+
+        magma_int_t nsr, nwr;
+        zhseqr_params( nh, &nsr, &nwr );
+        magma_int_t nwmax = min( nh, 2*nwr );
+        std::vector< magmaDoubleComplex > sh( max( nwmax, nsr ));
+
+        magma_int_t kbot  = ihi - 1;
+        magma_int_t itmax = 30 * max( 10, nh );
+        magma_int_t ndfl  = 1;
+        magma_int_t nw    = nwr;
+        magma_int_t it;
+        for (it = 0; it < itmax; ++it) {
+            if (kbot < ilo - 1) {
+                break;
+            }
+
+            // locate the active block [ktop, kbot], zeroing a negligible
+            // subdiagonal entry, with the Ahues & Tisseur test as in zlahqr
+            magma_int_t ktop;
+            for (ktop = kbot; ktop > ilo - 1; --ktop) {
+                magmaDoubleComplex *hk = H(ktop, ktop-1);
+                double h10 = MAGMA_Z_ABS1( *hk );
+                if (h10 <= d->smlnum) {
+                    *hk = c_zero;
+                    break;
+                }
+                double tst = MAGMA_Z_ABS1( *H(ktop-1, ktop-1) ) + MAGMA_Z_ABS1( *H(ktop, ktop) );
+                if (h10 <= d->ulp * tst) {
+                    double h01 = MAGMA_Z_ABS1( *H(ktop-1, ktop) );
+                    double ab  = max( h10, h01 );
+                    double ba  = min( h10, h01 );
+                    double hd  = MAGMA_Z_ABS1( *H(ktop-1, ktop-1) - *H(ktop, ktop) );
+                    double aa  = max( MAGMA_Z_ABS1( *H(ktop, ktop) ), hd );
+                    double bb  = min( MAGMA_Z_ABS1( *H(ktop, ktop) ), hd );
+                    double s   = aa + ab;
+                    if (ba*(ab/s) <= max( d->smlnum, d->ulp*(bb*(aa/s)) )) {
+                        *hk = c_zero;
+                        break;
+                    }
+                }
+            }
+
+            magma_int_t nh_act = kbot - ktop + 1;
+            if (nh_act < nmin) {
+                // small block: finish it with zlahqr
+                magma_int_t ktop1 = ktop + 1, kbot1 = kbot + 1, iinfo = 0;
+                magma_int_t iloz1 = ilo, ihiz1 = ihi;
+                lapackf77_zlahqr( &wantt_, &wantz_, &n, &ktop1, &kbot1, H, &ldh, w,
+                                  &iloz1, &ihiz1, Z, &ldz, &iinfo );
+                if (iinfo > 0) {
+                    *info = iinfo;
+                    break;
+                }
+                kbot = ktop - 1;
+                ndfl = 1;
+                continue;
+            }
+
+            // aggressive early deflation, with a window that grows if
+            // deflation stalls
+            magma_int_t nwupbd = min( nh_act, nwmax );
+            if (ndfl < kexnw) {
+                nw = min( nwupbd, nwr );
+            }
+            else {
+                nw = min( nwupbd, 2*nw );
+            }
+            magma_int_t ns_aed, nd;
+            zhseqr_aed( d, ktop, kbot, nw, w, &sh[0], &ns_aed, &nd );
+            kbot -= nd;
+
+            // skip the sweep if AED deflated enough to repeat it
+            if (nd == 0 || (nd*100 <= nw*nibble && kbot - ktop + 1 > nmin)) {
+                magma_int_t ns = min( nsr, max( 2, kbot - ktop ));
+                ns -= ns % 2;
+                magmaDoubleComplex *shifts;
+                if (ndfl % kexsh == 0) {
+                    // exceptional shifts
+                    shifts = &sh[0];
+                    for (magma_int_t j = 0; j < ns; j += 2) {
+                        magma_int_t i = kbot - j;
+                        double ss = MAGMA_Z_ABS1( *H(i, i-1) );
+                        if (i - 2 >= ktop) {
+                            ss += MAGMA_Z_ABS1( *H(i-1, i-2) );
+                        }
+                        shifts[j]   = *H(i,i) + MAGMA_Z_MAKE( 0.75*ss, 0 );
+                        shifts[j+1] = shifts[j];
+                    }
+                }
+                else if (ns_aed <= ns/2) {
+                    // too few shifts from AED: use the eigenvalues of the
+                    // trailing ns-by-ns submatrix
+                    magma_int_t ks = kbot - ns + 1, iinfo, izero = 0;
+                    std::vector< magmaDoubleComplex > Hs( ns*ns );
+                    lapackf77_zlacpy( "F", &ns, &ns, H(ks, ks), &ldh, &Hs[0], &ns );
+                    lapackf77_zlahqr( &izero, &izero, &ns, &ione, &ns, &Hs[0], &ns, &sh[0],
+                                      &ione, &ns, NULL, &ione, &iinfo );
+                    shifts = &sh[iinfo];  // converged ones
+                    ns = ns - iinfo;
+                    ns -= ns % 2;
+                    if (ns < 2) {
+                        shifts = &sh[0];
+                        ns = 2;
+                        shifts[0] = shifts[1] = *H(kbot, kbot);
+                    }
+                }
+                else {
+                    // the last undeflated eigenvalues of the window
+                    ns = min( ns, ns_aed - ns_aed % 2 );
+                    shifts = &sh[ ns_aed - ns ];
+                }
+                zhseqr_sweep( d, ktop, kbot, ns, shifts );
+            }
+
+            if (nd > 0) {
+                ndfl = 1;
+            }
+            else {
+                ndfl += 1;
+            }
+        }
+        if (it == itmax && kbot >= ilo - 1) {
+            *info = kbot + 1;
+        }
+
+        queue.quit();
+        magma_set_lapack_numthreads( lapack_nthread );
+    }
+
+    // clean up below the subdiagonal, as zhseqr does
+    if (wantt && *info == 0 && n > 2) {
+        magma_int_t n2 = n - 2;
+        lapackf77_zlaset( "L", &n2, &n2, &c_zero, &c_zero, &H[2], &ldh );
+    }
+
+    return *info;
+}
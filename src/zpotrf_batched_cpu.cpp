@@ -0,0 +1,271 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "magma_internal.h"
+#include "batched_cpu.hpp"
+
+#define COMPLEX
+
+#ifdef COMPLEX
+#define NCOMP 2
+#else
+#define NCOMP 1
+#endif
+
+// element (i,j) of the interleaved group; real plane, imaginary plane at +L
+#define A(i_, j_)  (A + ((j_)*N + (i_))*NCOMP*L)
+
+
+/***************************************************************************//**
+    Unblocked right-looking Cholesky factorization A = L L^H of one
+    interleaved group of N-by-N matrices (see batched_cpu.hpp), referencing
+    only the lower triangle.
+
+    Each lane carries a "live" mask. When a lane meets a non-positive (or NaN)
+    diagonal, its info is set and all its later writes are masked off, so that
+    lane ends up exactly as LAPACK zpotf2 leaves it: columns 1:info-1 factored,
+    A(info,info) holding the offending diagonal, the rest unchanged.
+*******************************************************************************/
+template< magma_int_t N >
+static void
+zpotrf_interleaved( double *A, magma_int_t *info )
+{
+    const magma_int_t L = magma_batched_cpu_lanes< double >();
+    bool   live[ L ];
+    double inv[ L ];
+    // scaled column k; zero for lanes that are no longer live
+    double col[ N*NCOMP*L ];
+
+    for (magma_int_t l = 0; l < L; ++l) {
+        info[l] = 0;
+        live[l] = true;
+    }
+
+    for (magma_int_t k = 0; k < N; ++k) {
+        double *akk = A(k,k);
+        #pragma omp simd
+        for (magma_int_t l = 0; l < L; ++l) {
+            double d = akk[l];
+            bool fail = live[l] && ! (d > 0);  // catches NaN
+            info[l] = fail ? k+1 : info[l];
+            live[l] = live[l] && ! fail;
+            double s = sqrt( live[l] ? d : 1 );
+            akk[l] = live[l] ? s : d;
+            #ifdef COMPLEX
+            akk[L+l] = (live[l] || fail) ? 0 : akk[L+l];
+            #endif
+            inv[l] = 1 / s;
+        }
+
+        for (magma_int_t i = k+1; i < N; ++i) {
+            double *a = A(i,k);
+            double *c = col + i*NCOMP*L;
+            #pragma omp simd
+            for (magma_int_t l = 0; l < L; ++l) {
+                c[l] = live[l] ? a[l] * inv[l] : 0;
+                a[l] = live[l] ? c[l] : a[l];
+                #ifdef COMPLEX
+                c[L+l] = live[l] ? a[L+l] * inv[l] : 0;
+                a[L+l] = live[l] ? c[L+l] : a[L+l];
+                #endif
+            }
+        }
+
+        // A(k+1:N, k+1:N) -= col * col^H, lower triangle only
+        for (magma_int_t j = k+1; j < N; ++j) {
+            const double *cj = col + j*NCOMP*L;
+            for (magma_int_t i = j; i < N; ++i) {
+                const double *ci = col + i*NCOMP*L;
+                double *a = A(i,j);
+                #pragma omp simd
+                for (magma_int_t l = 0; l < L; ++l) {
+                    #ifdef COMPLEX
+                    a[l]   -= ci[l]*cj[l]   + ci[L+l]*cj[L+l];
+                    a[L+l] -= ci[L+l]*cj[l] - ci[l]*cj[L+l];
+                    #else
+                    a[l]   -= ci[l]*cj[l];
+                    #endif
+                }
+            }
+        }
+    }
+}
+
+
+/******************************************************************************/
+// factors one group of matrices: pack, factor, unpack.
+// Upper is handled as the lower factorization of A^H.
+template< magma_int_t N >
+static void
+zpotrf_batched_cpu_group(
+    magma_uplo_t uplo,
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    magma_int_t *info_array,
+    magma_int_t count, double *buf )
+{
+    const magma_int_t L = magma_batched_cpu_lanes< double >();
+    double *A = buf;
+    magma_int_t *info = (magma_int_t*) (A + N*N*NCOMP*L);
+    bool upper = (uplo == MagmaUpper);
+
+    magma_batched_cpu_pack< double, NCOMP >(
+        N, (double const* const*) hA_array, lda, count, upper, A );
+
+    zpotrf_interleaved< N >( A, info );
+
+    magma_batched_cpu_unpack< double, NCOMP >(
+        N, A, MagmaLower, count, upper, (double* const*) hA_array, lda );
+    for (magma_int_t l = 0; l < count; ++l) {
+        info_array[l] = info[l];
+    }
+}
+
+
+/******************************************************************************/
+template< magma_int_t N >
+static magma_int_t
+zpotrf_batched_cpu_n(
+    magma_uplo_t uplo,
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    magma_int_t *info_array,
+    magma_int_t batchCount )
+{
+    const magma_int_t L = magma_batched_cpu_lanes< double >();
+    size_t bufsize = N*N*NCOMP*L
+                   + magma_ceildiv( L*sizeof(magma_int_t), sizeof(double) );
+
+    return magma_batched_cpu_run< double >( batchCount, bufsize,
+        [=]( magma_int_t first, magma_int_t count, double *buf )
+        {
+            zpotrf_batched_cpu_group< N >(
+                uplo, hA_array + first, lda, info_array + first, count, buf );
+        });
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZPOTRF_BATCHED_CPU computes the Cholesky factorization of each of a batch
+    of Hermitian positive definite matrices A on the host (CPU). This is the
+    host counterpart of magma_zpotrf_batched.
+
+    The factorization has the form
+        A = U**H * U,  if UPLO = MagmaUpper, or
+        A = L  * L**H, if UPLO = MagmaLower,
+    where U is an upper triangular matrix and L is lower triangular.
+
+    Matrices of size up to 32 are repacked, a group of 8 (double) or
+    16 (single) matrices at a time, into a batch-interleaved layout, and
+    factored by kernels specialized at compile time for each size, so that
+    each SIMD lane factors a different matrix. Groups are distributed over
+    OpenMP threads. Larger matrices are factored by LAPACK, one matrix per
+    thread.
+
+    Arguments
+    ---------
+    @param[in]
+    uplo    magma_uplo_t
+      -     = MagmaUpper:  Upper triangle of A is stored;
+      -     = MagmaLower:  Lower triangle of A is stored.
+
+    @param[in]
+    n       INTEGER
+            The order of each matrix A.  N >= 0.
+
+    @param[in,out]
+    hA_array Array of pointers, dimension (batchCount).
+            Each is a COMPLEX_16 array in CPU memory, dimension (LDA,N).
+            On entry, each pointer is a Hermitian matrix A; only the triangle
+            given by uplo is referenced.
+            On exit, if corresponding entry in info_array = 0,
+            each pointer is the factor U or L from the Cholesky
+            factorization A = U**H*U or A = L*L**H.
+
+    @param[in]
+    lda     INTEGER
+            The leading dimension of each array A.  LDA >= max(1,N).
+
+    @param[out]
+    info_array  Array of INTEGERs in CPU memory, dimension (batchCount), for corresponding matrices.
+      -     = 0:  successful exit
+      -     > 0:  if INFO = i, the leading minor of order i is not
+                  positive definite, and the factorization could not be
+                  completed.
+
+    @param[in]
+    batchCount  INTEGER
+                The number of matrices to operate on.
+
+    @return
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+                  or another error occured, such as memory allocation failed.
+
+    @ingroup magma_potrf_batched
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zpotrf_batched_cpu(
+    magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex **hA_array, magma_int_t lda,
+    magma_int_t *info_array,
+    magma_int_t batchCount )
+{
+    magma_int_t arginfo = 0;
+    if (uplo != MagmaUpper && uplo != MagmaLower)
+        arginfo = -1;
+    else if (n < 0)
+        arginfo = -2;
+    else if (lda < max(1,n))
+        arginfo = -4;
+    else if (batchCount < 0)
+        arginfo = -6;
+
+    if (arginfo != 0) {
+        magma_xerbla( __func__, -(arginfo) );
+        return arginfo;
+    }
+
+    /* Quick return if possible */
+    if (n == 0 || batchCount == 0) {
+        for (magma_int_t s = 0; s < batchCount; ++s) {
+            info_array[s] = 0;
+        }
+        return arginfo;
+    }
+
+    if (n <= MAGMA_BATCHED_CPU_MAX_N) {
+        switch (n) {
+            #define CASE( N_ ) \
+            case N_: return zpotrf_batched_cpu_n< N_ >( uplo, hA_array, lda, info_array, batchCount );
+            CASE( 1) CASE( 2) CASE( 3) CASE( 4) CASE( 5) CASE( 6) CASE( 7) CASE( 8)
+            CASE( 9) CASE(10) CASE(11) CASE(12) CASE(13) CASE(14) CASE(15) CASE(16)
+            CASE(17) CASE(18) CASE(19) CASE(20) CASE(21) CASE(22) CASE(23) CASE(24)
+            CASE(25) CASE(26) CASE(27) CASE(28) CASE(29) CASE(30) CASE(31) CASE(32)
+            #undef CASE
+        }
+    }
+
+    // general case: one LAPACK call per matrix, in parallel over the batch
+    const char* uplo_ = lapack_uplo_const( uplo );
+    #if defined(_OPENMP)
+    magma_int_t nthreads = magma_get_lapack_numthreads();
+    magma_set_lapack_numthreads(1);
+    magma_set_omp_numthreads(nthreads);
+    #pragma omp parallel for schedule(dynamic)
+    #endif
+    for (magma_int_t s = 0; s < batchCount; ++s) {
+        lapackf77_zpotrf( uplo_, &n, hA_array[s], &lda, &info_array[s] );
+    }
+    #if defined(_OPENMP)
+    magma_set_lapack_numthreads(nthreads);
+    #endif
+
+    return arginfo;
+}
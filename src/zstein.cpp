@@ -0,0 +1,458 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include <algorithm>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "magma_internal.h"
+
+#define COMPLEX
+
+// clusters at least this large are solved one at a time, with the
+// reorthogonalization done by all threads
+const magma_int_t magma_zstein_large_cluster = 64;
+
+
+/******************************************************************************/
+// A cluster of eigenvalues j0..j1-1 of block ib, starting at row b1, of
+// order blksiz. Eigenvectors within a cluster are orthogonalized against
+// each other; clusters are independent.
+struct zstein_cluster
+{
+    magma_int_t j0, j1;
+    magma_int_t b1, blksiz;
+    double onenrm;
+};
+
+
+/******************************************************************************/
+// Index of the element of x with the largest absolute value, 0-based.
+static inline magma_int_t zstein_iamax( magma_int_t n, const double *x )
+{
+    magma_int_t imax = 0;
+    for (magma_int_t i = 1; i < n; ++i) {
+        if (fabs( x[i] ) > fabs( x[imax] )) {
+            imax = i;
+        }
+    }
+    return imax;
+}
+
+
+/******************************************************************************/
+// Computes the eigenvectors of one cluster by inverse iteration, as
+// LAPACK's zstein does. xj are the (perturbed) eigenvalues of the cluster.
+// Previous eigenvectors of the cluster are projected out by modified
+// Gram-Schmidt, or with par set, by classical Gram-Schmidt done twice by all
+// threads.
+// work is 5*blksiz + (j1 - j0), iwork is blksiz.
+// Sets fail[j - j0] for eigenvectors that did not converge.
+static void zstein_inverse_iteration(
+    const zstein_cluster& c, const double *d, const double *e, const double *xj,
+    magmaDoubleComplex *Z, magma_int_t ldz,
+    double *work, magma_int_t *iwork, char *fail, bool par )
+{
+    #define Z(i_,j_) (Z + (i_) + (j_)*ldz)
+
+    const magma_int_t maxits = 5;
+    const magma_int_t extra  = 2;
+    const magma_int_t ione   = 1;
+    const magma_int_t itwo   = 2;
+    const magma_int_t ineg_one = -1;
+
+    magma_int_t blksiz = c.blksiz, b1 = c.b1, i, jr, iinfo;
+    double eps    = lapackf77_dlamch( "Precision" );
+    double dtpcrt = sqrt( 0.1 / blksiz );
+    double tol    = 0;
+
+    double *x    = work;
+    double *sub  = x + blksiz;
+    double *sup  = sub + blksiz;
+    double *diag = sup + blksiz;
+    double *fac  = diag + blksiz;
+    double *ztr  = fac + blksiz;
+
+    for (magma_int_t j = c.j0; j < c.j1; ++j) {
+        // start from a random vector; each eigenvalue has its own seed
+        // so the result does not depend on the order clusters are solved
+        magma_int_t iseed[4] = { 0, 0, (j / 2048) % 4096, 2*(j % 2048) + 1 };
+        lapackf77_dlarnv( &itwo, iseed, &blksiz, x );
+
+        // copy the matrix, and factor T - xj I
+        blasf77_dcopy( &blksiz, &d[b1], &ione, diag, &ione );
+        magma_int_t nm1 = blksiz - 1;
+        blasf77_dcopy( &nm1, &e[b1], &ione, sub + 1, &ione );
+        blasf77_dcopy( &nm1, &e[b1], &ione, sup, &ione );
+        lapackf77_dlagtf( &blksiz, diag, &xj[j - c.j0], sub + 1, sup, &tol, fac, iwork, &iinfo );
+
+        magma_int_t its = 0, nrmchk = 0;
+        bool converged = false;
+        while (its < maxits) {
+            ++its;
+
+            // normalize and scale the righthand side vector Pb
+            magma_int_t jmax = zstein_iamax( blksiz, x );
+            double scl = blksiz*c.onenrm*max( eps, fabs( diag[blksiz-1] )) / fabs( x[jmax] );
+            blasf77_dscal( &blksiz, &scl, x, &ione );
+
+            // solve the system LU = Pb
+            lapackf77_dlagts( &ineg_one, &blksiz, diag, sub + 1, sup, fac, iwork, x, &tol, &iinfo );
+
+            // reorthogonalize against the previous eigenvectors of the cluster
+            magma_int_t np = j - c.j0;
+            if (! par) {
+                // modified Gram-Schmidt, as LAPACK
+                for (i = 0; i < np; ++i) {
+                    double s = 0;
+                    #pragma omp simd reduction(+:s)
+                    for (jr = 0; jr < blksiz; ++jr) {
+                        s += x[jr] * MAGMA_Z_REAL( *Z(b1 + jr, c.j0 + i) );
+                    }
+                    for (jr = 0; jr < blksiz; ++jr) {
+                        x[jr] -= s * MAGMA_Z_REAL( *Z(b1 + jr, c.j0 + i) );
+                    }
+                }
+            }
+            else {
+                // classical Gram-Schmidt, twice, with threads over the
+                // previous eigenvectors, then over blocks of rows
+                for (magma_int_t pass = 0; pass < 2 && np > 0; ++pass) {
+                    #pragma omp parallel for schedule(static) private(jr)
+                    for (i = 0; i < np; ++i) {
+                        double s = 0;
+                        #pragma omp simd reduction(+:s)
+                        for (jr = 0; jr < blksiz; ++jr) {
+                            s += x[jr] * MAGMA_Z_REAL( *Z(b1 + jr, c.j0 + i) );
+                        }
+                        ztr[i] = s;
+                    }
+                    #pragma omp parallel for schedule(static) private(i, jr)
+                    for (magma_int_t r0 = 0; r0 < blksiz; r0 += 256) {
+                        magma_int_t r1 = min( r0 + 256, blksiz );
+                        for (i = 0; i < np; ++i) {
+                            for (jr = r0; jr < r1; ++jr) {
+                                x[jr] -= ztr[i] * MAGMA_Z_REAL( *Z(b1 + jr, c.j0 + i) );
+                            }
+                        }
+                    }
+                }
+            }
+
+            // check the infinity norm of the iterate
+            jmax = zstein_iamax( blksiz, x );
+            double nrm = fabs( x[jmax] );
+
+            // continue for additional iterations after norm reaches
+            // stopping criterion
+            if (nrm < dtpcrt) {
+                continue;
+            }
+            ++nrmchk;
+            if (nrmchk < extra + 1) {
+                continue;
+            }
+            converged = true;
+            break;
+        }
+        fail[j - c.j0] = ! converged;
+
+        // normalize, so the largest component is positive, and store
+        double nrm2 = 0;
+        for (jr = 0; jr < blksiz; ++jr) {
+            nrm2 += x[jr]*x[jr];
+        }
+        double scl = 1. / sqrt( nrm2 );
+        magma_int_t jmax = zstein_iamax( blksiz, x );
+        if (x[jmax] < 0) {
+            scl = -scl;
+        }
+        for (jr = 0; jr < blksiz; ++jr) {
+            *Z(b1 + jr, j) = MAGMA_Z_MAKE( scl*x[jr], 0 );
+        }
+    }
+
+    #undef Z
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZSTEIN computes the eigenvectors of a real symmetric tridiagonal
+    matrix T corresponding to specified eigenvalues, using inverse
+    iteration.
+
+    This is a multi-threaded replacement for LAPACK's zstein. As in LAPACK,
+    eigenvectors whose eigenvalues are within 1e-3 * ||T_i|| of each other
+    form a cluster, and are reorthogonalized only against the eigenvectors
+    of their own cluster. Clusters are therefore independent, and are solved
+    concurrently with OpenMP, largest first. Clusters of at least 64
+    eigenvalues are solved one at a time, with the reorthogonalization
+    spread over all threads.
+
+    The maximum number of iterations allowed for each eigenvector is
+    specified by an internal parameter MAXITS (currently set to 5).
+
+    Although the eigenvectors are real, they are stored in a complex
+    array, which may be passed to ZUNMTR or ZUPMTR for back
+    transformation to the eigenvectors of a complex Hermitian matrix
+    which was reduced to tridiagonal form.
+
+    Arguments
+    ---------
+    @param[in]
+    n       INTEGER
+            The order of the matrix.  N >= 0.
+
+    @param[in]
+    d       DOUBLE PRECISION array, dimension (N)
+            The n diagonal elements of the tridiagonal matrix T.
+
+    @param[in]
+    e       DOUBLE PRECISION array, dimension (N-1)
+            The (n-1) subdiagonal elements of the tridiagonal matrix
+            T, stored in elements 1 to N-1.
+
+    @param[in]
+    m       INTEGER
+            The number of eigenvectors to be found.  0 <= M <= N.
+
+    @param[in]
+    w       DOUBLE PRECISION array, dimension (N)
+            The first M elements of W contain the eigenvalues for
+            which eigenvectors are to be computed.  The eigenvalues
+            should be grouped by split-off block and ordered from
+            smallest to largest within the block.  (The output array
+            W from magma_dstebz with BYBLOCK = MagmaTrue is expected here.)
+
+    @param[in]
+    iblock  INTEGER array, dimension (N)
+            The submatrix indices associated with the corresponding
+            eigenvalues in W; IBLOCK(i)=1 if eigenvalue W(i) belongs to
+            the first submatrix from the top, =2 if W(i) belongs to
+            the second submatrix, etc.  (The output array IBLOCK
+            from magma_dstebz is expected here.)
+
+    @param[in]
+    isplit  INTEGER array, dimension (N)
+            The splitting points, at which T breaks up into submatrices.
+            The first submatrix consists of rows/columns 1 to
+            ISPLIT( 1 ), the second of rows/columns ISPLIT( 1 )+1
+            through ISPLIT( 2 ), etc.
+            (The output array ISPLIT from magma_dstebz is expected here.)
+
+    @param[out]
+    Z       COMPLEX_16 array, dimension (LDZ, M)
+            The computed eigenvectors.  The eigenvector associated
+            with the eigenvalue W(i) is stored in the i-th column of
+            Z.  Any vector which fails to converge is set to its current
+            iterate after MAXITS iterations.
+            The imaginary parts of the eigenvectors are set to zero.
+
+    @param[in]
+    ldz     INTEGER
+            The leading dimension of the array Z.  LDZ >= max(1,N).
+
+    @param
+    work    (workspace) DOUBLE PRECISION array, dimension (5*N)
+            Not referenced; each thread allocates its own workspace.
+
+    @param
+    iwork   (workspace) INTEGER array, dimension (N)
+            Not referenced; each thread allocates its own workspace.
+
+    @param[out]
+    ifail   INTEGER array, dimension (M)
+            On normal exit, all elements of IFAIL are zero.
+            If one or more eigenvectors fail to converge after
+            MAXITS iterations, then their indices are stored in
+            array IFAIL.
+
+    @param[out]
+    info    INTEGER
+      -     = 0: successful exit
+      -     < 0: if INFO = -i, the i-th argument had an illegal value
+      -     > 0: if INFO = i, then i eigenvectors failed to converge
+                 in MAXITS iterations.  Their indices are stored in
+                 array IFAIL.
+
+    @ingroup magma_heev_comp
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zstein(
+    magma_int_t n, const double *d, const double *e,
+    magma_int_t m, const double *w,
+    const magma_int_t *iblock, const magma_int_t *isplit,
+    magmaDoubleComplex *Z, magma_int_t ldz,
+    double *work, magma_int_t *iwork,
+    magma_int_t *ifail,
+    magma_int_t *info )
+{
+    #define Z(i_,j_) (Z + (i_) + (j_)*ldz)
+
+    const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    const magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+
+    magma_int_t i, j;
+
+    *info = 0;
+    for (i = 0; i < m; ++i) {
+        ifail[i] = 0;
+    }
+
+    if (n < 0) {
+        *info = -1;
+    } else if (m < 0 || m > n) {
+        *info = -4;
+    } else if (ldz < max( 1, n )) {
+        *info = -9;
+    } else {
+        for (j = 1; j < m; ++j) {
+            if (iblock[j] < iblock[j-1]) {
+                *info = -6;
+                break;
+            }
+            if (iblock[j] == iblock[j-1] && w[j] < w[j-1]) {
+                *info = -5;
+                break;
+            }
+        }
+    }
+
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    // Quick return if possible
+    if (n == 0 || m == 0) {
+        return *info;
+    }
+    else if (n == 1) {
+        *Z(0,0) = c_one;
+        return *info;
+    }
+
+    double eps = lapackf77_dlamch( "Precision" );
+
+    // find the clusters, with the eigenvalues perturbed as in LAPACK
+    std::vector< zstein_cluster > clusters;
+    std::vector< double > xj( m );
+    magma_int_t j1 = 0, maxblk = 0;
+    while (j1 < m) {
+        magma_int_t nblk   = iblock[j1];
+        magma_int_t b1     = (nblk == 1 ? 0 : isplit[nblk-2]);
+        magma_int_t bn     = isplit[nblk-1] - 1;
+        magma_int_t blksiz = bn - b1 + 1;
+        maxblk = max( maxblk, blksiz );
+
+        // compute reorthogonalization criterion
+        double onenrm = 0, ortol = 0;
+        if (blksiz > 1) {
+            onenrm = max( fabs( d[b1] ) + fabs( e[b1] ),
+                          fabs( d[bn] ) + fabs( e[bn-1] ));
+            for (i = b1 + 1; i < bn; ++i) {
+                onenrm = max( onenrm, fabs( d[i] ) + fabs( e[i-1] ) + fabs( e[i] ));
+            }
+            ortol = 1e-3*onenrm;
+        }
+
+        magma_int_t gpind = j1;
+        for (j = j1; j < m && iblock[j] == nblk; ++j) {
+            xj[j] = w[j];
+            if (j > j1) {
+                // if eigenvalues j and j-1 are too close, add a perturbation
+                double pertol = 10*fabs( eps*xj[j] );
+                if (xj[j] - xj[j-1] < pertol) {
+                    xj[j] = xj[j-1] + pertol;
+                }
+                if (fabs( xj[j] - xj[j-1] ) > ortol) {
+                    clusters.push_back( zstein_cluster{ gpind, j, b1, blksiz, onenrm } );
+                    gpind = j;
+                }
+            }
+        }
+        clusters.push_back( zstein_cluster{ gpind, j, b1, blksiz, onenrm } );
+
+        // zero out the eigenvectors outside the block
+        #pragma omp parallel for schedule(static)
+        for (magma_int_t jj = j1; jj < j; ++jj) {
+            for (i = 0; i < b1; ++i) {
+                *Z(i,jj) = c_zero;
+            }
+            for (i = bn + 1; i < n; ++i) {
+                *Z(i,jj) = c_zero;
+            }
+        }
+        j1 = j;
+    }
+
+    // large clusters first, then the others, largest first for load balance
+    auto is_large = []( const zstein_cluster& c ) {
+        return c.j1 - c.j0 >= magma_zstein_large_cluster;
+    };
+    std::stable_sort( clusters.begin(), clusters.end(),
+                      [is_large]( const zstein_cluster& a, const zstein_cluster& b ) {
+                          if (is_large( a ) != is_large( b )) {
+                              return is_large( a );
+                          }
+                          return (a.j1 - a.j0)*a.blksiz > (b.j1 - b.j0)*b.blksiz;
+                      } );
+    magma_int_t nclusters = clusters.size();
+    magma_int_t nlarge = std::count_if( clusters.begin(), clusters.end(), is_large );
+
+    std::vector< char > fail( m, 0 );
+    magma_int_t nthread = magma_get_parallel_numthreads();
+
+    // large clusters one at a time, with parallel reorthogonalization
+    for (magma_int_t k = 0; k < nlarge; ++k) {
+        const zstein_cluster& c = clusters[k];
+        if (c.blksiz == 1) {
+            *Z(c.b1, c.j0) = c_one;
+            continue;
+        }
+        std::vector< double > cwork( 5*c.blksiz + (c.j1 - c.j0) );
+        std::vector< magma_int_t > ciwork( c.blksiz );
+        zstein_inverse_iteration( c, d, e, &xj[c.j0], Z, ldz,
+                                  &cwork[0], &ciwork[0], &fail[c.j0], nthread > 1 );
+    }
+
+    // other clusters concurrently
+    #pragma omp parallel num_threads(nthread)
+    {
+        std::vector< double > twork( 5*maxblk + magma_zstein_large_cluster );
+        std::vector< magma_int_t > tiwork( maxblk );
+        #pragma omp for schedule(dynamic)
+        for (magma_int_t k = nlarge; k < nclusters; ++k) {
+            const zstein_cluster& c = clusters[k];
+            if (c.blksiz == 1) {
+                *Z(c.b1, c.j0) = c_one;
+                continue;
+            }
+            zstein_inverse_iteration( c, d, e, &xj[c.j0], Z, ldz,
+                                      &twork[0], &tiwork[0], &fail[c.j0], false );
+        }
+    }
+
+    // record the eigenvectors that failed to converge, in order
+    for (j = 0; j < m; ++j) {
+        if (fail[j]) {
+            ifail[*info] = j + 1;
+            *info += 1;
+        }
+    }
+
+    return *info;
+
+    #undef Z
+}
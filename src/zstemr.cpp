@@ -0,0 +1,950 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "thread_queue.hpp"
+
+#include "magma_internal.h"  // after thread_queue.hpp, so max, min are defined
+
+#define COMPLEX
+
+// consecutive singletons of a cluster are computed by one task,
+// to amortize the task overhead over several eigenvectors
+const magma_int_t magma_zstemr_singletons = 16;
+
+
+/******************************************************************************/
+// Data shared by all tasks of one call.
+// Each eigenvector column of Z, isuppz pair, and entry of w and werr is
+// written by exactly one task, so no locking is needed besides info.
+struct zstemr_data
+{
+    magma_int_t n, m;
+    double vl;        // left end of the wanted interval, for the leftmost gap
+    double pivmin;
+    double minrgp;    // relative gap below which eigenvalues form a cluster
+    double rtol1, rtol2;
+    const magma_int_t *indexw;
+    double *w, *werr;
+    magmaDoubleComplex *Z;
+    magma_int_t ldz;
+    magma_int_t *isuppz;
+    std::atomic< magma_int_t > info;
+};
+
+
+/******************************************************************************/
+// Representation L D L^T - sigma of one node of the representation tree, for
+// the block of rows ibegin..ibegin+in-1. ld = D*L and lld = D*L*L are the
+// products dlarrv precomputes.
+struct zstemr_rrr
+{
+    zstemr_rrr( magma_int_t in_, double sigma_ ):
+        in( in_ ), sigma( sigma_ ),
+        D( in_ ), L( in_ ), ld( in_ ), lld( in_ )
+    {}
+
+    void products()
+    {
+        for (magma_int_t i = 0; i < in-1; ++i) {
+            ld[i]  = D[i]*L[i];
+            lld[i] = ld[i]*L[i];
+        }
+    }
+
+    magma_int_t in;
+    double sigma;
+    std::vector< double > D, L, ld, lld;
+};
+
+
+/******************************************************************************/
+// Location of a cluster: eigenvalues fst..lst, relative to the first wanted
+// eigenvalue wbegin of a block of im wanted eigenvalues at rows ibegin...
+struct zstemr_block
+{
+    magma_int_t ibegin, wbegin, im;
+    double spdiam;
+};
+
+
+/******************************************************************************/
+// Computes eigenvectors k0..k1-1 (relative to the block) of the
+// representation rrr, which are all singletons with respect to it, by the
+// Rayleigh quotient iteration of LAPACK's dlarrv.
+// lambda, err, lgap, rgap are the eigenvalue approximations relative to rrr,
+// their errors, and gaps on either side, as they were when the parent
+// cluster was split.
+// Writes each eigenvector straight into its column of Z, and the
+// eigenvalue with all shifts applied into w.
+class zstemr_singleton_task: public magma_task
+{
+public:
+    zstemr_singleton_task(
+        zstemr_data* in_data, const zstemr_block& in_blk,
+        std::shared_ptr< const zstemr_rrr > in_rrr, magma_int_t in_k0
+    ):
+        data( in_data ), blk( in_blk ), rrr( in_rrr ), k0( in_k0 )
+    {}
+
+    size_t size() const { return lambdas.size(); }
+
+    void add( double lambda, double err, double lgap, double rgap )
+    {
+        lambdas.push_back( lambda );
+        errs.push_back( err );
+        lgaps.push_back( lgap );
+        rgaps.push_back( rgap );
+    }
+
+    virtual void run()
+    {
+        if (data->info != 0) {
+            return;
+        }
+        magma_int_t in = rrr->in;
+        std::vector< double > zvec( in ), work( 4*in );
+        std::vector< magma_int_t > iwork( 2*in );
+        for (size_t j = 0; j < lambdas.size(); ++j) {
+            magma_int_t iinfo = singleton( k0 + j, lambdas[j], errs[j], lgaps[j], rgaps[j],
+                                           &zvec[0], &work[0], &iwork[0] );
+            if (iinfo != 0) {
+                magma_int_t zero = 0;
+                data->info.compare_exchange_strong( zero, iinfo );
+                return;
+            }
+        }
+    }
+
+private:
+    magma_int_t singleton(
+        magma_int_t k, double lambda, double err, double lgap, double rgap,
+        double *zvec, double *work, magma_int_t *iwork )
+    {
+        const magma_int_t ione = 1;
+        const magma_int_t maxitr = 10;
+        const double d_zero = 0;
+        const double eps    = lapackf77_dlamch( "Precision" );
+        const double rqtol  = 2*eps;
+        const double bstol  = 2*eps;
+
+        magma_int_t in = rrr->in, im = blk.im;
+        magma_int_t windex = blk.wbegin + k;
+        magma_int_t indeig = data->indexw[ windex ];
+        magma_int_t offset = indeig - 1;
+        magma_int_t iter = 0, negcnt, r = 0, iinfo;
+        magma_int_t isuppz[2];
+        double tol = 4 * log( double( in )) * eps;
+        double left  = lambda - err;
+        double right = lambda + err;
+        double mid   = lambda;  // midpoint of the bracket [left, right]
+        double ztz, mingma, nrminv, resid, rqcorr, bstres = 0, bstw = 0, sgndef;
+
+        // as dlarrv, force small gaps at the ends of the block, since the
+        // gaps to vl, vu can be overestimated
+        if (k == 0) {
+            lgap = eps*max( fabs( left ), fabs( right ));
+        }
+        if (k == im-1) {
+            rgap = eps*max( fabs( left ), fabs( right ));
+        }
+        double gap = min( lgap, rgap );
+        double gaptol = (k == 0 || k == im-1) ? d_zero : gap*eps;
+
+        bool usedbs = false;
+        bool usedrq = false;
+        bool needbs = false;
+        while (true) {
+            if (needbs) {
+                // take the bisection as the new iterate
+                usedbs = true;
+                double wk = mid, werrk = err, wgapk = gap;
+                lapackf77_dlarrb( &in, &rrr->D[0], &rrr->lld[0], &indeig, &indeig,
+                                  &d_zero, &bstol, &offset, &wk, &wgapk, &werrk,
+                                  work, iwork, &data->pivmin, &blk.spdiam, &r, &iinfo );
+                if (iinfo != 0) {
+                    return -3;
+                }
+                lambda = wk;
+                mid = wk;
+                err = werrk;
+                // reset the twist index from the inaccurate lambda
+                r = 0;
+            }
+            magma_int_t wantnc = ! usedbs;
+            lapackf77_dlar1v( &in, &ione, &in, &lambda, &rrr->D[0], &rrr->L[0],
+                              &rrr->ld[0], &rrr->lld[0], &data->pivmin, &gaptol,
+                              zvec, &wantnc, &negcnt, &ztz, &mingma,
+                              &r, isuppz, &nrminv, &resid, &rqcorr, work );
+            if (iter == 0 || resid < bstres) {
+                bstres = resid;
+                bstw = lambda;
+            }
+            iter += 1;
+
+            if (resid > tol*gap && fabs( rqcorr ) > rqtol*fabs( lambda ) && ! usedbs) {
+                // make sure the Rayleigh quotient correction does not move
+                // lambda towards a neighbor; otherwise, bisect
+                sgndef = (indeig <= negcnt ? -1 : 1);
+                if (rqcorr*sgndef >= 0
+                    && lambda + rqcorr <= right
+                    && lambda + rqcorr >= left) {
+                    usedrq = true;
+                    if (sgndef == 1) {
+                        left = lambda;
+                    }
+                    else {
+                        right = lambda;
+                    }
+                    mid = (right + left) / 2;
+                    lambda += rqcorr;
+                    err = (right - left) / 2;
+                }
+                else {
+                    needbs = true;
+                }
+                if (right - left < rqtol*fabs( lambda )) {
+                    // eigenvalue is at bisection accuracy; one more vector
+                    usedbs = true;
+                }
+                else if (iter == maxitr) {
+                    needbs = true;
+                }
+                else if (iter > maxitr) {
+                    return 5;
+                }
+            }
+            else {
+                if (usedrq && usedbs && bstres <= resid) {
+                    // improve the error angle by a second step
+                    lambda = bstw;
+                    lapackf77_dlar1v( &in, &ione, &in, &lambda, &rrr->D[0], &rrr->L[0],
+                                      &rrr->ld[0], &rrr->lld[0], &data->pivmin, &gaptol,
+                                      zvec, &wantnc, &negcnt, &ztz, &mingma,
+                                      &r, isuppz, &nrminv, &resid, &rqcorr, work );
+                }
+                break;
+            }
+        }
+
+        // write the vector into its column, zero outside its support
+        magmaDoubleComplex *z = data->Z + windex*data->ldz;
+        magma_int_t zfrom = isuppz[0] - 1, zto = isuppz[1] - 1;
+        for (magma_int_t i = 0; i < data->n; ++i) {
+            z[i] = MAGMA_Z_ZERO;
+        }
+        for (magma_int_t i = zfrom; i <= zto; ++i) {
+            z[ blk.ibegin + i ] = MAGMA_Z_MAKE( nrminv*zvec[i], 0 );
+        }
+        data->isuppz[ 2*windex   ] = blk.ibegin + zfrom + 1;
+        data->isuppz[ 2*windex+1 ] = blk.ibegin + zto   + 1;
+        data->w[ windex ]    = lambda + rrr->sigma;
+        data->werr[ windex ] = err;
+        return 0;
+    }
+
+    zstemr_data* data;
+    zstemr_block blk;
+    std::shared_ptr< const zstemr_rrr > rrr;
+    magma_int_t k0;
+    std::vector< double > lambdas, errs, lgaps, rgaps;
+};
+
+
+/******************************************************************************/
+// One cluster fst..lst (relative to the block) of the representation tree,
+// with its own representation rrr. Refines the eigenvalues of the cluster
+// with respect to rrr, then splits it into singletons, which are pushed as
+// zstemr_singleton_task, and child clusters, for which a new representation
+// is computed and pushed as another zstemr_cluster_task. Children run
+// concurrently; each works on private copies of its eigenvalue
+// approximations, relative errors, and gaps.
+// lw, lwerr, lwgap, wabs hold work, werr, wgap, w of dlarrv for fst..lst;
+// gapl is the gap left of fst.
+class zstemr_cluster_task: public magma_task
+{
+public:
+    zstemr_cluster_task(
+        magma_thread_queue* in_queue, zstemr_data* in_data,
+        const zstemr_block& in_blk, std::shared_ptr< zstemr_rrr > in_rrr,
+        magma_int_t in_fst, magma_int_t in_lst, magma_int_t in_depth, double in_gapl
+    ):
+        queue( in_queue ), data( in_data ), blk( in_blk ), rrr( in_rrr ),
+        fst( in_fst ), lst( in_lst ), depth( in_depth ), gapl( in_gapl ),
+        lw( in_lst - in_fst + 1 ), lwerr( in_lst - in_fst + 1 ),
+        lwgap( in_lst - in_fst + 1 ), wabs( in_lst - in_fst + 1 )
+    {}
+
+    virtual void run()
+    {
+        if (data->info != 0) {
+            return;
+        }
+        magma_int_t iinfo = split();
+        if (iinfo != 0) {
+            magma_int_t zero = 0;
+            data->info.compare_exchange_strong( zero, iinfo );
+        }
+    }
+
+private:
+    magma_int_t split()
+    {
+        #define lw(k_)    lw   [ (k_) - fst ]
+        #define lwerr(k_) lwerr[ (k_) - fst ]
+        #define lwgap(k_) lwgap[ (k_) - fst ]
+        #define wabs(k_)  wabs [ (k_) - fst ]
+
+        const double eps   = lapackf77_dlamch( "Precision" );
+        const double rqtol = 2*eps;
+
+        magma_int_t in = rrr->in, iinfo;
+        std::vector< double > work( 2*in );
+        std::vector< magma_int_t > iwork( 2*in );
+        std::vector< double > dplus( in ), lplus( in );
+        rrr->products();
+
+        // offset of the eigenvalue indices within lw, lwerr, lwgap
+        magma_int_t offset = data->indexw[ blk.wbegin + fst ] - 1;
+
+        if (depth > 0) {
+            // refine the eigenvalues of the cluster w.r.t. its new representation.
+            // dlarrv also enlarges the gaps to the neighbors of the cluster
+            // here; those belong to other tasks, and only get larger, so
+            // keeping the smaller gaps is safe.
+            magma_int_t p = data->indexw[ blk.wbegin + fst ];
+            magma_int_t q = data->indexw[ blk.wbegin + lst ];
+            lapackf77_dlarrb( &in, &rrr->D[0], &rrr->lld[0], &p, &q,
+                              &data->rtol1, &data->rtol2, &offset,
+                              &lw(fst), &lwgap(fst), &lwerr(fst),
+                              &work[0], &iwork[0], &data->pivmin, &blk.spdiam,
+                              &in, &iinfo );
+            if (iinfo != 0) {
+                return -1;
+            }
+            for (magma_int_t j = fst; j <= lst; ++j) {
+                wabs(j) = lw(j) + rrr->sigma;
+            }
+        }
+
+        zstemr_singleton_task* singles = NULL;
+        magma_int_t newfst = fst;
+        for (magma_int_t j = fst; j <= lst; ++j) {
+            if (j < lst && lwgap(j) < data->minrgp*fabs( lw(j) )) {
+                continue;
+            }
+            magma_int_t newlst = j;
+            if (newlst > newfst) {
+                // child cluster newfst..newlst
+                if (singles != NULL) {
+                    queue->push_task( singles );
+                    singles = NULL;
+                }
+                double lgap;
+                if (newfst == 0) {
+                    lgap = max( 0., wabs(0) - lwerr(0) - data->vl );
+                }
+                else if (newfst > fst) {
+                    lgap = lwgap(newfst - 1);
+                }
+                else {
+                    lgap = gapl;
+                }
+                double rgap = lwgap(newlst);
+
+                // compute the outer eigenvalues of the child to full
+                // accuracy, to shift as close as possible
+                magma_int_t ends[2] = { newfst, newlst };
+                for (int k = 0; k < 2; ++k) {
+                    magma_int_t p = data->indexw[ blk.wbegin + ends[k] ];
+                    lapackf77_dlarrb( &in, &rrr->D[0], &rrr->lld[0], &p, &p,
+                                      &rqtol, &rqtol, &offset,
+                                      &lw(fst), &lwgap(fst), &lwerr(fst),
+                                      &work[0], &iwork[0], &data->pivmin, &blk.spdiam,
+                                      &in, &iinfo );
+                }
+
+                // new representation of the child
+                double tau;
+                magma_int_t clstrt = newfst - fst + 1;
+                magma_int_t clend  = newlst - fst + 1;
+                lapackf77_dlarrf( &in, &rrr->D[0], &rrr->L[0], &rrr->ld[0],
+                                  &clstrt, &clend, &lw(fst), &lwgap(fst), &lwerr(fst),
+                                  &blk.spdiam, &lgap, &rgap, &data->pivmin, &tau,
+                                  &dplus[0], &lplus[0], &work[0], &iinfo );
+                if (iinfo != 0) {
+                    return -2;
+                }
+                std::shared_ptr< zstemr_rrr > child_rrr(
+                    new zstemr_rrr( in, rrr->sigma + tau ));
+                std::copy( dplus.begin(), dplus.end(), child_rrr->D.begin() );
+                std::copy( lplus.begin(), lplus.end(), child_rrr->L.begin() );
+
+                zstemr_cluster_task* child = new zstemr_cluster_task(
+                    queue, data, blk, child_rrr, newfst, newlst, depth+1,
+                    (newfst > fst ? lwgap(newfst - 1) : gapl) );
+                for (magma_int_t k = newfst; k <= newlst; ++k) {
+                    // shift, and fudge the errors; gaps are not fudged
+                    double fudge = 3*eps*fabs( lw(k) );
+                    child->lw   [ k - newfst ] = lw(k) - tau;
+                    fudge += 4*eps*fabs( child->lw[ k - newfst ] );
+                    child->lwerr[ k - newfst ] = lwerr(k) + fudge;
+                    child->lwgap[ k - newfst ] = lwgap(k);
+                    child->wabs [ k - newfst ] = wabs(k);
+                }
+                queue->push_task( child );
+            }
+            else {
+                // singleton newfst
+                if (singles == NULL) {
+                    singles = new zstemr_singleton_task( data, blk, rrr, newfst );
+                }
+                double lgap = (newfst > fst ? lwgap(newfst - 1) : gapl);
+                singles->add( lw(newfst), lwerr(newfst), lgap, lwgap(newfst) );
+                if (singles->size() == size_t( magma_zstemr_singletons )) {
+                    queue->push_task( singles );
+                    singles = NULL;
+                }
+            }
+            newfst = j + 1;
+        }
+        if (singles != NULL) {
+            queue->push_task( singles );
+        }
+        return 0;
+
+        #undef lw
+        #undef lwerr
+        #undef lwgap
+        #undef wabs
+    }
+
+    magma_thread_queue* queue;
+    zstemr_data* data;
+    zstemr_block blk;
+    std::shared_ptr< zstemr_rrr > rrr;
+    magma_int_t fst, lst, depth;
+    double gapl;
+
+public:
+    std::vector< double > lw, lwerr, lwgap, wabs;
+};
+
+
+/******************************************************************************/
+// Refines eigenvalues w0..w1-1 of the block at rows ibegin..ibegin+in-1 by
+// bisection on the original matrix, as zstemr does with tryrac set.
+class zstemr_refine_task: public magma_task
+{
+public:
+    zstemr_refine_task(
+        magma_int_t in_in, const double *in_d, const double *in_e2,
+        const magma_int_t *in_indexw, double *in_w, double *in_werr,
+        magma_int_t in_w0, magma_int_t in_w1,
+        double in_pivmin, double in_spdiam
+    ):
+        in( in_in ), d( in_d ), e2( in_e2 ), indexw( in_indexw ),
+        w( in_w ), werr( in_werr ), w0( in_w0 ), w1( in_w1 ),
+        pivmin( in_pivmin ), spdiam( in_spdiam )
+    {}
+
+    virtual void run()
+    {
+        const double rtol = 2*lapackf77_dlamch( "Precision" );
+        std::vector< double > work( 2*in );
+        std::vector< magma_int_t > iwork( 2*in );
+        magma_int_t ifirst = indexw[ w0 ];
+        magma_int_t ilast  = indexw[ w1-1 ];
+        magma_int_t offset = ifirst - 1;
+        magma_int_t iinfo;
+        lapackf77_dlarrj( &in, d, e2, &ifirst, &ilast, &rtol, &offset,
+                          &w[ w0 ], &werr[ w0 ], &work[0], &iwork[0],
+                          &pivmin, &spdiam, &iinfo );
+    }
+
+private:
+    magma_int_t in;
+    const double *d, *e2;
+    const magma_int_t *indexw;
+    double *w, *werr;
+    magma_int_t w0, w1;
+    double pivmin, spdiam;
+};
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    ZSTEMR computes selected eigenvalues and, optionally, eigenvectors
+    of a real symmetric tridiagonal matrix T. Any such unreduced matrix has
+    a well defined set of pairwise different real eigenvalues, the
+    corresponding real eigenvectors are pairwise orthogonal.
+
+    The spectrum may be computed either completely or partially by
+    specifying either an interval (VL,VU] or a range of indices IL:IU
+    for the desired eigenvalues.
+
+    This is the algorithm of Multiple Relatively Robust Representations
+    (MRRR) of LAPACK's zstemr. The root representation of each block
+    and its eigenvalue approximations are computed once, by dlarre.
+    The representation tree is then traversed in parallel: each cluster
+    of eigenvalues is a task on the CPU thread pool, which refines its
+    eigenvalues, computes the representations of its child clusters and
+    pushes them as new tasks, and hands its singletons to tasks that
+    compute the eigenvectors by Rayleigh quotient iteration and write them
+    directly into their columns of Z. Unlike the serial dlarrv, the gaps
+    between neighboring clusters are not enlarged as the clusters get
+    refined; the smaller gaps are still valid bounds.
+
+    The eigenvalue-only path, workspace queries, and N <= 2 are passed
+    on to LAPACK's zstemr.
+
+    Although the eigenvectors are real, they are stored in a complex
+    array, which may be passed to ZUNMTR or ZUPMTR for back
+    transformation to the eigenvectors of a complex Hermitian matrix
+    which was reduced to tridiagonal form.
+
+    Arguments
+    ---------
+    @param[in]
+    jobz    magma_vec_t
+      -     = MagmaNoVec:  Compute eigenvalues only;
+      -     = MagmaVec:    Compute eigenvalues and eigenvectors.
+
+    @param[in]
+    range   magma_range_t
+      -     = MagmaRangeAll: all eigenvalues will be found.
+      -     = MagmaRangeV:   all eigenvalues in the half-open interval (VL,VU]
+                             will be found.
+      -     = MagmaRangeI:   the IL-th through IU-th eigenvalues will be found.
+
+    @param[in]
+    n       INTEGER
+            The order of the matrix.  N >= 0.
+
+    @param[in,out]
+    d       DOUBLE PRECISION array, dimension (N)
+            On entry, the N diagonal elements of the tridiagonal
+            matrix T. On exit, D is overwritten.
+
+    @param[in,out]
+    e       DOUBLE PRECISION array, dimension (N)
+            On entry, the (N-1) subdiagonal elements of the tridiagonal
+            matrix T in elements 1 to N-1 of E. E(N) need not be set on
+            input, but is used internally as workspace.
+            On exit, E is overwritten.
+
+    @param[in]
+    vl      DOUBLE PRECISION
+    @param[in]
+    vu      DOUBLE PRECISION
+            If RANGE=MagmaRangeV, the lower and upper bounds of the interval to
+            be searched for eigenvalues. VL < VU.
+            Not referenced if RANGE = MagmaRangeAll or MagmaRangeI.
+
+    @param[in]
+    il      INTEGER
+    @param[in]
+    iu      INTEGER
+            If RANGE=MagmaRangeI, the indices (in ascending order) of the
+            smallest and largest eigenvalues to be returned.
+            1 <= IL <= IU <= N, if N > 0.
+            Not referenced if RANGE = MagmaRangeAll or MagmaRangeV.
+
+    @param[out]
+    m       INTEGER
+            The total number of eigenvalues found.  0 <= M <= N.
+            If RANGE = MagmaRangeAll, M = N, and if RANGE = MagmaRangeI, M = IU-IL+1.
+
+    @param[out]
+    w       DOUBLE PRECISION array, dimension (N)
+            The first M elements contain the selected eigenvalues in
+            ascending order.
+
+    @param[out]
+    Z       COMPLEX_16 array, dimension (LDZ, max(1,M) )
+            If JOBZ = MagmaVec, and if INFO = 0, then the first M columns of Z
+            contain the orthonormal eigenvectors of the matrix T
+            corresponding to the selected eigenvalues, with the i-th
+            column of Z holding the eigenvector associated with W(i).
+            If JOBZ = MagmaNoVec, then Z is not referenced.
+
+    @param[in]
+    ldz     INTEGER
+            The leading dimension of the array Z.  LDZ >= 1, and if
+            JOBZ = MagmaVec, then LDZ >= max(1,N).
+
+    @param[in]
+    nzc     INTEGER
+            The number of eigenvectors to be held in the array Z, which
+            must be at least the number of selected eigenvalues.
+            If NZC = -1, then a workspace query is assumed, as in LAPACK.
+
+    @param[out]
+    isuppz  INTEGER array, dimension ( 2*max(1,M) )
+            The support of the eigenvectors in Z, i.e., the indices
+            indicating the nonzero elements in Z. The i-th computed eigenvector
+            is nonzero only in elements ISUPPZ( 2*i-1 ) through
+            ISUPPZ( 2*i ).
+
+    @param[in,out]
+    tryrac  LOGICAL
+            If TRYRAC = 1, indicates that the code should check whether
+            the tridiagonal matrix defines its eigenvalues to high relative
+            accuracy.  If so, the code uses relative-accuracy preserving
+            algorithms that might be (a bit) slower depending on the matrix.
+            On exit, TRYRAC is set to 0 if the matrix does not define
+            its eigenvalues to high relative accuracy.
+
+    @param
+    work    (workspace/output) DOUBLE PRECISION array, dimension (LWORK)
+            On exit, if INFO = 0, WORK(1) returns the optimal
+            (and minimal) LWORK.
+
+    @param[in]
+    lwork   INTEGER
+            The dimension of the array WORK. LWORK >= max(1,18*N)
+            if JOBZ = MagmaVec, and LWORK >= max(1,12*N) if JOBZ = MagmaNoVec.
+            If LWORK = -1, then a workspace query is assumed.
+
+    @param
+    iwork   (workspace/output) INTEGER array, dimension (LIWORK)
+            On exit, if INFO = 0, IWORK(1) returns the optimal LIWORK.
+
+    @param[in]
+    liwork  INTEGER
+            The dimension of the array IWORK.  LIWORK >= max(1,10*N)
+            if the eigenvectors are desired, and LIWORK >= max(1,8*N)
+            if only the eigenvalues are to be computed.
+            If LIWORK = -1, then a workspace query is assumed.
+
+    @param[out]
+    info    INTEGER
+      -     = 0:  successful exit
+      -     < 0:  if INFO = -i, the i-th argument had an illegal value
+      -     > 0:  if INFO = 1X, internal error in dlarre,
+                  if INFO = 2X, internal error in the computation of the
+                  eigenvectors, as for dlarrv in LAPACK.
+                  Here, the digit X = ABS( IINFO ) < 10.
+
+    @ingroup magma_heev_comp
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zstemr(
+    magma_vec_t jobz, magma_range_t range, magma_int_t n,
+    double *d, double *e,
+    double vl, double vu, magma_int_t il, magma_int_t iu,
+    magma_int_t *m, double *w,
+    magmaDoubleComplex *Z, magma_int_t ldz, magma_int_t nzc,
+    magma_int_t *isuppz, magma_int_t *tryrac,
+    double *work, magma_int_t lwork,
+    magma_int_t *iwork, magma_int_t liwork,
+    magma_int_t *info )
+{
+    #define Z(i_,j_) (Z + (i_) + (j_)*ldz)
+
+    const double minrgp = 1.e-3;
+
+    const char* jobz_  = lapack_vec_const( jobz );
+    const char* range_ = lapack_range_const( range );
+
+    bool wantz  = (jobz  == MagmaVec);
+    bool alleig = (range == MagmaRangeAll);
+    bool valeig = (range == MagmaRangeV);
+    bool indeig = (range == MagmaRangeI);
+    bool lquery = (lwork == -1 || liwork == -1 || nzc == -1);
+
+    magma_int_t lwmin  = max( 1, (wantz ? 18*n : 12*n) );
+    magma_int_t liwmin = max( 1, (wantz ? 10*n :  8*n) );
+
+    magma_int_t i, j, iinfo;
+
+    *info = 0;
+    if (! wantz && jobz != MagmaNoVec) {
+        *info = -1;
+    } else if (! (alleig || valeig || indeig)) {
+        *info = -2;
+    } else if (n < 0) {
+        *info = -3;
+    } else if (valeig && n > 0 && vu <= vl) {
+        *info = -7;
+    } else if (indeig && (il < 1 || il > max( 1, n ))) {
+        *info = -8;
+    } else if (indeig && (iu < min( n, il ) || iu > n)) {
+        *info = -9;
+    } else if (ldz < 1 || (wantz && ldz < n)) {
+        *info = -13;
+    } else if (lwork < lwmin && ! lquery) {
+        *info = -17;
+    } else if (liwork < liwmin && ! lquery) {
+        *info = -19;
+    }
+
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    // the queries, the eigenvalue-only path, and the tiny cases are LAPACK's
+    if (lquery || ! wantz || n <= 2) {
+        lapackf77_zstemr( jobz_, range_, &n, d, e, &vl, &vu, &il, &iu, m, w,
+                          Z, &ldz, &nzc, isuppz, tryrac,
+                          work, &lwork, iwork, &liwork, info );
+        return *info;
+    }
+
+    double safmin = lapackf77_dlamch( "Safe minimum" );
+    double eps    = lapackf77_dlamch( "Precision" );
+    double smlnum = safmin / eps;
+    double bignum = 1 / smlnum;
+    double rmin   = sqrt( smlnum );
+    double rmax   = min( sqrt( bignum ), 1 / sqrt( sqrt( safmin )));
+
+    double wl = 0, wu = 0;
+    magma_int_t iil = 0, iiu = 0;
+    if (valeig) {
+        wl = vl;
+        wu = vu;
+    }
+    else if (indeig) {
+        iil = il;
+        iiu = iu;
+    }
+
+    // workspace, laid out as in LAPACK's zstemr
+    double *werr  = work;
+    double *wgap  = werr  + n;
+    double *gers  = wgap  + n;
+    double *dsave = gers  + 2*n;
+    double *e2    = dsave + n;
+    double *rwork = e2    + n;      // 6*n for dlarre
+    magma_int_t *iblock = iwork;
+    magma_int_t *isplit = iblock + n;
+    magma_int_t *indexw = isplit + n;
+    magma_int_t *iiwork = indexw + n;  // 5*n for dlarre
+
+    // scale matrix to allowable range, if necessary
+    double scale = 1;
+    double tnrm  = 0;
+    for (i = 0; i < n; ++i) {
+        tnrm = max( tnrm, fabs( d[i] ));
+    }
+    for (i = 0; i < n-1; ++i) {
+        tnrm = max( tnrm, fabs( e[i] ));
+    }
+    if (tnrm > 0 && tnrm < rmin) {
+        scale = rmin / tnrm;
+    }
+    else if (tnrm > rmax) {
+        scale = rmax / tnrm;
+    }
+    if (scale != 1) {
+        for (i = 0; i < n; ++i) {
+            d[i] *= scale;
+        }
+        for (i = 0; i < n-1; ++i) {
+            e[i] *= scale;
+        }
+        tnrm *= scale;
+        if (valeig) {
+            wl *= scale;
+            wu *= scale;
+        }
+    }
+
+    // test whether the matrix warrants the more expensive relative approach
+    if (*tryrac) {
+        lapackf77_dlarrr( &n, d, e, &iinfo );
+    }
+    else {
+        iinfo = -1;
+    }
+    double thresh;
+    if (iinfo == 0) {
+        thresh = eps;
+    }
+    else {
+        thresh = -eps;
+        *tryrac = 0;
+    }
+
+    if (*tryrac) {
+        // original diagonal, needed to guarantee relative accuracy
+        for (i = 0; i < n; ++i) {
+            dsave[i] = d[i];
+        }
+    }
+    for (i = 0; i < n-1; ++i) {
+        e2[i] = e[i]*e[i];
+    }
+
+    // root representations and their eigenvalue approximations
+    double rtol1 = sqrt( eps );
+    double rtol2 = max( sqrt( eps )*5.e-3, 4*eps );
+    double pivmin;
+    magma_int_t nsplit;
+    lapackf77_dlarre( range_, &n, &wl, &wu, &iil, &iiu, d, e, e2,
+                      &rtol1, &rtol2, &thresh, &nsplit, isplit, m, w, werr, wgap,
+                      iblock, indexw, gers, &pivmin, rwork, iiwork, &iinfo );
+    if (iinfo != 0) {
+        *info = 10 + abs( iinfo );
+        return *info;
+    }
+
+    magma_int_t nthread = magma_get_parallel_numthreads();
+    magma_int_t lapack_nthread = magma_get_lapack_numthreads();
+    magma_set_lapack_numthreads( 1 );
+    magma_thread_queue queue;
+    queue.launch( nthread );
+
+    zstemr_data data;
+    data.n      = n;
+    data.m      = *m;
+    data.vl     = wl;
+    data.pivmin = pivmin;
+    data.minrgp = minrgp;
+    data.rtol1  = rtol1;
+    data.rtol2  = rtol2;
+    data.indexw = indexw;
+    data.w      = w;
+    data.werr   = werr;
+    data.Z      = Z;
+    data.ldz    = ldz;
+    data.isuppz = isuppz;
+    data.info   = 0;
+
+    // one root task per block with wanted eigenvalues
+    magma_int_t nblock = (*m > 0 ? iblock[ *m-1 ] : 0);
+    magma_int_t ibegin = 0, wbegin, wend = 0;
+    for (magma_int_t jblk = 0; jblk < nblock; ++jblk) {
+        magma_int_t iend = isplit[ jblk ] - 1;
+        double sigma = e[ iend ];
+        wbegin = wend;
+        while (wend < *m && iblock[ wend ] == jblk+1) {
+            wend += 1;
+        }
+        magma_int_t in = iend - ibegin + 1;
+        magma_int_t im = wend - wbegin;
+        if (im == 0) {
+            ibegin = iend + 1;
+            continue;
+        }
+        if (in == 1) {
+            for (i = 0; i < n; ++i) {
+                *Z(i, wbegin) = MAGMA_Z_ZERO;
+            }
+            *Z(ibegin, wbegin) = MAGMA_Z_ONE;
+            isuppz[ 2*wbegin   ] = ibegin + 1;
+            isuppz[ 2*wbegin+1 ] = ibegin + 1;
+            w[ wbegin ] += sigma;
+            ibegin = iend + 1;
+            continue;
+        }
+
+        // local spectral diameter of the block
+        double gl = gers[ 2*ibegin ], gu = gers[ 2*ibegin+1 ];
+        for (i = ibegin+1; i <= iend; ++i) {
+            gl = min( gl, gers[ 2*i   ] );
+            gu = max( gu, gers[ 2*i+1 ] );
+        }
+        zstemr_block blk = { ibegin, wbegin, im, gu - gl };
+
+        std::shared_ptr< zstemr_rrr > root( new zstemr_rrr( in, sigma ));
+        std::copy( d + ibegin, d + iend + 1, root->D.begin() );
+        std::copy( e + ibegin, e + iend,     root->L.begin() );
+        zstemr_cluster_task* task = new zstemr_cluster_task(
+            &queue, &data, blk, root, 0, im-1, 0, 0. );
+        for (j = 0; j < im; ++j) {
+            task->lw   [j] = w   [ wbegin + j ];
+            task->lwerr[j] = werr[ wbegin + j ];
+            task->lwgap[j] = wgap[ wbegin + j ];
+            task->wabs [j] = w   [ wbegin + j ] + sigma;
+        }
+        queue.push_task( task );
+        ibegin = iend + 1;
+    }
+    queue.sync();
+
+    if (data.info != 0) {
+        *info = 20 + abs( data.info.load() );
+    }
+    else if (*tryrac) {
+        // refine the eigenvalues so they are relatively accurate with
+        // respect to the original matrix, in chunks of eigenvalues
+        magma_int_t chunk = max( 1, magma_ceildiv( *m, 4*nthread ));
+        ibegin = 0;
+        wend = 0;
+        for (magma_int_t jblk = 0; jblk < nblock; ++jblk) {
+            magma_int_t iend = isplit[ jblk ] - 1;
+            wbegin = wend;
+            while (wend < *m && iblock[ wend ] == jblk+1) {
+                wend += 1;
+            }
+            for (j = wbegin; j < wend; j += chunk) {
+                queue.push_task( new zstemr_refine_task(
+                    iend - ibegin + 1, dsave + ibegin, e2 + ibegin, indexw,
+                    w, werr, j, min( j + chunk, wend ), pivmin, tnrm ));
+            }
+            ibegin = iend + 1;
+        }
+        queue.sync();
+    }
+
+    queue.quit();
+    magma_set_lapack_numthreads( lapack_nthread );
+
+    if (*info != 0) {
+        return *info;
+    }
+
+    // undo scaling
+    if (scale != 1) {
+        for (i = 0; i < *m; ++i) {
+            w[i] /= scale;
+        }
+    }
+
+    // eigenvalues come out by block; sort them in increasing order,
+    // following each permutation cycle with swaps of columns of Z
+    if (nsplit > 1) {
+        std::vector< magma_int_t > perm( *m );
+        for (i = 0; i < *m; ++i) {
+            perm[i] = i;
+        }
+        std::stable_sort( perm.begin(), perm.end(),
+            [w]( magma_int_t a, magma_int_t b ) { return w[a] < w[b]; } );
+        const magma_int_t ione = 1;
+        std::vector< bool > done( *m, false );
+        for (i = 0; i < *m; ++i) {
+            magma_int_t x = i;
+            while (! done[x]) {
+                done[x] = true;
+                magma_int_t y = perm[x];
+                if (y == i) {
+                    break;
+                }
+                std::swap( w[x], w[y] );
+                std::swap( isuppz[ 2*x   ], isuppz[ 2*y   ] );
+                std::swap( isuppz[ 2*x+1 ], isuppz[ 2*y+1 ] );
+                blasf77_zswap( &n, Z(0,x), &ione, Z(0,y), &ione );
+                x = y;
+            }
+        }
+    }
+
+    work[0]  = lwmin;
+    iwork[0] = liwmin;
+    return *info;
+
+    #undef Z
+}
@@ -10,6 +10,9 @@
        
        @precisions normal z -> c
 */
+#include <algorithm>
+#include <vector>
+
 #include "thread_queue.hpp"
 #include "magma_timer.h"
 
@@ -29,7 +32,8 @@ public:
         magmaDoubleComplex  in_lambda,
         magmaDoubleComplex *in_x, //magma_int_t in_incx,
         magmaDoubleComplex *in_scale,
-        double *in_cnorm
+        double *in_cnorm,
+        std::atomic< magma_int_t > *in_info
     ):
         uplo  ( in_uplo   ),
         trans ( in_trans  ),
@@ -42,7 +46,8 @@ public:
         x     ( in_x      ),
         //incx  ( in_incx   ),
         scale ( in_scale  ),
-        cnorm ( in_cnorm  )
+        cnorm ( in_cnorm  ),
+        latrs_info( in_info )
     {}
     
     virtual void run()
@@ -56,7 +61,7 @@ public:
                        T, ldt, lambda, x, &s, cnorm, &info );
         *scale = MAGMA_Z_MAKE( s, 0 );
         if ( info != 0 ) {
-            fprintf( stderr, "zlatrsd info %lld\n", (long long) info );
+            *latrs_info = info;
         }
     }
     
@@ -73,17 +78,17 @@ private:
     magmaDoubleComplex *scale;
     //magma_int_t   incx;
     double *cnorm;
+    std::atomic< magma_int_t > *latrs_info;
 };
 
 
 // ---------------------------------------------
 // stores arguments and executes call to zgemm (on CPU)
-// todo - better to store magma_trans_t and use lapack_trans_const, since there
-// is no guarantee that the char* string is still valid when the task gets executed.
-class zgemm_task: public magma_task
+class zgemm_task: public magma_graph_task
 {
 public:
     zgemm_task(
+        magma_thread_queue* in_queue,
         magma_trans_t in_transA, magma_trans_t in_transB,
         magma_int_t in_m, magma_int_t in_n, magma_int_t in_k,
         magmaDoubleComplex  in_alpha,
@@ -92,6 +97,7 @@ public:
         magmaDoubleComplex  in_beta,
         magmaDoubleComplex *in_C, magma_int_t in_ldc
     ):
+        magma_graph_task( in_queue ),
         transA( in_transA ),
         transB( in_transB ),
         m     ( in_m      ),
@@ -107,7 +113,7 @@ public:
         ldc   ( in_ldc    )
     {}
     
-    virtual void run()
+    virtual void run_task()
     {
         blasf77_zgemm( lapack_trans_const(transA), lapack_trans_const(transB),
                        &m, &n, &k, &alpha, A, &lda, B, &ldb, &beta, C, &ldc );
@@ -130,6 +136,485 @@ private:
 };
 
 
+// ---------------------------------------------
+// Rows of T per tile in the blocked solver. Each update task multiplies a
+// tile of T by the nb right-hand sides of a block, so every tile of T read
+// is reused across nb shifted systems.
+const magma_int_t ztrevc_tile = 256;
+
+
+// ---------------------------------------------
+// State of the blocked solve for one block of nc eigenvectors, with
+// eigenvalue indices kc[0] < ... < kc[nc-1].
+// Right eigenvectors solve
+//     ( T(0:k-1, 0:k-1) - T(k,k) ) x = -T(0:k-1, k)
+// by backward substitution; left eigenvectors solve
+//     ( T(k+1:n-1, k+1:n-1) - T(k,k) )**H x = -T(k, k+1:n-1)**H
+// by forward substitution, for each k = kc[c], over tiles of T.
+//
+// As in zlatrs, solutions are scaled to avoid overflow, but each tile r of
+// column c has its own scale: X(tile r, c) holds 2**alpha(r,c) times that
+// tile of the true rhs or solution. Keeping log2 of the scales means they
+// cannot underflow, so tiles keep their relative scale however much the
+// solution grows. zlatrsd's scale can underflow to zero, after which all
+// earlier tiles are negligible; that is recorded as a drop in alpha by
+// 2*log2(safemin), large enough that 2**(difference) is zero, keeping the
+// scale of later tiles relative to this one. Update tasks bring two tiles
+// to a common scale, reduced further if needed so the update cannot
+// overflow (robust "protect update" of Mikkelsen and Karlsson); the
+// finalize task brings all tiles of each column to the smallest scale,
+// which is stored in X(k,c), like scale in ztrevc3.
+class ztrevc_block
+{
+public:
+    bool left, over;
+    magma_int_t n, tb, ntile;
+    const magmaDoubleComplex *T;  magma_int_t ldt;
+    const double *tnorm;   // tnorm[q + r*ntile], q <= r, bounds ||T(q,r)*x|| / ||x||
+    const double *cnorm;   // cnorm[j] = 1-norm of T(r0:j-1, j), r0 = first row of j's tile
+    double bignum;
+    double log2_tiny;      // 2*log2(safemin), replaces log2(0) for a zero scale
+    
+    magma_int_t nc;
+    magma_int_t *kc;       // eigenvalue index of each column
+    magma_int_t *is;       // output column of each vector, if not over
+    magmaDoubleComplex *X;   magma_int_t ldx;   // n-by-nc solutions
+    magmaDoubleComplex *Y;   magma_int_t ldy;   // ntile*tb-by-nc workspace
+    magmaDoubleComplex *QX;                     // n-by-nc back-transformed, ld ldx
+    double *alpha;         // alpha[r + c*ntile], log2 of scale of tile r of column c
+    magmaDoubleComplex *V;   magma_int_t ldv;   // VR or VL
+    std::atomic< magma_int_t > *latrs_info;       // set to zlatrsd's info if it fails
+    
+    // unknowns of column c are rows lo(c):hi(c)-1
+    magma_int_t lo( magma_int_t c ) const { return left ? kc[c]+1 : 0; }
+    magma_int_t hi( magma_int_t c ) const { return left ? n : kc[c]; }
+    
+    magma_int_t row0( magma_int_t r ) const { return r*tb; }
+    magma_int_t row1( magma_int_t r ) const { return min( n, (r+1)*tb ); }
+    
+    bool active( magma_int_t r, magma_int_t c ) const
+    {
+        return max( row0(r), lo(c) ) < min( row1(r), hi(c) );
+    }
+    
+    // columns with unknowns in tile r are contiguous, cbeg:cend-1
+    void active_columns( magma_int_t r, magma_int_t *cbeg, magma_int_t *cend ) const
+    {
+        *cbeg = 0;
+        while ( *cbeg < nc && ! active( r, *cbeg )) {
+            *cbeg += 1;
+        }
+        *cend = *cbeg;
+        while ( *cend < nc && active( r, *cend )) {
+            *cend += 1;
+        }
+    }
+};
+
+
+// ---------------------------------------------
+// @return scale s in (0, 1] such that s*(bnorm + tnorm*xnorm) <= bignum,
+// given bnorm <= bignum, xnorm <= bignum, and tnorm <= bignum.
+static double ztrevc_protect_update(
+    double tnorm, double xnorm, double bnorm, double bignum )
+{
+    if ( xnorm <= 1. ) {
+        if ( tnorm*xnorm > bignum - bnorm ) {
+            return 0.5;
+        }
+    }
+    else if ( tnorm > (bignum - bnorm) / xnorm ) {
+        return 0.5 / xnorm;
+    }
+    return 1.;
+}
+
+
+// ---------------------------------------------
+// @return max_i |x_i|, using |re| + |im|
+static double ztrevc_amax( magma_int_t n, const magmaDoubleComplex *x )
+{
+    double xmax = 0;
+    for( magma_int_t i=0; i < n; ++i ) {
+        xmax = max( xmax, MAGMA_Z_ABS1( x[i] ));
+    }
+    return xmax;
+}
+
+
+// ---------------------------------------------
+// computes cnorm for columns of tile r and tnorm for tiles T(q,r), q < r.
+// As |x*y| <= |x|_1 * |y|_1 <= sqrt(2) |x*y|_1, where |x|_1 = |re| + |im|,
+// tnorm is twice the larger of the 1- and inf-norms of the tile, using |.|_1,
+// so it bounds the update in either direction (T or T**H).
+class ztrevc_norm_task: public magma_task
+{
+public:
+    ztrevc_norm_task( const ztrevc_block* in_b, magma_int_t in_r, double* in_tnorm, double* in_cnorm ):
+        b( in_b ), r( in_r ), tnorm( in_tnorm ), cnorm( in_cnorm )
+    {}
+    
+    virtual void run()
+    {
+        const magma_int_t ione = 1;
+        magma_int_t r0 = b->row0( r ), r1 = b->row1( r );
+        for( magma_int_t j = r0; j < r1; ++j ) {
+            cnorm[j] = magma_cblas_dzasum( j - r0, b->T + r0 + j*b->ldt, ione );
+        }
+        std::vector< double > rowsum( b->tb );
+        for( magma_int_t q = 0; q < r; ++q ) {
+            magma_int_t q0 = b->row0( q ), q1 = b->row1( q );
+            double colmax = 0;
+            for( magma_int_t i = 0; i < q1 - q0; ++i ) {
+                rowsum[i] = 0;
+            }
+            for( magma_int_t j = r0; j < r1; ++j ) {
+                double colsum = 0;
+                for( magma_int_t i = q0; i < q1; ++i ) {
+                    double t = MAGMA_Z_ABS1( b->T[ i + j*b->ldt ] );
+                    colsum        += t;
+                    rowsum[i-q0]  += t;
+                }
+                colmax = max( colmax, colsum );
+            }
+            double rowmax = 0;
+            for( magma_int_t i = 0; i < q1 - q0; ++i ) {
+                rowmax = max( rowmax, rowsum[i] );
+            }
+            tnorm[ q + r*b->ntile ] = 2 * max( colmax, rowmax );
+        }
+    }
+    
+private:
+    const ztrevc_block* b;
+    magma_int_t r;
+    double *tnorm, *cnorm;
+};
+
+
+// ---------------------------------------------
+// solves the diagonal tile r for columns c0:c1-1 with zlatrsd,
+// updating the tile's scale factors
+class ztrevc_solve_task: public magma_graph_task
+{
+public:
+    ztrevc_solve_task( magma_thread_queue* in_queue, ztrevc_block* in_b,
+                       magma_int_t in_r, magma_int_t in_c0, magma_int_t in_c1 ):
+        magma_graph_task( in_queue ), b( in_b ), r( in_r ), c0( in_c0 ), c1( in_c1 )
+    {}
+    
+    virtual void run_task()
+    {
+        magma_int_t info = 0;
+        // zlatrsd may scale cnorm in place, so give it a private copy
+        std::vector< double > cnorm( b->tb );
+        for( magma_int_t c = c0; c < c1; ++c ) {
+            if ( ! b->active( r, c )) {
+                continue;
+            }
+            magma_int_t i0 = max( b->row0( r ), b->lo( c ));
+            magma_int_t i1 = min( b->row1( r ), b->hi( c ));
+            for( magma_int_t i = i0; i < i1; ++i ) {
+                cnorm[ i - i0 ] = b->cnorm[i];
+            }
+            double s;
+            magma_int_t k = b->kc[c];
+            magma_zlatrsd( MagmaUpper, (b->left ? MagmaConjTrans : MagmaNoTrans),
+                           MagmaNonUnit, MagmaTrue, i1 - i0,
+                           b->T + i0 + i0*b->ldt, b->ldt, b->T[ k + k*b->ldt ],
+                           b->X + i0 + c*b->ldx, &s, &cnorm[0], &info );
+            if ( info != 0 ) {
+                *b->latrs_info = info;
+            }
+            b->alpha[ r + c*b->ntile ] += (s > 0 ? log2( s ) : b->log2_tiny);
+        }
+    }
+    
+private:
+    ztrevc_block* b;
+    magma_int_t r, c0, c1;
+};
+
+
+// ---------------------------------------------
+// updates tile q with solved tile r:
+// right: X(q,:) -= T(q,r)    * X(r,:),  q < r;
+// left:  X(q,:) -= T(r,q)**H * X(r,:),  q > r;
+// after scaling both to a common scale that protects against overflow.
+class ztrevc_update_task: public magma_graph_task
+{
+public:
+    ztrevc_update_task( magma_thread_queue* in_queue, ztrevc_block* in_b,
+                        magma_int_t in_r, magma_int_t in_q ):
+        magma_graph_task( in_queue ), b( in_b ), r( in_r ), q( in_q )
+    {}
+    
+    virtual void run_task()
+    {
+        const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+        const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+        const magma_int_t ione = 1;
+        
+        magma_int_t r0 = b->row0( r ), rm = b->row1( r ) - r0;
+        magma_int_t q0 = b->row0( q ), qm = b->row1( q ) - q0;
+        double tnorm = b->tnorm[ min( q, r ) + max( q, r )*b->ntile ];
+        magma_int_t cbeg, cend;
+        b->active_columns( r, &cbeg, &cend );
+        
+        magmaDoubleComplex *Y = b->Y + q0;
+        for( magma_int_t c = cbeg; c < cend; ++c ) {
+            magmaDoubleComplex *xq = b->X + q0 + c*b->ldx;
+            magmaDoubleComplex *xr = b->X + r0 + c*b->ldx;
+            double *aq = &b->alpha[ q + c*b->ntile ];
+            double  ar =  b->alpha[ r + c*b->ntile ];
+            
+            // common scale is the smaller one
+            double amin = min( *aq, ar );
+            double fq = (*aq == amin ? 1. : exp2( amin - *aq ));
+            double fr = (ar  == amin ? 1. : exp2( amin - ar  ));
+            double s = ztrevc_protect_update( tnorm, fr * ztrevc_amax( rm, xr ),
+                                              fq * ztrevc_amax( qm, xq ), b->bignum );
+            fq *= s;
+            fr *= s;
+            *aq = amin + log2( s );
+            if ( fq != 1. ) {
+                blasf77_zdscal( &qm, &fq, xq, &ione );
+            }
+            for( magma_int_t i = 0; i < rm; ++i ) {
+                Y[ i + c*b->ldy ] = xr[i] * fr;
+            }
+        }
+        
+        magma_int_t ncol = cend - cbeg;
+        if ( ncol > 0 ) {
+            if ( b->left ) {
+                blasf77_zgemm( "C", "N", &qm, &ncol, &rm,
+                               &c_neg_one, b->T + r0 + q0*b->ldt, &b->ldt,
+                                           Y + cbeg*b->ldy, &b->ldy,
+                               &c_one,     b->X + q0 + cbeg*b->ldx, &b->ldx );
+            }
+            else {
+                blasf77_zgemm( "N", "N", &qm, &ncol, &rm,
+                               &c_neg_one, b->T + q0 + r0*b->ldt, &b->ldt,
+                                           Y + cbeg*b->ldy, &b->ldy,
+                               &c_one,     b->X + q0 + cbeg*b->ldx, &b->ldx );
+            }
+        }
+    }
+    
+private:
+    ztrevc_block* b;
+    magma_int_t r, q;
+};
+
+
+// ---------------------------------------------
+// brings all tiles of each column to a common scale and sets x(k) = scale.
+// If not back-transforming, also copies each vector to V and normalizes it.
+class ztrevc_finalize_task: public magma_graph_task
+{
+public:
+    ztrevc_finalize_task( magma_thread_queue* in_queue, ztrevc_block* in_b ):
+        magma_graph_task( in_queue ), b( in_b )
+    {}
+    
+    virtual void run_task()
+    {
+        const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+        const magma_int_t ione = 1;
+        
+        for( magma_int_t c = 0; c < b->nc; ++c ) {
+            magmaDoubleComplex *x = b->X + c*b->ldx;
+            double amin = 0;
+            for( magma_int_t r = 0; r < b->ntile; ++r ) {
+                if ( b->active( r, c )) {
+                    amin = min( amin, b->alpha[ r + c*b->ntile ] );
+                }
+            }
+            for( magma_int_t r = 0; r < b->ntile; ++r ) {
+                double a = b->alpha[ r + c*b->ntile ];
+                if ( b->active( r, c ) && a != amin ) {
+                    magma_int_t i0 = b->row0( r ), m = b->row1( r ) - i0;
+                    double f = exp2( amin - a );
+                    blasf77_zdscal( &m, &f, x + i0, &ione );
+                }
+            }
+            magma_int_t k = b->kc[c];
+            x[k] = MAGMA_Z_MAKE( exp2( amin ), 0 );
+            
+            if ( ! b->over ) {
+                // copy x to V and normalize
+                magma_int_t i0 = (b->left ? k : 0);
+                magma_int_t n2 = (b->left ? b->n - k : k + 1);
+                magmaDoubleComplex *v = b->V + b->is[c]*b->ldv;
+                blasf77_zcopy( &n2, x + i0, &ione, v + i0, &ione );
+                
+                magma_int_t ii = blasf77_izamax( &n2, v + i0, &ione ) + i0 - 1;
+                double remax = 1. / MAGMA_Z_ABS1( v[ii] );
+                blasf77_zdscal( &n2, &remax, v + i0, &ione );
+                
+                for( magma_int_t i = 0; i < b->n; ++i ) {
+                    if ( i < i0 || i >= i0 + n2 ) {
+                        v[i] = c_zero;
+                    }
+                }
+            }
+        }
+    }
+    
+private:
+    ztrevc_block* b;
+};
+
+
+// ---------------------------------------------
+// normalizes back-transformed vectors and copies them to V
+class ztrevc_copy_task: public magma_graph_task
+{
+public:
+    ztrevc_copy_task( magma_thread_queue* in_queue, ztrevc_block* in_b ):
+        magma_graph_task( in_queue ), b( in_b )
+    {}
+    
+    virtual void run_task()
+    {
+        const magma_int_t ione = 1;
+        for( magma_int_t c = 0; c < b->nc; ++c ) {
+            magmaDoubleComplex *qx = b->QX + c*b->ldx;
+            magma_int_t ii = blasf77_izamax( &b->n, qx, &ione ) - 1;
+            double remax = 1. / MAGMA_Z_ABS1( qx[ii] );
+            blasf77_zdscal( &b->n, &remax, qx, &ione );
+        }
+        // back-transform is only for all vectors, so columns kc are contiguous
+        lapackf77_zlacpy( "F", &b->n, &b->nc, b->QX, &b->ldx,
+                          b->V + b->kc[0]*b->ldv, &b->ldv );
+    }
+    
+private:
+    ztrevc_block* b;
+};
+
+
+/******************************************************************************/
+// Adds to tasks the graph for the blocked solve of block b: for each tile r,
+// in order of the substitution, solve tasks for the diagonal tile, then
+// update tasks for each later tile q. Updates of one tile q are chained, and
+// the solve of tile q waits for its last update, so updates of tiles further
+// ahead overlap with the solve of the next tile. A finalize task follows the
+// last solve.
+static void
+ztrevc_solve_graph(
+    magma_thread_queue* queue, ztrevc_block* b,
+    std::vector< magma_graph_task* >& tasks )
+{
+    const magma_int_t ncol_solve = 8;  // columns per solve task
+    
+    // tiles with unknowns, in the order they are solved
+    std::vector< magma_int_t > order;
+    if ( b->left ) {
+        for( magma_int_t r = b->lo( 0 ) / b->tb; r < b->ntile; ++r ) {
+            order.push_back( r );
+        }
+    }
+    else {
+        for( magma_int_t r = (b->hi( b->nc-1 ) - 1) / b->tb; r >= 0; --r ) {
+            order.push_back( r );
+        }
+    }
+    // check the first tile is active (no unknowns if only k = 0 for right, or k = n-1 for left)
+    if ( order.empty() || b->lo( b->left ? 0 : b->nc-1 ) >= b->hi( b->left ? 0 : b->nc-1 )) {
+        order.clear();
+    }
+    
+    // last[q] is the last update task of tile q so far
+    std::vector< magma_graph_task* > last( b->ntile, (magma_graph_task*) NULL );
+    std::vector< magma_graph_task* > solves;
+    for( size_t ir = 0; ir < order.size(); ++ir ) {
+        magma_int_t r = order[ir];
+        solves.clear();
+        for( magma_int_t c0 = 0; c0 < b->nc; c0 += ncol_solve ) {
+            magma_graph_task* task = new ztrevc_solve_task(
+                queue, b, r, c0, min( c0 + ncol_solve, b->nc ));
+            if ( last[r] != NULL ) {
+                task->add_dependency( last[r] );
+            }
+            solves.push_back( task );
+            tasks.push_back( task );
+        }
+        for( size_t iq = ir+1; iq < order.size(); ++iq ) {
+            magma_int_t q = order[iq];
+            magma_graph_task* task = new ztrevc_update_task( queue, b, r, q );
+            for( size_t i = 0; i < solves.size(); ++i ) {
+                task->add_dependency( solves[i] );
+            }
+            if ( last[q] != NULL ) {
+                task->add_dependency( last[q] );
+            }
+            last[q] = task;
+            tasks.push_back( task );
+        }
+    }
+    
+    magma_graph_task* task = new ztrevc_finalize_task( queue, b );
+    for( size_t i = 0; i < solves.size(); ++i ) {
+        task->add_dependency( solves[i] );
+    }
+    tasks.push_back( task );
+}
+
+
+/******************************************************************************/
+// Adds to tasks the back-transform of block b, Q*X, split into block rows,
+// followed by a task that normalizes and copies the vectors to V.
+static void
+ztrevc_backtransform_graph(
+    magma_thread_queue* queue, ztrevc_block* b, magma_int_t gemm_nb,
+    std::vector< magma_graph_task* >& tasks )
+{
+    const magmaDoubleComplex c_zero = MAGMA_Z_ZERO;
+    const magmaDoubleComplex c_one  = MAGMA_Z_ONE;
+    
+    // right: Q(:, 0:kmax) * X(0:kmax, :);  left: Q(:, kmin:n-1) * X(kmin:n-1, :)
+    magma_int_t j0 = (b->left ? b->kc[0] : 0);
+    magma_int_t n2 = (b->left ? b->n - b->kc[0] : b->kc[ b->nc-1 ] + 1);
+    
+    magma_graph_task* copy = new ztrevc_copy_task( queue, b );
+    for( magma_int_t i=0; i < b->n; i += gemm_nb ) {
+        magma_int_t ib = min( gemm_nb, b->n - i );
+        magma_graph_task* task = new zgemm_task(
+            queue, MagmaNoTrans, MagmaNoTrans, ib, b->nc, n2, c_one,
+            b->V + i + j0*b->ldv, b->ldv,
+            b->X + j0, b->ldx, c_zero,
+            b->QX + i, b->ldx );
+        copy->add_dependency( task );
+        tasks.push_back( task );
+    }
+    tasks.push_back( copy );
+}
+
+
+/******************************************************************************/
+// Pushes the tasks that have no dependencies, and waits for the whole graph.
+// Ready tasks are found before pushing any, since tasks may run, push their
+// successors, and be deleted as soon as they are pushed.
+static void
+ztrevc_run_graph(
+    magma_thread_queue* queue, std::vector< magma_graph_task* >& tasks )
+{
+    std::vector< magma_graph_task* > ready;
+    for( size_t i = 0; i < tasks.size(); ++i ) {
+        if ( tasks[i]->ready() ) {
+            ready.push_back( tasks[i] );
+        }
+    }
+    for( size_t i = 0; i < ready.size(); ++i ) {
+        queue->push_task( ready[i] );
+    }
+    queue->sync();
+    tasks.clear();
+}
+
+
 /***************************************************************************//**
     Purpose
     -------
@@ -153,7 +638,11 @@ private:
     A to Schur form T, then Q*X and Q*Y are the matrices of right and
     left eigenvectors of A.
 
-    This uses a Level 3 BLAS version of the back transformation.
+    If there is sufficient workspace, this uses a blocked version that solves
+    nb shifted triangular systems at once, updating tiles of all nb vectors
+    with Level 3 BLAS, and a Level 3 BLAS version of the back transformation
+    that overlaps the solve of the next block of vectors.
+    Vectors are scaled to prevent overflow as in ZTREVC3.
     This uses a multi-threaded (mt) implementation.
 
     Arguments
@@ -256,6 +745,8 @@ private:
     info     INTEGER
        -     = 0:  successful exit
        -     < 0:  if info = -i, the i-th argument had an illegal value
+       -     = MAGMA_ERR_ILLEGAL_VALUE: zlatrsd rejected an argument while
+                   solving for an eigenvector
 
     Further Details
     ---------------
@@ -401,20 +892,156 @@ magma_int_t magma_ztrevc3_mt(
         gemm_nb += 32;
     }
     
-    magma_timer_t time_total=0, time_trsv=0, time_gemm=0, time_gemv=0, time_trsv_sum=0, time_gemm_sum=0, time_gemv_sum=0;
+    magma_timer_t time_total=0, time_trsv=0, time_gemv=0, time_trsv_sum=0, time_gemv_sum=0;
     timer_start( time_total );
+    
+    // tasks record a zlatrsd failure here; checked once all tasks are done
+    std::atomic< magma_int_t > latrs_info( 0 );
 
-    if ( rightv ) {
+    if ( version == 2 ) {
+        // ============================================================
+        // Blocked version: solves a block of nb eigenvectors together,
+        // one tile of T at a time (see ztrevc_block), so level 3 updates
+        // reuse each tile of T for all nb shifts. Tasks wait only on the
+        // tiles they depend on; the back-transform of each block of vectors
+        // runs concurrently with the solve of the next block,
+        // with one sync per block.
+        // X alternates between work(:,1:nb) and Xbuf; Q*X is in work(:,nb+1:2nb).
+        magma_int_t tb    = min( ztrevc_tile, n );
+        magma_int_t ntile = magma_ceildiv( n, tb );
+        magma_int_t ldy   = ntile*tb;
+        magmaDoubleComplex *Xbuf = NULL, *Y = NULL;
+        double *tnorm = NULL, *cnorm = NULL, *alpha = NULL;
+        if ( MAGMA_SUCCESS != magma_zmalloc_cpu( &Xbuf,  n*nb      ) ||
+             MAGMA_SUCCESS != magma_zmalloc_cpu( &Y,     ldy*nb    ) ||
+             MAGMA_SUCCESS != magma_dmalloc_cpu( &tnorm, ntile*ntile ) ||
+             MAGMA_SUCCESS != magma_dmalloc_cpu( &cnorm, n         ) ||
+             MAGMA_SUCCESS != magma_dmalloc_cpu( &alpha, ntile*nb  ))
+        {
+            *info = MAGMA_ERR_HOST_ALLOC;
+        }
+        else {
+            std::vector< magma_int_t > kc_buf[2], is_buf[2];
+            ztrevc_block blocks[2];
+            for( i=0; i < 2; ++i ) {
+                kc_buf[i].resize( nb );
+                is_buf[i].resize( nb );
+                ztrevc_block& b = blocks[i];
+                b.over   = over;
+                b.n      = n;
+                b.tb     = tb;
+                b.ntile  = ntile;
+                b.T      = T;
+                b.ldt    = ldt;
+                b.tnorm  = tnorm;
+                b.cnorm  = cnorm;
+                b.bignum = lapackf77_dlamch( "Precision" ) / unfl;
+                b.log2_tiny = 2*log2( unfl );
+                b.nc     = 0;
+                b.kc     = &kc_buf[i][0];
+                b.is     = &is_buf[i][0];
+                b.X      = (i == 0 ? work(0,1) : Xbuf);
+                b.ldx    = n;
+                b.Y      = Y;
+                b.ldy    = ldy;
+                b.QX     = work(0,nb+1);
+                b.alpha  = alpha;
+                b.latrs_info = &latrs_info;
+            }
+        
+            // norms of tiles of T
+            for( magma_int_t r=0; r < ntile; ++r ) {
+                queue.push_task( new ztrevc_norm_task( &blocks[0], r, tnorm, cnorm ));
+            }
+            queue.sync();
+        
+            std::vector< magma_graph_task* > tasks;
+            for( int iside = 0; iside < 2; ++iside ) {
+                bool left = (iside == 1);
+                if ( (left && ! leftv) || (! left && ! rightv) ) {
+                    continue;
+                }
+                for( i=0; i < 2; ++i ) {
+                    blocks[i].left = left;
+                    blocks[i].V    = (left ? VL   : VR);
+                    blocks[i].ldv  = (left ? ldvl : ldvr);
+                }
+                ztrevc_block* cur  = &blocks[0];
+                ztrevc_block* prev = NULL;
+                // right vectors go from ki = n-1 down, left from ki = 0 up
+                ki = (left ? 0 : n-1);
+                is = (left ? 0 : *mout - 1);
+                while ( true ) {
+                    // gather the next block of selected eigenvalues, in ascending order
+                    cur->nc = 0;
+                    while ( cur->nc < nb && ki >= 0 && ki < n ) {
+                        if ( ! somev || select[ki] ) {
+                            cur->kc[ cur->nc ] = ki;
+                            cur->is[ cur->nc ] = is;
+                            cur->nc += 1;
+                            is += (left ? 1 : -1);
+                        }
+                        ki += (left ? 1 : -1);
+                    }
+                    if ( ! left ) {
+                        std::reverse( cur->kc, cur->kc + cur->nc );
+                        std::reverse( cur->is, cur->is + cur->nc );
+                    }
+                    if ( cur->nc == 0 && prev == NULL ) {
+                        break;
+                    }
+                
+                    if ( cur->nc > 0 ) {
+                        // form right-hand sides
+                        lapackf77_zlaset( "F", &n, &cur->nc, &c_zero, &c_zero, cur->X, &cur->ldx );
+                        for( j=0; j < cur->nc; ++j ) {
+                            magmaDoubleComplex *x = cur->X + j*cur->ldx;
+                            k = cur->kc[j];
+                            if ( left ) {
+                                for( i = k+1; i < n; ++i ) {
+                                    x[i] = -MAGMA_Z_CONJ( *T(k,i) );
+                                }
+                            }
+                            else {
+                                for( i = 0; i < k; ++i ) {
+                                    x[i] = -(*T(i,k));
+                                }
+                            }
+                            for( i = 0; i < ntile; ++i ) {
+                                cur->alpha[ i + j*ntile ] = 0;
+                            }
+                        }
+                        ztrevc_solve_graph( &queue, cur, tasks );
+                    }
+                    if ( prev != NULL ) {
+                        ztrevc_backtransform_graph( &queue, prev, gemm_nb, tasks );
+                    }
+                    ztrevc_run_graph( &queue, tasks );
+                
+                    if ( cur->nc == 0 ) {
+                        break;
+                    }
+                    if ( over ) {
+                        prev = cur;
+                        cur  = (cur == &blocks[0] ? &blocks[1] : &blocks[0]);
+                    }
+                }
+            }
+        }
+        
+        magma_free_cpu( Xbuf  );
+        magma_free_cpu( Y     );
+        magma_free_cpu( tnorm );
+        magma_free_cpu( cnorm );
+        magma_free_cpu( alpha );
+    }
+    
+    if ( rightv && version == 1 ) {
         // ============================================================
         // Compute right eigenvectors.
-        // iv is index of column in current block.
-        // Non-blocked version always uses iv=1;
-        // blocked     version starts with iv=nb, goes down to 1.
+        // Non-blocked version uses column iv=1 of work.
         // (Note the "0-th" column is used to store the original diagonal.)
         iv = 1;
-        if ( version == 2 ) {
-            iv = nb;
-        }
         
         timer_start( time_trsv );
         is = *mout - 1;
@@ -441,7 +1068,7 @@ magma_int_t magma_ztrevc3_mt(
                 queue.push_task( new magma_zlatrsd_task(
                     MagmaUpper, MagmaNoTrans, MagmaNonUnit, MagmaTrue,
                     ki, T, ldt, *T(ki,ki),
-                    work(0,iv), work(ki,iv), rwork ));
+                    work(0,iv), work(ki,iv), rwork, &latrs_info ));
             }
 
             // Copy the vector x or Q*x to VR and normalize.
@@ -460,7 +1087,7 @@ magma_int_t magma_ztrevc3_mt(
                     *VR(k,is) = c_zero;
                 }
             }
-            else if ( version == 1 ) {
+            else {
                 // ------------------------------
                 // version 1: back-transform each vector with GEMV, Q*x.
                 queue.sync();
@@ -478,51 +1105,6 @@ magma_int_t magma_ztrevc3_mt(
                 blasf77_zdscal( &n, &remax, VR(0,ki), &ione );
                 timer_start( time_trsv );
             }
-            else if ( version == 2 ) {
-                // ------------------------------
-                // version 2: back-transform block of vectors with GEMM
-                // zero out below vector
-                for( k=ki+1; k < n; ++k ) {
-                    *work(k,iv) = c_zero;
-                }
-
-                // Columns iv:nb of work are valid vectors.
-                // When the number of vectors stored reaches nb,
-                // or if this was last vector, do the GEMM
-                if ( (iv == 1) || (ki == 0) ) {
-                    queue.sync();
-                    time_trsv_sum += timer_stop( time_trsv );
-                    timer_start( time_gemm );
-                    nb2 = nb-iv+1;
-                    n2  = ki+nb-iv+1;
-                    
-                    // split gemm into multiple tasks, each doing one block row
-                    for( i=0; i < n; i += gemm_nb ) {
-                        magma_int_t ib = min( gemm_nb, n-i );
-                        queue.push_task( new zgemm_task(
-                            MagmaNoTrans, MagmaNoTrans, ib, nb2, n2, c_one,
-                            VR(i,0), ldvr,
-                            work(0,iv   ), n, c_zero,
-                            work(i,nb+iv), n ));
-                    }
-                    queue.sync();
-                    time_gemm_sum += timer_stop( time_gemm );
-                    
-                    // normalize vectors
-                    // TODO if somev, should copy vectors individually to correct location.
-                    for( k = iv; k <= nb; ++k ) {
-                        ii = blasf77_izamax( &n, work(0,nb+k), &ione ) - 1;
-                        remax = 1. / MAGMA_Z_ABS1( *work(ii,nb+k) );
-                        blasf77_zdscal( &n, &remax, work(0,nb+k), &ione );
-                    }
-                    lapackf77_zlacpy( "F", &n, &nb2, work(0,nb+iv), &n, VR(0,ki), &ldvr );
-                    iv = nb;
-                    timer_start( time_trsv );
-                }
-                else {
-                    iv -= 1;
-                }
-            } // blocked back-transform
 
             is -= 1;
         }
@@ -530,15 +1112,13 @@ magma_int_t magma_ztrevc3_mt(
     timer_stop( time_trsv );
     
     timer_stop( time_total );
-    timer_printf( "trevc trsv %.4f, gemm %.4f, gemv %.4f, total %.4f\n",
-                  time_trsv_sum, time_gemm_sum, time_gemv_sum, time_total );
+    timer_printf( "trevc trsv %.4f, gemv %.4f, total %.4f\n",
+                  time_trsv_sum, time_gemv_sum, time_total );
 
-    if ( leftv ) {
+    if ( leftv && version == 1 ) {
         // ============================================================
         // Compute left eigenvectors.
-        // iv is index of column in current block.
-        // Non-blocked version always uses iv=1;
-        // blocked     version starts with iv=1, goes up to nb.
+        // Non-blocked version uses column iv=1 of work.
         // (Note the "0-th" column is used to store the original diagonal.)
         iv = 1;
         is = 0;
@@ -567,7 +1147,7 @@ magma_int_t magma_ztrevc3_mt(
                 queue.push_task( new magma_zlatrsd_task(
                     MagmaUpper, MagmaConjTrans, MagmaNonUnit, MagmaTrue,
                     n2, T(ki+1,ki+1), ldt, *T(ki,ki),
-                    work(ki+1,iv), work(ki,iv), rwork ));
+                    work(ki+1,iv), work(ki,iv), rwork, &latrs_info ));
             }
             
             // Copy the vector x or Q*x to VL and normalize.
@@ -586,7 +1166,7 @@ magma_int_t magma_ztrevc3_mt(
                     *VL(k,is) = c_zero;
                 }
             }
-            else if ( version == 1 ) {
+            else {
                 // ------------------------------
                 // version 1: back-transform each vector with GEMV, Q*x.
                 queue.sync();
@@ -601,45 +1181,6 @@ magma_int_t magma_ztrevc3_mt(
                 remax = 1. / MAGMA_Z_ABS1( *VL(ii,ki) );
                 blasf77_zdscal( &n, &remax, VL(0,ki), &ione );
             }
-            else if ( version == 2 ) {
-                // ------------------------------
-                // version 2: back-transform block of vectors with GEMM
-                // zero out above vector
-                // could go from (ki+1)-NV+1 to ki
-                for( k=0; k < ki; ++k ) {
-                    *work(k,iv) = c_zero;
-                }
-        
-                // Columns 1:iv of work are valid vectors.
-                // When the number of vectors stored reaches nb,
-                // or if this was last vector, do the GEMM
-                if ( (iv == nb) || (ki == n-1) ) {
-                    queue.sync();
-                    n2 = n-(ki+1)+iv;
-                    
-                    // split gemm into multiple tasks, each doing one block row
-                    for( i=0; i < n; i += gemm_nb ) {
-                        magma_int_t ib = min( gemm_nb, n-i );
-                        queue.push_task( new zgemm_task(
-                            MagmaNoTrans, MagmaNoTrans, ib, iv, n2, c_one,
-                            VL(i,ki-iv+1), ldvl,
-                            work(ki-iv+1,1), n, c_zero,
-                            work(i,nb+1), n ));
-                    }
-                    queue.sync();
-                    // normalize vectors
-                    for( k=1; k <= iv; ++k ) {
-                        ii = blasf77_izamax( &n, work(0,nb+k), &ione ) - 1;
-                        remax = 1. / MAGMA_Z_ABS1( *work(ii,nb+k) );
-                        blasf77_zdscal( &n, &remax, work(0,nb+k), &ione );
-                    }
-                    lapackf77_zlacpy( "F", &n, &iv, work(0,nb+1), &n, VL(0,ki-iv+1), &ldvl );
-                    iv = 1;
-                }
-                else {
-                    iv += 1;
-                }
-            } // blocked back-transform
         
             is += 1;
         }
@@ -649,5 +1190,9 @@ magma_int_t magma_ztrevc3_mt(
     queue.quit();
     magma_set_lapack_numthreads( lapack_nthread );
     
+    if ( *info == 0 && latrs_info != 0 ) {
+        *info = MAGMA_ERR_ILLEGAL_VALUE;
+    }
+    
     return *info;
 }  // End of ZTREVC
@@ -682,8 +682,10 @@ void magma_generate_matrix(
     magma_int_t minmn = min( A.m, A.n );
 
     // ----------
-    // set sigma to unknown (nan)
-    lapack::laset( "general", sigma.n, 1, nan, nan, sigma(0), sigma.n );
+    // set sigma to unknown (nan), unless it was specified on input
+    if (! contains( name, "_specified" )) {
+        lapack::laset( "general", sigma.n, 1, nan, nan, sigma(0), sigma.n );
+    }
 
     // ----- decode matrix type
     MatrixType type = MatrixType::identity;
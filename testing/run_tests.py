@@ -968,6 +968,10 @@ syev = (
 	('testing_zheevd',        '--version 4 --fraction 1.0 -L -JV -c',  n,    ''),
 	('testing_zheevd',        '--version 4 --fraction 1.0 -U -JV -c',  n,    ''),
 
+	# MRRR tridiagonal solver, all and subsets of eigenvalues
+	('testing_zstemr',        '-c',                  n,    ''),
+	('testing_zstemr',        '--fraction 0.1,0.5 -c',  n,    ''),
+
 	# lower/upper
 	('testing_zhetrd',          '-L     -c',  n,    ''),
 	('testing_zhetrd',          '-U     -c',  n,    ''),
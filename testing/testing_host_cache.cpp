@@ -0,0 +1,119 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing the host memory cache
+   Times allocating, zeroing, and freeing an M-by-N workspace with
+   magma_zmalloc_cpu and magma_zmalloc_pinned, as drivers do on every call,
+   with the cache disabled and enabled.
+   The check compares the number of cache hits with the number of
+   repetitions, and the alignment of the blocks.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    real_Double_t   cpu_off, cpu_on, pin_off, pin_on;
+    magmaDoubleComplex *A;
+    magma_host_cache_stats_t cpu0, pin0, cpu1, pin1;
+    magma_int_t M, N, mn, r, nrep = 20;
+    size_t bytes;
+    int status = 0;
+
+    magma_opts opts;
+    opts.parse_opts( argc, argv );
+
+    magma_int_t enabled_save = magma_host_cache_get_enabled();
+
+    printf("%%   M     N   CPU off (ms)   CPU on (ms)   pinned off (ms)   pinned on (ms)   hits CPU   hits pinned\n");
+    printf("%%===============================================================================================\n");
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            M  = opts.msize[itest];
+            N  = opts.nsize[itest];
+            mn = M*N;
+            bytes = mn * sizeof(magmaDoubleComplex);
+            bool okay = true;
+
+            // without the cache, every allocation gets fresh pages
+            magma_host_cache_set_enabled( false );
+            cpu_off = magma_wtime();
+            for (r = 0; r < nrep; ++r) {
+                TESTING_CHECK( magma_zmalloc_cpu( &A, mn ));
+                memset( A, 0, bytes );
+                magma_free_cpu( A );
+            }
+            cpu_off = (magma_wtime() - cpu_off) / nrep;
+
+            pin_off = magma_wtime();
+            for (r = 0; r < nrep; ++r) {
+                TESTING_CHECK( magma_zmalloc_pinned( &A, mn ));
+                memset( A, 0, bytes );
+                magma_free_pinned( A );
+            }
+            pin_off = (magma_wtime() - pin_off) / nrep;
+
+            // with the cache, all but the first allocation reuse the block
+            magma_host_cache_set_enabled( true );
+            magma_host_cache_get_stats( &cpu0, &pin0 );
+            cpu_on = magma_wtime();
+            for (r = 0; r < nrep; ++r) {
+                TESTING_CHECK( magma_zmalloc_cpu( &A, mn ));
+                okay = okay && (uintptr_t( A ) % 64 == 0);
+                memset( A, 0, bytes );
+                magma_free_cpu( A );
+            }
+            cpu_on = (magma_wtime() - cpu_on) / nrep;
+
+            pin_on = magma_wtime();
+            for (r = 0; r < nrep; ++r) {
+                TESTING_CHECK( magma_zmalloc_pinned( &A, mn ));
+                memset( A, 0, bytes );
+                magma_free_pinned( A );
+            }
+            pin_on = (magma_wtime() - pin_on) / nrep;
+            magma_host_cache_get_stats( &cpu1, &pin1 );
+
+            long long cpu_hits = cpu1.hits - cpu0.hits;
+            long long pin_hits = pin1.hits - pin0.hits;
+            okay = okay && cpu_hits >= nrep - 1 && pin_hits >= nrep - 1
+                        && cpu1.bytes_in_use == cpu0.bytes_in_use
+                        && pin1.bytes_in_use == pin0.bytes_in_use;
+            status += ! okay;
+
+            printf("%5lld %5lld   %12.3f   %11.3f   %15.3f   %14.3f   %8lld   %11lld   %s\n",
+                   (long long) M, (long long) N,
+                   cpu_off*1e3, cpu_on*1e3, pin_off*1e3, pin_on*1e3,
+                   cpu_hits, pin_hits, (okay ? "ok" : "failed"));
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    magma_host_cache_get_stats( &cpu1, &pin1 );
+    printf( "%% peak cached + in use: CPU %.1f MiB, pinned %.1f MiB\n",
+            cpu1.peak_bytes / 1048576., pin1.peak_bytes / 1048576. );
+    magma_host_cache_set_enabled( enabled_save );
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
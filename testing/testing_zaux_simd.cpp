@@ -0,0 +1,164 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "magma_operators.h"
+#include "testings.h"
+#include "../control/magma_simd.h"  // internal header
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing the vectorised host auxiliary kernels
+   Times dzasum, dznrm2, zdotc, znan_inf, and zpanel_to_q + zq_to_panel on an
+   M-by-N matrix, treated as a vector of M*N elements for the BLAS-1 routines,
+   at each instruction set the CPU supports, in GB/s of data read.
+   The check compares each level with the scalar kernels, and the NAN/INF
+   counts with the number injected.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    real_Double_t   time, asum_bw, nrm2_bw, dot_bw, nan_bw, panel_bw;
+    double          asum_ref, nrm2_ref, asum, nrm2, error, bytes;
+    magmaDoubleComplex dot_ref, dot;
+    magmaDoubleComplex *A, *B, *Acopy, *work;
+    magma_int_t M, N, mn, lda, ib, cnt_nan, cnt_inf, nrep, r;
+    magma_int_t ione     = 1;
+    magma_int_t ISEED[4] = {0,0,0,1};
+    int status = 0;
+
+    magma_opts opts;
+    opts.parse_opts( argc, argv );
+    double tol = opts.tolerance * lapackf77_dlamch("E");
+
+    magma_simd_t max_level = magma_simd_get_max_level();
+    magma_simd_t level_save = magma_simd_get_level();
+
+    printf("%% max ISA = %s\n", magma_simd_name( max_level ));
+    printf("%%   M     N   ISA      asum GB/s   nrm2 GB/s   dotc GB/s   nan_inf GB/s   panel GB/s   error\n");
+    printf("%%=============================================================================================\n");
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            M   = opts.msize[itest];
+            N   = opts.nsize[itest];
+            lda = M;
+            mn  = M*N;
+            ib  = min( M, N );
+            // repeat short kernels so each timing covers about 1 GB
+            nrep = max( 1, magma_int_t( 1e9 / (mn*sizeof(magmaDoubleComplex) + 1) ));
+            nrep = min( nrep, 1000 );
+
+            TESTING_CHECK( magma_zmalloc_cpu( &A,     mn ));
+            TESTING_CHECK( magma_zmalloc_cpu( &B,     mn ));
+            TESTING_CHECK( magma_zmalloc_cpu( &Acopy, mn ));
+            TESTING_CHECK( magma_zmalloc_cpu( &work,  ib*ib ));
+
+            lapackf77_zlarnv( &ione, ISEED, &mn, A );
+            lapackf77_zlarnv( &ione, ISEED, &mn, B );
+
+            // reference results from the scalar kernels
+            magma_simd_set_level( MagmaSimdScalar );
+            asum_ref = magma_cblas_dzasum( mn, A, ione );
+            nrm2_ref = magma_cblas_dznrm2( mn, A, ione );
+            dot_ref  = magma_cblas_zdotc( mn, A, ione, B, ione );
+
+            for( int lvl = MagmaSimdScalar; lvl <= max_level; ++lvl ) {
+                magma_simd_set_level( magma_simd_t( lvl ));
+
+                time = magma_wtime();
+                for (r = 0; r < nrep; ++r) {
+                    asum = magma_cblas_dzasum( mn, A, ione );
+                }
+                time = magma_wtime() - time;
+                bytes = double( nrep ) * mn * sizeof(magmaDoubleComplex);
+                asum_bw = bytes / time / 1e9;
+
+                time = magma_wtime();
+                for (r = 0; r < nrep; ++r) {
+                    nrm2 = magma_cblas_dznrm2( mn, A, ione );
+                }
+                time = magma_wtime() - time;
+                nrm2_bw = bytes / time / 1e9;
+
+                time = magma_wtime();
+                for (r = 0; r < nrep; ++r) {
+                    dot = magma_cblas_zdotc( mn, A, ione, B, ione );
+                }
+                time = magma_wtime() - time;
+                dot_bw = 2 * bytes / time / 1e9;
+
+                error = 0;
+                if (mn > 0) {
+                    error = fabs( asum - asum_ref ) / asum_ref;
+                    error = max( error, fabs( nrm2 - nrm2_ref ) / nrm2_ref );
+                    error = max( error, MAGMA_Z_ABS( dot - dot_ref ) / (nrm2_ref * magma_cblas_dznrm2( mn, B, ione )) );
+                }
+
+                // inject a NAN and an INF, if there is room
+                lapackf77_zlacpy( "Full", &M, &N, A, &lda, Acopy, &lda );
+                magma_int_t expect = 0;
+                if (mn >= 2) {
+                    Acopy[ mn/3   ] = MAGMA_Z_NAN;
+                    Acopy[ mn - 1 ] = MAGMA_Z_INF;
+                    expect = 2;
+                }
+                time = magma_wtime();
+                for (r = 0; r < nrep; ++r) {
+                    magma_znan_inf( MagmaFull, M, N, Acopy, lda, &cnt_nan, &cnt_inf );
+                }
+                time = magma_wtime() - time;
+                nan_bw = bytes / time / 1e9;
+                bool okay = (error < tol && cnt_nan + cnt_inf == expect);
+
+                // panel_to_q and q_to_panel each read and write the ib-by-ib triangle
+                lapackf77_zlacpy( "Full", &M, &N, A, &lda, Acopy, &lda );
+                time = magma_wtime();
+                for (r = 0; r < nrep; ++r) {
+                    magma_zpanel_to_q( MagmaLower, ib, Acopy, lda, work );
+                    magma_zq_to_panel( MagmaLower, ib, Acopy, lda, work );
+                }
+                time = magma_wtime() - time;
+                panel_bw = 4 * double( nrep ) * ib*(ib+1)/2 * sizeof(magmaDoubleComplex) / time / 1e9;
+                for (magma_int_t i = 0; i < mn; ++i) {
+                    okay = okay && MAGMA_Z_EQUAL( A[i], Acopy[i] );
+                }
+                status += ! okay;
+
+                printf("%5lld %5lld   %-6s   %9.2f   %9.2f   %9.2f   %12.2f   %10.2f   %8.2e   %s\n",
+                       (long long) M, (long long) N, magma_simd_name( magma_simd_t( lvl )),
+                       asum_bw, nrm2_bw, dot_bw, nan_bw, panel_bw,
+                       error, (okay ? "ok" : "failed"));
+            }
+            magma_simd_set_level( level_save );
+
+            magma_free_cpu( A );
+            magma_free_cpu( B );
+            magma_free_cpu( Acopy );
+            magma_free_cpu( work );
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
@@ -0,0 +1,196 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions mixed zc -> ds
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+#define PRECISION_z
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing zcheevd
+   Compares the mixed precision eigensolver, split into its single precision
+   eigensolver and refinement times, against magma_zheevd in double.
+   Reports the residual |A Z - Z W| / (N |A|) and orthogonality |I - Z^H Z| / N
+   that zcheevd returns, and |W - W_zheevd| / |A|, and checks that W is
+   in ascending order.
+   Besides the --matrix spectrum, each size is tested with spectra that
+   stress the refinement: degenerate (n-1 eigenvalues of modulus 1),
+   graded (geometric from 1 to 1/cond, random signs), clustered
+   (1 + (i%5)*1e-9, which single precision cannot separate), and multiple
+   (all 1, a rotated identity). On these, a fallback to magma_zheevd
+   (Iter < 0) is reported as failed.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    real_Double_t   dp_time, mp_time, mp_split[2];
+    magmaDoubleComplex *h_A, *h_R, *h_work, aux_work[1];
+    #if defined(PRECISION_z)
+    double *rwork, aux_rwork[1];
+    magma_int_t lrwork;
+    #endif
+    double *w1, *w2, resid[2], work[1], error;
+    magma_int_t *iwork, aux_iwork[1];
+    magma_int_t N, n2, lda, info, lwork, liwork, iter;
+    int status = 0;
+
+    printf("%% Epsilon(double): %8.6e\n"
+           "%% Epsilon(single): %8.6e\n\n",
+           lapackf77_dlamch("Epsilon"), lapackf77_slamch("Epsilon") );
+
+    magma_opts opts;
+    opts.parse_opts( argc, argv );
+
+    double tol = opts.tolerance * lapackf77_dlamch("E");
+
+    std::string matrix_save = opts.matrix;
+    const char* matrices[] = { matrix_save.c_str(), "heev_cluster1", "heev_geo", "heev_specified", "heev_specified" };
+    const char* labels[]   = { matrix_save.c_str(), "heev_cluster1", "heev_geo", "clustered", "multiple" };
+
+    printf("%% uplo = %s\n", lapack_uplo_const(opts.uplo) );
+    printf("%%   N   DP Time (sec)   MP Time (sec)   SP-Eig   Refine  Iter   |AZ-ZW|    |I-Z^H Z|  |W-W_dp|    matrix\n");
+    printf("%%==============================================================================================================\n");
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int imat = 0; imat < 5; ++imat ) {
+            // the generated spectra need N >= 2
+            if ( imat > 0 && opts.nsize[itest] < 2 )
+                continue;
+            for( int iter_ = 0; iter_ < opts.niter; ++iter_ ) {
+                N   = opts.nsize[itest];
+                lda = N;
+                n2  = lda*N;
+
+                magma_zheevd( MagmaVec, opts.uplo,
+                              N, NULL, lda, NULL,  // A, w
+                              aux_work,  -1,
+                              #if defined(PRECISION_z)
+                              aux_rwork, -1,
+                              #endif
+                              aux_iwork, -1,
+                              &info );
+                lwork  = (magma_int_t) MAGMA_Z_REAL( aux_work[0] );
+                #if defined(PRECISION_z)
+                lrwork = (magma_int_t) aux_rwork[0];
+                #endif
+                liwork = aux_iwork[0];
+
+                TESTING_CHECK( magma_zmalloc_cpu( &h_A, n2 ));
+                TESTING_CHECK( magma_dmalloc_cpu( &w1,  N  ));
+                TESTING_CHECK( magma_dmalloc_cpu( &w2,  N  ));
+                TESTING_CHECK( magma_imalloc_cpu( &iwork, liwork ));
+                TESTING_CHECK( magma_zmalloc_pinned( &h_R,    n2    ));
+                TESTING_CHECK( magma_zmalloc_pinned( &h_work, lwork ));
+                #if defined(PRECISION_z)
+                TESTING_CHECK( magma_dmalloc_pinned( &rwork, lrwork ));
+                #endif
+
+                /* Initialize the matrix */
+                opts.matrix = matrices[imat];
+                if (imat == 3) {
+                    for (int j=0; j < N; j++) {
+                        w2[j] = 1 + (j % 5) * 1e-9;
+                    }
+                }
+                else if (imat == 4) {
+                    for (int j=0; j < N; j++) {
+                        w2[j] = 1;
+                    }
+                }
+                magma_generate_matrix( opts, N, N, h_A, lda, w2 );
+                magma_zmake_hermitian( N, h_A, lda );
+                lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_R, &lda );
+
+                /* ====================================================================
+                   Performs operation using mixed precision MAGMA
+                   =================================================================== */
+                mp_time = magma_wtime();
+                magma_zcheevd( opts.uplo, N, h_R, lda, w1,
+                               resid, mp_split, &iter, &info );
+                mp_time = magma_wtime() - mp_time;
+                if (info != 0) {
+                    printf("magma_zcheevd returned error %lld: %s.\n",
+                           (long long) info, magma_strerror( info ));
+                }
+
+                /* ====================================================================
+                   Performs operation using double precision MAGMA
+                   =================================================================== */
+                lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_R, &lda );
+                dp_time = magma_wtime();
+                magma_zheevd( MagmaVec, opts.uplo,
+                              N, h_R, lda, w2,
+                              h_work, lwork,
+                              #if defined(PRECISION_z)
+                              rwork, lrwork,
+                              #endif
+                              iwork, liwork,
+                              &info );
+                dp_time = magma_wtime() - dp_time;
+                if (info != 0) {
+                    printf("magma_zheevd returned error %lld: %s.\n",
+                           (long long) info, magma_strerror( info ));
+                }
+
+                /* =====================================================================
+                   Check the eigenvalues against double precision
+                   =================================================================== */
+                double Anorm = safe_lapackf77_zlanhe( "Fro", lapack_uplo_const(opts.uplo),
+                                                      &N, h_A, &lda, work );
+                Anorm = (Anorm > 0 ? Anorm : 1);
+                error = 0;
+                bool sorted = true;
+                for (int j=0; j < N; j++) {
+                    error = max( error, fabs( w1[j] - w2[j] ) );
+                    sorted = sorted && (j == 0 || w1[j-1] <= w1[j]);
+                }
+                error /= Anorm;
+
+                // the refinement must not fall back on the generated spectra
+                bool refined = (imat == 0 || iter >= 0);
+                bool okay = (resid[0] < tol && resid[1] < tol && error < tol && sorted && refined);
+                status += ! okay;
+
+                printf("%5lld   %9.4f       %9.4f     %7.4f  %7.4f  %4lld   %8.2e   %8.2e   %8.2e   %-14s   %s\n",
+                       (long long) N, dp_time, mp_time, mp_split[0], mp_split[1],
+                       (long long) iter, resid[0], resid[1], error, labels[imat],
+                       (okay ? "ok" : (sorted ? "failed" : "unsorted")));
+
+                magma_free_cpu( h_A );
+                magma_free_cpu( w1  );
+                magma_free_cpu( w2  );
+                magma_free_cpu( iwork );
+                magma_free_pinned( h_R    );
+                magma_free_pinned( h_work );
+                #if defined(PRECISION_z)
+                magma_free_pinned( rwork );
+                #endif
+                fflush( stdout );
+            }
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+    opts.matrix = matrix_save;
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
@@ -0,0 +1,301 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "flops.h"
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+#if defined(_OPENMP)
+#include <omp.h>
+#include "../control/magma_threadsetting.h"  // internal header
+#endif
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing zgemm_vbatched_cpu
+   Compares the host variable-size batched GEMM against looped CPU BLAS, one
+   problem per thread. Sizes follow a skewed distribution, typical of sparse
+   direct solvers and block-low-rank codes: most problems are tiny
+   (up to 16), some are medium (up to M/4, N/4, K/4), and a few have the
+   maximum size M, N, K. Problem 0 always has the maximum size.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    real_Double_t   gflops, magma_perf, magma_time, cpu_perf = 0, cpu_time = 0;
+    double          error, magma_error, normalize, work[1];
+    magma_int_t M, N, K;
+    magma_int_t *Am, *An, *Bm, *Bn;
+    magma_int_t total_size_A = 0, total_size_B = 0, total_size_C = 0;
+    magma_int_t ione     = 1;
+    magma_int_t ISEED[4] = {0,0,0,1};
+    int status = 0;
+    magma_int_t batchCount;
+    magma_int_t max_M, max_N, max_K, ntiny, nlarge;
+
+    magmaDoubleComplex *h_A, *h_B, *h_C, *h_Cmagma;
+    magmaDoubleComplex *h_A_tmp, *h_B_tmp, *h_C_tmp, *h_Cmagma_tmp;
+    magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    magmaDoubleComplex alpha = MAGMA_Z_MAKE(  0.29, -0.86 );
+    magmaDoubleComplex beta  = MAGMA_Z_MAKE( -0.48,  0.38 );
+    magmaDoubleComplex **h_A_array = NULL;
+    magmaDoubleComplex **h_B_array = NULL;
+    magmaDoubleComplex **h_C_array = NULL;
+    magmaDoubleComplex **h_Cmagma_array = NULL;
+
+    magma_int_t *h_M, *h_N, *h_K;
+    magma_int_t *h_lda, *h_ldb, *h_ldc;
+
+    magma_opts opts( MagmaOptsBatched );
+    opts.parse_opts( argc, argv );
+    opts.lapack |= opts.check; // check (-c) implies lapack (-l)
+    batchCount = opts.batchcount;
+
+    TESTING_CHECK( magma_imalloc_cpu(&h_M, batchCount) );
+    TESTING_CHECK( magma_imalloc_cpu(&h_N, batchCount) );
+    TESTING_CHECK( magma_imalloc_cpu(&h_K, batchCount) );
+    TESTING_CHECK( magma_imalloc_cpu(&h_lda, batchCount) );
+    TESTING_CHECK( magma_imalloc_cpu(&h_ldb, batchCount) );
+    TESTING_CHECK( magma_imalloc_cpu(&h_ldc, batchCount) );
+
+    double *Anorm, *Bnorm, *Cnorm;
+    TESTING_CHECK( magma_dmalloc_cpu( &Anorm, batchCount ));
+    TESTING_CHECK( magma_dmalloc_cpu( &Bnorm, batchCount ));
+    TESTING_CHECK( magma_dmalloc_cpu( &Cnorm, batchCount ));
+
+    TESTING_CHECK( magma_malloc_cpu((void**)&h_A_array, batchCount*sizeof(magmaDoubleComplex*)) );
+    TESTING_CHECK( magma_malloc_cpu((void**)&h_B_array, batchCount*sizeof(magmaDoubleComplex*)) );
+    TESTING_CHECK( magma_malloc_cpu((void**)&h_C_array, batchCount*sizeof(magmaDoubleComplex*)) );
+    TESTING_CHECK( magma_malloc_cpu((void**)&h_Cmagma_array, batchCount*sizeof(magmaDoubleComplex*)) );
+
+    // See testing_zgemm about tolerance.
+    double eps = lapackf77_dlamch("E");
+    double tol = 3*eps;
+
+    printf("%% If running lapack (option --lapack), MAGMA error is computed\n"
+           "%% relative to CPU BLAS result.\n\n"
+           "%% transA = %s, transB = %s\n",
+           lapack_trans_const(opts.transA),
+           lapack_trans_const(opts.transB));
+
+    printf("%%                               max   max   max\n");
+    printf("%% BatchCount  #tiny  #large     M     N     K   MAGMA Gflop/s (ms)   CPU Gflop/s (ms)   MAGMA error\n");
+    printf("%%==================================================================================================\n");
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            M = opts.msize[itest];
+            N = opts.nsize[itest];
+            K = opts.ksize[itest];
+
+            if ( opts.transA == MagmaNoTrans ) {
+                Am = h_M;
+                An = h_K;
+            }
+            else {
+                Am = h_K;
+                An = h_M;
+            }
+            if ( opts.transB == MagmaNoTrans ) {
+                Bm = h_K;
+                Bn = h_N;
+            }
+            else {
+                Bm = h_N;
+                Bn = h_K;
+            }
+
+            // guarantee reproducible sizes
+            srand(1000);
+
+            gflops = 0;
+            max_M = max_N = max_K = 0;
+            ntiny = nlarge = 0;
+            total_size_A = total_size_B = total_size_C = 0;
+
+            for (int i = 0; i < batchCount; i++) {
+                // 90% tiny, 9% medium, 1% large
+                int r = (i == 0 ? 99 : rand() % 100);
+                if (r < 90) {
+                    h_M[i] = 1 + (rand() % min( M, 16 ));
+                    h_N[i] = 1 + (rand() % min( N, 16 ));
+                    h_K[i] = 1 + (rand() % min( K, 16 ));
+                    ntiny++;
+                }
+                else if (r < 99) {
+                    h_M[i] = 1 + (rand() % max( 1, M/4 ));
+                    h_N[i] = 1 + (rand() % max( 1, N/4 ));
+                    h_K[i] = 0 + (rand() % max( 1, K/4 ));
+                }
+                else {
+                    h_M[i] = M;
+                    h_N[i] = N;
+                    h_K[i] = K;
+                    nlarge++;
+                }
+                max_M = max( max_M, h_M[i] );
+                max_N = max( max_N, h_N[i] );
+                max_K = max( max_K, h_K[i] );
+
+                gflops += FLOPS_ZGEMM( h_M[i], h_N[i], h_K[i] ) / 1e9;
+
+                h_lda[i] = max(1, Am[i]);
+                h_ldb[i] = max(1, Bm[i]);
+                h_ldc[i] = max(1, h_M[i]);
+
+                total_size_A += An[i] * h_lda[i];
+                total_size_B += Bn[i] * h_ldb[i];
+                total_size_C += h_N[i] * h_ldc[i];
+            }
+
+            TESTING_CHECK( magma_zmalloc_cpu(&h_A,  total_size_A) );
+            TESTING_CHECK( magma_zmalloc_cpu(&h_B,  total_size_B) );
+            TESTING_CHECK( magma_zmalloc_cpu(&h_C,  total_size_C) );
+            TESTING_CHECK( magma_zmalloc_cpu(&h_Cmagma, total_size_C) );
+
+            /* Initialize the matrices */
+            lapackf77_zlarnv( &ione, ISEED, &total_size_A, h_A );
+            lapackf77_zlarnv( &ione, ISEED, &total_size_B, h_B );
+            lapackf77_zlarnv( &ione, ISEED, &total_size_C, h_C );
+            lapackf77_zlacpy( MagmaFullStr, &total_size_C, &ione, h_C, &total_size_C, h_Cmagma, &total_size_C );
+
+            // Compute norms for error
+            h_A_tmp = h_A;
+            h_B_tmp = h_B;
+            h_C_tmp = h_C;
+            h_Cmagma_tmp = h_Cmagma;
+            for (int s = 0; s < batchCount; ++s) {
+                Anorm[s] = lapackf77_zlange( "F",  &Am[s],  &An[s], h_A_tmp, &h_lda[s], work );
+                Bnorm[s] = lapackf77_zlange( "F",  &Bm[s],  &Bn[s], h_B_tmp, &h_ldb[s], work );
+                Cnorm[s] = lapackf77_zlange( "F", &h_M[s], &h_N[s], h_C_tmp, &h_ldc[s], work );
+                h_A_array[s]      = h_A_tmp;
+                h_B_array[s]      = h_B_tmp;
+                h_C_array[s]      = h_C_tmp;
+                h_Cmagma_array[s] = h_Cmagma_tmp;
+                h_A_tmp      +=  An[s] * h_lda[s];
+                h_B_tmp      +=  Bn[s] * h_ldb[s];
+                h_C_tmp      += h_N[s] * h_ldc[s];
+                h_Cmagma_tmp += h_N[s] * h_ldc[s];
+            }
+
+            /* =====================================================================
+               Performs operation using MAGMA
+               =================================================================== */
+            magma_time = magma_wtime();
+            blas_zgemm_vbatched( opts.transA, opts.transB,
+                                 h_M, h_N, h_K,
+                                 alpha, h_A_array, h_lda,
+                                        h_B_array, h_ldb,
+                                 beta,  h_Cmagma_array, h_ldc,
+                                 batchCount );
+            magma_time = magma_wtime() - magma_time;
+            magma_perf = gflops / magma_time;
+
+            /* =====================================================================
+               Performs operation using CPU BLAS
+               =================================================================== */
+            if ( opts.lapack ) {
+                cpu_time = magma_wtime();
+                #if defined(_OPENMP)
+                magma_int_t nthreads = magma_get_lapack_numthreads();
+                magma_set_lapack_numthreads(1);
+                magma_set_omp_numthreads(nthreads);
+                #pragma omp parallel for schedule(dynamic)
+                #endif
+                for (magma_int_t s=0; s < batchCount; s++)
+                {
+                    blasf77_zgemm( lapack_trans_const(opts.transA),
+                                   lapack_trans_const(opts.transB),
+                                   &h_M[s], &h_N[s], &h_K[s],
+                                   &alpha, h_A_array[s], &h_lda[s],
+                                           h_B_array[s], &h_ldb[s],
+                                   &beta,  h_C_array[s], &h_ldc[s] );
+                }
+                #if defined(_OPENMP)
+                magma_set_lapack_numthreads(nthreads);
+                #endif
+                cpu_time = magma_wtime() - cpu_time;
+                cpu_perf = gflops / cpu_time;
+            }
+
+            /* =====================================================================
+               Check the result
+               =================================================================== */
+            if ( opts.lapack ) {
+                // error = |dC - C| / (gamma_{k+2}|A||B| + gamma_2|Cin|)
+                magma_error = 0;
+
+                for (int s=0; s < batchCount; s++) {
+                    normalize = sqrt(double(h_K[s]+2))*Anorm[s]*Bnorm[s] + 2*Cnorm[s];
+                    if (normalize == 0)
+                        normalize = 1;
+                    magma_int_t Csize = h_ldc[s] * h_N[s];
+                    blasf77_zaxpy( &Csize, &c_neg_one, h_C_array[s], &ione, h_Cmagma_array[s], &ione );
+                    error = lapackf77_zlange( "F", &h_M[s], &h_N[s], h_Cmagma_array[s], &h_ldc[s], work )
+                          / normalize;
+                    magma_error = magma_max_nan( error, magma_error );
+                }
+
+                bool okay = (magma_error < tol);
+                status += ! okay;
+                printf("  %10lld %6lld %6lld %5lld %5lld %5lld   %7.2f (%7.2f)   %7.2f (%7.2f)   %8.2e   %s\n",
+                       (long long) batchCount, (long long) ntiny, (long long) nlarge,
+                       (long long) max_M, (long long) max_N, (long long) max_K,
+                       magma_perf,  1000.*magma_time,
+                       cpu_perf,    1000.*cpu_time,
+                       magma_error, (okay ? "ok" : "failed") );
+            }
+            else {
+                printf("  %10lld %6lld %6lld %5lld %5lld %5lld   %7.2f (%7.2f)     ---   (  ---  )     ---\n",
+                       (long long) batchCount, (long long) ntiny, (long long) nlarge,
+                       (long long) max_M, (long long) max_N, (long long) max_K,
+                       magma_perf,  1000.*magma_time);
+            }
+
+            magma_free_cpu( h_A  );
+            magma_free_cpu( h_B  );
+            magma_free_cpu( h_C  );
+            magma_free_cpu( h_Cmagma  );
+            fflush( stdout);
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    // free resources
+    magma_free_cpu( h_M );
+    magma_free_cpu( h_N );
+    magma_free_cpu( h_K );
+    magma_free_cpu( h_lda );
+    magma_free_cpu( h_ldb );
+    magma_free_cpu( h_ldc );
+
+    magma_free_cpu( Anorm );
+    magma_free_cpu( Bnorm );
+    magma_free_cpu( Cnorm );
+
+    magma_free_cpu( h_A_array  );
+    magma_free_cpu( h_B_array  );
+    magma_free_cpu( h_C_array  );
+    magma_free_cpu( h_Cmagma_array );
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
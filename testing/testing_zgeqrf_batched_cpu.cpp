@@ -0,0 +1,180 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "flops.h"
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+#if defined(_OPENMP)
+#include <omp.h>
+#include "../control/magma_threadsetting.h"  // internal header
+#endif
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing zgeqrf_batched_cpu
+   Compares the throughput (matrices/sec) of the host batched QR against
+   looped LAPACK, one matrix per thread. The check compares R and tau with
+   LAPACK's, as both compute the same Householder reflectors.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    real_Double_t    gflops, magma_perf, magma_time, cpu_perf = 0, cpu_time = 0;
+    double           error, Anorm, work[1];
+    magmaDoubleComplex  c_neg_one = MAGMA_Z_NEG_ONE;
+    magmaDoubleComplex *h_A, *h_Amagma, *tau, *tau_magma, *h_work;
+    magmaDoubleComplex **hA_array, **tau_array;
+    magma_int_t *info_magma;
+    magma_int_t M, N, n2, lda, lwork, info, min_mn;
+    magma_int_t ione     = 1;
+    magma_int_t ISEED[4] = {0,0,0,1};
+    int status = 0;
+
+    magma_opts opts( MagmaOptsBatched );
+    opts.parse_opts( argc, argv );
+    opts.lapack |= opts.check;  // check (-c) implies lapack (-l)
+    magma_int_t batchCount = opts.batchcount;
+    double tol = opts.tolerance * lapackf77_dlamch("E");
+
+    printf("%% BatchCount   M     N    CPU mat/s  Gflop/s (ms)      MAGMA mat/s  Gflop/s (ms)   ||A_magma - A_lapack||_1 / (N*||A||_1)\n");
+    printf("%%=================================================================================================================\n");
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            M      = opts.msize[itest];
+            N      = opts.nsize[itest];
+            min_mn = min(M, N);
+            lda    = M;
+            n2     = lda*N * batchCount;
+            gflops = (FLOPS_ZGEQRF( M, N ) + FLOPS_ZGEQRT( M, N )) / 1e9 * batchCount;
+
+            // workspace query
+            magmaDoubleComplex unused[1], tmp[1];
+            lwork = -1;
+            lapackf77_zgeqrf( &M, &N, unused, &M, unused, tmp, &lwork, &info );
+            lwork = (magma_int_t)MAGMA_Z_REAL( tmp[0] );
+
+            TESTING_CHECK( magma_imalloc_cpu( &info_magma, batchCount ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_A,        n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_Amagma,   n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &tau,        min_mn * batchCount ));
+            TESTING_CHECK( magma_zmalloc_cpu( &tau_magma,  min_mn * batchCount ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_work,     lwork  * batchCount ));
+            TESTING_CHECK( magma_malloc_cpu( (void**) &hA_array,  batchCount * sizeof(magmaDoubleComplex*) ));
+            TESTING_CHECK( magma_malloc_cpu( (void**) &tau_array, batchCount * sizeof(magmaDoubleComplex*) ));
+
+            /* Initialize the matrix */
+            lapackf77_zlarnv( &ione, ISEED, &n2, h_A );
+            magma_int_t columns = N * batchCount;
+            lapackf77_zlacpy( MagmaFullStr, &M, &columns, h_A, &lda, h_Amagma, &lda );
+            for (int i=0; i < batchCount; i++) {
+                hA_array[i]  = h_Amagma  + i * lda * N;
+                tau_array[i] = tau_magma + i * min_mn;
+            }
+
+            /* ====================================================================
+               Performs operation using MAGMA
+               =================================================================== */
+            magma_time = magma_wtime();
+            info = magma_zgeqrf_batched_cpu( M, N, hA_array, lda, tau_array, info_magma, batchCount );
+            magma_time = magma_wtime() - magma_time;
+            magma_perf = gflops / magma_time;
+
+            if (info != 0) {
+                printf("magma_zgeqrf_batched_cpu returned error %lld: %s.\n",
+                       (long long) info, magma_strerror( info ));
+            }
+
+            if ( opts.lapack ) {
+                /* =====================================================================
+                   Performs operation using LAPACK
+                   =================================================================== */
+                cpu_time = magma_wtime();
+                #if defined(_OPENMP)
+                magma_int_t nthreads = magma_get_lapack_numthreads();
+                magma_set_lapack_numthreads(1);
+                magma_set_omp_numthreads(nthreads);
+                #pragma omp parallel for schedule(dynamic)
+                #endif
+                for (magma_int_t s=0; s < batchCount; s++) {
+                    magma_int_t locinfo;
+                    lapackf77_zgeqrf( &M, &N, h_A + s * lda * N, &lda, tau + s * min_mn,
+                                      h_work + s * lwork, &lwork, &locinfo );
+                    if (locinfo != 0) {
+                        printf("lapackf77_zgeqrf matrix %lld returned error %lld: %s.\n",
+                               (long long) s, (long long) locinfo, magma_strerror( locinfo ));
+                    }
+                }
+                #if defined(_OPENMP)
+                magma_set_lapack_numthreads(nthreads);
+                #endif
+                cpu_time = magma_wtime() - cpu_time;
+                cpu_perf = gflops / cpu_time;
+
+                /* =====================================================================
+                   Check the result compared to LAPACK
+                   =================================================================== */
+                error = 0;
+                for (int i=0; i < batchCount; i++) {
+                    double err;
+                    magmaDoubleComplex *Ai = h_A      + i * lda * N;
+                    magmaDoubleComplex *Bi = h_Amagma + i * lda * N;
+                    Anorm = lapackf77_zlange( "1", &M, &N, Ai, &lda, work );
+                    for (magma_int_t j=0; j < N; j++) {
+                        blasf77_zaxpy( &M, &c_neg_one, Ai + j*lda, &ione, Bi + j*lda, &ione );
+                    }
+                    blasf77_zaxpy( &min_mn, &c_neg_one, tau + i*min_mn, &ione, tau_magma + i*min_mn, &ione );
+                    err = lapackf77_zlange( "1", &M, &N, Bi, &lda, work ) / (N * Anorm)
+                        + lapackf77_zlange( "1", &min_mn, &ione, tau_magma + i*min_mn, &min_mn, work );
+                    error = magma_max_nan( err, error );
+                }
+                bool okay = (error < tol);
+                status += ! okay;
+
+                printf("%10lld %5lld %5lld   %9.3e %7.2f (%7.2f)   %9.3e %7.2f (%7.2f)   %8.2e   %s\n",
+                       (long long) batchCount, (long long) M, (long long) N,
+                       batchCount / cpu_time,   cpu_perf,   cpu_time*1000.,
+                       batchCount / magma_time, magma_perf, magma_time*1000.,
+                       error, (okay ? "ok" : "failed"));
+            }
+            else {
+                printf("%10lld %5lld %5lld     ---       ---   (  ---  )   %9.3e %7.2f (%7.2f)     ---\n",
+                       (long long) batchCount, (long long) M, (long long) N,
+                       batchCount / magma_time, magma_perf, magma_time*1000. );
+            }
+
+            magma_free_cpu( info_magma );
+            magma_free_cpu( h_A );
+            magma_free_cpu( h_Amagma );
+            magma_free_cpu( tau );
+            magma_free_cpu( tau_magma );
+            magma_free_cpu( h_work );
+            magma_free_cpu( hA_array );
+            magma_free_cpu( tau_array );
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
@@ -0,0 +1,289 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+#if defined(_OPENMP)
+#include <omp.h>
+#include "../control/magma_threadsetting.h"  // internal header
+#endif
+
+#define COMPLEX
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing zgesvdj_batched_cpu
+   Compares the throughput (matrices/sec) of the host batched one-sided
+   Jacobi SVD against looped LAPACK zgesvd, one matrix per thread.
+   The check compares the singular values with LAPACK's,
+   |S - S_lapack| / (min(M,N) |A|), and, with -JV,
+   computes the residual |A - U S V^H| / (min(M,N) |A|) and orthogonality
+   |I - U^H U| / M and |I - V^H V| / N.
+   Besides random matrices, each size is tested with rank-one matrices,
+   x y^H with random x and y, and the matrix of all ones, where all but one
+   column become negligible during the Jacobi sweeps.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    const magmaDoubleComplex c_zero    = MAGMA_Z_ZERO;
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+
+    real_Double_t   magma_time, cpu_time = 0;
+    magmaDoubleComplex *h_A, *h_R, *h_U, *h_V, *h_work, *h_VT, *h_T, *h_xy;
+    magmaDoubleComplex **hA_array = NULL, **hU_array = NULL, **hV_array = NULL;
+    double **hS_array = NULL;
+    magmaDoubleComplex aux_work[1];
+    double *h_S, *s_lapack;
+    #ifdef COMPLEX
+    double *rwork;
+    #endif
+    magma_int_t *info_magma;
+    magma_int_t M, N, min_mn, n2, lda, ldu, ldv, info, lwork, lquery = -1;
+    magma_int_t ione     = 1;
+    magma_int_t ISEED[4] = {0,0,0,1};
+    double      work[1], result[4];
+    int status = 0;
+
+    const char* matrices[] = { "rand", "rank1", "ones" };
+
+    magma_opts opts( MagmaOptsBatched );
+    opts.parse_opts( argc, argv );
+    opts.lapack |= opts.check;  // check (-c) implies lapack (-l)
+    magma_int_t batchCount = opts.batchcount;
+    double tol = opts.tolerance * lapackf77_dlamch("E");
+
+    printf("%% jobz = %s\n", lapack_vec_const(opts.jobz) );
+    printf("%% BatchCount   M     N    CPU mat/s (ms)        MAGMA mat/s (ms)     |S-S_lapack|   |A-USV^H|   |I-U^H U|  |I-V^H V|   matrix\n");
+    printf("%%==========================================================================================================================\n");
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            for( int imat = 0; imat < 3; ++imat ) {
+                M      = opts.msize[itest];
+                N      = opts.nsize[itest];
+                min_mn = min( M, N );
+                lda    = M;
+                ldu    = M;
+                ldv    = N;
+                n2     = lda* N  * batchCount;
+
+                // workspace for one matrix per thread of the LAPACK loop;
+                // LAPACK computes only singular values, for timing and comparison
+                magma_int_t nthreads = 1;
+                #if defined(_OPENMP)
+                nthreads = magma_get_lapack_numthreads();
+                #endif
+                lapackf77_zgesvd( "N", "N", &M, &N, NULL, &lda, NULL, NULL, &ione, NULL, &ione,
+                                  aux_work, &lquery,
+                                  #ifdef COMPLEX
+                                  NULL,
+                                  #endif
+                                  &info );
+                lwork = (magma_int_t) MAGMA_Z_REAL( aux_work[0] );
+
+                TESTING_CHECK( magma_imalloc_cpu( &info_magma, batchCount ));
+                TESTING_CHECK( magma_zmalloc_cpu( &h_A, n2 ));
+                TESTING_CHECK( magma_zmalloc_cpu( &h_R, n2 ));
+                TESTING_CHECK( magma_zmalloc_cpu( &h_U, ldu*min_mn*batchCount ));
+                TESTING_CHECK( magma_zmalloc_cpu( &h_V, ldv*min_mn*batchCount ));
+                TESTING_CHECK( magma_zmalloc_cpu( &h_VT, min_mn*N ));
+                TESTING_CHECK( magma_zmalloc_cpu( &h_T, max( M, N )*max( M, N ) ));
+                TESTING_CHECK( magma_zmalloc_cpu( &h_xy, M + N ));
+                TESTING_CHECK( magma_dmalloc_cpu( &h_S,      min_mn*batchCount ));
+                TESTING_CHECK( magma_dmalloc_cpu( &s_lapack, min_mn*batchCount ));
+                TESTING_CHECK( magma_zmalloc_cpu( &h_work, lwork * nthreads ));
+                #ifdef COMPLEX
+                TESTING_CHECK( magma_dmalloc_cpu( &rwork, 5*min_mn * nthreads ));
+                #endif
+                TESTING_CHECK( magma_malloc_cpu( (void**) &hA_array, batchCount * sizeof(magmaDoubleComplex*) ));
+                TESTING_CHECK( magma_malloc_cpu( (void**) &hU_array, batchCount * sizeof(magmaDoubleComplex*) ));
+                TESTING_CHECK( magma_malloc_cpu( (void**) &hV_array, batchCount * sizeof(magmaDoubleComplex*) ));
+                TESTING_CHECK( magma_malloc_cpu( (void**) &hS_array, batchCount * sizeof(double*) ));
+
+                /* Initialize the matrices */
+                magma_int_t columns = N * batchCount;
+                magma_int_t mn2 = M + N;
+                lapackf77_zlarnv( &ione, ISEED, &n2, h_A );
+                if (imat == 1) {
+                    for (int i=0; i < batchCount; i++) {
+                        lapackf77_zlarnv( &ione, ISEED, &mn2, h_xy );
+                        lapackf77_zlaset( MagmaFullStr, &M, &N, &c_zero, &c_zero, h_A + i * lda*N, &lda );
+                        blasf77_zgerc( &M, &N, &c_one, h_xy, &ione, h_xy + M, &ione, h_A + i * lda*N, &lda );
+                    }
+                }
+                else if (imat == 2) {
+                    lapackf77_zlaset( MagmaFullStr, &M, &columns, &c_one, &c_one, h_A, &lda );
+                }
+
+                lapackf77_zlacpy( MagmaFullStr, &M, &(columns), h_A, &lda, h_R, &lda );
+                for (int i=0; i < batchCount; i++) {
+                    hA_array[i] = h_R + i * lda * N;
+                    hU_array[i] = h_U + i * ldu * min_mn;
+                    hV_array[i] = h_V + i * ldv * min_mn;
+                    hS_array[i] = h_S + i * min_mn;
+                }
+
+                /* ====================================================================
+                   Performs operation using MAGMA
+                   =================================================================== */
+                magma_time = magma_wtime();
+                info = magma_zgesvdj_batched_cpu( opts.jobz, M, N, hA_array, lda, hS_array,
+                                                  hU_array, ldu, hV_array, ldv,
+                                                  info_magma, batchCount );
+                magma_time = magma_wtime() - magma_time;
+
+                for (int i=0; i < batchCount; i++) {
+                    if (info_magma[i] != 0 ) {
+                        printf("magma_zgesvdj_batched_cpu matrix %lld returned error %lld\n",
+                                (long long) i, (long long) info_magma[i] );
+                        status = -1;
+                    }
+                }
+                if (info != 0) {
+                    printf("magma_zgesvdj_batched_cpu returned argument error %lld: %s.\n",
+                            (long long) info, magma_strerror( info ));
+                    status = -1;
+                }
+                if (status == -1)
+                    goto cleanup;
+
+                if ( opts.lapack ) {
+                    /* =====================================================================
+                       Performs operation using LAPACK
+                       =================================================================== */
+                    lapackf77_zlacpy( MagmaFullStr, &M, &(columns), h_A, &lda, h_R, &lda );
+                    cpu_time = magma_wtime();
+                    #if defined(_OPENMP)
+                    magma_set_lapack_numthreads(1);
+                    magma_set_omp_numthreads(nthreads);
+                    #pragma omp parallel for schedule(dynamic)
+                    #endif
+                    for (magma_int_t s=0; s < batchCount; s++) {
+                        magma_int_t locinfo, t = 0;
+                        #if defined(_OPENMP)
+                        t = omp_get_thread_num();
+                        #endif
+                        lapackf77_zgesvd( "N", "N", &M, &N, h_R + s * lda * N, &lda, s_lapack + s * min_mn,
+                                          NULL, &ione, NULL, &ione,
+                                          h_work + t * lwork, &lwork,
+                                          #ifdef COMPLEX
+                                          rwork + t * 5*min_mn,
+                                          #endif
+                                          &locinfo );
+                        if (locinfo != 0) {
+                            printf("lapackf77_zgesvd matrix %lld returned error %lld: %s.\n",
+                                   (long long) s, (long long) locinfo, magma_strerror( locinfo ));
+                        }
+                    }
+                    #if defined(_OPENMP)
+                    magma_set_lapack_numthreads(nthreads);
+                    #endif
+                    cpu_time = magma_wtime() - cpu_time;
+
+                    /* =====================================================================
+                       Check the result compared to LAPACK
+                       =================================================================== */
+                    result[0] = result[1] = result[2] = result[3] = 0;
+                    for (int i=0; i < batchCount; i++) {
+                        magmaDoubleComplex *A = h_A + i * lda*N;
+                        magmaDoubleComplex *U = h_U + i * ldu*min_mn;
+                        magmaDoubleComplex *V = h_V + i * ldv*min_mn;
+                        double *S = h_S + i * min_mn;
+                        double Anorm = lapackf77_zlange( "1", &M, &N, A, &lda, work );
+                        Anorm = (Anorm > 0 ? Anorm : 1);
+                        for (int j=0; j < min_mn; j++) {
+                            result[0] = max( result[0], fabs( S[j] - s_lapack[i*min_mn + j] ) / (min_mn * Anorm) );
+                        }
+                        if (opts.jobz == MagmaVec) {
+                            // R = A - U S V^H, with VT = S V^H
+                            for (int j=0; j < min_mn; j++) {
+                                for (int k=0; k < N; k++) {
+                                    h_VT[j + k*min_mn] = MAGMA_Z_MUL( MAGMA_Z_MAKE( S[j], 0 ), MAGMA_Z_CONJ( V[k + j*ldv] ));
+                                }
+                            }
+                            magmaDoubleComplex *R = h_R + i * lda*N;
+                            lapackf77_zlacpy( MagmaFullStr, &M, &N, A, &lda, R, &lda );
+                            blasf77_zgemm( "N", "N", &M, &N, &min_mn,
+                                           &c_neg_one, U, &ldu, h_VT, &min_mn, &c_one, R, &lda );
+                            result[1] = max( result[1],
+                                lapackf77_zlange( "1", &M, &N, R, &lda, work ) / (min_mn * Anorm) );
+
+                            // T = I - U^H U
+                            lapackf77_zlaset( "Full", &min_mn, &min_mn, &c_zero, &c_one, h_T, &min_mn );
+                            blasf77_zgemm( "C", "N", &min_mn, &min_mn, &M,
+                                           &c_neg_one, U, &ldu, U, &ldu, &c_one, h_T, &min_mn );
+                            result[2] = max( result[2],
+                                lapackf77_zlange( "1", &min_mn, &min_mn, h_T, &min_mn, work ) / M );
+
+                            // T = I - V^H V
+                            lapackf77_zlaset( "Full", &min_mn, &min_mn, &c_zero, &c_one, h_T, &min_mn );
+                            blasf77_zgemm( "C", "N", &min_mn, &min_mn, &N,
+                                           &c_neg_one, V, &ldv, V, &ldv, &c_one, h_T, &min_mn );
+                            result[3] = max( result[3],
+                                lapackf77_zlange( "1", &min_mn, &min_mn, h_T, &min_mn, work ) / N );
+                        }
+                    }
+                    bool okay = (result[0] < tol && result[1] < tol && result[2] < tol && result[3] < tol);
+                    status += ! okay;
+
+                    printf("%10lld %5lld %5lld   %9.3e (%7.2f)   %9.3e (%7.2f)   %8.2e       %8.2e    %8.2e   %8.2e   %-6s   %s\n",
+                           (long long) batchCount, (long long) M, (long long) N,
+                           batchCount / cpu_time,   cpu_time*1000.,
+                           batchCount / magma_time, magma_time*1000.,
+                           result[0], result[1], result[2], result[3], matrices[imat],
+                           (okay ? "ok" : "failed"));
+                }
+                else {
+                    printf("%10lld %5lld %5lld     ---     (  ---  )   %9.3e (%7.2f)     ---                                              %s\n",
+                           (long long) batchCount, (long long) M, (long long) N,
+                           batchCount / magma_time, magma_time*1000., matrices[imat] );
+                }
+cleanup:
+                magma_free_cpu( info_magma );
+                magma_free_cpu( h_A );
+                magma_free_cpu( h_R );
+                magma_free_cpu( h_U );
+                magma_free_cpu( h_V );
+                magma_free_cpu( h_VT );
+                magma_free_cpu( h_T );
+                magma_free_cpu( h_xy );
+                magma_free_cpu( h_S );
+                magma_free_cpu( s_lapack );
+                magma_free_cpu( h_work );
+                #ifdef COMPLEX
+                magma_free_cpu( rwork );
+                #endif
+                magma_free_cpu( hA_array );
+                magma_free_cpu( hU_array );
+                magma_free_cpu( hV_array );
+                magma_free_cpu( hS_array );
+                fflush( stdout );
+            }
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
@@ -0,0 +1,248 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+#if defined(_OPENMP)
+#include <omp.h>
+#include "../control/magma_threadsetting.h"  // internal header
+#endif
+
+#define COMPLEX
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing zheevj_batched_cpu
+   Compares the throughput (matrices/sec) of the host batched Jacobi
+   eigensolver against looped LAPACK zheevd, one matrix per thread.
+   The check compares the eigenvalues with LAPACK's and, with -JV, computes
+   the residual |A Z - Z W| / (N |A|) and orthogonality |I - Z^H Z| / N.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    const magmaDoubleComplex c_zero    = MAGMA_Z_ZERO;
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+
+    real_Double_t   magma_time, cpu_time = 0;
+    magmaDoubleComplex *h_A, *h_Z, *h_R, *h_work;
+    magmaDoubleComplex **hA_array = NULL;
+    double **hW_array = NULL;
+    magmaDoubleComplex aux_work[1];
+    double *h_W, *w_lapack;
+    #ifdef COMPLEX
+    double *rwork, aux_rwork[1];
+    magma_int_t lrwork;
+    #endif
+    magma_int_t *info_magma, *iwork, aux_iwork[1];
+    magma_int_t N, n2, lda, info, lwork, liwork, lquery = -1;
+    magma_int_t ione     = 1;
+    magma_int_t ISEED[4] = {0,0,0,1};
+    double      work[1], result[3];
+    int status = 0;
+
+    magma_opts opts( MagmaOptsBatched );
+    opts.parse_opts( argc, argv );
+    opts.lapack |= opts.check;  // check (-c) implies lapack (-l)
+    magma_int_t batchCount = opts.batchcount;
+    double tol = opts.tolerance * lapackf77_dlamch("E");
+    const char* jobz = lapack_vec_const(opts.jobz);
+    const char* uplo = lapack_uplo_const(opts.uplo);
+
+    printf("%% jobz = %s, uplo = %s\n", jobz, uplo );
+    printf("%% BatchCount   N    CPU mat/s (ms)        MAGMA mat/s (ms)     |W-W_lapack|   |AZ-ZW|    |I-Z^H Z|\n");
+    printf("%%=====================================================================================================\n");
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            N   = opts.nsize[itest];
+            lda = N;
+            n2  = lda* N  * batchCount;
+
+            // workspace for one matrix per thread of the LAPACK loop
+            magma_int_t nthreads = 1;
+            #if defined(_OPENMP)
+            nthreads = magma_get_lapack_numthreads();
+            #endif
+            lapackf77_zheevd( jobz, uplo, &N, NULL, &lda, NULL,
+                              aux_work, &lquery,
+                              #ifdef COMPLEX
+                              aux_rwork, &lquery,
+                              #endif
+                              aux_iwork, &lquery, &info );
+            lwork  = (magma_int_t) MAGMA_Z_REAL( aux_work[0] );
+            #ifdef COMPLEX
+            lrwork = (magma_int_t) aux_rwork[0];
+            #endif
+            liwork = aux_iwork[0];
+
+            TESTING_CHECK( magma_imalloc_cpu( &info_magma, batchCount ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_A, n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_Z, n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_R, n2 ));
+            TESTING_CHECK( magma_dmalloc_cpu( &h_W,      N*batchCount ));
+            TESTING_CHECK( magma_dmalloc_cpu( &w_lapack, N*batchCount ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_work, lwork  * nthreads ));
+            #ifdef COMPLEX
+            TESTING_CHECK( magma_dmalloc_cpu( &rwork,  lrwork * nthreads ));
+            #endif
+            TESTING_CHECK( magma_imalloc_cpu( &iwork,  liwork * nthreads ));
+            TESTING_CHECK( magma_malloc_cpu( (void**) &hA_array, batchCount * sizeof(magmaDoubleComplex*) ));
+            TESTING_CHECK( magma_malloc_cpu( (void**) &hW_array, batchCount * sizeof(double*) ));
+
+            /* Initialize the matrix */
+            lapackf77_zlarnv( &ione, ISEED, &n2, h_A );
+            for (int i=0; i < batchCount; i++) {
+                magma_zmake_hermitian( N, h_A + i * lda * N, lda );
+            }
+
+            magma_int_t columns = N * batchCount;
+            lapackf77_zlacpy( MagmaFullStr, &N, &(columns), h_A, &lda, h_Z, &lda );
+            for (int i=0; i < batchCount; i++) {
+                hA_array[i] = h_Z + i * lda * N;
+                hW_array[i] = h_W + i * N;
+            }
+
+            /* ====================================================================
+               Performs operation using MAGMA
+               =================================================================== */
+            magma_time = magma_wtime();
+            info = magma_zheevj_batched_cpu( opts.jobz, opts.uplo, N, hA_array, lda,
+                                             hW_array, info_magma, batchCount );
+            magma_time = magma_wtime() - magma_time;
+
+            for (int i=0; i < batchCount; i++) {
+                if (info_magma[i] != 0 ) {
+                    printf("magma_zheevj_batched_cpu matrix %lld returned error %lld\n",
+                            (long long) i, (long long) info_magma[i] );
+                    status = -1;
+                }
+            }
+            if (info != 0) {
+                printf("magma_zheevj_batched_cpu returned argument error %lld: %s.\n",
+                        (long long) info, magma_strerror( info ));
+                status = -1;
+            }
+            if (status == -1)
+                goto cleanup;
+
+            if ( opts.lapack ) {
+                /* =====================================================================
+                   Performs operation using LAPACK
+                   =================================================================== */
+                lapackf77_zlacpy( MagmaFullStr, &N, &(columns), h_A, &lda, h_R, &lda );
+                cpu_time = magma_wtime();
+                #if defined(_OPENMP)
+                magma_set_lapack_numthreads(1);
+                magma_set_omp_numthreads(nthreads);
+                #pragma omp parallel for schedule(dynamic)
+                #endif
+                for (magma_int_t s=0; s < batchCount; s++) {
+                    magma_int_t locinfo, t = 0;
+                    #if defined(_OPENMP)
+                    t = omp_get_thread_num();
+                    #endif
+                    lapackf77_zheevd( jobz, uplo, &N, h_R + s * lda * N, &lda, w_lapack + s * N,
+                                      h_work + t * lwork, &lwork,
+                                      #ifdef COMPLEX
+                                      rwork + t * lrwork, &lrwork,
+                                      #endif
+                                      iwork + t * liwork, &liwork, &locinfo );
+                    if (locinfo != 0) {
+                        printf("lapackf77_zheevd matrix %lld returned error %lld: %s.\n",
+                               (long long) s, (long long) locinfo, magma_strerror( locinfo ));
+                    }
+                }
+                #if defined(_OPENMP)
+                magma_set_lapack_numthreads(nthreads);
+                #endif
+                cpu_time = magma_wtime() - cpu_time;
+
+                /* =====================================================================
+                   Check the result compared to LAPACK
+                   =================================================================== */
+                result[0] = result[1] = result[2] = 0;
+                for (int i=0; i < batchCount; i++) {
+                    magmaDoubleComplex *A = h_A + i * lda*N;
+                    magmaDoubleComplex *Z = h_Z + i * lda*N;
+                    magmaDoubleComplex *R = h_R + i * lda*N;
+                    double Anorm = safe_lapackf77_zlanhe( "f", uplo, &N, A, &lda, work );
+                    Anorm = (Anorm > 0 ? Anorm : 1);
+                    for (int j=0; j < N; j++) {
+                        result[0] = max( result[0], fabs( h_W[i*N + j] - w_lapack[i*N + j] ) / Anorm );
+                    }
+                    if (opts.jobz == MagmaVec) {
+                        // R = A Z - Z W
+                        lapackf77_zlacpy( MagmaFullStr, &N, &N, Z, &lda, R, &lda );
+                        for (int j=0; j < N; j++) {
+                            blasf77_zdscal( &N, &h_W[i*N + j], R + j*lda, &ione );
+                        }
+                        blasf77_zhemm( "L", uplo, &N, &N, &c_one, A, &lda, Z, &lda,
+                                       &c_neg_one, R, &lda );
+                        result[1] = max( result[1],
+                            lapackf77_zlange( "1", &N, &N, R, &lda, work ) / (N * Anorm) );
+
+                        // R = I - Z^H Z
+                        lapackf77_zlaset( "Full", &N, &N, &c_zero, &c_one, R, &lda );
+                        blasf77_zgemm( "C", "N", &N, &N, &N,
+                                       &c_neg_one, Z, &lda, Z, &lda, &c_one, R, &lda );
+                        result[2] = max( result[2],
+                            lapackf77_zlange( "1", &N, &N, R, &lda, work ) / N );
+                    }
+                }
+                bool okay = (result[0] < tol && result[1] < tol && result[2] < tol);
+                status += ! okay;
+
+                printf("%10lld %5lld   %9.3e (%7.2f)   %9.3e (%7.2f)   %8.2e       %8.2e   %8.2e   %s\n",
+                       (long long) batchCount, (long long) N,
+                       batchCount / cpu_time,   cpu_time*1000.,
+                       batchCount / magma_time, magma_time*1000.,
+                       result[0], result[1], result[2], (okay ? "ok" : "failed"));
+            }
+            else {
+                printf("%10lld %5lld     ---     (  ---  )   %9.3e (%7.2f)     ---\n",
+                       (long long) batchCount, (long long) N,
+                       batchCount / magma_time, magma_time*1000. );
+            }
+cleanup:
+            magma_free_cpu( info_magma );
+            magma_free_cpu( h_A );
+            magma_free_cpu( h_Z );
+            magma_free_cpu( h_R );
+            magma_free_cpu( h_W );
+            magma_free_cpu( w_lapack );
+            magma_free_cpu( h_work );
+            #ifdef COMPLEX
+            magma_free_cpu( rwork );
+            #endif
+            magma_free_cpu( iwork );
+            magma_free_cpu( hA_array );
+            magma_free_cpu( hW_array );
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
@@ -0,0 +1,178 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "flops.h"
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+#if defined(_OPENMP)
+#include <omp.h>
+#include "../control/magma_threadsetting.h"  // internal header
+#endif
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing zpotrf_batched_cpu
+   Compares the throughput (matrices/sec) of the host batched Cholesky
+   against looped LAPACK, one matrix per thread.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    real_Double_t   gflops, magma_perf, magma_time, cpu_perf = 0, cpu_time = 0;
+    magmaDoubleComplex *h_A, *h_R;
+    magmaDoubleComplex **hA_array = NULL;
+    magma_int_t *info_magma;
+    magma_int_t N, n2, lda, info;
+    magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+    magma_int_t ione     = 1;
+    magma_int_t ISEED[4] = {0,0,0,1};
+    double      work[1], error;
+    int status = 0;
+
+    magma_opts opts( MagmaOptsBatched );
+    opts.parse_opts( argc, argv );
+    opts.lapack |= opts.check;  // check (-c) implies lapack (-l)
+    magma_int_t batchCount = opts.batchcount;
+    double tol = opts.tolerance * lapackf77_dlamch("E");
+
+    printf("%% uplo = %s\n", lapack_uplo_const(opts.uplo) );
+    printf("%% BatchCount   N    CPU mat/s  Gflop/s (ms)      MAGMA mat/s  Gflop/s (ms)   ||R_magma - R_lapack||_F / ||R_lapack||_F\n");
+    printf("%%==========================================================================================================\n");
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            N   = opts.nsize[itest];
+            lda = N;
+            n2  = lda* N  * batchCount;
+
+            gflops = batchCount * FLOPS_ZPOTRF( N ) / 1e9;
+
+            TESTING_CHECK( magma_imalloc_cpu( &info_magma, batchCount ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_A, n2 ));
+            TESTING_CHECK( magma_zmalloc_cpu( &h_R, n2 ));
+            TESTING_CHECK( magma_malloc_cpu( (void**) &hA_array, batchCount * sizeof(magmaDoubleComplex*) ));
+
+            /* Initialize the matrix */
+            lapackf77_zlarnv( &ione, ISEED, &n2, h_A );
+            for (int i=0; i < batchCount; i++) {
+                magma_zmake_hpd( N, h_A + i * lda * N, lda );
+            }
+
+            magma_int_t columns = N * batchCount;
+            lapackf77_zlacpy( MagmaFullStr, &N, &(columns), h_A, &lda, h_R, &lda );
+            for (int i=0; i < batchCount; i++) {
+                hA_array[i] = h_R + i * lda * N;
+            }
+
+            /* ====================================================================
+               Performs operation using MAGMA
+               =================================================================== */
+            magma_time = magma_wtime();
+            info = magma_zpotrf_batched_cpu( opts.uplo, N, hA_array, lda, info_magma, batchCount );
+            magma_time = magma_wtime() - magma_time;
+            magma_perf = gflops / magma_time;
+
+            for (int i=0; i < batchCount; i++) {
+                if (info_magma[i] != 0 ) {
+                    printf("magma_zpotrf_batched_cpu matrix %lld returned diag error %lld\n",
+                            (long long) i, (long long) info_magma[i] );
+                    status = -1;
+                }
+            }
+            if (info != 0) {
+                printf("magma_zpotrf_batched_cpu returned argument error %lld: %s.\n",
+                        (long long) info, magma_strerror( info ));
+                status = -1;
+            }
+            if (status == -1)
+                goto cleanup;
+
+            if ( opts.lapack ) {
+                /* =====================================================================
+                   Performs operation using LAPACK
+                   =================================================================== */
+                cpu_time = magma_wtime();
+                #if defined(_OPENMP)
+                magma_int_t nthreads = magma_get_lapack_numthreads();
+                magma_set_lapack_numthreads(1);
+                magma_set_omp_numthreads(nthreads);
+                #pragma omp parallel for schedule(dynamic)
+                #endif
+                for (magma_int_t s=0; s < batchCount; s++) {
+                    magma_int_t locinfo;
+                    lapackf77_zpotrf( lapack_uplo_const(opts.uplo), &N, h_A + s * lda * N, &lda, &locinfo );
+                    if (locinfo != 0) {
+                        printf("lapackf77_zpotrf matrix %lld returned error %lld: %s.\n",
+                               (long long) s, (long long) locinfo, magma_strerror( locinfo ));
+                    }
+                }
+                #if defined(_OPENMP)
+                magma_set_lapack_numthreads(nthreads);
+                #endif
+                cpu_time = magma_wtime() - cpu_time;
+                cpu_perf = gflops / cpu_time;
+
+                /* =====================================================================
+                   Check the result compared to LAPACK
+                   =================================================================== */
+                magma_int_t NN = lda*N;
+                const char* uplo = lapack_uplo_const(opts.uplo);
+                error = 0;
+                for (int i=0; i < batchCount; i++) {
+                    double Anorm, err;
+                    blasf77_zaxpy(&NN, &c_neg_one, h_A + i * lda*N, &ione, h_R + i * lda*N, &ione);
+                    Anorm = safe_lapackf77_zlanhe("f", uplo, &N, h_A + i * lda*N, &lda, work);
+                    err   = safe_lapackf77_zlanhe("f", uplo, &N, h_R + i * lda*N, &lda, work)
+                          / Anorm;
+                    if (std::isnan(err) || std::isinf(err)) {
+                        error = err;
+                        break;
+                    }
+                    error = max( err, error );
+                }
+                bool okay = (error < tol);
+                status += ! okay;
+
+                printf("%10lld %5lld   %9.3e %7.2f (%7.2f)   %9.3e %7.2f (%7.2f)   %8.2e   %s\n",
+                       (long long) batchCount, (long long) N,
+                       batchCount / cpu_time,   cpu_perf,   cpu_time*1000.,
+                       batchCount / magma_time, magma_perf, magma_time*1000.,
+                       error, (okay ? "ok" : "failed"));
+            }
+            else {
+                printf("%10lld %5lld     ---       ---   (  ---  )   %9.3e %7.2f (%7.2f)     ---\n",
+                       (long long) batchCount, (long long) N,
+                       batchCount / magma_time, magma_perf, magma_time*1000. );
+            }
+cleanup:
+            magma_free_cpu( info_magma );
+            magma_free_cpu( h_A );
+            magma_free_cpu( h_R );
+            magma_free_cpu( hA_array );
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
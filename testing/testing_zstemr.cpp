@@ -0,0 +1,183 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "magma_operators.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing zstemr
+   Times the task-parallel MRRR magma_zstemr against the serial LAPACK zstemr
+   on a random N-by-N symmetric tridiagonal matrix, for the range given by
+   --fraction, --irange, or --vrange.
+   The check compares the eigenvalues with LAPACK's, and computes the
+   residual |T Z - Z W| / (N |T|) and orthogonality |I - Z^H Z| / N.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    const magmaDoubleComplex c_zero    = MAGMA_Z_ZERO;
+    const magmaDoubleComplex c_one     = MAGMA_Z_ONE;
+    const magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+
+    real_Double_t   cpu_time, magma_time;
+    magmaDoubleComplex *Z, *Zref, *R;
+    double *d, *e, *dcopy, *ecopy, *w, *wref, *work;
+    double result[3], tnorm, unused[1];
+    magma_int_t *iwork, *isuppz;
+    magma_int_t N, M, Mref, ldz, lwork, liwork, tryrac, info;
+    magma_int_t ione     = 1;
+    magma_int_t ISEED[4] = {0,0,0,1};
+    int status = 0;
+
+    magma_opts opts;
+    opts.parse_opts( argc, argv );
+    double tol = opts.tolerance * lapackf77_dlamch("E");
+
+    printf("%%   N     M   LAPACK (sec)   MAGMA (sec)   speedup   |W-W_lapack|   |TZ-ZW|    |I-Z^H Z|\n");
+    printf("%%============================================================================================\n");
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            N      = opts.nsize[itest];
+            ldz    = max( 1, N );
+            lwork  = max( 1, 18*N );
+            liwork = max( 1, 10*N );
+
+            magma_range_t range;
+            magma_int_t il, iu;
+            double vl, vu;
+            opts.get_range( N, &range, &vl, &vu, &il, &iu );
+            if (range == MagmaRangeI) {
+                il = max( 1, il );
+                iu = max( il, iu );
+            }
+
+            TESTING_CHECK( magma_dmalloc_cpu( &d,      N      ));
+            TESTING_CHECK( magma_dmalloc_cpu( &e,      N      ));
+            TESTING_CHECK( magma_dmalloc_cpu( &dcopy,  N      ));
+            TESTING_CHECK( magma_dmalloc_cpu( &ecopy,  N      ));
+            TESTING_CHECK( magma_dmalloc_cpu( &w,      N      ));
+            TESTING_CHECK( magma_dmalloc_cpu( &wref,   N      ));
+            TESTING_CHECK( magma_dmalloc_cpu( &work,   lwork  ));
+            TESTING_CHECK( magma_imalloc_cpu( &iwork,  liwork ));
+            TESTING_CHECK( magma_imalloc_cpu( &isuppz, 2*ldz  ));
+            TESTING_CHECK( magma_zmalloc_cpu( &Z,      ldz*N  ));
+            TESTING_CHECK( magma_zmalloc_cpu( &Zref,   ldz*N  ));
+            TESTING_CHECK( magma_zmalloc_cpu( &R,      ldz*N  ));
+
+            lapackf77_dlarnv( &ione, ISEED, &N, d );
+            lapackf77_dlarnv( &ione, ISEED, &N, e );
+
+            /* ====================================================================
+               Performance test
+               =================================================================== */
+            blasf77_dcopy( &N, d, &ione, dcopy, &ione );
+            blasf77_dcopy( &N, e, &ione, ecopy, &ione );
+            tryrac = 1;
+            cpu_time = magma_wtime();
+            lapackf77_zstemr( "V", lapack_range_const( range ), &N, dcopy, ecopy,
+                              &vl, &vu, &il, &iu, &Mref, wref, Zref, &ldz, &N, isuppz,
+                              &tryrac, work, &lwork, iwork, &liwork, &info );
+            cpu_time = magma_wtime() - cpu_time;
+            if (info != 0) {
+                printf("lapackf77_zstemr returned error %lld.\n", (long long) info );
+            }
+
+            blasf77_dcopy( &N, d, &ione, dcopy, &ione );
+            blasf77_dcopy( &N, e, &ione, ecopy, &ione );
+            tryrac = 1;
+            magma_time = magma_wtime();
+            magma_zstemr( MagmaVec, range, N, dcopy, ecopy, vl, vu, il, iu,
+                          &M, w, Z, ldz, N, isuppz, &tryrac,
+                          work, lwork, iwork, liwork, &info );
+            magma_time = magma_wtime() - magma_time;
+            if (info != 0) {
+                printf("magma_zstemr returned error %lld: %s.\n",
+                       (long long) info, magma_strerror( info ));
+            }
+
+            /* =====================================================================
+               Check the result
+               =================================================================== */
+            result[0] = result[1] = result[2] = 0;
+            bool okay = (M == Mref);
+            if ( opts.check && okay && M > 0 ) {
+                tnorm = 0;
+                for (magma_int_t i = 0; i < N; ++i) {
+                    tnorm = max( tnorm, fabs( d[i] ) + (i > 0 ? fabs( e[i-1] ) : 0)
+                                                      + (i < N-1 ? fabs( e[i] ) : 0) );
+                }
+                for (magma_int_t j = 0; j < M; ++j) {
+                    result[0] = max( result[0], fabs( w[j] - wref[j] ) / tnorm );
+                }
+
+                // R = T Z - Z W
+                for (magma_int_t j = 0; j < M; ++j) {
+                    for (magma_int_t i = 0; i < N; ++i) {
+                        magmaDoubleComplex r = (d[i] - w[j]) * Z[i + j*ldz];
+                        if (i > 0) {
+                            r += e[i-1] * Z[i-1 + j*ldz];
+                        }
+                        if (i < N-1) {
+                            r += e[i] * Z[i+1 + j*ldz];
+                        }
+                        R[i + j*ldz] = r;
+                    }
+                }
+                result[1] = lapackf77_zlange( "1", &N, &M, R, &ldz, unused ) / (N * tnorm);
+
+                // R = I - Z^H Z
+                lapackf77_zlaset( "Full", &M, &M, &c_zero, &c_one, R, &ldz );
+                blasf77_zgemm( "C", "N", &M, &M, &N,
+                               &c_neg_one, Z, &ldz, Z, &ldz, &c_one, R, &ldz );
+                result[2] = lapackf77_zlange( "1", &M, &M, R, &ldz, unused ) / N;
+
+                okay = okay && result[0] < tol && result[1] < tol && result[2] < tol;
+            }
+            status += ! okay;
+
+            printf("%5lld %5lld   %12.4f   %11.4f   %7.2f   %12.2e   %8.2e   %8.2e   %s\n",
+                   (long long) N, (long long) M, cpu_time, magma_time, cpu_time / magma_time,
+                   result[0], result[1], result[2],
+                   (opts.check ? (okay ? "ok" : "failed") : (okay ? "" : "failed")));
+
+            magma_free_cpu( d      );
+            magma_free_cpu( e      );
+            magma_free_cpu( dcopy  );
+            magma_free_cpu( ecopy  );
+            magma_free_cpu( w      );
+            magma_free_cpu( wref   );
+            magma_free_cpu( work   );
+            magma_free_cpu( iwork  );
+            magma_free_cpu( isuppz );
+            magma_free_cpu( Z      );
+            magma_free_cpu( Zref   );
+            magma_free_cpu( R      );
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
@@ -94,6 +94,7 @@ blas_mixed = [
     ('dlag2s',         'zlag2c'          ),
     ('dlagsy',         'zlaghe'          ),
     ('dlange',         'zlange'          ),
+    ('dlaset',         'zlaset'          ),
     ('dlansy',         'zlanhe'          ),
     ('dlansy',         'zlansy'          ),
     ('dlarnv',         'zlarnv'          ),
@@ -102,6 +103,7 @@ blas_mixed = [
     ('dormqr',         'zunmqr'          ),
     ('dpotrf',         'zpotrf'          ),
     ('dpotrs',         'zpotrs'          ),
+    ('dsyev',          'zheev'           ),
     ('dsymm',          'zhemm'           ),
     ('dsymv',          'zhemv'           ),
     ('dsyrk',          'zherk'           ),
@@ -115,6 +117,7 @@ blas_mixed = [
     ('slansy',         'clanhe'          ),
     ('slat2d',         'clat2z'          ),
     ('spotrf',         'cpotrf'          ),
+    ('ssyev',          'cheev'           ),
     ('ssysv',          'chesv'           ),
     ('ssysv',          'csysv'           ),
     ('ssytrf',         'chetrf'          ),
@@ -223,8 +226,10 @@ lapack = [
     ('slaed',          'dlaed',          'slaed',          'dlaed'           ),
     ('slaex',          'dlaex',          'slaex',          'dlaex'           ),
     ('slag2d',         'dlag2s',         'clag2z',         'zlag2c'          ),
+    ('slagt',          'dlagt',          'slagt',          'dlagt'           ),
     ('slagsy',         'dlagsy',         'claghe',         'zlaghe'          ),
     ('slagsy',         'dlagsy',         'clagsy',         'zlagsy'          ),
+    ('slahqr',         'dlahqr',         'clahqr',         'zlahqr'          ),
     ('slahr',          'dlahr',          'clahr',          'zlahr'           ),
     ('slaln2',         'dlaln2',         'slaln2',         'dlaln2'          ),
     ('slamc3',         'dlamc3',         'slamc3',         'dlamc3'          ),
@@ -240,14 +245,18 @@ lapack = [
     ('slaqp2',         'dlaqp2',         'claqp2',         'zlaqp2'          ),
     ('slaqps',         'dlaqps',         'claqps',         'zlaqps'          ),
     ('slaqtrs',        'dlaqtrs',        'claqtrs',        'zlaqtrs'         ),
+    ('slar1v',         'dlar1v',         'slar1v',         'dlar1v'          ),
     ('slarcm',         'dlarcm',         'clarcm',         'zlarcm'          ),
     ('slarf',          'dlarf',          'clarf',          'zlarf'           ),  # also does zlarfb, zlarfg, etc.
     ('slarnv',         'dlarnv',         'clarnv',         'zlarnv'          ),
     ('slarnv',         'dlarnv',         'slarnv',         'dlarnv'          ),
+    ('slarr',          'dlarr',          'slarr',          'dlarr'           ),
     ('slartg',         'dlartg',         'clartg',         'zlartg'          ),
     ('slascl',         'dlascl',         'slascl',         'dlascl'          ),
     ('slascl',         'dlascl',         'clascl',         'zlascl'          ),
+    ('slasd',          'dlasd',          'slasd',          'dlasd'           ),
     ('slaset',         'dlaset',         'claset',         'zlaset'          ),
+    ('slasr',          'dlasr',          'slasr',          'dlasr'           ),
     ('slasrt',         'dlasrt',         'slasrt',         'dlasrt'          ),
     ('slaswp',         'dlaswp',         'claswp',         'zlaswp'          ),
     ('slasyf',         'dlasyf',         'clahef',         'zlahef'          ),
@@ -265,6 +274,7 @@ lapack = [
     ('sorgtr',         'dorgtr',         'cungtr',         'zungtr'          ),
     ('sorm2r',         'dorm2r',         'cunm2r',         'zunm2r'          ),
     ('sormbr',         'dormbr',         'cunmbr',         'zunmbr'          ),
+    ('sormhr',         'dormhr',         'cunmhr',         'zunmhr'          ),
     ('sormlq',         'dormlq',         'cunmlq',         'zunmlq'          ),
     ('sormql',         'dormql',         'cunmql',         'zunmql'          ),
     ('sormqr',         'dormqr',         'cunmqr',         'zunmqr'          ),
@@ -316,6 +326,7 @@ lapack = [
     ('ssytrs',         'dsytrs',         'chetrs',         'zhetrs'          ),
     ('ssytrs',         'dsytrs',         'csytrs',         'zsytrs'          ),
     ('strevc',         'dtrevc',         'ctrevc',         'ztrevc'          ),
+    ('strexc',         'dtrexc',         'ctrexc',         'ztrexc'          ),
     ('strsmpl',        'dtrsmpl',        'ctrsmpl',        'ztrsmpl'         ),
     ('strtri',         'dtrtri',         'ctrtri',         'ztrtri'          ),
     ('stsmqr',         'dtsmqr',         'ctsmqr',         'ztsmqr'          ),
@@ -336,6 +347,8 @@ subs = {
     # ----- special cases
     ('dcopy',                     'zcopy'                   ),  # before zc
     ('dssysv',                    'zchesv'                   ),  # before zc
+    ('dssyevd',                   'zcheevd'                  ),  # before zc
+    ('DSSYEVD',                   'ZCHEEVD'                  ),  # before ZC
 
     # ----- Mixed precision prefix
     # TODO drop these two -- they are way too general
@@ -597,6 +610,10 @@ subs = {
     ('smzdotc',        'dmzdotc',        'cmzdotc',        'zmzdotc'         ),
     ('smt',            'dmt',            'cmt',            'zmt'             ),
     ('spipelined',     'dpipelined',     'cpipelined',     'zpipelined'      ),
+    ('spipecg',        'dpipecg',        'cpipecg',        'zpipecg'         ),
+    ('samg',           'damg',           'camg',           'zamg'            ),
+    ('smcgs',          'dmcgs',          'cmcgs',          'zmcgs'           ),
+    ('sras',           'dras',           'cras',           'zras'            ),
     ('mkl_scsrmv',     'mkl_dcsrmv',     'mkl_ccsrmv',     'mkl_zcsrmv'      ),
     ('mkl_scsrmm',     'mkl_dcsrmm',     'mkl_ccsrmm',     'mkl_zcsrmm'      ),
     ('mkl_sbsrmv',     'mkl_dbsrmv',     'mkl_cbsrmv',     'mkl_zbsrmv'      ),